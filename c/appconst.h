@@ -58,6 +58,14 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include "platformTime.h"
 #endif
 
+// When PROFILE_COUNTERS is also defined, the profile of each embedder phase
+// includes hardware performance counter values per edge (Linux perf_event)
+
+//#define PROFILE_COUNTERS
+#ifdef PROFILE
+#include "platformCounters.h"
+#endif
+
 /* Define DEBUG to get additional debugging. The default is to define it when MSC does */
 
 #ifdef _DEBUG
@@ -93,6 +93,7 @@ int		gp_EnsureArcCapacity(graphP theGraph, int requiredArcCapacity);
 int		gp_AddEdge(graphP theGraph, int u, int ulink, int v, int vlink);
 int     gp_InsertEdge(graphP theGraph, int u, int e_u, int e_ulink,
                                        int v, int e_v, int e_vlink);
+int		gp_BuildFromEdgeArray(graphP theGraph, int N, const int *u, const int *v, int M);
 
 void	gp_HideEdge(graphP theGraph, int e);
 void	gp_RestoreEdge(graphP theGraph, int e);
@@ -107,10 +108,24 @@ int		gp_CreateDFSTree(graphP theGraph);
 int		gp_SortVertices(graphP theGraph);
 int 	gp_LowpointAndLeastAncestor(graphP theGraph);
 int		gp_PreprocessForEmbedding(graphP theGraph);
+int		gp_CopyPreprocessedGraph(graphP dstGraph, graphP srcGraph);
+int		gp_CachePreprocessing(graphP theGraph);
+int		gp_CompactAndReorder(graphP theGraph, int orderType, int *originalIds);
 
 int		gp_Embed(graphP theGraph, int embedFlags);
+int		gp_EmbedPlanar(graphP theGraph);
+int		gp_EmbedOuterplanar(graphP theGraph);
+int		gp_EmbedComponents(graphP theGraph, int embedFlags, int numThreads);
+int		gp_EmbedBlocks(graphP theGraph, int embedFlags, int numThreads);
+int		gp_EmbedReduced(graphP theGraph, int embedFlags);
+int		gp_FindObstructions(graphP theGraph, int embedFlags, int findFlags, int k,
+                                    graphP *obstructions, int *pNumFound);
 int		gp_TestEmbedResultIntegrity(graphP theGraph, graphP origGraph, int embedResult);
 
+int		gp_TraceEnable(graphP theGraph, int capacity);
+void	gp_TraceDisable(graphP theGraph);
+int		gp_TraceWrite(graphP theGraph, char *FileName);
+
 /* Possible Flags for gp_Embed.  The planar and outerplanar settings are supported
    natively.  The rest require extension modules. */
 
@@ -118,6 +133,7 @@ int		gp_TestEmbedResultIntegrity(graphP theGraph, graphP origGraph, int embedRes
 #define EMBEDFLAGS_OUTERPLANAR  2
 
 #define EMBEDFLAGS_DRAWPLANAR   (4|EMBEDFLAGS_PLANAR)
+#define EMBEDFLAGS_DRAWSTRAIGHTLINE (8|EMBEDFLAGS_PLANAR)
 
 #define EMBEDFLAGS_SEARCHFORK23 (16|EMBEDFLAGS_OUTERPLANAR)
 #define EMBEDFLAGS_SEARCHFORK4  (32|EMBEDFLAGS_OUTERPLANAR)
@@ -129,41 +145,16 @@ int		gp_TestEmbedResultIntegrity(graphP theGraph, graphP origGraph, int embedRes
 #define EMBEDFLAGS_PROJECTIVEPLANAR         512
 #define EMBEDFLAGS_TOROIDAL                 1024
 
-/* If LOGGING is defined, then write to the log, otherwise no-op
-   By default, neither release nor DEBUG builds including LOGGING.
-   Logging is useful for seeing details of how various algorithms
-   handle a particular graph. */
-
-//#define LOGGING
-#ifdef LOGGING
-
-#define gp_LogLine _LogLine
-#define gp_Log _Log
-
-void _LogLine(char *Line);
-void _Log(char *Line);
-
-#define gp_MakeLogStr1 _MakeLogStr1
-#define gp_MakeLogStr2 _MakeLogStr2
-#define gp_MakeLogStr3 _MakeLogStr3
-#define gp_MakeLogStr4 _MakeLogStr4
-#define gp_MakeLogStr5 _MakeLogStr5
-
-char *_MakeLogStr1(char *format, int);
-char *_MakeLogStr2(char *format, int, int);
-char *_MakeLogStr3(char *format, int, int, int);
-char *_MakeLogStr4(char *format, int, int, int, int);
-char *_MakeLogStr5(char *format, int, int, int, int, int);
-
-#else
-#define gp_LogLine(Line)
-#define gp_Log(Line)
-#define gp_MakeLogStr1(format, one)
-#define gp_MakeLogStr2(format, one, two)
-#define gp_MakeLogStr3(format, one, two, three)
-#define gp_MakeLogStr4(format, one, two, three, four)
-#define gp_MakeLogStr5(format, one, two, three, four, five)
-#endif
+/* Possible flags for gp_FindObstructions */
+
+#define FINDOBSTRUCTIONS_DISTINCT       0
+#define FINDOBSTRUCTIONS_EDGEDISJOINT   1
+
+/* Possible orders for gp_CompactAndReorder */
+
+#define REORDER_BFS     1
+#define REORDER_DFS     2
+#define REORDER_RCM     3
 
 #ifdef __cplusplus
 }
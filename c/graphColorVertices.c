@@ -97,11 +97,11 @@ int _GetContractibleNeighbors(ColorVerticesContext *context, int v, int *pu, int
 
 int gp_ColorVertices(graphP theGraph)
 {
-    ColorVerticesContext *context = NULL;
-    int v, deg;
-    int u=0, w=0, contractible;
+	ColorVerticesContext *context = NULL;
+	int v, deg;
+	int u=0, w=0, contractible;
 
-    // Attach the algorithm if it is not already attached
+	// Attach the algorithm if it is not already attached
 	if (gp_AttachColorVertices(theGraph) != OK)
 		return NOTOK;
 
@@ -123,57 +123,50 @@ int gp_ColorVertices(graphP theGraph)
 	}
 
 	// Get the extension context and reinitialize it if necessary
-    gp_FindExtension(theGraph, COLORVERTICES_ID, (void *)&context);
+	gp_FindExtension(theGraph, COLORVERTICES_ID, (void *)&context);
 
-    if (context->color[0] > -1)
-    	_ColorVertices_Reinitialize(context);
+	if (context->color[0] > -1)
+		_ColorVertices_Reinitialize(context);
 
-    // Initialize the degree lists, and provide a color for any trivial vertices
-    for (v = gp_GetFirstVertex(theGraph); gp_VertexInRange(theGraph, v); v++)
-    {
-    	deg = gp_GetVertexDegree(theGraph, v);
-    	_AddVertexToDegList(context, theGraph, v, deg);
+	// Initialize the degree lists, and provide a color for any trivial vertices
+	for (v = gp_GetFirstVertex(theGraph); gp_VertexInRange(theGraph, v); v++)
+	{
+		deg = gp_GetVertexDegree(theGraph, v);
+		_AddVertexToDegList(context, theGraph, v, deg);
 
-    	if (deg == 0)
-    		context->color[v] = 0;
-    }
+		if (deg == 0)
+			context->color[v] = 0;
+	}
 
-    // Initialize the vertex visited flags so they can be used during reductions
-    _ClearVertexVisitedFlags(theGraph, FALSE);
+	// Initialize the vertex visited flags so they can be used during reductions
+	_ClearVertexVisitedFlags(theGraph, FALSE);
 
-    // Reduce the graph using minimum degree selection
-    while (context->numVerticesToReduce > 0)
-    {
-    	v = _GetVertexToReduce(context, theGraph);
-
-    	// Find out if v is contractible and the neighbors to contract
-    	contractible = _GetContractibleNeighbors(context, v, &u, &w);
-
-    	// Remove the vertex from the graph. This calls the fpHideEdge
-    	// overload, which performs the correct _RemoveVertexFromDegList()
-    	// and _AddVertexToDegList() operations on v and its neighbors.
-    	if (gp_HideVertex(theGraph, v) != OK)
-    		return NOTOK;
-
-    	// If v was contractibile, then identify u and w
-    	if (contractible)
-    	{
-    		if (gp_IdentifyVertices(theGraph, u, w, NIL) != OK)
-    			return NOTOK;
-    	}
-    }
+	// Reduce the graph using minimum degree selection
+	while (context->numVerticesToReduce > 0)
+	{
+		v = _GetVertexToReduce(context, theGraph);
 
-    // Restore the graph one vertex at a time, coloring each vertex distinctly
-    // from its neighbors as it is restored.
-    context->colorDetector = (int *) calloc(theGraph->N, sizeof(int));
-    if (context->colorDetector == NULL)
-    	return NOTOK;
+		// Find out if v is contractible and the neighbors to contract
+		contractible = _GetContractibleNeighbors(context, v, &u, &w);
 
-    if (gp_RestoreVertices(theGraph) != OK)
-    	return NOTOK;
+		// Remove the vertex from the graph. This calls the fpHideEdge
+		// overload, which performs the correct _RemoveVertexFromDegList()
+		// and _AddVertexToDegList() operations on v and its neighbors.
+		if (gp_HideVertex(theGraph, v) != OK)
+			return NOTOK;
+
+		// If v was contractibile, then identify u and w
+		if (contractible)
+		{
+			if (gp_IdentifyVertices(theGraph, u, w, NIL) != OK)
+				return NOTOK;
+		}
+	}
 
-    free(context->colorDetector);
-    context->colorDetector = NULL;
+	// Restore the graph one vertex at a time, coloring each vertex distinctly
+	// from its neighbors as it is restored.
+	if (gp_RestoreVertices(theGraph) != OK)
+		return NOTOK;
 
 	return OK;
 }
@@ -209,21 +202,6 @@ void _AddVertexToDegList(ColorVerticesContext *context, graphP theGraph, int v,
 	context->degree[v] = deg;
 }
 
-/********************************************************************
- _GetVertexDegree()
- ********************************************************************/
-
-int _GetVertexDegree(ColorVerticesContext *context, int v)
-{
-	return context->degree[v];
-
-	// We cache vertex degree values because the API function is O(deg(v)),
-	// which would make this algorithm implementation have quadratic behavior
-	// in the worst case
-	//
-	// return gp_GetVertexDegree(context->theGraph, v);
-}
-
 /********************************************************************
  _IsConstantTimeContractible()
  Wrapper function that just returns the result of _GetContractibleNeighbors()
@@ -281,7 +259,7 @@ int _IsConstantTimeContractible(ColorVerticesContext *context, int v)
 
 int _GetContractibleNeighbors(ColorVerticesContext *context, int v, int *pu, int *pw)
 {
-	int lowDegreeNeighbors[5], i, j, n=0, e;
+	int lowDegreeNeighbors[5], i, j, n=0, k=0, e;
 	graphP theGraph = context->theGraph;
 
 	// This method is only applicable to degree 5 vertices
@@ -292,6 +270,11 @@ int _GetContractibleNeighbors(ColorVerticesContext *context, int v, int *pu, int
     e = gp_GetFirstArc(theGraph, v);
     while (gp_IsArc(e))
     {
+    	// The cached degree of v can be stale while v is being moved to a
+    	// new degree list, so v is not contractible if it has more arcs
+    	if (++k > 5)
+    		return FALSE;
+
     	if (_GetVertexDegree(context, gp_GetNeighbor(theGraph, e)) <= 7)
     		lowDegreeNeighbors[n++] = gp_GetNeighbor(theGraph, e);
         e = gp_GetNextArc(theGraph, e);
@@ -348,51 +331,77 @@ int _GetVertexToReduce(ColorVerticesContext *context, graphP theGraph)
 
 /********************************************************************
  _AssignColorToVertex()
+
+ Assigns to v the least numbered color not used by any of its neighbors.
+
+ The colors of the neighbors are collected in a bitmask, so the least
+ unused color is found with a single find-first-zero bit operation
+ rather than with a color detector array of size N.  Each pass over the
+ neighbors tests a window of COLORMASK_BITS colors, starting with the
+ lowest, and since v has only deg(v) neighbors, at most deg(v)/COLORMASK_BITS+1
+ passes are needed.  Planar graphs use only five colors, so they never
+ need more than one pass.
  ********************************************************************/
 
 int _AssignColorToVertex(ColorVerticesContext *context, graphP theGraph, int v)
 {
-	int e, w, color;
+	int e, color, base = 0;
+	unsigned int colorsUsed;
 
-	// Run the neighbor list of v and flag all the colors in use
-    e = gp_GetFirstArc(theGraph, v);
-    while (gp_IsArc(e))
-    {
-         w = gp_GetNeighbor(theGraph, e);
-         context->colorDetector[context->color[w]] = 1;
+	for (;;)
+	{
+		// Run the neighbor list of v and flag the colors in use that are
+		// in the window of colors starting at base
+		colorsUsed = 0;
+		e = gp_GetFirstArc(theGraph, v);
+		while (gp_IsArc(e))
+		{
+			color = context->color[gp_GetNeighbor(theGraph, e)] - base;
+			if (color >= 0 && color < COLORMASK_BITS)
+				colorsUsed |= 1U << color;
 
-         e = gp_GetNextArc(theGraph, e);
-    }
+			e = gp_GetNextArc(theGraph, e);
+		}
 
-    // Find the least numbered unused color and assign it to v
-    // Note that this loop never runs more than deg(v) steps
-    for (color = 0; color < theGraph->N; color++)
-    {
-        if (context->colorDetector[color] == 0)
-        {
-        	context->color[v] = color;
-        	if (context->highestColorUsed < color)
-        		context->highestColorUsed = color;
-        	break;
-        }
-    }
+		if (colorsUsed != ~0U)
+			break;
 
-    if (context->color[v] < 0)
-    	return NOTOK;
+		base += COLORMASK_BITS;
+	}
 
-    // Run the neighbor list of v and unflag all the colors in use
-    e = gp_GetFirstArc(theGraph, v);
-    while (gp_IsArc(e))
-    {
-         w = gp_GetNeighbor(theGraph, e);
-         context->colorDetector[context->color[w]] = 0;
+	// Assign the least numbered unused color to v
+	color = base + _FindFirstZeroBit(colorsUsed);
+	if (color >= theGraph->N)
+		return NOTOK;
 
-         e = gp_GetNextArc(theGraph, e);
-    }
+	context->color[v] = color;
+	if (context->highestColorUsed < color)
+		context->highestColorUsed = color;
 
 	return OK;
 }
 
+#if !defined(__GNUC__) && !defined(_MSC_VER)
+/********************************************************************
+ _ColorVertices_FindFirstZeroBit()
+ Portable version of the find-first-zero operation used by
+ _AssignColorToVertex() for compilers without a bit scan intrinsic.
+ ********************************************************************/
+
+int _ColorVertices_FindFirstZeroBit(unsigned int mask)
+{
+	int pos = 0;
+
+	while (mask & 1U)
+	{
+		mask >>= 1;
+		pos++;
+	}
+
+	return pos;
+}
+#endif
+
 /********************************************************************
  gp_GetNumColorsUsed()
  ********************************************************************/
@@ -58,10 +58,19 @@ extern "C" {
 
 #define COLORVERTICES_NAME "ColorVertices"
 
+// Strategies for gp_ColorVerticesStrategy(), any of which may be combined
+// with COLORVERTICES_LOCALSEARCH to try to reduce the number of colors
+#define COLORVERTICES_STRATEGY_REDUCTION     0
+#define COLORVERTICES_STRATEGY_SMALLESTLAST  1
+#define COLORVERTICES_STRATEGY_DSATUR        2
+#define COLORVERTICES_LOCALSEARCH            16
+
 int gp_AttachColorVertices(graphP theGraph);
 int gp_DetachColorVertices(graphP theGraph);
 
 int gp_ColorVertices(graphP theGraph);
+int gp_ColorVerticesParallel(graphP theGraph, int numThreads);
+int gp_ColorVerticesStrategy(graphP theGraph, int strategy, double timeLimit);
 int gp_GetNumColorsUsed(graphP theGraph);
 int gp_ColorVerticesIntegrityCheck(graphP theGraph, graphP origGraph);
 
@@ -76,10 +76,35 @@ typedef struct
     int *color;
     int numVerticesToReduce, highestColorUsed;
 
-    int *colorDetector;
-
 } ColorVerticesContext;
 
+// The degree of each vertex is cached in the context and maintained by the
+// degree list operations, because the API function gp_GetVertexDegree() is
+// O(deg(v)), which would make the algorithm quadratic in the worst case
+#define _GetVertexDegree(context, v) ((context)->degree[v])
+
+// Colors are assigned using a bitmask of the colors of the neighbors of a
+// vertex, so the number of colors tested at a time is the width of the mask.
+// _FindFirstZeroBit() returns the position of the least significant zero bit
+// of a mask that is not all ones.
+#define COLORMASK_BITS (8 * (int) sizeof(unsigned int))
+
+#if defined(__GNUC__)
+#define _FindFirstZeroBit(mask) __builtin_ctz(~(mask))
+#elif defined(_MSC_VER)
+#include <intrin.h>
+#define _FindFirstZeroBit(mask) _ColorVertices_FindFirstZeroBit(mask)
+static __inline int _ColorVertices_FindFirstZeroBit(unsigned int mask)
+{
+    unsigned long pos;
+    _BitScanForward(&pos, ~mask);
+    return (int) pos;
+}
+#else
+#define _FindFirstZeroBit(mask) _ColorVertices_FindFirstZeroBit(mask)
+int _ColorVertices_FindFirstZeroBit(unsigned int mask);
+#endif
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,816 @@
+/*
+Planarity-Related Graph Algorithms Project
+Copyright (c) 1997-2012, John M. Boyer
+All rights reserved. Includes a reference implementation of the following:
+
+* John M. Boyer. "Subgraph Homeomorphism via the Edge Addition Planarity Algorithm".
+  Journal of Graph Algorithms and Applications, Vol. 16, no. 2, pp. 381-410, 2012.
+  http://www.jgaa.info/16/268.html
+
+* John M. Boyer. "A New Method for Efficiently Generating Planar Graph
+  Visibility Representations". In P. Eades and P. Healy, editors,
+  Proceedings of the 13th International Conference on Graph Drawing 2005,
+  Lecture Notes Comput. Sci., Volume 3843, pp. 508-511, Springer-Verlag, 2006.
+
+* John M. Boyer and Wendy J. Myrvold. "On the Cutting Edge: Simplified O(n)
+  Planarity by Edge Addition". Journal of Graph Algorithms and Applications,
+  Vol. 8, No. 3, pp. 241-273, 2004.
+  http://www.jgaa.info/08/91.html
+
+* John M. Boyer. "Simplified O(n) Algorithms for Planar Graph Embedding,
+  Kuratowski Subgraph Isolation, and Related Problems". Ph.D. Dissertation,
+  University of Victoria, 2001.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+* Redistributions of source code must retain the above copyright notice, this
+  list of conditions and the following disclaimer.
+
+* Redistributions in binary form must reproduce the above copyright notice, this
+  list of conditions and the following disclaimer in the documentation and/or
+  other materials provided with the distribution.
+
+* Neither the name of the Planarity-Related Graph Algorithms Project nor the names
+  of its contributors may be used to endorse or promote products derived from this
+  software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include "graphColorVertices.h"
+#include "graphColorVertices.private.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#ifdef WIN32
+#include <windows.h>
+#else
+#include <pthread.h>
+#endif
+
+extern int COLORVERTICES_ID;
+
+/* Imported functions */
+
+extern int  _GetDefaultNumThreads(void);
+extern void _ColorVertices_Reinitialize(ColorVerticesContext *context);
+
+/* Private definitions */
+
+/* The phases of the reduction and coloring rounds.  In each phase, each
+   thread processes one slice of an array of vertices. */
+
+#define COLORPHASE_INIT         1
+#define COLORPHASE_SELECT       2
+#define COLORPHASE_REMOVE       3
+#define COLORPHASE_COLOR        4
+
+/* A phase on fewer vertices than this is run by the calling thread alone,
+   since starting the threads would cost more than the work saved */
+
+#define COLORPHASE_MINPARALLELSIZE  8192
+
+/* The degree bound of the vertices removed in each round.  Every planar
+   graph has a vertex of degree at most 5. */
+
+#define COLORPARALLEL_DEGREELIMIT   5
+
+#ifdef WIN32
+#define _AtomicAdd(pVar, value) InterlockedExchangeAdd((volatile LONG *) (pVar), (value))
+#else
+#define _AtomicAdd(pVar, value) __sync_fetch_and_add((pVar), (value))
+#endif
+
+typedef struct
+{
+    graphP theGraph;
+    ColorVerticesContext *context;
+    int numThreads, phase, round, degreeLimit;
+
+    // The array of vertices sliced among the threads in the current phase,
+    // or NULL if the phase is over all vertices of the graph
+    int *phaseVertices, phaseSize, phaseThreads;
+
+    // The round in which each vertex was removed, or 0 if it remains
+    int *removalRound;
+
+    // The remaining vertices of degree at most degreeLimit, which are the
+    // candidates for removal in the current round and in the next round
+    int *candidates, numCandidates;
+    int *nextCandidates, numNextCandidates;
+
+    // The removed vertices in order of removal round.  The vertices
+    // removed in round r start at removalOrder[roundStart[r]].
+    int *removalOrder, numRemoved;
+    int *roundStart;
+
+    // The vertices of a coloring round that need a Kempe chain interchange,
+    // and the storage for the breadth first search of the chains
+    int *deferred, numDeferred;
+    int *kempeQueue, *kempeVisited, kempeStamp;
+} colorParallelRec;
+
+typedef colorParallelRec * colorParallelRecP;
+
+typedef struct
+{
+    colorParallelRecP p;
+    int thread;
+} colorThreadRec;
+
+/* Private functions */
+
+int  _ColorParallel_Init(colorParallelRecP p, graphP theGraph, ColorVerticesContext *context, int numThreads);
+void _ColorParallel_Free(colorParallelRecP p);
+void _ColorParallel_RunPhase(colorParallelRecP p, int phase, int *vertices, int size);
+void _ColorParallel_DoPhase(colorParallelRecP p, int thread);
+void _ColorParallel_InitVertex(colorParallelRecP p, int v);
+void _ColorParallel_SelectVertex(colorParallelRecP p, int v);
+void _ColorParallel_RemoveVertex(colorParallelRecP p, int v);
+void _ColorParallel_ColorVertex(colorParallelRecP p, int v);
+int  _ColorParallel_Precedes(colorParallelRecP p, int u, int v);
+void _ColorParallel_RaiseDegreeLimit(colorParallelRecP p);
+int  _ColorParallel_GetLeastFreeColor(colorParallelRecP p, int v, int *pNumColoredNeighbors);
+int  _ColorParallel_ColorDeferredVertex(colorParallelRecP p, int v);
+int  _ColorParallel_RecolorNeighbor(colorParallelRecP p, int u);
+int  _ColorParallel_KempeChainReaches(colorParallelRecP p, int s, int t, int color1, int color2);
+int  _ColorParallel_CompareVertices(const void *a, const void *b);
+
+#ifdef WIN32
+DWORD WINAPI _ColorParallel_Thread(LPVOID param);
+#else
+void *_ColorParallel_Thread(void *param);
+#endif
+
+/********************************************************************
+ gp_ColorVerticesParallel()
+
+ Colors the vertices of theGraph like gp_ColorVertices(), but with a
+ reduction that can be performed by numThreads threads.  If numThreads
+ is zero or less, then the number of online processors is used.
+
+ Rather than removing one minimum degree vertex at a time, each round
+ removes together an independent set of vertices of degree at most 5,
+ namely each such vertex that precedes all of its such neighbors in a
+ pseudorandom order that favors vertices of degree 4 or less.  The
+ degrees of the remaining neighbors are then decremented concurrently.
+ The rounds are then undone in reverse, and the vertices removed in a
+ round are colored concurrently, since they are not adjacent and their
+ colored neighbors are exactly those that remained when they were
+ removed.
+
+ A vertex removed with degree at most 4 always receives one of the
+ first five colors.  A vertex removed with degree 5 may find that its
+ five neighbors use all five colors, so it is deferred to the end of
+ its round and colored by the calling thread, first by trying to give
+ one neighbor a different color, and otherwise by a Kempe chain
+ interchange.  In a planar graph, one of the chains between two of the
+ five neighbors does not connect them (Kempe, 1879), so interchanging
+ its colors frees a color for the vertex.  Hence, planar graphs are
+ colored with at most five colors.
+
+ For a non-planar graph, a round may find no vertex of degree 5 or less,
+ in which case the degree bound is raised to the least remaining degree,
+ and more colors may be used.
+
+ The graph is not modified, except for the colors.  Use
+ gp_ColorVerticesIntegrityCheck() and gp_GetNumColorsUsed() as after
+ gp_ColorVertices().
+
+ Returns OK on success, NOTOK on failure
+ ********************************************************************/
+
+int  gp_ColorVerticesParallel(graphP theGraph, int numThreads)
+{
+ColorVerticesContext *context = NULL;
+colorParallelRec p;
+int v, r, i, RetVal = OK;
+
+    // Attach the algorithm if it is not already attached
+	if (theGraph == NULL || gp_AttachColorVertices(theGraph) != OK)
+		return NOTOK;
+
+	// Get the extension context and reinitialize it if necessary
+    gp_FindExtension(theGraph, COLORVERTICES_ID, (void *)&context);
+
+    if (context->color[0] > -1)
+    	_ColorVertices_Reinitialize(context);
+
+    if (numThreads <= 0)
+    	numThreads = _GetDefaultNumThreads();
+
+    if (_ColorParallel_Init(&p, theGraph, context, numThreads) != OK)
+    {
+    	_ColorParallel_Free(&p);
+    	return NOTOK;
+    }
+
+    // Get the vertex degrees and the initial candidates for removal
+    _ColorParallel_RunPhase(&p, COLORPHASE_INIT, NULL, theGraph->N);
+
+    // Remove an independent set of candidates in each round until no vertices remain
+    while (p.numRemoved < theGraph->N)
+    {
+    	if (p.numCandidates == 0)
+    		_ColorParallel_RaiseDegreeLimit(&p);
+
+    	p.round++;
+    	p.roundStart[p.round] = p.numRemoved;
+    	p.numNextCandidates = 0;
+
+    	_ColorParallel_RunPhase(&p, COLORPHASE_SELECT, p.candidates, p.numCandidates);
+    	_ColorParallel_RunPhase(&p, COLORPHASE_REMOVE, p.removalOrder + p.roundStart[p.round],
+    			                p.numRemoved - p.roundStart[p.round]);
+
+    	// The candidates that were not removed and the vertices whose degree
+    	// dropped to the limit are the candidates for the next round
+    	{
+    		int *temp = p.candidates;
+    		p.candidates = p.nextCandidates;
+    		p.nextCandidates = temp;
+    		p.numCandidates = p.numNextCandidates;
+    	}
+    }
+	p.roundStart[p.round+1] = p.numRemoved;
+
+	// Color the vertices in the reverse order of the rounds
+	for (r = p.round; r > 0 && RetVal == OK; r--)
+	{
+		p.round = r;
+		p.numDeferred = 0;
+
+		_ColorParallel_RunPhase(&p, COLORPHASE_COLOR, p.removalOrder + p.roundStart[r],
+				                p.roundStart[r+1] - p.roundStart[r]);
+
+		// The deferred vertices are colored in vertex order, so that the
+		// result does not depend on the number of threads
+		if (p.numDeferred > 0)
+		{
+			qsort(p.deferred, p.numDeferred, sizeof(int), _ColorParallel_CompareVertices);
+			for (i = 0; i < p.numDeferred && RetVal == OK; i++)
+				RetVal = _ColorParallel_ColorDeferredVertex(&p, p.deferred[i]);
+		}
+	}
+
+	for (v = gp_GetFirstVertex(theGraph); gp_VertexInRange(theGraph, v); v++)
+	{
+		if (context->highestColorUsed < context->color[v])
+			context->highestColorUsed = context->color[v];
+	}
+
+    _ColorParallel_Free(&p);
+	return RetVal;
+}
+
+/********************************************************************
+ _ColorParallel_Init()
+ ********************************************************************/
+
+int  _ColorParallel_Init(colorParallelRecP p, graphP theGraph, ColorVerticesContext *context, int numThreads)
+{
+int VIsize = gp_PrimaryVertexIndexBound(theGraph);
+
+	memset(p, 0, sizeof(colorParallelRec));
+
+	p->theGraph = theGraph;
+	p->context = context;
+	p->numThreads = numThreads;
+	p->degreeLimit = COLORPARALLEL_DEGREELIMIT;
+
+	if ((p->removalRound = (int *) calloc(VIsize, sizeof(int))) == NULL ||
+		(p->candidates = (int *) malloc(VIsize * sizeof(int))) == NULL ||
+		(p->nextCandidates = (int *) malloc(VIsize * sizeof(int))) == NULL ||
+		(p->removalOrder = (int *) malloc(VIsize * sizeof(int))) == NULL ||
+		(p->roundStart = (int *) malloc((VIsize + 1) * sizeof(int))) == NULL ||
+		(p->deferred = (int *) malloc(VIsize * sizeof(int))) == NULL)
+		return NOTOK;
+
+	return OK;
+}
+
+/********************************************************************
+ _ColorParallel_Free()
+ ********************************************************************/
+
+void _ColorParallel_Free(colorParallelRecP p)
+{
+	if (p->removalRound != NULL) free(p->removalRound);
+	if (p->candidates != NULL) free(p->candidates);
+	if (p->nextCandidates != NULL) free(p->nextCandidates);
+	if (p->removalOrder != NULL) free(p->removalOrder);
+	if (p->roundStart != NULL) free(p->roundStart);
+	if (p->deferred != NULL) free(p->deferred);
+	if (p->kempeQueue != NULL) free(p->kempeQueue);
+	if (p->kempeVisited != NULL) free(p->kempeVisited);
+
+	memset(p, 0, sizeof(colorParallelRec));
+}
+
+/********************************************************************
+ _ColorParallel_RunPhase()
+
+ Runs the phase on the given vertices, or on all vertices of the graph
+ if vertices is NULL, by starting numThreads-1 threads and having the
+ calling thread process the first slice.  A small phase, or a phase
+ for which a thread cannot be created, is run by the calling thread.
+ ********************************************************************/
+
+void _ColorParallel_RunPhase(colorParallelRecP p, int phase, int *vertices, int size)
+{
+int  t, numThreads = size < COLORPHASE_MINPARALLELSIZE ? 1 : p->numThreads;
+colorThreadRec *threadRecs = NULL;
+#ifdef WIN32
+HANDLE *threads = NULL;
+#else
+pthread_t *threads = NULL;
+char *started = NULL;
+#endif
+
+     p->phase = phase;
+     p->phaseVertices = vertices;
+     p->phaseSize = size;
+     p->phaseThreads = 1;
+
+     if (numThreads > 1)
+     {
+    	 threadRecs = (colorThreadRec *) malloc(numThreads * sizeof(colorThreadRec));
+#ifdef WIN32
+    	 threads = (HANDLE *) calloc(numThreads, sizeof(HANDLE));
+#else
+    	 threads = (pthread_t *) calloc(numThreads, sizeof(pthread_t));
+    	 started = (char *) calloc(numThreads, sizeof(char));
+#endif
+     }
+
+     if (threadRecs == NULL || threads == NULL)
+    	 _ColorParallel_DoPhase(p, 0);
+     else
+     {
+    	 p->phaseThreads = numThreads;
+    	 for (t = 0; t < numThreads; t++)
+    	 {
+    		 threadRecs[t].p = p;
+    		 threadRecs[t].thread = t;
+    	 }
+
+    	 for (t = 1; t < numThreads; t++)
+    	 {
+#ifdef WIN32
+    		 if ((threads[t] = CreateThread(NULL, 0, _ColorParallel_Thread, threadRecs+t, 0, NULL)) == NULL)
+    			 _ColorParallel_Thread(threadRecs+t);
+#else
+    		 if (started != NULL && pthread_create(threads+t, NULL, _ColorParallel_Thread, threadRecs+t) == 0)
+    			 started[t] = 1;
+    		 else
+    			 _ColorParallel_Thread(threadRecs+t);
+#endif
+    	 }
+
+    	 _ColorParallel_Thread(threadRecs);
+
+    	 for (t = 1; t < numThreads; t++)
+    	 {
+#ifdef WIN32
+    		 if (threads[t] != NULL)
+    		 {
+    			 WaitForSingleObject(threads[t], INFINITE);
+    			 CloseHandle(threads[t]);
+    		 }
+#else
+    		 if (started != NULL && started[t])
+    			 pthread_join(threads[t], NULL);
+#endif
+    	 }
+     }
+
+     if (threadRecs != NULL) free(threadRecs);
+     if (threads != NULL) free(threads);
+#ifndef WIN32
+     if (started != NULL) free(started);
+#endif
+}
+
+/********************************************************************
+ _ColorParallel_Thread()
+ ********************************************************************/
+
+#ifdef WIN32
+DWORD WINAPI _ColorParallel_Thread(LPVOID param)
+#else
+void *_ColorParallel_Thread(void *param)
+#endif
+{
+colorThreadRec *threadRec = (colorThreadRec *) param;
+
+     _ColorParallel_DoPhase(threadRec->p, threadRec->thread);
+     return 0;
+}
+
+/********************************************************************
+ _ColorParallel_DoPhase()
+ Performs the current phase on the slice of the phase vertices that
+ belongs to the given thread.
+ ********************************************************************/
+
+void _ColorParallel_DoPhase(colorParallelRecP p, int thread)
+{
+int  i, v, first, last;
+
+     first = (int) ((double) p->phaseSize * thread / p->phaseThreads);
+     last = (int) ((double) p->phaseSize * (thread + 1) / p->phaseThreads);
+
+     for (i = first; i < last; i++)
+     {
+    	 v = p->phaseVertices == NULL ? gp_GetFirstVertex(p->theGraph) + i : p->phaseVertices[i];
+
+    	 switch (p->phase)
+    	 {
+    	 	 case COLORPHASE_INIT   : _ColorParallel_InitVertex(p, v); break;
+    	 	 case COLORPHASE_SELECT : _ColorParallel_SelectVertex(p, v); break;
+    	 	 case COLORPHASE_REMOVE : _ColorParallel_RemoveVertex(p, v); break;
+    	 	 case COLORPHASE_COLOR  : _ColorParallel_ColorVertex(p, v); break;
+    	 }
+     }
+}
+
+/********************************************************************
+ _ColorParallel_InitVertex()
+ Records the degree of v, and makes v a candidate for removal in the
+ first round if its degree is within the limit.
+ ********************************************************************/
+
+void _ColorParallel_InitVertex(colorParallelRecP p, int v)
+{
+int deg = gp_GetVertexDegree(p->theGraph, v);
+
+	p->context->degree[v] = deg;
+	p->context->color[v] = -1;
+
+	if (deg <= p->degreeLimit)
+		p->candidates[_AtomicAdd(&p->numCandidates, 1)] = v;
+}
+
+/********************************************************************
+ _ColorParallel_Precedes()
+
+ Returns TRUE if the candidate u precedes the candidate v in the order
+ used to choose the independent set of the current round.  Vertices
+ of degree 5 or more follow those of lesser degree, and otherwise the
+ order is given by a hash of the vertex and the round, with the vertex
+ index breaking ties.
+ ********************************************************************/
+
+int  _ColorParallel_Precedes(colorParallelRecP p, int u, int v)
+{
+int *degree = p->context->degree;
+unsigned int uKey, vKey;
+
+	uKey = ((unsigned int) u ^ ((unsigned int) p->round * 0x9E3779B9u)) * 0x85EBCA6Bu;
+	uKey = ((uKey ^ (uKey >> 15)) >> 1) | (degree[u] >= 5 ? 0x80000000u : 0);
+
+	vKey = ((unsigned int) v ^ ((unsigned int) p->round * 0x9E3779B9u)) * 0x85EBCA6Bu;
+	vKey = ((vKey ^ (vKey >> 15)) >> 1) | (degree[v] >= 5 ? 0x80000000u : 0);
+
+	return uKey < vKey || (uKey == vKey && u < v) ? TRUE : FALSE;
+}
+
+/********************************************************************
+ _ColorParallel_SelectVertex()
+
+ Removes the candidate v in the current round if it precedes each of
+ its remaining neighbors that is also a candidate.  Otherwise, v stays
+ a candidate for the next round.  The degrees and removal rounds are
+ only read in this phase, so the selected vertices are independent.
+ ********************************************************************/
+
+void _ColorParallel_SelectVertex(colorParallelRecP p, int v)
+{
+graphP theGraph = p->theGraph;
+int *degree = p->context->degree;
+int e, u, selected = TRUE;
+
+	e = gp_GetFirstArc(theGraph, v);
+	while (gp_IsArc(e))
+	{
+		u = gp_GetNeighbor(theGraph, e);
+		if (p->removalRound[u] == 0 && degree[u] <= p->degreeLimit &&
+			_ColorParallel_Precedes(p, u, v))
+		{
+			selected = FALSE;
+			break;
+		}
+		e = gp_GetNextArc(theGraph, e);
+	}
+
+	if (selected)
+		p->removalOrder[_AtomicAdd(&p->numRemoved, 1)] = v;
+	else
+		p->nextCandidates[_AtomicAdd(&p->numNextCandidates, 1)] = v;
+}
+
+/********************************************************************
+ _ColorParallel_RemoveVertex()
+
+ Records the removal round of the selected vertex v and decrements the
+ degrees of its remaining neighbors.  A neighbor is not selected in the
+ same round, so only the degree is shared among threads, and exactly
+ one thread sees the degree of a neighbor drop to the limit and makes
+ the neighbor a candidate.
+ ********************************************************************/
+
+void _ColorParallel_RemoveVertex(colorParallelRecP p, int v)
+{
+graphP theGraph = p->theGraph;
+int *degree = p->context->degree;
+int e, u;
+
+	p->removalRound[v] = p->round;
+
+	e = gp_GetFirstArc(theGraph, v);
+	while (gp_IsArc(e))
+	{
+		u = gp_GetNeighbor(theGraph, e);
+		if (p->removalRound[u] == 0)
+		{
+			if (_AtomicAdd(&degree[u], -1) == p->degreeLimit + 1)
+				p->nextCandidates[_AtomicAdd(&p->numNextCandidates, 1)] = u;
+		}
+		e = gp_GetNextArc(theGraph, e);
+	}
+}
+
+/********************************************************************
+ _ColorParallel_RaiseDegreeLimit()
+
+ If no remaining vertex has degree within the limit, which does not
+ happen for planar graphs, then the limit is raised to the least
+ remaining degree, and the candidates are the vertices of that degree.
+ ********************************************************************/
+
+void _ColorParallel_RaiseDegreeLimit(colorParallelRecP p)
+{
+graphP theGraph = p->theGraph;
+int *degree = p->context->degree;
+int v;
+
+	p->degreeLimit = theGraph->N;
+	for (v = gp_GetFirstVertex(theGraph); gp_VertexInRange(theGraph, v); v++)
+	{
+		if (p->removalRound[v] == 0 && p->degreeLimit > degree[v])
+			p->degreeLimit = degree[v];
+	}
+
+	p->numCandidates = 0;
+	for (v = gp_GetFirstVertex(theGraph); gp_VertexInRange(theGraph, v); v++)
+	{
+		if (p->removalRound[v] == 0 && degree[v] <= p->degreeLimit)
+			p->candidates[p->numCandidates++] = v;
+	}
+}
+
+/********************************************************************
+ _ColorParallel_GetLeastFreeColor()
+
+ Returns the least color not used by the colored neighbors of v, which
+ are those removed in a later round than v.  Also returns the number of
+ colored neighbors.
+ ********************************************************************/
+
+int  _ColorParallel_GetLeastFreeColor(colorParallelRecP p, int v, int *pNumColoredNeighbors)
+{
+graphP theGraph = p->theGraph;
+int *color = p->context->color;
+unsigned long colorsUsed = 0;
+int e, u, c, n = 0, numBits = (int) (8 * sizeof(colorsUsed));
+
+	e = gp_GetFirstArc(theGraph, v);
+	while (gp_IsArc(e))
+	{
+		u = gp_GetNeighbor(theGraph, e);
+		if (color[u] >= 0)
+		{
+			n++;
+			if (color[u] < numBits)
+				colorsUsed |= 1UL << color[u];
+		}
+		e = gp_GetNextArc(theGraph, e);
+	}
+
+	*pNumColoredNeighbors = n;
+
+	for (c = 0; c < numBits; c++)
+		if ((colorsUsed & (1UL << c)) == 0)
+			return c;
+
+	// All of the low colors are used, so test each higher color
+	for (c = numBits; ; c++)
+	{
+		e = gp_GetFirstArc(theGraph, v);
+		while (gp_IsArc(e) && color[gp_GetNeighbor(theGraph, e)] != c)
+			e = gp_GetNextArc(theGraph, e);
+
+		if (!gp_IsArc(e))
+			return c;
+	}
+}
+
+/********************************************************************
+ _ColorParallel_ColorVertex()
+
+ Colors a vertex v of the current coloring round.  The neighbors of v
+ that are colored are exactly those removed in later rounds, since the
+ vertices of the current round are not adjacent and the vertices of
+ earlier rounds are not yet colored.  If the only free color is a sixth
+ color for a vertex with five colored neighbors, then v is deferred.
+ ********************************************************************/
+
+void _ColorParallel_ColorVertex(colorParallelRecP p, int v)
+{
+int n, c = _ColorParallel_GetLeastFreeColor(p, v, &n);
+
+	if (c >= 5 && n == 5)
+		p->deferred[_AtomicAdd(&p->numDeferred, 1)] = v;
+	else
+		p->context->color[v] = c;
+}
+
+/********************************************************************
+ _ColorParallel_ColorDeferredVertex()
+
+ Colors a vertex v whose five colored neighbors used all five colors
+ when it was deferred.  The colors may since have been changed by the
+ coloring of another deferred vertex, so a free color is sought first.
+ Otherwise, a neighbor is given a different color if it can be, and
+ failing that, a Kempe chain interchange is performed.
+
+ Returns OK, or NOTOK if memory for the Kempe chain search cannot be
+ allocated.
+ ********************************************************************/
+
+int  _ColorParallel_ColorDeferredVertex(colorParallelRecP p, int v)
+{
+graphP theGraph = p->theGraph;
+int *color = p->context->color;
+int neighbors[5], i, j, n = 0, e, c;
+
+	if ((c = _ColorParallel_GetLeastFreeColor(p, v, &n)) < 5)
+	{
+		color[v] = c;
+		return OK;
+	}
+
+	n = 0;
+	e = gp_GetFirstArc(theGraph, v);
+	while (gp_IsArc(e) && n < 5)
+	{
+		if (color[gp_GetNeighbor(theGraph, e)] >= 0)
+			neighbors[n++] = gp_GetNeighbor(theGraph, e);
+		e = gp_GetNextArc(theGraph, e);
+	}
+
+	// If a neighbor can take another of the five colors, then v takes its color
+	for (i = 0; i < 5; i++)
+	{
+		c = color[neighbors[i]];
+		if (_ColorParallel_RecolorNeighbor(p, neighbors[i]) == TRUE)
+		{
+			color[v] = c;
+			return OK;
+		}
+	}
+
+	// Otherwise, seek a pair of neighbors not connected by a chain of their
+	// two colors, and interchange the colors of the chain at the first one
+	if (p->kempeQueue == NULL)
+	{
+		int VIsize = gp_PrimaryVertexIndexBound(theGraph);
+
+		if ((p->kempeQueue = (int *) malloc(VIsize * sizeof(int))) == NULL ||
+			(p->kempeVisited = (int *) calloc(VIsize, sizeof(int))) == NULL)
+			return NOTOK;
+	}
+
+	for (i = 0; i < 4; i++)
+	{
+		for (j = i+1; j < 5; j++)
+		{
+			int ci = color[neighbors[i]], cj = color[neighbors[j]];
+			int qSize = _ColorParallel_KempeChainReaches(p, neighbors[i], neighbors[j], ci, cj);
+
+			if (qSize > 0)
+			{
+				while (qSize > 0)
+				{
+					int u = p->kempeQueue[--qSize];
+					color[u] = color[u] == ci ? cj : ci;
+				}
+				color[v] = ci;
+				return OK;
+			}
+		}
+	}
+
+	// The graph is not planar, so v takes a sixth color
+	color[v] = _ColorParallel_GetLeastFreeColor(p, v, &n);
+	return OK;
+}
+
+/********************************************************************
+ _ColorParallel_RecolorNeighbor()
+
+ Gives the colored vertex u another of the first five colors that is
+ not used by its colored neighbors, if there is one.
+
+ Returns TRUE if u was recolored, FALSE otherwise
+ ********************************************************************/
+
+int  _ColorParallel_RecolorNeighbor(colorParallelRecP p, int u)
+{
+graphP theGraph = p->theGraph;
+int *color = p->context->color;
+int e, w, c, colorsUsed = 1 << color[u];
+
+	e = gp_GetFirstArc(theGraph, u);
+	while (gp_IsArc(e))
+	{
+		w = gp_GetNeighbor(theGraph, e);
+		if (color[w] >= 0 && color[w] < 5)
+			colorsUsed |= 1 << color[w];
+		e = gp_GetNextArc(theGraph, e);
+	}
+
+	for (c = 0; c < 5; c++)
+	{
+		if ((colorsUsed & (1 << c)) == 0)
+		{
+			color[u] = c;
+			return TRUE;
+		}
+	}
+
+	return FALSE;
+}
+
+/********************************************************************
+ _ColorParallel_KempeChainReaches()
+
+ Performs a breadth first search from s through the colored vertices
+ having color1 or color2.  If t is reached, then the search stops and
+ 0 is returned.  Otherwise, the vertices of the chain containing s are
+ in the kempeQueue, and their number is returned.
+ ********************************************************************/
+
+int  _ColorParallel_KempeChainReaches(colorParallelRecP p, int s, int t, int color1, int color2)
+{
+graphP theGraph = p->theGraph;
+int *color = p->context->color;
+int head = 0, tail = 0, e, u, w;
+
+	p->kempeStamp++;
+
+	p->kempeVisited[s] = p->kempeStamp;
+	p->kempeQueue[tail++] = s;
+
+	while (head < tail)
+	{
+		u = p->kempeQueue[head++];
+
+		e = gp_GetFirstArc(theGraph, u);
+		while (gp_IsArc(e))
+		{
+			w = gp_GetNeighbor(theGraph, e);
+			if (p->kempeVisited[w] != p->kempeStamp &&
+				(color[w] == color1 || color[w] == color2))
+			{
+				if (w == t)
+					return 0;
+
+				p->kempeVisited[w] = p->kempeStamp;
+				p->kempeQueue[tail++] = w;
+			}
+			e = gp_GetNextArc(theGraph, e);
+		}
+	}
+
+	return tail;
+}
+
+/********************************************************************
+ _ColorParallel_CompareVertices()
+ ********************************************************************/
+
+int  _ColorParallel_CompareVertices(const void *a, const void *b)
+{
+	return *((const int *) a) - *((const int *) b);
+}
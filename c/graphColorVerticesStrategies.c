@@ -0,0 +1,762 @@
+/*
+Planarity-Related Graph Algorithms Project
+Copyright (c) 1997-2012, John M. Boyer
+All rights reserved. Includes a reference implementation of the following:
+
+* John M. Boyer. "Subgraph Homeomorphism via the Edge Addition Planarity Algorithm".
+  Journal of Graph Algorithms and Applications, Vol. 16, no. 2, pp. 381-410, 2012.
+  http://www.jgaa.info/16/268.html
+
+* John M. Boyer. "A New Method for Efficiently Generating Planar Graph
+  Visibility Representations". In P. Eades and P. Healy, editors,
+  Proceedings of the 13th International Conference on Graph Drawing 2005,
+  Lecture Notes Comput. Sci., Volume 3843, pp. 508-511, Springer-Verlag, 2006.
+
+* John M. Boyer and Wendy J. Myrvold. "On the Cutting Edge: Simplified O(n)
+  Planarity by Edge Addition". Journal of Graph Algorithms and Applications,
+  Vol. 8, No. 3, pp. 241-273, 2004.
+  http://www.jgaa.info/08/91.html
+
+* John M. Boyer. "Simplified O(n) Algorithms for Planar Graph Embedding,
+  Kuratowski Subgraph Isolation, and Related Problems". Ph.D. Dissertation,
+  University of Victoria, 2001.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+* Redistributions of source code must retain the above copyright notice, this
+  list of conditions and the following disclaimer.
+
+* Redistributions in binary form must reproduce the above copyright notice, this
+  list of conditions and the following disclaimer in the documentation and/or
+  other materials provided with the distribution.
+
+* Neither the name of the Planarity-Related Graph Algorithms Project nor the names
+  of its contributors may be used to endorse or promote products derived from this
+  software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include "graphColorVertices.h"
+#include "graphColorVertices.private.h"
+
+#include "platformTime.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+extern int COLORVERTICES_ID;
+
+/* Imported functions */
+
+extern void _ColorVertices_Reinitialize(ColorVerticesContext *context);
+extern int  _AssignColorToVertex(ColorVerticesContext *context, graphP theGraph, int v);
+
+/* Private definitions */
+
+/* The time limit is tested once per this many steps of an algorithm,
+   since reading the clock costs much more than one step */
+
+#define COLORSTRATEGY_TIMECHECKINTERVAL  1024
+
+/* Kempe chain interchanges are tried by the local search only when the
+   highest color is below this bound, since the number of color pairs to
+   try grows quadratically with the number of colors.  The interchanges
+   are what usually take a five-colored planar graph down to four colors. */
+
+#define COLORSTRATEGY_KEMPEMAXCOLORS     8
+
+typedef struct
+{
+    graphP theGraph;
+    ColorVerticesContext *context;
+
+    // The time when the coloring started, the time limit in seconds (or
+    // zero for no limit), and a step counter for testing the time limit
+    platform_time start;
+    double timeLimit;
+    int steps;
+
+    // For DSATUR, the number of distinct colors among the colored neighbors
+    // of each vertex, which are also kept in a bitmask if they are less than
+    // COLORMASK_BITS, and a max-heap of the uncolored vertices
+    int *saturation;
+    unsigned int *saturationMask;
+    int *heap, *heapPos, heapSize;
+
+    // For smallest-last, the vertices in the order they were removed
+    int *order;
+
+    // For the local search, the number of neighbors of a vertex having each
+    // color, a stamp per color for the colors used by the neighbors of one
+    // vertex, and the storage for the breadth first search of Kempe chains
+    int *colorCount;
+    int *colorStamp, stamp;
+    int *kempeQueue, *kempeVisited, kempeStamp;
+} colorStrategyRec;
+
+typedef colorStrategyRec * colorStrategyRecP;
+
+/* Private functions */
+
+int  _ColorStrategy_Init(colorStrategyRecP s, graphP theGraph, ColorVerticesContext *context, double timeLimit);
+void _ColorStrategy_Free(colorStrategyRecP s);
+int  _ColorStrategy_OutOfTime(colorStrategyRecP s);
+
+int  _ColorStrategy_SmallestLast(colorStrategyRecP s);
+
+int  _ColorStrategy_DSatur(colorStrategyRecP s);
+void _ColorStrategy_AddSaturation(colorStrategyRecP s, int w, int u, int c);
+int  _ColorStrategy_HeapPrecedes(colorStrategyRecP s, int u, int w);
+void _ColorStrategy_HeapSiftUp(colorStrategyRecP s, int pos);
+void _ColorStrategy_HeapSiftDown(colorStrategyRecP s, int pos);
+int  _ColorStrategy_HeapPop(colorStrategyRecP s);
+
+int  _ColorStrategy_LocalSearch(colorStrategyRecP s);
+int  _ColorStrategy_RemoveHighestColor(colorStrategyRecP s, int v, int k);
+void _ColorStrategy_CountNeighborColors(colorStrategyRecP s, int v);
+int  _ColorStrategy_RecolorNeighbor(colorStrategyRecP s, int u, int c, int k);
+int  _ColorStrategy_KempeInterchange(colorStrategyRecP s, int v, int a, int b);
+
+/********************************************************************
+ gp_ColorVerticesStrategy()
+
+ Colors the vertices of theGraph with the given strategy, which is one
+ of the following, optionally combined with COLORVERTICES_LOCALSEARCH:
+
+ COLORVERTICES_STRATEGY_REDUCTION - the minimum degree reduction of
+   gp_ColorVertices(), which colors planar graphs with at most five
+   colors but gives no useful bound for non-planar graphs.
+
+ COLORVERTICES_STRATEGY_SMALLESTLAST - repeatedly removes a vertex of
+   minimum degree, then colors the vertices greedily in the reverse
+   order of removal, with the least color not used by a neighbor.
+   Each vertex has at most d colored neighbors when it is colored, where
+   d is the degeneracy of the graph (at most 5 for planar graphs), so at
+   most d+1 colors are used.  Runs in linear time.
+
+ COLORVERTICES_STRATEGY_DSATUR - repeatedly colors an uncolored vertex
+   whose colored neighbors have the most distinct colors (Brelaz, 1979),
+   breaking ties by higher degree then lower index, with the least color
+   not used by a neighbor.  The vertices are kept in a heap keyed by
+   saturation, so it runs in O(M log N) time.  It often uses fewer colors
+   than the other strategies.
+
+ COLORVERTICES_LOCALSEARCH - after the strategy, repeatedly tries to
+   remove the highest color by giving each vertex having it a lower
+   color.  A vertex is recolored directly, or by first recoloring the
+   only neighbor having some lower color, or by a Kempe chain
+   interchange of two lower colors.  It stops at the first vertex that
+   keeps the highest color.
+
+ The timeLimit is in seconds, and zero or less means no limit.  When
+ DSATUR runs out of time, the remaining vertices are colored greedily
+ in heap order, and the local search stops when it runs out of time.
+ The result is a proper coloring in either case.  Smallest-last and
+ the reduction are linear, so they are not limited.
+
+ The graph is not modified, except for the colors.  Use
+ gp_ColorVerticesIntegrityCheck() and gp_GetNumColorsUsed() as after
+ gp_ColorVertices().
+
+ Returns OK on success, NOTOK on failure
+ ********************************************************************/
+
+int  gp_ColorVerticesStrategy(graphP theGraph, int strategy, double timeLimit)
+{
+ColorVerticesContext *context = NULL;
+colorStrategyRec s;
+int v, RetVal = OK;
+
+	if (theGraph == NULL)
+		return NOTOK;
+
+	if ((strategy & ~COLORVERTICES_LOCALSEARCH) == COLORVERTICES_STRATEGY_REDUCTION)
+	{
+		if (gp_ColorVertices(theGraph) != OK)
+			return NOTOK;
+	}
+
+	// Attach the algorithm if it is not already attached
+	if (gp_AttachColorVertices(theGraph) != OK)
+		return NOTOK;
+
+	// Get the extension context and reinitialize it if necessary
+    gp_FindExtension(theGraph, COLORVERTICES_ID, (void *)&context);
+
+    if ((strategy & ~COLORVERTICES_LOCALSEARCH) != COLORVERTICES_STRATEGY_REDUCTION &&
+    	context->color[0] > -1)
+    	_ColorVertices_Reinitialize(context);
+
+    if (_ColorStrategy_Init(&s, theGraph, context, timeLimit) != OK)
+    {
+    	_ColorStrategy_Free(&s);
+    	return NOTOK;
+    }
+
+    switch (strategy & ~COLORVERTICES_LOCALSEARCH)
+    {
+    	case COLORVERTICES_STRATEGY_REDUCTION    : break;
+    	case COLORVERTICES_STRATEGY_SMALLESTLAST : RetVal = _ColorStrategy_SmallestLast(&s); break;
+    	case COLORVERTICES_STRATEGY_DSATUR       : RetVal = _ColorStrategy_DSatur(&s); break;
+    	default                                  : RetVal = NOTOK; break;
+    }
+
+	if (RetVal == OK && (strategy & COLORVERTICES_LOCALSEARCH))
+		RetVal = _ColorStrategy_LocalSearch(&s);
+
+	// Record the highest color, and leave the degree lists empty with
+	// zero degrees, as gp_ColorVertices() expects to find them
+	context->highestColorUsed = -1;
+	for (v = gp_GetFirstVertex(theGraph); gp_VertexInRange(theGraph, v); v++)
+	{
+		if (context->highestColorUsed < context->color[v])
+			context->highestColorUsed = context->color[v];
+		context->degree[v] = 0;
+	}
+
+    _ColorStrategy_Free(&s);
+	return RetVal;
+}
+
+/********************************************************************
+ _ColorStrategy_Init()
+ ********************************************************************/
+
+int  _ColorStrategy_Init(colorStrategyRecP s, graphP theGraph, ColorVerticesContext *context, double timeLimit)
+{
+int VIsize = gp_PrimaryVertexIndexBound(theGraph);
+
+	memset(s, 0, sizeof(colorStrategyRec));
+
+	s->theGraph = theGraph;
+	s->context = context;
+	s->timeLimit = timeLimit;
+	platform_GetTime(s->start);
+
+	if ((s->saturation = (int *) calloc(VIsize, sizeof(int))) == NULL ||
+		(s->saturationMask = (unsigned int *) calloc(VIsize, sizeof(unsigned int))) == NULL ||
+		(s->heap = (int *) malloc(VIsize * sizeof(int))) == NULL ||
+		(s->heapPos = (int *) malloc(VIsize * sizeof(int))) == NULL ||
+		(s->order = (int *) malloc(VIsize * sizeof(int))) == NULL ||
+		(s->colorCount = (int *) calloc(VIsize, sizeof(int))) == NULL ||
+		(s->colorStamp = (int *) calloc(VIsize, sizeof(int))) == NULL ||
+		(s->kempeQueue = (int *) malloc(VIsize * sizeof(int))) == NULL ||
+		(s->kempeVisited = (int *) calloc(VIsize, sizeof(int))) == NULL)
+		return NOTOK;
+
+	return OK;
+}
+
+/********************************************************************
+ _ColorStrategy_Free()
+ ********************************************************************/
+
+void _ColorStrategy_Free(colorStrategyRecP s)
+{
+	if (s->saturation != NULL) free(s->saturation);
+	if (s->saturationMask != NULL) free(s->saturationMask);
+	if (s->heap != NULL) free(s->heap);
+	if (s->heapPos != NULL) free(s->heapPos);
+	if (s->order != NULL) free(s->order);
+	if (s->colorCount != NULL) free(s->colorCount);
+	if (s->colorStamp != NULL) free(s->colorStamp);
+	if (s->kempeQueue != NULL) free(s->kempeQueue);
+	if (s->kempeVisited != NULL) free(s->kempeVisited);
+
+	memset(s, 0, sizeof(colorStrategyRec));
+}
+
+/********************************************************************
+ _ColorStrategy_OutOfTime()
+
+ Counts one step, and returns TRUE if there is a time limit and it
+ has been exceeded, which is tested once per TIMECHECKINTERVAL steps.
+ ********************************************************************/
+
+int  _ColorStrategy_OutOfTime(colorStrategyRecP s)
+{
+platform_time now;
+
+	if (s->timeLimit <= 0 || ++s->steps < COLORSTRATEGY_TIMECHECKINTERVAL)
+		return FALSE;
+
+	s->steps = 0;
+	platform_GetTime(now);
+	return platform_GetDuration(s->start, now) > s->timeLimit ? TRUE : FALSE;
+}
+
+/********************************************************************
+ _ColorStrategy_SmallestLast()
+
+ The vertices are kept in the degree lists of the context by their
+ degree among the vertices not yet removed, and a removed vertex gets
+ degree -1.  The minimum degree drops by at most one per removal, so
+ the search for the next nonempty list takes linear time overall.
+ ********************************************************************/
+
+int  _ColorStrategy_SmallestLast(colorStrategyRecP s)
+{
+graphP theGraph = s->theGraph;
+ColorVerticesContext *context = s->context;
+int *degree = context->degree, *degListHeads = context->degListHeads;
+int v, w, e, i, minDeg = 0;
+
+	// The degree lists are indexed by degree, from 0 to N-1
+	LCReset(context->degLists);
+	for (i = 0; i < theGraph->N; i++)
+		degListHeads[i] = NIL;
+
+	for (v = gp_GetFirstVertex(theGraph); gp_VertexInRange(theGraph, v); v++)
+	{
+		degree[v] = gp_GetVertexDegree(theGraph, v);
+		degListHeads[degree[v]] = LCAppend(context->degLists, degListHeads[degree[v]], v);
+		context->color[v] = -1;
+	}
+
+	// Remove a vertex of minimum degree until none remain
+	for (i = 0; i < theGraph->N; i++)
+	{
+		while (gp_IsNotVertex(degListHeads[minDeg]))
+			minDeg++;
+
+		v = degListHeads[minDeg];
+		degListHeads[minDeg] = LCDelete(context->degLists, degListHeads[minDeg], v);
+		degree[v] = -1;
+		s->order[i] = v;
+
+		e = gp_GetFirstArc(theGraph, v);
+		while (gp_IsArc(e))
+		{
+			w = gp_GetNeighbor(theGraph, e);
+			if (degree[w] > 0)
+			{
+				degListHeads[degree[w]] = LCDelete(context->degLists, degListHeads[degree[w]], w);
+				degree[w]--;
+				degListHeads[degree[w]] = LCAppend(context->degLists, degListHeads[degree[w]], w);
+			}
+			e = gp_GetNextArc(theGraph, e);
+		}
+
+		if (minDeg > 0)
+			minDeg--;
+	}
+
+	// Color the vertices in the reverse order of removal
+	for (i = theGraph->N - 1; i >= 0; i--)
+	{
+		if (_AssignColorToVertex(context, theGraph, s->order[i]) != OK)
+			return NOTOK;
+	}
+
+	return OK;
+}
+
+/********************************************************************
+ _ColorStrategy_DSatur()
+ ********************************************************************/
+
+int  _ColorStrategy_DSatur(colorStrategyRecP s)
+{
+graphP theGraph = s->theGraph;
+ColorVerticesContext *context = s->context;
+int v, w, e, c, i;
+
+	// The heap initially has all vertices, and the vertex degrees are
+	// stored in the context to break ties in saturation
+	s->heapSize = 0;
+	for (v = gp_GetFirstVertex(theGraph); gp_VertexInRange(theGraph, v); v++)
+	{
+		context->degree[v] = gp_GetVertexDegree(theGraph, v);
+		context->color[v] = -1;
+		s->heapPos[v] = s->heapSize;
+		s->heap[s->heapSize++] = v;
+	}
+
+	for (i = s->heapSize/2 - 1; i >= 0; i--)
+		_ColorStrategy_HeapSiftDown(s, i);
+
+	// Color the most saturated vertex until all are colored, or until the
+	// time limit is reached
+	while (s->heapSize > 0 && !_ColorStrategy_OutOfTime(s))
+	{
+		v = _ColorStrategy_HeapPop(s);
+		if (_AssignColorToVertex(context, theGraph, v) != OK)
+			return NOTOK;
+
+		c = context->color[v];
+		e = gp_GetFirstArc(theGraph, v);
+		while (gp_IsArc(e))
+		{
+			w = gp_GetNeighbor(theGraph, e);
+			if (context->color[w] < 0)
+				_ColorStrategy_AddSaturation(s, w, v, c);
+			e = gp_GetNextArc(theGraph, e);
+		}
+	}
+
+	// Out of time, so color the remaining vertices greedily
+	for (i = 0; i < s->heapSize; i++)
+	{
+		if (_AssignColorToVertex(context, theGraph, s->heap[i]) != OK)
+			return NOTOK;
+	}
+	s->heapSize = 0;
+
+	return OK;
+}
+
+/********************************************************************
+ _ColorStrategy_AddSaturation()
+
+ The uncolored vertex w has a neighbor u that just received color c.
+ If no other neighbor of w has color c, then the saturation of w
+ increases, and w moves up in the heap.  Colors below COLORMASK_BITS
+ are tested in the bitmask of w, and higher colors by a scan of the
+ neighbors of w.
+ ********************************************************************/
+
+void _ColorStrategy_AddSaturation(colorStrategyRecP s, int w, int u, int c)
+{
+graphP theGraph = s->theGraph;
+int e, x;
+
+	if (c < COLORMASK_BITS)
+	{
+		if (s->saturationMask[w] & (1U << c))
+			return;
+		s->saturationMask[w] |= 1U << c;
+	}
+	else
+	{
+		e = gp_GetFirstArc(theGraph, w);
+		while (gp_IsArc(e))
+		{
+			x = gp_GetNeighbor(theGraph, e);
+			if (x != u && s->context->color[x] == c)
+				return;
+			e = gp_GetNextArc(theGraph, e);
+		}
+	}
+
+	s->saturation[w]++;
+	_ColorStrategy_HeapSiftUp(s, s->heapPos[w]);
+}
+
+/********************************************************************
+ _ColorStrategy_HeapPrecedes()
+
+ Returns TRUE if u has higher priority than w in the DSATUR heap:
+ greater saturation, then greater degree, then lesser index.
+ ********************************************************************/
+
+int  _ColorStrategy_HeapPrecedes(colorStrategyRecP s, int u, int w)
+{
+	if (s->saturation[u] != s->saturation[w])
+		return s->saturation[u] > s->saturation[w];
+
+	if (s->context->degree[u] != s->context->degree[w])
+		return s->context->degree[u] > s->context->degree[w];
+
+	return u < w;
+}
+
+/********************************************************************
+ _ColorStrategy_HeapSiftUp()
+ ********************************************************************/
+
+void _ColorStrategy_HeapSiftUp(colorStrategyRecP s, int pos)
+{
+int v = s->heap[pos], parent;
+
+	while (pos > 0)
+	{
+		parent = (pos - 1) / 2;
+		if (!_ColorStrategy_HeapPrecedes(s, v, s->heap[parent]))
+			break;
+
+		s->heap[pos] = s->heap[parent];
+		s->heapPos[s->heap[pos]] = pos;
+		pos = parent;
+	}
+
+	s->heap[pos] = v;
+	s->heapPos[v] = pos;
+}
+
+/********************************************************************
+ _ColorStrategy_HeapSiftDown()
+ ********************************************************************/
+
+void _ColorStrategy_HeapSiftDown(colorStrategyRecP s, int pos)
+{
+int v = s->heap[pos], child;
+
+	while ((child = 2*pos + 1) < s->heapSize)
+	{
+		if (child+1 < s->heapSize && _ColorStrategy_HeapPrecedes(s, s->heap[child+1], s->heap[child]))
+			child++;
+
+		if (!_ColorStrategy_HeapPrecedes(s, s->heap[child], v))
+			break;
+
+		s->heap[pos] = s->heap[child];
+		s->heapPos[s->heap[pos]] = pos;
+		pos = child;
+	}
+
+	s->heap[pos] = v;
+	s->heapPos[v] = pos;
+}
+
+/********************************************************************
+ _ColorStrategy_HeapPop()
+ ********************************************************************/
+
+int  _ColorStrategy_HeapPop(colorStrategyRecP s)
+{
+int v = s->heap[0];
+
+	s->heap[0] = s->heap[--s->heapSize];
+	s->heapPos[s->heap[0]] = 0;
+	if (s->heapSize > 0)
+		_ColorStrategy_HeapSiftDown(s, 0);
+
+	return v;
+}
+
+/********************************************************************
+ _ColorStrategy_LocalSearch()
+
+ Removes the highest color k while every vertex having color k can be
+ given a lower color, or until the time limit is reached.
+ ********************************************************************/
+
+int  _ColorStrategy_LocalSearch(colorStrategyRecP s)
+{
+graphP theGraph = s->theGraph;
+int *color = s->context->color;
+int v, k = -1;
+
+	for (v = gp_GetFirstVertex(theGraph); gp_VertexInRange(theGraph, v); v++)
+		if (k < color[v])
+			k = color[v];
+
+	while (k > 0)
+	{
+		for (v = gp_GetFirstVertex(theGraph); gp_VertexInRange(theGraph, v); v++)
+		{
+			if (color[v] == k && !_ColorStrategy_RemoveHighestColor(s, v, k))
+				return OK;
+		}
+		k--;
+	}
+
+	return OK;
+}
+
+/********************************************************************
+ _ColorStrategy_RemoveHighestColor()
+
+ Tries to give v, which has the highest color k, a color less than k.
+
+ Returns TRUE if v was recolored, FALSE if not or if out of time
+ ********************************************************************/
+
+int  _ColorStrategy_RemoveHighestColor(colorStrategyRecP s, int v, int k)
+{
+graphP theGraph = s->theGraph;
+int *color = s->context->color;
+int *colorCount = s->colorCount;
+int e, u, a, b, result = FALSE;
+
+	if (_ColorStrategy_OutOfTime(s))
+		return FALSE;
+
+	_ColorStrategy_CountNeighborColors(s, v);
+
+	// Use a lower color that no neighbor has
+	for (a = 0; a < k && !result; a++)
+	{
+		if (colorCount[a] == 0)
+		{
+			color[v] = a;
+			result = TRUE;
+		}
+	}
+
+	// Or give another color to the only neighbor having a lower color a
+	for (a = 0; a < k && !result; a++)
+	{
+		if (colorCount[a] == 1)
+		{
+			e = gp_GetFirstArc(theGraph, v);
+			while (color[gp_GetNeighbor(theGraph, e)] != a)
+				e = gp_GetNextArc(theGraph, e);
+			u = gp_GetNeighbor(theGraph, e);
+
+			if (_ColorStrategy_RecolorNeighbor(s, u, a, k))
+			{
+				color[v] = a;
+				result = TRUE;
+			}
+		}
+	}
+
+	// Or interchange the colors a and b in the Kempe chains starting from
+	// the neighbors having color a, if they contain no neighbor having color b
+	if (k < COLORSTRATEGY_KEMPEMAXCOLORS)
+	{
+		for (a = 0; a < k && !result; a++)
+		{
+			for (b = 0; b < k && !result; b++)
+			{
+				if (a != b && _ColorStrategy_KempeInterchange(s, v, a, b))
+				{
+					color[v] = a;
+					result = TRUE;
+				}
+			}
+		}
+	}
+
+	// The neighbors of v have colors at most k, and some may have been
+	// recolored, so the counts are cleared by color rather than by neighbor
+	memset(colorCount, 0, (k+1) * sizeof(int));
+
+	return result;
+}
+
+/********************************************************************
+ _ColorStrategy_CountNeighborColors()
+
+ Counts the neighbors of v having each color.
+ ********************************************************************/
+
+void _ColorStrategy_CountNeighborColors(colorStrategyRecP s, int v)
+{
+graphP theGraph = s->theGraph;
+int e;
+
+	e = gp_GetFirstArc(theGraph, v);
+	while (gp_IsArc(e))
+	{
+		s->colorCount[s->context->color[gp_GetNeighbor(theGraph, e)]]++;
+		e = gp_GetNextArc(theGraph, e);
+	}
+}
+
+/********************************************************************
+ _ColorStrategy_RecolorNeighbor()
+
+ Gives u, which has color c, another color less than k that is not
+ used by its neighbors, if there is one.
+
+ Returns TRUE if u was recolored, FALSE otherwise
+ ********************************************************************/
+
+int  _ColorStrategy_RecolorNeighbor(colorStrategyRecP s, int u, int c, int k)
+{
+graphP theGraph = s->theGraph;
+int *color = s->context->color;
+int e, d;
+
+	s->stamp++;
+	s->colorStamp[c] = s->stamp;
+
+	e = gp_GetFirstArc(theGraph, u);
+	while (gp_IsArc(e))
+	{
+		s->colorStamp[color[gp_GetNeighbor(theGraph, e)]] = s->stamp;
+		e = gp_GetNextArc(theGraph, e);
+	}
+
+	for (d = 0; d < k; d++)
+	{
+		if (s->colorStamp[d] != s->stamp)
+		{
+			color[u] = d;
+			return TRUE;
+		}
+	}
+
+	return FALSE;
+}
+
+/********************************************************************
+ _ColorStrategy_KempeInterchange()
+
+ Performs a breadth first search through the vertices having color a
+ or b, starting from the neighbors of v having color a.  If the search
+ reaches a neighbor of v having color b, or the time limit, then it
+ stops and nothing changes.  Otherwise, colors a and b are interchanged
+ in the vertices found, so no neighbor of v has color a anymore.
+
+ Returns TRUE if the colors were interchanged, FALSE otherwise
+ ********************************************************************/
+
+int  _ColorStrategy_KempeInterchange(colorStrategyRecP s, int v, int a, int b)
+{
+graphP theGraph = s->theGraph;
+int *color = s->context->color;
+int head = 0, tail = 0, e, u, w;
+
+	if (s->colorCount[a] == 0)
+		return FALSE;
+
+	s->kempeStamp++;
+
+	e = gp_GetFirstArc(theGraph, v);
+	while (gp_IsArc(e))
+	{
+		w = gp_GetNeighbor(theGraph, e);
+		if (color[w] == a)
+		{
+			s->kempeVisited[w] = s->kempeStamp;
+			s->kempeQueue[tail++] = w;
+		}
+		e = gp_GetNextArc(theGraph, e);
+	}
+
+	while (head < tail)
+	{
+		if (_ColorStrategy_OutOfTime(s))
+			return FALSE;
+
+		u = s->kempeQueue[head++];
+
+		e = gp_GetFirstArc(theGraph, u);
+		while (gp_IsArc(e))
+		{
+			w = gp_GetNeighbor(theGraph, e);
+			if ((color[w] == a || color[w] == b) && s->kempeVisited[w] != s->kempeStamp)
+			{
+				// The chain would give color a to a neighbor of v
+				if (color[w] == b && gp_IsNeighbor(theGraph, v, w))
+					return FALSE;
+
+				s->kempeVisited[w] = s->kempeStamp;
+				s->kempeQueue[tail++] = w;
+			}
+			e = gp_GetNextArc(theGraph, e);
+		}
+	}
+
+	while (tail > 0)
+	{
+		u = s->kempeQueue[--tail];
+		color[u] = color[u] == a ? b : a;
+	}
+
+	return TRUE;
+}
@@ -55,7 +55,6 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 extern void _AddVertexToDegList(ColorVerticesContext *context, graphP theGraph, int v, int deg);
 extern void _RemoveVertexFromDegList(ColorVerticesContext *context, graphP theGraph, int v, int deg);
 extern int  _AssignColorToVertex(ColorVerticesContext *context, graphP theGraph, int v);
-extern int _GetVertexDegree(ColorVerticesContext *context, int v);
 
 /* Forward declarations of local functions */
 
@@ -205,7 +204,6 @@ void _ColorVertices_ClearStructures(ColorVerticesContext *context)
         context->color = NULL;
         context->numVerticesToReduce = 0;
         context->highestColorUsed = -1;
-        context->colorDetector = NULL;
 
         context->initialized = 1;
     }
@@ -232,7 +230,6 @@ void _ColorVertices_ClearStructures(ColorVerticesContext *context)
         }
         context->numVerticesToReduce = 0;
         context->highestColorUsed = -1;
-        context->colorDetector = NULL;
     }
 }
 
@@ -268,7 +265,6 @@ int  _ColorVertices_CreateStructures(ColorVerticesContext *context)
 
      context->numVerticesToReduce = 0;
      context->highestColorUsed = -1;
-     context->colorDetector = NULL;
 
      return OK;
 }
@@ -321,7 +317,6 @@ void *_ColorVertices_DupContext(void *pContext, void *pGraph)
              }
              newContext->numVerticesToReduce = context->numVerticesToReduce;
              newContext->highestColorUsed = context->highestColorUsed;
-             newContext->colorDetector = NULL;
          }
      }
 
@@ -346,7 +341,7 @@ void _ColorVertices_FreeContext(void *pContext)
 int  _ColorVertices_InitGraph(graphP theGraph, int N)
 {
     ColorVerticesContext *context = NULL;
-    gp_FindExtension(theGraph, COLORVERTICES_ID, (void *)&context);
+    context = (ColorVerticesContext *) gp_GetExtensionContext(theGraph, COLORVERTICES_ID);
 
     if (context == NULL)
         return NOTOK;
@@ -381,7 +376,6 @@ void _ColorVertices_Reinitialize(ColorVerticesContext *context)
     }
     context->numVerticesToReduce = 0;
     context->highestColorUsed = -1;
-    context->colorDetector = NULL;
 }
 
 /********************************************************************
@@ -389,7 +383,7 @@ void _ColorVertices_Reinitialize(ColorVerticesContext *context)
 
 void _ColorVertices_ReinitializeGraph(graphP theGraph)
 {
-    ColorVerticesContext *context = (ColorVerticesContext *) gp_GetExtension(theGraph, COLORVERTICES_ID);
+    ColorVerticesContext *context = (ColorVerticesContext *) gp_GetExtensionContext(theGraph, COLORVERTICES_ID);
 
     if (context != NULL)
     {
@@ -406,7 +400,7 @@ void _ColorVertices_ReinitializeGraph(graphP theGraph)
 
 int  _ColorVertices_ReadPostprocess(graphP theGraph, void *extraData, long extraDataSize)
 {
-    ColorVerticesContext *context = (ColorVerticesContext *) gp_GetExtension(theGraph, COLORVERTICES_ID);
+    ColorVerticesContext *context = (ColorVerticesContext *) gp_GetExtensionContext(theGraph, COLORVERTICES_ID);
 
     if (context != NULL)
     {
@@ -448,7 +442,7 @@ int  _ColorVertices_ReadPostprocess(graphP theGraph, void *extraData, long extra
 
 int  _ColorVertices_WritePostprocess(graphP theGraph, void **pExtraData, long *pExtraDataSize)
 {
-    ColorVerticesContext *context = (ColorVerticesContext *) gp_GetExtension(theGraph, COLORVERTICES_ID);
+    ColorVerticesContext *context = (ColorVerticesContext *) gp_GetExtensionContext(theGraph, COLORVERTICES_ID);
 
     if (context != NULL)
     {
@@ -506,7 +500,7 @@ int  _ColorVertices_WritePostprocess(graphP theGraph, void **pExtraData, long *p
  ********************************************************************/
 void _ColorVertices_HideEdge(graphP theGraph, int e)
 {
-    ColorVerticesContext *context = (ColorVerticesContext *) gp_GetExtension(theGraph, COLORVERTICES_ID);
+    ColorVerticesContext *context = (ColorVerticesContext *) gp_GetExtensionContext(theGraph, COLORVERTICES_ID);
 
     if (context != NULL)
     {
@@ -551,7 +545,7 @@ void _ColorVertices_HideEdge(graphP theGraph, int e)
 
 int _ColorVertices_IdentifyVertices(graphP theGraph, int u, int v, int eBefore)
 {
-    ColorVerticesContext *context = (ColorVerticesContext *) gp_GetExtension(theGraph, COLORVERTICES_ID);
+    ColorVerticesContext *context = (ColorVerticesContext *) gp_GetExtensionContext(theGraph, COLORVERTICES_ID);
 
     if (context != NULL)
     {
@@ -582,8 +576,10 @@ int _ColorVertices_IdentifyVertices(graphP theGraph, int u, int v, int eBefore)
 			// common edges with u, they were "hidden", which reduced the degree of v to K.
 			_RemoveVertexFromDegList(context, theGraph, v, K);
 
-	        // We move u from degree list deg(u)-K to degree list deg(u)
-			degu = gp_GetVertexDegree(theGraph, u);
+	        // We move u from degree list deg(u)-K to degree list deg(u). The cached
+			// degree of u is still deg(u)-K because the transferred edges were not
+			// seen by the degree list operations.
+			degu = _GetVertexDegree(context, u) + K;
 			_RemoveVertexFromDegList(context, theGraph, u, degu-K);
 			_AddVertexToDegList(context, theGraph, u, degu);
 		}
@@ -603,7 +599,7 @@ int _ColorVertices_IdentifyVertices(graphP theGraph, int u, int v, int eBefore)
 
 int _ColorVertices_RestoreVertex(graphP theGraph)
 {
-    ColorVerticesContext *context = (ColorVerticesContext *) gp_GetExtension(theGraph, COLORVERTICES_ID);
+    ColorVerticesContext *context = (ColorVerticesContext *) gp_GetExtensionContext(theGraph, COLORVERTICES_ID);
 
     if (context != NULL)
     {
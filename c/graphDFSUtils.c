@@ -52,6 +52,7 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include "graph.h"
 
 extern void _ClearVertexVisitedFlags(graphP theGraph, int);
+extern void _ReleasePreprocessCache(graphP theGraph);
 
 /********************************************************************
  gp_CreateDFSTree
@@ -82,7 +83,9 @@ platform_GetTime(start);
      if (theGraph==NULL) return NOTOK;
      if (theGraph->internalFlags & FLAGS_DFSNUMBERED) return OK;
 
-     gp_LogLine("\ngraphDFSUtils.c/gp_CreateDFSTree() start");
+     _ReleasePreprocessCache(theGraph);
+
+     gp_Trace0(theGraph, TRACE_CREATEDFSTREE_BEGIN);
 
      N = theGraph->N;
      theStack  = theGraph->theStack;
@@ -115,7 +118,7 @@ platform_GetTime(start);
 
               if (!gp_GetVertexVisited(theGraph, u))
               {
-            	  gp_LogLine(gp_MakeLogStr3("V=%d, DFI=%d, Parent=%d", u, DFI, uparent));
+            	  gp_Trace3(theGraph, TRACE_DFS_VISIT, u, DFI, uparent);
 
             	  gp_SetVertexVisited(theGraph, u);
                   gp_SetVertexIndex(theGraph, u, DFI++);
@@ -147,7 +150,7 @@ platform_GetTime(start);
           }
      }
 
-     gp_LogLine("graphDFSUtils.c/gp_CreateDFSTree() end\n");
+     gp_Trace0(theGraph, TRACE_CREATEDFSTREE_END);
 
      theGraph->internalFlags |= FLAGS_DFSNUMBERED;
 
@@ -194,7 +197,7 @@ platform_GetTime(start);
          if (gp_CreateDFSTree(theGraph) != OK)
              return NOTOK;
 
-     gp_LogLine("\ngraphDFSUtils.c/_SortVertices() start");
+     gp_Trace0(theGraph, TRACE_SORTVERTICES_BEGIN);
 
      /* Change labels of edges from v to DFI(v)-- or vice versa
         Also, if any links go back to locations 0 to n-1, then they
@@ -254,7 +257,7 @@ platform_GetTime(start);
 
      theGraph->internalFlags ^= FLAGS_SORTEDBYDFI;
 
-	 gp_LogLine("graphDFSUtils.c/_SortVertices() end\n");
+	 gp_Trace0(theGraph, TRACE_SORTVERTICES_END);
 
 #ifdef PROFILE
 platform_GetTime(end);
@@ -309,7 +312,7 @@ platform_time start, end;
 platform_GetTime(start);
 #endif
 
-	 gp_LogLine("\ngraphDFSUtils.c/gp_LowpointAndLeastAncestor() start");
+	 gp_Trace0(theGraph, TRACE_LOWPOINT_BEGIN);
 
 	 // A stack of size N suffices because at maximum every vertex is pushed only once
 	 // However, since a larger stack is needed for the main DFS, this is mainly documentation
@@ -387,7 +390,7 @@ platform_GetTime(start);
          }
      }
 
-	 gp_LogLine("graphDFSUtils.c/gp_LowpointAndLeastAncestor() end\n");
+	 gp_Trace0(theGraph, TRACE_LOWPOINT_END);
 
 #ifdef PROFILE
 platform_GetTime(end);
@@ -436,7 +439,7 @@ platform_time start, end;
 platform_GetTime(start);
 #endif
 
-	 gp_LogLine("\ngraphDFSUtils.c/gp_LeastAncestor() start");
+	 gp_Trace0(theGraph, TRACE_LEASTANCESTOR_BEGIN);
 
 	 // A stack of size N suffices because at maximum every vertex is pushed only once
 	 if (sp_GetCapacity(theStack) < theGraph->N)
@@ -485,7 +488,7 @@ platform_GetTime(start);
 		 }
 	 }
 
-	 gp_LogLine("graphDFSUtils.c/gp_LeastAncestor() end\n");
+	 gp_Trace0(theGraph, TRACE_LEASTANCESTOR_END);
 
 #ifdef PROFILE
 platform_GetTime(end);
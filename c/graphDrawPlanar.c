@@ -58,7 +58,76 @@ extern int DRAWPLANAR_ID;
 #include <malloc.h>
 #include <stdio.h>
 
+#ifdef WIN32
+#include <windows.h>
+#else
+#include <pthread.h>
+#endif
+
 extern void _ClearVisitedFlags(graphP theGraph);
+extern int  _GetDefaultNumThreads(void);
+
+/* Private definitions for computing the visibility representation.
+   In the position phases, the threads take the connected components
+   one at a time from a shared counter.  In the range phases, each
+   thread processes one slice of the vertex or edge array. */
+
+#define DRAWPHASE_VERTEXPOSITIONS   1
+#define DRAWPHASE_EDGEPOSITIONS     2
+#define DRAWPHASE_EDGENUMBERS       3
+#define DRAWPHASE_VERTEXRANGES      4
+#define DRAWPHASE_EDGERANGES        5
+
+/* A phase on fewer vertices or edges than this is run by the calling
+   thread alone, since starting the threads would cost more than the
+   work saved */
+
+#define DRAWPHASE_MINPARALLELSIZE   8192
+
+#ifdef WIN32
+#define _AtomicAdd(pVar, value) InterlockedExchangeAdd((volatile LONG *) (pVar), (value))
+#else
+#define _AtomicAdd(pVar, value) __sync_fetch_and_add((pVar), (value))
+#endif
+
+typedef struct
+{
+    // The DFS tree root of the component, the first position and number
+    // of its vertices, and the head, first position and number of its
+    // edges in the edge list
+    int root, vertexStart, numVertices;
+    int edgeListHead, edgeStart, numEdges;
+} drawComponentRec;
+
+typedef struct
+{
+    DrawPlanarContext *context;
+    int numThreads, phase, phaseSize, phaseThreads, RetVal;
+
+    // The connected components in order of their DFS tree roots, and the
+    // index of the next component to be taken by a thread in the phase
+    drawComponentRec *components;
+    int numComponents, nextComponent;
+
+    // The depth first search stack of each thread.  The first is the stack
+    // of the graph, and the others exist only if the components are known
+    // to be contiguous so that their sizes can be found in advance.
+    stackP *stacks;
+    int numStacks;
+
+    // The vertices in order of vertex position, and the collections that
+    // hold the vertex order list and edge order list of each component
+    int *vertexOrder;
+    listCollectionP theOrder, edgeList;
+} drawParallelRec;
+
+typedef drawParallelRec * drawParallelRecP;
+
+typedef struct
+{
+    drawParallelRecP p;
+    int thread;
+} drawThreadRec;
 
 /* Private functions exported to system */
 
@@ -69,11 +138,27 @@ int  _ComputeVisibilityRepresentation(DrawPlanarContext *context);
 int  _CheckVisibilityRepresentationIntegrity(DrawPlanarContext *context);
 
 /* Private functions */
-int _ComputeVertexPositions(DrawPlanarContext *context);
-int _ComputeVertexPositionsInComponent(DrawPlanarContext *context, int root, int *pIndex);
-int _ComputeEdgePositions(DrawPlanarContext *context);
-int _ComputeVertexRanges(DrawPlanarContext *context);
-int _ComputeEdgeRanges(DrawPlanarContext *context);
+int _ComputeVertexPositions(drawParallelRecP p);
+int _ComputeVertexPositionsInComponent(DrawPlanarContext *context, int root, listCollectionP theOrder, stackP theStack, int *pVertpos);
+int _ComputeEdgePositions(drawParallelRecP p);
+int _ComputeEdgePositionsInComponent(drawParallelRecP p, drawComponentRec *component);
+int _ComputeVertexRanges(DrawPlanarContext *context, int first, int last);
+int _ComputeEdgeRanges(DrawPlanarContext *context, int first, int last);
+
+int  _DrawParallel_Init(drawParallelRecP p, DrawPlanarContext *context);
+void _DrawParallel_Free(drawParallelRecP p);
+void _DrawParallel_RunPhase(drawParallelRecP p, int phase, int size);
+void _DrawParallel_DoPhase(drawParallelRecP p, int thread);
+#ifdef WIN32
+DWORD WINAPI _DrawParallel_Thread(LPVOID param);
+#else
+void *_DrawParallel_Thread(void *param);
+#endif
+
+int  _RenderRows(DrawPlanarContext *context, FILE *outfile);
+FILE *_OpenDrawingFile(char *theFileName, char *mode);
+int  _CloseDrawingFile(FILE *outfile, char *theFileName);
+int  _WriteCoordinateRecord(FILE *outfile, int Mode, int *record, int size);
 
 /********************************************************************
  _ComputeVisibilityRepresentation()
@@ -83,55 +168,64 @@ int _ComputeEdgeRanges(DrawPlanarContext *context);
   Assign horizontal ranges of vertices
   Assign vertical ranges of edges
 
+  The connected components are positioned concurrently, and the
+  ranges are assigned by parallel loops over the vertices and edges.
  ********************************************************************/
 
 int _ComputeVisibilityRepresentation(DrawPlanarContext *context)
 {
-    if (sp_NonEmpty(context->theGraph->edgeHoles))
-        return NOTOK;
+graphP theEmbedding = context->theGraph;
+drawParallelRec p;
+int RetVal;
 
-    if (_ComputeVertexPositions(context) != OK)
+    if (sp_NonEmpty(theEmbedding->edgeHoles))
         return NOTOK;
 
-    if (_ComputeEdgePositions(context) != OK)
-        return NOTOK;
+    RetVal = _DrawParallel_Init(&p, context);
 
-    if (_ComputeVertexRanges(context) != OK)
-        return NOTOK;
+    if (RetVal == OK)
+        RetVal = _ComputeVertexPositions(&p);
 
-    if (_ComputeEdgeRanges(context) != OK)
-        return NOTOK;
+    if (RetVal == OK)
+        RetVal = _ComputeEdgePositions(&p);
 
-    return OK;
+    if (RetVal == OK)
+    {
+        _DrawParallel_RunPhase(&p, DRAWPHASE_VERTEXRANGES, theEmbedding->N);
+        _DrawParallel_RunPhase(&p, DRAWPHASE_EDGERANGES, theEmbedding->M);
+        RetVal = p.RetVal;
+    }
+
+    _DrawParallel_Free(&p);
+    return RetVal;
 }
 
 /********************************************************************
  _ComputeVertexPositions()
 
   Computes the vertex positions in the graph.  This method accounts
-  for disconnected graphs by finding the DFS tree roots and then,
-  for each, invoking _ComputeVertexPositionsInComponent().
-  The index variable for the positioning is maintained by this method
-  so that the vertices in separate components still get distinct
-  vertex positions.
+  for disconnected graphs by invoking _ComputeVertexPositionsInComponent()
+  for each DFS tree root.  The components are positioned concurrently,
+  each from position zero, so afterward this method gives each component
+  the number of vertices in the preceding components as the offset that
+  makes the vertex positions in separate components distinct.  The
+  offsets are applied by _ComputeEdgePositionsInComponent().
  ********************************************************************/
 
-int _ComputeVertexPositions(DrawPlanarContext *context)
+int _ComputeVertexPositions(drawParallelRecP p)
 {
-	graphP theEmbedding = context->theGraph;
-	int v, vertpos;
+	int c, vertpos;
+
+	_DrawParallel_RunPhase(p, DRAWPHASE_VERTEXPOSITIONS, p->context->theGraph->N);
+	if (p->RetVal != OK)
+		return NOTOK;
 
 	vertpos = 0;
-	for (v = gp_GetFirstVertex(theEmbedding); gp_VertexInRange(theEmbedding, v); v++)
-    {
-        // For each DFS tree root in the embedding, we
-        // compute the vertex positions
-        if (gp_IsDFSTreeRoot(theEmbedding, v))
-        {
-            if (_ComputeVertexPositionsInComponent(context, v, &vertpos) != OK)
-                return NOTOK;
-        }
-    }
+	for (c = 0; c < p->numComponents; c++)
+	{
+		p->components[c].vertexStart = vertpos;
+		vertpos += p->components[c].numVertices;
+	}
 
     return OK;
 }
@@ -229,23 +323,19 @@ int _ComputeVertexPositions(DrawPlanarContext *context)
   based on the between/beyond indicator stored in W during embedding.
  ********************************************************************/
 
-int _ComputeVertexPositionsInComponent(DrawPlanarContext *context, int root, int *pVertpos)
+int _ComputeVertexPositionsInComponent(DrawPlanarContext *context, int root, listCollectionP theOrder, stackP theStack, int *pVertpos)
 {
 graphP theEmbedding = context->theGraph;
-listCollectionP theOrder = LCNew(gp_PrimaryVertexIndexBound(theEmbedding));
 int W, P, C, V, e;
 
-    if (theOrder == NULL)
-        return NOTOK;
-
     // Determine the vertex order using a depth first search with
     // pre-order visitation.
 
-    sp_ClearStack(theEmbedding->theStack);
-    sp_Push(theEmbedding->theStack, root);
-    while (!sp_IsEmpty(theEmbedding->theStack))
+    sp_ClearStack(theStack);
+    sp_Push(theStack, root);
+    while (!sp_IsEmpty(theStack))
     {
-        sp_Pop(theEmbedding->theStack, W);
+        sp_Pop(theStack, W);
 
         P = gp_GetVertexParent(theEmbedding, W);
         V = context->VI[W].ancestor;
@@ -308,7 +398,7 @@ int W, P, C, V, e;
         while (gp_IsArc(e))
         {
             if (gp_GetEdgeType(theEmbedding, e) == EDGE_TYPE_CHILD)
-                sp_Push(theEmbedding->theStack, gp_GetNeighbor(theEmbedding, e));
+                sp_Push(theStack, gp_GetNeighbor(theEmbedding, e));
 
             e = gp_GetNextArc(theEmbedding, e);
         }
@@ -323,76 +413,56 @@ int W, P, C, V, e;
         V = LCGetNext(theOrder, root, V);
     }
 
-    // Clean up and return
-
-    LCFree(&theOrder);
     return OK;
 }
 
 
-#ifdef LOGGING
 /********************************************************************
- _LogEdgeList()
+ _TraceEdgeList()
  Used to show the progressive calculation of the edge position list.
+ Since this traces every edge in the list, it is called only if
+ tracing is enabled.
  ********************************************************************/
-void _LogEdgeList(graphP theEmbedding, listCollectionP edgeList, int edgeListHead)
+void _TraceEdgeList(graphP theEmbedding, listCollectionP edgeList, int edgeListHead)
 {
     int eIndex = edgeListHead, e, eTwin;
 
-    gp_Log("EdgeList: [ ");
-
     while (gp_IsArc(eIndex))
     {
         e = (eIndex << 1);
         eTwin = gp_GetTwinArc(theEmbedding, e);
 
-        gp_Log(gp_MakeLogStr2("(%d, %d) ",
+        gp_Trace2(theEmbedding, TRACE_DRAW_EDGELISTENTRY,
         		gp_GetVertexIndex(theEmbedding, gp_GetNeighbor(theEmbedding, e)),
-        		gp_GetVertexIndex(theEmbedding, gp_GetNeighbor(theEmbedding, eTwin))));
+        		gp_GetVertexIndex(theEmbedding, gp_GetNeighbor(theEmbedding, eTwin)));
 
         eIndex = LCGetNext(edgeList, edgeListHead, eIndex);
     }
-
-    gp_LogLine("]");
 }
-#endif
 
 /********************************************************************
  _ComputeEdgePositions()
 
-  Performs a vertical sweep of the combinatorial planar embedding,
-  developing the edge order in the horizontal sweep line as it
-  advances through the vertices according to their assigned
-  vertical positions.
-
-  The 'visitedInfo' member of each vertex is used to indicate the
-  location in the edge order list of the generator edge for the vertex.
-  The generator edge is the first edge used to visit the vertex from
-  a higher vertex in the drawing (i.e. a vertex with an earlier, or
-  lower, position number).
-
-  All edges added from this vertex to the neighbors below it are
-  added immediately after the generator edge for the vertex.
+  Computes the edge positions in the graph by invoking
+  _ComputeEdgePositionsInComponent() concurrently on the connected
+  components.  The edge order of the whole graph is the concatenation
+  of the edge orders of the components in order of their DFS tree
+  roots, so the edges of each component are numbered starting from
+  the number of edges in the preceding components.
  ********************************************************************/
 
-int _ComputeEdgePositions(DrawPlanarContext *context)
+int _ComputeEdgePositions(drawParallelRecP p)
 {
-graphP theEmbedding = context->theGraph;
-int *vertexOrder = NULL;
-listCollectionP edgeList = NULL;
-int edgeListHead, edgeListInsertPoint;
-int e, eTwin, eCur, v, vpos, epos, eIndex;
+graphP theEmbedding = p->context->theGraph;
+int c, epos;
 
-	gp_LogLine("\ngraphDrawPlanar.c/_ComputeEdgePositions() start");
+	gp_Trace0(theEmbedding, TRACE_COMPUTEEDGEPOSITIONS_BEGIN);
 
-    // Sort the vertices by vertical position (in linear time)
+    // Allocate the array that sorts the vertices by vertical position
 
-    if ((vertexOrder = (int *) malloc(theEmbedding->N * sizeof(int))) == NULL)
+    if ((p->vertexOrder = (int *) malloc(theEmbedding->N * sizeof(int))) == NULL)
         return NOTOK;
 
-	for (v = gp_GetFirstVertex(theEmbedding); gp_VertexInRange(theEmbedding, v); v++)
-        vertexOrder[context->VI[v].pos] = v;
-
     // Allocate the edge list of size M.
     //    This is an array of (prev, next) pointers.
     //    An edge at position X corresponds to the edge
@@ -400,31 +470,87 @@ int e, eTwin, eCur, v, vpos, epos, eIndex;
     //    represented by a pair of adjacent edge records
     //    at index 2X.
 
-    if (theEmbedding->M > 0 && (edgeList = LCNew(gp_GetFirstEdge(theEmbedding)/2+theEmbedding->M)) == NULL)
-    {
-        free(vertexOrder);
+    if (theEmbedding->M > 0 && (p->edgeList = LCNew(gp_GetFirstEdge(theEmbedding)/2+theEmbedding->M)) == NULL)
+        return NOTOK;
+
+    // Sweep the components, which also counts the edges of each
+    _DrawParallel_RunPhase(p, DRAWPHASE_EDGEPOSITIONS, theEmbedding->N);
+    if (p->RetVal != OK)
         return NOTOK;
+
+    epos = 0;
+    for (c = 0; c < p->numComponents; c++)
+    {
+        p->components[c].edgeStart = epos;
+        epos += p->components[c].numEdges;
     }
 
-    edgeListHead = NIL;
+    // Now iterate through the edge lists and assign positions to the edges.
+    _DrawParallel_RunPhase(p, DRAWPHASE_EDGENUMBERS, theEmbedding->M);
+    if (p->RetVal != OK)
+        return NOTOK;
 
-    // Each vertex starts out with a NIL generator edge.
+    gp_Trace0(theEmbedding, TRACE_COMPUTEEDGEPOSITIONS_END);
 
-	for (v = gp_GetFirstVertex(theEmbedding); gp_VertexInRange(theEmbedding, v); v++)
+    return OK;
+}
+
+/********************************************************************
+ _ComputeEdgePositionsInComponent()
+
+  Performs a vertical sweep of the combinatorial planar embedding
+  of the component, developing the edge order in the horizontal
+  sweep line as it advances through the vertices according to their
+  assigned vertical positions.
+
+  The 'visitedInfo' member of each vertex is used to indicate the
+  location in the edge order list of the generator edge for the vertex.
+  The generator edge is the first edge used to visit the vertex from
+  a higher vertex in the drawing (i.e. a vertex with an earlier, or
+  lower, position number).
+
+  All edges added from this vertex to the neighbors below it are
+  added immediately after the generator edge for the vertex.
+ ********************************************************************/
+
+int _ComputeEdgePositionsInComponent(drawParallelRecP p, drawComponentRec *component)
+{
+DrawPlanarContext *context = p->context;
+graphP theEmbedding = context->theGraph;
+listCollectionP edgeList = p->edgeList;
+int *vertexOrder = p->vertexOrder;
+int edgeListHead, edgeListInsertPoint;
+int e, eTwin, eCur, v, vpos, vposBound, eIndex;
+
+    // Offset the vertex positions of the component by the vertices in the
+    // preceding components, and sort the vertices by vertical position
+    // (in linear time).  Each vertex also starts out with a NIL generator edge.
+
+    v = component->root;
+    while (gp_IsVertex(v))
+    {
+        context->VI[v].pos += component->vertexStart;
+        vertexOrder[context->VI[v].pos] = v;
         gp_SetVertexVisitedInfo(theEmbedding, v, NIL);
 
+        v = LCGetNext(p->theOrder, component->root, v);
+    }
+
+    edgeListHead = NIL;
+    component->numEdges = 0;
+
     // Perform the vertical sweep of the combinatorial embedding, using
     // the vertex ordering to guide the sweep.
     // For each vertex, each edge leading to a vertex with a higher number in
     // the vertex order is recorded as the "generator edge", or the edge of
     // first discovery of that higher numbered vertex, unless the vertex already has
     // a recorded generator edge
-	for (vpos = 0; vpos < theEmbedding->N; vpos++)
+    vposBound = component->vertexStart + component->numVertices;
+	for (vpos = component->vertexStart; vpos < vposBound; vpos++)
     {
         // Get the vertex associated with the position
         v = vertexOrder[vpos];
-        gp_LogLine(gp_MakeLogStr3("Processing vertex %d with DFI=%d at position=%d",
-    				 gp_GetVertexIndex(theEmbedding, v), v, vpos));
+        gp_Trace3(theEmbedding, TRACE_DRAW_VERTEXPOSITION, gp_GetVertexIndex(theEmbedding, v), v, vpos);
 
         // The DFS tree root of a connected component is always the least
         // number vertex in the vertex ordering.  We have to give it a
@@ -447,8 +573,9 @@ int e, eTwin, eCur, v, vpos, epos, eIndex;
                 eIndex = (e >> 1); // div by 2 since each edge is a pair of arcs
 
                 edgeListHead = LCAppend(edgeList, edgeListHead, eIndex);
-                gp_LogLine(gp_MakeLogStr2("Append generator edge (%d, %d) to edgeList",
-                		gp_GetVertexIndex(theEmbedding, v), gp_GetVertexIndex(theEmbedding, gp_GetNeighbor(theEmbedding, e))));
+                component->numEdges++;
+                gp_Trace2(theEmbedding, TRACE_DRAW_APPENDEDGE,
+                		gp_GetVertexIndex(theEmbedding, v), gp_GetVertexIndex(theEmbedding, gp_GetNeighbor(theEmbedding, e)));
 
                 // Set the generator edge for the root's neighbor
                 gp_SetVertexVisitedInfo(theEmbedding, gp_GetNeighbor(theEmbedding, e), e);
@@ -485,12 +612,13 @@ int e, eTwin, eCur, v, vpos, epos, eIndex;
                 {
                     eIndex = eCur >> 1;
                     LCInsertAfter(edgeList, edgeListInsertPoint, eIndex);
+                    component->numEdges++;
 
-                    gp_LogLine(gp_MakeLogStr4("Insert (%d, %d) after (%d, %d)",
+                    gp_Trace4(theEmbedding, TRACE_DRAW_INSERTEDGE,
                     		gp_GetVertexIndex(theEmbedding, v),
                     		gp_GetVertexIndex(theEmbedding, gp_GetNeighbor(theEmbedding, eCur)),
                     		gp_GetVertexIndex(theEmbedding, gp_GetNeighbor(theEmbedding, gp_GetTwinArc(theEmbedding, e))),
-                    		gp_GetVertexIndex(theEmbedding, gp_GetNeighbor(theEmbedding, e))));
+                    		gp_GetVertexIndex(theEmbedding, gp_GetNeighbor(theEmbedding, e)));
 
                     edgeListInsertPoint = eIndex;
 
@@ -500,9 +628,9 @@ int e, eTwin, eCur, v, vpos, epos, eIndex;
                     if (gp_IsNotArc(gp_GetVertexVisitedInfo(theEmbedding, gp_GetNeighbor(theEmbedding, eCur))))
                     {
                         gp_SetVertexVisitedInfo(theEmbedding, gp_GetNeighbor(theEmbedding, eCur), eCur);
-                        gp_LogLine(gp_MakeLogStr2("Generator edge (%d, %d)",
+                        gp_Trace2(theEmbedding, TRACE_DRAW_GENERATOREDGE,
                         		gp_GetVertexIndex(theEmbedding, gp_GetNeighbor(theEmbedding, gp_GetTwinArc(theEmbedding, e))),
-                        		gp_GetVertexIndex(theEmbedding, gp_GetNeighbor(theEmbedding, eCur))));
+                        		gp_GetVertexIndex(theEmbedding, gp_GetNeighbor(theEmbedding, eCur)));
                     }
                 }
 
@@ -511,31 +639,11 @@ int e, eTwin, eCur, v, vpos, epos, eIndex;
             }
         }
 
-#ifdef LOGGING
-        _LogEdgeList(theEmbedding, edgeList, edgeListHead);
-#endif
-    }
-
-    // Now iterate through the edgeList and assign positions to the edges.
-    epos = 0;
-    eIndex = edgeListHead;
-    while (gp_IsArc(eIndex))
-    {
-        e = (eIndex << 1);
-        eTwin = gp_GetTwinArc(theEmbedding, e);
-
-        context->E[e].pos = context->E[eTwin].pos = epos;
-
-        epos++;
-
-        eIndex = LCGetNext(edgeList, edgeListHead, eIndex);
+        if (theEmbedding->trace != NULL)
+            _TraceEdgeList(theEmbedding, edgeList, edgeListHead);
     }
 
-    // Clean up and return
-    LCFree(&edgeList);
-    free(vertexOrder);
-
-	gp_LogLine("graphDrawPlanar.c/_ComputeEdgePositions() end\n");
+    component->edgeListHead = edgeListHead;
 
     return OK;
 }
@@ -545,15 +653,16 @@ int e, eTwin, eCur, v, vpos, epos, eIndex;
 
    Assumes edge positions are known (see _ComputeEdgePositions()).
    A vertex spans horizontally the positions of the edges incident
-   to it.
+   to it.  The ranges are computed for the vertices from first up to
+   but not including last.
  ********************************************************************/
 
-int _ComputeVertexRanges(DrawPlanarContext *context)
+int _ComputeVertexRanges(DrawPlanarContext *context, int first, int last)
 {
 	graphP theEmbedding = context->theGraph;
 	int v, e, min, max;
 
-	for (v = gp_GetFirstVertex(theEmbedding); gp_VertexInRange(theEmbedding, v); v++)
+	for (v = first; v < last; v++)
     {
         min = theEmbedding->M + 1;
         max = -1;
@@ -591,21 +700,22 @@ int _ComputeVertexRanges(DrawPlanarContext *context)
  _ComputeEdgeRanges()
 
     Assumes vertex positions are known (see _ComputeVertexPositions()).
-    An edges spans the vertical range of its endpoints.
+    An edges spans the vertical range of its endpoints.  The ranges
+    are computed for the edges whose first arc is from first up to
+    but not including last.
  ********************************************************************/
 
-int _ComputeEdgeRanges(DrawPlanarContext *context)
+int _ComputeEdgeRanges(DrawPlanarContext *context, int first, int last)
 {
 	graphP theEmbedding = context->theGraph;
-	int e, eTwin, EsizeOccupied, v1, v2, pos1, pos2;
+	int e, eTwin, v1, v2, pos1, pos2;
 
 	// Deleted edges are not supported, nor should they be in the embedding, so
 	// this is just a reality check that avoids an in-use test inside the loop
     if (sp_NonEmpty(theEmbedding->edgeHoles))
 		return NOTOK;
 
-	EsizeOccupied = gp_EdgeInUseIndexBound(theEmbedding);
-    for (e = gp_GetFirstEdge(theEmbedding); e < EsizeOccupied; e+=2)
+    for (e = first; e < last; e+=2)
     {
         eTwin = gp_GetTwinArc(theEmbedding, e);
 
@@ -633,6 +743,271 @@ int _ComputeEdgeRanges(DrawPlanarContext *context)
     return OK;
 }
 
+/********************************************************************
+ _DrawParallel_Init()
+
+ Finds the DFS tree roots of the connected components and allocates
+ the vertex order list and the thread stacks.  If the graph is sorted
+ by DFI, then each DFS tree occupies the contiguous range of vertices
+ that starts at its root, so the largest component bounds the size of
+ the stack needed by each thread after the first.
+ ********************************************************************/
+
+int  _DrawParallel_Init(drawParallelRecP p, DrawPlanarContext *context)
+{
+graphP theEmbedding = context->theGraph;
+int v, c, t, size, maxSize;
+
+	memset(p, 0, sizeof(drawParallelRec));
+
+	p->context = context;
+	p->numThreads = context->numThreads > 0 ? context->numThreads : _GetDefaultNumThreads();
+	p->RetVal = OK;
+
+	for (v = gp_GetFirstVertex(theEmbedding); gp_VertexInRange(theEmbedding, v); v++)
+		if (gp_IsDFSTreeRoot(theEmbedding, v))
+			p->numComponents++;
+
+	if ((p->components = (drawComponentRec *) malloc((p->numComponents + 1) * sizeof(drawComponentRec))) == NULL ||
+		(p->theOrder = LCNew(gp_PrimaryVertexIndexBound(theEmbedding))) == NULL ||
+		(p->stacks = (stackP *) calloc(p->numThreads, sizeof(stackP))) == NULL)
+		return NOTOK;
+
+	c = 0;
+	for (v = gp_GetFirstVertex(theEmbedding); gp_VertexInRange(theEmbedding, v); v++)
+		if (gp_IsDFSTreeRoot(theEmbedding, v))
+			p->components[c++].root = v;
+
+	p->stacks[0] = theEmbedding->theStack;
+	p->numStacks = 1;
+
+	if (p->numThreads > 1 && p->numComponents > 1 &&
+		theEmbedding->N >= DRAWPHASE_MINPARALLELSIZE &&
+		(theEmbedding->internalFlags & FLAGS_SORTEDBYDFI))
+	{
+		maxSize = 0;
+		for (c = 0; c < p->numComponents; c++)
+		{
+			size = (c+1 < p->numComponents ? p->components[c+1].root : gp_PrimaryVertexIndexBound(theEmbedding)) -
+				   p->components[c].root;
+			if (maxSize < size)
+				maxSize = size;
+		}
+
+		for (t = 1; t < p->numThreads; t++)
+		{
+			if ((p->stacks[t] = sp_New(maxSize)) == NULL)
+				break;
+			p->numStacks++;
+		}
+	}
+
+	return OK;
+}
+
+/********************************************************************
+ _DrawParallel_Free()
+ The first stack belongs to the graph, so it is not freed.
+ ********************************************************************/
+
+void _DrawParallel_Free(drawParallelRecP p)
+{
+int t;
+
+	if (p->components != NULL) free(p->components);
+	if (p->vertexOrder != NULL) free(p->vertexOrder);
+	LCFree(&p->theOrder);
+	LCFree(&p->edgeList);
+
+	if (p->stacks != NULL)
+	{
+		for (t = 1; t < p->numStacks; t++)
+			sp_Free(&p->stacks[t]);
+		free(p->stacks);
+	}
+
+	memset(p, 0, sizeof(drawParallelRec));
+}
+
+/********************************************************************
+ _DrawParallel_RunPhase()
+
+ Runs the phase by starting up to numThreads-1 threads and having the
+ calling thread also do its part.  The size is the number of vertices
+ or edges processed by the phase.  A small phase, or a phase for which
+ a thread cannot be created, is run by the calling thread, and so is
+ every phase when tracing so that the trace remains in order.
+ ********************************************************************/
+
+void _DrawParallel_RunPhase(drawParallelRecP p, int phase, int size)
+{
+int  t, numThreads = size < DRAWPHASE_MINPARALLELSIZE ? 1 : p->numThreads;
+drawThreadRec *threadRecs = NULL;
+#ifdef WIN32
+HANDLE *threads = NULL;
+#else
+pthread_t *threads = NULL;
+char *started = NULL;
+#endif
+
+     if (phase == DRAWPHASE_VERTEXPOSITIONS && numThreads > p->numStacks)
+    	 numThreads = p->numStacks;
+
+     if (phase != DRAWPHASE_VERTEXRANGES && phase != DRAWPHASE_EDGERANGES &&
+    	 numThreads > p->numComponents)
+    	 numThreads = p->numComponents;
+
+     if (numThreads < 1 || p->context->theGraph->trace != NULL)
+    	 numThreads = 1;
+
+     p->phase = phase;
+     p->phaseSize = size;
+     p->phaseThreads = 1;
+     p->nextComponent = 0;
+
+     if (numThreads > 1)
+     {
+    	 threadRecs = (drawThreadRec *) malloc(numThreads * sizeof(drawThreadRec));
+#ifdef WIN32
+    	 threads = (HANDLE *) calloc(numThreads, sizeof(HANDLE));
+#else
+    	 threads = (pthread_t *) calloc(numThreads, sizeof(pthread_t));
+    	 started = (char *) calloc(numThreads, sizeof(char));
+#endif
+     }
+
+     if (threadRecs == NULL || threads == NULL)
+    	 _DrawParallel_DoPhase(p, 0);
+     else
+     {
+    	 p->phaseThreads = numThreads;
+    	 for (t = 0; t < numThreads; t++)
+    	 {
+    		 threadRecs[t].p = p;
+    		 threadRecs[t].thread = t;
+    	 }
+
+    	 for (t = 1; t < numThreads; t++)
+    	 {
+#ifdef WIN32
+    		 if ((threads[t] = CreateThread(NULL, 0, _DrawParallel_Thread, threadRecs+t, 0, NULL)) == NULL)
+    			 _DrawParallel_Thread(threadRecs+t);
+#else
+    		 if (started != NULL && pthread_create(threads+t, NULL, _DrawParallel_Thread, threadRecs+t) == 0)
+    			 started[t] = 1;
+    		 else
+    			 _DrawParallel_Thread(threadRecs+t);
+#endif
+    	 }
+
+    	 _DrawParallel_Thread(threadRecs);
+
+    	 for (t = 1; t < numThreads; t++)
+    	 {
+#ifdef WIN32
+    		 if (threads[t] != NULL)
+    		 {
+    			 WaitForSingleObject(threads[t], INFINITE);
+    			 CloseHandle(threads[t]);
+    		 }
+#else
+    		 if (started != NULL && started[t])
+    			 pthread_join(threads[t], NULL);
+#endif
+    	 }
+     }
+
+     if (threadRecs != NULL) free(threadRecs);
+     if (threads != NULL) free(threads);
+#ifndef WIN32
+     if (started != NULL) free(started);
+#endif
+}
+
+/********************************************************************
+ _DrawParallel_Thread()
+ ********************************************************************/
+
+#ifdef WIN32
+DWORD WINAPI _DrawParallel_Thread(LPVOID param)
+#else
+void *_DrawParallel_Thread(void *param)
+#endif
+{
+drawThreadRec *threadRec = (drawThreadRec *) param;
+
+     _DrawParallel_DoPhase(threadRec->p, threadRec->thread);
+     return 0;
+}
+
+/********************************************************************
+ _DrawParallel_DoPhase()
+
+ In a range phase, computes the ranges of the slice of the vertices
+ or edges that belongs to the given thread.  In a position phase,
+ takes components from the shared counter until none remain or a
+ thread has failed.
+ ********************************************************************/
+
+void _DrawParallel_DoPhase(drawParallelRecP p, int thread)
+{
+DrawPlanarContext *context = p->context;
+drawComponentRec *component;
+int  c, first, last, vertpos, epos, eIndex, e, RetVal = OK;
+
+     if (p->phase == DRAWPHASE_VERTEXRANGES || p->phase == DRAWPHASE_EDGERANGES)
+     {
+         first = (int) ((double) p->phaseSize * thread / p->phaseThreads);
+         last = (int) ((double) p->phaseSize * (thread + 1) / p->phaseThreads);
+
+         if (p->phase == DRAWPHASE_VERTEXRANGES)
+             RetVal = _ComputeVertexRanges(context, gp_GetFirstVertex(context->theGraph) + first,
+                                                    gp_GetFirstVertex(context->theGraph) + last);
+         else
+             RetVal = _ComputeEdgeRanges(context, gp_GetFirstEdge(context->theGraph) + 2*first,
+                                                  gp_GetFirstEdge(context->theGraph) + 2*last);
+
+         if (RetVal != OK)
+             p->RetVal = NOTOK;
+         return;
+     }
+
+     while (p->RetVal == OK && (c = _AtomicAdd(&p->nextComponent, 1)) < p->numComponents)
+     {
+         component = p->components + c;
+
+         switch (p->phase)
+         {
+             case DRAWPHASE_VERTEXPOSITIONS :
+                 vertpos = 0;
+                 RetVal = _ComputeVertexPositionsInComponent(context, component->root,
+                                                             p->theOrder, p->stacks[thread], &vertpos);
+                 component->numVertices = vertpos;
+                 break;
+
+             case DRAWPHASE_EDGEPOSITIONS :
+                 RetVal = _ComputeEdgePositionsInComponent(p, component);
+                 break;
+
+             case DRAWPHASE_EDGENUMBERS :
+                 epos = component->edgeStart;
+                 eIndex = component->edgeListHead;
+                 while (gp_IsArc(eIndex))
+                 {
+                     e = (eIndex << 1);
+                     context->E[e].pos = context->E[gp_GetTwinArc(context->theGraph, e)].pos = epos;
+                     epos++;
+
+                     eIndex = LCGetNext(p->edgeList, component->edgeListHead, eIndex);
+                 }
+                 break;
+         }
+
+         if (RetVal != OK)
+             p->RetVal = NOTOK;
+     }
+}
+
 /********************************************************************
  _GetNextExternalFaceVertex()
  Uses the extFace links to traverse to the next vertex on the external
@@ -675,9 +1050,7 @@ void _CollectDrawingData(DrawPlanarContext *context, int RootVertex, int W, int
 graphP theEmbedding = context->theGraph;
 int K, Parent, BicompRoot, DFSChild, direction, descendant;
 
-    gp_LogLine("\ngraphDrawPlanar.c/_CollectDrawingData() start");
-    gp_LogLine(gp_MakeLogStr3("_CollectDrawingData(RootVertex=%d, W=%d, W_in=%d)",
-				 RootVertex, W, WPrevLink));
+    gp_Trace3(theEmbedding, TRACE_COLLECTDRAWINGDATA_BEGIN, RootVertex, W, WPrevLink);
 
     /* Process all of the merge points to set their drawing flags. */
 
@@ -713,11 +1086,11 @@ int K, Parent, BicompRoot, DFSChild, direction, descendant;
          direction = theEmbedding->theStack->S[K+1];
          context->VI[Parent].tie[direction] = DFSChild;
 
-         gp_LogLine(gp_MakeLogStr5("V[Parent=%d]=.tie[%d] = V[descendant=%d].tie[%d] = (child=%d)",
-					 Parent, direction, descendant, theEmbedding->theStack->S[K+3], DFSChild));
+         gp_Trace5(theEmbedding, TRACE_DRAW_TIE,
+					 Parent, direction, descendant, theEmbedding->theStack->S[K+3], DFSChild);
     }
 
-    gp_LogLine("graphDrawPlanar.c/_CollectDrawingData() end\n");
+    gp_Trace0(theEmbedding, TRACE_COLLECTDRAWINGDATA_END);
 }
 
 /********************************************************************
@@ -759,14 +1132,12 @@ graphP theEmbedding = context->theGraph;
 int WPredNextLink = 1^WPrevLink,
     WPred = _GetNextExternalFaceVertex(theEmbedding, W, &WPredNextLink);
 
-	gp_LogLine("\ngraphDrawPlanar.c/::_BreakTie() start");
-    gp_LogLine(gp_MakeLogStr4("_BreakTie(BicompRoot=%d, W=%d, W_in=%d) WPred=%d",
-				 BicompRoot, W, WPrevLink, WPred));
+    gp_Trace4(theEmbedding, TRACE_BREAKTIE_BEGIN, BicompRoot, W, WPrevLink, WPred);
 
     /* Ties happen only within a bicomp (i.e. between two non-root vertices) */
     if (gp_IsVirtualVertex(theEmbedding, W) || gp_IsVirtualVertex(theEmbedding, WPred))
     {
-    	gp_LogLine("graphDrawPlanar.c/_BreakTie() end\n");
+    	gp_Trace0(theEmbedding, TRACE_BREAKTIE_END);
         return OK;
     }
 
@@ -787,16 +1158,16 @@ int WPredNextLink = 1^WPrevLink,
         context->VI[DFSChild].ancestorChild = gp_GetDFSChildFromRoot(theEmbedding, BicompRoot);
         context->VI[DFSChild].ancestor = gp_GetPrimaryVertexFromRoot(theEmbedding, BicompRoot);
 
-        gp_LogLine(gp_MakeLogStr4("V[child=%d]=.ancestorChild = %d, V[child=%d]=.ancestor = %d",
-					 DFSChild, context->VI[DFSChild].ancestorChild, DFSChild, context->VI[DFSChild].ancestor));
+        gp_Trace3(theEmbedding, TRACE_DRAW_ANCESTOR,
+					 DFSChild, context->VI[DFSChild].ancestorChild, context->VI[DFSChild].ancestor);
 
         /* If W is the ancestor of WPred, then the DFSChild subtree contains
             WPred, and so must go between W and some ancestor. */
         if (W < WPred)
         {
             context->VI[DFSChild].drawingFlag = DRAWINGFLAG_BETWEEN;
-            gp_LogLine(gp_MakeLogStr3("Child=%d is 'between' ancestorChild=%d and ancestor=%d",
-    					 DFSChild, context->VI[DFSChild].ancestorChild, context->VI[DFSChild].ancestor));
+            gp_Trace3(theEmbedding, TRACE_DRAW_BETWEEN,
+    					 DFSChild, context->VI[DFSChild].ancestorChild, context->VI[DFSChild].ancestor);
         }
 
         /* If W is the descendant, so we achieve the effect of putting WPred
@@ -804,8 +1175,8 @@ int WPredNextLink = 1^WPrevLink,
         else
         {
             context->VI[DFSChild].drawingFlag = DRAWINGFLAG_BEYOND;
-            gp_LogLine(gp_MakeLogStr3("Child=%d is 'beyond' ancestorChild=%d relative to ancestor=%d",
-    					 DFSChild, context->VI[DFSChild].ancestorChild, context->VI[DFSChild].ancestor));
+            gp_Trace3(theEmbedding, TRACE_DRAW_BEYOND,
+    					 DFSChild, context->VI[DFSChild].ancestorChild, context->VI[DFSChild].ancestor);
         }
 
         /* The tie is resolved so clear the flags*/
@@ -813,138 +1184,432 @@ int WPredNextLink = 1^WPrevLink,
         context->VI[WPred].tie[WPredNextLink] = NIL;
     }
 
-	gp_LogLine("graphDrawPlanar.c/_BreakTie() end\n");
+	gp_Trace0(theEmbedding, TRACE_BREAKTIE_END);
     return OK;
 }
 
 /********************************************************************
- _RenderToString()
- Draws the previously calculated visibility representation in a
- string of size (M+1)*2N + 1 characters, which should be deallocated
- with free().
-
- Returns NULL on failure, or the string containing the visibility
- representation otherwise.  The string can be printed using %s,
+ _RenderRows()
+ Draws the previously calculated visibility representation to the
+ outfile, which has 2N rows of M characters each, plus newlines.
+
+ Each vertex position gives two rows, one containing the vertex
+ segment and label, and one below it.  The rows are drawn into two
+ buffers of M+1 characters and written one pair at a time, so memory
+ use is O(N+M) rather than proportional to the size of the drawing.
+ Since each edge has its own column, the column of each edge holds
+ its vertical range, and a row contains '|' in the column of each edge
+ whose range crosses it.
+
+ Returns OK on success, NOTOK on failure
  ********************************************************************/
 
-char *_RenderToString(graphP theEmbedding)
+int _RenderRows(DrawPlanarContext *context, FILE *outfile)
 {
-    DrawPlanarContext *context = NULL;
-    gp_FindExtension(theEmbedding, DRAWPLANAR_ID, (void *) &context);
-
-    if (context != NULL)
+    graphP theEmbedding = context->theGraph;
+    int N = theEmbedding->N;
+    int M = theEmbedding->M;
+    int zeroBasedVertexOffset = (theEmbedding->internalFlags & FLAGS_ZEROBASEDIO) ? gp_GetFirstVertex(theEmbedding) : 0;
+    int n, c, EsizeOccupied, v, vRange, e, Mid, labelLength, RetVal = OK;
+    int *vertexAtPos = (int *) malloc(N * sizeof(int));
+    int *columnStart = (int *) calloc(M + 1, sizeof(int));
+    int *columnEnd = (int *) calloc(M + 1, sizeof(int));
+    char *rowVertex = (char *) malloc((M + 1) * sizeof(char));
+    char *rowBelow = (char *) malloc((M + 1) * sizeof(char));
+    char numBuffer[32];
+
+    if (vertexAtPos == NULL || columnStart == NULL || columnEnd == NULL ||
+        rowVertex == NULL || rowBelow == NULL)
+        RetVal = NOTOK;
+
+    if (RetVal == OK)
     {
-        int N = theEmbedding->N;
-        int M = theEmbedding->M;
-        int zeroBasedVertexOffset = (theEmbedding->internalFlags & FLAGS_ZEROBASEDIO) ? gp_GetFirstVertex(theEmbedding) : 0;
-        int n, m, EsizeOccupied, v, vRange, e, eRange, Mid, Pos;
-        char *visRep = (char *) malloc(sizeof(char) * ((M+1) * 2*N + 1));
-        char numBuffer[32];
-
-        if (visRep == NULL)
-            return NULL;
+        // Get the vertex at each position and the vertical range of each column
+    	for (v = gp_GetFirstVertex(theEmbedding); gp_VertexInRange(theEmbedding, v); v++)
+    		vertexAtPos[context->VI[v].pos] = v;
 
-        if (sp_NonEmpty(context->theGraph->edgeHoles))
+    	EsizeOccupied = gp_EdgeInUseIndexBound(theEmbedding);
+        for (e = gp_GetFirstEdge(theEmbedding); e < EsizeOccupied; e+=2)
         {
-            free(visRep);
-            return NULL;
+            columnStart[context->E[e].pos] = context->E[e].start;
+            columnEnd[context->E[e].pos] = context->E[e].end;
         }
 
-        // Clear the space
-    	for (n = 0; n < N; n++)
-        {
-            for (m=0; m < M; m++)
-            {
-                visRep[(2*n) * (M+1) + m] = ' ';
-                visRep[(2*n+1) * (M+1) + m] = ' ';
-            }
-
-            visRep[(2*n) * (M+1) + M] = '\n';
-            visRep[(2*n+1) * (M+1) + M] = '\n';
-        }
+        rowVertex[M] = rowBelow[M] = '\n';
 
-        // Draw the vertices
-    	for (v = gp_GetFirstVertex(theEmbedding); gp_VertexInRange(theEmbedding, v); v++)
+        for (n = 0; n < N && RetVal == OK; n++)
         {
-            Pos = context->VI[v].pos;
+            // Clear the space
+            memset(rowVertex, ' ', M);
+            memset(rowBelow, ' ', M);
+
+            // Draw the vertex
+            v = vertexAtPos[n];
             for (vRange=context->VI[v].start; vRange <= context->VI[v].end; vRange++)
-                visRep[(2*Pos) * (M+1) + vRange] = '-';
+                rowVertex[vRange] = '-';
 
             // Draw vertex label
             Mid = (context->VI[v].start + context->VI[v].end) / 2;
             sprintf(numBuffer, "%d", v - zeroBasedVertexOffset);
-            if ((unsigned)(context->VI[v].end - context->VI[v].start + 1) >= strlen(numBuffer))
+            labelLength = (int) strlen(numBuffer);
+            if (context->VI[v].end - context->VI[v].start + 1 >= labelLength)
             {
-                strncpy(visRep + (2*Pos) * (M+1) + Mid, numBuffer, strlen(numBuffer));
+                if (labelLength > M - Mid)
+                    labelLength = M - Mid;
+                memcpy(rowVertex + Mid, numBuffer, labelLength);
             }
             // If the vertex width is less than the label width, then fail gracefully
             else
             {
-                if (strlen(numBuffer)==2)
-                    visRep[(2*Pos) * (M+1) + Mid] = numBuffer[0];
+                if (labelLength == 2)
+                    rowVertex[Mid] = numBuffer[0];
                 else
-                    visRep[(2*Pos) * (M+1) + Mid] = '*';
+                    rowVertex[Mid] = '*';
+
+                rowBelow[Mid] = numBuffer[labelLength-1];
+            }
 
-                visRep[(2*Pos+1) * (M+1) + Mid] = numBuffer[strlen(numBuffer)-1];
+            // Draw the edges that cross the rows
+            for (c = 0; c < M; c++)
+            {
+                if (columnStart[c] <= n && n < columnEnd[c])
+                {
+                    if (columnStart[c] < n)
+                        rowVertex[c] = '|';
+                    rowBelow[c] = '|';
+                }
             }
+
+            if (fwrite(rowVertex, sizeof(char), M + 1, outfile) != (size_t) (M + 1) ||
+                fwrite(rowBelow, sizeof(char), M + 1, outfile) != (size_t) (M + 1))
+                RetVal = NOTOK;
         }
+    }
 
-        // Draw the edges
-    	EsizeOccupied = gp_EdgeInUseIndexBound(theEmbedding);
-        for (e = gp_GetFirstEdge(theEmbedding); e < EsizeOccupied; e+=2)
+    if (vertexAtPos != NULL) free(vertexAtPos);
+    if (columnStart != NULL) free(columnStart);
+    if (columnEnd != NULL) free(columnEnd);
+    if (rowVertex != NULL) free(rowVertex);
+    if (rowBelow != NULL) free(rowBelow);
+
+    return RetVal;
+}
+
+/********************************************************************
+ _OpenDrawingFile()
+ Opens the named file for writing in the given mode, or returns stdout
+ or stderr for those names.
+ ********************************************************************/
+
+FILE *_OpenDrawingFile(char *theFileName, char *mode)
+{
+    if (strcmp(theFileName, "stdout") == 0)
+         return stdout;
+    else if (strcmp(theFileName, "stderr") == 0)
+         return stderr;
+    else return fopen(theFileName, mode);
+}
+
+/********************************************************************
+ _CloseDrawingFile()
+ Returns OK if the file was flushed or closed, NOTOK otherwise.
+ ********************************************************************/
+
+int _CloseDrawingFile(FILE *outfile, char *theFileName)
+{
+    if (strcmp(theFileName, "stdout") == 0 || strcmp(theFileName, "stderr") == 0)
+        return fflush(outfile) == 0 ? OK : NOTOK;
+
+    return fclose(outfile) == 0 ? OK : NOTOK;
+}
+
+/********************************************************************
+ gp_DrawPlanar_RenderToFile()
+ Writes a rendition of the planar graph visibility representation
+ to the file, one pair of rows at a time.
+ ********************************************************************/
+int gp_DrawPlanar_RenderToFile(graphP theEmbedding, char *theFileName)
+{
+    DrawPlanarContext *context = NULL;
+    gp_FindExtension(theEmbedding, DRAWPLANAR_ID, (void *) &context);
+
+    if (context != NULL && sp_IsEmpty(theEmbedding->edgeHoles))
+    {
+        FILE *outfile = _OpenDrawingFile(theFileName, WRITETEXT);
+        int RetVal;
+
+        if (outfile == NULL)
+            return NOTOK;
+
+        RetVal = _RenderRows(context, outfile);
+
+        if (_CloseDrawingFile(outfile, theFileName) != OK)
+            RetVal = NOTOK;
+
+        return RetVal;
+    }
+
+    return NOTOK;
+}
+
+/********************************************************************
+ gp_DrawPlanar_WriteCoordinates()
+ Writes the previously calculated visibility representation as a
+ list of coordinates, which takes O(N+M) space rather than the
+ O(NM) space of a rendition.
+
+ In DRAWPLANAR_WRITE_TEXT mode, the first line has N and M, then
+ there is one line per vertex, in vertex order, with its
+ "pos start end", then one line per edge with its "u v pos start end",
+ where u and v are the endpoint vertices.  A vertex has vertical
+ position pos and horizontal range start to end, and an edge has
+ horizontal position pos and vertical range start to end.
+
+ In DRAWPLANAR_WRITE_BINARY mode, the same integers are written in
+ the same order as 32-bit little-endian two's complement values.
+
+ Returns OK on success, NOTOK on failure
+ ********************************************************************/
+
+int gp_DrawPlanar_WriteCoordinates(graphP theEmbedding, char *theFileName, int Mode)
+{
+    DrawPlanarContext *context = NULL;
+    gp_FindExtension(theEmbedding, DRAWPLANAR_ID, (void *) &context);
+
+    if (context != NULL && (Mode == DRAWPLANAR_WRITE_TEXT || Mode == DRAWPLANAR_WRITE_BINARY))
+    {
+        int zeroBasedVertexOffset = (theEmbedding->internalFlags & FLAGS_ZEROBASEDIO) ? gp_GetFirstVertex(theEmbedding) : 0;
+        int v, e, EsizeOccupied, record[5], RetVal = OK;
+        FILE *outfile = _OpenDrawingFile(theFileName, Mode == DRAWPLANAR_WRITE_TEXT ? WRITETEXT : "wb");
+
+        if (outfile == NULL)
+            return NOTOK;
+
+        record[0] = theEmbedding->N;
+        record[1] = theEmbedding->M;
+        RetVal = _WriteCoordinateRecord(outfile, Mode, record, 2);
+
+        for (v = gp_GetFirstVertex(theEmbedding); gp_VertexInRange(theEmbedding, v) && RetVal == OK; v++)
+        {
+            record[0] = context->VI[v].pos;
+            record[1] = context->VI[v].start;
+            record[2] = context->VI[v].end;
+            RetVal = _WriteCoordinateRecord(outfile, Mode, record, 3);
+        }
+
+        EsizeOccupied = gp_EdgeInUseIndexBound(theEmbedding);
+        for (e = gp_GetFirstEdge(theEmbedding); e < EsizeOccupied && RetVal == OK; e+=2)
         {
-            Pos = context->E[e].pos;
-            for (eRange=context->E[e].start; eRange < context->E[e].end; eRange++)
+            if (gp_EdgeInUse(theEmbedding, e))
             {
-                if (eRange > context->E[e].start)
-                    visRep[(2*eRange) * (M+1) + Pos] = '|';
-                visRep[(2*eRange+1) * (M+1) + Pos] = '|';
+                record[0] = gp_GetNeighbor(theEmbedding, gp_GetTwinArc(theEmbedding, e)) - zeroBasedVertexOffset;
+                record[1] = gp_GetNeighbor(theEmbedding, e) - zeroBasedVertexOffset;
+                record[2] = context->E[e].pos;
+                record[3] = context->E[e].start;
+                record[4] = context->E[e].end;
+                RetVal = _WriteCoordinateRecord(outfile, Mode, record, 5);
             }
         }
 
-        // Null terminate string and return it
-        visRep[(M+1) * 2*N] = '\0';
-        return visRep;
+        if (_CloseDrawingFile(outfile, theFileName) != OK)
+            RetVal = NOTOK;
+
+        return RetVal;
     }
 
-    return NULL;
+    return NOTOK;
 }
 
 /********************************************************************
- gp_DrawPlanar_RenderToFile()
- Creates a rendition of the planar graph visibility representation
- as a string, then dumps the string to the file.
+ _WriteCoordinateRecord()
+ Writes the integers of one line of gp_DrawPlanar_WriteCoordinates().
  ********************************************************************/
-int gp_DrawPlanar_RenderToFile(graphP theEmbedding, char *theFileName)
+
+int _WriteCoordinateRecord(FILE *outfile, int Mode, int *record, int size)
 {
-    if (sp_IsEmpty(theEmbedding->edgeHoles))
+    unsigned char bytes[20];
+    int i;
+
+    if (Mode == DRAWPLANAR_WRITE_TEXT)
+    {
+        for (i = 0; i < size; i++)
+        {
+            if (fprintf(outfile, i < size-1 ? "%d " : "%d\n", record[i]) < 0)
+                return NOTOK;
+        }
+        return OK;
+    }
+
+    for (i = 0; i < size; i++)
     {
-        FILE *outfile;
-        char *theRendition;
+        unsigned int value = (unsigned int) record[i];
+        bytes[4*i] = (unsigned char) (value & 0xFF);
+        bytes[4*i+1] = (unsigned char) ((value >> 8) & 0xFF);
+        bytes[4*i+2] = (unsigned char) ((value >> 16) & 0xFF);
+        bytes[4*i+3] = (unsigned char) ((value >> 24) & 0xFF);
+    }
+
+    return fwrite(bytes, sizeof(unsigned char), 4*size, outfile) == (size_t) (4*size) ? OK : NOTOK;
+}
+
+/********************************************************************
+ gp_DrawPlanar_WriteSVG()
+ Writes the previously calculated visibility representation as an
+ SVG image, in one pass over the vertices and edges.
+
+ Each vertex is a thick horizontal line at the height of its position,
+ spanning its horizontal range, and labelled with the vertex number.
+ Each edge is a thin vertical line in the column of its position,
+ spanning its vertical range.  One unit of the representation is
+ DRAWPLANAR_SVG_UNIT units of the image, and the image has a viewBox
+ rather than a fixed size, so a viewer can scale it freely.
+
+ Returns OK on success, NOTOK on failure
+ ********************************************************************/
+
+#define DRAWPLANAR_SVG_UNIT 10
+
+int gp_DrawPlanar_WriteSVG(graphP theEmbedding, char *theFileName)
+{
+    DrawPlanarContext *context = NULL;
+    gp_FindExtension(theEmbedding, DRAWPLANAR_ID, (void *) &context);
 
-        if (strcmp(theFileName, "stdout") == 0)
-             outfile = stdout;
-        else if (strcmp(theFileName, "stderr") == 0)
-             outfile = stderr;
-        else outfile = fopen(theFileName, WRITETEXT);
+    if (context != NULL)
+    {
+        int zeroBasedVertexOffset = (theEmbedding->internalFlags & FLAGS_ZEROBASEDIO) ? gp_GetFirstVertex(theEmbedding) : 0;
+        int unit = DRAWPLANAR_SVG_UNIT, v, e, EsizeOccupied, RetVal = OK;
+        FILE *outfile = _OpenDrawingFile(theFileName, WRITETEXT);
 
         if (outfile == NULL)
             return NOTOK;
 
-        theRendition = _RenderToString(theEmbedding);
-        if (theRendition != NULL)
+        if (fprintf(outfile, "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n"
+                             "<svg xmlns=\"http://www.w3.org/2000/svg\" viewBox=\"%d %d %d %d\">\n",
+                             -unit, -unit,
+                             (theEmbedding->M > 0 ? theEmbedding->M : 1) * unit + unit,
+                             theEmbedding->N * unit + unit) < 0)
+            RetVal = NOTOK;
+
+        // The edges are drawn first, so that the vertices are drawn over their ends
+        if (RetVal == OK && fprintf(outfile, "<g stroke=\"black\" stroke-width=\"1\">\n") < 0)
+            RetVal = NOTOK;
+
+        EsizeOccupied = gp_EdgeInUseIndexBound(theEmbedding);
+        for (e = gp_GetFirstEdge(theEmbedding); e < EsizeOccupied && RetVal == OK; e+=2)
         {
-            fprintf(outfile, "%s", theRendition);
-            free(theRendition);
+            if (gp_EdgeInUse(theEmbedding, e))
+            {
+                if (fprintf(outfile, "<line x1=\"%d\" y1=\"%d\" x2=\"%d\" y2=\"%d\"/>\n",
+                                     context->E[e].pos * unit, context->E[e].start * unit,
+                                     context->E[e].pos * unit, context->E[e].end * unit) < 0)
+                    RetVal = NOTOK;
+            }
         }
 
-        if (strcmp(theFileName, "stdout") == 0 || strcmp(theFileName, "stderr") == 0)
-            fflush(outfile);
+        if (RetVal == OK && fprintf(outfile, "</g>\n<g stroke=\"black\" stroke-width=\"%d\" stroke-linecap=\"round\">\n", unit/3) < 0)
+            RetVal = NOTOK;
 
-        else if (fclose(outfile) != 0)
+        for (v = gp_GetFirstVertex(theEmbedding); gp_VertexInRange(theEmbedding, v) && RetVal == OK; v++)
+        {
+            if (fprintf(outfile, "<line x1=\"%d\" y1=\"%d\" x2=\"%d\" y2=\"%d\"/>\n",
+                                 context->VI[v].start * unit, context->VI[v].pos * unit,
+                                 context->VI[v].end * unit, context->VI[v].pos * unit) < 0)
+                RetVal = NOTOK;
+        }
+
+        // The labels are above the middle of each vertex
+        if (RetVal == OK && fprintf(outfile, "</g>\n<g font-family=\"sans-serif\" font-size=\"%d\" text-anchor=\"middle\">\n", unit/2 + 1) < 0)
+            RetVal = NOTOK;
+
+        for (v = gp_GetFirstVertex(theEmbedding); gp_VertexInRange(theEmbedding, v) && RetVal == OK; v++)
+        {
+            if (fprintf(outfile, "<text x=\"%d\" y=\"%d\">%d</text>\n",
+                                 (context->VI[v].start + context->VI[v].end) * unit / 2,
+                                 context->VI[v].pos * unit - unit/4,
+                                 v - zeroBasedVertexOffset) < 0)
+                RetVal = NOTOK;
+        }
+
+        if (RetVal == OK && fprintf(outfile, "</g>\n</svg>\n") < 0)
+            RetVal = NOTOK;
+
+        if (_CloseDrawingFile(outfile, theFileName) != OK)
+            RetVal = NOTOK;
+
+        return RetVal;
+    }
+
+    return NOTOK;
+}
+
+/********************************************************************
+ gp_DrawPlanar_WriteJSON()
+ Writes the previously calculated visibility representation as a
+ JSON object, in one pass over the vertices and edges, like this:
+
+ {"N":3,"M":2,
+  "vertices":[{"v":1,"pos":0,"start":0,"end":1}, ...],
+  "edges":[{"u":1,"v":2,"pos":0,"start":0,"end":1}, ...]}
+
+ A vertex has vertical position pos and horizontal range start to end,
+ and an edge between vertices u and v has horizontal position pos and
+ vertical range start to end.
+
+ Returns OK on success, NOTOK on failure
+ ********************************************************************/
+
+int gp_DrawPlanar_WriteJSON(graphP theEmbedding, char *theFileName)
+{
+    DrawPlanarContext *context = NULL;
+    gp_FindExtension(theEmbedding, DRAWPLANAR_ID, (void *) &context);
+
+    if (context != NULL)
+    {
+        int zeroBasedVertexOffset = (theEmbedding->internalFlags & FLAGS_ZEROBASEDIO) ? gp_GetFirstVertex(theEmbedding) : 0;
+        int v, e, EsizeOccupied, RetVal = OK;
+        char *separator = "";
+        FILE *outfile = _OpenDrawingFile(theFileName, WRITETEXT);
+
+        if (outfile == NULL)
             return NOTOK;
 
-        return theRendition ? OK : NOTOK;
+        if (fprintf(outfile, "{\"N\":%d,\"M\":%d,\n\"vertices\":[", theEmbedding->N, theEmbedding->M) < 0)
+            RetVal = NOTOK;
+
+        for (v = gp_GetFirstVertex(theEmbedding); gp_VertexInRange(theEmbedding, v) && RetVal == OK; v++)
+        {
+            if (fprintf(outfile, "%s\n{\"v\":%d,\"pos\":%d,\"start\":%d,\"end\":%d}", separator,
+                                 v - zeroBasedVertexOffset,
+                                 context->VI[v].pos, context->VI[v].start, context->VI[v].end) < 0)
+                RetVal = NOTOK;
+            separator = ",";
+        }
+
+        if (RetVal == OK && fprintf(outfile, "],\n\"edges\":[") < 0)
+            RetVal = NOTOK;
+
+        separator = "";
+        EsizeOccupied = gp_EdgeInUseIndexBound(theEmbedding);
+        for (e = gp_GetFirstEdge(theEmbedding); e < EsizeOccupied && RetVal == OK; e+=2)
+        {
+            if (gp_EdgeInUse(theEmbedding, e))
+            {
+                if (fprintf(outfile, "%s\n{\"u\":%d,\"v\":%d,\"pos\":%d,\"start\":%d,\"end\":%d}", separator,
+                                     gp_GetNeighbor(theEmbedding, gp_GetTwinArc(theEmbedding, e)) - zeroBasedVertexOffset,
+                                     gp_GetNeighbor(theEmbedding, e) - zeroBasedVertexOffset,
+                                     context->E[e].pos, context->E[e].start, context->E[e].end) < 0)
+                    RetVal = NOTOK;
+                separator = ",";
+            }
+        }
+
+        if (RetVal == OK && fprintf(outfile, "]}\n") < 0)
+            RetVal = NOTOK;
+
+        if (_CloseDrawingFile(outfile, theFileName) != OK)
+            RetVal = NOTOK;
+
+        return RetVal;
     }
 
     return NOTOK;
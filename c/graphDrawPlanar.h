@@ -61,8 +61,17 @@ extern "C" {
 int gp_AttachDrawPlanar(graphP theGraph);
 int gp_DetachDrawPlanar(graphP theGraph);
 
+int  gp_DrawPlanar_SetNumThreads(graphP theGraph, int numThreads);
+
 int  gp_DrawPlanar_RenderToFile(graphP theEmbedding, char *theFileName);
 
+#define DRAWPLANAR_WRITE_TEXT   1
+#define DRAWPLANAR_WRITE_BINARY 2
+
+int  gp_DrawPlanar_WriteCoordinates(graphP theEmbedding, char *theFileName, int Mode);
+int  gp_DrawPlanar_WriteSVG(graphP theEmbedding, char *theFileName);
+int  gp_DrawPlanar_WriteJSON(graphP theEmbedding, char *theFileName);
+
 #ifdef __cplusplus
 }
 #endif
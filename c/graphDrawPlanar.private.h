@@ -115,8 +115,14 @@ typedef struct
     // The graph that this context augments
     graphP theGraph;
 
-    // Parallel array for additional edge level equipment
+    // The number of threads used to compute the visibility representation,
+    // or 0 to use the number of online processors
+    int numThreads;
+
+    // Parallel array for additional edge level equipment, and the
+    // memory that holds it so that it can grow with the arc capacity
     DrawPlanar_EdgeRecP E;
+    platform_memory EMemory;
 
     // Parallel array for additional vertex level equipment
     DrawPlanar_VertexInfoP VI;
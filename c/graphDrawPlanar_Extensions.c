@@ -123,7 +123,7 @@ int  gp_AttachDrawPlanar(graphP theGraph)
 
      // If the drawing feature has already been attached to the graph,
      // then there is no need to attach it again
-     gp_FindExtension(theGraph, DRAWPLANAR_ID, (void *)&context);
+     gp_FindExtension(theGraph, DRAWPLANAR_ID, (void *) &context);
      if (context != NULL)
      {
          return OK;
@@ -142,6 +142,9 @@ int  gp_AttachDrawPlanar(graphP theGraph)
      // Save a pointer to theGraph in the context
      context->theGraph = theGraph;
 
+     // Use the default number of threads for computing the drawing
+     context->numThreads = 0;
+
      // Put the overload functions into the context function table.
      // gp_AddExtension will overload the graph's functions with these, and
      // return the base function pointers in the context function table
@@ -203,6 +206,30 @@ int gp_DetachDrawPlanar(graphP theGraph)
     return gp_RemoveExtension(theGraph, DRAWPLANAR_ID);
 }
 
+/********************************************************************
+ gp_DrawPlanar_SetNumThreads()
+
+ Sets the number of threads used to compute the visibility
+ representation after the embedding.  The connected components are
+ positioned concurrently, and the vertex and edge ranges are computed
+ by parallel loops.  If numThreads is 0 or less, then the number of
+ online processors is used, which is the default.
+
+ Returns OK, or NOTOK if the feature is not attached to the graph.
+ ********************************************************************/
+
+int gp_DrawPlanar_SetNumThreads(graphP theGraph, int numThreads)
+{
+    DrawPlanarContext *context = NULL;
+
+    gp_FindExtension(theGraph, DRAWPLANAR_ID, (void *) &context);
+    if (context == NULL)
+        return NOTOK;
+
+    context->numThreads = numThreads > 0 ? numThreads : 0;
+    return OK;
+}
+
 /********************************************************************
  _DrawPlanar_ClearStructures()
  ********************************************************************/
@@ -214,17 +241,15 @@ void _DrawPlanar_ClearStructures(DrawPlanarContext *context)
         // Before initialization, the pointers are stray, not NULL
         // Once NULL or allocated, free() or LCFree() can do the job
         context->E = NULL;
+        platform_InitMemory(&context->EMemory);
         context->VI = NULL;
 
         context->initialized = 1;
     }
     else
     {
-        if (context->E != NULL)
-        {
-            free(context->E);
-            context->E = NULL;
-        }
+        platform_FreeMemory(&context->EMemory);
+        context->E = NULL;
         if (context->VI != NULL)
         {
             free(context->VI);
@@ -247,7 +272,7 @@ int  _DrawPlanar_CreateStructures(DrawPlanarContext *context)
      if (theGraph->N <= 0)
          return NOTOK;
 
-     if ((context->E = (DrawPlanar_EdgeRecP) malloc(Esize*sizeof(DrawPlanar_EdgeRec))) == NULL ||
+     if ((context->E = (DrawPlanar_EdgeRecP) platform_AllocMemory(&context->EMemory, Esize*sizeof(DrawPlanar_EdgeRec))) == NULL ||
          (context->VI = (DrawPlanar_VertexInfoP) malloc(VIsize*sizeof(DrawPlanar_VertexInfo))) == NULL
         )
      {
@@ -341,7 +366,7 @@ void _DrawPlanar_FreeContext(void *pContext)
 int  _DrawPlanar_InitGraph(graphP theGraph, int N)
 {
     DrawPlanarContext *context = NULL;
-    gp_FindExtension(theGraph, DRAWPLANAR_ID, (void *)&context);
+    context = (DrawPlanarContext *) gp_GetExtensionContext(theGraph, DRAWPLANAR_ID);
 
     if (context == NULL)
         return NOTOK;
@@ -366,7 +391,7 @@ int  _DrawPlanar_InitGraph(graphP theGraph, int N)
 void _DrawPlanar_ReinitializeGraph(graphP theGraph)
 {
     DrawPlanarContext *context = NULL;
-    gp_FindExtension(theGraph, DRAWPLANAR_ID, (void *)&context);
+    context = (DrawPlanarContext *) gp_GetExtensionContext(theGraph, DRAWPLANAR_ID);
 
     if (context != NULL)
     {
@@ -379,17 +404,36 @@ void _DrawPlanar_ReinitializeGraph(graphP theGraph)
 }
 
 /********************************************************************
- The current implementation does not support an increase of arc
- (edge record) capacity once the extension is attached to the graph
- data structure.  This is only due to not being necessary to support.
- For now, it is easy to ensure the correct capacity before attaching
- the extension, but support could be added later if there is some
- reason to do so.
+ _DrawPlanar_EnsureArcCapacity()
+ Grows the extension's edge records along with those of the graph.
+ The existing edge records keep their content, and the new ones are
+ initialized.
  ********************************************************************/
 
 int  _DrawPlanar_EnsureArcCapacity(graphP theGraph, int requiredArcCapacity)
 {
-	return NOTOK;
+    DrawPlanarContext *context = NULL;
+    int e, Esize, newEsize;
+
+    context = (DrawPlanarContext *) gp_GetExtensionContext(theGraph, DRAWPLANAR_ID);
+
+    if (context == NULL)
+        return NOTOK;
+
+    Esize = gp_EdgeIndexBound(theGraph);
+    newEsize = gp_GetFirstEdge(theGraph) + requiredArcCapacity;
+
+    if (platform_ResizeMemory(&context->EMemory, newEsize*sizeof(DrawPlanar_EdgeRec)) == NULL)
+        return NOTOK;
+    context->E = (DrawPlanar_EdgeRecP) context->EMemory.ptr;
+
+    if (context->functions.fpEnsureArcCapacity(theGraph, requiredArcCapacity) != OK)
+        return NOTOK;
+
+    for (e = Esize; e < newEsize; e++)
+        _DrawPlanar_InitEdgeRec(context, e);
+
+    return OK;
 }
 
 /********************************************************************
@@ -398,7 +442,7 @@ int  _DrawPlanar_EnsureArcCapacity(graphP theGraph, int requiredArcCapacity)
 int  _DrawPlanar_SortVertices(graphP theGraph)
 {
     DrawPlanarContext *context = NULL;
-    gp_FindExtension(theGraph, DRAWPLANAR_ID, (void *)&context);
+    context = (DrawPlanarContext *) gp_GetExtensionContext(theGraph, DRAWPLANAR_ID);
 
     if (context != NULL)
     {
@@ -471,7 +515,7 @@ int  _DrawPlanar_SortVertices(graphP theGraph)
 int  _DrawPlanar_MergeBicomps(graphP theGraph, int v, int RootVertex, int W, int WPrevLink)
 {
     DrawPlanarContext *context = NULL;
-    gp_FindExtension(theGraph, DRAWPLANAR_ID, (void *)&context);
+    context = (DrawPlanarContext *) gp_GetExtensionContext(theGraph, DRAWPLANAR_ID);
 
     if (context != NULL)
     {
@@ -492,7 +536,7 @@ int  _DrawPlanar_MergeBicomps(graphP theGraph, int v, int RootVertex, int W, int
 int _DrawPlanar_HandleInactiveVertex(graphP theGraph, int BicompRoot, int *pW, int *pWPrevLink)
 {
     DrawPlanarContext *context = NULL;
-    gp_FindExtension(theGraph, DRAWPLANAR_ID, (void *)&context);
+    context = (DrawPlanarContext *) gp_GetExtensionContext(theGraph, DRAWPLANAR_ID);
 
     if (context != NULL)
     {
@@ -542,7 +586,7 @@ void _DrawPlanar_InitVertexInfo(DrawPlanarContext *context, int v)
 int _DrawPlanar_EmbedPostprocess(graphP theGraph, int v, int edgeEmbeddingResult)
 {
     DrawPlanarContext *context = NULL;
-    gp_FindExtension(theGraph, DRAWPLANAR_ID, (void *)&context);
+    context = (DrawPlanarContext *) gp_GetExtensionContext(theGraph, DRAWPLANAR_ID);
 
     if (context != NULL)
     {
@@ -568,7 +612,7 @@ int _DrawPlanar_EmbedPostprocess(graphP theGraph, int v, int edgeEmbeddingResult
 int  _DrawPlanar_CheckEmbeddingIntegrity(graphP theGraph, graphP origGraph)
 {
     DrawPlanarContext *context = NULL;
-    gp_FindExtension(theGraph, DRAWPLANAR_ID, (void *)&context);
+    context = (DrawPlanarContext *) gp_GetExtensionContext(theGraph, DRAWPLANAR_ID);
 
     if (context != NULL)
     {
@@ -595,7 +639,7 @@ int  _DrawPlanar_CheckObstructionIntegrity(graphP theGraph, graphP origGraph)
 int  _DrawPlanar_ReadPostprocess(graphP theGraph, void *extraData, long extraDataSize)
 {
     DrawPlanarContext *context = NULL;
-    gp_FindExtension(theGraph, DRAWPLANAR_ID, (void *)&context);
+    context = (DrawPlanarContext *) gp_GetExtensionContext(theGraph, DRAWPLANAR_ID);
 
     if (context != NULL)
     {
@@ -653,7 +697,7 @@ int  _DrawPlanar_ReadPostprocess(graphP theGraph, void *extraData, long extraDat
 int  _DrawPlanar_WritePostprocess(graphP theGraph, void **pExtraData, long *pExtraDataSize)
 {
     DrawPlanarContext *context = NULL;
-    gp_FindExtension(theGraph, DRAWPLANAR_ID, (void *)&context);
+    context = (DrawPlanarContext *) gp_GetExtensionContext(theGraph, DRAWPLANAR_ID);
 
     if (context != NULL)
     {
@@ -0,0 +1,1020 @@
+/*
+Planarity-Related Graph Algorithms Project
+Copyright (c) 1997-2012, John M. Boyer
+All rights reserved. Includes a reference implementation of the following:
+
+* John M. Boyer. "Subgraph Homeomorphism via the Edge Addition Planarity Algorithm".
+  Journal of Graph Algorithms and Applications, Vol. 16, no. 2, pp. 381-410, 2012.
+  http://www.jgaa.info/16/268.html
+
+* John M. Boyer. "A New Method for Efficiently Generating Planar Graph
+  Visibility Representations". In P. Eades and P. Healy, editors,
+  Proceedings of the 13th International Conference on Graph Drawing 2005,
+  Lecture Notes Comput. Sci., Volume 3843, pp. 508-511, Springer-Verlag, 2006.
+
+* John M. Boyer and Wendy J. Myrvold. "On the Cutting Edge: Simplified O(n)
+  Planarity by Edge Addition". Journal of Graph Algorithms and Applications,
+  Vol. 8, No. 3, pp. 241-273, 2004.
+  http://www.jgaa.info/08/91.html
+
+* John M. Boyer. "Simplified O(n) Algorithms for Planar Graph Embedding,
+  Kuratowski Subgraph Isolation, and Related Problems". Ph.D. Dissertation,
+  University of Victoria, 2001.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+* Redistributions of source code must retain the above copyright notice, this
+  list of conditions and the following disclaimer.
+
+* Redistributions in binary form must reproduce the above copyright notice, this
+  list of conditions and the following disclaimer in the documentation and/or
+  other materials provided with the distribution.
+
+* Neither the name of the Planarity-Related Graph Algorithms Project nor the names
+  of its contributors may be used to endorse or promote products derived from this
+  software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include "graphDrawStraightLine.h"
+#include "graphDrawStraightLine.private.h"
+
+extern int DRAWSTRAIGHTLINE_ID;
+
+#include "graph.h"
+
+#include <stdlib.h>
+#include <string.h>
+#include <stdio.h>
+
+/* Imported functions */
+
+extern FILE *_OpenDrawingFile(char *theFileName, char *mode);
+extern int  _CloseDrawingFile(FILE *outfile, char *theFileName);
+
+/* Private definitions */
+
+/* The states of a vertex during the computation of the canonical ordering */
+
+#define CANONICAL_INTERIOR  0
+#define CANONICAL_CONTOUR   1
+#define CANONICAL_REMOVED   2
+
+typedef struct
+{
+    DrawStraightLineContext *context;
+
+    // The work graph is a copy of the embedding with the same vertex and
+    // arc indices, to which edges and vertices are added to make it
+    // a triangulation.  It has numVertices vertices in use, the first N
+    // of which are the vertices of the embedding, and the rest of which
+    // are the dummy vertices added to triangulate some faces.
+    graphP work;
+    int N, numVertices;
+
+    // The label of the block (biconnected component) of each edge of the
+    // work graph, indexed by the arc index divided by two, and the
+    // union-find forest that merges block labels as new edges join blocks
+    int *edgeBlock, *blockParent;
+
+    // The degree of each vertex in the work graph, a vertex marking array,
+    // and the arcs of the face being triangulated
+    int *degree, *mark, *faceArcs;
+
+    // The canonical ordering: the vertices in order, the state of each
+    // vertex and its neighbors on the contour, the number of chords of the
+    // contour incident to each contour vertex, and a stack of contour
+    // vertices that may be removable.  Once a vertex is removed, its
+    // contour neighbors remain those at the time of its removal, which are
+    // the leftmost and rightmost neighbors to which it is attached.
+    int *order, *state, *contourPrev, *contourNext, *chords;
+    int *candidates, numCandidates;
+
+    // The shift method: the x offset of each vertex relative to its parent
+    // in the tree formed by the left and right links, and the y coordinate
+    int *dx, *y, *left, *right;
+} straightLineRec;
+
+typedef straightLineRec * straightLineRecP;
+
+/* Private functions exported to system */
+
+int  _ComputeStraightLineDrawing(DrawStraightLineContext *context);
+int  _CheckStraightLineDrawingIntegrity(DrawStraightLineContext *context);
+
+/* Private functions */
+
+int  _StraightLine_Init(straightLineRecP s, DrawStraightLineContext *context);
+void _StraightLine_Free(straightLineRecP s);
+int  _StraightLine_InsertEdge(straightLineRecP s, int u, int e_u, int e_ulink, int v, int e_v, int e_vlink, int block);
+int  _StraightLine_FindBlock(straightLineRecP s, int block);
+int  _StraightLine_Connect(straightLineRecP s);
+int  _StraightLine_Biconnect(straightLineRecP s);
+int  _StraightLine_Triangulate(straightLineRecP s);
+int  _StraightLine_TriangulateFace(straightLineRecP s, int k);
+int  _StraightLine_CanonicalOrder(straightLineRecP s);
+int  _StraightLine_RemoveContourVertex(straightLineRecP s, int v, int k);
+int  _StraightLine_Shift(straightLineRecP s);
+
+int  _PrecedesAngularly(int dx1, int dy1, int dx2, int dy2);
+int  _ComparePoints(const void *p1, const void *p2);
+
+/********************************************************************
+ _ComputeStraightLineDrawing()
+
+ Computes a straight-line drawing of the planar embedding on an
+ integer grid of size (2n-4) x (n-2), where n is at most 3N.
+
+ The embedding is copied into a work graph, which is made connected,
+ then biconnected, then triangulated by adding edges (and a dummy
+ vertex for a face that cannot be fanned from one of its vertices)
+ without disturbing the embedding of the original edges.  Then the
+ de Fraysseix-Pach-Pollack shift method, in the linear time form
+ of Chrobak and Payne, places the vertices of the triangulation in
+ a canonical ordering.  Removing the added edges leaves a straight-
+ line drawing of the embedding.  All steps take linear time.
+
+ The embedding must be sorted by DFI, with the DFS parents and lowpoints
+ of the vertices, which is the case during the embedding postprocessing.
+ ********************************************************************/
+
+int _ComputeStraightLineDrawing(DrawStraightLineContext *context)
+{
+graphP theEmbedding = context->theGraph;
+straightLineRec s;
+int v, RetVal = OK;
+
+    if (!(theEmbedding->internalFlags & FLAGS_SORTEDBYDFI))
+        return NOTOK;
+
+    context->width = context->height = 0;
+
+    // With fewer than three vertices, the vertices are simply placed in a row
+    if (theEmbedding->N < 3)
+    {
+        for (v = gp_GetFirstVertex(theEmbedding); gp_VertexInRange(theEmbedding, v); v++)
+        {
+            context->VI[v].x = v - gp_GetFirstVertex(theEmbedding);
+            context->VI[v].y = 0;
+        }
+        context->width = theEmbedding->N - 1;
+        return OK;
+    }
+
+    if (_StraightLine_Init(&s, context) != OK ||
+        _StraightLine_Connect(&s) != OK ||
+        _StraightLine_Biconnect(&s) != OK ||
+        _StraightLine_Triangulate(&s) != OK ||
+        _StraightLine_CanonicalOrder(&s) != OK ||
+        _StraightLine_Shift(&s) != OK)
+        RetVal = NOTOK;
+
+    _StraightLine_Free(&s);
+    return RetVal;
+}
+
+/********************************************************************
+ _StraightLine_Init()
+
+ Creates the work graph as a copy of the embedding, with room for a
+ triangulation of up to 3N vertices, since a biconnected planar graph
+ has fewer than 2N faces and at most one dummy vertex is added per face.
+
+ Each edge is also labeled with its block.  Since the embedding is
+ sorted by DFI, each vertex w has a greater index than its DFS parent,
+ and the tree edge from the parent starts a new block if the lowpoint
+ of w is not less than the parent.  Otherwise the tree edge is in the
+ block of the tree edge into the parent.  Every other edge is in the
+ block of the tree edge into its greater endpoint, so an edge is
+ labeled with the block of the tree edge into its greater endpoint.
+ ********************************************************************/
+
+int  _StraightLine_Init(straightLineRecP s, DrawStraightLineContext *context)
+{
+graphP theEmbedding = context->theGraph;
+int N = theEmbedding->N, maxVertices = 3*N, maxEdges = 3*maxVertices - 6;
+int v, e, f, u, w, parent, EsizeOccupied, VIsize, numBlocks, *arcMap;
+
+    memset(s, 0, sizeof(straightLineRec));
+
+    s->context = context;
+    s->N = s->numVertices = N;
+
+    if ((s->work = gp_New()) == NULL ||
+        gp_EnsureArcCapacity(s->work, 2*maxEdges) != OK ||
+        gp_InitGraph(s->work, maxVertices) != OK)
+        return NOTOK;
+
+    // The blocks are labeled by vertex, and each edge added to join
+    // connected components is a block with a label greater than N
+    VIsize = gp_PrimaryVertexIndexBound(s->work);
+    numBlocks = gp_PrimaryVertexIndexBound(theEmbedding) + N;
+
+    if ((s->edgeBlock = (int *) calloc(gp_EdgeIndexBound(s->work)/2, sizeof(int))) == NULL ||
+        (s->blockParent = (int *) malloc(numBlocks * sizeof(int))) == NULL ||
+        (s->degree = (int *) calloc(VIsize, sizeof(int))) == NULL ||
+        (s->mark = (int *) calloc(VIsize, sizeof(int))) == NULL ||
+        (s->faceArcs = (int *) malloc(gp_EdgeIndexBound(s->work) * sizeof(int))) == NULL ||
+        (s->order = (int *) calloc(VIsize, sizeof(int))) == NULL ||
+        (s->state = (int *) calloc(VIsize, sizeof(int))) == NULL ||
+        (s->contourPrev = (int *) calloc(VIsize, sizeof(int))) == NULL ||
+        (s->contourNext = (int *) calloc(VIsize, sizeof(int))) == NULL ||
+        (s->chords = (int *) calloc(VIsize, sizeof(int))) == NULL ||
+        (s->candidates = (int *) malloc(3 * VIsize * sizeof(int))) == NULL ||
+        (s->dx = (int *) calloc(VIsize, sizeof(int))) == NULL ||
+        (s->y = (int *) calloc(VIsize, sizeof(int))) == NULL ||
+        (s->left = (int *) calloc(VIsize, sizeof(int))) == NULL ||
+        (s->right = (int *) calloc(VIsize, sizeof(int))) == NULL)
+        return NOTOK;
+
+    for (v = 0; v < numBlocks; v++)
+        s->blockParent[v] = v;
+
+    // Copy the embedding into the work graph, numbering the edges in use
+    // consecutively so that the work graph has no edge holes
+    EsizeOccupied = gp_EdgeInUseIndexBound(theEmbedding);
+    if ((arcMap = (int *) calloc(EsizeOccupied, sizeof(int))) == NULL)
+        return NOTOK;
+
+    f = gp_GetFirstEdge(s->work);
+    for (e = gp_GetFirstEdge(theEmbedding); e < EsizeOccupied; e+=2)
+    {
+        if (gp_EdgeInUse(theEmbedding, e))
+        {
+            arcMap[e] = f;
+            arcMap[e+1] = f+1;
+            f += 2;
+        }
+    }
+
+    for (v = gp_GetFirstVertex(theEmbedding); gp_VertexInRange(theEmbedding, v); v++)
+    {
+        gp_SetFirstArc(s->work, v, arcMap[gp_GetFirstArc(theEmbedding, v)]);
+        gp_SetLastArc(s->work, v, arcMap[gp_GetLastArc(theEmbedding, v)]);
+    }
+
+    for (e = gp_GetFirstEdge(theEmbedding); e < EsizeOccupied; e++)
+    {
+        if (gp_EdgeInUse(theEmbedding, e))
+        {
+            f = arcMap[e];
+            gp_SetNeighbor(s->work, f, gp_GetNeighbor(theEmbedding, e));
+            gp_SetNextArc(s->work, f, arcMap[gp_GetNextArc(theEmbedding, e)]);
+            gp_SetPrevArc(s->work, f, arcMap[gp_GetPrevArc(theEmbedding, e)]);
+            s->degree[gp_GetNeighbor(theEmbedding, e)]++;
+        }
+    }
+    s->work->M = theEmbedding->M;
+
+    free(arcMap);
+
+    // Label the blocks of the tree edges in the mark array, then the edges
+    for (v = gp_GetFirstVertex(theEmbedding); gp_VertexInRange(theEmbedding, v); v++)
+    {
+        parent = gp_GetVertexParent(theEmbedding, v);
+        if (gp_IsNotVertex(parent) || gp_GetVertexLowpoint(theEmbedding, v) >= parent)
+            s->mark[v] = v;
+        else
+            s->mark[v] = s->mark[parent];
+    }
+
+    for (e = gp_GetFirstEdge(s->work); e < gp_EdgeInUseIndexBound(s->work); e+=2)
+    {
+        u = gp_GetNeighbor(s->work, e);
+        w = gp_GetNeighbor(s->work, gp_GetTwinArc(s->work, e));
+        s->edgeBlock[e >> 1] = s->mark[u > w ? u : w];
+    }
+
+    memset(s->mark, 0, VIsize * sizeof(int));
+
+    return OK;
+}
+
+/********************************************************************
+ _StraightLine_Free()
+ ********************************************************************/
+
+void _StraightLine_Free(straightLineRecP s)
+{
+    gp_Free(&s->work);
+
+    if (s->edgeBlock != NULL) free(s->edgeBlock);
+    if (s->blockParent != NULL) free(s->blockParent);
+    if (s->degree != NULL) free(s->degree);
+    if (s->mark != NULL) free(s->mark);
+    if (s->faceArcs != NULL) free(s->faceArcs);
+    if (s->order != NULL) free(s->order);
+    if (s->state != NULL) free(s->state);
+    if (s->contourPrev != NULL) free(s->contourPrev);
+    if (s->contourNext != NULL) free(s->contourNext);
+    if (s->chords != NULL) free(s->chords);
+    if (s->candidates != NULL) free(s->candidates);
+    if (s->dx != NULL) free(s->dx);
+    if (s->y != NULL) free(s->y);
+    if (s->left != NULL) free(s->left);
+    if (s->right != NULL) free(s->right);
+
+    memset(s, 0, sizeof(straightLineRec));
+}
+
+/********************************************************************
+ _StraightLine_InsertEdge()
+
+ Inserts the edge (u, v) into the work graph as gp_InsertEdge() does,
+ labels it with the given block, and updates the vertex degrees.
+
+ Returns the new arc in the adjacency list of u, or NIL on failure.
+ ********************************************************************/
+
+int  _StraightLine_InsertEdge(straightLineRecP s, int u, int e_u, int e_ulink, int v, int e_v, int e_vlink, int block)
+{
+int e = gp_EdgeInUseIndexBound(s->work);
+
+    if (gp_InsertEdge(s->work, u, e_u, e_ulink, v, e_v, e_vlink) != OK)
+        return NIL;
+
+    s->edgeBlock[e >> 1] = block;
+    s->degree[u]++;
+    s->degree[v]++;
+
+    return gp_GetTwinArc(s->work, e);
+}
+
+/********************************************************************
+ _StraightLine_FindBlock()
+ Returns the representative of the merged blocks containing the block.
+ ********************************************************************/
+
+int  _StraightLine_FindBlock(straightLineRecP s, int block)
+{
+    while (s->blockParent[block] != block)
+    {
+        s->blockParent[block] = s->blockParent[s->blockParent[block]];
+        block = s->blockParent[block];
+    }
+
+    return block;
+}
+
+/********************************************************************
+ _StraightLine_Connect()
+
+ Joins the DFS tree root of each connected component to the root of
+ the preceding component.  Each such edge is a block by itself, and
+ it can be embedded anywhere in the two adjacency lists because the
+ components are embedded separately.
+ ********************************************************************/
+
+int  _StraightLine_Connect(straightLineRecP s)
+{
+graphP work = s->work;
+int v, root = NIL, block = gp_PrimaryVertexIndexBound(s->context->theGraph);
+
+    for (v = gp_GetFirstVertex(work); v < gp_GetFirstVertex(work) + s->N; v++)
+    {
+        if (gp_IsDFSTreeRoot(s->context->theGraph, v))
+        {
+            if (gp_IsVertex(root) &&
+                _StraightLine_InsertEdge(s, root, gp_GetFirstArc(work, root), 1,
+                                            v, gp_GetFirstArc(work, v), 1, block++) == NIL)
+                return NOTOK;
+
+            root = v;
+        }
+    }
+
+    return OK;
+}
+
+/********************************************************************
+ _StraightLine_Biconnect()
+
+ Makes the connected work graph biconnected.  For each pair of
+ consecutive arcs (v, x) and (v, y) in the adjacency list of a vertex v,
+ the path x, v, y is on a face.  If the two arcs are in different
+ blocks, then x and y cannot be adjacent, so the edge (x, y) is added
+ in the face to merge the two blocks.  Once every pair of consecutive
+ arcs of v is in the same block, v is not a cut vertex, and adding
+ edges does not make it one again.
+ ********************************************************************/
+
+int  _StraightLine_Biconnect(straightLineRecP s)
+{
+graphP work = s->work;
+int v, e, eNext, block, nextBlock;
+
+    for (v = gp_GetFirstVertex(work); v < gp_GetFirstVertex(work) + s->N; v++)
+    {
+        e = gp_GetFirstArc(work, v);
+        do {
+            eNext = gp_GetNextArcCircular(work, e);
+
+            block = _StraightLine_FindBlock(s, s->edgeBlock[e >> 1]);
+            nextBlock = _StraightLine_FindBlock(s, s->edgeBlock[eNext >> 1]);
+
+            // The arc (x, y) goes before (x, v) in the adjacency list of x,
+            // and the arc (y, x) goes after (y, v) in the adjacency list of y,
+            // so that x, v, y becomes a triangular face
+            if (block != nextBlock)
+            {
+                if (_StraightLine_InsertEdge(s, gp_GetNeighbor(work, e), gp_GetTwinArc(work, e), 1,
+                                                gp_GetNeighbor(work, eNext), gp_GetTwinArc(work, eNext), 0,
+                                                block) == NIL)
+                    return NOTOK;
+
+                s->blockParent[nextBlock] = block;
+            }
+
+            e = eNext;
+        } while (e != gp_GetFirstArc(work, v));
+    }
+
+    return OK;
+}
+
+/********************************************************************
+ _StraightLine_Triangulate()
+
+ Triangulates each face of the biconnected work graph.  Since the
+ graph is biconnected, each face is a simple cycle.  The arcs added
+ are inside the faces already triangulated, so they are not visited.
+ ********************************************************************/
+
+int  _StraightLine_Triangulate(straightLineRecP s)
+{
+graphP work = s->work;
+int e, eStart, k, EsizeOccupied = gp_EdgeInUseIndexBound(work);
+
+    for (e = gp_GetFirstEdge(work); e < EsizeOccupied; e++)
+        gp_ClearEdgeVisited(work, e);
+
+    for (eStart = gp_GetFirstEdge(work); eStart < EsizeOccupied; eStart++)
+    {
+        if (gp_GetEdgeVisited(work, eStart))
+            continue;
+
+        k = 0;
+        e = eStart;
+        do {
+            s->faceArcs[k++] = e;
+            gp_SetEdgeVisited(work, e);
+            e = gp_GetNextArcCircular(work, gp_GetTwinArc(work, e));
+        } while (e != eStart);
+
+        if (k > 3 && _StraightLine_TriangulateFace(s, k) != OK)
+            return NOTOK;
+    }
+
+    return OK;
+}
+
+/********************************************************************
+ _StraightLine_TriangulateFace()
+
+ The face has k > 3 arcs, where arc i goes from vertex f(i) to vertex
+ f(i+1).  The new arcs of a vertex f(i) go after the arc (f(i), f(i-1))
+ in its adjacency list, which is where the face is.
+
+ The face is fanned from a vertex f of least degree on the face if f is
+ not already adjacent to a face vertex other than its face neighbors.
+ Otherwise, a dummy vertex is added inside the face and joined to every
+ vertex of the face.  Choosing a vertex of least degree bounds the total
+ cost of marking the neighbors by a constant times the number of edges.
+ ********************************************************************/
+
+int  _StraightLine_TriangulateFace(straightLineRecP s, int k)
+{
+graphP work = s->work;
+int *faceArcs = s->faceArcs;
+int i, j, f, w, e, eAnchor, stamp = faceArcs[0], canFan = TRUE;
+
+#define _FaceVertex(i) gp_GetNeighbor(work, gp_GetTwinArc(work, faceArcs[(i) % k]))
+#define _FaceAnchor(i) gp_GetTwinArc(work, faceArcs[((i) + k - 1) % k])
+
+    i = 0;
+    for (j = 1; j < k; j++)
+        if (s->degree[_FaceVertex(j)] < s->degree[_FaceVertex(i)])
+            i = j;
+
+    f = _FaceVertex(i);
+
+    e = gp_GetFirstArc(work, f);
+    while (gp_IsArc(e))
+    {
+        s->mark[gp_GetNeighbor(work, e)] = stamp;
+        e = gp_GetNextArc(work, e);
+    }
+
+    for (j = 2; j <= k-2; j++)
+        if (s->mark[_FaceVertex(i+j)] == stamp)
+            canFan = FALSE;
+
+    if (canFan)
+    {
+        eAnchor = _FaceAnchor(i);
+        for (j = 2; j <= k-2; j++)
+        {
+            if (_StraightLine_InsertEdge(s, f, eAnchor, 0, _FaceVertex(i+j), _FaceAnchor(i+j), 0, 0) == NIL)
+                return NOTOK;
+        }
+    }
+    else
+    {
+        if (s->numVertices >= work->N)
+            return NOTOK;
+
+        // The arcs of the dummy vertex go in reverse order of the face
+        // vertices, each before the preceding one, so that each edge of
+        // the face forms a triangle with the dummy vertex
+        w = gp_GetFirstVertex(work) + s->numVertices++;
+        e = NIL;
+        for (j = 0; j < k; j++)
+        {
+            if ((e = _StraightLine_InsertEdge(s, _FaceVertex(j), _FaceAnchor(j), 0, w, e, 1, 0)) == NIL)
+                return NOTOK;
+            e = gp_GetTwinArc(work, e);
+        }
+    }
+
+#undef _FaceVertex
+#undef _FaceAnchor
+
+    return OK;
+}
+
+/********************************************************************
+ _StraightLine_CanonicalOrder()
+
+ Computes a canonical ordering v1, v2, ..., vn of the triangulated work
+ graph, in which (v1, v2, vn) is the external face, and for each k >= 3,
+ the graph Gk induced by v1 to vk is biconnected with an external face
+ containing the edge (v1, v2) and the contour from v1 to v2, and vk
+ is attached to a contiguous interval of the contour of G(k-1).
+
+ The ordering is computed in reverse.  A vertex can be removed from the
+ contour if it is not v1 or v2 and it is not incident to a chord of the
+ contour, i.e. an edge joining two contour vertices that are not
+ consecutive on the contour.  The neighbors of the removed vertex that
+ are inside the contour then join the contour between its contour
+ neighbors.  Each vertex joins the contour once, when its edges are
+ scanned for new chords, so the total time is linear.
+ ********************************************************************/
+
+int  _StraightLine_CanonicalOrder(straightLineRecP s)
+{
+graphP work = s->work;
+int v, v1, v2, vn, k, e;
+
+    memset(s->mark, 0, gp_PrimaryVertexIndexBound(work) * sizeof(int));
+
+    v1 = gp_GetFirstVertex(work);
+    e = gp_GetFirstArc(work, v1);
+    v2 = gp_GetNeighbor(work, e);
+    vn = gp_GetNeighbor(work, gp_GetNextArcCircular(work, gp_GetTwinArc(work, e)));
+
+    s->order[1] = v1;
+    s->order[2] = v2;
+
+    s->state[v1] = s->state[v2] = s->state[vn] = CANONICAL_CONTOUR;
+    s->contourNext[v1] = vn;
+    s->contourPrev[vn] = v1;
+    s->contourNext[vn] = v2;
+    s->contourPrev[v2] = vn;
+
+    s->numCandidates = 0;
+    s->candidates[s->numCandidates++] = vn;
+
+    for (k = s->numVertices; k >= 3; k--)
+    {
+        // Find a removable vertex, discarding the candidates that are
+        // no longer removable
+        v = NIL;
+        while (s->numCandidates > 0 && gp_IsNotVertex(v))
+        {
+            v = s->candidates[--s->numCandidates];
+            if (s->state[v] != CANONICAL_CONTOUR || s->chords[v] > 0 || v == v1 || v == v2)
+                v = NIL;
+        }
+
+        if (gp_IsNotVertex(v))
+            return NOTOK;
+
+        s->order[k] = v;
+        if (_StraightLine_RemoveContourVertex(s, v, k) != OK)
+            return NOTOK;
+    }
+
+    return OK;
+}
+
+/********************************************************************
+ _StraightLine_RemoveContourVertex()
+
+ Removes v from the contour and replaces it by its interior neighbors.
+ In the adjacency list of v, the interior neighbors are on one side of
+ the arc to its contour predecessor p and the removed neighbors are on
+ the other side, so the interior neighbors are found by going from p
+ toward the contour successor q in the direction that does not first
+ meet a removed vertex.
+ ********************************************************************/
+
+int  _StraightLine_RemoveContourVertex(straightLineRecP s, int v, int k)
+{
+graphP work = s->work;
+int p = s->contourPrev[v], q = s->contourNext[v];
+int e, ep, w, x, link, prev;
+
+    s->state[v] = CANONICAL_REMOVED;
+
+    ep = gp_GetFirstArc(work, v);
+    while (gp_IsArc(ep) && gp_GetNeighbor(work, ep) != p)
+        ep = gp_GetNextArc(work, ep);
+
+    if (gp_IsNotArc(ep))
+        return NOTOK;
+
+    // Find the arc to the first interior neighbor, or NIL if there are none,
+    // and the link that goes from it toward q
+    link = 0;
+    e = gp_GetNextArcCircular(work, ep);
+    if (s->state[gp_GetNeighbor(work, e)] == CANONICAL_REMOVED)
+    {
+        link = 1;
+        e = gp_GetPrevArcCircular(work, ep);
+    }
+    else if (gp_GetNeighbor(work, e) == q)
+    {
+        link = 1;
+        e = gp_GetPrevArcCircular(work, ep);
+        if (s->state[gp_GetNeighbor(work, e)] == CANONICAL_REMOVED)
+            e = NIL;
+    }
+
+    // Replace v by its interior neighbors on the contour
+    prev = p;
+    if (gp_IsArc(e))
+    {
+        while ((w = gp_GetNeighbor(work, e)) != q)
+        {
+            if (s->state[w] != CANONICAL_INTERIOR)
+                return NOTOK;
+
+            s->state[w] = CANONICAL_CONTOUR;
+            s->mark[w] = k;
+            s->contourNext[prev] = w;
+            s->contourPrev[w] = prev;
+            prev = w;
+
+            e = link == 0 ? gp_GetNextArcCircular(work, e) : gp_GetPrevArcCircular(work, e);
+        }
+    }
+    s->contourNext[prev] = q;
+    s->contourPrev[q] = prev;
+
+    // If there were no interior neighbors, then the edge (p, q) was a chord
+    // unless it is the edge (v1, v2), which is never counted as a chord
+    if (prev == p)
+    {
+        if (k > 3)
+        {
+            if (--s->chords[p] == 0)
+                s->candidates[s->numCandidates++] = p;
+            if (--s->chords[q] == 0)
+                s->candidates[s->numCandidates++] = q;
+        }
+        return OK;
+    }
+
+    // Count the chords incident to the new contour vertices.  A chord to an
+    // older contour vertex is counted for both endpoints, and a chord between
+    // two new contour vertices is counted once by each of them.
+    for (w = s->contourNext[p]; w != q; w = s->contourNext[w])
+    {
+        e = gp_GetFirstArc(work, w);
+        while (gp_IsArc(e))
+        {
+            x = gp_GetNeighbor(work, e);
+            if (s->state[x] == CANONICAL_CONTOUR &&
+                x != s->contourPrev[w] && x != s->contourNext[w])
+            {
+                s->chords[w]++;
+                if (s->mark[x] != k)
+                    s->chords[x]++;
+            }
+            e = gp_GetNextArc(work, e);
+        }
+
+        if (s->chords[w] == 0)
+            s->candidates[s->numCandidates++] = w;
+    }
+
+    return OK;
+}
+
+/********************************************************************
+ _StraightLine_Shift()
+
+ Places the vertices in canonical order with the shift method.  The
+ contour is kept as a list of right links from v1 to v2, in which each
+ vertex has an x offset from its predecessor.  When vk is attached to
+ the contour interval from wp to wq, the vertices after wp are shifted
+ right by one and the vertices from wq on are shifted right by two, so
+ that vk can be placed at the intersection of the line of slope +1
+ from wp and the line of slope -1 from wq.  The vertices strictly
+ between wp and wq leave the contour and become the left subtree of vk,
+ with offsets relative to vk, so that they move with vk when it is
+ shifted later.  Each vertex leaves the contour once, so the total time
+ is linear.  Finally, the offsets are accumulated down the tree of left
+ and right links from v1.
+ ********************************************************************/
+
+int  _StraightLine_Shift(straightLineRecP s)
+{
+DrawStraightLineContext *context = s->context;
+graphP work = s->work;
+int *dx = s->dx, *y = s->y, *left = s->left, *right = s->right;
+int *x = s->chords;
+int k, v, w, wp, wq, wqPrev, dpq;
+
+    v = s->order[1];
+    dx[v] = y[v] = 0;
+    right[v] = s->order[3];
+
+    v = s->order[3];
+    dx[v] = y[v] = 1;
+    right[v] = s->order[2];
+
+    v = s->order[2];
+    dx[v] = 1;
+    y[v] = 0;
+    right[v] = NIL;
+
+    for (k = 4; k <= s->numVertices; k++)
+    {
+        v = s->order[k];
+        wp = s->contourPrev[v];
+        wq = s->contourNext[v];
+
+        dx[right[wp]]++;
+        dx[wq]++;
+
+        dpq = 0;
+        wqPrev = wp;
+        for (w = right[wp]; w != right[wq]; w = right[w])
+        {
+            dpq += dx[w];
+            if (w != wq)
+                wqPrev = w;
+        }
+
+        dx[v] = (dpq + y[wq] - y[wp]) / 2;
+        y[v] = y[wp] + dx[v];
+        dx[wq] = dpq - dx[v];
+
+        if (right[wp] != wq)
+        {
+            dx[right[wp]] -= dx[v];
+            left[v] = right[wp];
+            right[wqPrev] = NIL;
+        }
+        else
+            left[v] = NIL;
+
+        right[wp] = v;
+        right[v] = wq;
+    }
+
+    // Accumulate the offsets, reusing the chord counts for the x coordinates
+    sp_ClearStack(work->theStack);
+    v = s->order[1];
+    x[v] = dx[v];
+    sp_Push(work->theStack, v);
+    while (sp_NonEmpty(work->theStack))
+    {
+        sp_Pop(work->theStack, v);
+
+        if (gp_IsVertex(left[v]))
+        {
+            x[left[v]] = x[v] + dx[left[v]];
+            sp_Push(work->theStack, left[v]);
+        }
+        if (gp_IsVertex(right[v]))
+        {
+            x[right[v]] = x[v] + dx[right[v]];
+            sp_Push(work->theStack, right[v]);
+        }
+    }
+
+    // Keep the coordinates of the vertices of the embedding
+    for (v = gp_GetFirstVertex(work); v < gp_GetFirstVertex(work) + s->N; v++)
+    {
+        context->VI[v].x = x[v];
+        context->VI[v].y = y[v];
+    }
+
+    context->width = 2*s->numVertices - 4;
+    context->height = s->numVertices - 2;
+
+    return OK;
+}
+
+/********************************************************************
+ _CheckStraightLineDrawingIntegrity()
+
+ Checks that the vertices are at distinct points of the grid, and that
+ the edges leave each vertex in the order of its adjacency list, with
+ the same rotational direction (clockwise or counterclockwise) at every
+ vertex.
+ ********************************************************************/
+
+int  _CheckStraightLineDrawingIntegrity(DrawStraightLineContext *context)
+{
+graphP theEmbedding = context->theGraph;
+DrawStraightLine_VertexInfoP VI = context->VI;
+DrawStraightLine_VertexInfoP points;
+int v, w1, w2, e, eNext, degree, forward, backward, direction = 0, RetVal = OK;
+
+    if ((points = (DrawStraightLine_VertexInfoP) malloc((theEmbedding->N + 1) * sizeof(DrawStraightLine_VertexInfo))) == NULL)
+        return NOTOK;
+
+    for (v = gp_GetFirstVertex(theEmbedding); gp_VertexInRange(theEmbedding, v); v++)
+    {
+        if (VI[v].x < 0 || VI[v].x > context->width || VI[v].y < 0 || VI[v].y > context->height)
+            RetVal = NOTOK;
+        points[v - gp_GetFirstVertex(theEmbedding)] = VI[v];
+    }
+
+    qsort(points, theEmbedding->N, sizeof(DrawStraightLine_VertexInfo), _ComparePoints);
+    for (v = 1; v < theEmbedding->N; v++)
+        if (_ComparePoints(points + v - 1, points + v) == 0)
+            RetVal = NOTOK;
+
+    free(points);
+
+    for (v = gp_GetFirstVertex(theEmbedding); gp_VertexInRange(theEmbedding, v) && RetVal == OK; v++)
+    {
+        degree = forward = backward = 0;
+        e = gp_GetFirstArc(theEmbedding, v);
+        while (gp_IsArc(e))
+        {
+            eNext = gp_GetNextArcCircular(theEmbedding, e);
+            w1 = gp_GetNeighbor(theEmbedding, e);
+            w2 = gp_GetNeighbor(theEmbedding, eNext);
+
+            degree++;
+            if (_PrecedesAngularly(VI[w1].x - VI[v].x, VI[w1].y - VI[v].y, VI[w2].x - VI[v].x, VI[w2].y - VI[v].y))
+                forward++;
+            else if (_PrecedesAngularly(VI[w2].x - VI[v].x, VI[w2].y - VI[v].y, VI[w1].x - VI[v].x, VI[w1].y - VI[v].y))
+                backward++;
+            else if (eNext != e)
+                RetVal = NOTOK;
+
+            e = gp_GetNextArc(theEmbedding, e);
+        }
+
+        // In a sorted cyclic sequence, there is exactly one step that wraps around
+        if (degree >= 3)
+        {
+            if (forward == degree-1 && backward == 1)
+            {
+                if (direction < 0)
+                    RetVal = NOTOK;
+                direction = 1;
+            }
+            else if (backward == degree-1 && forward == 1)
+            {
+                if (direction > 0)
+                    RetVal = NOTOK;
+                direction = -1;
+            }
+            else
+                RetVal = NOTOK;
+        }
+    }
+
+    return RetVal;
+}
+
+/********************************************************************
+ _PrecedesAngularly()
+ Returns TRUE if the direction (dx1, dy1) precedes (dx2, dy2) in
+ counterclockwise order starting from the positive x axis.
+ ********************************************************************/
+
+int  _PrecedesAngularly(int dx1, int dy1, int dx2, int dy2)
+{
+int half1 = dy1 < 0 || (dy1 == 0 && dx1 < 0),
+    half2 = dy2 < 0 || (dy2 == 0 && dx2 < 0);
+
+    if (half1 != half2)
+        return half1 < half2;
+
+    return (double) dx1 * dy2 - (double) dy1 * dx2 > 0;
+}
+
+/********************************************************************
+ _ComparePoints()
+ ********************************************************************/
+
+int  _ComparePoints(const void *p1, const void *p2)
+{
+DrawStraightLine_VertexInfoP a = (DrawStraightLine_VertexInfoP) p1,
+                             b = (DrawStraightLine_VertexInfoP) p2;
+
+    if (a->x != b->x)
+        return a->x < b->x ? -1 : 1;
+
+    return a->y < b->y ? -1 : (a->y > b->y ? 1 : 0);
+}
+
+/********************************************************************
+ gp_DrawStraightLine_GetCoordinates()
+ Gets the grid point of vertex v in the drawing.
+ Returns OK on success, NOTOK on failure
+ ********************************************************************/
+
+int gp_DrawStraightLine_GetCoordinates(graphP theEmbedding, int v, int *pX, int *pY)
+{
+    DrawStraightLineContext *context = NULL;
+    gp_FindExtension(theEmbedding, DRAWSTRAIGHTLINE_ID, (void *) &context);
+
+    if (context == NULL || context->VI == NULL || !gp_VertexInRange(theEmbedding, v) ||
+        v < gp_GetFirstVertex(theEmbedding))
+        return NOTOK;
+
+    *pX = context->VI[v].x;
+    *pY = context->VI[v].y;
+    return OK;
+}
+
+/********************************************************************
+ gp_DrawStraightLine_GetGridSize()
+ Gets the size of the grid [0, width] x [0, height] of the drawing.
+ Returns OK on success, NOTOK on failure
+ ********************************************************************/
+
+int gp_DrawStraightLine_GetGridSize(graphP theEmbedding, int *pWidth, int *pHeight)
+{
+    DrawStraightLineContext *context = NULL;
+    gp_FindExtension(theEmbedding, DRAWSTRAIGHTLINE_ID, (void *) &context);
+
+    if (context == NULL)
+        return NOTOK;
+
+    *pWidth = context->width;
+    *pHeight = context->height;
+    return OK;
+}
+
+/********************************************************************
+ gp_DrawStraightLine_WriteCoordinates()
+ Writes the previously calculated straight-line drawing.  The first
+ line has N, M, and the width and height of the grid, then there is
+ one line per vertex, in vertex order, with its "x y" grid point.
+ Each edge is the segment between the points of its endpoints.
+
+ Returns OK on success, NOTOK on failure
+ ********************************************************************/
+
+int gp_DrawStraightLine_WriteCoordinates(graphP theEmbedding, char *theFileName)
+{
+    DrawStraightLineContext *context = NULL;
+    gp_FindExtension(theEmbedding, DRAWSTRAIGHTLINE_ID, (void *) &context);
+
+    if (context != NULL)
+    {
+        int v, RetVal = OK;
+        FILE *outfile = _OpenDrawingFile(theFileName, WRITETEXT);
+
+        if (outfile == NULL)
+            return NOTOK;
+
+        if (fprintf(outfile, "%d %d %d %d\n", theEmbedding->N, theEmbedding->M,
+                                             context->width, context->height) < 0)
+            RetVal = NOTOK;
+
+        for (v = gp_GetFirstVertex(theEmbedding); gp_VertexInRange(theEmbedding, v) && RetVal == OK; v++)
+        {
+            if (fprintf(outfile, "%d %d\n", context->VI[v].x, context->VI[v].y) < 0)
+                RetVal = NOTOK;
+        }
+
+        if (_CloseDrawingFile(outfile, theFileName) != OK)
+            RetVal = NOTOK;
+
+        return RetVal;
+    }
+
+    return NOTOK;
+}
@@ -0,0 +1,456 @@
+/*
+Planarity-Related Graph Algorithms Project
+Copyright (c) 1997-2012, John M. Boyer
+All rights reserved. Includes a reference implementation of the following:
+
+* John M. Boyer. "Subgraph Homeomorphism via the Edge Addition Planarity Algorithm".
+  Journal of Graph Algorithms and Applications, Vol. 16, no. 2, pp. 381-410, 2012.
+  http://www.jgaa.info/16/268.html
+
+* John M. Boyer. "A New Method for Efficiently Generating Planar Graph
+  Visibility Representations". In P. Eades and P. Healy, editors,
+  Proceedings of the 13th International Conference on Graph Drawing 2005,
+  Lecture Notes Comput. Sci., Volume 3843, pp. 508-511, Springer-Verlag, 2006.
+
+* John M. Boyer and Wendy J. Myrvold. "On the Cutting Edge: Simplified O(n)
+  Planarity by Edge Addition". Journal of Graph Algorithms and Applications,
+  Vol. 8, No. 3, pp. 241-273, 2004.
+  http://www.jgaa.info/08/91.html
+
+* John M. Boyer. "Simplified O(n) Algorithms for Planar Graph Embedding,
+  Kuratowski Subgraph Isolation, and Related Problems". Ph.D. Dissertation,
+  University of Victoria, 2001.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+* Redistributions of source code must retain the above copyright notice, this
+  list of conditions and the following disclaimer.
+
+* Redistributions in binary form must reproduce the above copyright notice, this
+  list of conditions and the following disclaimer in the documentation and/or
+  other materials provided with the distribution.
+
+* Neither the name of the Planarity-Related Graph Algorithms Project nor the names
+  of its contributors may be used to endorse or promote products derived from this
+  software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include <stdlib.h>
+
+#include "graphDrawStraightLine.private.h"
+#include "graphDrawStraightLine.h"
+
+extern void _ClearVertexVisitedFlags(graphP theGraph, int);
+
+extern int  _ComputeStraightLineDrawing(DrawStraightLineContext *context);
+extern int  _CheckStraightLineDrawingIntegrity(DrawStraightLineContext *context);
+
+/* Forward declarations of local functions */
+
+void _DrawStraightLine_ClearStructures(DrawStraightLineContext *context);
+int  _DrawStraightLine_CreateStructures(DrawStraightLineContext *context);
+int  _DrawStraightLine_InitStructures(DrawStraightLineContext *context);
+
+void _DrawStraightLine_InitVertexInfo(DrawStraightLineContext *context, int v);
+
+/* Forward declarations of overloading functions */
+
+int  _DrawStraightLine_EmbedPostprocess(graphP theGraph, int v, int edgeEmbeddingResult);
+int  _DrawStraightLine_CheckEmbeddingIntegrity(graphP theGraph, graphP origGraph);
+int  _DrawStraightLine_CheckObstructionIntegrity(graphP theGraph, graphP origGraph);
+
+int  _DrawStraightLine_InitGraph(graphP theGraph, int N);
+void _DrawStraightLine_ReinitializeGraph(graphP theGraph);
+int  _DrawStraightLine_SortVertices(graphP theGraph);
+
+/* Forward declarations of functions used by the extension system */
+
+void *_DrawStraightLine_DupContext(void *pContext, void *theGraph);
+void _DrawStraightLine_FreeContext(void *);
+
+/****************************************************************************
+ * DRAWSTRAIGHTLINE_ID - the variable used to hold the integer identifier for
+ * this extension, enabling this feature's extension context to be distinguished
+ * from other features' extension contexts that may be attached to a graph.
+ ****************************************************************************/
+
+int DRAWSTRAIGHTLINE_ID = 0;
+
+/****************************************************************************
+ gp_AttachDrawStraightLine()
+
+ This function adjusts the graph data structure to attach the straight-line
+ grid drawing feature.
+
+ To activate this feature during gp_Embed(), use EMBEDFLAGS_DRAWSTRAIGHTLINE.
+
+ As with the other extensions, this method may be called before or after
+ gp_InitGraph(), and it initializes the additional data structures specific
+ to straight-line drawing if the graph has already been initialized.
+
+ Returns OK for success, NOTOK for failure.
+ ****************************************************************************/
+
+int  gp_AttachDrawStraightLine(graphP theGraph)
+{
+     DrawStraightLineContext *context = NULL;
+
+     // If the drawing feature has already been attached to the graph,
+     // then there is no need to attach it again
+     gp_FindExtension(theGraph, DRAWSTRAIGHTLINE_ID, (void *) &context);
+     if (context != NULL)
+     {
+         return OK;
+     }
+
+     // Allocate a new extension context
+     context = (DrawStraightLineContext *) malloc(sizeof(DrawStraightLineContext));
+     if (context == NULL)
+     {
+         return NOTOK;
+     }
+
+     // First, tell the context that it is not initialized
+     context->initialized = 0;
+
+     // Save a pointer to theGraph in the context
+     context->theGraph = theGraph;
+
+     // Put the overload functions into the context function table.
+     // gp_AddExtension will overload the graph's functions with these, and
+     // return the base function pointers in the context function table
+     memset(&context->functions, 0, sizeof(graphFunctionTable));
+
+     context->functions.fpEmbedPostprocess = _DrawStraightLine_EmbedPostprocess;
+     context->functions.fpCheckEmbeddingIntegrity = _DrawStraightLine_CheckEmbeddingIntegrity;
+     context->functions.fpCheckObstructionIntegrity = _DrawStraightLine_CheckObstructionIntegrity;
+
+     context->functions.fpInitGraph = _DrawStraightLine_InitGraph;
+     context->functions.fpReinitializeGraph = _DrawStraightLine_ReinitializeGraph;
+     context->functions.fpSortVertices = _DrawStraightLine_SortVertices;
+
+     _DrawStraightLine_ClearStructures(context);
+
+     // Store the context, including the data structure and the
+     // function pointers, as an extension of the graph
+     if (gp_AddExtension(theGraph, &DRAWSTRAIGHTLINE_ID, (void *) context,
+                         _DrawStraightLine_DupContext, _DrawStraightLine_FreeContext,
+                         &context->functions) != OK)
+     {
+         _DrawStraightLine_FreeContext(context);
+         return NOTOK;
+     }
+
+     // Create the structures if the size of the graph is known
+     if (theGraph->N > 0)
+     {
+         if (_DrawStraightLine_CreateStructures(context) != OK ||
+             _DrawStraightLine_InitStructures(context) != OK)
+         {
+             _DrawStraightLine_FreeContext(context);
+             return NOTOK;
+         }
+     }
+
+     return OK;
+}
+
+/********************************************************************
+ gp_DetachDrawStraightLine()
+ ********************************************************************/
+
+int gp_DetachDrawStraightLine(graphP theGraph)
+{
+    return gp_RemoveExtension(theGraph, DRAWSTRAIGHTLINE_ID);
+}
+
+/********************************************************************
+ _DrawStraightLine_ClearStructures()
+ ********************************************************************/
+
+void _DrawStraightLine_ClearStructures(DrawStraightLineContext *context)
+{
+    if (!context->initialized)
+    {
+        // Before initialization, the pointers are stray, not NULL
+        // Once NULL or allocated, free() can do the job
+        context->VI = NULL;
+
+        context->initialized = 1;
+    }
+    else
+    {
+        if (context->VI != NULL)
+        {
+            free(context->VI);
+            context->VI = NULL;
+        }
+    }
+
+    context->width = context->height = 0;
+}
+
+/********************************************************************
+ _DrawStraightLine_CreateStructures()
+ Create uninitialized structures for the vertex level
+ ********************************************************************/
+
+int  _DrawStraightLine_CreateStructures(DrawStraightLineContext *context)
+{
+     graphP theGraph = context->theGraph;
+     int VIsize = gp_PrimaryVertexIndexBound(theGraph);
+
+     if (theGraph->N <= 0)
+         return NOTOK;
+
+     if ((context->VI = (DrawStraightLine_VertexInfoP) malloc(VIsize*sizeof(DrawStraightLine_VertexInfo))) == NULL)
+     {
+         return NOTOK;
+     }
+
+     return OK;
+}
+
+/********************************************************************
+ _DrawStraightLine_InitStructures()
+ Intended to be called when N>0.
+ ********************************************************************/
+
+int  _DrawStraightLine_InitStructures(DrawStraightLineContext *context)
+{
+     int v;
+     graphP theGraph = context->theGraph;
+
+     if (theGraph->N <= 0)
+         return NOTOK;
+
+     for (v = gp_GetFirstVertex(theGraph); gp_VertexInRange(theGraph, v); v++)
+          _DrawStraightLine_InitVertexInfo(context, v);
+
+     context->width = context->height = 0;
+
+     return OK;
+}
+
+/********************************************************************
+ _DrawStraightLine_DupContext()
+ ********************************************************************/
+
+void *_DrawStraightLine_DupContext(void *pContext, void *theGraph)
+{
+     DrawStraightLineContext *context = (DrawStraightLineContext *) pContext;
+     DrawStraightLineContext *newContext = (DrawStraightLineContext *) malloc(sizeof(DrawStraightLineContext));
+
+     if (newContext != NULL)
+     {
+         int VIsize = gp_PrimaryVertexIndexBound((graphP) theGraph);
+
+         *newContext = *context;
+
+         newContext->theGraph = (graphP) theGraph;
+
+         newContext->initialized = 0;
+         _DrawStraightLine_ClearStructures(newContext);
+         if (((graphP) theGraph)->N > 0)
+         {
+             if (_DrawStraightLine_CreateStructures(newContext) != OK)
+             {
+                 _DrawStraightLine_FreeContext(newContext);
+                 return NULL;
+             }
+
+             // Initialize custom data structures by copying
+             memcpy(newContext->VI, context->VI, VIsize*sizeof(DrawStraightLine_VertexInfo));
+             newContext->width = context->width;
+             newContext->height = context->height;
+         }
+     }
+
+     return newContext;
+}
+
+/********************************************************************
+ _DrawStraightLine_FreeContext()
+ ********************************************************************/
+
+void _DrawStraightLine_FreeContext(void *pContext)
+{
+     DrawStraightLineContext *context = (DrawStraightLineContext *) pContext;
+
+     _DrawStraightLine_ClearStructures(context);
+     free(pContext);
+}
+
+/********************************************************************
+ ********************************************************************/
+
+int  _DrawStraightLine_InitGraph(graphP theGraph, int N)
+{
+    DrawStraightLineContext *context = NULL;
+    context = (DrawStraightLineContext *) gp_GetExtensionContext(theGraph, DRAWSTRAIGHTLINE_ID);
+
+    if (context == NULL)
+        return NOTOK;
+
+    theGraph->N = N;
+    theGraph->NV = N;
+    if (theGraph->arcCapacity == 0)
+        theGraph->arcCapacity = 2*DEFAULT_EDGE_LIMIT*N;
+
+    if (_DrawStraightLine_CreateStructures(context) != OK ||
+        _DrawStraightLine_InitStructures(context) != OK)
+        return NOTOK;
+
+    context->functions.fpInitGraph(theGraph, N);
+
+    return OK;
+}
+
+/********************************************************************
+ ********************************************************************/
+
+void _DrawStraightLine_ReinitializeGraph(graphP theGraph)
+{
+    DrawStraightLineContext *context = NULL;
+    context = (DrawStraightLineContext *) gp_GetExtensionContext(theGraph, DRAWSTRAIGHTLINE_ID);
+
+    if (context != NULL)
+    {
+		// Reinitialize the graph
+		context->functions.fpReinitializeGraph(theGraph);
+
+		// Do the reinitialization that is specific to this module
+		_DrawStraightLine_InitStructures(context);
+    }
+}
+
+/********************************************************************
+ _DrawStraightLine_SortVertices()
+ The coordinates are kept with their vertices when the vertices are
+ put into or out of DFI order.
+ ********************************************************************/
+
+int  _DrawStraightLine_SortVertices(graphP theGraph)
+{
+    DrawStraightLineContext *context = NULL;
+    context = (DrawStraightLineContext *) gp_GetExtensionContext(theGraph, DRAWSTRAIGHTLINE_ID);
+
+    if (context != NULL)
+    {
+        // If the embedding process has already been completed, then
+        // rearrange the coordinates according to the index values
+        // of the vertices, in the same (almost) in-place manner as
+        // the DrawPlanar extension
+        if (theGraph->embedFlags == EMBEDFLAGS_DRAWSTRAIGHTLINE)
+        {
+        	int v, vIndex;
+        	DrawStraightLine_VertexInfo temp;
+
+            _ClearVertexVisitedFlags(theGraph, FALSE);
+            for (v = gp_GetFirstVertex(theGraph); gp_VertexInRange(theGraph, v); v++)
+            {
+            	if (gp_GetVertexVisited(theGraph, v))
+            		continue;
+
+            	vIndex = gp_GetVertexIndex(theGraph, v);
+
+            	while (!gp_GetVertexVisited(theGraph, v))
+                {
+            		temp = context->VI[v];
+            		context->VI[v] = context->VI[vIndex];
+            		context->VI[vIndex] = temp;
+
+                    gp_SetVertexVisited(theGraph, vIndex);
+
+                    vIndex = gp_GetVertexIndex(theGraph, vIndex);
+                }
+            }
+        }
+
+        if (context->functions.fpSortVertices(theGraph) != OK)
+            return NOTOK;
+
+        return OK;
+    }
+
+    return NOTOK;
+}
+
+/********************************************************************
+ ********************************************************************/
+
+void _DrawStraightLine_InitVertexInfo(DrawStraightLineContext *context, int v)
+{
+    context->VI[v].x = 0;
+    context->VI[v].y = 0;
+}
+
+/********************************************************************
+ ********************************************************************/
+
+int _DrawStraightLine_EmbedPostprocess(graphP theGraph, int v, int edgeEmbeddingResult)
+{
+    DrawStraightLineContext *context = NULL;
+    context = (DrawStraightLineContext *) gp_GetExtensionContext(theGraph, DRAWSTRAIGHTLINE_ID);
+
+    if (context != NULL)
+    {
+        int RetVal = context->functions.fpEmbedPostprocess(theGraph, v, edgeEmbeddingResult);
+
+        if (theGraph->embedFlags == EMBEDFLAGS_DRAWSTRAIGHTLINE)
+        {
+            if (RetVal == OK)
+            {
+                RetVal = _ComputeStraightLineDrawing(context);
+            }
+        }
+
+        return RetVal;
+    }
+
+    return NOTOK;
+}
+
+/********************************************************************
+ ********************************************************************/
+
+int  _DrawStraightLine_CheckEmbeddingIntegrity(graphP theGraph, graphP origGraph)
+{
+    DrawStraightLineContext *context = NULL;
+    context = (DrawStraightLineContext *) gp_GetExtensionContext(theGraph, DRAWSTRAIGHTLINE_ID);
+
+    if (context != NULL)
+    {
+        if (context->functions.fpCheckEmbeddingIntegrity(theGraph, origGraph) != OK)
+            return NOTOK;
+
+        if (theGraph->embedFlags == EMBEDFLAGS_DRAWSTRAIGHTLINE)
+            return _CheckStraightLineDrawingIntegrity(context);
+
+        return OK;
+    }
+
+    return NOTOK;
+}
+
+/********************************************************************
+ ********************************************************************/
+
+int  _DrawStraightLine_CheckObstructionIntegrity(graphP theGraph, graphP origGraph)
+{
+     (void) theGraph;
+     (void) origGraph;
+     return OK;
+}
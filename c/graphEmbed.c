@@ -48,6 +48,7 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 */
 
 #include <stdlib.h>
+#include <string.h>
 
 #include "graph.h"
 
@@ -59,9 +60,16 @@ extern int _IsolateKuratowskiSubgraph(graphP theGraph, int v, int R);
 extern int _IsolateOuterplanarObstruction(graphP theGraph, int v, int R);
 
 extern void _InitVertexRec(graphP theGraph, int v);
+extern void _InitEdgeRec(graphP theGraph, int e);
+
+extern int  _CopyBaseGraph(graphP dstGraph, graphP srcGraph);
+extern void _ReleasePreprocessCache(graphP theGraph);
+extern void _AdviseGraphMemory(graphP theGraph, int advice);
 
 /* Private functions (some are exported to system only) */
 
+int  _RestorePreprocessCache(graphP theGraph);
+void _DeletePreprocessedBackEdge(graphP theGraph, int e);
 int  _EmbeddingInitialize(graphP theGraph);
 
 void _EmbedBackEdgeToDescendant(graphP theGraph, int RootSide, int RootVertex, int W, int WPrevLink);
@@ -74,6 +82,7 @@ void _WalkUp(graphP theGraph, int v, int e);
 int  _WalkDown(graphP theGraph, int v, int RootVertex);
 
 int  _HandleBlockedBicomp(graphP theGraph, int v, int RootVertex, int R);
+int  _HandleInactiveVertex(graphP theGraph, int BicompRoot, int *pW, int *pWPrevLink);
 void _AdvanceFwdArcList(graphP theGraph, int v, int child, int nextChild);
 
 int  _EmbedPostprocess(graphP theGraph, int v, int edgeEmbeddingResult);
@@ -117,100 +126,211 @@ int  _JoinBicomps(graphP theGraph);
   The algorithm extension for gp_Embed() is encoded in the embedFlags,
   and the details of the return value can be found in the extension
   module that defines the embedding flag.
+
+  The body of gp_Embed(), along with _WalkDown() and _MergeBicomps(),
+  is instantiated from graphEmbed.template.h.  This generic copy calls
+  every embedder function through theGraph->functions.
+ ********************************************************************/
+
+#define EMBED_TEMPLATE_STORAGE
+#define EMBED_TEMPLATE_EMBED            gp_Embed
+#define EMBED_TEMPLATE_WALKDOWN         _WalkDown
+#define EMBED_TEMPLATE_MERGEBICOMPS     _MergeBicomps
+#define EMBED_TEMPLATE_OUTERPLANAR(theGraph) ((theGraph)->embedFlags & EMBEDFLAGS_OUTERPLANAR)
+
+#define EMBED_HOOK_EMBEDDINGINITIALIZE(theGraph) \
+        (theGraph)->functions.fpEmbeddingInitialize(theGraph)
+#define EMBED_HOOK_WALKUP(theGraph, v, e) \
+        (theGraph)->functions.fpWalkUp(theGraph, v, e)
+#define EMBED_HOOK_WALKDOWN(theGraph, v, RootVertex) \
+        (theGraph)->functions.fpWalkDown(theGraph, v, RootVertex)
+#define EMBED_HOOK_MERGEBICOMPS(theGraph, v, RootVertex, W, WPrevLink) \
+        (theGraph)->functions.fpMergeBicomps(theGraph, v, RootVertex, W, WPrevLink)
+#define EMBED_HOOK_MERGEVERTEX(theGraph, W, WPrevLink, R) \
+        (theGraph)->functions.fpMergeVertex(theGraph, W, WPrevLink, R)
+#define EMBED_HOOK_EMBEDBACKEDGETODESCENDANT(theGraph, RootSide, RootVertex, W, WPrevLink) \
+        (theGraph)->functions.fpEmbedBackEdgeToDescendant(theGraph, RootSide, RootVertex, W, WPrevLink)
+#define EMBED_HOOK_HANDLEBLOCKEDBICOMP(theGraph, v, RootVertex, R) \
+        (theGraph)->functions.fpHandleBlockedBicomp(theGraph, v, RootVertex, R)
+#define EMBED_HOOK_HANDLEINACTIVEVERTEX(theGraph, BicompRoot, pW, pWPrevLink) \
+        (theGraph)->functions.fpHandleInactiveVertex(theGraph, BicompRoot, pW, pWPrevLink)
+#define EMBED_HOOK_EMBEDPOSTPROCESS(theGraph, v, edgeEmbeddingResult) \
+        (theGraph)->functions.fpEmbedPostprocess(theGraph, v, edgeEmbeddingResult)
+
+#include "graphEmbed.template.h"
+
+/********************************************************************
+ Core embedder instantiations
+
+ One specialized copy of the embedder for each of the core planarity
+ and outerplanarity algorithms.  Their hooks call the core functions
+ of this module directly, and the outerplanarity stopping-vertex test
+ in the Walkdown becomes a compile-time constant.
+ ********************************************************************/
+
+#define EMBED_TEMPLATE_STORAGE          static
+#define EMBED_TEMPLATE_EMBED            _EmbedPlanarCore
+#define EMBED_TEMPLATE_WALKDOWN         _WalkDownPlanar
+#define EMBED_TEMPLATE_MERGEBICOMPS     _MergeBicompsPlanar
+#define EMBED_TEMPLATE_OUTERPLANAR(theGraph) 0
+
+#define EMBED_HOOK_EMBEDDINGINITIALIZE(theGraph) \
+        _EmbeddingInitialize(theGraph)
+#define EMBED_HOOK_WALKUP(theGraph, v, e) \
+        _WalkUp(theGraph, v, e)
+#define EMBED_HOOK_WALKDOWN(theGraph, v, RootVertex) \
+        _WalkDownPlanar(theGraph, v, RootVertex)
+#define EMBED_HOOK_MERGEBICOMPS(theGraph, v, RootVertex, W, WPrevLink) \
+        _MergeBicompsPlanar(theGraph, v, RootVertex, W, WPrevLink)
+#define EMBED_HOOK_MERGEVERTEX(theGraph, W, WPrevLink, R) \
+        _MergeVertex(theGraph, W, WPrevLink, R)
+#define EMBED_HOOK_EMBEDBACKEDGETODESCENDANT(theGraph, RootSide, RootVertex, W, WPrevLink) \
+        _EmbedBackEdgeToDescendant(theGraph, RootSide, RootVertex, W, WPrevLink)
+#define EMBED_HOOK_HANDLEBLOCKEDBICOMP(theGraph, v, RootVertex, R) \
+        _HandleBlockedBicomp(theGraph, v, RootVertex, R)
+#define EMBED_HOOK_HANDLEINACTIVEVERTEX(theGraph, BicompRoot, pW, pWPrevLink) \
+        _HandleInactiveVertex(theGraph, BicompRoot, pW, pWPrevLink)
+#define EMBED_HOOK_EMBEDPOSTPROCESS(theGraph, v, edgeEmbeddingResult) \
+        _EmbedPostprocess(theGraph, v, edgeEmbeddingResult)
+
+static int _WalkDownPlanar(graphP theGraph, int v, int RootVertex);
+static int _MergeBicompsPlanar(graphP theGraph, int v, int RootVertex, int W, int WPrevLink);
+
+#include "graphEmbed.template.h"
+
+#define EMBED_TEMPLATE_STORAGE          static
+#define EMBED_TEMPLATE_EMBED            _EmbedOuterplanarCore
+#define EMBED_TEMPLATE_WALKDOWN         _WalkDownOuterplanar
+#define EMBED_TEMPLATE_MERGEBICOMPS     _MergeBicompsOuterplanar
+#define EMBED_TEMPLATE_OUTERPLANAR(theGraph) 1
+
+#define EMBED_HOOK_EMBEDDINGINITIALIZE(theGraph) \
+        _EmbeddingInitialize(theGraph)
+#define EMBED_HOOK_WALKUP(theGraph, v, e) \
+        _WalkUp(theGraph, v, e)
+#define EMBED_HOOK_WALKDOWN(theGraph, v, RootVertex) \
+        _WalkDownOuterplanar(theGraph, v, RootVertex)
+#define EMBED_HOOK_MERGEBICOMPS(theGraph, v, RootVertex, W, WPrevLink) \
+        _MergeBicompsOuterplanar(theGraph, v, RootVertex, W, WPrevLink)
+#define EMBED_HOOK_MERGEVERTEX(theGraph, W, WPrevLink, R) \
+        _MergeVertex(theGraph, W, WPrevLink, R)
+#define EMBED_HOOK_EMBEDBACKEDGETODESCENDANT(theGraph, RootSide, RootVertex, W, WPrevLink) \
+        _EmbedBackEdgeToDescendant(theGraph, RootSide, RootVertex, W, WPrevLink)
+#define EMBED_HOOK_HANDLEBLOCKEDBICOMP(theGraph, v, RootVertex, R) \
+        _HandleBlockedBicomp(theGraph, v, RootVertex, R)
+#define EMBED_HOOK_HANDLEINACTIVEVERTEX(theGraph, BicompRoot, pW, pWPrevLink) \
+        _HandleInactiveVertex(theGraph, BicompRoot, pW, pWPrevLink)
+#define EMBED_HOOK_EMBEDPOSTPROCESS(theGraph, v, edgeEmbeddingResult) \
+        _EmbedPostprocess(theGraph, v, edgeEmbeddingResult)
+
+static int _WalkDownOuterplanar(graphP theGraph, int v, int RootVertex);
+static int _MergeBicompsOuterplanar(graphP theGraph, int v, int RootVertex, int W, int WPrevLink);
+
+#include "graphEmbed.template.h"
+
+/********************************************************************
+ _HasCoreEmbedFunctions()
+
+ Returns TRUE if none of the functions used by the embedder have been
+ overloaded by an extension, in which case the core instantiation
+ computes exactly what gp_Embed() would.
  ********************************************************************/
 
-int gp_Embed(graphP theGraph, int embedFlags)
+static int _HasCoreEmbedFunctions(graphP theGraph)
 {
-int v, e, c;
-int RetVal = OK;
+    return theGraph->functions.fpEmbeddingInitialize == _EmbeddingInitialize &&
+           theGraph->functions.fpWalkUp == _WalkUp &&
+           theGraph->functions.fpWalkDown == _WalkDown &&
+           theGraph->functions.fpMergeBicomps == _MergeBicomps &&
+           theGraph->functions.fpMergeVertex == _MergeVertex &&
+           theGraph->functions.fpEmbedBackEdgeToDescendant == _EmbedBackEdgeToDescendant &&
+           theGraph->functions.fpHandleBlockedBicomp == _HandleBlockedBicomp &&
+           theGraph->functions.fpHandleInactiveVertex == _HandleInactiveVertex &&
+           theGraph->functions.fpEmbedPostprocess == _EmbedPostprocess ? TRUE : FALSE;
+}
 
-    // Basic parameter checks
-    if (theGraph==NULL)
-    	return NOTOK;
+/********************************************************************
+ gp_EmbedPlanar()
+ gp_EmbedOuterplanar()
 
-    // Preprocessing
-    theGraph->embedFlags = embedFlags;
+ Equivalent to gp_Embed() with EMBEDFLAGS_PLANAR or EMBEDFLAGS_OUTERPLANAR,
+ respectively, but faster because the embedder hooks are bound at
+ compile time rather than called through theGraph->functions.
 
-    // Allow extension algorithms to postprocess the DFS
-    if (theGraph->functions.fpEmbeddingInitialize(theGraph) != OK)
-    	return NOTOK;
+ The function table is checked once per call.  If an attached extension
+ has overloaded any embedder function, then the call is passed on to
+ gp_Embed() so that the extension behaves exactly as it would otherwise.
 
-    // In reverse DFI order, embed the back edges from each vertex to its DFS descendants.
-    for (v = gp_GetLastVertex(theGraph); gp_VertexInRangeDescending(theGraph, v); v--)
-    {
-          RetVal = OK;
+ Returns the same values as gp_Embed().
+ ********************************************************************/
 
-          // Walkup calls establish Pertinence in Step v
-          // Do the Walkup for each cycle edge from v to a DFS descendant W.
-          e = gp_GetVertexFwdArcList(theGraph, v);
-          while (gp_IsArc(e))
-          {
-        	  theGraph->functions.fpWalkUp(theGraph, v, e);
+int gp_EmbedPlanar(graphP theGraph)
+{
+    if (theGraph == NULL)
+        return NOTOK;
 
-              e = gp_GetNextArc(theGraph, e);
-              if (e == gp_GetVertexFwdArcList(theGraph, v))
-                  e = NIL;
-          }
-          gp_SetVertexPertinentRootsList(theGraph, v, NIL);
+    if (!_HasCoreEmbedFunctions(theGraph))
+        return gp_Embed(theGraph, EMBEDFLAGS_PLANAR);
 
-          // Work systematically through the DFS children of vertex v, using Walkdown
-          // to add the back edges from v to its descendants in each of the DFS subtrees
-          c = gp_GetVertexSortedDFSChildList(theGraph, v);
-          while (gp_IsVertex(c))
-          {
-        	  if (gp_IsVertex(gp_GetVertexPertinentRootsList(theGraph, c)))
-        	  {
-        		  RetVal = theGraph->functions.fpWalkDown(theGraph, v, gp_GetRootFromDFSChild(theGraph, c));
-        		  // If Walkdown returns OK, then it is OK to proceed with edge addition.
-        		  // Otherwise, if Walkdown returns NONEMBEDDABLE then we stop edge addition.
-				  if (RetVal != OK)
-					  break;
-        	  }
-        	  c = gp_GetVertexNextDFSChild(theGraph, v, c);
-          }
+    return _EmbedPlanarCore(theGraph, EMBEDFLAGS_PLANAR);
+}
 
-          // If the Walkdown determined that the graph is NONEMBEDDABLE,
-          // then the guiding embedder loop can be stopped now.
-          if (RetVal != OK)
-        	  break;
-    }
+int gp_EmbedOuterplanar(graphP theGraph)
+{
+    if (theGraph == NULL)
+        return NOTOK;
 
-    // Postprocessing to orient the embedding and merge any remaining separated bicomps.
-    // Some extension algorithms may overload this function, e.g. to do nothing if they
-    // have no need of an embedding.
-    return theGraph->functions.fpEmbedPostprocess(theGraph, v, RetVal);
+    if (!_HasCoreEmbedFunctions(theGraph))
+        return gp_Embed(theGraph, EMBEDFLAGS_OUTERPLANAR);
+
+    return _EmbedOuterplanarCore(theGraph, EMBEDFLAGS_OUTERPLANAR);
 }
 
 /********************************************************************
- _EmbeddingInitialize()
+ gp_PreprocessForEmbedding()
 
- This method performs the following tasks:
- (1) Assign depth first index (DFI) and DFS parentvalues to vertices
+ This method performs the part of the embedding initialization that
+ depends only on the graph, not on the embedding algorithm:
+ (1) Assign depth first index (DFI) and DFS parent values to vertices
  (2) Assign DFS edge types
  (3) Create a sortedDFSChildList for each vertex, sorted by child DFI
  (4) Create a sortedFwdArcList for each vertex, sorted by descendant DFI
  (5) Assign leastAncestor values to vertices
  (6) Sort the vertices by their DFIs
- (7) Initialize for pertinence and future pertinence management
- (8) Embed each tree edge as a singleton biconnected component
+ (7) Assign lowpoint values to vertices
 
- The first five of these are performed in a single-pass DFS of theGraph.
- Afterward, the vertices are sorted by their DFIs, the lowpoint values
- are assigned and then the DFS tree edges stored in virtual vertices
- during the DFS are used to create the DFS tree embedding.
+ The first five of these are performed in a single-pass DFS of theGraph,
+ which also stores each DFS tree edge in the virtual vertex that will
+ be used by _EmbeddingInitialize() to embed the tree edge.
+
+ A graph on which this method succeeds has the FLAGS_EMBEDPREPROCESSED
+ flag, and gp_Embed() does not repeat the work for such a graph.  Since
+ gp_CopyPreprocessedGraph() copies the preprocessing results, a graph
+ can be preprocessed once and then copied into each graph on which an
+ embedding algorithm is to be run.  If the graph is already
+ preprocessed, then this method does nothing.
+
+ If the graph has a cache made by gp_CachePreprocessing(), then the
+ cached result is copied into the graph rather than being recomputed.
+
+ Returns OK on success, NOTOK on internal failure
  ********************************************************************/
-int  _EmbeddingInitialize(graphP theGraph)
+int  gp_PreprocessForEmbedding(graphP theGraph)
 {
 	stackP theStack;
 	int DFI, v, R, uparent, u, uneighbor, e, f, eTwin, ePrev, eNext;
 	int leastValue, child;
 
-#ifdef PROFILE
-platform_time start, end;
-platform_GetTime(start);
-#endif
+	if (theGraph == NULL)
+		return NOTOK;
 
-	gp_LogLine("graphEmbed.c/_EmbeddingInitialize() start\n");
+	if ((theGraph->internalFlags & FLAGS_EMBEDPREPROCESSED) &&
+		(theGraph->internalFlags & FLAGS_SORTEDBYDFI))
+		return OK;
+
+	if (theGraph->preprocessCache != NULL &&
+		!(theGraph->internalFlags & FLAGS_DFSNUMBERED))
+		return _RestorePreprocessCache(theGraph);
 
 	theStack  = theGraph->theStack;
 
@@ -252,7 +372,7 @@ platform_GetTime(start);
 			// or a false edge to the DFS tree root (u).
 			if (!gp_GetVertexVisited(theGraph, u))
 			{
-				gp_LogLine(gp_MakeLogStr3("v=%d, DFI=%d, parent=%d", u, DFI, uparent));
+				gp_Trace3(theGraph, TRACE_DFS_VISIT, u, DFI, uparent);
 
 				// (1) Set the DFI and DFS parent
 				gp_SetVertexVisited(theGraph, u);
@@ -269,7 +389,7 @@ platform_GetTime(start);
                     gp_SetVertexSortedDFSChildList(theGraph, uparent,
                     		gp_AppendDFSChild(theGraph, uparent, gp_GetVertexIndex(theGraph, u)));
 
-					// (8) Record e as the first and last arc of the virtual vertex R,
+					// Record e as the first and last arc of the virtual vertex R,
 					//     a root copy of uparent uniquely associated with child u
                     R = gp_GetRootFromDFSChild(theGraph, gp_GetVertexIndex(theGraph, u));
                 	gp_SetFirstArc(theGraph, R, e);
@@ -343,16 +463,12 @@ platform_GetTime(start);
     if (gp_SortVertices(theGraph) != OK)
         return NOTOK;
 
-    // Loop through the vertices and virtual vertices to...
+    // (7) Compute the lowpoint of each vertex in reverse DFI order, so that
+    //     the lowpoints of the DFS children of the vertex are already known
     for (v = gp_GetLastVertex(theGraph); gp_VertexInRangeDescending(theGraph, v); v--)
     {
-    	// (7) Initialize for pertinence management
-        gp_SetVertexVisitedInfo(theGraph, v, theGraph->N);
-
-        // (7) Initialize for future pertinence management
-        child = gp_GetVertexSortedDFSChildList(theGraph, v);
-        gp_SetVertexFuturePertinentChild(theGraph, v, child);
 		leastValue = gp_GetVertexLeastAncestor(theGraph, v);
+        child = gp_GetVertexSortedDFSChildList(theGraph, v);
 	    while (gp_IsVertex(child))
 	    {
 	    	if (leastValue > gp_GetVertexLowpoint(theGraph, child))
@@ -361,8 +477,228 @@ platform_GetTime(start);
 	    	child = gp_GetVertexNextDFSChild(theGraph, v, child);
 	    }
 		gp_SetVertexLowpoint(theGraph, v, leastValue);
+    }
+
+    theGraph->internalFlags |= FLAGS_EMBEDPREPROCESSED;
+
+	return OK;
+}
+
+/********************************************************************
+ gp_CachePreprocessing()
+
+ Preprocesses a copy of theGraph with gp_PreprocessForEmbedding() and
+ keeps the copy with theGraph, so that the DFS, the sort and the
+ lowpoint computation are done only once no matter how many times
+ theGraph, or a copy of it made by gp_CopyGraph() or gp_DupGraph(),
+ is then embedded.  This suits running several algorithms on the same
+ input graph, each on its own copy.
+
+ The cache is dropped by any change to the vertices or edges of the
+ graph, e.g. by gp_AddEdge(), gp_HideEdge() or gp_ReinitializeGraph(),
+ as well as by gp_CreateDFSTree() and by the embedding itself, since
+ each leaves the cache out of date.  The exception is gp_DeleteEdge()
+ of an edge that is not a DFS tree edge, which leaves the DFS tree as
+ it was, so the edge is deleted from the cache as well.  Changes made
+ directly to the edge records, e.g. with gp_AttachArc(), are not
+ detected.
+
+ As for gp_CopyPreprocessedGraph(), the extension data of a graph that
+ uses the cache must be in its initial state when it is embedded.
+
+ Returns OK on success, NOTOK if theGraph is DFS numbered or on
+ internal failure.  If theGraph already has a cache, it is kept.
+ ********************************************************************/
+int  gp_CachePreprocessing(graphP theGraph)
+{
+	preprocessCacheP cache;
+	graphP cacheGraph = NULL;
+
+	if (theGraph == NULL || theGraph->N == 0 ||
+		(theGraph->internalFlags & FLAGS_DFSNUMBERED))
+		return NOTOK;
+
+	if (theGraph->preprocessCache != NULL)
+		return OK;
+
+	if ((cache = (preprocessCacheP) malloc(sizeof(preprocessCacheRec))) == NULL)
+		return NOTOK;
+
+	if ((cacheGraph = gp_New()) == NULL ||
+		gp_EnsureArcCapacity(cacheGraph, theGraph->arcCapacity) != OK ||
+		gp_InitGraph(cacheGraph, theGraph->N) != OK ||
+		_CopyBaseGraph(cacheGraph, theGraph) != OK ||
+		gp_PreprocessForEmbedding(cacheGraph) != OK)
+	{
+		gp_Free(&cacheGraph);
+		free(cache);
+		return NOTOK;
+	}
+
+	cache->theGraph = cacheGraph;
+	cache->refCount = 1;
+	theGraph->preprocessCache = cache;
+
+	return OK;
+}
+
+/********************************************************************
+ _RestorePreprocessCache()
+
+ Copies the cached result of gp_PreprocessForEmbedding() into theGraph.
+ The embedFlags of theGraph are kept, since gp_Embed() sets them before
+ preprocessing.  theGraph keeps the cache, which still describes it, so
+ that copies of the preprocessed graph also share the cache.
+
+ Returns OK on success, NOTOK on internal failure
+ ********************************************************************/
+int  _RestorePreprocessCache(graphP theGraph)
+{
+	preprocessCacheP cache = theGraph->preprocessCache;
+	int embedFlags = theGraph->embedFlags;
+	int RetVal;
+
+	// Detach the cache first, or else copying the cached graph, which has
+	// no cache, would release it while it is being copied
+	theGraph->preprocessCache = NULL;
+
+	RetVal = _CopyBaseGraph(theGraph, cache->theGraph);
+	theGraph->embedFlags = embedFlags;
+
+	theGraph->preprocessCache = cache;
+
+	return RetVal;
+}
+
+/********************************************************************
+ _DeletePreprocessedBackEdge()
+
+ Deletes the back edge whose back arc e is in the adjacency list of
+ the descendant and whose forward arc is in the sortedFwdArcList of
+ the ancestor, as left by gp_PreprocessForEmbedding().  The least
+ ancestor of the descendant is recomputed from its remaining back
+ arcs, and the lowpoints are updated up the DFS tree until one of
+ them does not change, which leaves the graph as if it had been
+ preprocessed without the edge but with the same DFS tree.
+ ********************************************************************/
+
+void _DeletePreprocessedBackEdge(graphP theGraph, int e)
+{
+int  eTwin = gp_GetTwinArc(theGraph, e);
+int  ancestor = gp_GetNeighbor(theGraph, e), descendant = gp_GetNeighbor(theGraph, eTwin);
+int  ePrev, eNext, v, child, leastValue;
+
+    _ReleasePreprocessCache(theGraph);
+
+    // Remove the back arc from the adjacency list of the descendant
+    gp_DetachArc(theGraph, e);
+
+    // Remove the forward arc from the circular list of the ancestor
+    ePrev = gp_GetPrevArc(theGraph, eTwin);
+    eNext = gp_GetNextArc(theGraph, eTwin);
+    if (eNext == eTwin)
+        gp_SetVertexFwdArcList(theGraph, ancestor, NIL);
+    else
+    {
+        gp_SetNextArc(theGraph, ePrev, eNext);
+        gp_SetPrevArc(theGraph, eNext, ePrev);
+        if (gp_GetVertexFwdArcList(theGraph, ancestor) == eTwin)
+            gp_SetVertexFwdArcList(theGraph, ancestor, eNext);
+    }
+
+    // Clear the edge records as gp_DeleteEdge() does
+#if NIL == 0
+    memset(theGraph->E + (e & ~1), NIL_CHAR, sizeof(edgeRec) << 1);
+#else
+    _InitEdgeRec(theGraph, e);
+    _InitEdgeRec(theGraph, eTwin);
+#endif
+
+    theGraph->M--;
+    if (e < gp_EdgeInUseIndexBound(theGraph))
+        sp_Push(theGraph->edgeHoles, e);
 
-		// (8) Create the DFS tree embedding using the child edge records stored in the virtual vertices
+    // Recompute the least ancestor of the descendant
+    leastValue = descendant;
+    e = gp_GetFirstArc(theGraph, descendant);
+    while (gp_IsArc(e))
+    {
+        if (gp_GetEdgeType(theGraph, e) == EDGE_TYPE_BACK &&
+            gp_GetNeighbor(theGraph, e) < leastValue)
+            leastValue = gp_GetNeighbor(theGraph, e);
+
+        e = gp_GetNextArc(theGraph, e);
+    }
+    gp_SetVertexLeastAncestor(theGraph, descendant, leastValue);
+
+    // Lowpoints can only increase, and only along the path to the root
+    for (v = descendant; gp_IsVertex(v); v = gp_GetVertexParent(theGraph, v))
+    {
+        leastValue = gp_GetVertexLeastAncestor(theGraph, v);
+        child = gp_GetVertexSortedDFSChildList(theGraph, v);
+        while (gp_IsVertex(child))
+        {
+            if (leastValue > gp_GetVertexLowpoint(theGraph, child))
+                leastValue = gp_GetVertexLowpoint(theGraph, child);
+
+            child = gp_GetVertexNextDFSChild(theGraph, v, child);
+        }
+
+        if (leastValue == gp_GetVertexLowpoint(theGraph, v))
+            break;
+
+        gp_SetVertexLowpoint(theGraph, v, leastValue);
+    }
+}
+
+/********************************************************************
+ _EmbeddingInitialize()
+
+ This method performs the following tasks:
+ (1) Preprocess the graph with gp_PreprocessForEmbedding(), unless
+     this has already been done
+ (2) Initialize for pertinence and future pertinence management
+ (3) Embed each tree edge as a singleton biconnected component
+
+ The DFS tree edges stored in virtual vertices during the DFS are used
+ to create the DFS tree embedding.  Since this changes the adjacency
+ lists, the graph is no longer marked as preprocessed afterward, and
+ its preprocessing cache, if any, is released.
+ ********************************************************************/
+int  _EmbeddingInitialize(graphP theGraph)
+{
+	int v, R, e, eTwin, child;
+
+#ifdef PROFILE
+platform_time start, end;
+platform_counters startCounters, endCounters;
+platform_GetTime(start);
+platform_GetCounters(&startCounters);
+#endif
+
+	gp_Trace0(theGraph, TRACE_EMBEDDINGINITIALIZE_BEGIN);
+
+	// The DFS and the embedder follow edges to vertices anywhere in the arrays
+	_AdviseGraphMemory(theGraph, PLATFORM_ADVISE_RANDOM);
+
+	// (1) Perform the DFS, the sort and the lowpoint computation
+	if (gp_PreprocessForEmbedding(theGraph) != OK)
+		return NOTOK;
+
+	theGraph->internalFlags &= ~FLAGS_EMBEDPREPROCESSED;
+	_ReleasePreprocessCache(theGraph);
+
+    // Loop through the vertices and virtual vertices to...
+    for (v = gp_GetLastVertex(theGraph); gp_VertexInRangeDescending(theGraph, v); v--)
+    {
+    	// (2) Initialize for pertinence management
+        gp_SetVertexVisitedInfo(theGraph, v, theGraph->N);
+
+        // (2) Initialize for future pertinence management
+        child = gp_GetVertexSortedDFSChildList(theGraph, v);
+        gp_SetVertexFuturePertinentChild(theGraph, v, child);
+
+		// (3) Create the DFS tree embedding using the child edge records stored in the virtual vertices
     	//     For each vertex v that is a DFS child, the virtual vertex R that will represent v's parent
     	//     in the singleton bicomp with v is at location v + N in the vertex array.
         if (gp_IsDFSTreeRoot(theGraph, v))
@@ -397,11 +733,13 @@ platform_GetTime(start);
         }
     }
 
-	gp_LogLine("graphEmbed.c/_EmbeddingInitialize() end\n");
+	gp_Trace0(theGraph, TRACE_EMBEDDINGINITIALIZE_END);
 
 #ifdef PROFILE
+platform_GetCounters(&endCounters);
 platform_GetTime(end);
 printf("Initialize embedding in %.3lf seconds.\n", platform_GetDuration(start,end));
+platform_PrintCounters("Initialize embedding", &startCounters, &endCounters, theGraph->M);
 #endif
 
 	return OK;
@@ -430,8 +768,7 @@ int fwdArc, backArc, parentCopy;
 
     parentCopy = gp_GetPrimaryVertexFromRoot(theGraph, RootVertex);
 
-    gp_LogLine(gp_MakeLogStr5("graphEmbed.c/_EmbedBackEdgeToDescendant() V=%d, R=%d, R_out=%d, W=%d, W_in=%d",
-    		parentCopy, RootVertex, RootSide, W, WPrevLink));
+    gp_Trace5(theGraph, TRACE_EMBEDBACKEDGE, parentCopy, RootVertex, RootSide, W, WPrevLink);
 
     if (gp_GetVertexFwdArcList(theGraph, parentCopy) == fwdArc)
     {
@@ -477,7 +814,7 @@ void _InvertVertex(graphP theGraph, int W)
 {
 int e, temp;
 
-	 gp_LogLine(gp_MakeLogStr1("graphEmbed.c/_InvertVertex() W=%d", W));
+	 gp_Trace1(theGraph, TRACE_INVERTVERTEX, W);
 
      // Swap the links in all the arcs of the adjacency list
      e = gp_GetFirstArc(theGraph, W);
@@ -530,8 +867,7 @@ void _MergeVertex(graphP theGraph, int W, int WPrevLink, int R)
 {
 int  e, eTwin, e_w, e_r, e_ext;
 
-	 gp_LogLine(gp_MakeLogStr4("graphEmbed.c/_MergeVertex() W=%d, W_in=%d, R=%d, R_out=%d",
-			 W, WPrevLink, R, 1^WPrevLink));
+	 gp_Trace4(theGraph, TRACE_MERGEVERTEX, W, WPrevLink, R, 1^WPrevLink);
 
      // All arcs leading into R from its neighbors must be changed
      // to say that they are leading into W
@@ -581,100 +917,6 @@ int  e, eTwin, e_w, e_r, e_ext;
      _InitVertexRec(theGraph, R);
 }
 
-/********************************************************************
- _MergeBicomps()
-
- Merges all biconnected components at the cut vertices indicated by
- entries on the stack.
-
- theGraph contains the stack of bicomp roots and cut vertices to merge
-
- v, RootVertex, W and WPrevLink are not used in this routine, but are
-          used by overload extensions
-
- Returns OK, but an extension function may return a value other than
-         OK in order to cause Walkdown to terminate immediately.
-********************************************************************/
-
-int  _MergeBicomps(graphP theGraph, int v, int RootVertex, int W, int WPrevLink)
-{
-int  R, Rout, Z, ZPrevLink, e, extFaceVertex;
-
-     while (sp_NonEmpty(theGraph->theStack))
-     {
-         sp_Pop2(theGraph->theStack, R, Rout);
-         sp_Pop2(theGraph->theStack, Z, ZPrevLink);
-
-         /* The external faces of the bicomps containing R and Z will
-            form two corners at Z.  One corner will become part of the
-            internal face formed by adding the new back edge. The other
-            corner will be the new external face corner at Z.
-            We first want to update the links at Z to reflect this. */
-
-         extFaceVertex = gp_GetExtFaceVertex(theGraph, R, 1^Rout);
-         gp_SetExtFaceVertex(theGraph, Z, ZPrevLink, extFaceVertex);
-
-         if (gp_GetExtFaceVertex(theGraph, extFaceVertex, 0) == gp_GetExtFaceVertex(theGraph, extFaceVertex, 1))
-        	 // When (R, extFaceVertex) form a singleton bicomp, they have the same orientation, so the Rout link in extFaceVertex
-        	 // is the one that has to now point back to Z
-        	 gp_SetExtFaceVertex(theGraph, extFaceVertex, Rout, Z);
-         else
-        	 // When R and extFaceVertex are not alone in the bicomp, then they may not have the same orientation, so the
-        	 // ext face link that should point to Z is whichever one pointed to R, since R is a root copy of Z.
-             gp_SetExtFaceVertex(theGraph, extFaceVertex, gp_GetExtFaceVertex(theGraph, extFaceVertex, 0) == R ? 0 : 1, Z);
-
-         /* If the path used to enter Z is opposed to the path
-            used to exit R, then we have to flip the bicomp
-            rooted at R, which we signify by inverting R
-            then setting the sign on its DFS child edge to
-            indicate that its descendants must be flipped later */
-
-         if (ZPrevLink == Rout)
-         {
-             Rout = 1^ZPrevLink;
-
-             if (gp_GetFirstArc(theGraph, R) != gp_GetLastArc(theGraph, R))
-                _InvertVertex(theGraph, R);
-
-             e = gp_GetFirstArc(theGraph, R);
-             while (gp_IsArc(e))
-             {
-                 if (gp_GetEdgeType(theGraph, e) == EDGE_TYPE_CHILD)
-                 {
-                	 // The core planarity algorithm could simply "set" the inverted flag
-                	 // because a bicomp root edge cannot be already inverted in the core
-                	 // planarity algorithm at the time of this merge.
-                	 // However, extensions may perform edge reductions on tree edges, resulting
-                	 // in an inversion sign being promoted to the root edge of a bicomp before
-                	 // it gets merged.  So, xor is used to reverse the inversion flag on the
-                	 // root edge if the bicomp root must be inverted before it is merged.
-                	 gp_XorEdgeFlagInverted(theGraph, e);
-                     break;
-                 }
-
-                 e = gp_GetNextArc(theGraph, e);
-             }
-         }
-
-         // R is no longer pertinent to Z since we are about to merge R into Z, so we delete R
-         // from Z's pertinent bicomp list (Walkdown gets R from the head of the list).
-         gp_DeleteVertexPertinentRoot(theGraph, Z, R);
-
-         // If the merge will place the current future pertinence child into the same bicomp as Z,
-         // then we advance to the next child (or NIL) because future pertinence is
-         if (gp_GetDFSChildFromRoot(theGraph, R) == gp_GetVertexFuturePertinentChild(theGraph, Z))
-         {
-        	 gp_SetVertexFuturePertinentChild(theGraph, Z,
-        			 gp_GetVertexNextDFSChild(theGraph, Z, gp_GetVertexFuturePertinentChild(theGraph, Z)));
-         }
-
-         // Now we push R into Z, eliminating R
-         theGraph->functions.fpMergeVertex(theGraph, Z, ZPrevLink, R);
-     }
-
-     return OK;
-}
-
 /********************************************************************
  _WalkUp()
  v is the vertex currently being embedded
@@ -805,231 +1047,6 @@ int  nextZig, nextZag, R;
      }
 }
 
-/********************************************************************
- _WalkDown()
- Consider a circular shape with small circles and squares along its perimeter.
- The small circle at the top is the root vertex of the bicomp.  The other small
- circles represent active vertices, and the squares represent future pertinent
- vertices.  The root vertex is a root copy of v, the vertex currently being processed.
-
- The Walkup previously marked all vertices adjacent to v by setting their
- pertinentEdge members with the forward arcs of the back edges to embed.
- Two Walkdown traversals are performed to visit all reachable vertices
- along each of the external face paths emanating from RootVertex (a root
- copy of vertex v) to embed back edges to descendants of vertex v that
- have their pertinentEdge members marked.
-
- During each Walkdown traversal, it is sometimes necessary to hop from a
- vertex to one of its child biconnected components in order to reach the
- desired vertices.  In such cases, the biconnected components are merged
- such that adding the back edge forms a new proper face in the biconnected
- component rooted at RootVertex (which, again, is a root copy of v).
-
- The outer loop performs both walks, unless the first walk got all the way
- around to RootVertex (only happens when bicomp contains no external activity,
- such as when processing the last vertex), or when non-planarity is
- discovered (in a pertinent child bicomp such that the stack is non-empty).
-
- For the inner loop, each iteration visits a vertex W.  If W is marked as
- requiring a back edge, then MergeBicomps is called to merge the biconnected
- components whose cut vertices have been collecting in merge stack.  Then,
- the back edge (RootVertex, W) is added, and the pertinentEdge of W is cleared.
-
- Next, we check whether W has a pertinent child bicomp.  If so, then we figure
- out which path down from the root of the child bicomp leads to the next vertex
- to be visited, and we push onto the stack information on the cut vertex and
- the paths used to enter into it and exit from it.  Alternately, if W
- had no pertinent child bicomps, then we check to see if it is inactive.
- If so, we find the next vertex along the external face, then short-circuit
- its inactive predecessor (under certain conditions).  Finally, if W is not
- inactive, but it has no pertinent child bicomps, then we already know its
- adjacentTo flag is clear so both criteria for internal activity also fail.
- Therefore, W must be a stopping vertex.
-
- A stopping vertex X is a future pertinent vertex that has no pertinent
- child bicomps and no unembedded back edge to the current vertex v.
- The inner loop of Walkdown stops walking when it reaches a stopping vertex X
- because if it were to proceed beyond X and embed a back edge, then X would be
- surrounded by the bounding cycle of the bicomp.  This would clearly be
- incorrect because X has a path leading from it to an ancestor of v, which
- would have to cross the bounding cycle.
-
- Either Walkdown traversal can halt the Walkdown and return if a pertinent
- child biconnected component to which the traversal has descended is blocked,
- i.e. has stopping vertices on both paths emanating from the root.  This
- indicates an obstruction to embedding. In core planarity it is evidence of
- a K_{3,3}, but some extension algorithms are able to clear the blockage and
- proceed with embedding.
-
- If both Walkdown traversals successfully completed, then the outer loop
- ends.  Post-processing code tests whether the Walkdown embedded all the
- back edges from v to its descendants in the subtree rooted by c, a DFS
- child of v uniquely associated with the RootVertex.  If not, then embedding
- was obstructed.  In core planarity it is evidence of a K_{3,3} or K_5, but some
- extension algorithms are able to clear the blockage and proceed with embedding.
-
-  Returns OK if all possible edges were embedded,
-  	  	  NONEMBEDDABLE if less than all possible edges were embedded,
-  	  	  NOTOK for an internal code failure
- ********************************************************************/
-
-int  _WalkDown(graphP theGraph, int v, int RootVertex)
-{
-int  RetVal, W, WPrevLink, R, X, XPrevLink, Y, YPrevLink, RootSide, e;
-int  RootEdgeChild = gp_GetDFSChildFromRoot(theGraph, RootVertex);
-
-     sp_ClearStack(theGraph->theStack);
-
-     for (RootSide = 0; RootSide < 2; RootSide++)
-     {
-         W = gp_GetExtFaceVertex(theGraph, RootVertex, RootSide);
-
-         // Determine the link used to enter W based on which side points back to RootVertex
-         // Implicitly handled special case: In core planarity, the first Walkdown traversal
-         // Will be on a singleton edge.  In this case, RootVertex and W are *consistently*
-         // oriented, and the RootSide is 0, so WPrevLink should be 1. This calculation is
-         // written to implicitly produce that result.
-         WPrevLink = gp_GetExtFaceVertex(theGraph, W, 1) == RootVertex ? 1 : 0;
-
-         while (W != RootVertex)
-         {
-             // Detect unembedded back edge descendant endpoint W
-             if (gp_IsArc(gp_GetVertexPertinentEdge(theGraph, W)))
-             {
-                // Merge any bicomps whose cut vertices were traversed to reach W, then add the
-            	// edge to W to form a new proper face in the embedding.
-                if (sp_NonEmpty(theGraph->theStack))
-                {
-                    if ((RetVal = theGraph->functions.fpMergeBicomps(theGraph, v, RootVertex, W, WPrevLink)) != OK)
-                        return RetVal;
-                }
-                theGraph->functions.fpEmbedBackEdgeToDescendant(theGraph, RootSide, RootVertex, W, WPrevLink);
-
-                // Clear W's pertinentEdge since the forward arc it contained has been embedded
-                gp_SetVertexPertinentEdge(theGraph, W, NIL);
-             }
-
-             // If W has a pertinent child bicomp, then we descend to the first one...
-             if (gp_IsVertex(gp_GetVertexPertinentRootsList(theGraph, W)))
-             {
-            	 // Push the vertex W and the direction of entry, then descend to a root copy R of W
-                 sp_Push2(theGraph->theStack, W, WPrevLink);
-                 R = gp_GetVertexFirstPertinentRoot(theGraph, W);
-
-                 // Get the next active vertices X and Y on the external face paths emanating from R
-                 X = gp_GetExtFaceVertex(theGraph, R, 0);
-                 XPrevLink = gp_GetExtFaceVertex(theGraph, X, 1)==R ? 1 : 0;
-                 Y = gp_GetExtFaceVertex(theGraph, R, 1);
-                 YPrevLink = gp_GetExtFaceVertex(theGraph, Y, 0)==R ? 0 : 1;
-
-                 // Now we implement the Walkdown's simple path selection rules!
-                 // Select a direction from the root to a pertinent vertex,
-                 // preferentially toward a vertex that is not future pertinent
-                 gp_UpdateVertexFuturePertinentChild(theGraph, X, v);
-                 gp_UpdateVertexFuturePertinentChild(theGraph, Y, v);
-                 if (PERTINENT(theGraph, X) && NOTFUTUREPERTINENT(theGraph, X, v))
-				 {
-					 W = X;
-					 WPrevLink = XPrevLink;
-					 sp_Push2(theGraph->theStack, R, 0);
-				 }
-                 else if (PERTINENT(theGraph, Y) && NOTFUTUREPERTINENT(theGraph, Y, v))
-            	 {
-                     W = Y;
-                     WPrevLink = YPrevLink;
-                     sp_Push2(theGraph->theStack, R, 1);
-            	 }
-                 else if (PERTINENT(theGraph, X))
-				 {
-					 W = X;
-					 WPrevLink = XPrevLink;
-					 sp_Push2(theGraph->theStack, R, 0);
-				 }
-                 else if (PERTINENT(theGraph, Y))
-            	 {
-                     W = Y;
-                     WPrevLink = YPrevLink;
-                     sp_Push2(theGraph->theStack, R, 1);
-            	 }
-                 else
-                 {
-                	 // Both the X and Y sides of the descendant bicomp are blocked.
-                	 // Let the application decide whether it can unblock the bicomp.
-                	 // The core planarity/outerplanarity embedder simply isolates a
-                	 // planarity/outerplanary obstruction and returns NONEMBEDDABLE
-                     if ((RetVal = theGraph->functions.fpHandleBlockedBicomp(theGraph, v, RootVertex, R)) != OK)
-                         return RetVal;
-
-                     // If an extension algorithm cleared the blockage, then we pop W and WPrevLink
-                     // back off the stack and let the Walkdown traversal try descending again
-                     sp_Pop2(theGraph->theStack, W, WPrevLink);
-                 }
-             }
-             else
-             {
-                 // The vertex W is known to be non-pertinent, so if it is future pertinent
-                 // (or if the algorithm is based on outerplanarity), then the vertex is
-                 // a stopping vertex for the Walkdown traversal.
-            	 gp_UpdateVertexFuturePertinentChild(theGraph, W, v);
-                 if (FUTUREPERTINENT(theGraph, W, v) || (theGraph->embedFlags & EMBEDFLAGS_OUTERPLANAR))
-                 {
-                	 // Create an external face short-circuit between RootVertex and the stopping vertex W
-                	 // so that future steps do not walk down a long path of inactive vertices between them.
-                	 // As a special case, we ensure that the external face is not reduced to just two
-                	 // vertices, W and RootVertex, because it would then become a challenge to determine
-                	 // whether W has the same orientation as RootVertex.
-                	 // So, if the other side of RootVertex is already attached to W, then we simply push
-                	 // W back one vertex so that the external face will have at least three vertices.
-                	 if (gp_GetExtFaceVertex(theGraph, RootVertex, 1^RootSide) == W)
-                	 {
-                	     X = W;
-                	     W = gp_GetExtFaceVertex(theGraph, W, WPrevLink);
-                	     WPrevLink = gp_GetExtFaceVertex(theGraph, W, 0) == X ? 1 : 0;
-                	 }
-                     gp_SetExtFaceVertex(theGraph, RootVertex, RootSide, W);
-                     gp_SetExtFaceVertex(theGraph, W, WPrevLink, RootVertex);
-
-                     // Terminate the Walkdown traversal since it encountered the stopping vertex
-                     break;
-                 }
-
-                 // If the vertex is neither pertinent nor future pertinent, then it is inactive.
-            	 // The default handler planarity handler simply skips inactive vertices by traversing
-                 // to the next vertex on the external face.
-                 // Once upon a time, false edges called short-circuit edges were added to eliminate
-                 // inactive vertices, but the extFace links above achieve the same result with less work.
-                 else
-                 {
-                     if (theGraph->functions.fpHandleInactiveVertex(theGraph, RootVertex, &W, &WPrevLink) != OK)
-                         return NOTOK;
-                 }
-             }
-         }
-     }
-
-     // Detect and handle the case in which Walkdown was blocked from embedding all the back edges from v
-     // to descendants in the subtree of the child of v associated with the bicomp RootVertex.
-	 if (gp_IsArc(e = gp_GetVertexFwdArcList(theGraph, v)) && RootEdgeChild < gp_GetNeighbor(theGraph, e))
-	 {
-	     int nextChild = gp_GetVertexNextDFSChild(theGraph, v, RootEdgeChild);
-
-	     // The Walkdown was blocked from embedding all forward arcs into the RootEdgeChild subtree
-	     // if there the next child's DFI is greater than the descendant endpoint of the next forward arc,
-	     // or if there is no next child.
-	     if (gp_IsNotVertex(nextChild) || nextChild > gp_GetNeighbor(theGraph, e))
-	     {
-	    	 // If an extension indicates it is OK to proceed despite the unembedded forward arcs, then
-	    	 // advance to the forward arcs for the next child, if any
-	    	 if ((RetVal = theGraph->functions.fpHandleBlockedBicomp(theGraph, v, RootVertex, RootVertex)) == OK)
-	    		 _AdvanceFwdArcList(theGraph, v, RootEdgeChild, nextChild);
-
-	    	 return RetVal;
-	     }
-	 }
-
-     return OK;
-}
-
 /********************************************************************
  _HandleBlockedBicomp()
 
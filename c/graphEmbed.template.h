@@ -0,0 +1,530 @@
+/*
+Planarity-Related Graph Algorithms Project
+Copyright (c) 1997-2012, John M. Boyer
+All rights reserved. Includes a reference implementation of the following:
+
+* John M. Boyer. "Subgraph Homeomorphism via the Edge Addition Planarity Algorithm".
+  Journal of Graph Algorithms and Applications, Vol. 16, no. 2, pp. 381-410, 2012.
+  http://www.jgaa.info/16/268.html
+
+* John M. Boyer. "A New Method for Efficiently Generating Planar Graph
+  Visibility Representations". In P. Eades and P. Healy, editors,
+  Proceedings of the 13th International Conference on Graph Drawing 2005,
+  Lecture Notes Comput. Sci., Volume 3843, pp. 508-511, Springer-Verlag, 2006.
+
+* John M. Boyer and Wendy J. Myrvold. "On the Cutting Edge: Simplified O(n)
+  Planarity by Edge Addition". Journal of Graph Algorithms and Applications,
+  Vol. 8, No. 3, pp. 241-273, 2004.
+  http://www.jgaa.info/08/91.html
+
+* John M. Boyer. "Simplified O(n) Algorithms for Planar Graph Embedding,
+  Kuratowski Subgraph Isolation, and Related Problems". Ph.D. Dissertation,
+  University of Victoria, 2001.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+* Redistributions of source code must retain the above copyright notice, this
+  list of conditions and the following disclaimer.
+
+* Redistributions in binary form must reproduce the above copyright notice, this
+  list of conditions and the following disclaimer in the documentation and/or
+  other materials provided with the distribution.
+
+* Neither the name of the Planarity-Related Graph Algorithms Project nor the names
+  of its contributors may be used to endorse or promote products derived from this
+  software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+/* This file is deliberately not guarded against multiple inclusion.
+
+   It holds the single source of the embedder's main loop (the driver
+   behind gp_Embed()), the Walkdown and the bicomp merge, written in
+   terms of the macros below.  Each inclusion instantiates one copy of
+   those routines.  The generic copy in graphEmbed.c dispatches every
+   hook through theGraph->functions so that extensions can overload it.
+   The specialized copies bind the hooks directly to known functions at
+   compile time, so the compiler can inline them and the function table
+   need not be consulted inside the inner loops.
+
+   Required before inclusion:
+
+   EMBED_TEMPLATE_STORAGE       storage class of the generated functions
+                                (empty or static)
+   EMBED_TEMPLATE_EMBED         name of the generated embedder driver
+   EMBED_TEMPLATE_WALKDOWN      name of the generated Walkdown
+   EMBED_TEMPLATE_MERGEBICOMPS  name of the generated bicomp merge, or
+                                leave undefined to omit it
+
+   EMBED_TEMPLATE_OUTERPLANAR(theGraph)  nonzero if every non-pertinent
+                                vertex is a stopping vertex
+
+   EMBED_HOOK_EMBEDDINGINITIALIZE(theGraph)
+   EMBED_HOOK_WALKUP(theGraph, v, e)
+   EMBED_HOOK_WALKDOWN(theGraph, v, RootVertex)
+   EMBED_HOOK_MERGEBICOMPS(theGraph, v, RootVertex, W, WPrevLink)
+   EMBED_HOOK_MERGEVERTEX(theGraph, W, WPrevLink, R)
+   EMBED_HOOK_EMBEDBACKEDGETODESCENDANT(theGraph, RootSide, RootVertex, W, WPrevLink)
+   EMBED_HOOK_HANDLEBLOCKEDBICOMP(theGraph, v, RootVertex, R)
+   EMBED_HOOK_HANDLEINACTIVEVERTEX(theGraph, BicompRoot, pW, pWPrevLink)
+   EMBED_HOOK_EMBEDPOSTPROCESS(theGraph, v, edgeEmbeddingResult)
+
+   All of the above are undefined again at the end of this file.
+   The including file must declare _AdvanceFwdArcList() and whatever
+   functions its hooks name.
+*/
+
+/********************************************************************
+ EMBED_TEMPLATE_EMBED()
+
+ The embedder's main loop.  See gp_Embed() for the return values.
+ ********************************************************************/
+
+EMBED_TEMPLATE_STORAGE int EMBED_TEMPLATE_EMBED(graphP theGraph, int embedFlags)
+{
+int v, e, c;
+int RetVal = OK;
+
+#ifdef PROFILE
+platform_time start, end;
+platform_counters startCounters, endCounters;
+#endif
+
+    // Basic parameter checks
+    if (theGraph==NULL)
+    	return NOTOK;
+
+    // Preprocessing
+    theGraph->embedFlags = embedFlags;
+
+    // Allow extension algorithms to postprocess the DFS
+    if (EMBED_HOOK_EMBEDDINGINITIALIZE(theGraph) != OK)
+    	return NOTOK;
+
+#ifdef PROFILE
+platform_GetTime(start);
+platform_GetCounters(&startCounters);
+#endif
+
+    // In reverse DFI order, embed the back edges from each vertex to its DFS descendants.
+    for (v = gp_GetLastVertex(theGraph); gp_VertexInRangeDescending(theGraph, v); v--)
+    {
+          RetVal = OK;
+
+          // Walkup calls establish Pertinence in Step v
+          // Do the Walkup for each cycle edge from v to a DFS descendant W.
+          e = gp_GetVertexFwdArcList(theGraph, v);
+          while (gp_IsArc(e))
+          {
+        	  EMBED_HOOK_WALKUP(theGraph, v, e);
+
+              e = gp_GetNextArc(theGraph, e);
+              if (e == gp_GetVertexFwdArcList(theGraph, v))
+                  e = NIL;
+          }
+          gp_SetVertexPertinentRootsList(theGraph, v, NIL);
+
+          // Work systematically through the DFS children of vertex v, using Walkdown
+          // to add the back edges from v to its descendants in each of the DFS subtrees
+          c = gp_GetVertexSortedDFSChildList(theGraph, v);
+          while (gp_IsVertex(c))
+          {
+        	  if (gp_IsVertex(gp_GetVertexPertinentRootsList(theGraph, c)))
+        	  {
+        		  gp_Trace2(theGraph, TRACE_WALKDOWN_BEGIN, v, gp_GetRootFromDFSChild(theGraph, c));
+        		  RetVal = EMBED_HOOK_WALKDOWN(theGraph, v, gp_GetRootFromDFSChild(theGraph, c));
+        		  gp_Trace1(theGraph, TRACE_WALKDOWN_END, RetVal);
+        		  // If Walkdown returns OK, then it is OK to proceed with edge addition.
+        		  // Otherwise, if Walkdown returns NONEMBEDDABLE then we stop edge addition.
+				  if (RetVal != OK)
+					  break;
+        	  }
+        	  c = gp_GetVertexNextDFSChild(theGraph, v, c);
+          }
+
+          // If the Walkdown determined that the graph is NONEMBEDDABLE,
+          // then the guiding embedder loop can be stopped now.
+          if (RetVal != OK)
+        	  break;
+    }
+
+#ifdef PROFILE
+platform_GetCounters(&endCounters);
+platform_GetTime(end);
+printf("Walkup and Walkdown in %.3lf seconds.\n", platform_GetDuration(start,end));
+platform_PrintCounters("Walkup and Walkdown", &startCounters, &endCounters, theGraph->M);
+platform_GetTime(start);
+platform_GetCounters(&startCounters);
+#endif
+
+    // Postprocessing to orient the embedding and merge any remaining separated bicomps.
+    // Some extension algorithms may overload this function, e.g. to do nothing if they
+    // have no need of an embedding.
+    RetVal = EMBED_HOOK_EMBEDPOSTPROCESS(theGraph, v, RetVal);
+
+#ifdef PROFILE
+platform_GetCounters(&endCounters);
+platform_GetTime(end);
+printf("Embedding postprocess in %.3lf seconds.\n", platform_GetDuration(start,end));
+platform_PrintCounters("Embedding postprocess", &startCounters, &endCounters, theGraph->M);
+#endif
+
+    return RetVal;
+}
+
+#ifdef EMBED_TEMPLATE_MERGEBICOMPS
+/********************************************************************
+ _MergeBicomps()
+
+ Merges all biconnected components at the cut vertices indicated by
+ entries on the stack.
+
+ theGraph contains the stack of bicomp roots and cut vertices to merge
+
+ v, RootVertex, W and WPrevLink are not used in this routine, but are
+          used by overload extensions
+
+ Returns OK, but an extension function may return a value other than
+         OK in order to cause Walkdown to terminate immediately.
+********************************************************************/
+
+
+EMBED_TEMPLATE_STORAGE int EMBED_TEMPLATE_MERGEBICOMPS(graphP theGraph, int v, int RootVertex, int W, int WPrevLink)
+{
+int  R, Rout, Z, ZPrevLink, e, extFaceVertex;
+
+     (void) v;
+     (void) RootVertex;
+     (void) W;
+     (void) WPrevLink;
+
+     while (sp_NonEmpty(theGraph->theStack))
+     {
+         sp_Pop2(theGraph->theStack, R, Rout);
+         sp_Pop2(theGraph->theStack, Z, ZPrevLink);
+
+         /* The external faces of the bicomps containing R and Z will
+            form two corners at Z.  One corner will become part of the
+            internal face formed by adding the new back edge. The other
+            corner will be the new external face corner at Z.
+            We first want to update the links at Z to reflect this. */
+
+         extFaceVertex = gp_GetExtFaceVertex(theGraph, R, 1^Rout);
+         gp_SetExtFaceVertex(theGraph, Z, ZPrevLink, extFaceVertex);
+
+         if (gp_GetExtFaceVertex(theGraph, extFaceVertex, 0) == gp_GetExtFaceVertex(theGraph, extFaceVertex, 1))
+        	 // When (R, extFaceVertex) form a singleton bicomp, they have the same orientation, so the Rout link in extFaceVertex
+        	 // is the one that has to now point back to Z
+        	 gp_SetExtFaceVertex(theGraph, extFaceVertex, Rout, Z);
+         else
+        	 // When R and extFaceVertex are not alone in the bicomp, then they may not have the same orientation, so the
+        	 // ext face link that should point to Z is whichever one pointed to R, since R is a root copy of Z.
+             gp_SetExtFaceVertex(theGraph, extFaceVertex, gp_GetExtFaceVertex(theGraph, extFaceVertex, 0) == R ? 0 : 1, Z);
+
+         /* If the path used to enter Z is opposed to the path
+            used to exit R, then we have to flip the bicomp
+            rooted at R, which we signify by inverting R
+            then setting the sign on its DFS child edge to
+            indicate that its descendants must be flipped later */
+
+         if (ZPrevLink == Rout)
+         {
+             Rout = 1^ZPrevLink;
+
+             if (gp_GetFirstArc(theGraph, R) != gp_GetLastArc(theGraph, R))
+                _InvertVertex(theGraph, R);
+
+             e = gp_GetFirstArc(theGraph, R);
+             while (gp_IsArc(e))
+             {
+                 if (gp_GetEdgeType(theGraph, e) == EDGE_TYPE_CHILD)
+                 {
+                	 // The core planarity algorithm could simply "set" the inverted flag
+                	 // because a bicomp root edge cannot be already inverted in the core
+                	 // planarity algorithm at the time of this merge.
+                	 // However, extensions may perform edge reductions on tree edges, resulting
+                	 // in an inversion sign being promoted to the root edge of a bicomp before
+                	 // it gets merged.  So, xor is used to reverse the inversion flag on the
+                	 // root edge if the bicomp root must be inverted before it is merged.
+                	 gp_XorEdgeFlagInverted(theGraph, e);
+                     break;
+                 }
+
+                 e = gp_GetNextArc(theGraph, e);
+             }
+         }
+
+         // R is no longer pertinent to Z since we are about to merge R into Z, so we delete R
+         // from Z's pertinent bicomp list (Walkdown gets R from the head of the list).
+         gp_DeleteVertexPertinentRoot(theGraph, Z, R);
+
+         // If the merge will place the current future pertinence child into the same bicomp as Z,
+         // then we advance to the next child (or NIL) because future pertinence is
+         if (gp_GetDFSChildFromRoot(theGraph, R) == gp_GetVertexFuturePertinentChild(theGraph, Z))
+         {
+        	 gp_SetVertexFuturePertinentChild(theGraph, Z,
+        			 gp_GetVertexNextDFSChild(theGraph, Z, gp_GetVertexFuturePertinentChild(theGraph, Z)));
+         }
+
+         // Now we push R into Z, eliminating R
+         EMBED_HOOK_MERGEVERTEX(theGraph, Z, ZPrevLink, R);
+     }
+
+     return OK;
+}
+#endif
+
+/********************************************************************
+ _WalkDown()
+ Consider a circular shape with small circles and squares along its perimeter.
+ The small circle at the top is the root vertex of the bicomp.  The other small
+ circles represent active vertices, and the squares represent future pertinent
+ vertices.  The root vertex is a root copy of v, the vertex currently being processed.
+
+ The Walkup previously marked all vertices adjacent to v by setting their
+ pertinentEdge members with the forward arcs of the back edges to embed.
+ Two Walkdown traversals are performed to visit all reachable vertices
+ along each of the external face paths emanating from RootVertex (a root
+ copy of vertex v) to embed back edges to descendants of vertex v that
+ have their pertinentEdge members marked.
+
+ During each Walkdown traversal, it is sometimes necessary to hop from a
+ vertex to one of its child biconnected components in order to reach the
+ desired vertices.  In such cases, the biconnected components are merged
+ such that adding the back edge forms a new proper face in the biconnected
+ component rooted at RootVertex (which, again, is a root copy of v).
+
+ The outer loop performs both walks, unless the first walk got all the way
+ around to RootVertex (only happens when bicomp contains no external activity,
+ such as when processing the last vertex), or when non-planarity is
+ discovered (in a pertinent child bicomp such that the stack is non-empty).
+
+ For the inner loop, each iteration visits a vertex W.  If W is marked as
+ requiring a back edge, then MergeBicomps is called to merge the biconnected
+ components whose cut vertices have been collecting in merge stack.  Then,
+ the back edge (RootVertex, W) is added, and the pertinentEdge of W is cleared.
+
+ Next, we check whether W has a pertinent child bicomp.  If so, then we figure
+ out which path down from the root of the child bicomp leads to the next vertex
+ to be visited, and we push onto the stack information on the cut vertex and
+ the paths used to enter into it and exit from it.  Alternately, if W
+ had no pertinent child bicomps, then we check to see if it is inactive.
+ If so, we find the next vertex along the external face, then short-circuit
+ its inactive predecessor (under certain conditions).  Finally, if W is not
+ inactive, but it has no pertinent child bicomps, then we already know its
+ adjacentTo flag is clear so both criteria for internal activity also fail.
+ Therefore, W must be a stopping vertex.
+
+ A stopping vertex X is a future pertinent vertex that has no pertinent
+ child bicomps and no unembedded back edge to the current vertex v.
+ The inner loop of Walkdown stops walking when it reaches a stopping vertex X
+ because if it were to proceed beyond X and embed a back edge, then X would be
+ surrounded by the bounding cycle of the bicomp.  This would clearly be
+ incorrect because X has a path leading from it to an ancestor of v, which
+ would have to cross the bounding cycle.
+
+ Either Walkdown traversal can halt the Walkdown and return if a pertinent
+ child biconnected component to which the traversal has descended is blocked,
+ i.e. has stopping vertices on both paths emanating from the root.  This
+ indicates an obstruction to embedding. In core planarity it is evidence of
+ a K_{3,3}, but some extension algorithms are able to clear the blockage and
+ proceed with embedding.
+
+ If both Walkdown traversals successfully completed, then the outer loop
+ ends.  Post-processing code tests whether the Walkdown embedded all the
+ back edges from v to its descendants in the subtree rooted by c, a DFS
+ child of v uniquely associated with the RootVertex.  If not, then embedding
+ was obstructed.  In core planarity it is evidence of a K_{3,3} or K_5, but some
+ extension algorithms are able to clear the blockage and proceed with embedding.
+
+  Returns OK if all possible edges were embedded,
+  	  	  NONEMBEDDABLE if less than all possible edges were embedded,
+  	  	  NOTOK for an internal code failure
+ ********************************************************************/
+
+
+EMBED_TEMPLATE_STORAGE int EMBED_TEMPLATE_WALKDOWN(graphP theGraph, int v, int RootVertex)
+{
+int  RetVal, W, WPrevLink, R, X, XPrevLink, Y, YPrevLink, RootSide, e;
+int  RootEdgeChild = gp_GetDFSChildFromRoot(theGraph, RootVertex);
+
+     sp_ClearStack(theGraph->theStack);
+
+     for (RootSide = 0; RootSide < 2; RootSide++)
+     {
+         W = gp_GetExtFaceVertex(theGraph, RootVertex, RootSide);
+
+         // Determine the link used to enter W based on which side points back to RootVertex
+         // Implicitly handled special case: In core planarity, the first Walkdown traversal
+         // Will be on a singleton edge.  In this case, RootVertex and W are *consistently*
+         // oriented, and the RootSide is 0, so WPrevLink should be 1. This calculation is
+         // written to implicitly produce that result.
+         WPrevLink = gp_GetExtFaceVertex(theGraph, W, 1) == RootVertex ? 1 : 0;
+
+         while (W != RootVertex)
+         {
+             // Detect unembedded back edge descendant endpoint W
+             if (gp_IsArc(gp_GetVertexPertinentEdge(theGraph, W)))
+             {
+                // Merge any bicomps whose cut vertices were traversed to reach W, then add the
+            	// edge to W to form a new proper face in the embedding.
+                if (sp_NonEmpty(theGraph->theStack))
+                {
+                    if ((RetVal = EMBED_HOOK_MERGEBICOMPS(theGraph, v, RootVertex, W, WPrevLink)) != OK)
+                        return RetVal;
+                }
+                EMBED_HOOK_EMBEDBACKEDGETODESCENDANT(theGraph, RootSide, RootVertex, W, WPrevLink);
+
+                // Clear W's pertinentEdge since the forward arc it contained has been embedded
+                gp_SetVertexPertinentEdge(theGraph, W, NIL);
+             }
+
+             // If W has a pertinent child bicomp, then we descend to the first one...
+             if (gp_IsVertex(gp_GetVertexPertinentRootsList(theGraph, W)))
+             {
+            	 // Push the vertex W and the direction of entry, then descend to a root copy R of W
+                 sp_Push2(theGraph->theStack, W, WPrevLink);
+                 R = gp_GetVertexFirstPertinentRoot(theGraph, W);
+
+                 // Get the next active vertices X and Y on the external face paths emanating from R
+                 X = gp_GetExtFaceVertex(theGraph, R, 0);
+                 XPrevLink = gp_GetExtFaceVertex(theGraph, X, 1)==R ? 1 : 0;
+                 Y = gp_GetExtFaceVertex(theGraph, R, 1);
+                 YPrevLink = gp_GetExtFaceVertex(theGraph, Y, 0)==R ? 0 : 1;
+
+                 // Now we implement the Walkdown's simple path selection rules!
+                 // Select a direction from the root to a pertinent vertex,
+                 // preferentially toward a vertex that is not future pertinent
+                 gp_UpdateVertexFuturePertinentChild(theGraph, X, v);
+                 gp_UpdateVertexFuturePertinentChild(theGraph, Y, v);
+                 if (PERTINENT(theGraph, X) && NOTFUTUREPERTINENT(theGraph, X, v))
+				 {
+					 W = X;
+					 WPrevLink = XPrevLink;
+					 sp_Push2(theGraph->theStack, R, 0);
+				 }
+                 else if (PERTINENT(theGraph, Y) && NOTFUTUREPERTINENT(theGraph, Y, v))
+            	 {
+                     W = Y;
+                     WPrevLink = YPrevLink;
+                     sp_Push2(theGraph->theStack, R, 1);
+            	 }
+                 else if (PERTINENT(theGraph, X))
+				 {
+					 W = X;
+					 WPrevLink = XPrevLink;
+					 sp_Push2(theGraph->theStack, R, 0);
+				 }
+                 else if (PERTINENT(theGraph, Y))
+            	 {
+                     W = Y;
+                     WPrevLink = YPrevLink;
+                     sp_Push2(theGraph->theStack, R, 1);
+            	 }
+                 else
+                 {
+                	 // Both the X and Y sides of the descendant bicomp are blocked.
+                	 // Let the application decide whether it can unblock the bicomp.
+                	 // The core planarity/outerplanarity embedder simply isolates a
+                	 // planarity/outerplanary obstruction and returns NONEMBEDDABLE
+                     gp_Trace3(theGraph, TRACE_BLOCKEDBICOMP, v, RootVertex, R);
+                     if ((RetVal = EMBED_HOOK_HANDLEBLOCKEDBICOMP(theGraph, v, RootVertex, R)) != OK)
+                         return RetVal;
+
+                     // If an extension algorithm cleared the blockage, then we pop W and WPrevLink
+                     // back off the stack and let the Walkdown traversal try descending again
+                     sp_Pop2(theGraph->theStack, W, WPrevLink);
+                 }
+             }
+             else
+             {
+                 // The vertex W is known to be non-pertinent, so if it is future pertinent
+                 // (or if the algorithm is based on outerplanarity), then the vertex is
+                 // a stopping vertex for the Walkdown traversal.
+            	 gp_UpdateVertexFuturePertinentChild(theGraph, W, v);
+                 if (FUTUREPERTINENT(theGraph, W, v) || EMBED_TEMPLATE_OUTERPLANAR(theGraph))
+                 {
+                	 // Create an external face short-circuit between RootVertex and the stopping vertex W
+                	 // so that future steps do not walk down a long path of inactive vertices between them.
+                	 // As a special case, we ensure that the external face is not reduced to just two
+                	 // vertices, W and RootVertex, because it would then become a challenge to determine
+                	 // whether W has the same orientation as RootVertex.
+                	 // So, if the other side of RootVertex is already attached to W, then we simply push
+                	 // W back one vertex so that the external face will have at least three vertices.
+                	 if (gp_GetExtFaceVertex(theGraph, RootVertex, 1^RootSide) == W)
+                	 {
+                	     X = W;
+                	     W = gp_GetExtFaceVertex(theGraph, W, WPrevLink);
+                	     WPrevLink = gp_GetExtFaceVertex(theGraph, W, 0) == X ? 1 : 0;
+                	 }
+                     gp_SetExtFaceVertex(theGraph, RootVertex, RootSide, W);
+                     gp_SetExtFaceVertex(theGraph, W, WPrevLink, RootVertex);
+
+                     // Terminate the Walkdown traversal since it encountered the stopping vertex
+                     break;
+                 }
+
+                 // If the vertex is neither pertinent nor future pertinent, then it is inactive.
+            	 // The default handler planarity handler simply skips inactive vertices by traversing
+                 // to the next vertex on the external face.
+                 // Once upon a time, false edges called short-circuit edges were added to eliminate
+                 // inactive vertices, but the extFace links above achieve the same result with less work.
+                 else
+                 {
+                     if (EMBED_HOOK_HANDLEINACTIVEVERTEX(theGraph, RootVertex, &W, &WPrevLink) != OK)
+                         return NOTOK;
+                 }
+             }
+         }
+     }
+
+     // Detect and handle the case in which Walkdown was blocked from embedding all the back edges from v
+     // to descendants in the subtree of the child of v associated with the bicomp RootVertex.
+	 if (gp_IsArc(e = gp_GetVertexFwdArcList(theGraph, v)) && RootEdgeChild < gp_GetNeighbor(theGraph, e))
+	 {
+	     int nextChild = gp_GetVertexNextDFSChild(theGraph, v, RootEdgeChild);
+
+	     // The Walkdown was blocked from embedding all forward arcs into the RootEdgeChild subtree
+	     // if there the next child's DFI is greater than the descendant endpoint of the next forward arc,
+	     // or if there is no next child.
+	     if (gp_IsNotVertex(nextChild) || nextChild > gp_GetNeighbor(theGraph, e))
+	     {
+	    	 // If an extension indicates it is OK to proceed despite the unembedded forward arcs, then
+	    	 // advance to the forward arcs for the next child, if any
+	    	 gp_Trace3(theGraph, TRACE_BLOCKEDBICOMP, v, RootVertex, RootVertex);
+	    	 if ((RetVal = EMBED_HOOK_HANDLEBLOCKEDBICOMP(theGraph, v, RootVertex, RootVertex)) == OK)
+	    		 _AdvanceFwdArcList(theGraph, v, RootEdgeChild, nextChild);
+
+	    	 return RetVal;
+	     }
+	 }
+
+     return OK;
+}
+
+#undef EMBED_TEMPLATE_STORAGE
+#undef EMBED_TEMPLATE_EMBED
+#undef EMBED_TEMPLATE_WALKDOWN
+#undef EMBED_TEMPLATE_MERGEBICOMPS
+#undef EMBED_TEMPLATE_OUTERPLANAR
+
+#undef EMBED_HOOK_EMBEDDINGINITIALIZE
+#undef EMBED_HOOK_WALKUP
+#undef EMBED_HOOK_WALKDOWN
+#undef EMBED_HOOK_MERGEBICOMPS
+#undef EMBED_HOOK_MERGEVERTEX
+#undef EMBED_HOOK_EMBEDBACKEDGETODESCENDANT
+#undef EMBED_HOOK_HANDLEBLOCKEDBICOMP
+#undef EMBED_HOOK_HANDLEINACTIVEVERTEX
+#undef EMBED_HOOK_EMBEDPOSTPROCESS
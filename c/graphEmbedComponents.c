@@ -0,0 +1,1507 @@
+/*
+Planarity-Related Graph Algorithms Project
+Copyright (c) 1997-2012, John M. Boyer
+All rights reserved. Includes a reference implementation of the following:
+
+* John M. Boyer. "Subgraph Homeomorphism via the Edge Addition Planarity Algorithm".
+  Journal of Graph Algorithms and Applications, Vol. 16, no. 2, pp. 381-410, 2012.
+  http://www.jgaa.info/16/268.html
+
+* John M. Boyer. "A New Method for Efficiently Generating Planar Graph
+  Visibility Representations". In P. Eades and P. Healy, editors,
+  Proceedings of the 13th International Conference on Graph Drawing 2005,
+  Lecture Notes Comput. Sci., Volume 3843, pp. 508-511, Springer-Verlag, 2006.
+
+* John M. Boyer and Wendy J. Myrvold. "On the Cutting Edge: Simplified O(n)
+  Planarity by Edge Addition". Journal of Graph Algorithms and Applications,
+  Vol. 8, No. 3, pp. 241-273, 2004.
+  http://www.jgaa.info/08/91.html
+
+* John M. Boyer. "Simplified O(n) Algorithms for Planar Graph Embedding,
+  Kuratowski Subgraph Isolation, and Related Problems". Ph.D. Dissertation,
+  University of Victoria, 2001.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+* Redistributions of source code must retain the above copyright notice, this
+  list of conditions and the following disclaimer.
+
+* Redistributions in binary form must reproduce the above copyright notice, this
+  list of conditions and the following disclaimer in the documentation and/or
+  other materials provided with the distribution.
+
+* Neither the name of the Planarity-Related Graph Algorithms Project nor the names
+  of its contributors may be used to endorse or promote products derived from this
+  software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "graph.h"
+
+#ifdef WIN32
+#include <windows.h>
+#else
+#include <pthread.h>
+#include <unistd.h>
+#endif
+
+/* Imported functions */
+
+extern void _ClearVertexVisitedFlags(graphP theGraph, int);
+extern void _InitVertexRec(graphP theGraph, int v);
+extern void _InitVertexInfo(graphP theGraph, int v);
+extern void _InitEdgeRec(graphP theGraph, int e);
+extern void _ReleasePreprocessCache(graphP theGraph);
+
+/* Private definitions */
+
+/* A component bin is a subgraph formed by the disjoint union of one or
+   more connected components of the input graph, or of one or more of its
+   biconnected components in the case of gp_EmbedBlocks().  Each bin is
+   embedded by gp_Embed() in its own thread. The subToGlobal array maps
+   each bin vertex to the input graph vertex from which it was copied.
+
+   The remaining members are used only by gp_EmbedBlocks(), whose threads
+   also build the bins and merge them back into the input graph: b is the
+   bin number, split is the state shared by all bins, rootBlockOf gives the
+   block of which each bin vertex is the root copy, or -1 if it is not one,
+   and isTreeEdge marks the bin edges that are DFS tree edges of the input
+   graph. */
+
+struct blockSplit;
+
+typedef struct
+{
+	graphP subgraph;
+	int *subToGlobal;
+	int embedFlags, result;
+
+	int b;
+	struct blockSplit *split;
+	int *rootBlockOf;
+	char *isTreeEdge;
+} componentBinRec;
+
+typedef componentBinRec * componentBinRecP;
+
+/* The state of gp_EmbedBlocks() shared by the bins.  The arrays from dfi
+   to blockArcs are filled before the threads start and only read by them.
+   A vertex belongs to one block as a non-root, namely the block of the
+   tree edge from its parent, so its one non-root copy, globalToSub[v], is
+   written only by the bin of that block.  Each other block containing the
+   vertex has it as its root, whose copy is rootSub[c] for block c, and
+   the rotation of that copy is left in rootFirst[c] and rootLast[c] for
+   the calling thread to concatenate, since several bins may share it. */
+
+typedef struct blockSplit
+{
+	graphP theGraph;
+	int numBins, numBlocks, obstructionBin, edgeIndexBound;
+	int *dfi, *parent, *parentArc, *lowpoint, *leastAncestor;
+	int *blockOf, *blockBin, *blockStart, *blockArcs;
+	int *binN, *binM, *binEdgeStart;
+	int *globalToSub, *rootSub, *blockRoot, *rootFirst, *rootLast;
+} blockSplitRec;
+
+typedef blockSplitRec * blockSplitP;
+
+/* If gp_EmbedBlocks() chooses the number of threads, then it splits the
+   graph only if no bin has more than 1/EMBEDBLOCKS_SPLITFACTOR of the
+   edges, since the largest bin bounds the wall time of the threads. */
+
+#define EMBEDBLOCKS_SPLITFACTOR 4
+
+#ifdef WIN32
+typedef LPTHREAD_START_ROUTINE binThreadProc;
+#else
+typedef void *(*binThreadProc)(void *);
+#endif
+
+typedef struct
+{
+	int component, load;
+} componentLoadRec;
+
+/* Private functions */
+
+int  _GetDefaultNumThreads(void);
+int  _LabelConnectedComponents(graphP theGraph, int *compOf, int *compSize, int *compEdges);
+int  _CompareComponentLoads(const void *a, const void *b);
+int  _AssignComponentsToBins(int numComponents, int *compSize, int *compEdges,
+                             int *compBin, int *binN, int *binM, int numBins);
+int  _CreateComponentBin(graphP theGraph, componentBinRecP bin, int b, int N, int M,
+                         int embedFlags, int *compOf, int *compBin, int *globalToSub);
+void _EmbedComponentBins(componentBinRecP bins, int numBins);
+void _RunComponentBinThreads(componentBinRecP bins, int numBins, binThreadProc threadProc);
+int  _JoinComponentBins(graphP theGraph, componentBinRecP bins, int numBins,
+                        int *compOf, int *compStart, int *subRoot);
+int  _JoinComponentBin(graphP theGraph, componentBinRecP bin, int includeEdges,
+                       int *compOf, int *compStart, int *subRoot);
+
+int  _LabelBlocks(graphP theGraph, int *dfi, int *parent, int *lowpoint, int *leastAncestor,
+                  int *parentArc, int *blockOf, int *blockSize, int *blockEdges);
+void _InitBlockVertices(componentBinRecP bin);
+int  _CreateBlockBin(componentBinRecP bin);
+int  _GetBlockVertexCopy(componentBinRecP bin, int c, int v, int *pSubv);
+int  _JoinBlockBins(blockSplitP split, componentBinRecP bins);
+void _InitBlockEdges(componentBinRecP bin);
+int  _JoinBlockBin(componentBinRecP bin);
+void _FreeBlockBin(componentBinRecP bin);
+
+#ifdef WIN32
+DWORD WINAPI _CreateBlockBinThread(LPVOID param);
+DWORD WINAPI _JoinBlockBinThread(LPVOID param);
+#else
+void *_CreateBlockBinThread(void *param);
+void *_JoinBlockBinThread(void *param);
+#endif
+
+/********************************************************************
+ gp_EmbedComponents()
+
+ Performs the same operation as gp_Embed(), except that a disconnected
+ input graph is first split into its connected components, which are
+ then embedded concurrently, up to numThreads at a time.  If numThreads
+ is zero or less, then the number of online processors is used.
+
+ The components are distributed among numThreads subgraphs (bins) by
+ a greedy largest-first assignment, so the wall time approaches that
+ of embedding the largest component.  Once the bins are embedded, their
+ rotation systems are copied back into theGraph and renumbered so that
+ theGraph meets the documented post-condition of gp_Embed(): vertices
+ are sorted by DFI, with each DFS tree occupying a contiguous range of
+ DFIs in the order of the least original vertex of each component.
+
+ If any component is not embeddable, then the obstruction isolated in
+ one of the bins is the result, and all other edges are removed.
+
+ Extension algorithms may overload the embedder in ways that depend on
+ the whole graph, so gp_Embed() is called directly if theGraph has any
+ extensions attached, if the embedFlags are other than the core planar
+ or outerplanar settings, if theGraph is already DFS numbered, or if
+ there are fewer than two components containing edges.
+
+ Returns the same values as gp_Embed().
+ ********************************************************************/
+
+int  gp_EmbedComponents(graphP theGraph, int embedFlags, int numThreads)
+{
+int  *compOf=NULL, *compSize=NULL, *compEdges=NULL, *compBin=NULL, *compStart=NULL;
+int  *subRoot=NULL, *globalToSub=NULL, *binN=NULL, *binM=NULL;
+componentBinRecP bins = NULL;
+int  numComponents, numNontrivial, numBins, c, b, v, RetVal = OK;
+
+#ifdef PROFILE
+platform_time start, end;
+platform_GetTime(start);
+#endif
+
+	if (theGraph == NULL)
+		return NOTOK;
+
+	if (theGraph->extensions != NULL ||
+	    (embedFlags != EMBEDFLAGS_PLANAR && embedFlags != EMBEDFLAGS_OUTERPLANAR) ||
+	    (theGraph->internalFlags & FLAGS_DFSNUMBERED))
+		return gp_Embed(theGraph, embedFlags);
+
+	if (numThreads <= 0)
+		numThreads = _GetDefaultNumThreads();
+
+	if (numThreads < 2)
+		return gp_Embed(theGraph, embedFlags);
+
+	gp_Trace2(theGraph, TRACE_EMBEDCOMPONENTS_BEGIN, embedFlags, numThreads);
+
+	// There are at most N components, so all per-component arrays
+	// are indexed from zero and sized by the vertex index bound
+	v = gp_PrimaryVertexIndexBound(theGraph);
+	if ((compOf = (int *) malloc(v * sizeof(int))) == NULL ||
+	    (compSize = (int *) calloc(v, sizeof(int))) == NULL ||
+	    (compEdges = (int *) calloc(v, sizeof(int))) == NULL ||
+	    (compBin = (int *) malloc(v * sizeof(int))) == NULL ||
+	    (compStart = (int *) malloc(v * sizeof(int))) == NULL ||
+	    (subRoot = (int *) malloc(v * sizeof(int))) == NULL ||
+	    (globalToSub = (int *) malloc(v * sizeof(int))) == NULL)
+		RetVal = NOTOK;
+
+	// Find the connected components and decide whether the split is worthwhile
+	numComponents = numNontrivial = 0;
+	if (RetVal == OK)
+	{
+		numComponents = _LabelConnectedComponents(theGraph, compOf, compSize, compEdges);
+		for (c = 0; c < numComponents; c++)
+			if (compEdges[c] > 0)
+				numNontrivial++;
+	}
+
+	if (RetVal == OK && numNontrivial < 2)
+	{
+		free(compOf); free(compSize); free(compEdges); free(compBin);
+		free(compStart); free(subRoot); free(globalToSub);
+		return gp_Embed(theGraph, embedFlags);
+	}
+
+	// Each component will receive the DFIs that the outer loop of the
+	// DFS in gp_Embed() would give it, i.e. components are numbered in
+	// order of their least vertex, so they receive consecutive DFI ranges
+	if (RetVal == OK)
+	{
+		compStart[0] = gp_GetFirstVertex(theGraph);
+		for (c = 1; c < numComponents; c++)
+			compStart[c] = compStart[c-1] + compSize[c-1];
+	}
+
+	// Distribute the components among the bins
+	numBins = numThreads < numNontrivial ? numThreads : numNontrivial;
+	if (RetVal == OK)
+	{
+		if ((bins = (componentBinRecP) calloc(numBins, sizeof(componentBinRec))) == NULL ||
+		    (binN = (int *) calloc(numBins, sizeof(int))) == NULL ||
+		    (binM = (int *) calloc(numBins, sizeof(int))) == NULL ||
+		    _AssignComponentsToBins(numComponents, compSize, compEdges,
+		                            compBin, binN, binM, numBins) != OK)
+			RetVal = NOTOK;
+	}
+
+	// Copy each bin's components into a separate graph
+	for (b = 0; b < numBins && RetVal == OK; b++)
+		RetVal = _CreateComponentBin(theGraph, bins+b, b, binN[b], binM[b],
+		                             embedFlags, compOf, compBin, globalToSub);
+
+	// Embed the bins concurrently, then copy the results back into theGraph
+	if (RetVal == OK)
+	{
+		_EmbedComponentBins(bins, numBins);
+		RetVal = _JoinComponentBins(theGraph, bins, numBins, compOf, compStart, subRoot);
+	}
+
+	// Release the bins and the working arrays
+	if (bins != NULL)
+	{
+		for (b = 0; b < numBins; b++)
+		{
+			gp_Free(&bins[b].subgraph);
+			if (bins[b].subToGlobal != NULL)
+				free(bins[b].subToGlobal);
+		}
+		free(bins);
+	}
+
+	if (compOf != NULL) free(compOf);
+	if (compSize != NULL) free(compSize);
+	if (compEdges != NULL) free(compEdges);
+	if (compBin != NULL) free(compBin);
+	if (compStart != NULL) free(compStart);
+	if (subRoot != NULL) free(subRoot);
+	if (globalToSub != NULL) free(globalToSub);
+	if (binN != NULL) free(binN);
+	if (binM != NULL) free(binM);
+
+	gp_Trace1(theGraph, TRACE_EMBEDCOMPONENTS_END, RetVal);
+
+#ifdef PROFILE
+platform_GetTime(end);
+printf("EmbedComponents in %.3lf seconds.\n", platform_GetDuration(start,end));
+#endif
+
+	return RetVal;
+}
+
+/********************************************************************
+ _GetDefaultNumThreads()
+ Returns the number of online processors, or 1 if it cannot be found.
+ ********************************************************************/
+
+int  _GetDefaultNumThreads(void)
+{
+#ifdef WIN32
+SYSTEM_INFO sysInfo;
+
+	GetSystemInfo(&sysInfo);
+	return sysInfo.dwNumberOfProcessors > 0 ? (int) sysInfo.dwNumberOfProcessors : 1;
+#else
+long numProcessors = sysconf(_SC_NPROCESSORS_ONLN);
+
+	return numProcessors > 0 ? (int) numProcessors : 1;
+#endif
+}
+
+/********************************************************************
+ _LabelConnectedComponents()
+
+ Numbers the connected components of theGraph in order of their least
+ vertex. On return, compOf[v] is the component containing vertex v,
+ and compSize[c] and compEdges[c] are the number of vertices and edges
+ in component c (the two count arrays must be zero-filled on entry).
+
+ Uses the graph's stack and the vertex visited flags.
+ Returns the number of connected components.
+ ********************************************************************/
+
+int  _LabelConnectedComponents(graphP theGraph, int *compOf, int *compSize, int *compEdges)
+{
+stackP theStack = theGraph->theStack;
+int  numComponents = 0, v, u, w, e;
+
+	sp_ClearStack(theStack);
+	_ClearVertexVisitedFlags(theGraph, FALSE);
+
+	for (v = gp_GetFirstVertex(theGraph); gp_VertexInRange(theGraph, v); v++)
+	{
+		if (gp_GetVertexVisited(theGraph, v))
+			continue;
+
+		gp_SetVertexVisited(theGraph, v);
+		sp_Push(theStack, v);
+		while (sp_NonEmpty(theStack))
+		{
+			sp_Pop(theStack, u);
+			compOf[u] = numComponents;
+			compSize[numComponents]++;
+
+			e = gp_GetFirstArc(theGraph, u);
+			while (gp_IsArc(e))
+			{
+				compEdges[numComponents]++;
+				w = gp_GetNeighbor(theGraph, e);
+				if (!gp_GetVertexVisited(theGraph, w))
+				{
+					gp_SetVertexVisited(theGraph, w);
+					sp_Push(theStack, w);
+				}
+				e = gp_GetNextArc(theGraph, e);
+			}
+		}
+
+		// Each edge was counted once from each endpoint
+		compEdges[numComponents] /= 2;
+		numComponents++;
+	}
+
+	return numComponents;
+}
+
+/********************************************************************
+ _AssignComponentsToBins()
+
+ Assigns each component to the bin with the least total load so far,
+ taking the components in descending order of load (vertices plus
+ edges).  Ties are broken by component number, so the assignment does
+ not depend on the qsort() implementation.
+
+ On return, compBin[c] is the bin for component c, and binN[b] and
+ binM[b] are the number of vertices and edges in bin b.
+ Returns OK on success, NOTOK on memory allocation failure.
+ ********************************************************************/
+
+int  _AssignComponentsToBins(int numComponents, int *compSize, int *compEdges,
+                             int *compBin, int *binN, int *binM, int numBins)
+{
+componentLoadRec *loads;
+int  *binLoad;
+int  i, b, c, minBin;
+
+	loads = (componentLoadRec *) malloc(numComponents * sizeof(componentLoadRec));
+	binLoad = (int *) calloc(numBins, sizeof(int));
+	if (loads == NULL || binLoad == NULL)
+	{
+		if (loads != NULL) free(loads);
+		if (binLoad != NULL) free(binLoad);
+		return NOTOK;
+	}
+
+	for (c = 0; c < numComponents; c++)
+	{
+		loads[c].component = c;
+		loads[c].load = compSize[c] + compEdges[c];
+	}
+
+	qsort(loads, numComponents, sizeof(componentLoadRec), _CompareComponentLoads);
+
+	for (i = 0; i < numComponents; i++)
+	{
+		for (minBin = 0, b = 1; b < numBins; b++)
+			if (binLoad[b] < binLoad[minBin])
+				minBin = b;
+
+		c = loads[i].component;
+		compBin[c] = minBin;
+		binLoad[minBin] += loads[i].load;
+		binN[minBin] += compSize[c];
+		binM[minBin] += compEdges[c];
+	}
+
+	free(loads);
+	free(binLoad);
+	return OK;
+}
+
+int  _CompareComponentLoads(const void *a, const void *b)
+{
+const componentLoadRec *x = (const componentLoadRec *) a;
+const componentLoadRec *y = (const componentLoadRec *) b;
+
+	if (x->load != y->load)
+		return x->load > y->load ? -1 : 1;
+
+	return x->component - y->component;
+}
+
+/********************************************************************
+ _CreateComponentBin()
+
+ Creates the subgraph for bin b, containing N vertices and M edges.
+ The vertices of the bin are numbered in ascending order of their
+ numbers in theGraph, so the least vertex of each component is also
+ its least vertex in the bin and hence becomes its DFS tree root.
+ The globalToSub array is used as scratch space to map the vertices.
+
+ Returns OK on success, NOTOK on failure.
+ ********************************************************************/
+
+int  _CreateComponentBin(graphP theGraph, componentBinRecP bin, int b, int N, int M,
+                         int embedFlags, int *compOf, int *compBin, int *globalToSub)
+{
+graphP subgraph;
+int  v, w, e, subv;
+
+	bin->embedFlags = embedFlags;
+	bin->result = NOTOK;
+
+	if ((bin->subgraph = subgraph = gp_New()) == NULL)
+		return NOTOK;
+
+	if (M > DEFAULT_EDGE_LIMIT * N && gp_EnsureArcCapacity(subgraph, 2*M) != OK)
+		return NOTOK;
+
+	if (gp_InitGraph(subgraph, N) != OK)
+		return NOTOK;
+
+	if ((bin->subToGlobal = (int *) malloc(gp_PrimaryVertexIndexBound(subgraph) * sizeof(int))) == NULL)
+		return NOTOK;
+
+	// Number the bin's vertices
+	subv = gp_GetFirstVertex(subgraph);
+	for (v = gp_GetFirstVertex(theGraph); gp_VertexInRange(theGraph, v); v++)
+	{
+		if (compBin[compOf[v]] == b)
+		{
+			gp_SetVertexIndex(subgraph, subv, subv);
+			bin->subToGlobal[subv] = v;
+			globalToSub[v] = subv++;
+		}
+	}
+
+	// Copy the edges of the bin's vertices, once per edge
+	for (v = gp_GetFirstVertex(theGraph); gp_VertexInRange(theGraph, v); v++)
+	{
+		if (compBin[compOf[v]] != b)
+			continue;
+
+		e = gp_GetFirstArc(theGraph, v);
+		while (gp_IsArc(e))
+		{
+			if (e < gp_GetTwinArc(theGraph, e))
+			{
+				w = gp_GetNeighbor(theGraph, e);
+				if (gp_AddEdge(subgraph, globalToSub[v], 0, globalToSub[w], 0) != OK)
+					return NOTOK;
+			}
+			e = gp_GetNextArc(theGraph, e);
+		}
+	}
+
+	return OK;
+}
+
+/********************************************************************
+ _EmbedComponentBinThread()
+ The thread procedure that embeds one bin.
+ ********************************************************************/
+
+#ifdef WIN32
+DWORD WINAPI _EmbedComponentBinThread(LPVOID param)
+#else
+void *_EmbedComponentBinThread(void *param)
+#endif
+{
+componentBinRecP bin = (componentBinRecP) param;
+
+	bin->result = gp_Embed(bin->subgraph, bin->embedFlags);
+	return 0;
+}
+
+/********************************************************************
+ _EmbedComponentBins()
+ Embeds the bins concurrently.
+ ********************************************************************/
+
+void _EmbedComponentBins(componentBinRecP bins, int numBins)
+{
+	_RunComponentBinThreads(bins, numBins, _EmbedComponentBinThread);
+}
+
+/********************************************************************
+ _RunComponentBinThreads()
+
+ Runs threadProc on bins 1 to numBins-1 in new threads while the calling
+ thread runs it on bin 0, then waits for all threads to finish.  If a
+ thread cannot be created, its bin is processed by the calling thread.
+ ********************************************************************/
+
+void _RunComponentBinThreads(componentBinRecP bins, int numBins, binThreadProc threadProc)
+{
+int  b;
+#ifdef WIN32
+HANDLE *threads = (HANDLE *) calloc(numBins, sizeof(HANDLE));
+#else
+pthread_t *threads = (pthread_t *) calloc(numBins, sizeof(pthread_t));
+char *started = (char *) calloc(numBins, sizeof(char));
+#endif
+
+	for (b = 1; b < numBins; b++)
+	{
+#ifdef WIN32
+		if (threads == NULL ||
+		    (threads[b] = CreateThread(NULL, 0, threadProc, bins+b, 0, NULL)) == NULL)
+			threadProc(bins+b);
+#else
+		if (threads != NULL && started != NULL &&
+		    pthread_create(threads+b, NULL, threadProc, bins+b) == 0)
+			started[b] = 1;
+		else
+			threadProc(bins+b);
+#endif
+	}
+
+	threadProc(bins);
+
+	for (b = 1; b < numBins; b++)
+	{
+#ifdef WIN32
+		if (threads != NULL && threads[b] != NULL)
+		{
+			WaitForSingleObject(threads[b], INFINITE);
+			CloseHandle(threads[b]);
+		}
+#else
+		if (started != NULL && started[b])
+			pthread_join(threads[b], NULL);
+#endif
+	}
+
+	if (threads != NULL) free(threads);
+#ifndef WIN32
+	if (started != NULL) free(started);
+#endif
+}
+
+/********************************************************************
+ _JoinComponentBins()
+
+ Replaces the content of theGraph with the embedded bins.  If all bins
+ were embedded, then all of their edges are copied into theGraph.
+ If a bin produced an obstruction, then only the edges of the first
+ such bin are kept, since any one obstruction suffices as the result.
+ The DFS tree structure of every bin is copied, so that theGraph is
+ DFS numbered and sorted by DFI, as after gp_Embed().
+
+ Returns OK, NONEMBEDDABLE or NOTOK, like gp_Embed().
+ ********************************************************************/
+
+int  _JoinComponentBins(graphP theGraph, componentBinRecP bins, int numBins,
+                        int *compOf, int *compStart, int *subRoot)
+{
+int  b, e, EsizeOccupied, obstructionBin = -1;
+
+	for (b = 0; b < numBins; b++)
+	{
+		if (bins[b].result == NONEMBEDDABLE && obstructionBin < 0)
+			obstructionBin = b;
+		else if (bins[b].result != OK && bins[b].result != NONEMBEDDABLE)
+			return NOTOK;
+	}
+
+	// Remove all edges of theGraph; the edge records of the bins replace them
+	_ReleasePreprocessCache(theGraph);
+	EsizeOccupied = gp_EdgeInUseIndexBound(theGraph);
+	for (e = gp_GetFirstEdge(theGraph); e < EsizeOccupied; e++)
+		_InitEdgeRec(theGraph, e);
+	sp_ClearStack(theGraph->edgeHoles);
+	theGraph->M = 0;
+
+	for (b = 0; b < numBins; b++)
+	{
+		if (_JoinComponentBin(theGraph, bins+b, obstructionBin < 0 || obstructionBin == b,
+		                      compOf, compStart, subRoot) != OK)
+			return NOTOK;
+	}
+
+	theGraph->internalFlags |= FLAGS_DFSNUMBERED | FLAGS_SORTEDBYDFI;
+	theGraph->embedFlags = bins[0].embedFlags;
+
+	return obstructionBin < 0 ? OK : NONEMBEDDABLE;
+}
+
+/********************************************************************
+ _JoinComponentBin()
+
+ The bin's subgraph is sorted by DFI, and the DFIs of each component
+ in it are contiguous, so a bin vertex is moved to the DFI of its
+ component's root in theGraph plus its offset from the component's
+ root in the bin.  The subRoot array records the bin DFI of the root
+ of each component found in the bin.
+
+ The edge records are appended to theGraph's edge records, which
+ preserves the pairing of twin arcs, and their links are translated.
+ If includeEdges is FALSE, then the vertices receive empty adjacency
+ lists.
+
+ Returns OK on success, NOTOK on failure.
+ ********************************************************************/
+
+int  _JoinComponentBin(graphP theGraph, componentBinRecP bin, int includeEdges,
+                       int *compOf, int *compStart, int *subRoot)
+{
+graphP subgraph = bin->subgraph;
+int  *dfiMap, *arcMap = NULL;
+int  d, g, c, e, u, EsizeOccupied;
+
+	if ((dfiMap = (int *) malloc(gp_PrimaryVertexIndexBound(subgraph) * sizeof(int))) == NULL)
+		return NOTOK;
+
+	// Determine the DFI in theGraph of each bin vertex
+	for (d = gp_GetFirstVertex(subgraph); gp_VertexInRange(subgraph, d); d++)
+	{
+		c = compOf[bin->subToGlobal[gp_GetVertexIndex(subgraph, d)]];
+		if (gp_IsDFSTreeRoot(subgraph, d))
+			subRoot[c] = d;
+		dfiMap[d] = compStart[c] + (d - subRoot[c]);
+	}
+
+	// Copy the edge records, translating neighbors and links
+	EsizeOccupied = gp_EdgeInUseIndexBound(subgraph);
+	if (includeEdges)
+	{
+		if ((arcMap = (int *) calloc(EsizeOccupied, sizeof(int))) == NULL)
+		{
+			free(dfiMap);
+			return NOTOK;
+		}
+
+		for (e = gp_GetFirstEdge(subgraph); e < EsizeOccupied; e+=2)
+		{
+			if (gp_EdgeInUse(subgraph, e))
+			{
+				arcMap[e] = gp_GetFirstEdge(theGraph) + 2*theGraph->M;
+				arcMap[e+1] = arcMap[e] + 1;
+				theGraph->M++;
+			}
+		}
+
+		for (e = gp_GetFirstEdge(subgraph); e < EsizeOccupied; e++)
+		{
+			if (gp_EdgeInUse(subgraph, e))
+			{
+				g = arcMap[e];
+				gp_CopyEdgeRec(theGraph, g, subgraph, e);
+				gp_SetNeighbor(theGraph, g, dfiMap[gp_GetNeighbor(subgraph, e)]);
+				if (gp_IsArc(gp_GetNextArc(subgraph, e)))
+					gp_SetNextArc(theGraph, g, arcMap[gp_GetNextArc(subgraph, e)]);
+				if (gp_IsArc(gp_GetPrevArc(subgraph, e)))
+					gp_SetPrevArc(theGraph, g, arcMap[gp_GetPrevArc(subgraph, e)]);
+			}
+		}
+	}
+
+	// Copy the vertex records, translating links and DFS tree information
+	for (d = gp_GetFirstVertex(subgraph); gp_VertexInRange(subgraph, d); d++)
+	{
+		g = dfiMap[d];
+
+		gp_CopyVertexRec(theGraph, g, subgraph, d);
+		gp_SetVertexIndex(theGraph, g, bin->subToGlobal[gp_GetVertexIndex(subgraph, d)]);
+		if (includeEdges && gp_IsArc(gp_GetFirstArc(subgraph, d)))
+		{
+			gp_SetFirstArc(theGraph, g, arcMap[gp_GetFirstArc(subgraph, d)]);
+			gp_SetLastArc(theGraph, g, arcMap[gp_GetLastArc(subgraph, d)]);
+		}
+		else
+		{
+			gp_SetFirstArc(theGraph, g, NIL);
+			gp_SetLastArc(theGraph, g, NIL);
+		}
+
+		gp_CopyVertexInfo(theGraph, g, subgraph, d);
+		if (gp_IsVertex(u = gp_GetVertexParent(subgraph, d)))
+			gp_SetVertexParent(theGraph, g, dfiMap[u]);
+		if (gp_IsVertex(u = gp_GetVertexLeastAncestor(subgraph, d)))
+			gp_SetVertexLeastAncestor(theGraph, g, dfiMap[u]);
+		if (gp_IsVertex(u = gp_GetVertexLowpoint(subgraph, d)))
+			gp_SetVertexLowpoint(theGraph, g, dfiMap[u]);
+
+		gp_SetVertexVisitedInfo(theGraph, g, NIL);
+		gp_SetVertexPertinentEdge(theGraph, g, NIL);
+		gp_SetVertexPertinentRootsList(theGraph, g, NIL);
+		gp_SetVertexFuturePertinentChild(theGraph, g, NIL);
+		gp_SetVertexSortedDFSChildList(theGraph, g, NIL);
+		gp_SetVertexFwdArcList(theGraph, g, NIL);
+	}
+
+	if (arcMap != NULL) free(arcMap);
+	free(dfiMap);
+
+	return OK;
+}
+
+/********************************************************************
+ gp_EmbedBlocks()
+
+ Performs the same operation as gp_Embed(), except that the input graph
+ is first split into its biconnected components (blocks), which are
+ then embedded concurrently, up to numThreads at a time.
+
+ A graph is planar if and only if each of its blocks is planar, and
+ the blocks share only cut vertices, so a planar embedding of the whole
+ graph is obtained by concatenating, at each cut vertex, the rotations
+ of the blocks that contain it.  This is the only merge needed, since
+ inserting one block's rotation into a corner of another block's
+ rotation joins one face of each into one face.  Unlike
+ gp_EmbedComponents(), this helps with a single connected graph, as
+ long as it has more than one large block.
+
+ The blocks are found by one iterative DFS of theGraph, and the DFIs
+ and DFS tree of that DFS are given to theGraph after the merge, so
+ that it meets the documented post-condition of gp_Embed().  The blocks
+ are distributed among the bins by the same greedy largest-first
+ assignment used by gp_EmbedComponents().  Then the thread of each bin
+ copies the bin's blocks into a subgraph, with each cut vertex copied
+ into every block that contains it, embeds the subgraph, and writes its
+ edge records, edge types and rotations into theGraph, so the DFS is
+ the only pass over the whole graph that is not shared by the threads.
+ The calling thread only concatenates the rotations of the copies of
+ the cut vertices that are the roots of blocks, one per block.
+
+ The block DFS costs about a third of gp_Embed(), and building and
+ merging a bin costs about as much as embedding it, so the wall time
+ beats gp_Embed() only if the largest bin is a small part of the graph.
+ If numThreads is zero or less, then the number of online processors
+ is used, and gp_Embed() is called directly unless no bin would have
+ more than 1/EMBEDBLOCKS_SPLITFACTOR of the edges, which needs at least
+ that many processors.  A positive numThreads always splits a graph
+ that has at least two blocks, which is mainly of use for testing.
+
+ The blocks are not split further at separation pairs, as they would
+ be in an SPQR tree, since gp_CreateSPQRTree() takes about twice as
+ long as gp_Embed() on a triconnected graph, in one thread, and the
+ rotation systems of the triconnected components would then have to
+ be merged across virtual edges.
+
+ If any block is not embeddable, then the obstruction isolated in the
+ first such bin is the result, and all other edges are removed.
+
+ The outerplanar setting is not supported because a block's rotation
+ could then only be inserted into a corner on the outer face, so
+ gp_Embed() is called directly if the embedFlags are other than
+ EMBEDFLAGS_PLANAR.  The same is done if theGraph has any extensions,
+ if it is already DFS numbered, if it has a self-loop, or if it has
+ fewer than two blocks.
+
+ Returns the same values as gp_Embed().
+ ********************************************************************/
+
+int  gp_EmbedBlocks(graphP theGraph, int embedFlags, int numThreads)
+{
+blockSplitRec split;
+componentBinRecP bins = NULL;
+int  *blockSize=NULL, *blockEdges=NULL;
+int  chooseSplit = numThreads <= 0;
+int  numEdges, maxBinEdges, c, b, e, v, RetVal = OK;
+
+#ifdef PROFILE
+platform_time start, end;
+platform_GetTime(start);
+#endif
+
+	if (theGraph == NULL)
+		return NOTOK;
+
+	if (theGraph->extensions != NULL || embedFlags != EMBEDFLAGS_PLANAR ||
+	    (theGraph->internalFlags & FLAGS_DFSNUMBERED))
+		return gp_Embed(theGraph, embedFlags);
+
+	if (numThreads <= 0)
+		numThreads = _GetDefaultNumThreads();
+
+	if (numThreads < 2)
+		return gp_Embed(theGraph, embedFlags);
+
+	gp_Trace2(theGraph, TRACE_EMBEDBLOCKS_BEGIN, embedFlags, numThreads);
+
+	// A graph with N vertices has fewer than N blocks, so the per-block
+	// arrays are indexed from zero and sized by the vertex index bound.
+	// The vertex copies are NIL until made, so those arrays are zero-filled.
+	memset(&split, 0, sizeof(blockSplitRec));
+	split.theGraph = theGraph;
+	split.edgeIndexBound = gp_EdgeInUseIndexBound(theGraph);
+
+	v = gp_PrimaryVertexIndexBound(theGraph);
+	e = split.edgeIndexBound;
+	if ((split.dfi = (int *) malloc(v * sizeof(int))) == NULL ||
+	    (split.parent = (int *) malloc(v * sizeof(int))) == NULL ||
+	    (split.parentArc = (int *) malloc(v * sizeof(int))) == NULL ||
+	    (split.lowpoint = (int *) malloc(v * sizeof(int))) == NULL ||
+	    (split.leastAncestor = (int *) malloc(v * sizeof(int))) == NULL ||
+	    (split.blockOf = (int *) malloc((e/2 + 1) * sizeof(int))) == NULL ||
+	    (blockSize = (int *) calloc(v, sizeof(int))) == NULL ||
+	    (blockEdges = (int *) calloc(v, sizeof(int))) == NULL ||
+	    (split.blockBin = (int *) malloc(v * sizeof(int))) == NULL ||
+	    (split.blockStart = (int *) calloc(v + 1, sizeof(int))) == NULL ||
+	    (split.blockArcs = (int *) malloc((theGraph->M + 1) * sizeof(int))) == NULL ||
+	    (split.globalToSub = (int *) calloc(v, sizeof(int))) == NULL ||
+	    (split.rootSub = (int *) calloc(v, sizeof(int))) == NULL ||
+	    (split.blockRoot = (int *) malloc(v * sizeof(int))) == NULL ||
+	    (split.rootFirst = (int *) malloc(v * sizeof(int))) == NULL ||
+	    (split.rootLast = (int *) malloc(v * sizeof(int))) == NULL)
+		RetVal = NOTOK;
+
+	// Find the blocks
+	numEdges = 0;
+	if (RetVal == OK)
+	{
+		if ((split.numBlocks = _LabelBlocks(theGraph, split.dfi, split.parent, split.lowpoint,
+		                                    split.leastAncestor, split.parentArc,
+		                                    split.blockOf, blockSize, blockEdges)) < 0)
+			RetVal = NOTOK;
+
+		for (c = 0; c < split.numBlocks; c++)
+			numEdges += blockEdges[c];
+	}
+
+	// Distribute the blocks among the bins, unless there are too few blocks.
+	// Self-loops belong to no block, so their graphs are left to gp_Embed().
+	split.numBins = 0;
+	if (RetVal == OK && split.numBlocks >= 2 && numEdges == theGraph->M)
+	{
+		split.numBins = numThreads < split.numBlocks ? numThreads : split.numBlocks;
+		if ((bins = (componentBinRecP) calloc(split.numBins, sizeof(componentBinRec))) == NULL ||
+		    (split.binN = (int *) calloc(split.numBins, sizeof(int))) == NULL ||
+		    (split.binM = (int *) calloc(split.numBins, sizeof(int))) == NULL ||
+		    (split.binEdgeStart = (int *) calloc(split.numBins, sizeof(int))) == NULL ||
+		    _AssignComponentsToBins(split.numBlocks, blockSize, blockEdges,
+		                            split.blockBin, split.binN, split.binM, split.numBins) != OK)
+			RetVal = NOTOK;
+	}
+
+	// Decide whether the split is worthwhile, which it is taken to be if
+	// the caller gave the number of threads
+	maxBinEdges = 0;
+	for (b = 0; b < split.numBins && RetVal == OK; b++)
+		if (maxBinEdges < split.binM[b])
+			maxBinEdges = split.binM[b];
+
+	if (RetVal == OK && (split.numBins == 0 ||
+	    (chooseSplit && maxBinEdges > theGraph->M / EMBEDBLOCKS_SPLITFACTOR)))
+	{
+		RetVal = gp_Embed(theGraph, embedFlags);
+		split.numBins = 0;
+	}
+
+	// Group the edges by block, so each bin can be built from its blocks' edges
+	if (RetVal == OK && split.numBins > 0)
+	{
+		for (c = 0; c < split.numBlocks; c++)
+			split.blockStart[c+1] = split.blockStart[c] + blockEdges[c];
+
+		for (e = gp_GetFirstEdge(theGraph); e < split.edgeIndexBound; e+=2)
+			if (gp_EdgeInUse(theGraph, e))
+				split.blockArcs[split.blockStart[split.blockOf[e>>1]]++] = e;
+
+		for (c = split.numBlocks; c > 0; c--)
+			split.blockStart[c] = split.blockStart[c-1];
+		split.blockStart[0] = 0;
+	}
+
+	// Build and embed the bins concurrently, then merge them into theGraph
+	if (RetVal == OK && split.numBins > 0)
+	{
+		for (b = 0; b < split.numBins; b++)
+		{
+			bins[b].b = b;
+			bins[b].split = &split;
+			bins[b].embedFlags = embedFlags;
+			bins[b].result = NOTOK;
+		}
+
+		_ReleasePreprocessCache(theGraph);
+		_RunComponentBinThreads(bins, split.numBins, _CreateBlockBinThread);
+		RetVal = _JoinBlockBins(&split, bins);
+	}
+
+	// Release the bins and the working arrays
+	if (bins != NULL)
+	{
+		for (b = 0; b < split.numBins; b++)
+			_FreeBlockBin(bins+b);
+		free(bins);
+	}
+
+	if (split.dfi != NULL) free(split.dfi);
+	if (split.parent != NULL) free(split.parent);
+	if (split.parentArc != NULL) free(split.parentArc);
+	if (split.lowpoint != NULL) free(split.lowpoint);
+	if (split.leastAncestor != NULL) free(split.leastAncestor);
+	if (split.blockOf != NULL) free(split.blockOf);
+	if (blockSize != NULL) free(blockSize);
+	if (blockEdges != NULL) free(blockEdges);
+	if (split.blockBin != NULL) free(split.blockBin);
+	if (split.blockStart != NULL) free(split.blockStart);
+	if (split.blockArcs != NULL) free(split.blockArcs);
+	if (split.binN != NULL) free(split.binN);
+	if (split.binM != NULL) free(split.binM);
+	if (split.binEdgeStart != NULL) free(split.binEdgeStart);
+	if (split.globalToSub != NULL) free(split.globalToSub);
+	if (split.rootSub != NULL) free(split.rootSub);
+	if (split.blockRoot != NULL) free(split.blockRoot);
+	if (split.rootFirst != NULL) free(split.rootFirst);
+	if (split.rootLast != NULL) free(split.rootLast);
+
+	gp_Trace1(theGraph, TRACE_EMBEDBLOCKS_END, RetVal);
+
+#ifdef PROFILE
+platform_GetTime(end);
+printf("EmbedBlocks in %.3lf seconds.\n", platform_GetDuration(start,end));
+#endif
+
+	return RetVal;
+}
+
+/********************************************************************
+ _LabelBlocks()
+
+ Performs an iterative DFS of theGraph, in order of vertex number for
+ the roots and adjacency list order for the children, and pushes the
+ tree edges and back edges onto an edge stack as they are found.  Once
+ the DFS retreats from a child v to its parent u with lowpoint(v) not
+ less than the DFI of u, the edges above and including (u, v) on the
+ edge stack form a block (Hopcroft and Tarjan).
+
+ On return, dfi, parent, lowpoint and leastAncestor give the DFS tree
+ of each vertex of theGraph, with parent, lowpoint and leastAncestor
+ expressed as DFIs except for a root's NIL parent.  If parentArc is not
+ NULL, then parentArc[v] is the arc from the parent of v to v, or NIL
+ for a root.  The block of each edge is blockOf[e>>1] for either of its
+ arcs e, and blockSize[c] and blockEdges[c] are the number of vertices
+ and edges in block c (the two count arrays must be zero-filled on
+ entry).  theGraph is not modified.
+
+ Returns the number of blocks, or -1 on memory allocation failure.
+ ********************************************************************/
+
+int  _LabelBlocks(graphP theGraph, int *dfi, int *parent, int *lowpoint, int *leastAncestor,
+                  int *parentArc, int *blockOf, int *blockSize, int *blockEdges)
+{
+int  *nextArc, *localParentArc = NULL, *vertexStack, *edgeStack;
+int  numBlocks = 0, nextDFI, top, edgeTop, r, u, v, w, e, f;
+
+	if (parentArc == NULL)
+		parentArc = localParentArc = (int *) malloc(gp_PrimaryVertexIndexBound(theGraph) * sizeof(int));
+	nextArc = (int *) malloc(gp_PrimaryVertexIndexBound(theGraph) * sizeof(int));
+	vertexStack = (int *) malloc(gp_PrimaryVertexIndexBound(theGraph) * sizeof(int));
+	edgeStack = (int *) malloc((theGraph->M + 1) * sizeof(int));
+	if (nextArc == NULL || parentArc == NULL || vertexStack == NULL || edgeStack == NULL)
+	{
+		if (nextArc != NULL) free(nextArc);
+		if (localParentArc != NULL) free(localParentArc);
+		if (vertexStack != NULL) free(vertexStack);
+		if (edgeStack != NULL) free(edgeStack);
+		return -1;
+	}
+
+	for (v = gp_GetFirstVertex(theGraph); gp_VertexInRange(theGraph, v); v++)
+		dfi[v] = NIL;
+
+	for (e = gp_GetFirstEdge(theGraph); e < gp_EdgeInUseIndexBound(theGraph); e+=2)
+		blockOf[e>>1] = -1;
+
+	nextDFI = gp_GetFirstVertex(theGraph);
+	for (r = gp_GetFirstVertex(theGraph); gp_VertexInRange(theGraph, r); r++)
+	{
+		if (dfi[r] != NIL)
+			continue;
+
+		dfi[r] = lowpoint[r] = leastAncestor[r] = nextDFI++;
+		parent[r] = parentArc[r] = NIL;
+		nextArc[r] = gp_GetFirstArc(theGraph, r);
+		vertexStack[0] = r;
+		top = 1;
+		edgeTop = 0;
+
+		while (top > 0)
+		{
+			v = vertexStack[top-1];
+
+			// Advance along the next arc of v, if any
+			if (gp_IsArc(e = nextArc[v]))
+			{
+				nextArc[v] = gp_GetNextArc(theGraph, e);
+				w = gp_GetNeighbor(theGraph, e);
+
+				if (dfi[w] == NIL)
+				{
+					edgeStack[edgeTop++] = e;
+					parent[w] = v;
+					parentArc[w] = e;
+					dfi[w] = lowpoint[w] = leastAncestor[w] = nextDFI++;
+					nextArc[w] = gp_GetFirstArc(theGraph, w);
+					vertexStack[top++] = w;
+				}
+
+				// A back edge is pushed once, from its descendant endpoint,
+				// but the twin of the tree edge to the parent is skipped
+				else if (dfi[w] < dfi[v] &&
+				         !(gp_IsArc(parentArc[v]) && e == gp_GetTwinArc(theGraph, parentArc[v])))
+				{
+					edgeStack[edgeTop++] = e;
+					if (dfi[w] < leastAncestor[v])
+						leastAncestor[v] = dfi[w];
+					if (dfi[w] < lowpoint[v])
+						lowpoint[v] = dfi[w];
+				}
+			}
+
+			// Retreat from v to its parent u, popping a block if u separates it
+			else
+			{
+				top--;
+				if (gp_IsVertex(u = parent[v]))
+				{
+					if (lowpoint[v] < lowpoint[u])
+						lowpoint[u] = lowpoint[v];
+
+					if (lowpoint[v] >= dfi[u])
+					{
+						// The block contains u plus the child endpoint of each tree edge
+						blockSize[numBlocks] = 1;
+						do {
+							f = edgeStack[--edgeTop];
+							blockOf[f>>1] = numBlocks;
+							blockEdges[numBlocks]++;
+							if (f == parentArc[gp_GetNeighbor(theGraph, f)])
+								blockSize[numBlocks]++;
+						} while (f != parentArc[v]);
+						numBlocks++;
+					}
+				}
+			}
+		}
+	}
+
+	// Express the parents as DFIs, now that all vertices have one
+	for (v = gp_GetFirstVertex(theGraph); gp_VertexInRange(theGraph, v); v++)
+		if (gp_IsVertex(parent[v]))
+			parent[v] = dfi[parent[v]];
+
+	free(nextArc);
+	if (localParentArc != NULL) free(localParentArc);
+	free(vertexStack);
+	free(edgeStack);
+
+	return numBlocks;
+}
+
+/********************************************************************
+ _CreateBlockBinThread()
+
+ The thread procedure that builds and embeds one bin of gp_EmbedBlocks().
+ It also initializes its share of the vertex records of theGraph, which
+ the bins only read the edge records of, so that they are ready to
+ receive the merged rotations.
+ ********************************************************************/
+
+#ifdef WIN32
+DWORD WINAPI _CreateBlockBinThread(LPVOID param)
+#else
+void *_CreateBlockBinThread(void *param)
+#endif
+{
+componentBinRecP bin = (componentBinRecP) param;
+
+	_InitBlockVertices(bin);
+
+	if (_CreateBlockBin(bin) == OK)
+		bin->result = gp_Embed(bin->subgraph, bin->embedFlags);
+
+	return 0;
+}
+
+/********************************************************************
+ _InitBlockVertices()
+
+ Moves each vertex in the bin's share of the vertices of theGraph to
+ its DFI, with a new vertex record that holds the DFS tree information
+ computed by _LabelBlocks().  Nothing else is needed of the old record,
+ so each record is written once and never read.
+ ********************************************************************/
+
+void _InitBlockVertices(componentBinRecP bin)
+{
+blockSplitP split = bin->split;
+graphP theGraph = split->theGraph;
+int  first = gp_GetFirstVertex(theGraph), N = theGraph->N;
+int  v, g, vEnd;
+
+	vEnd = first + (int) ((long) N * (bin->b + 1) / split->numBins);
+	for (v = first + (int) ((long) N * bin->b / split->numBins); v < vEnd; v++)
+	{
+		g = split->dfi[v];
+		_InitVertexRec(theGraph, g);
+		_InitVertexInfo(theGraph, g);
+		gp_SetVertexIndex(theGraph, g, v);
+		gp_SetVertexParent(theGraph, g, split->parent[v]);
+		gp_SetVertexLeastAncestor(theGraph, g, split->leastAncestor[v]);
+		gp_SetVertexLowpoint(theGraph, g, split->lowpoint[v]);
+	}
+}
+
+/********************************************************************
+ _CreateBlockBin()
+
+ Creates the subgraph for the bin, containing the vertex copies and the
+ edges of the blocks assigned to it.  Each block receives its own copy
+ of each of its vertices, so the blocks are the connected components of
+ the bin and a cut vertex has one copy per block that contains it.  The
+ bin also records which of its edges are DFS tree edges of theGraph.
+
+ Returns OK on success, NOTOK on failure.
+ ********************************************************************/
+
+int  _CreateBlockBin(componentBinRecP bin)
+{
+blockSplitP split = bin->split;
+graphP theGraph = split->theGraph, subgraph;
+int  N = split->binN[bin->b], M = split->binM[bin->b];
+int  c, i, k, u, w, e, subu, subw, subv;
+
+	if ((bin->subgraph = subgraph = gp_New()) == NULL)
+		return NOTOK;
+
+	if (M > DEFAULT_EDGE_LIMIT * N && gp_EnsureArcCapacity(subgraph, 2*M) != OK)
+		return NOTOK;
+
+	if (gp_InitGraph(subgraph, N) != OK)
+		return NOTOK;
+
+	if ((bin->subToGlobal = (int *) malloc(gp_PrimaryVertexIndexBound(subgraph) * sizeof(int))) == NULL ||
+	    (bin->rootBlockOf = (int *) malloc(gp_PrimaryVertexIndexBound(subgraph) * sizeof(int))) == NULL ||
+	    (bin->isTreeEdge = (char *) malloc((M + 1) * sizeof(char))) == NULL)
+		return NOTOK;
+
+	subv = gp_GetFirstVertex(subgraph);
+	k = 0;
+	for (c = 0; c < split->numBlocks; c++)
+	{
+		if (split->blockBin[c] != bin->b)
+			continue;
+
+		split->rootFirst[c] = split->rootLast[c] = NIL;
+
+		for (i = split->blockStart[c]; i < split->blockStart[c+1]; i++)
+		{
+			e = split->blockArcs[i];
+			u = gp_GetNeighbor(theGraph, gp_GetTwinArc(theGraph, e));
+			w = gp_GetNeighbor(theGraph, e);
+
+			subu = _GetBlockVertexCopy(bin, c, u, &subv);
+			subw = _GetBlockVertexCopy(bin, c, w, &subv);
+
+			// The k-th edge added to a new graph occupies the k-th edge record
+			bin->isTreeEdge[k++] = split->parentArc[w] == e ||
+			                       split->parentArc[u] == gp_GetTwinArc(theGraph, e);
+
+			if (gp_AddEdge(subgraph, subu, 0, subw, 0) != OK)
+				return NOTOK;
+		}
+	}
+
+	return OK;
+}
+
+/********************************************************************
+ _GetBlockVertexCopy()
+
+ Returns the copy of vertex v in the bin's copy of block c, making it
+ from the next bin vertex, *pSubv, if it does not exist yet.  Vertex v
+ is a non-root of block c only if the tree edge from its parent is in
+ block c, and otherwise it is the root of block c.
+ ********************************************************************/
+
+int  _GetBlockVertexCopy(componentBinRecP bin, int c, int v, int *pSubv)
+{
+blockSplitP split = bin->split;
+int  e = split->parentArc[v], isRoot = !gp_IsArc(e) || split->blockOf[e>>1] != c;
+int  *pCopy = isRoot ? split->rootSub + c : split->globalToSub + v;
+
+	if (*pCopy == NIL)
+	{
+		*pCopy = (*pSubv)++;
+		gp_SetVertexIndex(bin->subgraph, *pCopy, *pCopy);
+		bin->subToGlobal[*pCopy] = v;
+		bin->rootBlockOf[*pCopy] = isRoot ? c : -1;
+		if (isRoot)
+			split->blockRoot[c] = v;
+	}
+
+	return *pCopy;
+}
+
+/********************************************************************
+ _JoinBlockBins()
+
+ Replaces the edges of theGraph with those of the embedded bins, whose
+ threads write the edge records into consecutive ranges, one per bin,
+ and whose vertices have been moved to their DFIs.  Then the rotations
+ of the root copies of the cut vertices, which each bin thread leaves
+ in the rootFirst and rootLast arrays, are concatenated onto those of
+ their vertices.  If a bin produced an obstruction, then only the edges
+ of the first such bin are kept, since any one obstruction suffices as
+ the result.
+
+ Returns OK, NONEMBEDDABLE or NOTOK, like gp_Embed().
+ ********************************************************************/
+
+int  _JoinBlockBins(blockSplitP split, componentBinRecP bins)
+{
+graphP theGraph = split->theGraph;
+int  b, c, g, M;
+
+	split->obstructionBin = -1;
+	for (b = 0; b < split->numBins; b++)
+	{
+		if (bins[b].result == NONEMBEDDABLE && split->obstructionBin < 0)
+			split->obstructionBin = b;
+		else if (bins[b].result != OK && bins[b].result != NONEMBEDDABLE)
+			return NOTOK;
+	}
+
+	// Give each bin whose edges are kept the range of edge records after
+	// those of the preceding bins
+	M = 0;
+	for (b = 0; b < split->numBins; b++)
+	{
+		split->binEdgeStart[b] = gp_GetFirstEdge(theGraph) + 2*M;
+		if (split->obstructionBin < 0 || split->obstructionBin == b)
+			M += bins[b].subgraph->M;
+	}
+
+	theGraph->M = M;
+	sp_ClearStack(theGraph->edgeHoles);
+
+	_RunComponentBinThreads(bins, split->numBins, _JoinBlockBinThread);
+
+	for (b = 0; b < split->numBins; b++)
+		if (bins[b].result != OK && bins[b].result != NONEMBEDDABLE)
+			return NOTOK;
+
+	// Concatenate the rotation of each block's root copy onto its vertex
+	for (c = 0; c < split->numBlocks; c++)
+	{
+		if (!gp_IsArc(split->rootFirst[c]))
+			continue;
+
+		g = split->dfi[split->blockRoot[c]];
+
+		if (gp_IsArc(gp_GetLastArc(theGraph, g)))
+		{
+			gp_SetNextArc(theGraph, gp_GetLastArc(theGraph, g), split->rootFirst[c]);
+			gp_SetPrevArc(theGraph, split->rootFirst[c], gp_GetLastArc(theGraph, g));
+		}
+		else
+			gp_SetFirstArc(theGraph, g, split->rootFirst[c]);
+
+		gp_SetLastArc(theGraph, g, split->rootLast[c]);
+	}
+
+	theGraph->internalFlags |= FLAGS_DFSNUMBERED | FLAGS_SORTEDBYDFI;
+	theGraph->embedFlags = bins[0].embedFlags;
+
+	return split->obstructionBin < 0 ? OK : NONEMBEDDABLE;
+}
+
+/********************************************************************
+ _JoinBlockBinThread()
+
+ The thread procedure that merges one bin of gp_EmbedBlocks() into
+ theGraph, if its edges are kept, and releases the bin.  It also clears
+ its share of the edge records of theGraph beyond those of the bins.
+ ********************************************************************/
+
+#ifdef WIN32
+DWORD WINAPI _JoinBlockBinThread(LPVOID param)
+#else
+void *_JoinBlockBinThread(void *param)
+#endif
+{
+componentBinRecP bin = (componentBinRecP) param;
+blockSplitP split = bin->split;
+
+	_InitBlockEdges(bin);
+
+	if ((split->obstructionBin < 0 || split->obstructionBin == bin->b) &&
+	    _JoinBlockBin(bin) != OK)
+		bin->result = NOTOK;
+
+	_FreeBlockBin(bin);
+	return 0;
+}
+
+/********************************************************************
+ _InitBlockEdges()
+
+ Initializes the bin's share of the edge records of theGraph that lie
+ beyond the edge records of the bins, which are left over from the
+ removed edges and from the holes of theGraph.
+ ********************************************************************/
+
+void _InitBlockEdges(componentBinRecP bin)
+{
+blockSplitP split = bin->split;
+graphP theGraph = split->theGraph;
+int  first = gp_GetFirstEdge(theGraph) + 2*theGraph->M;
+int  numEdges = (split->edgeIndexBound - first) / 2;
+int  e, eEnd;
+
+	eEnd = first + 2 * (int) ((long) numEdges * (bin->b + 1) / split->numBins);
+	for (e = first + 2 * (int) ((long) numEdges * bin->b / split->numBins); e < eEnd; e++)
+		_InitEdgeRec(theGraph, e);
+}
+
+/********************************************************************
+ _JoinBlockBin()
+
+ The edge records of the bin are written into its range of theGraph's
+ edge records, which preserves the pairing of twin arcs, and their
+ neighbors and links are translated.  Each arc is typed relative to the
+ DFS tree of theGraph, which needs only the parent of each vertex since
+ the bin marks its tree edges.  Then the adjacency list of each bin
+ vertex becomes the adjacency list of the vertex of theGraph from which
+ it was copied, unless it is the root copy of a cut vertex, whose list
+ is left for _JoinBlockBins() to append.
+
+ Returns OK on success, NOTOK on failure.
+ ********************************************************************/
+
+int  _JoinBlockBin(componentBinRecP bin)
+{
+blockSplitP split = bin->split;
+graphP theGraph = split->theGraph, subgraph = bin->subgraph;
+int  *arcMap;
+int  d, g, u, w, e, f, type, first, last, EsizeOccupied;
+
+	EsizeOccupied = gp_EdgeInUseIndexBound(subgraph);
+	if ((arcMap = (int *) calloc(EsizeOccupied, sizeof(int))) == NULL)
+		return NOTOK;
+
+	f = split->binEdgeStart[bin->b];
+	for (e = gp_GetFirstEdge(subgraph); e < EsizeOccupied; e+=2)
+	{
+		if (gp_EdgeInUse(subgraph, e))
+		{
+			arcMap[e] = f;
+			arcMap[e+1] = f + 1;
+			f += 2;
+		}
+	}
+
+	for (e = gp_GetFirstEdge(subgraph); e < EsizeOccupied; e++)
+	{
+		if (!gp_EdgeInUse(subgraph, e))
+			continue;
+
+		g = arcMap[e];
+		gp_CopyEdgeRec(theGraph, g, subgraph, e);
+
+		d = gp_GetVertexIndex(subgraph, gp_GetNeighbor(subgraph, e));
+		w = split->dfi[bin->subToGlobal[d]];
+		d = gp_GetVertexIndex(subgraph, gp_GetNeighbor(subgraph, gp_GetTwinArc(subgraph, e)));
+		u = split->dfi[bin->subToGlobal[d]];
+
+		gp_SetNeighbor(theGraph, g, w);
+		gp_SetNextArc(theGraph, g, gp_IsArc(gp_GetNextArc(subgraph, e)) ? arcMap[gp_GetNextArc(subgraph, e)] : NIL);
+		gp_SetPrevArc(theGraph, g, gp_IsArc(gp_GetPrevArc(subgraph, e)) ? arcMap[gp_GetPrevArc(subgraph, e)] : NIL);
+
+		if (bin->isTreeEdge[(e - gp_GetFirstEdge(subgraph)) >> 1])
+			type = gp_GetVertexParent(theGraph, w) == u ? EDGE_TYPE_CHILD : EDGE_TYPE_PARENT;
+		else
+			type = w < u ? EDGE_TYPE_BACK : EDGE_TYPE_FORWARD;
+		gp_ResetEdgeType(theGraph, g, type);
+	}
+
+	// Give the rotation of each bin vertex to its vertex in theGraph
+	for (d = gp_GetFirstVertex(subgraph); gp_VertexInRange(subgraph, d); d++)
+	{
+		if (!gp_IsArc(gp_GetFirstArc(subgraph, d)))
+			continue;
+
+		u = gp_GetVertexIndex(subgraph, d);
+		first = arcMap[gp_GetFirstArc(subgraph, d)];
+		last = arcMap[gp_GetLastArc(subgraph, d)];
+
+		if (bin->rootBlockOf[u] >= 0)
+		{
+			split->rootFirst[bin->rootBlockOf[u]] = first;
+			split->rootLast[bin->rootBlockOf[u]] = last;
+		}
+		else
+		{
+			g = split->dfi[bin->subToGlobal[u]];
+			gp_SetFirstArc(theGraph, g, first);
+			gp_SetLastArc(theGraph, g, last);
+		}
+	}
+
+	free(arcMap);
+	return OK;
+}
+
+/********************************************************************
+ _FreeBlockBin()
+ Releases the subgraph and the arrays of a bin of gp_EmbedBlocks().
+ ********************************************************************/
+
+void _FreeBlockBin(componentBinRecP bin)
+{
+	gp_Free(&bin->subgraph);
+
+	if (bin->subToGlobal != NULL)
+	{
+		free(bin->subToGlobal);
+		bin->subToGlobal = NULL;
+	}
+
+	if (bin->rootBlockOf != NULL)
+	{
+		free(bin->rootBlockOf);
+		bin->rootBlockOf = NULL;
+	}
+
+	if (bin->isTreeEdge != NULL)
+	{
+		free(bin->isTreeEdge);
+		bin->isTreeEdge = NULL;
+	}
+}
@@ -0,0 +1,545 @@
+/*
+Planarity-Related Graph Algorithms Project
+Copyright (c) 1997-2012, John M. Boyer
+All rights reserved. Includes a reference implementation of the following:
+
+* John M. Boyer. "Subgraph Homeomorphism via the Edge Addition Planarity Algorithm".
+  Journal of Graph Algorithms and Applications, Vol. 16, no. 2, pp. 381-410, 2012.
+  http://www.jgaa.info/16/268.html
+
+* John M. Boyer. "A New Method for Efficiently Generating Planar Graph
+  Visibility Representations". In P. Eades and P. Healy, editors,
+  Proceedings of the 13th International Conference on Graph Drawing 2005,
+  Lecture Notes Comput. Sci., Volume 3843, pp. 508-511, Springer-Verlag, 2006.
+
+* John M. Boyer and Wendy J. Myrvold. "On the Cutting Edge: Simplified O(n)
+  Planarity by Edge Addition". Journal of Graph Algorithms and Applications,
+  Vol. 8, No. 3, pp. 241-273, 2004.
+  http://www.jgaa.info/08/91.html
+
+* John M. Boyer. "Simplified O(n) Algorithms for Planar Graph Embedding,
+  Kuratowski Subgraph Isolation, and Related Problems". Ph.D. Dissertation,
+  University of Victoria, 2001.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+* Redistributions of source code must retain the above copyright notice, this
+  list of conditions and the following disclaimer.
+
+* Redistributions in binary form must reproduce the above copyright notice, this
+  list of conditions and the following disclaimer in the documentation and/or
+  other materials provided with the distribution.
+
+* Neither the name of the Planarity-Related Graph Algorithms Project nor the names
+  of its contributors may be used to endorse or promote products derived from this
+  software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include <stdlib.h>
+
+#include "graph.h"
+
+/* Imported functions */
+
+extern void _ClearVertexVisitedFlags(graphP theGraph, int);
+
+/* Private definitions */
+
+/* A reduction record describes the removal of vertex v from the graph.
+   The arc h is the arc from a to v.  If g is NIL, then v had degree 1
+   and was hidden.  Otherwise, v had degree 2 and was merged into a
+   by contracting h, so the arc g from v to b became an arc from a to b.
+   If a was already adjacent to b by the arc k, then g was hidden as a
+   duplicate edge, and k is recorded; otherwise, k is NIL. */
+
+typedef struct
+{
+    int v, a, b, h, g, k;
+} reductionRec;
+
+typedef reductionRec * reductionRecP;
+
+/* Private functions */
+
+int  _ReduceDegreeTwoOrLess(graphP theGraph, reductionRecP reductions, int *pNumReductions);
+int  _CreateKernel(graphP theGraph, graphP *pKernel, int *kernelToGraph, int **pKernelArcToGraphArc);
+int  _ExpandEmbedding(graphP theGraph, graphP theKernel, int *kernelToGraph, int *kernelArcToGraphArc,
+                      reductionRecP reductions, int numReductions);
+int  _ExpandObstruction(graphP theGraph, graphP theKernel, int *kernelArcToGraphArc,
+                        reductionRecP reductions, int numReductions);
+void _ReplaceArc(graphP theGraph, int v, int oldArc, int newArc);
+
+/********************************************************************
+ gp_EmbedReduced()
+
+ Performs the same operation as gp_Embed() with EMBEDFLAGS_PLANAR,
+ except that the graph is first reduced by repeatedly hiding vertices
+ of degree 1 with gp_HideVertex() and merging vertices of degree 2
+ into a neighbor with gp_ContractEdge().  Neither operation changes
+ whether the graph is planar, so only the remaining kernel is given
+ to gp_Embed(), in a separate graph sized to the kernel.
+
+ Once the reduction has been recorded, gp_RestoreVertices() returns
+ theGraph to its original state.  Then, if the kernel was embedded,
+ its rotation system is expanded by reinserting the removed vertices
+ in reverse order of their removal.  Otherwise, the edges of the
+ kernel obstruction are expanded into the paths of the original graph
+ that they represent, and all other edges are deleted.
+
+ On completion, theGraph is DFS numbered and sorted by DFI, as after
+ gp_Embed().  Extension algorithms may overload the embedder, and the
+ reductions do not preserve outerplanarity, so gp_Embed() is called
+ directly for other embedFlags, if any extensions are attached, if the
+ graph is already DFS numbered, or if no vertex can be removed.
+
+ Returns the same values as gp_Embed().
+ ********************************************************************/
+
+int  gp_EmbedReduced(graphP theGraph, int embedFlags)
+{
+reductionRecP reductions = NULL;
+graphP theKernel = NULL;
+int  *kernelToGraph = NULL, *kernelArcToGraphArc = NULL;
+int  numReductions = 0, RetVal = OK;
+
+#ifdef PROFILE
+platform_time start, end;
+platform_GetTime(start);
+#endif
+
+    if (theGraph == NULL)
+        return NOTOK;
+
+    // The stack must hold every edge once, when it is hidden, plus
+    // seven integers for each vertex that is hidden or contracted
+    if (theGraph->extensions != NULL || embedFlags != EMBEDFLAGS_PLANAR ||
+        (theGraph->internalFlags & FLAGS_DFSNUMBERED) ||
+        sp_GetCapacity(theGraph->theStack) < theGraph->M + 7*theGraph->N)
+        return gp_Embed(theGraph, embedFlags);
+
+    gp_Trace1(theGraph, TRACE_EMBEDREDUCED_BEGIN, embedFlags);
+
+    if ((reductions = (reductionRecP) malloc(theGraph->N * sizeof(reductionRec))) == NULL ||
+        (kernelToGraph = (int *) malloc(gp_PrimaryVertexIndexBound(theGraph) * sizeof(int))) == NULL)
+        RetVal = NOTOK;
+
+    // Reduce the graph, copy the kernel, then restore the graph
+    sp_ClearStack(theGraph->theStack);
+    if (RetVal == OK)
+        RetVal = _ReduceDegreeTwoOrLess(theGraph, reductions, &numReductions);
+
+    if (RetVal == OK && numReductions > 0)
+        RetVal = _CreateKernel(theGraph, &theKernel, kernelToGraph, &kernelArcToGraphArc);
+
+    if (gp_RestoreVertices(theGraph) != OK)
+        RetVal = NOTOK;
+
+    if (RetVal == OK && numReductions == 0)
+    {
+        free(reductions);
+        free(kernelToGraph);
+        return gp_Embed(theGraph, embedFlags);
+    }
+
+    // Embed the kernel, if there is one, and expand the result
+    if (RetVal == OK && theKernel != NULL)
+        RetVal = gp_Embed(theKernel, embedFlags);
+
+    if (RetVal == OK)
+        RetVal = _ExpandEmbedding(theGraph, theKernel, kernelToGraph, kernelArcToGraphArc,
+                                  reductions, numReductions);
+
+    else if (RetVal == NONEMBEDDABLE)
+    {
+        if (_ExpandObstruction(theGraph, theKernel, kernelArcToGraphArc,
+                               reductions, numReductions) != OK)
+            RetVal = NOTOK;
+    }
+
+    // Give theGraph the DFS numbering and vertex order of the gp_Embed() result
+    if (RetVal == OK || RetVal == NONEMBEDDABLE)
+    {
+        theGraph->embedFlags = embedFlags;
+        if (gp_CreateDFSTree(theGraph) != OK || gp_SortVertices(theGraph) != OK)
+            RetVal = NOTOK;
+    }
+
+    gp_Free(&theKernel);
+    if (reductions != NULL) free(reductions);
+    if (kernelToGraph != NULL) free(kernelToGraph);
+    if (kernelArcToGraphArc != NULL) free(kernelArcToGraphArc);
+
+    gp_Trace1(theGraph, TRACE_EMBEDREDUCED_END, RetVal);
+
+#ifdef PROFILE
+platform_GetTime(end);
+printf("EmbedReduced in %.3lf seconds.\n", platform_GetDuration(start,end));
+#endif
+
+    return RetVal;
+}
+
+/********************************************************************
+ _ReduceDegreeTwoOrLess()
+
+ Repeatedly removes vertices of degree 1 and 2 until none remain.
+ A vertex of degree 1 is hidden.  A vertex v of degree 2 with
+ neighbors a and b is merged into a by contracting the edge (a, v),
+ which turns the edge (v, b) into an edge (a, b), unless a and b are
+ already adjacent, in which case the edge (v, b) is hidden since it
+ would be a duplicate.
+
+ The vertex degrees are cached and a vertex is pushed on a work list
+ whenever its degree drops to 1 or 2.  The work of each contraction is
+ proportional to the degree of a, so a is chosen to be the neighbor of
+ v with the lesser degree.
+
+ Each removal is recorded in the reductions array, in order.
+ Returns OK on success, NOTOK on failure.
+ ********************************************************************/
+
+int  _ReduceDegreeTwoOrLess(graphP theGraph, reductionRecP reductions, int *pNumReductions)
+{
+stackP workList;
+int  *degree;
+int  numReductions = 0, v, a, b, e, h, g, k, RetVal = OK;
+
+    if ((degree = (int *) malloc(gp_PrimaryVertexIndexBound(theGraph) * sizeof(int))) == NULL)
+        return NOTOK;
+
+    // Each vertex is pushed at most once initially, and at most two
+    // neighbors are pushed per removal
+    if ((workList = sp_New(3 * theGraph->N)) == NULL)
+    {
+        free(degree);
+        return NOTOK;
+    }
+
+    _ClearVertexVisitedFlags(theGraph, FALSE);
+
+    for (v = gp_GetFirstVertex(theGraph); gp_VertexInRange(theGraph, v); v++)
+    {
+        degree[v] = gp_GetVertexDegree(theGraph, v);
+        if (degree[v] == 1 || degree[v] == 2)
+            sp_Push(workList, v);
+    }
+
+    while (sp_NonEmpty(workList) && RetVal == OK)
+    {
+        sp_Pop(workList, v);
+
+        // The degree of v may have changed since it was pushed
+        if (degree[v] != 1 && degree[v] != 2)
+            continue;
+
+        // A degree 2 vertex is merged into its neighbor of lesser degree
+        // because the contraction takes time proportional to its degree
+        e = gp_GetFirstArc(theGraph, v);
+        if (degree[v] == 2 && degree[gp_GetNeighbor(theGraph, e)] >
+                              degree[gp_GetNeighbor(theGraph, gp_GetLastArc(theGraph, v))])
+            e = gp_GetLastArc(theGraph, v);
+
+        h = gp_GetTwinArc(theGraph, e);
+        a = gp_GetNeighbor(theGraph, e);
+
+        if (degree[v] == 1)
+        {
+            b = g = k = NIL;
+
+            if (gp_HideVertex(theGraph, v) != OK)
+                RetVal = NOTOK;
+
+            if (--degree[a] == 1 || degree[a] == 2)
+                sp_Push(workList, a);
+        }
+        else
+        {
+            g = e == gp_GetFirstArc(theGraph, v) ? gp_GetLastArc(theGraph, v) : gp_GetFirstArc(theGraph, v);
+            b = gp_GetNeighbor(theGraph, g);
+            k = gp_GetNeighborEdgeRecord(theGraph, a, b);
+
+            if (gp_ContractEdge(theGraph, h) != OK)
+                RetVal = NOTOK;
+
+            // If (v, b) duplicated (a, b), then it was hidden
+            if (gp_IsArc(k))
+            {
+                if (--degree[a] == 1 || degree[a] == 2)
+                    sp_Push(workList, a);
+                if (--degree[b] == 1 || degree[b] == 2)
+                    sp_Push(workList, b);
+            }
+        }
+
+        degree[v] = 0;
+
+        reductions[numReductions].v = v;
+        reductions[numReductions].a = a;
+        reductions[numReductions].b = b;
+        reductions[numReductions].h = h;
+        reductions[numReductions].g = g;
+        reductions[numReductions].k = k;
+        numReductions++;
+    }
+
+    sp_Free(&workList);
+    free(degree);
+
+    *pNumReductions = numReductions;
+    return RetVal;
+}
+
+/********************************************************************
+ _CreateKernel()
+
+ Copies the vertices of theGraph that have edges, and their edges,
+ into a new graph.  If no vertex has edges, then no graph is created.
+ On return, kernelToGraph[x] is the vertex of theGraph copied to kernel
+ vertex x, and the new array kernelArcToGraphArc gives the arc of
+ theGraph that corresponds to each arc of the kernel.
+
+ Returns OK on success, NOTOK on failure.
+ ********************************************************************/
+
+int  _CreateKernel(graphP theGraph, graphP *pKernel, int *kernelToGraph, int **pKernelArcToGraphArc)
+{
+graphP theKernel;
+int  *graphToKernel;
+int  N, M, v, e, pos;
+
+    *pKernel = NULL;
+    *pKernelArcToGraphArc = NULL;
+
+    // Hidden edges are still counted in M, so the kernel size is
+    // counted from the adjacency lists
+    N = M = 0;
+    for (v = gp_GetFirstVertex(theGraph); gp_VertexInRange(theGraph, v); v++)
+    {
+        if (gp_IsArc(gp_GetFirstArc(theGraph, v)))
+        {
+            N++;
+            M += gp_GetVertexDegree(theGraph, v);
+        }
+    }
+    M /= 2;
+
+    if (N == 0)
+        return OK;
+
+    if ((graphToKernel = (int *) malloc(gp_PrimaryVertexIndexBound(theGraph) * sizeof(int))) == NULL)
+        return NOTOK;
+
+    if ((*pKernel = theKernel = gp_New()) == NULL ||
+        (M > DEFAULT_EDGE_LIMIT * N && gp_EnsureArcCapacity(theKernel, 2*M) != OK) ||
+        gp_InitGraph(theKernel, N) != OK ||
+        (*pKernelArcToGraphArc = (int *) malloc(gp_EdgeIndexBound(theKernel) * sizeof(int))) == NULL)
+    {
+        free(graphToKernel);
+        return NOTOK;
+    }
+
+    N = gp_GetFirstVertex(theKernel);
+    for (v = gp_GetFirstVertex(theGraph); gp_VertexInRange(theGraph, v); v++)
+    {
+        if (gp_IsArc(gp_GetFirstArc(theGraph, v)))
+        {
+            gp_SetVertexIndex(theKernel, N, N);
+            kernelToGraph[N] = v;
+            graphToKernel[v] = N++;
+        }
+    }
+
+    // gp_AddEdge() puts the arc at the edge-in-use bound into the list of
+    // its second vertex parameter, and the twin of that arc into the list
+    // of its first vertex parameter
+    for (v = gp_GetFirstVertex(theGraph); gp_VertexInRange(theGraph, v); v++)
+    {
+        e = gp_GetFirstArc(theGraph, v);
+        while (gp_IsArc(e))
+        {
+            if (e < gp_GetTwinArc(theGraph, e))
+            {
+                pos = gp_EdgeInUseIndexBound(theKernel);
+                if (gp_AddEdge(theKernel, graphToKernel[v], 0,
+                               graphToKernel[gp_GetNeighbor(theGraph, e)], 0) != OK)
+                {
+                    free(graphToKernel);
+                    return NOTOK;
+                }
+                (*pKernelArcToGraphArc)[pos] = gp_GetTwinArc(theGraph, e);
+                (*pKernelArcToGraphArc)[gp_GetTwinArc(theKernel, pos)] = e;
+            }
+            e = gp_GetNextArc(theGraph, e);
+        }
+    }
+
+    free(graphToKernel);
+    return OK;
+}
+
+/********************************************************************
+ _ExpandEmbedding()
+
+ Rebuilds the adjacency lists of theGraph, which has been restored to
+ its original state, as a planar embedding.  The lists of the kernel
+ vertices are first given the rotation order of the kernel embedding,
+ using the arcs of theGraph that the kernel arcs were copied from.
+ Then, the reductions are undone in reverse order:
+
+ 1) A hidden degree 1 vertex v gets the arc to a, and the arc h from a
+    to v is appended to the list of a.
+ 2) A contracted vertex v takes the place of g in the list of a, i.e.
+    h replaces g, and v gets the arcs to a and b.
+ 3) If g was a duplicate of k, then v is embedded in a face incident
+    to (a, b) by inserting h after k in the list of a and the twin of
+    g before the twin of k in the list of b.
+
+ Each step preserves the consistent orientation of the embedding.
+ Returns OK on success, NOTOK on failure.
+ ********************************************************************/
+
+int  _ExpandEmbedding(graphP theGraph, graphP theKernel, int *kernelToGraph, int *kernelArcToGraphArc,
+                      reductionRecP reductions, int numReductions)
+{
+reductionRecP r;
+int  v, x, e, i;
+
+    for (v = gp_GetFirstVertex(theGraph); gp_VertexInRange(theGraph, v); v++)
+    {
+        gp_SetFirstArc(theGraph, v, NIL);
+        gp_SetLastArc(theGraph, v, NIL);
+    }
+
+    if (theKernel != NULL)
+    {
+        // Restore the kernel's original vertex numbering (undo DFS numbering)
+        if (gp_SortVertices(theKernel) != OK)
+            return NOTOK;
+
+        for (x = gp_GetFirstVertex(theKernel); gp_VertexInRange(theKernel, x); x++)
+        {
+            e = gp_GetFirstArc(theKernel, x);
+            while (gp_IsArc(e))
+            {
+                gp_AttachArc(theGraph, kernelToGraph[x], NIL, 1, kernelArcToGraphArc[e]);
+                e = gp_GetNextArc(theKernel, e);
+            }
+        }
+    }
+
+    for (i = numReductions-1; i >= 0; i--)
+    {
+        r = reductions + i;
+
+        if (gp_IsNotArc(r->g))
+            gp_AttachArc(theGraph, r->a, NIL, 1, r->h);
+
+        else
+        {
+            if (gp_IsNotArc(r->k))
+                _ReplaceArc(theGraph, r->a, r->g, r->h);
+            else
+            {
+                gp_AttachArc(theGraph, r->a, r->k, 0, r->h);
+                gp_AttachArc(theGraph, r->b, gp_GetTwinArc(theGraph, r->k), 1,
+                             gp_GetTwinArc(theGraph, r->g));
+            }
+
+            gp_AttachArc(theGraph, r->v, NIL, 1, r->g);
+        }
+
+        gp_AttachArc(theGraph, r->v, NIL, 0, gp_GetTwinArc(theGraph, r->h));
+    }
+
+    return OK;
+}
+
+/********************************************************************
+ _ExpandObstruction()
+
+ The kernel has been reduced to an obstruction by gp_Embed(), and
+ theGraph has been restored to its original state.  Each edge of the
+ obstruction corresponds to a path in theGraph, which is obtained by
+ undoing the reductions in reverse order: if the edge containing g
+ is in the obstruction, then so is the edge containing h.  Other
+ edges of theGraph are deleted, so theGraph becomes a subdivision of
+ the kernel obstruction.
+
+ Returns OK on success, NOTOK on failure.
+ ********************************************************************/
+
+int  _ExpandObstruction(graphP theGraph, graphP theKernel, int *kernelArcToGraphArc,
+                        reductionRecP reductions, int numReductions)
+{
+char *keep;
+int  EsizeOccupied, v, e, i;
+
+    if (theKernel == NULL)
+        return NOTOK;
+
+    if ((keep = (char *) calloc(gp_EdgeInUseIndexBound(theGraph), sizeof(char))) == NULL)
+        return NOTOK;
+
+    EsizeOccupied = gp_EdgeInUseIndexBound(theKernel);
+    for (e = gp_GetFirstEdge(theKernel); e < EsizeOccupied; e++)
+        if (gp_EdgeInUse(theKernel, e))
+            keep[kernelArcToGraphArc[e]] = 1;
+
+    for (i = numReductions-1; i >= 0; i--)
+    {
+        if (gp_IsArc(reductions[i].g) && keep[reductions[i].g])
+            keep[reductions[i].h] = keep[gp_GetTwinArc(theGraph, reductions[i].h)] = 1;
+    }
+
+    for (v = gp_GetFirstVertex(theGraph); gp_VertexInRange(theGraph, v); v++)
+    {
+        e = gp_GetFirstArc(theGraph, v);
+        while (gp_IsArc(e))
+        {
+            if (keep[e])
+                e = gp_GetNextArc(theGraph, e);
+            else e = gp_DeleteEdge(theGraph, e, 0);
+        }
+    }
+
+    free(keep);
+    return OK;
+}
+
+/********************************************************************
+ _ReplaceArc()
+ Puts newArc in the position of oldArc in the adjacency list of v.
+ The owner of the list is given explicitly because the neighbor of
+ the twin of oldArc may not yet indicate v.
+ ********************************************************************/
+
+void _ReplaceArc(graphP theGraph, int v, int oldArc, int newArc)
+{
+int  nextArc = gp_GetNextArc(theGraph, oldArc),
+     prevArc = gp_GetPrevArc(theGraph, oldArc);
+
+    gp_SetNextArc(theGraph, newArc, nextArc);
+    gp_SetPrevArc(theGraph, newArc, prevArc);
+
+    if (gp_IsArc(nextArc))
+        gp_SetPrevArc(theGraph, nextArc, newArc);
+    else
+        gp_SetLastArc(theGraph, v, newArc);
+
+    if (gp_IsArc(prevArc))
+        gp_SetNextArc(theGraph, prevArc, newArc);
+    else
+        gp_SetFirstArc(theGraph, v, newArc);
+}
@@ -50,6 +50,10 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include <stdlib.h>
 #include <string.h>
 
+#ifdef WIN32
+#include <windows.h>
+#endif
+
 #include "appconst.h"
 
 #include "graphExtensions.private.h"
@@ -74,10 +78,24 @@ graphExtensionP _FindNearestOverload(graphP theGraph, graphExtensionP target, in
  * graphs.  It is used in lieu of identifying extensions by a string
  * name, which is noticeably expensive when a frequently called
  * overload function seeks the extension context for a graph.
+ *
+ * The ID also indexes the graph's extensionContexts slots, so it is
+ * bounded by GRAPH_MAXEXTENSIONS.  IDs are assigned atomically so that
+ * graphs on different threads can attach features concurrently.
  ********************************************************************/
 
 static int moduleIDGenerator = 0;
 
+#ifdef WIN32
+#define _AtomicIncrement(pVar) InterlockedIncrement((volatile LONG *) (pVar))
+#define _AtomicCompareAndSwap(pVar, oldValue, newValue) \
+        InterlockedCompareExchange((volatile LONG *) (pVar), (newValue), (oldValue))
+#else
+#define _AtomicIncrement(pVar) __sync_add_and_fetch((pVar), 1)
+#define _AtomicCompareAndSwap(pVar, oldValue, newValue) \
+        __sync_val_compare_and_swap((pVar), (oldValue), (newValue))
+#endif
+
 /********************************************************************
  The extension mechanism allows new modules to equip a graph with the
  data structures and functions needed to implement new algorithms
@@ -234,6 +252,10 @@ static int moduleIDGenerator = 0;
                         module overloaded.
 
  The new extension is created and added to the graph.
+
+ Returns NOTOK if a parameter is invalid, if the extension is already
+ added to the graph, if more than GRAPH_MAXEXTENSIONS modules have been
+ assigned IDs, or if memory cannot be allocated; OK otherwise.
  ********************************************************************/
 
 int gp_AddExtension(graphP theGraph,
@@ -258,10 +280,16 @@ int gp_AddExtension(graphP theGraph,
         return NOTOK;
     }
 
-    // Assign a unique ID to the extension if it does not already have one
+    // Assign a unique ID to the extension if it does not already have one.
+    // If another thread assigns the module's ID first, then that ID is kept.
     if (*pModuleID == 0)
     {
-    	*pModuleID = ++moduleIDGenerator;
+    	_AtomicCompareAndSwap(pModuleID, 0, _AtomicIncrement(&moduleIDGenerator));
+    }
+
+    if (*pModuleID < 1 || *pModuleID > GRAPH_MAXEXTENSIONS)
+    {
+        return NOTOK;
     }
 
     // Allocate the new extension
@@ -282,6 +310,7 @@ int gp_AddExtension(graphP theGraph,
     // Make the new linkages
     newExtension->next = (struct graphExtension *) theGraph->extensions;
     theGraph->extensions = newExtension;
+    theGraph->extensionContexts[*pModuleID] = context;
 
     // The new extension was successfully added
     return OK;
@@ -328,45 +357,30 @@ int  K;
  @param theGraph - the graph whose extension list is to be searched
  @param moduleID - the identifier of the module whose extension context is desired
  @param pContext - the return parameter that receives the value of the
-                extension, if found.  This may be NULL if the extension was
-                not found or if the extension context value was NULL.
- @return TRUE if the extension was found, NOTOK if not found
-         If FALSE is returned, then the context returned is guaranteed to be NULL
-         If TRUE is returned, the context returned may be NULL if that is the
-         current value of the module extension
+                extension, if found, or NULL if the extension was not found.
+ @return TRUE if the extension was found, FALSE if not found
+
+ The context is read from the graph's extensionContexts slot for the
+ moduleID, so the cost does not depend on the number of extensions.
+ Overload functions can use the gp_GetExtensionContext() macro to
+ avoid the function call as well.
  ********************************************************************/
 
 int gp_FindExtension(graphP theGraph, int moduleID, void **pContext)
 {
-    graphExtensionP first = NULL, next = NULL;
-
-    if (pContext != NULL)
-    {
-        *pContext = NULL;
-    }
+    void *context = NULL;
 
-    if (theGraph==NULL || moduleID==0)
+    if (theGraph != NULL)
     {
-        return FALSE;
+        context = gp_GetExtensionContext(theGraph, moduleID);
     }
 
-    first = theGraph->extensions;
-
-    while (first != NULL)
+    if (pContext != NULL)
     {
-        next = (graphExtensionP) first->next;
-        if (first->moduleID == moduleID)
-        {
-            if (pContext != NULL)
-            {
-                *pContext = first->context;
-            }
-            return TRUE;
-        }
-        first = next;
+        *pContext = context;
     }
 
-    return FALSE;
+    return context != NULL ? TRUE : FALSE;
 }
 
 /********************************************************************
@@ -435,6 +449,7 @@ int gp_RemoveExtension(graphP theGraph, int moduleID)
         if (prev != NULL)
              prev->next = (struct graphExtension *) next;
         else theGraph->extensions = next;
+        theGraph->extensionContexts[moduleID] = NULL;
 
         // Free the curr extension
         _FreeExtension(curr);
@@ -536,6 +551,15 @@ int gp_CopyExtensions(graphP dstGraph, graphP srcGraph)
         newNext->functions = next->functions;
         newNext->next = NULL;
 
+        if (newNext->context == NULL)
+        {
+            free(newNext);
+            gp_FreeExtensions(dstGraph);
+            return NOTOK;
+        }
+
+        dstGraph->extensionContexts[newNext->moduleID] = newNext->context;
+
         if (newLast != NULL)
             newLast->next = (struct graphExtension *) newNext;
         else
@@ -572,6 +596,7 @@ void gp_FreeExtensions(graphP theGraph)
         }
 
         theGraph->extensions = NULL;
+        memset(theGraph->extensionContexts, 0, sizeof(theGraph->extensionContexts));
         _InitFunctionTable(theGraph);
     }
 }
@@ -63,6 +63,14 @@ int gp_AddExtension(graphP theGraph,
                     void (*freeContext)(void *),
                     graphFunctionTableP overloadTable);
 
+/* Returns the context of the extension with the given moduleID, or NULL
+   if the extension is not attached to theGraph.  Module IDs are never
+   negative, so the unsigned comparison also rejects out-of-range IDs. */
+
+#define gp_GetExtensionContext(theGraph, moduleID) \
+        ((unsigned) (moduleID) <= GRAPH_MAXEXTENSIONS ? \
+         (theGraph)->extensionContexts[moduleID] : NULL)
+
 int gp_FindExtension(graphP theGraph, int moduleID, void **pContext);
 void *gp_GetExtension(graphP theGraph, int moduleID);
 
@@ -0,0 +1,272 @@
+/*
+Planarity-Related Graph Algorithms Project
+Copyright (c) 1997-2012, John M. Boyer
+All rights reserved. Includes a reference implementation of the following:
+
+* John M. Boyer. "Subgraph Homeomorphism via the Edge Addition Planarity Algorithm".
+  Journal of Graph Algorithms and Applications, Vol. 16, no. 2, pp. 381-410, 2012.
+  http://www.jgaa.info/16/268.html
+
+* John M. Boyer. "A New Method for Efficiently Generating Planar Graph
+  Visibility Representations". In P. Eades and P. Healy, editors,
+  Proceedings of the 13th International Conference on Graph Drawing 2005,
+  Lecture Notes Comput. Sci., Volume 3843, pp. 508-511, Springer-Verlag, 2006.
+
+* John M. Boyer and Wendy J. Myrvold. "On the Cutting Edge: Simplified O(n)
+  Planarity by Edge Addition". Journal of Graph Algorithms and Applications,
+  Vol. 8, No. 3, pp. 241-273, 2004.
+  http://www.jgaa.info/08/91.html
+
+* John M. Boyer. "Simplified O(n) Algorithms for Planar Graph Embedding,
+  Kuratowski Subgraph Isolation, and Related Problems". Ph.D. Dissertation,
+  University of Victoria, 2001.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+* Redistributions of source code must retain the above copyright notice, this
+  list of conditions and the following disclaimer.
+
+* Redistributions in binary form must reproduce the above copyright notice, this
+  list of conditions and the following disclaimer in the documentation and/or
+  other materials provided with the distribution.
+
+* Neither the name of the Planarity-Related Graph Algorithms Project nor the names
+  of its contributors may be used to endorse or promote products derived from this
+  software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include <stdlib.h>
+
+#include "graph.h"
+
+/* Imported functions */
+
+extern int  _CopyBaseGraph(graphP dstGraph, graphP srcGraph);
+extern void _DeletePreprocessedBackEdge(graphP theGraph, int e);
+
+/* Private functions */
+
+graphP _NewObstructionWorkGraph(graphP theGraph);
+graphP _NewObstructionGraph(graphP workGraph);
+void _DeleteObstructionEdges(graphP srcGraph, graphP workGraph);
+int  _DeleteObstructionBackEdge(graphP srcGraph, graphP workGraph);
+
+/********************************************************************
+ gp_FindObstructions()
+
+ Finds up to k obstructions to embedding theGraph, where embedFlags is
+ EMBEDFLAGS_PLANAR for Kuratowski subgraphs or EMBEDFLAGS_OUTERPLANAR
+ for K4 and K2,3 homeomorphs.  Each obstruction is returned in
+ obstructions[0] to obstructions[*pNumFound - 1] as a new graph with
+ the vertices of theGraph and only the edges of the obstruction, sized
+ to those edges, and the caller must gp_Free() each of them.  Fewer
+ than k are found if the graph becomes embeddable first.  theGraph is
+ not changed.
+
+ After each obstruction is isolated, edges of it are deleted from the
+ graph so that the next embedding finds another one:
+
+ FINDOBSTRUCTIONS_DISTINCT deletes one edge that is not in the DFS
+ tree, which every obstruction has since it contains a cycle, so each
+ obstruction differs from all those found before.  The DFS tree stays
+ valid, so the graph is preprocessed only once, and deleting a back
+ edge only updates the least ancestor of its descendant endpoint and
+ the lowpoints of the ancestors that depended on it.  Each obstruction
+ after the first then costs one embedding from the preprocessed graph,
+ without the DFS, the vertex sort or the lowpoint computation, which
+ take most of the time of the embedding initialization.
+
+ FINDOBSTRUCTIONS_EDGEDISJOINT deletes all edges of the obstruction,
+ so the obstructions are edge-disjoint.  This breaks the DFS tree, so
+ each obstruction costs a full embedding.
+
+ Returns OK with *pNumFound set, or NOTOK on internal error or if the
+ embedFlags or findFlags are not supported.
+ ********************************************************************/
+
+int  gp_FindObstructions(graphP theGraph, int embedFlags, int findFlags, int k,
+                         graphP *obstructions, int *pNumFound)
+{
+graphP srcGraph = NULL, workGraph = NULL;
+int  Result, RetVal = OK;
+
+    if (theGraph == NULL || obstructions == NULL || pNumFound == NULL)
+        return NOTOK;
+
+    *pNumFound = 0;
+
+    if ((embedFlags != EMBEDFLAGS_PLANAR && embedFlags != EMBEDFLAGS_OUTERPLANAR) ||
+        (findFlags != FINDOBSTRUCTIONS_DISTINCT && findFlags != FINDOBSTRUCTIONS_EDGEDISJOINT))
+        return NOTOK;
+
+    // The source graph holds theGraph less the deleted edges, and it is
+    // copied into the work graph for each embedding.  Neither has any
+    // extensions, so the core embedder is used.
+    if ((srcGraph = _NewObstructionWorkGraph(theGraph)) == NULL ||
+        (workGraph = _NewObstructionWorkGraph(theGraph)) == NULL ||
+        (findFlags == FINDOBSTRUCTIONS_DISTINCT &&
+         gp_PreprocessForEmbedding(srcGraph) != OK))
+        RetVal = NOTOK;
+
+    while (RetVal == OK && *pNumFound < k)
+    {
+        // The work graph has no extensions to reinitialize, so the base
+        // graph copy suffices, as for gp_CopyPreprocessedGraph()
+        if (_CopyBaseGraph(workGraph, srcGraph) != OK)
+        {
+            RetVal = NOTOK;
+            break;
+        }
+
+        Result = embedFlags == EMBEDFLAGS_PLANAR ? gp_EmbedPlanar(workGraph)
+                                                 : gp_EmbedOuterplanar(workGraph);
+        if (Result != NONEMBEDDABLE)
+        {
+            if (Result != OK)
+                RetVal = NOTOK;
+            break;
+        }
+
+        if ((obstructions[*pNumFound] = _NewObstructionGraph(workGraph)) == NULL)
+        {
+            RetVal = NOTOK;
+            break;
+        }
+        (*pNumFound)++;
+
+        if (findFlags == FINDOBSTRUCTIONS_EDGEDISJOINT)
+            _DeleteObstructionEdges(srcGraph, workGraph);
+        else
+            RetVal = _DeleteObstructionBackEdge(srcGraph, workGraph);
+    }
+
+    gp_Free(&srcGraph);
+    gp_Free(&workGraph);
+
+    if (RetVal != OK)
+    {
+        while (*pNumFound > 0)
+            gp_Free(&obstructions[--(*pNumFound)]);
+    }
+
+    return RetVal;
+}
+
+/********************************************************************
+ _NewObstructionWorkGraph()
+
+ Returns a new graph with the vertices and edges of theGraph, but not
+ its extensions, or NULL on failure.
+ ********************************************************************/
+
+graphP _NewObstructionWorkGraph(graphP theGraph)
+{
+graphP newGraph;
+
+    if ((newGraph = gp_New()) == NULL)
+        return NULL;
+
+    if (gp_EnsureArcCapacity(newGraph, theGraph->arcCapacity) != OK ||
+        gp_InitGraph(newGraph, theGraph->N) != OK ||
+        _CopyBaseGraph(newGraph, theGraph) != OK)
+        gp_Free(&newGraph);
+
+    return newGraph;
+}
+
+/********************************************************************
+ _NewObstructionGraph()
+
+ Returns a new graph with the vertices of workGraph, numbered as in
+ the input graph, and the edges that remain in workGraph after it was
+ reduced to an obstruction, or NULL on failure.
+ ********************************************************************/
+
+graphP _NewObstructionGraph(graphP workGraph)
+{
+graphP newGraph;
+int  e, EsizeOccupied = gp_EdgeInUseIndexBound(workGraph);
+
+    if ((newGraph = gp_New()) == NULL)
+        return NULL;
+
+    if (gp_EnsureArcCapacity(newGraph, 2*workGraph->M) != OK ||
+        gp_InitGraph(newGraph, workGraph->N) != OK)
+    {
+        gp_Free(&newGraph);
+        return NULL;
+    }
+
+    for (e = gp_GetFirstEdge(workGraph); e < EsizeOccupied; e += 2)
+    {
+        if (gp_EdgeInUse(workGraph, e) &&
+            gp_AddEdge(newGraph, gp_GetVertexIndex(workGraph, gp_GetNeighbor(workGraph, e)), 0,
+                                 gp_GetVertexIndex(workGraph, gp_GetNeighbor(workGraph, gp_GetTwinArc(workGraph, e))), 0) != OK)
+        {
+            gp_Free(&newGraph);
+            return NULL;
+        }
+    }
+
+    return newGraph;
+}
+
+/********************************************************************
+ _DeleteObstructionEdges()
+
+ Deletes from srcGraph each edge that remains in workGraph, which
+ holds an obstruction.  The work graph is copied from srcGraph and
+ edges are never moved, so an edge has the same index in both graphs.
+ ********************************************************************/
+
+void _DeleteObstructionEdges(graphP srcGraph, graphP workGraph)
+{
+int  e, EsizeOccupied = gp_EdgeInUseIndexBound(workGraph);
+
+    for (e = gp_GetFirstEdge(workGraph); e < EsizeOccupied; e += 2)
+    {
+        if (gp_EdgeInUse(workGraph, e))
+            gp_DeleteEdge(srcGraph, e, 0);
+    }
+}
+
+/********************************************************************
+ _DeleteObstructionBackEdge()
+
+ Deletes from the preprocessed srcGraph the first edge of the
+ obstruction in workGraph that is not a DFS tree edge of srcGraph.
+
+ Returns OK, or NOTOK if the obstruction has no such edge.
+ ********************************************************************/
+
+int  _DeleteObstructionBackEdge(graphP srcGraph, graphP workGraph)
+{
+int  e, type, EsizeOccupied = gp_EdgeInUseIndexBound(workGraph);
+
+    for (e = gp_GetFirstEdge(workGraph); e < EsizeOccupied; e += 2)
+    {
+        if (!gp_EdgeInUse(workGraph, e))
+            continue;
+
+        type = gp_GetEdgeType(srcGraph, e);
+        if (type == EDGE_TYPE_BACK || type == EDGE_TYPE_FORWARD)
+        {
+            _DeletePreprocessedBackEdge(srcGraph, type == EDGE_TYPE_BACK ? e : gp_GetTwinArc(srcGraph, e));
+            return OK;
+        }
+    }
+
+    return NOTOK;
+}
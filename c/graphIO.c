@@ -49,6 +49,7 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 #include <stdlib.h>
 #include <string.h>
+#include <limits.h>
 
 #include "graph.h"
 
@@ -56,10 +57,44 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 int  _ReadAdjMatrix(graphP theGraph, FILE *Infile);
 int  _ReadAdjList(graphP theGraph, FILE *Infile);
+int  _ReadAddEdge(graphP theGraph, int u, int v);
 int  _WriteAdjList(graphP theGraph, FILE *Outfile);
 int  _WriteAdjMatrix(graphP theGraph, FILE *Outfile);
 int  _WriteDebugInfo(graphP theGraph, FILE *Outfile);
 
+/********************************************************************
+ _ReadAddEdge()
+ Adds the edge (u, v) to a graph being read.  The number of edges is
+ not known in advance, so if the arc capacity of the graph has been
+ reached, then it is doubled, up to the largest even capacity whose
+ edge indices fit in an int (maxArcCapacity below).  This grows
+ the edge storage of the graph and its extensions geometrically, and
+ large edge arrays grow without their content being copied (see
+ platform_ResizeMemory()).
+
+ Returns: OK on success, NOTOK on internal error, including failure to
+          allocate the larger arc capacity, NONEMBEDDABLE if the arc
+          capacity is already maxArcCapacity and is reached
+ ********************************************************************/
+
+int  _ReadAddEdge(graphP theGraph, int u, int v)
+{
+int  maxArcCapacity = (INT_MAX - gp_GetFirstEdge(theGraph)) & ~1;
+int  newArcCapacity;
+
+     if (theGraph->M >= theGraph->arcCapacity/2)
+     {
+         newArcCapacity = theGraph->arcCapacity > maxArcCapacity/2 ? maxArcCapacity
+                                                                   : 2*theGraph->arcCapacity;
+
+         if (newArcCapacity > theGraph->arcCapacity &&
+             gp_EnsureArcCapacity(theGraph, newArcCapacity) != OK)
+             return NOTOK;
+     }
+
+     return gp_AddEdge(theGraph, u, 0, v, 0);
+}
+
 /********************************************************************
  _ReadAdjMatrix()
  This function reads the undirected graph in upper triangular matrix format.
@@ -86,7 +121,7 @@ int _ReadAdjMatrix(graphP theGraph, FILE *Infile)
               fscanf(Infile, " %1d", &Flag);
               if (Flag)
               {
-                  if (gp_AddEdge(theGraph, v, 0, w, 0) != OK)
+                  if (_ReadAddEdge(theGraph, v, w) != OK)
                	      return NOTOK;
               }
          }
@@ -215,7 +250,7 @@ int  _ReadAdjList(graphP theGraph, FILE *Infile)
              // then we'll add an undirected edge for now
              else if (v < W)
              {
-             	 if ((ErrorCode = gp_AddEdge(theGraph, v, 0, W, 0)) != OK)
+             	 if ((ErrorCode = _ReadAddEdge(theGraph, v, W)) != OK)
              		 return ErrorCode;
              }
 
@@ -249,7 +284,7 @@ int  _ReadAdjList(graphP theGraph, FILE *Infile)
             	 else
             	 {
             		 // It is added as the new first arc in both vertices
-                	 if ((ErrorCode = gp_AddEdge(theGraph, v, 0, W, 0)) != OK)
+                	 if ((ErrorCode = _ReadAddEdge(theGraph, v, W)) != OK)
                 		 return ErrorCode;
 
 					 // Note that this call also sets OUTONLY on the twin arc
@@ -328,7 +363,7 @@ int  _ReadLEDAGraph(graphP theGraph, FILE *Infile)
         sscanf(Line, " %d %d", &u, &v);
         if (u != v && !gp_IsNeighbor(theGraph, u-zeroBasedOffset, v-zeroBasedOffset))
         {
-             if ((ErrorCode = gp_AddEdge(theGraph, u-zeroBasedOffset, 0, v-zeroBasedOffset, 0)) != OK)
+             if ((ErrorCode = _ReadAddEdge(theGraph, u-zeroBasedOffset, v-zeroBasedOffset)) != OK)
                  return ErrorCode;
         }
     }
@@ -729,69 +764,3 @@ int  _WritePostprocess(graphP theGraph, void **pExtraData, long *pExtraDataSize)
 {
      return OK;
 }
-
-/********************************************************************
- _Log()
-
- When the project is compiled with LOGGING enabled, this method writes
- a string to the file PLANARITY.LOG in the current working directory.
- On first write, the file is created or cleared.
- Call this method with NULL to close the log file.
- ********************************************************************/
-
-void _Log(char *Str)
-{
-static FILE *logfile = NULL;
-
-    if (logfile == NULL)
-    {
-        if ((logfile = fopen("PLANARITY.LOG", WRITETEXT)) == NULL)
-        	return;
-    }
-
-    if (Str != NULL)
-    {
-        fprintf(logfile, "%s", Str);
-        fflush(logfile);
-    }
-    else
-        fclose(logfile);
-}
-
-void _LogLine(char *Str)
-{
-	_Log(Str);
-	_Log("\n");
-}
-
-static char LogStr[512];
-
-char *_MakeLogStr1(char *format, int one)
-{
-	sprintf(LogStr, format, one);
-	return LogStr;
-}
-
-char *_MakeLogStr2(char *format, int one, int two)
-{
-	sprintf(LogStr, format, one, two);
-	return LogStr;
-}
-
-char *_MakeLogStr3(char *format, int one, int two, int three)
-{
-	sprintf(LogStr, format, one, two, three);
-	return LogStr;
-}
-
-char *_MakeLogStr4(char *format, int one, int two, int three, int four)
-{
-	sprintf(LogStr, format, one, two, three, four);
-	return LogStr;
-}
-
-char *_MakeLogStr5(char *format, int one, int two, int three, int four, int five)
-{
-	sprintf(LogStr, format, one, two, three, four, five);
-	return LogStr;
-}
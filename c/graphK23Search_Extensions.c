@@ -187,7 +187,7 @@ int  _K23Search_HandleBlockedBicomp(graphP theGraph, int v, int RootVertex, int
     else
     {
         K23SearchContext *context = NULL;
-        gp_FindExtension(theGraph, K23SEARCH_ID, (void *)&context);
+        context = (K23SearchContext *) gp_GetExtensionContext(theGraph, K23SEARCH_ID);
 
         if (context != NULL)
         {
@@ -214,7 +214,7 @@ int  _K23Search_EmbedPostprocess(graphP theGraph, int v, int edgeEmbeddingResult
      else
      {
         K23SearchContext *context = NULL;
-        gp_FindExtension(theGraph, K23SEARCH_ID, (void *)&context);
+        context = (K23SearchContext *) gp_GetExtensionContext(theGraph, K23SEARCH_ID);
 
         if (context != NULL)
         {
@@ -239,7 +239,7 @@ int  _K23Search_CheckEmbeddingIntegrity(graphP theGraph, graphP origGraph)
      else
      {
         K23SearchContext *context = NULL;
-        gp_FindExtension(theGraph, K23SEARCH_ID, (void *)&context);
+        context = (K23SearchContext *) gp_GetExtensionContext(theGraph, K23SEARCH_ID);
 
         if (context != NULL)
         {
@@ -279,7 +279,7 @@ int  _K23Search_CheckObstructionIntegrity(graphP theGraph, graphP origGraph)
      else
      {
         K23SearchContext *context = NULL;
-        gp_FindExtension(theGraph, K23SEARCH_ID, (void *)&context);
+        context = (K23SearchContext *) gp_GetExtensionContext(theGraph, K23SEARCH_ID);
 
         if (context != NULL)
         {
@@ -61,6 +61,8 @@ extern "C" {
 int gp_AttachK33Search(graphP theGraph);
 int gp_DetachK33Search(graphP theGraph);
 
+int gp_EmbedK33(graphP theGraph);
+
 #ifdef __cplusplus
 }
 #endif
@@ -61,6 +61,11 @@ extern int  _getImageVertices(graphP theGraph, int *degrees, int maxDegree,
                               int *imageVerts, int maxNumImageVerts);
 extern int  _TestSubgraph(graphP theSubgraph, graphP theGraph);
 
+extern void _WalkUp(graphP theGraph, int v, int e);
+extern int  _WalkDown(graphP theGraph, int v, int RootVertex);
+extern int  _HandleInactiveVertex(graphP theGraph, int BicompRoot, int *pW, int *pWPrevLink);
+extern void _AdvanceFwdArcList(graphP theGraph, int v, int child, int nextChild);
+
 /* Forward declarations of local functions */
 
 void _K33Search_ClearStructures(K33SearchContext *context);
@@ -190,6 +195,82 @@ int gp_DetachK33Search(graphP theGraph)
     return gp_RemoveExtension(theGraph, K33SEARCH_ID);
 }
 
+/********************************************************************
+ K3,3 search embedder instantiation
+
+ A copy of the embedder whose hooks call the K3,3 search overloads
+ and the core functions they sit on directly.  The overloads that
+ defer to the base algorithm still do so through the context's
+ function table.  The bicomp merge is not instantiated because the
+ K3,3 search overload of it is called instead.
+ ********************************************************************/
+
+#define EMBED_TEMPLATE_STORAGE          static
+#define EMBED_TEMPLATE_EMBED            _K33Search_Embed
+#define EMBED_TEMPLATE_WALKDOWN         _K33Search_WalkDown
+#define EMBED_TEMPLATE_OUTERPLANAR(theGraph) 0
+
+#define EMBED_HOOK_EMBEDDINGINITIALIZE(theGraph) \
+        _K33Search_EmbeddingInitialize(theGraph)
+#define EMBED_HOOK_WALKUP(theGraph, v, e) \
+        _WalkUp(theGraph, v, e)
+#define EMBED_HOOK_WALKDOWN(theGraph, v, RootVertex) \
+        _K33Search_WalkDown(theGraph, v, RootVertex)
+#define EMBED_HOOK_MERGEBICOMPS(theGraph, v, RootVertex, W, WPrevLink) \
+        _K33Search_MergeBicomps(theGraph, v, RootVertex, W, WPrevLink)
+#define EMBED_HOOK_EMBEDBACKEDGETODESCENDANT(theGraph, RootSide, RootVertex, W, WPrevLink) \
+        _K33Search_EmbedBackEdgeToDescendant(theGraph, RootSide, RootVertex, W, WPrevLink)
+#define EMBED_HOOK_HANDLEBLOCKEDBICOMP(theGraph, v, RootVertex, R) \
+        _K33Search_HandleBlockedBicomp(theGraph, v, RootVertex, R)
+#define EMBED_HOOK_HANDLEINACTIVEVERTEX(theGraph, BicompRoot, pW, pWPrevLink) \
+        _HandleInactiveVertex(theGraph, BicompRoot, pW, pWPrevLink)
+#define EMBED_HOOK_EMBEDPOSTPROCESS(theGraph, v, edgeEmbeddingResult) \
+        _K33Search_EmbedPostprocess(theGraph, v, edgeEmbeddingResult)
+
+static int _K33Search_WalkDown(graphP theGraph, int v, int RootVertex);
+
+#include "graphEmbed.template.h"
+
+/********************************************************************
+ gp_EmbedK33()
+
+ Equivalent to gp_Embed(theGraph, EMBEDFLAGS_SEARCHFORK33), but with
+ the embedder hooks bound at compile time.  The K3,3 search feature
+ must already be attached.
+
+ The function table is checked once per call.  If another extension
+ attached after this one has overloaded any embedder function, then
+ the call is passed on to gp_Embed() so that it behaves exactly as it
+ would otherwise.
+
+ Returns the same values as gp_Embed() with EMBEDFLAGS_SEARCHFORK33,
+         or NOTOK if the K3,3 search feature is not attached.
+ ********************************************************************/
+
+int gp_EmbedK33(graphP theGraph)
+{
+    K33SearchContext *context = NULL;
+
+    if (theGraph == NULL)
+        return NOTOK;
+
+    gp_FindExtension(theGraph, K33SEARCH_ID, (void *)&context);
+    if (context == NULL)
+        return NOTOK;
+
+    if (theGraph->functions.fpEmbeddingInitialize != _K33Search_EmbeddingInitialize ||
+        theGraph->functions.fpWalkUp != _WalkUp ||
+        theGraph->functions.fpWalkDown != _WalkDown ||
+        theGraph->functions.fpMergeBicomps != _K33Search_MergeBicomps ||
+        theGraph->functions.fpEmbedBackEdgeToDescendant != _K33Search_EmbedBackEdgeToDescendant ||
+        theGraph->functions.fpHandleBlockedBicomp != _K33Search_HandleBlockedBicomp ||
+        theGraph->functions.fpHandleInactiveVertex != _HandleInactiveVertex ||
+        theGraph->functions.fpEmbedPostprocess != _K33Search_EmbedPostprocess)
+        return gp_Embed(theGraph, EMBEDFLAGS_SEARCHFORK33);
+
+    return _K33Search_Embed(theGraph, EMBEDFLAGS_SEARCHFORK33);
+}
+
 /********************************************************************
  _K33Search_ClearStructures()
  ********************************************************************/
@@ -201,6 +282,7 @@ void _K33Search_ClearStructures(K33SearchContext *context)
         // Before initialization, the pointers are stray, not NULL
         // Once NULL or allocated, free() or LCFree() can do the job
         context->E = NULL;
+        platform_InitMemory(&context->EMemory);
         context->VI = NULL;
 
         context->separatedDFSChildLists = NULL;
@@ -211,11 +293,8 @@ void _K33Search_ClearStructures(K33SearchContext *context)
     }
     else
     {
-        if (context->E != NULL)
-        {
-            free(context->E);
-            context->E = NULL;
-        }
+        platform_FreeMemory(&context->EMemory);
+        context->E = NULL;
         if (context->VI != NULL)
         {
             free(context->VI);
@@ -245,7 +324,7 @@ int  _K33Search_CreateStructures(K33SearchContext *context)
      if (context->theGraph->N <= 0)
          return NOTOK;
 
-     if ((context->E = (K33Search_EdgeRecP) malloc(Esize*sizeof(K33Search_EdgeRec))) == NULL ||
+     if ((context->E = (K33Search_EdgeRecP) platform_AllocMemory(&context->EMemory, Esize*sizeof(K33Search_EdgeRec))) == NULL ||
          (context->VI = (K33Search_VertexInfoP) malloc(VIsize*sizeof(K33Search_VertexInfo))) == NULL ||
 		 (context->separatedDFSChildLists = LCNew(VIsize)) == NULL ||
 		 (context->buckets = (int *) malloc(VIsize * sizeof(int))) == NULL ||
@@ -290,7 +369,7 @@ int  _K33Search_InitStructures(K33SearchContext *context)
 int  _K33Search_InitGraph(graphP theGraph, int N)
 {
     K33SearchContext *context = NULL;
-    gp_FindExtension(theGraph, K33SEARCH_ID, (void *)&context);
+    context = (K33SearchContext *) gp_GetExtensionContext(theGraph, K33SEARCH_ID);
 
     if (context == NULL)
         return NOTOK;
@@ -315,7 +394,7 @@ int  _K33Search_InitGraph(graphP theGraph, int N)
 void _K33Search_ReinitializeGraph(graphP theGraph)
 {
     K33SearchContext *context = NULL;
-    gp_FindExtension(theGraph, K33SEARCH_ID, (void *)&context);
+    context = (K33SearchContext *) gp_GetExtensionContext(theGraph, K33SEARCH_ID);
 
     if (context != NULL)
     {
@@ -330,17 +409,36 @@ void _K33Search_ReinitializeGraph(graphP theGraph)
 }
 
 /********************************************************************
- The current implementation does not support an increase of arc
- (edge record) capacity once the extension is attached to the graph
- data structure.  This is only due to not being necessary to support.
- For now, it is easy to ensure the correct capacity before attaching
- the extension, but support could be added later if there is some
- reason to do so.
+ _K33Search_EnsureArcCapacity()
+ Grows the extension's edge records along with those of the graph.
+ The existing edge records keep their content, and the new ones are
+ initialized.
  ********************************************************************/
 
 int  _K33Search_EnsureArcCapacity(graphP theGraph, int requiredArcCapacity)
 {
-	return NOTOK;
+    K33SearchContext *context = NULL;
+    int e, Esize, newEsize;
+
+    context = (K33SearchContext *) gp_GetExtensionContext(theGraph, K33SEARCH_ID);
+
+    if (context == NULL)
+        return NOTOK;
+
+    Esize = gp_EdgeIndexBound(theGraph);
+    newEsize = gp_GetFirstEdge(theGraph) + requiredArcCapacity;
+
+    if (platform_ResizeMemory(&context->EMemory, newEsize*sizeof(K33Search_EdgeRec)) == NULL)
+        return NOTOK;
+    context->E = (K33Search_EdgeRecP) context->EMemory.ptr;
+
+    if (context->functions.fpEnsureArcCapacity(theGraph, requiredArcCapacity) != OK)
+        return NOTOK;
+
+    for (e = Esize; e < newEsize; e++)
+        _K33Search_InitEdgeRec(context, e);
+
+    return OK;
 }
 
 /********************************************************************
@@ -404,7 +502,7 @@ void _K33Search_FreeContext(void *pContext)
 int  _K33Search_EmbeddingInitialize(graphP theGraph)
 {
     K33SearchContext *context = NULL;
-    gp_FindExtension(theGraph, K33SEARCH_ID, (void *)&context);
+    context = (K33SearchContext *) gp_GetExtensionContext(theGraph, K33SEARCH_ID);
 
     if (context != NULL)
     {
@@ -530,7 +628,7 @@ int v, L, DFSParent, theList;
 void _K33Search_EmbedBackEdgeToDescendant(graphP theGraph, int RootSide, int RootVertex, int W, int WPrevLink)
 {
     K33SearchContext *context = NULL;
-    gp_FindExtension(theGraph, K33SEARCH_ID, (void *)&context);
+    context = (K33SearchContext *) gp_GetExtensionContext(theGraph, K33SEARCH_ID);
 
     if (context != NULL)
     {
@@ -573,7 +671,7 @@ void _K33Search_EmbedBackEdgeToDescendant(graphP theGraph, int RootSide, int Roo
 int  _K33Search_MergeBicomps(graphP theGraph, int v, int RootVertex, int W, int WPrevLink)
 {
     K33SearchContext *context = NULL;
-    gp_FindExtension(theGraph, K33SEARCH_ID, (void *)&context);
+    context = (K33SearchContext *) gp_GetExtensionContext(theGraph, K33SEARCH_ID);
 
     if (context != NULL)
     {
@@ -628,7 +726,7 @@ int  _K33Search_MergeBicomps(graphP theGraph, int v, int RootVertex, int W, int
 void _K33Search_MergeVertex(graphP theGraph, int W, int WPrevLink, int R)
 {
     K33SearchContext *context = NULL;
-    gp_FindExtension(theGraph, K33SEARCH_ID, (void *)&context);
+    context = (K33SearchContext *) gp_GetExtensionContext(theGraph, K33SEARCH_ID);
 
     if (context != NULL)
     {
@@ -669,7 +767,7 @@ int  _K33Search_HandleBlockedBicomp(graphP theGraph, int v, int RootVertex, int
 {
 	K33SearchContext *context = NULL;
 
-	gp_FindExtension(theGraph, K33SEARCH_ID, (void *)&context);
+	context = (K33SearchContext *) gp_GetExtensionContext(theGraph, K33SEARCH_ID);
 	if (context == NULL)
 		return NOTOK;
 
@@ -712,7 +810,7 @@ int  _K33Search_EmbedPostprocess(graphP theGraph, int v, int edgeEmbeddingResult
      else
      {
         K33SearchContext *context = NULL;
-        gp_FindExtension(theGraph, K33SEARCH_ID, (void *)&context);
+        context = (K33SearchContext *) gp_GetExtensionContext(theGraph, K33SEARCH_ID);
 
         if (context != NULL)
         {
@@ -737,7 +835,7 @@ int  _K33Search_CheckEmbeddingIntegrity(graphP theGraph, graphP origGraph)
      else
      {
         K33SearchContext *context = NULL;
-        gp_FindExtension(theGraph, K33SEARCH_ID, (void *)&context);
+        context = (K33SearchContext *) gp_GetExtensionContext(theGraph, K33SEARCH_ID);
 
         if (context != NULL)
         {
@@ -781,7 +879,7 @@ int  _K33Search_CheckObstructionIntegrity(graphP theGraph, graphP origGraph)
      else
      {
         K33SearchContext *context = NULL;
-        gp_FindExtension(theGraph, K33SEARCH_ID, (void *)&context);
+        context = (K33SearchContext *) gp_GetExtensionContext(theGraph, K33SEARCH_ID);
 
         if (context != NULL)
         {
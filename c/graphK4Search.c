@@ -137,7 +137,7 @@ isolatorContextP IC = &theGraph->IC;
 
 	if (context == NULL)
 	{
-		gp_FindExtension(theGraph, K4SEARCH_ID, (void *)&context);
+		context = (K4SearchContext *) gp_GetExtensionContext(theGraph, K4SEARCH_ID);
 		if (context == NULL)
 			return NOTOK;
 	}
@@ -1235,7 +1235,7 @@ int  _K4_DeleteUnmarkedEdgesInPathComponent(graphP theGraph, int R, int prevLink
 {
 	int Z, ZPrevLink, e;
     K4SearchContext *context = NULL;
-    gp_FindExtension(theGraph, K4SEARCH_ID, (void *)&context);
+    context = (K4SearchContext *) gp_GetExtensionContext(theGraph, K4SEARCH_ID);
 
     if (context == NULL)
     	return NOTOK;
@@ -85,8 +85,10 @@ typedef struct
     // The graph that this context augments
     graphP theGraph;
 
-    // Parallel array for additional edge level equipment
+    // Parallel array for additional edge level equipment, and the
+    // memory that holds it so that it can grow with the arc capacity
     K4Search_EdgeRecP E;
+    platform_memory EMemory;
 
     // Overloaded function pointers
     graphFunctionTable functions;
@@ -189,6 +189,7 @@ void _K4Search_ClearStructures(K4SearchContext *context)
         // Before initialization, the pointers are stray, not NULL
         // Once NULL or allocated, free() or LCFree() can do the job
         context->E = NULL;
+        platform_InitMemory(&context->EMemory);
 
         context->handlingBlockedBicomp = FALSE;
 
@@ -196,11 +197,8 @@ void _K4Search_ClearStructures(K4SearchContext *context)
     }
     else
     {
-        if (context->E != NULL)
-        {
-            free(context->E);
-            context->E = NULL;
-        }
+        platform_FreeMemory(&context->EMemory);
+        context->E = NULL;
         context->handlingBlockedBicomp = FALSE;
     }
 }
@@ -217,7 +215,7 @@ int  _K4Search_CreateStructures(K4SearchContext *context)
      if (context->theGraph->N <= 0)
          return NOTOK;
 
-     if ((context->E = (K4Search_EdgeRecP) malloc(Esize*sizeof(K4Search_EdgeRec))) == NULL ||
+     if ((context->E = (K4Search_EdgeRecP) platform_AllocMemory(&context->EMemory, Esize*sizeof(K4Search_EdgeRec))) == NULL ||
         0)
      {
          return NOTOK;
@@ -250,7 +248,7 @@ int  _K4Search_InitStructures(K4SearchContext *context)
 int  _K4Search_InitGraph(graphP theGraph, int N)
 {
     K4SearchContext *context = NULL;
-    gp_FindExtension(theGraph, K4SEARCH_ID, (void *)&context);
+    context = (K4SearchContext *) gp_GetExtensionContext(theGraph, K4SEARCH_ID);
 
     if (context == NULL)
         return NOTOK;
@@ -275,7 +273,7 @@ int  _K4Search_InitGraph(graphP theGraph, int N)
 void _K4Search_ReinitializeGraph(graphP theGraph)
 {
     K4SearchContext *context = NULL;
-    gp_FindExtension(theGraph, K4SEARCH_ID, (void *)&context);
+    context = (K4SearchContext *) gp_GetExtensionContext(theGraph, K4SEARCH_ID);
 
     if (context != NULL)
     {
@@ -288,17 +286,36 @@ void _K4Search_ReinitializeGraph(graphP theGraph)
 }
 
 /********************************************************************
- The current implementation does not support an increase of arc
- (edge record) capacity once the extension is attached to the graph
- data structure.  This is only due to not being necessary to support.
- For now, it is easy to ensure the correct capacity before attaching
- the extension, but support could be added later if there is some
- reason to do so.
+ _K4Search_EnsureArcCapacity()
+ Grows the extension's edge records along with those of the graph.
+ The existing edge records keep their content, and the new ones are
+ initialized.
  ********************************************************************/
 
 int  _K4Search_EnsureArcCapacity(graphP theGraph, int requiredArcCapacity)
 {
-	return NOTOK;
+    K4SearchContext *context = NULL;
+    int e, Esize, newEsize;
+
+    context = (K4SearchContext *) gp_GetExtensionContext(theGraph, K4SEARCH_ID);
+
+    if (context == NULL)
+        return NOTOK;
+
+    Esize = gp_EdgeIndexBound(theGraph);
+    newEsize = gp_GetFirstEdge(theGraph) + requiredArcCapacity;
+
+    if (platform_ResizeMemory(&context->EMemory, newEsize*sizeof(K4Search_EdgeRec)) == NULL)
+        return NOTOK;
+    context->E = (K4Search_EdgeRecP) context->EMemory.ptr;
+
+    if (context->functions.fpEnsureArcCapacity(theGraph, requiredArcCapacity) != OK)
+        return NOTOK;
+
+    for (e = Esize; e < newEsize; e++)
+        _K4Search_InitEdgeRec(context, e);
+
+    return OK;
 }
 
 /********************************************************************
@@ -368,7 +385,7 @@ int  _K4Search_HandleBlockedBicomp(graphP theGraph, int v, int RootVertex, int R
 {
 	K4SearchContext *context = NULL;
 
-	gp_FindExtension(theGraph, K4SEARCH_ID, (void *)&context);
+	context = (K4SearchContext *) gp_GetExtensionContext(theGraph, K4SEARCH_ID);
 	if (context == NULL)
 		return NOTOK;
 
@@ -460,7 +477,7 @@ int  _K4Search_EmbedPostprocess(graphP theGraph, int v, int edgeEmbeddingResult)
      else
      {
         K4SearchContext *context = NULL;
-        gp_FindExtension(theGraph, K4SEARCH_ID, (void *)&context);
+        context = (K4SearchContext *) gp_GetExtensionContext(theGraph, K4SEARCH_ID);
 
         if (context != NULL)
         {
@@ -485,7 +502,7 @@ int  _K4Search_CheckEmbeddingIntegrity(graphP theGraph, graphP origGraph)
      else
      {
         K4SearchContext *context = NULL;
-        gp_FindExtension(theGraph, K4SEARCH_ID, (void *)&context);
+        context = (K4SearchContext *) gp_GetExtensionContext(theGraph, K4SEARCH_ID);
 
         if (context != NULL)
         {
@@ -525,7 +542,7 @@ int  _K4Search_CheckObstructionIntegrity(graphP theGraph, graphP origGraph)
      else
      {
         K4SearchContext *context = NULL;
-        gp_FindExtension(theGraph, K4SEARCH_ID, (void *)&context);
+        context = (K4SearchContext *) gp_GetExtensionContext(theGraph, K4SEARCH_ID);
 
         if (context != NULL)
         {
@@ -0,0 +1,1705 @@
+/*
+Planarity-Related Graph Algorithms Project
+Copyright (c) 1997-2012, John M. Boyer
+All rights reserved. Includes a reference implementation of the following:
+
+* John M. Boyer. "Subgraph Homeomorphism via the Edge Addition Planarity Algorithm".
+  Journal of Graph Algorithms and Applications, Vol. 16, no. 2, pp. 381-410, 2012.
+  http://www.jgaa.info/16/268.html
+
+* John M. Boyer. "A New Method for Efficiently Generating Planar Graph
+  Visibility Representations". In P. Eades and P. Healy, editors,
+  Proceedings of the 13th International Conference on Graph Drawing 2005,
+  Lecture Notes Comput. Sci., Volume 3843, pp. 508-511, Springer-Verlag, 2006.
+
+* John M. Boyer and Wendy J. Myrvold. "On the Cutting Edge: Simplified O(n)
+  Planarity by Edge Addition". Journal of Graph Algorithms and Applications,
+  Vol. 8, No. 3, pp. 241-273, 2004.
+  http://www.jgaa.info/08/91.html
+
+* John M. Boyer. "Simplified O(n) Algorithms for Planar Graph Embedding,
+  Kuratowski Subgraph Isolation, and Related Problems". Ph.D. Dissertation,
+  University of Victoria, 2001.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+* Redistributions of source code must retain the above copyright notice, this
+  list of conditions and the following disclaimer.
+
+* Redistributions in binary form must reproduce the above copyright notice, this
+  list of conditions and the following disclaimer in the documentation and/or
+  other materials provided with the distribution.
+
+* Neither the name of the Planarity-Related Graph Algorithms Project nor the names
+  of its contributors may be used to endorse or promote products derived from this
+  software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include "graphK5Search.h"
+#include "graphK5Search.private.h"
+#include "graphSPQRTree.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+/* Imported functions */
+
+extern void _InitEdges(graphP theGraph);
+
+/* Private definitions */
+
+// The states of the edges of a kernel during the search
+#define K5SEARCH_FREE       0
+#define K5SEARCH_REQUIRED   1
+#define K5SEARCH_DELETED    2
+
+// The memoization of failed kernels stops growing once the keys stored
+// reach this many integers
+#define K5SEARCH_MEMO_LIMIT (1L << 24)
+
+// The number of branches that the search may take before it restarts is
+// this unit times the next term of the Luby sequence
+#define K5SEARCH_RESTART_UNIT 256L
+
+// A kernel is a multigraph with vertices 1 to N and edges 1 to M, given
+// by their endpoints u and w.  The search marks edges as deleted or
+// required, and marks inK5 the edges of the K5 homeomorph it finds.
+// The origin of each vertex is the vertex of the input graph it came
+// from, so that kernels reached by different branches can be compared.
+typedef struct
+{
+    int N, M;
+    int *u, *w, *state, *inK5, *origin;
+} k5KernelRec;
+
+typedef k5KernelRec * k5KernelP;
+
+// The hash set of the keys of the kernels in which the search failed,
+// the number of branches taken so far, the limits on them for the whole
+// search and for the current restart, and whether a limit was reached
+typedef struct
+{
+    int **memo, memoSize, memoCount;
+    long memoInts;
+    long numBranches, branchLimit, restartLimit;
+    int limitReached;
+} k5SearchRec;
+
+typedef k5SearchRec * k5SearchP;
+
+// The reduction of a kernel K to the chains between its vertices of
+// degree at least 3.  Each chain is stored in the slot of one of the
+// edges of K that it contains.  A chain c has endpoints cu and cw, its
+// edges of K are linked from cfirst to clast by edgeNext, and creq tells
+// whether any of them is required.  The arcs 2c at cu and 2c+1 at cw are
+// kept in a doubly linked list at each vertex, and the live chains are
+// kept in a hash table by their endpoints to find parallel chains.
+typedef struct
+{
+    k5SearchP s;
+    k5KernelP K;
+    int *cu, *cw, *creq, *clive, *cfirst, *clast, *edgeNext;
+    int *firstArc, *arcNext, *arcPrev, *degree, *reqDegree;
+    int *hashHead, *hashNext, hashMask;
+    int *stack, *onStack, stackSize;
+    int *block, numBlocks, *vertexMap;
+    int pruned;
+} k5ReduceRec;
+
+typedef k5ReduceRec * k5ReduceP;
+
+#define K5SEARCH_ARCVERTEX(r, a) ((a) & 1 ? (r)->cw[(a) >> 1] : (r)->cu[(a) >> 1])
+
+/* Private functions exported to system */
+
+int  _CopyK5SearchGraph(K5SearchContext *context);
+int  _IsK5Homeomorph(graphP theGraph);
+int  _SearchForK5(K5SearchContext *context);
+
+/* Private functions */
+
+int  _K5Search_NewKernel(k5KernelP K, int N, int M);
+void _K5Search_FreeKernel(k5KernelP K);
+long _K5Search_Luby(int i);
+int  _K5Search_SearchPermuted(k5SearchP s, k5KernelP K, k5KernelP P, int *perm, int restart);
+int  _K5Search_Search(k5SearchP s, k5KernelP K);
+int  _K5Search_InitReduce(k5ReduceP r, k5SearchP s, k5KernelP K);
+void _K5Search_FreeReduce(k5ReduceP r);
+void _K5Search_Reduce(k5ReduceP r);
+void _K5Search_ReduceVertex(k5ReduceP r, int v);
+void _K5Search_RemoveFreeChains(k5ReduceP r, int v);
+void _K5Search_Push(k5ReduceP r, int v);
+void _K5Search_AddChain(k5ReduceP r, int c);
+void _K5Search_RemoveChain(k5ReduceP r, int c);
+int  _K5Search_FindChain(k5ReduceP r, int a, int b);
+int  _K5Search_Hash(k5ReduceP r, int a, int b);
+void _K5Search_CheckDegrees(k5ReduceP r);
+int  _K5Search_FindBlocks(k5ReduceP r);
+int  _K5Search_SearchBlock(k5ReduceP r, int theBlock);
+int  _K5Search_MakeKernel(k5ReduceP r, int theBlock, k5KernelP C, int **pChainOf);
+int  _K5Search_SearchTricomps(k5SearchP s, k5KernelP C);
+int  _K5Search_SearchRNode(k5SearchP s, k5KernelP C, graphP H, spqrTreeP T, int x, int *vertexMap);
+int  _K5Search_MarkVirtualEdge(k5KernelP C, graphP H, spqrTreeP T, int x, int k);
+int  _K5Search_Branch(k5SearchP s, k5KernelP C);
+graphP _K5Search_MakeGraph(k5KernelP C);
+int  _K5Search_TestKernel(k5KernelP C, int *inT, int *pIsK5);
+int *_K5Search_MakeKey(k5KernelP C);
+int  _K5Search_CompareKeyEdges(const void *edge1, const void *edge2);
+unsigned _K5Search_HashKey(int *key);
+int  _K5Search_MemoFind(k5SearchP s, int *key);
+void _K5Search_MemoAdd(k5SearchP s, int *key);
+void _K5Search_FreeMemo(k5SearchP s);
+int  _K5Search_Assemble(K5SearchContext *context, k5KernelP K, int found);
+
+/********************************************************************
+ _CopyK5SearchGraph()
+
+ Copies the preprocessed graph into context->origGraph, with the edges
+ numbered consecutively.  The back arcs have been moved from the
+ adjacency lists to the forward arc lists, but the neighbors of all
+ arcs are intact, so the edges are copied from the edge array.
+ ********************************************************************/
+
+int _CopyK5SearchGraph(K5SearchContext *context)
+{
+graphP theGraph = context->theGraph;
+int e, EsizeOccupied;
+
+    gp_Free(&context->origGraph);
+
+    if ((context->origGraph = gp_New()) == NULL ||
+        gp_EnsureArcCapacity(context->origGraph, theGraph->arcCapacity) != OK ||
+        gp_InitGraph(context->origGraph, theGraph->N) != OK)
+    {
+        gp_Free(&context->origGraph);
+        return NOTOK;
+    }
+
+    EsizeOccupied = gp_EdgeInUseIndexBound(theGraph);
+    for (e = gp_GetFirstEdge(theGraph); e < EsizeOccupied; e+=2)
+    {
+        if (gp_EdgeInUse(theGraph, e))
+        {
+            if (gp_AddEdge(context->origGraph, gp_GetNeighbor(theGraph, e), 0,
+                           gp_GetNeighbor(theGraph, gp_GetTwinArc(theGraph, e)), 0) != OK)
+            {
+                gp_Free(&context->origGraph);
+                return NOTOK;
+            }
+        }
+    }
+
+    return OK;
+}
+
+/********************************************************************
+ _IsK5Homeomorph()
+
+ theGraph contains a Kuratowski subgraph isolated by the core planarity
+ algorithm, which is a K5 homeomorph rather than a K3,3 homeomorph
+ exactly when it has five vertices of degree 4.
+ ********************************************************************/
+
+int _IsK5Homeomorph(graphP theGraph)
+{
+int v, numDegree4 = 0;
+
+    for (v = gp_GetFirstVertex(theGraph); gp_VertexInRange(theGraph, v); v++)
+    {
+        if (gp_GetVertexDegree(theGraph, v) == 4)
+            numDegree4++;
+    }
+
+    return numDegree4 == 5 ? TRUE : FALSE;
+}
+
+/********************************************************************
+ _SearchForK5()
+
+ theGraph contains a K3,3 homeomorph isolated by the core planarity
+ algorithm, and context->origGraph contains the input graph with the
+ same vertex numbering.  This function determines whether the input
+ graph has a subgraph homeomorphic to K5.
+
+ The search works on kernels, which are multigraphs whose edges stand
+ for paths of the input graph.  A kernel is first reduced in linear
+ time, in the manner of _ReduceBicomp() for the K3,3 search, by removing
+ the vertices of degree at most 1, by replacing the paths through
+ vertices of degree 2 with single edges, and by removing loops and all
+ but one of each set of parallel edges, none of which can be in a K5
+ homeomorph.  If fewer than five vertices of degree at least 4 remain,
+ then there is no K5 homeomorph.  Otherwise, the reduced kernel is split
+ into its blocks, since a K5 homeomorph is biconnected, and each block
+ is tested for planarity.  A planar block has no K5 homeomorph, and the
+ Kuratowski subgraph T isolated in a nonplanar block is either a K5
+ homeomorph, which ends the search, or a K3,3 homeomorph.  In the latter
+ case, a K5 homeomorph, having no K3,3 homeomorph as a subgraph, must
+ omit some edge of T, so the search branches on the first edge of T that
+ is omitted.  Branch i deletes edge i of T and requires edges 1 to i-1,
+ and the required edges let the reduction prune a branch early when
+ they cannot all be in a K5 homeomorph.  Different branches often
+ reduce to the same kernel, so the kernels in which the search fails
+ are memoized.
+
+ The reductions take linear time, so a graph is resolved in linear
+ time when it is planar, when the core planarity algorithm isolates a
+ K5 homeomorph, or when the reductions leave too few vertices of degree
+ at least 4, as for a K3,3 homeomorph or any graph of maximum degree 3.
+ Otherwise, the branching is exponential, so a block with no required
+ edges is first split into its triconnected components, and only the
+ R-nodes of its SPQR tree that could hold a K5 homeomorph are searched.
+
+ How quickly a K5 homeomorph is found depends heavily on which Kuratowski
+ subgraphs the core planarity algorithm happens to isolate, and so on the
+ order of the edges.  The search is therefore restarted with the edges
+ in a new pseudo-random order whenever it takes more branches than the
+ restart unit times the next term of the Luby sequence, which is within a
+ logarithmic factor of the best restart schedule for an unknown run time
+ distribution.  The memo of failed kernels is kept across restarts, since
+ a kernel is only memoized once it has been searched exhaustively, so the
+ restarts repeat little work when there is no K5 homeomorph.  The total
+ number of branches is limited by context->branchLimit.
+
+ Returns NONEMBEDDABLE with the K5 homeomorph in theGraph, OK with the
+ input graph restored in theGraph, K5SEARCH_LIMITREACHED with the input
+ graph restored in theGraph if the branch limit was reached, in which
+ case it is unknown whether the graph has a K5 homeomorph, or NOTOK on
+ internal error.
+ ********************************************************************/
+
+int _SearchForK5(K5SearchContext *context)
+{
+graphP G = context->origGraph;
+k5SearchRec s;
+k5KernelRec K, P;
+int *perm = NULL;
+int i, e, restart, RetVal;
+
+    if (G == NULL)
+        return NOTOK;
+
+    if (_K5Search_NewKernel(&K, G->N, G->M) != OK)
+    {
+        _K5Search_FreeKernel(&K);
+        return NOTOK;
+    }
+
+    for (i = 1; i <= K.N; i++)
+        K.origin[i] = i;
+
+    // Edge i of the kernel is the edge of origGraph with arcs e and e+1,
+    // since the edges of origGraph were added consecutively
+    for (i = 1; i <= K.M; i++)
+    {
+        e = gp_GetFirstEdge(G) + 2*(i-1);
+        K.u[i] = gp_GetNeighbor(G, gp_GetTwinArc(G, e));
+        K.w[i] = gp_GetNeighbor(G, e);
+    }
+
+    memset(&s, 0, sizeof(k5SearchRec));
+    memset(&P, 0, sizeof(k5KernelRec));
+    s.branchLimit = context->branchLimit;
+
+    for (restart = 1; ; restart++)
+    {
+        s.restartLimit = s.numBranches + K5SEARCH_RESTART_UNIT * _K5Search_Luby(restart);
+        s.limitReached = FALSE;
+
+        if (restart == 1)
+            RetVal = _K5Search_Search(&s, &K);
+        else
+            RetVal = _K5Search_SearchPermuted(&s, &K, &P, perm, restart);
+
+        if (RetVal != NOTOK || !s.limitReached ||
+            (s.branchLimit > 0 && s.numBranches >= s.branchLimit))
+            break;
+
+        if (restart == 1 &&
+            (_K5Search_NewKernel(&P, K.N, K.M) != OK ||
+             (perm = (int *) malloc((K.M+1) * sizeof(int))) == NULL))
+            break;
+    }
+
+    // Only the branch limit for the whole search makes the result
+    // undecided; any other NOTOK is an internal error
+    if (RetVal == NOTOK && s.limitReached &&
+        s.branchLimit > 0 && s.numBranches >= s.branchLimit)
+        RetVal = K5SEARCH_LIMITREACHED;
+
+    _K5Search_FreeMemo(&s);
+    _K5Search_FreeKernel(&P);
+    if (perm != NULL) free(perm);
+
+    if (RetVal != NOTOK)
+    {
+        if (_K5Search_Assemble(context, &K, RetVal == NONEMBEDDABLE) != OK)
+            RetVal = NOTOK;
+    }
+
+    _K5Search_FreeKernel(&K);
+    return RetVal;
+}
+
+/********************************************************************
+ _K5Search_NewKernel()
+ _K5Search_FreeKernel()
+ ********************************************************************/
+
+int  _K5Search_NewKernel(k5KernelP K, int N, int M)
+{
+    memset(K, 0, sizeof(k5KernelRec));
+
+    K->N = N;
+    K->M = M;
+
+    if ((K->u = (int *) calloc(M+1, sizeof(int))) == NULL ||
+        (K->w = (int *) calloc(M+1, sizeof(int))) == NULL ||
+        (K->state = (int *) calloc(M+1, sizeof(int))) == NULL ||
+        (K->inK5 = (int *) calloc(M+1, sizeof(int))) == NULL ||
+        (K->origin = (int *) calloc(N+1, sizeof(int))) == NULL)
+        return NOTOK;
+
+    return OK;
+}
+
+void _K5Search_FreeKernel(k5KernelP K)
+{
+    if (K->u != NULL) free(K->u);
+    if (K->w != NULL) free(K->w);
+    if (K->state != NULL) free(K->state);
+    if (K->inK5 != NULL) free(K->inK5);
+    if (K->origin != NULL) free(K->origin);
+
+    memset(K, 0, sizeof(k5KernelRec));
+}
+
+/********************************************************************
+ _K5Search_Luby()
+
+ Returns term i of the Luby sequence 1, 1, 2, 1, 1, 2, 4, 1, 1, 2, ...,
+ in which term 2^k - 1 is 2^(k-1), and the terms after it repeat the
+ sequence from its start.
+ ********************************************************************/
+
+long _K5Search_Luby(int i)
+{
+long size = 1, term = 1;
+
+    while (size < i)
+    {
+        size = 2*size + 1;
+        term *= 2;
+    }
+
+    while (size != i)
+    {
+        size = (size - 1) / 2;
+        term /= 2;
+        if (i > size)
+            i -= size;
+    }
+
+    return term;
+}
+
+/********************************************************************
+ _K5Search_SearchPermuted()
+
+ Searches the kernel P made from the kernel K by putting its edges in
+ a pseudo-random order that depends on the restart number.  The edges
+ of a K5 homeomorph found in P are marked inK5 in K.
+ ********************************************************************/
+
+int  _K5Search_SearchPermuted(k5SearchP s, k5KernelP K, k5KernelP P, int *perm, int restart)
+{
+unsigned seed = (unsigned) restart;
+int i, j, temp, RetVal;
+
+    for (i = 1; i <= K->M; i++)
+        perm[i] = i;
+
+    for (i = K->M; i > 1; i--)
+    {
+        seed = seed * 1103515245u + 12345u;
+        j = 1 + (int) ((seed >> 8) % (unsigned) i);
+        temp = perm[i];
+        perm[i] = perm[j];
+        perm[j] = temp;
+    }
+
+    for (i = 1; i <= K->N; i++)
+        P->origin[i] = K->origin[i];
+
+    for (i = 1; i <= K->M; i++)
+    {
+        P->u[i] = K->u[perm[i]];
+        P->w[i] = K->w[perm[i]];
+        P->state[i] = K->state[perm[i]];
+        P->inK5[i] = FALSE;
+    }
+
+    RetVal = _K5Search_Search(s, P);
+
+    if (RetVal == NONEMBEDDABLE)
+    {
+        for (i = 1; i <= K->M; i++)
+            K->inK5[perm[i]] = P->inK5[i];
+    }
+
+    return RetVal;
+}
+
+/********************************************************************
+ _K5Search_Search()
+
+ Searches the kernel K for a K5 homeomorph that contains all of its
+ required edges and none of its deleted edges.
+
+ Returns NONEMBEDDABLE with the edges of a K5 homeomorph marked inK5,
+ OK if there is no such K5 homeomorph, or NOTOK on internal error.
+ ********************************************************************/
+
+int  _K5Search_Search(k5SearchP s, k5KernelP K)
+{
+k5ReduceRec r;
+int c, b, reqBlock = NIL, RetVal = OK;
+
+    if (_K5Search_InitReduce(&r, s, K) != OK)
+    {
+        _K5Search_FreeReduce(&r);
+        return NOTOK;
+    }
+
+    _K5Search_Reduce(&r);
+
+    if (!r.pruned)
+    {
+        if (_K5Search_FindBlocks(&r) != OK)
+            RetVal = NOTOK;
+
+        // The required chains must all be in the same block
+        for (c = 1; c <= K->M && RetVal == OK && !r.pruned; c++)
+        {
+            if (r.clive[c] && r.creq[c])
+            {
+                if (reqBlock == NIL)
+                    reqBlock = r.block[c];
+                else if (reqBlock != r.block[c])
+                    r.pruned = TRUE;
+            }
+        }
+
+        for (b = 1; b <= r.numBlocks && RetVal == OK && !r.pruned; b++)
+        {
+            if (reqBlock == NIL || reqBlock == b)
+                RetVal = _K5Search_SearchBlock(&r, b);
+        }
+    }
+
+    _K5Search_FreeReduce(&r);
+    return RetVal;
+}
+
+/********************************************************************
+ _K5Search_InitReduce()
+ _K5Search_FreeReduce()
+ ********************************************************************/
+
+int  _K5Search_InitReduce(k5ReduceP r, k5SearchP s, k5KernelP K)
+{
+int N = K->N, M = K->M, hashSize = 16;
+
+    memset(r, 0, sizeof(k5ReduceRec));
+
+    r->s = s;
+    r->K = K;
+
+    while (hashSize < 2*M)
+        hashSize <<= 1;
+    r->hashMask = hashSize - 1;
+
+    if ((r->cu = (int *) calloc(M+1, sizeof(int))) == NULL ||
+        (r->cw = (int *) calloc(M+1, sizeof(int))) == NULL ||
+        (r->creq = (int *) calloc(M+1, sizeof(int))) == NULL ||
+        (r->clive = (int *) calloc(M+1, sizeof(int))) == NULL ||
+        (r->cfirst = (int *) calloc(M+1, sizeof(int))) == NULL ||
+        (r->clast = (int *) calloc(M+1, sizeof(int))) == NULL ||
+        (r->edgeNext = (int *) calloc(M+1, sizeof(int))) == NULL ||
+        (r->block = (int *) calloc(M+1, sizeof(int))) == NULL ||
+        (r->hashNext = (int *) calloc(M+1, sizeof(int))) == NULL ||
+        (r->arcNext = (int *) calloc(2*M+2, sizeof(int))) == NULL ||
+        (r->arcPrev = (int *) calloc(2*M+2, sizeof(int))) == NULL ||
+        (r->firstArc = (int *) calloc(N+1, sizeof(int))) == NULL ||
+        (r->degree = (int *) calloc(N+1, sizeof(int))) == NULL ||
+        (r->reqDegree = (int *) calloc(N+1, sizeof(int))) == NULL ||
+        (r->stack = (int *) calloc(N+1, sizeof(int))) == NULL ||
+        (r->onStack = (int *) calloc(N+1, sizeof(int))) == NULL ||
+        (r->vertexMap = (int *) calloc(N+1, sizeof(int))) == NULL ||
+        (r->hashHead = (int *) calloc(hashSize, sizeof(int))) == NULL)
+        return NOTOK;
+
+    return OK;
+}
+
+void _K5Search_FreeReduce(k5ReduceP r)
+{
+    if (r->cu != NULL) free(r->cu);
+    if (r->cw != NULL) free(r->cw);
+    if (r->creq != NULL) free(r->creq);
+    if (r->clive != NULL) free(r->clive);
+    if (r->cfirst != NULL) free(r->cfirst);
+    if (r->clast != NULL) free(r->clast);
+    if (r->edgeNext != NULL) free(r->edgeNext);
+    if (r->block != NULL) free(r->block);
+    if (r->hashNext != NULL) free(r->hashNext);
+    if (r->arcNext != NULL) free(r->arcNext);
+    if (r->arcPrev != NULL) free(r->arcPrev);
+    if (r->firstArc != NULL) free(r->firstArc);
+    if (r->degree != NULL) free(r->degree);
+    if (r->reqDegree != NULL) free(r->reqDegree);
+    if (r->stack != NULL) free(r->stack);
+    if (r->onStack != NULL) free(r->onStack);
+    if (r->vertexMap != NULL) free(r->vertexMap);
+    if (r->hashHead != NULL) free(r->hashHead);
+
+    memset(r, 0, sizeof(k5ReduceRec));
+}
+
+/********************************************************************
+ _K5Search_Reduce()
+
+ Makes a chain of each edge of the kernel that is not deleted, then
+ reduces the vertices on a stack until every vertex has degree 0 or at
+ least 3 and the required chains are consistent with a K5 homeomorph.
+ Adding a chain removes it instead if it is a loop, or if it is parallel
+ to a chain already added, in which case the remaining chain is a
+ required one if either was.  The reduction is pruned if a required
+ chain would be removed or two required chains are parallel.
+
+ Each step removes a chain, so the reduction takes linear time, apart
+ from the degree checks, which are repeated only when they remove
+ chains.
+ ********************************************************************/
+
+void _K5Search_Reduce(k5ReduceP r)
+{
+k5KernelP K = r->K;
+int e, v;
+
+    for (e = 1; e <= K->M && !r->pruned; e++)
+    {
+        r->cfirst[e] = r->clast[e] = e;
+        r->edgeNext[e] = NIL;
+        r->cu[e] = K->u[e];
+        r->cw[e] = K->w[e];
+        r->creq[e] = K->state[e] == K5SEARCH_REQUIRED;
+
+        if (K->state[e] != K5SEARCH_DELETED)
+            _K5Search_AddChain(r, e);
+    }
+
+    for (v = 1; v <= K->N; v++)
+        _K5Search_Push(r, v);
+
+    do {
+        while (r->stackSize > 0 && !r->pruned)
+        {
+            v = r->stack[--r->stackSize];
+            r->onStack[v] = FALSE;
+            _K5Search_ReduceVertex(r, v);
+        }
+
+        if (!r->pruned)
+            _K5Search_CheckDegrees(r);
+
+    } while (r->stackSize > 0 && !r->pruned);
+}
+
+/********************************************************************
+ _K5Search_ReduceVertex()
+
+ A chain at a vertex of degree 1 is removed, and the two chains at a
+ vertex of degree 2 are joined into one chain.  A vertex with at least
+ three required chains must be an image vertex of the K5 homeomorph, so
+ it must have degree at least 4 and at most four required chains, and
+ if it has four, then its other chains are removed.  A vertex of degree
+ 3 cannot be an image vertex, so if two of its chains are required,
+ then its third chain is removed.
+ ********************************************************************/
+
+void _K5Search_ReduceVertex(k5ReduceP r, int v)
+{
+int a1, a2, c1, c2;
+
+    if (r->degree[v] == 1)
+    {
+        c1 = r->firstArc[v] >> 1;
+        if (r->creq[c1])
+            r->pruned = TRUE;
+        else
+            _K5Search_RemoveChain(r, c1);
+    }
+
+    else if (r->degree[v] == 2)
+    {
+        a1 = r->firstArc[v];
+        a2 = r->arcNext[a1];
+        c1 = a1 >> 1;
+        c2 = a2 >> 1;
+
+        _K5Search_RemoveChain(r, c1);
+        _K5Search_RemoveChain(r, c2);
+
+        // The joined chain takes the slot of c1
+        r->cu[c1] = K5SEARCH_ARCVERTEX(r, a1 ^ 1);
+        r->cw[c1] = K5SEARCH_ARCVERTEX(r, a2 ^ 1);
+        r->edgeNext[r->clast[c1]] = r->cfirst[c2];
+        r->clast[c1] = r->clast[c2];
+        r->creq[c1] = r->creq[c1] || r->creq[c2];
+
+        _K5Search_AddChain(r, c1);
+    }
+
+    else if (r->degree[v] > 2)
+    {
+        if (r->reqDegree[v] > 4 || (r->reqDegree[v] >= 3 && r->degree[v] < 4))
+            r->pruned = TRUE;
+
+        else if ((r->reqDegree[v] == 4 && r->degree[v] > 4) ||
+                 (r->reqDegree[v] == 2 && r->degree[v] == 3))
+            _K5Search_RemoveFreeChains(r, v);
+    }
+}
+
+/********************************************************************
+ _K5Search_RemoveFreeChains()
+ Removes the chains at v that are not required.
+ ********************************************************************/
+
+void _K5Search_RemoveFreeChains(k5ReduceP r, int v)
+{
+int a = r->firstArc[v], next;
+
+    while (a != NIL)
+    {
+        next = r->arcNext[a];
+        if (!r->creq[a >> 1])
+            _K5Search_RemoveChain(r, a >> 1);
+        a = next;
+    }
+}
+
+/********************************************************************
+ _K5Search_Push()
+ ********************************************************************/
+
+void _K5Search_Push(k5ReduceP r, int v)
+{
+    if (!r->onStack[v])
+    {
+        r->onStack[v] = TRUE;
+        r->stack[r->stackSize++] = v;
+    }
+}
+
+/********************************************************************
+ _K5Search_AddChain()
+ ********************************************************************/
+
+void _K5Search_AddChain(k5ReduceP r, int c)
+{
+int a = r->cu[c], b = r->cw[c], d, h;
+
+    r->clive[c] = FALSE;
+
+    if (a == b)
+    {
+        if (r->creq[c])
+            r->pruned = TRUE;
+        _K5Search_Push(r, a);
+        return;
+    }
+
+    if ((d = _K5Search_FindChain(r, a, b)) != NIL)
+    {
+        if (r->creq[c] && r->creq[d])
+            r->pruned = TRUE;
+        else if (r->creq[c])
+        {
+            r->cfirst[d] = r->cfirst[c];
+            r->clast[d] = r->clast[c];
+            r->creq[d] = TRUE;
+            r->reqDegree[a]++;
+            r->reqDegree[b]++;
+        }
+        _K5Search_Push(r, a);
+        _K5Search_Push(r, b);
+        return;
+    }
+
+    r->arcPrev[2*c] = NIL;
+    r->arcNext[2*c] = r->firstArc[a];
+    if (r->firstArc[a] != NIL)
+        r->arcPrev[r->firstArc[a]] = 2*c;
+    r->firstArc[a] = 2*c;
+    r->degree[a]++;
+
+    r->arcPrev[2*c+1] = NIL;
+    r->arcNext[2*c+1] = r->firstArc[b];
+    if (r->firstArc[b] != NIL)
+        r->arcPrev[r->firstArc[b]] = 2*c+1;
+    r->firstArc[b] = 2*c+1;
+    r->degree[b]++;
+
+    if (r->creq[c])
+    {
+        r->reqDegree[a]++;
+        r->reqDegree[b]++;
+    }
+
+    h = _K5Search_Hash(r, a, b);
+    r->hashNext[c] = r->hashHead[h];
+    r->hashHead[h] = c;
+
+    r->clive[c] = TRUE;
+}
+
+/********************************************************************
+ _K5Search_RemoveChain()
+ ********************************************************************/
+
+void _K5Search_RemoveChain(k5ReduceP r, int c)
+{
+int arc, v, h, d, prev = NIL;
+
+    for (arc = 2*c; arc <= 2*c+1; arc++)
+    {
+        v = K5SEARCH_ARCVERTEX(r, arc);
+
+        if (r->arcPrev[arc] != NIL)
+            r->arcNext[r->arcPrev[arc]] = r->arcNext[arc];
+        else
+            r->firstArc[v] = r->arcNext[arc];
+
+        if (r->arcNext[arc] != NIL)
+            r->arcPrev[r->arcNext[arc]] = r->arcPrev[arc];
+
+        r->degree[v]--;
+        if (r->creq[c])
+            r->reqDegree[v]--;
+        _K5Search_Push(r, v);
+    }
+
+    h = _K5Search_Hash(r, r->cu[c], r->cw[c]);
+    for (d = r->hashHead[h]; d != c; d = r->hashNext[d])
+        prev = d;
+
+    if (prev != NIL)
+        r->hashNext[prev] = r->hashNext[c];
+    else
+        r->hashHead[h] = r->hashNext[c];
+
+    r->clive[c] = FALSE;
+}
+
+/********************************************************************
+ _K5Search_FindChain()
+ _K5Search_Hash()
+ ********************************************************************/
+
+int  _K5Search_FindChain(k5ReduceP r, int a, int b)
+{
+int c;
+
+    for (c = r->hashHead[_K5Search_Hash(r, a, b)]; c != NIL; c = r->hashNext[c])
+    {
+        if ((r->cu[c] == a && r->cw[c] == b) || (r->cu[c] == b && r->cw[c] == a))
+            return c;
+    }
+
+    return NIL;
+}
+
+int  _K5Search_Hash(k5ReduceP r, int a, int b)
+{
+unsigned h;
+
+    if (a > b)
+    {
+        int temp = a;
+        a = b;
+        b = temp;
+    }
+
+    h = (unsigned) a * 2654435761u ^ (unsigned) b * 2246822519u;
+    return (int) ((h ^ (h >> 16)) & (unsigned) r->hashMask);
+}
+
+/********************************************************************
+ _K5Search_CheckDegrees()
+
+ Prunes the search if fewer than five vertices have degree at least 4,
+ or if more than five vertices have at least three required chains and
+ so must be image vertices.  If there are exactly five such vertices,
+ then no other vertex is an image vertex, so the chains that are not
+ required are removed from any other vertex with two required chains.
+ ********************************************************************/
+
+void _K5Search_CheckDegrees(k5ReduceP r)
+{
+k5KernelP K = r->K;
+int v, numDegree4 = 0, numImage = 0;
+
+    for (v = 1; v <= K->N; v++)
+    {
+        if (r->degree[v] >= 4)
+            numDegree4++;
+
+        if (r->reqDegree[v] >= 3)
+            numImage++;
+    }
+
+    if (numDegree4 < 5 || numImage > 5)
+        r->pruned = TRUE;
+
+    else if (numImage == 5)
+    {
+        for (v = 1; v <= K->N; v++)
+        {
+            if (r->reqDegree[v] == 2 && r->degree[v] > 2)
+                _K5Search_RemoveFreeChains(r, v);
+        }
+    }
+}
+
+/********************************************************************
+ _K5Search_FindBlocks()
+
+ Assigns each live chain the number of its block, from 1 to numBlocks,
+ using an iterative depth first search that keeps the chains on a stack
+ until the lowpoint of a child shows that its subtree ends a block.
+ ********************************************************************/
+
+int  _K5Search_FindBlocks(k5ReduceP r)
+{
+k5KernelP K = r->K;
+int *dfi = NULL, *lowpoint = NULL, *nextArc = NULL, *parentArc = NULL;
+int *vertexStack = NULL, *chainStack = NULL;
+int numVertexStack = 0, numChainStack = 0, dfiCount = 0;
+int s, v, p, a, c, x;
+
+    if ((dfi = (int *) calloc(K->N+1, sizeof(int))) == NULL ||
+        (lowpoint = (int *) calloc(K->N+1, sizeof(int))) == NULL ||
+        (nextArc = (int *) calloc(K->N+1, sizeof(int))) == NULL ||
+        (parentArc = (int *) calloc(K->N+1, sizeof(int))) == NULL ||
+        (vertexStack = (int *) calloc(K->N+1, sizeof(int))) == NULL ||
+        (chainStack = (int *) calloc(K->M+1, sizeof(int))) == NULL)
+    {
+        if (dfi != NULL) free(dfi);
+        if (lowpoint != NULL) free(lowpoint);
+        if (nextArc != NULL) free(nextArc);
+        if (parentArc != NULL) free(parentArc);
+        if (vertexStack != NULL) free(vertexStack);
+        return NOTOK;
+    }
+
+    r->numBlocks = 0;
+
+    for (s = 1; s <= K->N; s++)
+    {
+        if (r->degree[s] == 0 || dfi[s] != 0)
+            continue;
+
+        dfi[s] = lowpoint[s] = ++dfiCount;
+        nextArc[s] = r->firstArc[s];
+        parentArc[s] = NIL;
+        vertexStack[numVertexStack++] = s;
+
+        while (numVertexStack > 0)
+        {
+            v = vertexStack[numVertexStack-1];
+
+            if ((a = nextArc[v]) != NIL)
+            {
+                nextArc[v] = r->arcNext[a];
+                c = a >> 1;
+                x = K5SEARCH_ARCVERTEX(r, a ^ 1);
+
+                if (parentArc[v] != NIL && c == (parentArc[v] >> 1))
+                    continue;
+
+                if (dfi[x] == 0)
+                {
+                    chainStack[numChainStack++] = c;
+                    dfi[x] = lowpoint[x] = ++dfiCount;
+                    nextArc[x] = r->firstArc[x];
+                    parentArc[x] = a ^ 1;
+                    vertexStack[numVertexStack++] = x;
+                }
+                else if (dfi[x] < dfi[v])
+                {
+                    chainStack[numChainStack++] = c;
+                    if (lowpoint[v] > dfi[x])
+                        lowpoint[v] = dfi[x];
+                }
+            }
+            else
+            {
+                numVertexStack--;
+                if (numVertexStack > 0)
+                {
+                    p = vertexStack[numVertexStack-1];
+                    if (lowpoint[p] > lowpoint[v])
+                        lowpoint[p] = lowpoint[v];
+
+                    // The chains above the tree chain to v form a block
+                    if (lowpoint[v] >= dfi[p])
+                    {
+                        r->numBlocks++;
+                        do {
+                            c = chainStack[--numChainStack];
+                            r->block[c] = r->numBlocks;
+                        } while (c != (parentArc[v] >> 1));
+                    }
+                }
+            }
+        }
+    }
+
+    free(dfi);
+    free(lowpoint);
+    free(nextArc);
+    free(parentArc);
+    free(vertexStack);
+    free(chainStack);
+
+    return OK;
+}
+
+/********************************************************************
+ _K5Search_SearchBlock()
+
+ Makes a kernel of the chains of the given block.  If the reduced kernel
+ has other blocks, then the new kernel is searched from the start,
+ since removing the other blocks may reduce it further.  Otherwise, the
+ new kernel is already reduced, and it is split into its triconnected
+ components if none of its edges are required, or else it is tested for
+ planarity.  If a K5 homeomorph is found, then the edges of its chains
+ are marked.
+ ********************************************************************/
+
+int  _K5Search_SearchBlock(k5ReduceP r, int theBlock)
+{
+k5KernelRec C;
+int *chainOf = NULL;
+int i, e, RetVal;
+
+    if (_K5Search_MakeKernel(r, theBlock, &C, &chainOf) != OK)
+    {
+        _K5Search_FreeKernel(&C);
+        if (chainOf != NULL) free(chainOf);
+        return NOTOK;
+    }
+
+    // A K5 homeomorph has ten paths, each with at least one chain
+    if (C.M < 10)
+        RetVal = OK;
+    else if (r->numBlocks > 1)
+        RetVal = _K5Search_Search(r->s, &C);
+    else
+    {
+        for (i = 1; i <= C.M && C.state[i] != K5SEARCH_REQUIRED; i++)
+            ;
+        if (i > C.M)
+            RetVal = _K5Search_SearchTricomps(r->s, &C);
+        else
+            RetVal = _K5Search_Branch(r->s, &C);
+    }
+
+    if (RetVal == NONEMBEDDABLE)
+    {
+        for (i = 1; i <= C.M; i++)
+        {
+            if (C.inK5[i])
+            {
+                for (e = r->cfirst[chainOf[i]]; e != NIL; e = r->edgeNext[e])
+                    r->K->inK5[e] = TRUE;
+            }
+        }
+    }
+
+    _K5Search_FreeKernel(&C);
+    free(chainOf);
+
+    return RetVal;
+}
+
+/********************************************************************
+ _K5Search_MakeKernel()
+
+ Makes the kernel C whose edges are the live chains of the given block,
+ with the vertices renumbered consecutively, and the array that gives
+ the chain of each edge of C.
+ ********************************************************************/
+
+int  _K5Search_MakeKernel(k5ReduceP r, int theBlock, k5KernelP C, int **pChainOf)
+{
+k5KernelP K = r->K;
+int c, i, N = 0, M = 0;
+
+    for (c = 1; c <= K->M; c++)
+    {
+        if (r->clive[c] && r->block[c] == theBlock)
+        {
+            M++;
+            if (r->vertexMap[r->cu[c]] == NIL)
+                r->vertexMap[r->cu[c]] = ++N;
+            if (r->vertexMap[r->cw[c]] == NIL)
+                r->vertexMap[r->cw[c]] = ++N;
+        }
+    }
+
+    if (_K5Search_NewKernel(C, N, M) != OK ||
+        (*pChainOf = (int *) calloc(M+1, sizeof(int))) == NULL)
+        return NOTOK;
+
+    for (c = 1, i = 0; c <= K->M; c++)
+    {
+        if (r->clive[c] && r->block[c] == theBlock)
+        {
+            i++;
+            (*pChainOf)[i] = c;
+            C->u[i] = r->vertexMap[r->cu[c]];
+            C->w[i] = r->vertexMap[r->cw[c]];
+            C->state[i] = r->creq[c] ? K5SEARCH_REQUIRED : K5SEARCH_FREE;
+            C->origin[C->u[i]] = K->origin[r->cu[c]];
+            C->origin[C->w[i]] = K->origin[r->cw[c]];
+        }
+    }
+
+    for (c = 1; c <= K->M; c++)
+    {
+        if (r->clive[c] && r->block[c] == theBlock)
+            r->vertexMap[r->cu[c]] = r->vertexMap[r->cw[c]] = NIL;
+    }
+
+    return OK;
+}
+
+/********************************************************************
+ _K5Search_SearchTricomps()
+
+ Searches the reduced, biconnected kernel C, none of whose edges are
+ required, by searching the skeletons of the R-nodes of its SPQR tree.
+ A K5 homeomorph is triconnected apart from its paths, so its image
+ vertices cannot be separated by a separation pair, and it is in the
+ skeleton of one R-node with some of its paths replaced by the virtual
+ edges of the separation pairs they pass through.  Conversely, a K5
+ homeomorph in a skeleton becomes one in C by replacing each virtual
+ edge with a path through the part of C that it stands for.  The
+ skeletons of S-nodes and P-nodes are planar, so they are skipped, as
+ are the R-nodes with fewer than five vertices of degree at least 4.
+
+ Returns NONEMBEDDABLE with the edges of a K5 homeomorph marked inK5,
+ OK if there is none, or NOTOK on internal error or if the branch limit
+ was reached.
+ ********************************************************************/
+
+int  _K5Search_SearchTricomps(k5SearchP s, k5KernelP C)
+{
+graphP H = NULL;
+spqrTreeP T = NULL;
+int *vertexMap = NULL;
+int x, RetVal = OK;
+
+    if ((H = _K5Search_MakeGraph(C)) == NULL ||
+        gp_CreateSPQRTree(H, &T) != OK ||
+        (vertexMap = (int *) calloc(C->N+1, sizeof(int))) == NULL)
+        RetVal = NOTOK;
+
+    for (x = 0; RetVal == OK && x < T->numNodes; x++)
+    {
+        if (T->nodeType[x] == SPQR_RNODE)
+            RetVal = _K5Search_SearchRNode(s, C, H, T, x, vertexMap);
+    }
+
+    if (vertexMap != NULL) free(vertexMap);
+    gp_FreeSPQRTree(&T);
+    gp_Free(&H);
+
+    return RetVal;
+}
+
+/********************************************************************
+ _K5Search_SearchRNode()
+
+ Makes a kernel S of the skeleton of R-node x of the SPQR tree T of the
+ graph H made from C, and branches on it if it has at least ten edges
+ and five vertices of degree at least 4.  If a K5 homeomorph is found,
+ then its real edges are marked inK5 in C, along with a path for each
+ of its virtual edges.  The vertexMap is all NIL on entry and on exit.
+ ********************************************************************/
+
+int  _K5Search_SearchRNode(k5SearchP s, k5KernelP C, graphP H, spqrTreeP T, int x, int *vertexMap)
+{
+k5KernelRec S;
+int start = T->nodeEdgeStart[x], M = T->nodeEdgeStart[x+1] - start;
+int *ends = NULL, *degree = NULL;
+int i, k, N = 0, numDegree4 = 0, RetVal = OK;
+
+    if (M < 10)
+        return OK;
+
+    memset(&S, 0, sizeof(k5KernelRec));
+
+    if ((ends = (int *) calloc(2 * M, sizeof(int))) == NULL ||
+        (degree = (int *) calloc(2*M+1, sizeof(int))) == NULL)
+        RetVal = NOTOK;
+
+    // Number the vertices of the skeleton consecutively
+    for (i = 0; i < M && RetVal == OK; i++)
+    {
+        k = T->nodeEdges[start+i];
+        if (spqr_IsVirtualEdge(k))
+        {
+            ends[2*i] = T->virtualEdgeEnds[2*spqr_GetVirtualEdge(k)];
+            ends[2*i+1] = T->virtualEdgeEnds[2*spqr_GetVirtualEdge(k)+1];
+        }
+        else
+        {
+            ends[2*i] = gp_GetNeighbor(H, gp_GetTwinArc(H, k));
+            ends[2*i+1] = gp_GetNeighbor(H, k);
+        }
+
+        for (k = 2*i; k <= 2*i+1; k++)
+        {
+            if (vertexMap[ends[k]] == NIL)
+                vertexMap[ends[k]] = ++N;
+            if (++degree[vertexMap[ends[k]]] == 4)
+                numDegree4++;
+        }
+    }
+
+    if (RetVal == OK && numDegree4 >= 5)
+    {
+        if (_K5Search_NewKernel(&S, N, M) != OK)
+            RetVal = NOTOK;
+
+        for (i = 0; i < M && RetVal == OK; i++)
+        {
+            S.u[i+1] = vertexMap[ends[2*i]];
+            S.w[i+1] = vertexMap[ends[2*i+1]];
+            S.origin[S.u[i+1]] = C->origin[ends[2*i]];
+            S.origin[S.w[i+1]] = C->origin[ends[2*i+1]];
+        }
+
+        if (RetVal == OK)
+            RetVal = _K5Search_Branch(s, &S);
+
+        for (i = 0; i < M && RetVal == NONEMBEDDABLE; i++)
+        {
+            if (S.inK5[i+1])
+            {
+                k = T->nodeEdges[start+i];
+                if (spqr_IsVirtualEdge(k))
+                {
+                    if (_K5Search_MarkVirtualEdge(C, H, T, x, spqr_GetVirtualEdge(k)) != OK)
+                        RetVal = NOTOK;
+                }
+                else
+                    C->inK5[(k - gp_GetFirstEdge(H)) / 2 + 1] = TRUE;
+            }
+        }
+    }
+
+    if (ends != NULL)
+    {
+        for (i = 0; i < M; i++)
+            vertexMap[ends[2*i]] = vertexMap[ends[2*i+1]] = NIL;
+        free(ends);
+    }
+    if (degree != NULL) free(degree);
+    _K5Search_FreeKernel(&S);
+
+    return RetVal;
+}
+
+/********************************************************************
+ _K5Search_MarkVirtualEdge()
+
+ Marks inK5 in C the edges of a path between the endpoints of virtual
+ edge k of node x.  The nodes on the far side of the tree edge of k are
+ found by a traversal of the tree that does not cross back to x, and
+ the path is found by a breadth first search of H restricted to the
+ real edges of those nodes.  Since the nodes on the far sides of the
+ virtual edges of x are disjoint, and share no vertices with x other
+ than the endpoints of their virtual edges, the paths are internally
+ disjoint from each other and from the skeleton of x.
+ ********************************************************************/
+
+int  _K5Search_MarkVirtualEdge(k5KernelP C, graphP H, spqrTreeP T, int x, int k)
+{
+int *farSide = NULL, *queue = NULL, *parentArc = NULL;
+int qHead = 0, qTail = 0, y, z, i, j, v, e, RetVal = NOTOK;
+int a = T->virtualEdgeEnds[2*k], b = T->virtualEdgeEnds[2*k+1];
+
+    if ((farSide = (int *) calloc(T->numNodes, sizeof(int))) == NULL ||
+        (queue = (int *) malloc((T->numNodes + H->N + 1) * sizeof(int))) == NULL ||
+        (parentArc = (int *) calloc(H->N + 1, sizeof(int))) == NULL)
+    {
+        if (farSide != NULL) free(farSide);
+        if (queue != NULL) free(queue);
+        return NOTOK;
+    }
+
+    y = T->virtualEdgeNodes[2*k] == x ? T->virtualEdgeNodes[2*k+1] : T->virtualEdgeNodes[2*k];
+    farSide[x] = farSide[y] = TRUE;
+    queue[qTail++] = y;
+    while (qHead < qTail)
+    {
+        z = queue[qHead++];
+        for (i = T->nodeEdgeStart[z]; i < T->nodeEdgeStart[z+1]; i++)
+        {
+            if (spqr_IsVirtualEdge(T->nodeEdges[i]))
+            {
+                j = spqr_GetVirtualEdge(T->nodeEdges[i]);
+                y = T->virtualEdgeNodes[2*j] == z ? T->virtualEdgeNodes[2*j+1] : T->virtualEdgeNodes[2*j];
+                if (!farSide[y])
+                {
+                    farSide[y] = TRUE;
+                    queue[qTail++] = y;
+                }
+            }
+        }
+    }
+    farSide[x] = FALSE;
+
+    qHead = qTail = 0;
+    parentArc[a] = NIL;
+    queue[qTail++] = a;
+    while (qHead < qTail && RetVal != OK)
+    {
+        v = queue[qHead++];
+        e = gp_GetFirstArc(H, v);
+        while (gp_IsArc(e) && RetVal != OK)
+        {
+            z = gp_GetNeighbor(H, e);
+            if (z != a && parentArc[z] == NIL && T->edgeNode[e] >= 0 && farSide[T->edgeNode[e]])
+            {
+                parentArc[z] = e;
+                if (z == b)
+                    RetVal = OK;
+                queue[qTail++] = z;
+            }
+            e = gp_GetNextArc(H, e);
+        }
+    }
+
+    for (v = b; RetVal == OK && v != a; v = gp_GetNeighbor(H, gp_GetTwinArc(H, parentArc[v])))
+        C->inK5[(parentArc[v] - gp_GetFirstEdge(H)) / 2 + 1] = TRUE;
+
+    free(farSide);
+    free(queue);
+    free(parentArc);
+
+    return RetVal;
+}
+
+/********************************************************************
+ _K5Search_Branch()
+
+ Tests the reduced, biconnected kernel C for planarity.  If it is not
+ planar and the isolated Kuratowski subgraph T is a K5 homeomorph, then
+ its edges are marked.  Otherwise, the K5 homeomorph must omit some
+ edge of T, so each free edge of T is deleted in turn, with the edges of
+ T before it required, and the resulting kernel is searched.
+
+ The edges of T are taken in order of the sum of the degrees of their
+ endpoints, since deleting an edge at a vertex of low degree lets the
+ reduction remove that vertex, while the vertices of higher degree,
+ which are more likely to be image vertices, are kept.  Different
+ branches often reduce to the same kernel, so the kernels in which the
+ search fails are memoized.  Each kernel not found in the memo counts
+ as one branch toward the limits of the search and of its restart.
+
+ Returns NONEMBEDDABLE if a K5 homeomorph was found, OK if not, or
+ NOTOK on internal error or if a limit was reached.
+ ********************************************************************/
+
+int  _K5Search_Branch(k5SearchP s, k5KernelP C)
+{
+int *key = NULL, *inT = NULL, *degree = NULL, *order = NULL;
+int i, j, numOrder = 0, isK5 = FALSE, RetVal;
+
+    if ((key = _K5Search_MakeKey(C)) == NULL)
+        return NOTOK;
+
+    if (_K5Search_MemoFind(s, key))
+    {
+        free(key);
+        return OK;
+    }
+
+    if ((s->branchLimit > 0 && s->numBranches >= s->branchLimit) ||
+        s->numBranches >= s->restartLimit)
+    {
+        s->limitReached = TRUE;
+        free(key);
+        return NOTOK;
+    }
+    s->numBranches++;
+
+    if ((inT = (int *) calloc(C->M+1, sizeof(int))) == NULL ||
+        (degree = (int *) calloc(C->N+1, sizeof(int))) == NULL ||
+        (order = (int *) malloc(2 * (C->M+1) * sizeof(int))) == NULL)
+        RetVal = NOTOK;
+    else
+        RetVal = _K5Search_TestKernel(C, inT, &isK5);
+
+    if (RetVal == NONEMBEDDABLE && isK5)
+    {
+        for (i = 1; i <= C->M; i++)
+            C->inK5[i] = inT[i];
+    }
+
+    else if (RetVal == NONEMBEDDABLE)
+    {
+        for (i = 1; i <= C->M; i++)
+        {
+            degree[C->u[i]]++;
+            degree[C->w[i]]++;
+        }
+
+        for (i = 1; i <= C->M; i++)
+        {
+            if (inT[i] && C->state[i] == K5SEARCH_FREE)
+            {
+                order[2*numOrder] = degree[C->u[i]] + degree[C->w[i]];
+                order[2*numOrder+1] = i;
+                numOrder++;
+            }
+        }
+
+        qsort(order, numOrder, 2*sizeof(int), _K5Search_CompareKeyEdges);
+
+        RetVal = OK;
+        for (j = 0; j < numOrder && RetVal == OK; j++)
+        {
+            C->state[order[2*j+1]] = K5SEARCH_DELETED;
+            RetVal = _K5Search_Search(s, C);
+            C->state[order[2*j+1]] = K5SEARCH_REQUIRED;
+        }
+
+        for (j = 0; j < numOrder; j++)
+            C->state[order[2*j+1]] = K5SEARCH_FREE;
+    }
+
+    if (RetVal == OK)
+        _K5Search_MemoAdd(s, key);
+    else
+        free(key);
+
+    if (inT != NULL) free(inT);
+    if (degree != NULL) free(degree);
+    if (order != NULL) free(order);
+
+    return RetVal;
+}
+
+/********************************************************************
+ _K5Search_MakeGraph()
+
+ Makes a graph of the kernel C with its edges added consecutively, so
+ that edge i of C is the edge with arcs first+2(i-1) and its twin.
+
+ Returns the graph, or NULL on error.
+ ********************************************************************/
+
+graphP _K5Search_MakeGraph(k5KernelP C)
+{
+graphP H = gp_New();
+int i;
+
+    if (H == NULL)
+        return NULL;
+
+    if ((C->M > DEFAULT_EDGE_LIMIT * C->N && gp_EnsureArcCapacity(H, 2*C->M) != OK) ||
+        gp_InitGraph(H, C->N) != OK)
+    {
+        gp_Free(&H);
+        return NULL;
+    }
+
+    for (i = 1; i <= C->M; i++)
+    {
+        if (gp_AddEdge(H, C->u[i], 0, C->w[i], 0) != OK)
+        {
+            gp_Free(&H);
+            return NULL;
+        }
+    }
+
+    return H;
+}
+
+/********************************************************************
+ _K5Search_TestKernel()
+
+ Embeds the kernel C with the core planarity algorithm.  If it is not
+ planar, then the edges of the isolated Kuratowski subgraph are marked
+ in inT, and pIsK5 tells whether it is a K5 homeomorph.  The core
+ planarity algorithm neither moves nor renumbers edge records, so each
+ remaining edge gives the edge of C from which it was made.
+
+ Returns OK if C is planar, NONEMBEDDABLE if not, or NOTOK on error.
+ ********************************************************************/
+
+int  _K5Search_TestKernel(k5KernelP C, int *inT, int *pIsK5)
+{
+graphP H = _K5Search_MakeGraph(C);
+int i, e, u, w, RetVal;
+
+    if (H == NULL)
+        return NOTOK;
+
+    RetVal = gp_EmbedPlanar(H);
+
+    if (RetVal == NONEMBEDDABLE)
+    {
+        if (gp_SortVertices(H) != OK)
+            RetVal = NOTOK;
+        else
+            *pIsK5 = _IsK5Homeomorph(H);
+
+        for (e = gp_GetFirstEdge(H); e < gp_EdgeInUseIndexBound(H) && RetVal != NOTOK; e+=2)
+        {
+            if (gp_EdgeInUse(H, e))
+            {
+                i = (e - gp_GetFirstEdge(H)) / 2 + 1;
+                u = gp_GetNeighbor(H, gp_GetTwinArc(H, e));
+                w = gp_GetNeighbor(H, e);
+
+                if ((u != C->u[i] || w != C->w[i]) && (u != C->w[i] || w != C->u[i]))
+                    RetVal = NOTOK;
+                else
+                    inT[i] = TRUE;
+            }
+        }
+    }
+
+    gp_Free(&H);
+    return RetVal;
+}
+
+/********************************************************************
+ _K5Search_MakeKey()
+
+ The key of a kernel is an array whose first entry is its length,
+ followed by a pair for each edge: the lesser origin of its endpoints,
+ and twice the greater origin plus one if the edge is required.  The
+ pairs are sorted, so kernels with the same edges have the same key.
+
+ Returns the key, or NULL if it could not be allocated.
+ ********************************************************************/
+
+int *_K5Search_MakeKey(k5KernelP C)
+{
+int *key, i, a, b;
+
+    if ((key = (int *) malloc((1 + 2*C->M) * sizeof(int))) == NULL)
+        return NULL;
+
+    key[0] = 1 + 2*C->M;
+    for (i = 1; i <= C->M; i++)
+    {
+        a = C->origin[C->u[i]];
+        b = C->origin[C->w[i]];
+        key[2*i-1] = a < b ? a : b;
+        key[2*i] = 2*(a < b ? b : a) + (C->state[i] == K5SEARCH_REQUIRED ? 1 : 0);
+    }
+
+    qsort(key+1, C->M, 2*sizeof(int), _K5Search_CompareKeyEdges);
+
+    return key;
+}
+
+/********************************************************************
+ _K5Search_CompareKeyEdges()
+ Compares two pairs of integers lexicographically.
+ ********************************************************************/
+
+int  _K5Search_CompareKeyEdges(const void *edge1, const void *edge2)
+{
+const int *p1 = (const int *) edge1, *p2 = (const int *) edge2;
+
+    if (p1[0] != p2[0])
+        return p1[0] < p2[0] ? -1 : 1;
+
+    if (p1[1] != p2[1])
+        return p1[1] < p2[1] ? -1 : 1;
+
+    return 0;
+}
+
+/********************************************************************
+ _K5Search_HashKey()
+ ********************************************************************/
+
+unsigned _K5Search_HashKey(int *key)
+{
+unsigned h = 2166136261u;
+int i;
+
+    for (i = 0; i < key[0]; i++)
+        h = (h ^ (unsigned) key[i]) * 16777619u;
+
+    return h;
+}
+
+/********************************************************************
+ _K5Search_MemoFind()
+
+ Returns TRUE if the key is in the hash set of failed kernels.
+ ********************************************************************/
+
+int  _K5Search_MemoFind(k5SearchP s, int *key)
+{
+unsigned h;
+
+    if (s->memo == NULL)
+        return FALSE;
+
+    h = _K5Search_HashKey(key) & (s->memoSize - 1);
+    while (s->memo[h] != NULL)
+    {
+        if (s->memo[h][0] == key[0] && memcmp(s->memo[h], key, key[0] * sizeof(int)) == 0)
+            return TRUE;
+        h = (h + 1) & (s->memoSize - 1);
+    }
+
+    return FALSE;
+}
+
+/********************************************************************
+ _K5Search_MemoAdd()
+
+ Adds the key to the hash set of failed kernels, which takes ownership
+ of it.  The hash set doubles in size when it becomes half full, and it
+ stops growing once K5SEARCH_MEMO_LIMIT is reached or memory runs out,
+ since the memoization only serves to prune the search.
+ ********************************************************************/
+
+void _K5Search_MemoAdd(k5SearchP s, int *key)
+{
+int **newMemo, newSize, i;
+unsigned h;
+
+    if (s->memoInts + key[0] > K5SEARCH_MEMO_LIMIT)
+    {
+        free(key);
+        return;
+    }
+
+    if (2 * (s->memoCount + 1) > s->memoSize)
+    {
+        newSize = s->memoSize > 0 ? 2 * s->memoSize : 1024;
+        if ((newMemo = (int **) calloc(newSize, sizeof(int *))) == NULL)
+        {
+            free(key);
+            return;
+        }
+
+        for (i = 0; i < s->memoSize; i++)
+        {
+            if (s->memo[i] != NULL)
+            {
+                h = _K5Search_HashKey(s->memo[i]) & (newSize - 1);
+                while (newMemo[h] != NULL)
+                    h = (h + 1) & (newSize - 1);
+                newMemo[h] = s->memo[i];
+            }
+        }
+
+        if (s->memo != NULL)
+            free(s->memo);
+        s->memo = newMemo;
+        s->memoSize = newSize;
+    }
+
+    h = _K5Search_HashKey(key) & (s->memoSize - 1);
+    while (s->memo[h] != NULL)
+        h = (h + 1) & (s->memoSize - 1);
+    s->memo[h] = key;
+    s->memoCount++;
+    s->memoInts += key[0];
+}
+
+/********************************************************************
+ _K5Search_FreeMemo()
+ ********************************************************************/
+
+void _K5Search_FreeMemo(k5SearchP s)
+{
+int i;
+
+    if (s->memo != NULL)
+    {
+        for (i = 0; i < s->memoSize; i++)
+            if (s->memo[i] != NULL)
+                free(s->memo[i]);
+        free(s->memo);
+    }
+
+    memset(s, 0, sizeof(k5SearchRec));
+}
+
+/********************************************************************
+ _K5Search_Assemble()
+
+ Restores the edges of the input graph in theGraph, in the order of
+ origGraph, or only those of the K5 homeomorph if one was found.
+ ********************************************************************/
+
+int  _K5Search_Assemble(K5SearchContext *context, k5KernelP K, int found)
+{
+graphP theGraph = context->theGraph;
+int v, i;
+
+    for (v = gp_GetFirstVertex(theGraph); gp_VertexInRange(theGraph, v); v++)
+    {
+        gp_SetFirstArc(theGraph, v, NIL);
+        gp_SetLastArc(theGraph, v, NIL);
+    }
+    for (v = gp_GetFirstVirtualVertex(theGraph); gp_VirtualVertexInRange(theGraph, v); v++)
+    {
+        gp_SetFirstArc(theGraph, v, NIL);
+        gp_SetLastArc(theGraph, v, NIL);
+    }
+
+    _InitEdges(theGraph);
+    theGraph->M = 0;
+    sp_ClearStack(theGraph->edgeHoles);
+
+    for (i = 1; i <= K->M; i++)
+    {
+        if (!found || K->inK5[i])
+        {
+            if (gp_AddEdge(theGraph, K->u[i], 0, K->w[i], 0) != OK)
+                return NOTOK;
+        }
+    }
+
+    return OK;
+}
@@ -0,0 +1,388 @@
+/*
+Planarity-Related Graph Algorithms Project
+Copyright (c) 1997-2012, John M. Boyer
+All rights reserved. Includes a reference implementation of the following:
+
+* John M. Boyer. "Subgraph Homeomorphism via the Edge Addition Planarity Algorithm".
+  Journal of Graph Algorithms and Applications, Vol. 16, no. 2, pp. 381-410, 2012.
+  http://www.jgaa.info/16/268.html
+
+* John M. Boyer. "A New Method for Efficiently Generating Planar Graph
+  Visibility Representations". In P. Eades and P. Healy, editors,
+  Proceedings of the 13th International Conference on Graph Drawing 2005,
+  Lecture Notes Comput. Sci., Volume 3843, pp. 508-511, Springer-Verlag, 2006.
+
+* John M. Boyer and Wendy J. Myrvold. "On the Cutting Edge: Simplified O(n)
+  Planarity by Edge Addition". Journal of Graph Algorithms and Applications,
+  Vol. 8, No. 3, pp. 241-273, 2004.
+  http://www.jgaa.info/08/91.html
+
+* John M. Boyer. "Simplified O(n) Algorithms for Planar Graph Embedding,
+  Kuratowski Subgraph Isolation, and Related Problems". Ph.D. Dissertation,
+  University of Victoria, 2001.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+* Redistributions of source code must retain the above copyright notice, this
+  list of conditions and the following disclaimer.
+
+* Redistributions in binary form must reproduce the above copyright notice, this
+  list of conditions and the following disclaimer in the documentation and/or
+  other materials provided with the distribution.
+
+* Neither the name of the Planarity-Related Graph Algorithms Project nor the names
+  of its contributors may be used to endorse or promote products derived from this
+  software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include <stdlib.h>
+
+#include "graphK5Search.private.h"
+#include "graphK5Search.h"
+
+extern int  _IsolateKuratowskiSubgraph(graphP theGraph, int v, int R);
+extern int  _TestSubgraph(graphP theSubgraph, graphP theGraph);
+extern int  _getImageVertices(graphP theGraph, int *degrees, int maxDegree,
+                              int *imageVerts, int maxNumImageVerts);
+extern int  _TestForCompleteGraphObstruction(graphP theGraph, int numVerts,
+                                             int *degrees, int *imageVerts);
+
+extern int  _CopyK5SearchGraph(K5SearchContext *context);
+extern int  _IsK5Homeomorph(graphP theGraph);
+extern int  _SearchForK5(K5SearchContext *context);
+
+/* Forward declarations of overloading functions */
+
+int  _K5Search_EmbeddingInitialize(graphP theGraph);
+int  _K5Search_HandleBlockedBicomp(graphP theGraph, int v, int RootVertex, int R);
+int  _K5Search_EmbedPostprocess(graphP theGraph, int v, int edgeEmbeddingResult);
+int  _K5Search_CheckEmbeddingIntegrity(graphP theGraph, graphP origGraph);
+int  _K5Search_CheckObstructionIntegrity(graphP theGraph, graphP origGraph);
+
+/* Forward declarations of functions used by the extension system */
+
+void *_K5Search_DupContext(void *pContext, void *theGraph);
+void _K5Search_FreeContext(void *);
+
+/****************************************************************************
+ * K5SEARCH_ID - the variable used to hold the integer identifier for this
+ * extension, enabling this feature's extension context to be distinguished
+ * from other features' extension contexts that may be attached to a graph.
+ ****************************************************************************/
+
+int K5SEARCH_ID = 0;
+
+/****************************************************************************
+ gp_AttachK5Search()
+
+ This function adjusts the graph data structure to attach the K5 search
+ feature.
+
+ To activate this feature during gp_Embed(), use EMBEDFLAGS_SEARCHFORK5.
+ The result is NONEMBEDDABLE if the graph contains a subgraph homeomorphic
+ to K5, in which case theGraph is reduced to such a subgraph.  The result
+ is OK if the graph has no K5 homeomorph, in which case theGraph contains
+ the input graph, as a planar embedding if the graph is planar.  The result
+ is K5SEARCH_LIMITREACHED, with the input graph in theGraph, if the search
+ reaches the branch limit set by gp_SetK5SearchBranchLimit() before
+ deciding, so it is not known whether the graph has a K5 homeomorph.
+ ****************************************************************************/
+
+int  gp_AttachK5Search(graphP theGraph)
+{
+     K5SearchContext *context = NULL;
+
+     // If the K5 search feature has already been attached to the graph
+     // then there is no need to attach it again
+     gp_FindExtension(theGraph, K5SEARCH_ID, (void *)&context);
+     if (context != NULL)
+     {
+         return OK;
+     }
+
+     // Allocate a new extension context
+     context = (K5SearchContext *) malloc(sizeof(K5SearchContext));
+     if (context == NULL)
+     {
+         return NOTOK;
+     }
+
+     context->theGraph = theGraph;
+     context->origGraph = NULL;
+     context->branchLimit = K5SEARCH_DEFAULT_BRANCHLIMIT;
+
+     // Put the overload functions into the context function table.
+     // gp_AddExtension will overload the graph's functions with these, and
+     // return the base function pointers in the context function table
+     memset(&context->functions, 0, sizeof(graphFunctionTable));
+
+     context->functions.fpEmbeddingInitialize = _K5Search_EmbeddingInitialize;
+     context->functions.fpHandleBlockedBicomp = _K5Search_HandleBlockedBicomp;
+     context->functions.fpEmbedPostprocess = _K5Search_EmbedPostprocess;
+     context->functions.fpCheckEmbeddingIntegrity = _K5Search_CheckEmbeddingIntegrity;
+     context->functions.fpCheckObstructionIntegrity = _K5Search_CheckObstructionIntegrity;
+
+     // Store the K5 search context, including the data structure and the
+     // function pointers, as an extension of the graph
+     if (gp_AddExtension(theGraph, &K5SEARCH_ID, (void *) context,
+                         _K5Search_DupContext, _K5Search_FreeContext,
+                         &context->functions) != OK)
+     {
+         _K5Search_FreeContext(context);
+         return NOTOK;
+     }
+
+     return OK;
+}
+
+/********************************************************************
+ gp_DetachK5Search()
+ ********************************************************************/
+
+int gp_DetachK5Search(graphP theGraph)
+{
+    return gp_RemoveExtension(theGraph, K5SEARCH_ID);
+}
+
+/********************************************************************
+ gp_SetK5SearchBranchLimit()
+
+ Sets the number of branches that the search for a K5 homeomorph may
+ take before giving up, which is K5SEARCH_DEFAULT_BRANCHLIMIT when the
+ feature is attached.  Zero means no limit, so the search may take time
+ exponential in the size of the graph.
+
+ Returns OK, or NOTOK if the feature is not attached or the limit is
+ negative.
+ ********************************************************************/
+
+int gp_SetK5SearchBranchLimit(graphP theGraph, long branchLimit)
+{
+    K5SearchContext *context = NULL;
+
+    gp_FindExtension(theGraph, K5SEARCH_ID, (void *)&context);
+    if (context == NULL || branchLimit < 0)
+        return NOTOK;
+
+    context->branchLimit = branchLimit;
+    return OK;
+}
+
+/********************************************************************
+ _K5Search_DupContext()
+ The copy of the input graph is only used during gp_Embed(),
+ so it is not duplicated.
+ ********************************************************************/
+
+void *_K5Search_DupContext(void *pContext, void *theGraph)
+{
+     K5SearchContext *context = (K5SearchContext *) pContext;
+     K5SearchContext *newContext = (K5SearchContext *) malloc(sizeof(K5SearchContext));
+
+     if (newContext != NULL)
+     {
+         *newContext = *context;
+
+         newContext->theGraph = (graphP) theGraph;
+         newContext->origGraph = NULL;
+     }
+
+     return newContext;
+}
+
+/********************************************************************
+ _K5Search_FreeContext()
+ ********************************************************************/
+
+void _K5Search_FreeContext(void *pContext)
+{
+     K5SearchContext *context = (K5SearchContext *) pContext;
+
+     gp_Free(&context->origGraph);
+     free(pContext);
+}
+
+/********************************************************************
+ _K5Search_EmbeddingInitialize()
+
+ For K5 search, the graph is preprocessed and then copied before the
+ base initialization separates the DFS tree edges into singleton
+ bicomps, so the copy has the DFI vertex numbering that theGraph still
+ has once the core planarity algorithm finishes.
+ ********************************************************************/
+
+int  _K5Search_EmbeddingInitialize(graphP theGraph)
+{
+    K5SearchContext *context = NULL;
+    context = (K5SearchContext *) gp_GetExtensionContext(theGraph, K5SEARCH_ID);
+
+    if (context == NULL)
+        return NOTOK;
+
+    if (theGraph->embedFlags == EMBEDFLAGS_SEARCHFORK5)
+    {
+        if (gp_PreprocessForEmbedding(theGraph) != OK ||
+            _CopyK5SearchGraph(context) != OK)
+            return NOTOK;
+    }
+
+    return context->functions.fpEmbeddingInitialize(theGraph);
+}
+
+/********************************************************************
+ _K5Search_HandleBlockedBicomp()
+
+ For K5 search, the core planarity algorithm isolates a Kuratowski
+ subgraph as it would for EMBEDFLAGS_PLANAR.  If it is not a K5
+ homeomorph, then the search is performed in the postprocessing.
+ ********************************************************************/
+
+int  _K5Search_HandleBlockedBicomp(graphP theGraph, int v, int RootVertex, int R)
+{
+    if (theGraph->embedFlags == EMBEDFLAGS_SEARCHFORK5)
+    {
+        if (R != RootVertex)
+            sp_Push2(theGraph->theStack, R, 0);
+
+        if (_IsolateKuratowskiSubgraph(theGraph, v, RootVertex) != OK)
+            return NOTOK;
+
+        return NONEMBEDDABLE;
+    }
+
+    else
+    {
+        K5SearchContext *context = NULL;
+        context = (K5SearchContext *) gp_GetExtensionContext(theGraph, K5SEARCH_ID);
+
+        if (context != NULL)
+        {
+            return context->functions.fpHandleBlockedBicomp(theGraph, v, RootVertex, R);
+        }
+    }
+
+    return NOTOK;
+}
+
+/********************************************************************
+ _K5Search_EmbedPostprocess()
+
+ A planar graph has no K5 homeomorph, and neither does a graph whose
+ isolated Kuratowski subgraph is already a K5 homeomorph need any more
+ searching.  Otherwise, theGraph contains a K3,3 homeomorph, and the
+ search for a K5 homeomorph is performed on the copy of the input graph.
+ ********************************************************************/
+
+int  _K5Search_EmbedPostprocess(graphP theGraph, int v, int edgeEmbeddingResult)
+{
+    K5SearchContext *context = NULL;
+    int RetVal;
+
+    context = (K5SearchContext *) gp_GetExtensionContext(theGraph, K5SEARCH_ID);
+
+    if (context == NULL)
+        return NOTOK;
+
+    RetVal = context->functions.fpEmbedPostprocess(theGraph, v, edgeEmbeddingResult);
+
+    if (theGraph->embedFlags == EMBEDFLAGS_SEARCHFORK5 && context->origGraph != NULL)
+    {
+        if (RetVal == NONEMBEDDABLE && !_IsK5Homeomorph(theGraph))
+            RetVal = _SearchForK5(context);
+
+        gp_Free(&context->origGraph);
+    }
+
+    return RetVal;
+}
+
+/********************************************************************
+ _K5Search_CheckEmbeddingIntegrity()
+
+ For K5 search, theGraph need not be planar when no K5 homeomorph is
+ found, so we only ensure that it still contains the input graph.
+ ********************************************************************/
+
+int  _K5Search_CheckEmbeddingIntegrity(graphP theGraph, graphP origGraph)
+{
+     if (theGraph->embedFlags == EMBEDFLAGS_SEARCHFORK5)
+     {
+         if (_TestSubgraph(theGraph, origGraph) != TRUE ||
+             _TestSubgraph(origGraph, theGraph) != TRUE)
+             return NOTOK;
+
+         return OK;
+     }
+
+     // When not searching for K5, we let the superclass do the work
+     else
+     {
+        K5SearchContext *context = NULL;
+        context = (K5SearchContext *) gp_GetExtensionContext(theGraph, K5SEARCH_ID);
+
+        if (context != NULL)
+        {
+            return context->functions.fpCheckEmbeddingIntegrity(theGraph, origGraph);
+        }
+     }
+
+     return NOTOK;
+}
+
+/********************************************************************
+ _K5Search_CheckObstructionIntegrity()
+
+ When searching for K5, we ensure that theGraph is a subgraph of the
+ original graph and that it is a K5 homeomorph.
+ ********************************************************************/
+
+int  _K5Search_CheckObstructionIntegrity(graphP theGraph, graphP origGraph)
+{
+     if (theGraph->embedFlags == EMBEDFLAGS_SEARCHFORK5)
+     {
+         int  degrees[5], imageVerts[6];
+
+         if (_TestSubgraph(theGraph, origGraph) != TRUE)
+         {
+             return NOTOK;
+         }
+
+         if (_getImageVertices(theGraph, degrees, 4, imageVerts, 6) != OK)
+         {
+             return NOTOK;
+         }
+
+         if (_TestForCompleteGraphObstruction(theGraph, 5, degrees, imageVerts) == TRUE)
+         {
+             return OK;
+         }
+
+         return NOTOK;
+     }
+
+     // When not searching for K5, we let the superclass do the work
+     else
+     {
+        K5SearchContext *context = NULL;
+        context = (K5SearchContext *) gp_GetExtensionContext(theGraph, K5SEARCH_ID);
+
+        if (context != NULL)
+        {
+            return context->functions.fpCheckObstructionIntegrity(theGraph, origGraph);
+        }
+     }
+
+     return NOTOK;
+}
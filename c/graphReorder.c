@@ -0,0 +1,446 @@
+/*
+Planarity-Related Graph Algorithms Project
+Copyright (c) 1997-2012, John M. Boyer
+All rights reserved. Includes a reference implementation of the following:
+
+* John M. Boyer. "Subgraph Homeomorphism via the Edge Addition Planarity Algorithm".
+  Journal of Graph Algorithms and Applications, Vol. 16, no. 2, pp. 381-410, 2012.
+  http://www.jgaa.info/16/268.html
+
+* John M. Boyer. "A New Method for Efficiently Generating Planar Graph
+  Visibility Representations". In P. Eades and P. Healy, editors,
+  Proceedings of the 13th International Conference on Graph Drawing 2005,
+  Lecture Notes Comput. Sci., Volume 3843, pp. 508-511, Springer-Verlag, 2006.
+
+* John M. Boyer and Wendy J. Myrvold. "On the Cutting Edge: Simplified O(n)
+  Planarity by Edge Addition". Journal of Graph Algorithms and Applications,
+  Vol. 8, No. 3, pp. 241-273, 2004.
+  http://www.jgaa.info/08/91.html
+
+* John M. Boyer. "Simplified O(n) Algorithms for Planar Graph Embedding,
+  Kuratowski Subgraph Isolation, and Related Problems". Ph.D. Dissertation,
+  University of Victoria, 2001.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+* Redistributions of source code must retain the above copyright notice, this
+  list of conditions and the following disclaimer.
+
+* Redistributions in binary form must reproduce the above copyright notice, this
+  list of conditions and the following disclaimer in the documentation and/or
+  other materials provided with the distribution.
+
+* Neither the name of the Planarity-Related Graph Algorithms Project nor the names
+  of its contributors may be used to endorse or promote products derived from this
+  software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "graph.h"
+
+/* Imported functions */
+
+extern void _InitEdgeRec(graphP theGraph, int e);
+extern void _ReleasePreprocessCache(graphP theGraph);
+
+/* Private functions */
+
+int  _GetBFSOrder(graphP theGraph, int *newToOld, int *isNumbered);
+int  _GetDFSOrder(graphP theGraph, int *newToOld, int *isNumbered);
+int  _GetRCMOrder(graphP theGraph, int *newToOld, int *isNumbered);
+int  _CompareDegreeVertexPairs(const void *pair1, const void *pair2);
+int  _RelayoutGraph(graphP theGraph, int *newToOld, int *oldToNew);
+
+/********************************************************************
+ gp_CompactAndReorder()
+
+ Renumbers the vertices of theGraph in the order given by orderType
+ and rewrites the edge array so that the edges are grouped by vertex,
+ which improves the memory locality of the adjacency list traversals
+ done by the DFS and the rest of the embedder:
+
+ REORDER_BFS numbers each connected component in breadth first order,
+ starting from its least vertex.
+
+ REORDER_DFS numbers each connected component in depth first preorder,
+ starting from its least vertex.
+
+ REORDER_RCM numbers each connected component in reverse Cuthill-McKee
+ order, i.e. breadth first from a vertex of least degree, visiting the
+ neighbors of each vertex in order of increasing degree, then reversed,
+ which tends to give each vertex neighbors with nearby numbers.
+
+ The edge array is rewritten with each edge placed in the block of its
+ endpoint that comes first in the new order, so the arcs of a vertex
+ to the vertices after it are contiguous, apart from their twins.  Any
+ holes left by deleted edges are removed.  The order of the arcs in
+ each adjacency list is not changed.
+
+ If originalIds is not NULL, then it must have room for
+ gp_PrimaryVertexIndexBound() entries, and originalIds[v] receives the
+ number that vertex v had before the call, so that results can be
+ translated back.
+
+ The vertex and edge data of extensions are not renumbered, so the
+ graph must not have extensions attached, and it must not be DFS
+ numbered, as after gp_Embed(), since the DFS data refers to vertex
+ numbers.
+
+ Returns OK on success, NOTOK on internal failure or if theGraph has
+ extensions, is DFS numbered, or orderType is not supported.
+ ********************************************************************/
+
+int  gp_CompactAndReorder(graphP theGraph, int orderType, int *originalIds)
+{
+int  *newToOld = NULL, *oldToNew = NULL;
+int  v, RetVal = OK;
+
+    if (theGraph == NULL || theGraph->extensions != NULL ||
+        (theGraph->internalFlags & FLAGS_DFSNUMBERED) ||
+        (orderType != REORDER_BFS && orderType != REORDER_DFS && orderType != REORDER_RCM))
+        return NOTOK;
+
+    v = gp_PrimaryVertexIndexBound(theGraph);
+    if ((newToOld = (int *) malloc(v * sizeof(int))) == NULL ||
+        (oldToNew = (int *) calloc(v, sizeof(int))) == NULL)
+        RetVal = NOTOK;
+
+    // The oldToNew array doubles as the set of numbered vertices
+    if (RetVal == OK)
+    {
+        if (orderType == REORDER_BFS)
+            RetVal = _GetBFSOrder(theGraph, newToOld, oldToNew);
+        else if (orderType == REORDER_DFS)
+            RetVal = _GetDFSOrder(theGraph, newToOld, oldToNew);
+        else
+            RetVal = _GetRCMOrder(theGraph, newToOld, oldToNew);
+    }
+
+    if (RetVal == OK)
+    {
+        for (v = gp_GetFirstVertex(theGraph); gp_VertexInRange(theGraph, v); v++)
+            oldToNew[newToOld[v]] = v;
+
+        _ReleasePreprocessCache(theGraph);
+        RetVal = _RelayoutGraph(theGraph, newToOld, oldToNew);
+    }
+
+    if (RetVal == OK && originalIds != NULL)
+    {
+        for (v = gp_GetFirstVertex(theGraph); gp_VertexInRange(theGraph, v); v++)
+            originalIds[v] = newToOld[v];
+    }
+
+    if (newToOld != NULL) free(newToOld);
+    if (oldToNew != NULL) free(oldToNew);
+
+    return RetVal;
+}
+
+/********************************************************************
+ _GetBFSOrder()
+
+ Fills newToOld, indexed by new vertex number, with the vertices of
+ theGraph in breadth first order.  The newToOld array serves as the
+ queue, and isNumbered flags the vertices already queued.
+ ********************************************************************/
+
+int  _GetBFSOrder(graphP theGraph, int *newToOld, int *isNumbered)
+{
+int  root, head, tail, u, w, e;
+
+    head = tail = gp_GetFirstVertex(theGraph);
+    for (root = gp_GetFirstVertex(theGraph); gp_VertexInRange(theGraph, root); root++)
+    {
+        if (isNumbered[root])
+            continue;
+
+        isNumbered[root] = TRUE;
+        newToOld[tail++] = root;
+
+        while (head < tail)
+        {
+            u = newToOld[head++];
+            e = gp_GetFirstArc(theGraph, u);
+            while (gp_IsArc(e))
+            {
+                w = gp_GetNeighbor(theGraph, e);
+                if (!isNumbered[w])
+                {
+                    isNumbered[w] = TRUE;
+                    newToOld[tail++] = w;
+                }
+                e = gp_GetNextArc(theGraph, e);
+            }
+        }
+    }
+
+    return OK;
+}
+
+/********************************************************************
+ _GetDFSOrder()
+
+ Fills newToOld, indexed by new vertex number, with the vertices of
+ theGraph in depth first preorder.  The stack holds the next arc to
+ explore from each vertex on the current DFS path.
+ ********************************************************************/
+
+int  _GetDFSOrder(graphP theGraph, int *newToOld, int *isNumbered)
+{
+int  *pathArc, pathSize, root, next, w, e;
+
+    if ((pathArc = (int *) malloc(gp_PrimaryVertexIndexBound(theGraph) * sizeof(int))) == NULL)
+        return NOTOK;
+
+    next = gp_GetFirstVertex(theGraph);
+    for (root = gp_GetFirstVertex(theGraph); gp_VertexInRange(theGraph, root); root++)
+    {
+        if (isNumbered[root])
+            continue;
+
+        isNumbered[root] = TRUE;
+        newToOld[next++] = root;
+        pathArc[0] = gp_GetFirstArc(theGraph, root);
+        pathSize = 1;
+
+        while (pathSize > 0)
+        {
+            e = pathArc[pathSize-1];
+            if (gp_IsNotArc(e))
+            {
+                pathSize--;
+                continue;
+            }
+
+            pathArc[pathSize-1] = gp_GetNextArc(theGraph, e);
+            w = gp_GetNeighbor(theGraph, e);
+            if (!isNumbered[w])
+            {
+                isNumbered[w] = TRUE;
+                newToOld[next++] = w;
+                pathArc[pathSize++] = gp_GetFirstArc(theGraph, w);
+            }
+        }
+    }
+
+    free(pathArc);
+    return OK;
+}
+
+/********************************************************************
+ _GetRCMOrder()
+
+ Fills newToOld, indexed by new vertex number, with the vertices of
+ theGraph in reverse Cuthill-McKee order.  Each connected component is
+ searched breadth first from its vertex of least degree, and the
+ unnumbered neighbors of each vertex are queued in order of increasing
+ degree.  The whole order is then reversed.
+ ********************************************************************/
+
+int  _GetRCMOrder(graphP theGraph, int *newToOld, int *isNumbered)
+{
+int  *degree, *roots, *pairs, numPairs, root, head, tail, u, w, e, i;
+
+    i = gp_PrimaryVertexIndexBound(theGraph);
+    degree = (int *) malloc(i * sizeof(int));
+    roots = (int *) malloc(i * sizeof(int));
+    pairs = (int *) malloc(2 * i * sizeof(int));
+    if (degree == NULL || roots == NULL || pairs == NULL)
+    {
+        if (degree != NULL) free(degree);
+        if (roots != NULL) free(roots);
+        if (pairs != NULL) free(pairs);
+        return NOTOK;
+    }
+
+    // Sort the vertices by degree, so that each component is started
+    // from one of its vertices of least degree
+    numPairs = 0;
+    for (u = gp_GetFirstVertex(theGraph); gp_VertexInRange(theGraph, u); u++)
+    {
+        degree[u] = gp_GetVertexDegree(theGraph, u);
+        pairs[2*numPairs] = degree[u];
+        pairs[2*numPairs+1] = u;
+        numPairs++;
+    }
+    qsort(pairs, numPairs, 2*sizeof(int), _CompareDegreeVertexPairs);
+
+    for (i = 0; i < numPairs; i++)
+        roots[i] = pairs[2*i+1];
+
+    head = tail = gp_GetFirstVertex(theGraph);
+    for (i = 0; i < theGraph->N; i++)
+    {
+        root = roots[i];
+        if (isNumbered[root])
+            continue;
+
+        isNumbered[root] = TRUE;
+        newToOld[tail++] = root;
+
+        while (head < tail)
+        {
+            u = newToOld[head++];
+
+            numPairs = 0;
+            e = gp_GetFirstArc(theGraph, u);
+            while (gp_IsArc(e))
+            {
+                w = gp_GetNeighbor(theGraph, e);
+                if (!isNumbered[w])
+                {
+                    isNumbered[w] = TRUE;
+                    pairs[2*numPairs] = degree[w];
+                    pairs[2*numPairs+1] = w;
+                    numPairs++;
+                }
+                e = gp_GetNextArc(theGraph, e);
+            }
+
+            qsort(pairs, numPairs, 2*sizeof(int), _CompareDegreeVertexPairs);
+            for (w = 0; w < numPairs; w++)
+                newToOld[tail++] = pairs[2*w+1];
+        }
+    }
+
+    free(degree);
+    free(roots);
+    free(pairs);
+
+    // Reverse the order
+    for (head = gp_GetFirstVertex(theGraph), tail = gp_GetLastVertex(theGraph); head < tail; head++, tail--)
+    {
+        u = newToOld[head];
+        newToOld[head] = newToOld[tail];
+        newToOld[tail] = u;
+    }
+
+    return OK;
+}
+
+/********************************************************************
+ _CompareDegreeVertexPairs()
+ Compares two (degree, vertex) pairs lexicographically.
+ ********************************************************************/
+
+int  _CompareDegreeVertexPairs(const void *pair1, const void *pair2)
+{
+const int *p1 = (const int *) pair1, *p2 = (const int *) pair2;
+
+    if (p1[0] != p2[0])
+        return p1[0] < p2[0] ? -1 : 1;
+
+    if (p1[1] != p2[1])
+        return p1[1] < p2[1] ? -1 : 1;
+
+    return 0;
+}
+
+/********************************************************************
+ _RelayoutGraph()
+
+ Moves vertex newToOld[v] to position v and rewrites the edge array.
+ The edges are assigned positions by visiting the vertices in their
+ new order and taking, in adjacency list order, each edge whose other
+ endpoint is not before the vertex.  As in gp_AddEdge(), the even arc
+ of an edge is in the adjacency list of the later endpoint and its twin
+ is in the list of the earlier one.  The records are then copied to
+ their new positions, with their neighbors and links translated.
+ ********************************************************************/
+
+int  _RelayoutGraph(graphP theGraph, int *newToOld, int *oldToNew)
+{
+edgeRecP oldE = NULL;
+vertexRecP oldV = NULL;
+vertexInfoP oldVI = NULL;
+int  *arcMap = NULL;
+int  v, u, w, e, eNew, EsizeOccupied = gp_EdgeInUseIndexBound(theGraph);
+
+    if ((oldE = (edgeRecP) malloc(EsizeOccupied * sizeof(edgeRec))) == NULL ||
+        (oldV = (vertexRecP) malloc(gp_PrimaryVertexIndexBound(theGraph) * sizeof(vertexRec))) == NULL ||
+        (oldVI = (vertexInfoP) malloc(gp_PrimaryVertexIndexBound(theGraph) * sizeof(vertexInfo))) == NULL ||
+        (arcMap = (int *) malloc(EsizeOccupied * sizeof(int))) == NULL)
+    {
+        if (oldE != NULL) free(oldE);
+        if (oldV != NULL) free(oldV);
+        if (oldVI != NULL) free(oldVI);
+        return NOTOK;
+    }
+
+    memcpy(oldE, theGraph->E, EsizeOccupied * sizeof(edgeRec));
+    memcpy(oldV, theGraph->V, gp_PrimaryVertexIndexBound(theGraph) * sizeof(vertexRec));
+    memcpy(oldVI, theGraph->VI, gp_PrimaryVertexIndexBound(theGraph) * sizeof(vertexInfo));
+
+    // Assign the new edge positions.  A loop appears twice in the list
+    // of its vertex, so it is taken at its lesser arc.
+    eNew = gp_GetFirstEdge(theGraph);
+    for (v = gp_GetFirstVertex(theGraph); gp_VertexInRange(theGraph, v); v++)
+    {
+        u = newToOld[v];
+        e = gp_GetFirstArc(theGraph, u);
+        while (gp_IsArc(e))
+        {
+            w = oldToNew[gp_GetNeighbor(theGraph, e)];
+            if (w > v || (w == v && e < gp_GetTwinArc(theGraph, e)))
+            {
+                arcMap[gp_GetTwinArc(theGraph, e)] = eNew;
+                arcMap[e] = gp_GetTwinArc(theGraph, eNew);
+                eNew += 2;
+            }
+            e = gp_GetNextArc(theGraph, e);
+        }
+    }
+
+    // Copy the edge records to their new positions, then clear the rest
+    for (e = gp_GetFirstEdge(theGraph); e < EsizeOccupied; e++)
+    {
+        if (!gp_IsVertex(oldE[e].neighbor))
+            continue;
+
+        eNew = arcMap[e];
+        theGraph->E[eNew] = oldE[e];
+        gp_SetNeighbor(theGraph, eNew, oldToNew[oldE[e].neighbor]);
+        gp_SetNextArc(theGraph, eNew, gp_IsArc(oldE[e].link[0]) ? arcMap[oldE[e].link[0]] : NIL);
+        gp_SetPrevArc(theGraph, eNew, gp_IsArc(oldE[e].link[1]) ? arcMap[oldE[e].link[1]] : NIL);
+    }
+
+    for (e = gp_GetFirstEdge(theGraph) + 2*theGraph->M; e < EsizeOccupied; e++)
+        _InitEdgeRec(theGraph, e);
+
+    sp_ClearStack(theGraph->edgeHoles);
+
+    // Move the vertex records, translating the adjacency list ends
+    for (v = gp_GetFirstVertex(theGraph); gp_VertexInRange(theGraph, v); v++)
+    {
+        u = newToOld[v];
+        theGraph->V[v] = oldV[u];
+        theGraph->VI[v] = oldVI[u];
+        if (gp_IsArc(oldV[u].link[0]))
+        {
+            gp_SetFirstArc(theGraph, v, arcMap[oldV[u].link[0]]);
+            gp_SetLastArc(theGraph, v, arcMap[oldV[u].link[1]]);
+        }
+    }
+
+    free(oldE);
+    free(oldV);
+    free(oldVI);
+    free(arcMap);
+
+    return OK;
+}
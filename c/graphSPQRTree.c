@@ -0,0 +1,1820 @@
+/*
+Planarity-Related Graph Algorithms Project
+Copyright (c) 1997-2012, John M. Boyer
+All rights reserved. Includes a reference implementation of the following:
+
+* John M. Boyer. "Subgraph Homeomorphism via the Edge Addition Planarity Algorithm".
+  Journal of Graph Algorithms and Applications, Vol. 16, no. 2, pp. 381-410, 2012.
+  http://www.jgaa.info/16/268.html
+
+* John M. Boyer. "A New Method for Efficiently Generating Planar Graph
+  Visibility Representations". In P. Eades and P. Healy, editors,
+  Proceedings of the 13th International Conference on Graph Drawing 2005,
+  Lecture Notes Comput. Sci., Volume 3843, pp. 508-511, Springer-Verlag, 2006.
+
+* John M. Boyer and Wendy J. Myrvold. "On the Cutting Edge: Simplified O(n)
+  Planarity by Edge Addition". Journal of Graph Algorithms and Applications,
+  Vol. 8, No. 3, pp. 241-273, 2004.
+  http://www.jgaa.info/08/91.html
+
+* John M. Boyer. "Simplified O(n) Algorithms for Planar Graph Embedding,
+  Kuratowski Subgraph Isolation, and Related Problems". Ph.D. Dissertation,
+  University of Victoria, 2001.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+* Redistributions of source code must retain the above copyright notice, this
+  list of conditions and the following disclaimer.
+
+* Redistributions in binary form must reproduce the above copyright notice, this
+  list of conditions and the following disclaimer in the documentation and/or
+  other materials provided with the distribution.
+
+* Neither the name of the Planarity-Related Graph Algorithms Project nor the names
+  of its contributors may be used to endorse or promote products derived from this
+  software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include <stdlib.h>
+
+#include "graph.h"
+#include "graphSPQRTree.h"
+
+/* Imported functions */
+
+extern int  _LabelBlocks(graphP theGraph, int *dfi, int *parent, int *lowpoint, int *leastAncestor,
+                         int *parentArc, int *blockOf, int *blockSize, int *blockEdges);
+
+/* Private definitions */
+
+// Types of the edges of a block during the decomposition.  A tree edge
+// is directed from parent to child and a frond from descendant to
+// ancestor.  A removed edge is one of a set of parallel edges that was
+// replaced by a virtual edge before the DFS.
+#define TRIC_UNSEEN         0
+#define TRIC_TREE           1
+#define TRIC_FROND          2
+#define TRIC_REMOVED        3
+
+// Types of split components
+#define TRIC_BOND           1
+#define TRIC_POLYGON        2
+#define TRIC_TRICONNECTED   3
+
+// The a member of the end-of-segment marker on the triple stack
+#define TRIC_EOS            (-1)
+
+/* The working data for decomposing one block of N vertices and M edges.
+
+   The DFS tree, lowpoints and edge types are computed by the graph library
+   on G, a simple copy of the block.  The path search then operates on its
+   own edge records, which are numbered from 1, with the block's real edges
+   first and the virtual edges created by splits after them.  The vertices
+   are numbered by their DFI in G.
+
+   The members follow Hopcroft and Tarjan, "Dividing a graph into
+   triconnected components", SIAM J. Comput. 2(3), 1973, as corrected by
+   Gutwenger and Mutzel, "A linear time implementation of SPQR-trees",
+   Graph Drawing 2000, LNCS 1984.  The adjacency list of v, with links
+   nextArc and prevArc, holds the tree edges and fronds leaving v in the
+   order of the acceptable adjacency structure.  The highpoint list of v,
+   with links nextHigh and prevHigh, holds the numbers of the sources of
+   the fronds entering v, and inHigh[e] is the vertex whose list holds
+   the entry for frond e, or NIL.  The currentArc, pathArc, pendingArc
+   and outDegree members hold the state of the path search at each
+   vertex, so the search needs no recursion. */
+
+typedef struct
+{
+     graphP G;
+     int  N, M, capacity, numEdges;
+
+     int  *src, *tgt, *type, *startsPath, *nextArc, *prevArc;
+     int  *inHigh, *nextHigh, *prevHigh, *highValue;
+
+     int  *number, *nodeAt, *lowpt1, *lowpt2, *nd, *degree, *father, *treeArc;
+     int  *firstArc, *lastArc, *firstHigh, *lastHigh;
+     int  *currentArc, *pathArc, *pendingArc, *outDegree;
+
+     stackP edgeStack, vertexStack;
+     int  *tsH, *tsA, *tsB, tsTop, tsCapacity;
+
+     int  numComps, compLen, compCapacity;
+     int  *compStart, *compType, *compEdges;
+} tricompContext;
+
+typedef tricompContext * tricompContextP;
+
+/* Private functions */
+
+int  _DecomposeBlock(graphP theGraph, spqrTreeP theTree, int block, int N, int M,
+                     int *blockArcs, int *stamp, int *globalToSub, int *subToGlobal,
+                     int nodeCapacity, int edgeCapacity);
+int  _EmitTrivialBlock(spqrTreeP theTree, int block, int nodeType, int M, int *blockArcs);
+
+tricompContextP _NewTricompContext(int N, int M);
+void _FreeTricompContext(tricompContextP *pContext);
+
+int  _BuildBlockGraph(tricompContextP tc, int *lo, int *hi, int *vertexGlobal, int *subToGlobal);
+int  _InitBlockDFS(tricompContextP tc, int *gRep);
+int  _BuildAcceptableAdjacency(tricompContextP tc);
+int  _PathFinder(tricompContextP tc);
+int  _PathSearch(tricompContextP tc);
+int  _CheckSplitsAfterChild(tricompContextP tc, int v, int w);
+int  _EmitBlockNodes(spqrTreeP theTree, tricompContextP tc, int block,
+                     int *blockArcs, int *vertexGlobal, int nodeCapacity, int edgeCapacity);
+void _ClassifyComponents(tricompContextP tc, int *vertexMark, int *vertexCount);
+void _OrderCycle(tricompContextP tc, int *edges, int numEdges, int mark,
+                 int *vertexMark, int *incident1, int *incident2, int *scratch);
+
+int  _NewTricompEdge(tricompContextP tc, int u, int v, int type);
+int  _NewTricompComp(tricompContextP tc, int type);
+int  _AddToTricompComp(tricompContextP tc, int e);
+int  _PushTriple(tricompContextP tc, int h, int a, int b);
+int  _FirstChildNumber(tricompContextP tc, int v);
+
+void _TricompAppendArc(tricompContextP tc, int e);
+void _TricompDeleteArc(tricompContextP tc, int e);
+void _TricompReplaceArc(tricompContextP tc, int e, int eNew);
+
+void _TricompAppendHigh(tricompContextP tc, int v, int e, int value);
+void _TricompPrependHigh(tricompContextP tc, int v, int e, int value);
+void _TricompDeleteHigh(tricompContextP tc, int e);
+void _TricompReplaceHigh(tricompContextP tc, int e, int eNew);
+int  _TricompGetHigh(tricompContextP tc, int v);
+
+/********************************************************************
+ gp_CreateSPQRTree()
+
+ Computes the triconnected components of each biconnected component
+ (block) of theGraph in linear time, and returns them in *pSPQRTree
+ as the nodes of one SPQR tree per block, in the flat arrays described
+ in graphSPQRTree.h.  The result must be released by gp_FreeSPQRTree().
+
+ The blocks are found by the same DFS used by gp_EmbedBlocks().  Each
+ block with at least three vertices is copied into a simple graph, with
+ each set of parallel edges replaced by one virtual edge, and the DFS
+ tree, edge types and lowpoints of that copy are computed by
+ gp_CreateDFSTree(), gp_SortVertices() and gp_LowpointAndLeastAncestor().
+ The path search of Hopcroft and Tarjan, as corrected by Gutwenger and
+ Mutzel, then splits the block, and the split components that are
+ adjacent bonds or adjacent polygons are merged.
+
+ theGraph is not modified, and vertices are reported by their current
+ numbers in theGraph.  Self-loops belong to no block and hence no node.
+
+ Returns OK on success, NOTOK on failure.
+ ********************************************************************/
+
+int  gp_CreateSPQRTree(graphP theGraph, spqrTreeP *pSPQRTree)
+{
+int  *dfi=NULL, *parent=NULL, *lowpoint=NULL, *leastAncestor=NULL, *blockOf=NULL;
+int  *blockSize=NULL, *blockEdges=NULL, *blockStart=NULL, *blockArcs=NULL;
+int  *stamp=NULL, *globalToSub=NULL, *subToGlobal=NULL;
+spqrTreeP theTree = NULL;
+int  numBlocks = 0, nodeCapacity = 0, edgeCapacity = 0, c, e, v, EsizeOccupied, RetVal = OK;
+
+#ifdef PROFILE
+platform_time start, end;
+platform_GetTime(start);
+#endif
+
+    if (theGraph == NULL || pSPQRTree == NULL)
+        return NOTOK;
+
+    *pSPQRTree = NULL;
+
+    gp_Trace0(theGraph, TRACE_CREATESPQRTREE_BEGIN);
+
+    // A graph with N vertices has fewer than N blocks, so the per-block
+    // arrays are indexed from zero and sized by the vertex index bound
+    v = gp_PrimaryVertexIndexBound(theGraph);
+    EsizeOccupied = gp_EdgeInUseIndexBound(theGraph);
+    if ((dfi = (int *) malloc(v * sizeof(int))) == NULL ||
+        (parent = (int *) malloc(v * sizeof(int))) == NULL ||
+        (lowpoint = (int *) malloc(v * sizeof(int))) == NULL ||
+        (leastAncestor = (int *) malloc(v * sizeof(int))) == NULL ||
+        (blockOf = (int *) malloc((EsizeOccupied/2 + 1) * sizeof(int))) == NULL ||
+        (blockSize = (int *) calloc(v, sizeof(int))) == NULL ||
+        (blockEdges = (int *) calloc(v, sizeof(int))) == NULL ||
+        (blockStart = (int *) calloc(v + 1, sizeof(int))) == NULL ||
+        (blockArcs = (int *) malloc((theGraph->M + 1) * sizeof(int))) == NULL ||
+        (stamp = (int *) malloc(v * sizeof(int))) == NULL ||
+        (globalToSub = (int *) malloc(v * sizeof(int))) == NULL ||
+        (subToGlobal = (int *) malloc(v * sizeof(int))) == NULL)
+        RetVal = NOTOK;
+
+    // Find the blocks, then group the edges by block
+    if (RetVal == OK)
+    {
+        if ((numBlocks = _LabelBlocks(theGraph, dfi, parent, lowpoint, leastAncestor,
+                                      NULL, blockOf, blockSize, blockEdges)) < 0)
+            RetVal = NOTOK;
+    }
+
+    if (RetVal == OK)
+    {
+        for (c = 0; c < numBlocks; c++)
+            blockStart[c+1] = blockStart[c] + blockEdges[c];
+
+        for (e = gp_GetFirstEdge(theGraph); e < EsizeOccupied; e+=2)
+            if (gp_EdgeInUse(theGraph, e) && blockOf[e>>1] >= 0)
+                blockArcs[blockStart[blockOf[e>>1]]++] = e;
+
+        for (c = numBlocks; c > 0; c--)
+            blockStart[c] = blockStart[c-1];
+        blockStart[0] = 0;
+
+        for (v = gp_GetFirstVertex(theGraph); gp_VertexInRange(theGraph, v); v++)
+            stamp[v] = -1;
+    }
+
+    // The split components of a block with M edges have at most 3M-6 edges
+    // in total (Hopcroft and Tarjan), and its SPQR tree has at most M nodes
+    // and virtual edges, which bounds the sizes of the result arrays
+    if (RetVal == OK)
+    {
+        nodeCapacity = blockStart[numBlocks] + numBlocks;
+        edgeCapacity = 3 * blockStart[numBlocks] + numBlocks;
+
+        if ((theTree = (spqrTreeP) calloc(1, sizeof(spqrTreeRec))) == NULL ||
+            (theTree->nodeType = (int *) malloc((nodeCapacity + 1) * sizeof(int))) == NULL ||
+            (theTree->nodeBlock = (int *) malloc((nodeCapacity + 1) * sizeof(int))) == NULL ||
+            (theTree->nodeEdgeStart = (int *) calloc(nodeCapacity + 1, sizeof(int))) == NULL ||
+            (theTree->nodeEdges = (int *) malloc((edgeCapacity + 1) * sizeof(int))) == NULL ||
+            (theTree->virtualEdgeEnds = (int *) malloc(2 * (nodeCapacity + 1) * sizeof(int))) == NULL ||
+            (theTree->virtualEdgeNodes = (int *) malloc(2 * (nodeCapacity + 1) * sizeof(int))) == NULL ||
+            (theTree->edgeNode = (int *) malloc((EsizeOccupied + 1) * sizeof(int))) == NULL)
+            RetVal = NOTOK;
+    }
+
+    if (RetVal == OK)
+    {
+        theTree->numBlocks = numBlocks;
+        for (e = 0; e <= EsizeOccupied; e++)
+            theTree->edgeNode[e] = -1;
+    }
+
+    // Decompose each block, appending its nodes to the result
+    for (c = 0; c < numBlocks && RetVal == OK; c++)
+        RetVal = _DecomposeBlock(theGraph, theTree, c, blockSize[c], blockEdges[c],
+                                 blockArcs + blockStart[c], stamp, globalToSub, subToGlobal,
+                                 nodeCapacity, edgeCapacity);
+
+    if (dfi != NULL) free(dfi);
+    if (parent != NULL) free(parent);
+    if (lowpoint != NULL) free(lowpoint);
+    if (leastAncestor != NULL) free(leastAncestor);
+    if (blockOf != NULL) free(blockOf);
+    if (blockSize != NULL) free(blockSize);
+    if (blockEdges != NULL) free(blockEdges);
+    if (blockStart != NULL) free(blockStart);
+    if (blockArcs != NULL) free(blockArcs);
+    if (stamp != NULL) free(stamp);
+    if (globalToSub != NULL) free(globalToSub);
+    if (subToGlobal != NULL) free(subToGlobal);
+
+    if (RetVal == OK)
+        *pSPQRTree = theTree;
+    else
+        gp_FreeSPQRTree(&theTree);
+
+    gp_Trace2(theGraph, TRACE_CREATESPQRTREE_END, RetVal, RetVal == OK ? (*pSPQRTree)->numNodes : 0);
+
+#ifdef PROFILE
+platform_GetTime(end);
+printf("CreateSPQRTree in %.3lf seconds.\n", platform_GetDuration(start,end));
+#endif
+
+    return RetVal;
+}
+
+/********************************************************************
+ gp_FreeSPQRTree()
+ Releases the result of gp_CreateSPQRTree() and sets *pSPQRTree to NULL.
+ ********************************************************************/
+
+void gp_FreeSPQRTree(spqrTreeP *pSPQRTree)
+{
+spqrTreeP theTree;
+
+     if (pSPQRTree == NULL || (theTree = *pSPQRTree) == NULL)
+         return;
+
+     if (theTree->nodeType != NULL) free(theTree->nodeType);
+     if (theTree->nodeBlock != NULL) free(theTree->nodeBlock);
+     if (theTree->nodeEdgeStart != NULL) free(theTree->nodeEdgeStart);
+     if (theTree->nodeEdges != NULL) free(theTree->nodeEdges);
+     if (theTree->virtualEdgeEnds != NULL) free(theTree->virtualEdgeEnds);
+     if (theTree->virtualEdgeNodes != NULL) free(theTree->virtualEdgeNodes);
+     if (theTree->edgeNode != NULL) free(theTree->edgeNode);
+
+     free(theTree);
+     *pSPQRTree = NULL;
+}
+
+/********************************************************************
+ _DecomposeBlock()
+
+ Appends the SPQR tree of one block of theGraph to theTree.  The M arcs
+ in blockArcs are the lesser arcs of the block's edges.  The vertices
+ of the block are numbered 1 to N in the order they are met, using the
+ stamp and globalToSub arrays as in _CreateBlockBin(), and subToGlobal
+ receives the inverse mapping.
+
+ A block with one edge becomes a Q-node and a block with two vertices
+ becomes a P-node.  Otherwise, the block is split by the path search.
+
+ Returns OK on success, NOTOK on failure.
+ ********************************************************************/
+
+int  _DecomposeBlock(graphP theGraph, spqrTreeP theTree, int block, int N, int M,
+                     int *blockArcs, int *stamp, int *globalToSub, int *subToGlobal,
+                     int nodeCapacity, int edgeCapacity)
+{
+tricompContextP tc;
+int  *lo, *hi, *vertexGlobal;
+int  k, u, w, subv, RetVal = OK;
+
+     if (M == 1 || N == 2)
+     {
+         if (theTree->numNodes >= nodeCapacity ||
+             theTree->nodeEdgeStart[theTree->numNodes] + M > edgeCapacity)
+             return NOTOK;
+
+         return _EmitTrivialBlock(theTree, block, M == 1 ? SPQR_QNODE : SPQR_PNODE,
+                                  M, blockArcs);
+     }
+
+     if ((tc = _NewTricompContext(N, M)) == NULL)
+         return NOTOK;
+
+     lo = (int *) malloc((M + 1) * sizeof(int));
+     hi = (int *) malloc((M + 1) * sizeof(int));
+     vertexGlobal = (int *) malloc((N + 1) * sizeof(int));
+     if (lo == NULL || hi == NULL || vertexGlobal == NULL)
+         RetVal = NOTOK;
+
+     // Number the block's vertices and give each edge its endpoints
+     if (RetVal == OK)
+     {
+         subv = 1;
+         for (k = 1; k <= M; k++)
+         {
+              u = gp_GetNeighbor(theGraph, gp_GetTwinArc(theGraph, blockArcs[k-1]));
+              w = gp_GetNeighbor(theGraph, blockArcs[k-1]);
+
+              if (stamp[u] != block)
+              {
+                  stamp[u] = block;
+                  subToGlobal[subv] = u;
+                  globalToSub[u] = subv++;
+              }
+
+              if (stamp[w] != block)
+              {
+                  stamp[w] = block;
+                  subToGlobal[subv] = w;
+                  globalToSub[w] = subv++;
+              }
+
+              if (globalToSub[u] < globalToSub[w])
+              {
+                  lo[k] = globalToSub[u];
+                  hi[k] = globalToSub[w];
+              }
+              else
+              {
+                  lo[k] = globalToSub[w];
+                  hi[k] = globalToSub[u];
+              }
+         }
+     }
+
+     // Split the block and report its nodes
+     if (RetVal == OK)
+         RetVal = _BuildBlockGraph(tc, lo, hi, vertexGlobal, subToGlobal);
+
+     if (RetVal == OK)
+     {
+         if (_BuildAcceptableAdjacency(tc) != OK ||
+             _PathFinder(tc) != OK || _PathSearch(tc) != OK)
+             RetVal = NOTOK;
+     }
+
+     if (RetVal == OK)
+         RetVal = _EmitBlockNodes(theTree, tc, block, blockArcs, vertexGlobal,
+                                  nodeCapacity, edgeCapacity);
+
+     if (lo != NULL) free(lo);
+     if (hi != NULL) free(hi);
+     if (vertexGlobal != NULL) free(vertexGlobal);
+     _FreeTricompContext(&tc);
+
+     return RetVal;
+}
+
+/********************************************************************
+ _EmitTrivialBlock()
+ Appends a block that needs no splitting as a single node of the
+ given type, holding all M edges of the block.
+ ********************************************************************/
+
+int  _EmitTrivialBlock(spqrTreeP theTree, int block, int nodeType, int M, int *blockArcs)
+{
+int  node = theTree->numNodes, start = theTree->nodeEdgeStart[node], k;
+
+     theTree->nodeType[node] = nodeType;
+     theTree->nodeBlock[node] = block;
+
+     for (k = 0; k < M; k++)
+     {
+          theTree->nodeEdges[start + k] = blockArcs[k];
+          theTree->edgeNode[blockArcs[k]] = node;
+          theTree->edgeNode[gp_GetTwinArc(theGraph, blockArcs[k])] = node;
+     }
+
+     theTree->nodeEdgeStart[node+1] = start + M;
+     theTree->numNodes++;
+
+     return OK;
+}
+
+/********************************************************************
+ _NewTricompContext()
+
+ Allocates the working data for decomposing a block of N vertices and
+ M edges.  Each split creates at most two virtual edges and removes at
+ least one edge from the graph, so 3M+4 edge records suffice, and the
+ split components hold each edge record at most twice.
+ ********************************************************************/
+
+tricompContextP _NewTricompContext(int N, int M)
+{
+tricompContextP tc;
+int  cap = 3*M + 4;
+
+     if ((tc = (tricompContextP) calloc(1, sizeof(tricompContext))) == NULL)
+         return NULL;
+
+     tc->N = N;
+     tc->M = M;
+     tc->capacity = cap;
+     tc->numEdges = M;
+     tc->tsCapacity = 2*cap + 2;
+     tc->compCapacity = 2*cap;
+
+     if ((tc->src = (int *) calloc(cap + 1, sizeof(int))) == NULL ||
+         (tc->tgt = (int *) calloc(cap + 1, sizeof(int))) == NULL ||
+         (tc->type = (int *) calloc(cap + 1, sizeof(int))) == NULL ||
+         (tc->startsPath = (int *) calloc(cap + 1, sizeof(int))) == NULL ||
+         (tc->nextArc = (int *) calloc(cap + 1, sizeof(int))) == NULL ||
+         (tc->prevArc = (int *) calloc(cap + 1, sizeof(int))) == NULL ||
+         (tc->inHigh = (int *) calloc(cap + 1, sizeof(int))) == NULL ||
+         (tc->nextHigh = (int *) calloc(cap + 1, sizeof(int))) == NULL ||
+         (tc->prevHigh = (int *) calloc(cap + 1, sizeof(int))) == NULL ||
+         (tc->highValue = (int *) calloc(cap + 1, sizeof(int))) == NULL ||
+
+         (tc->number = (int *) calloc(N + 1, sizeof(int))) == NULL ||
+         (tc->nodeAt = (int *) calloc(N + 1, sizeof(int))) == NULL ||
+         (tc->lowpt1 = (int *) calloc(N + 1, sizeof(int))) == NULL ||
+         (tc->lowpt2 = (int *) calloc(N + 1, sizeof(int))) == NULL ||
+         (tc->nd = (int *) calloc(N + 1, sizeof(int))) == NULL ||
+         (tc->degree = (int *) calloc(N + 1, sizeof(int))) == NULL ||
+         (tc->father = (int *) calloc(N + 1, sizeof(int))) == NULL ||
+         (tc->treeArc = (int *) calloc(N + 1, sizeof(int))) == NULL ||
+         (tc->firstArc = (int *) calloc(N + 1, sizeof(int))) == NULL ||
+         (tc->lastArc = (int *) calloc(N + 1, sizeof(int))) == NULL ||
+         (tc->firstHigh = (int *) calloc(N + 1, sizeof(int))) == NULL ||
+         (tc->lastHigh = (int *) calloc(N + 1, sizeof(int))) == NULL ||
+         (tc->currentArc = (int *) calloc(N + 1, sizeof(int))) == NULL ||
+         (tc->pathArc = (int *) calloc(N + 1, sizeof(int))) == NULL ||
+         (tc->pendingArc = (int *) calloc(N + 1, sizeof(int))) == NULL ||
+         (tc->outDegree = (int *) calloc(N + 1, sizeof(int))) == NULL ||
+
+         (tc->edgeStack = sp_New(cap + 1)) == NULL ||
+         (tc->vertexStack = sp_New(N + 1)) == NULL ||
+         (tc->tsH = (int *) malloc((tc->tsCapacity + 1) * sizeof(int))) == NULL ||
+         (tc->tsA = (int *) malloc((tc->tsCapacity + 1) * sizeof(int))) == NULL ||
+         (tc->tsB = (int *) malloc((tc->tsCapacity + 1) * sizeof(int))) == NULL ||
+
+         (tc->compStart = (int *) malloc((cap + 2) * sizeof(int))) == NULL ||
+         (tc->compType = (int *) malloc((cap + 1) * sizeof(int))) == NULL ||
+         (tc->compEdges = (int *) malloc((tc->compCapacity + 1) * sizeof(int))) == NULL)
+     {
+         _FreeTricompContext(&tc);
+         return NULL;
+     }
+
+     return tc;
+}
+
+/********************************************************************
+ _FreeTricompContext()
+ ********************************************************************/
+
+void _FreeTricompContext(tricompContextP *pContext)
+{
+tricompContextP tc;
+
+     if (pContext == NULL || (tc = *pContext) == NULL)
+         return;
+
+     if (tc->G != NULL) gp_Free(&tc->G);
+
+     if (tc->src != NULL) free(tc->src);
+     if (tc->tgt != NULL) free(tc->tgt);
+     if (tc->type != NULL) free(tc->type);
+     if (tc->startsPath != NULL) free(tc->startsPath);
+     if (tc->nextArc != NULL) free(tc->nextArc);
+     if (tc->prevArc != NULL) free(tc->prevArc);
+     if (tc->inHigh != NULL) free(tc->inHigh);
+     if (tc->nextHigh != NULL) free(tc->nextHigh);
+     if (tc->prevHigh != NULL) free(tc->prevHigh);
+     if (tc->highValue != NULL) free(tc->highValue);
+
+     if (tc->number != NULL) free(tc->number);
+     if (tc->nodeAt != NULL) free(tc->nodeAt);
+     if (tc->lowpt1 != NULL) free(tc->lowpt1);
+     if (tc->lowpt2 != NULL) free(tc->lowpt2);
+     if (tc->nd != NULL) free(tc->nd);
+     if (tc->degree != NULL) free(tc->degree);
+     if (tc->father != NULL) free(tc->father);
+     if (tc->treeArc != NULL) free(tc->treeArc);
+     if (tc->firstArc != NULL) free(tc->firstArc);
+     if (tc->lastArc != NULL) free(tc->lastArc);
+     if (tc->firstHigh != NULL) free(tc->firstHigh);
+     if (tc->lastHigh != NULL) free(tc->lastHigh);
+     if (tc->currentArc != NULL) free(tc->currentArc);
+     if (tc->pathArc != NULL) free(tc->pathArc);
+     if (tc->pendingArc != NULL) free(tc->pendingArc);
+     if (tc->outDegree != NULL) free(tc->outDegree);
+
+     if (tc->edgeStack != NULL) sp_Free(&tc->edgeStack);
+     if (tc->vertexStack != NULL) sp_Free(&tc->vertexStack);
+     if (tc->tsH != NULL) free(tc->tsH);
+     if (tc->tsA != NULL) free(tc->tsA);
+     if (tc->tsB != NULL) free(tc->tsB);
+
+     if (tc->compStart != NULL) free(tc->compStart);
+     if (tc->compType != NULL) free(tc->compType);
+     if (tc->compEdges != NULL) free(tc->compEdges);
+
+     free(tc);
+     *pContext = NULL;
+}
+
+/********************************************************************
+ _BuildBlockGraph()
+
+ Given the endpoints lo[k] < hi[k] of the block's edges k = 1..M in the
+ block's vertex numbering, replaces each set of parallel edges by a
+ bond split component and one virtual edge, then creates G, a simple
+ graph with one edge for each remaining edge of the block, and has the
+ graph library compute its DFS tree, edge types and lowpoints.
+
+ On return, the vertices of the decomposition are numbered by their
+ DFI in G, and vertexGlobal gives the vertex of theGraph for each one.
+
+ Returns OK on success, NOTOK on failure.
+ ********************************************************************/
+
+int  _BuildBlockGraph(tricompContextP tc, int *lo, int *hi, int *vertexGlobal, int *subToGlobal)
+{
+int  *count = NULL, *byHi = NULL, *order = NULL, *gRep = NULL, *subToDFI = NULL;
+int  N = tc->N, M = tc->M, k, i, j, e, d, numGEdges = 0, RetVal = OK;
+
+     if ((count = (int *) calloc(N + 2, sizeof(int))) == NULL ||
+         (byHi = (int *) malloc(M * sizeof(int))) == NULL ||
+         (order = (int *) malloc(M * sizeof(int))) == NULL ||
+         (gRep = (int *) malloc(M * sizeof(int))) == NULL ||
+         (subToDFI = (int *) malloc((N + 1) * sizeof(int))) == NULL ||
+         (tc->G = gp_New()) == NULL)
+         RetVal = NOTOK;
+
+     // Radix sort the edges by their endpoints so that parallel edges
+     // are adjacent in the order
+     if (RetVal == OK)
+     {
+         for (k = 1; k <= M; k++)
+              count[hi[k]+1]++;
+         for (i = 1; i <= N; i++)
+              count[i+1] += count[i];
+         for (k = 1; k <= M; k++)
+              byHi[count[hi[k]]++] = k;
+
+         for (i = 0; i <= N+1; i++)
+              count[i] = 0;
+         for (k = 1; k <= M; k++)
+              count[lo[k]+1]++;
+         for (i = 1; i <= N; i++)
+              count[i+1] += count[i];
+         for (i = 0; i < M; i++)
+              order[count[lo[byHi[i]]]++] = byHi[i];
+     }
+
+     // Each set of two or more parallel edges becomes a bond with a new
+     // virtual edge that represents the set in G
+     for (i = 0; i < M && RetVal == OK; i = j)
+     {
+         k = order[i];
+         for (j = i+1; j < M && lo[order[j]] == lo[k] && hi[order[j]] == hi[k]; j++)
+              ;
+
+         if (j - i == 1)
+             gRep[numGEdges++] = k;
+         else
+         {
+             if (_NewTricompComp(tc, TRIC_BOND) != OK)
+                 RetVal = NOTOK;
+
+             for (d = i; d < j && RetVal == OK; d++)
+             {
+                  e = order[d];
+                  tc->src[e] = lo[e];
+                  tc->tgt[e] = hi[e];
+                  tc->type[e] = TRIC_REMOVED;
+                  RetVal = _AddToTricompComp(tc, e);
+             }
+
+             if (RetVal == OK)
+             {
+                 if ((e = _NewTricompEdge(tc, lo[k], hi[k], TRIC_UNSEEN)) == NIL)
+                     RetVal = NOTOK;
+                 else
+                 {
+                     gRep[numGEdges++] = e;
+                     RetVal = _AddToTricompComp(tc, e);
+                 }
+             }
+         }
+     }
+
+     if (RetVal == OK)
+     {
+         if (gp_EnsureArcCapacity(tc->G, 2*numGEdges + 2) != OK ||
+             gp_InitGraph(tc->G, N) != OK)
+             RetVal = NOTOK;
+     }
+
+     for (i = 0; i < numGEdges && RetVal == OK; i++)
+     {
+          k = gRep[i];
+          RetVal = gp_AddEdge(tc->G, k <= M ? lo[k] : tc->src[k], 0,
+                                     k <= M ? hi[k] : tc->tgt[k], 0);
+     }
+
+     // Compute the DFS tree, edge types and lowpoints of G, which also
+     // sorts the vertices of G by DFI
+     if (RetVal == OK)
+         RetVal = gp_LowpointAndLeastAncestor(tc->G);
+
+     // The removed parallel edges keep the block's vertex numbering,
+     // so renumber them by DFI
+     if (RetVal == OK)
+     {
+         for (d = 1; d <= N; d++)
+         {
+              subToDFI[gp_GetVertexIndex(tc->G, d)] = d;
+              vertexGlobal[d] = subToGlobal[gp_GetVertexIndex(tc->G, d)];
+         }
+
+         for (e = 1; e <= M; e++)
+              if (tc->type[e] == TRIC_REMOVED)
+              {
+                  tc->src[e] = subToDFI[tc->src[e]];
+                  tc->tgt[e] = subToDFI[tc->tgt[e]];
+              }
+
+         RetVal = _InitBlockDFS(tc, gRep);
+     }
+
+     if (count != NULL) free(count);
+     if (byHi != NULL) free(byHi);
+     if (order != NULL) free(order);
+     if (gRep != NULL) free(gRep);
+     if (subToDFI != NULL) free(subToDFI);
+
+     return RetVal;
+}
+
+/********************************************************************
+ _InitBlockDFS()
+
+ Transfers the DFS of G to the edge and vertex records of the path
+ search.  gRep[i] is the edge record represented by the i-th edge of G.
+ Each edge is directed by its type in G: the arc of type CHILD is a
+ tree edge from parent to child, and the arc of type BACK is a frond
+ from descendant to ancestor.  Then the number of descendants and the
+ second lowpoint of each vertex are computed in decreasing DFI order.
+
+ Returns OK on success, NOTOK if G was not as expected.
+ ********************************************************************/
+
+int  _InitBlockDFS(tricompContextP tc, int *gRep)
+{
+graphP G = tc->G;
+int  N = tc->N, i, e, a, u, v, w, low1, low2;
+
+     for (i = 0, e = gp_GetFirstEdge(G); e < gp_EdgeInUseIndexBound(G); i++, e += 2)
+     {
+          a = e;
+          if (gp_GetEdgeType(G, a) != EDGE_TYPE_CHILD && gp_GetEdgeType(G, a) != EDGE_TYPE_BACK)
+              a = gp_GetTwinArc(G, e);
+
+          u = gp_GetNeighbor(G, gp_GetTwinArc(G, a));
+          w = gp_GetNeighbor(G, a);
+          tc->src[gRep[i]] = u;
+          tc->tgt[gRep[i]] = w;
+          tc->degree[u]++;
+          tc->degree[w]++;
+
+          if (gp_GetEdgeType(G, a) == EDGE_TYPE_CHILD)
+          {
+              tc->type[gRep[i]] = TRIC_TREE;
+              tc->treeArc[w] = gRep[i];
+          }
+          else if (gp_GetEdgeType(G, a) == EDGE_TYPE_BACK)
+              tc->type[gRep[i]] = TRIC_FROND;
+          else
+              return NOTOK;
+     }
+
+     for (v = 1; v <= N; v++)
+     {
+          tc->father[v] = gp_GetVertexParent(G, v);
+          tc->lowpt1[v] = gp_GetVertexLowpoint(G, v);
+          tc->nd[v] = 1;
+     }
+
+     // The block is biconnected, so vertex 1 must be the only DFS tree root
+     if (tc->father[1] != NIL || tc->lowpt1[1] != 1)
+         return NOTOK;
+
+     for (v = N; v >= 1; v--)
+     {
+          low1 = tc->lowpt1[v];
+          low2 = v;
+
+          e = gp_GetFirstArc(G, v);
+          while (gp_IsArc(e))
+          {
+               w = gp_GetNeighbor(G, e);
+               if (gp_GetEdgeType(G, e) == EDGE_TYPE_CHILD)
+               {
+                   if (tc->lowpt1[w] != low1 && tc->lowpt1[w] < low2)
+                       low2 = tc->lowpt1[w];
+                   if (tc->lowpt2[w] < low2)
+                       low2 = tc->lowpt2[w];
+               }
+               else if (gp_GetEdgeType(G, e) == EDGE_TYPE_BACK)
+               {
+                   if (w != low1 && w < low2)
+                       low2 = w;
+               }
+               e = gp_GetNextArc(G, e);
+          }
+
+          tc->lowpt2[v] = low2;
+          if (tc->father[v] != NIL)
+              tc->nd[tc->father[v]] += tc->nd[v];
+     }
+
+     return OK;
+}
+
+/********************************************************************
+ _BuildAcceptableAdjacency()
+
+ Orders the tree edges and fronds leaving each vertex v by the value
+ phi of Hopcroft and Tarjan, as corrected by Gutwenger and Mutzel: a
+ tree edge to w has phi 3*lowpt1(w) if lowpt2(w) < v and 3*lowpt1(w)+2
+ otherwise, and a frond to w has phi 3*w+1.  A bucket sort over all
+ edges builds every adjacency list in linear time.
+
+ Returns OK on success, NOTOK on allocation failure.
+ ********************************************************************/
+
+int  _BuildAcceptableAdjacency(tricompContextP tc)
+{
+int  *bucketHead, *bucketNext;
+int  e, w, phi, maxPhi = 3*tc->N + 2;
+
+     bucketHead = (int *) calloc(maxPhi + 1, sizeof(int));
+     bucketNext = (int *) calloc(tc->numEdges + 1, sizeof(int));
+     if (bucketHead == NULL || bucketNext == NULL)
+     {
+         if (bucketHead != NULL) free(bucketHead);
+         if (bucketNext != NULL) free(bucketNext);
+         return NOTOK;
+     }
+
+     // Edges are pushed in decreasing order so each bucket lists them
+     // in increasing order
+     for (e = tc->numEdges; e >= 1; e--)
+     {
+          if (tc->type[e] != TRIC_TREE && tc->type[e] != TRIC_FROND)
+              continue;
+
+          w = tc->tgt[e];
+          if (tc->type[e] == TRIC_FROND)
+              phi = 3*w + 1;
+          else
+              phi = tc->lowpt2[w] < tc->src[e] ? 3*tc->lowpt1[w] : 3*tc->lowpt1[w] + 2;
+
+          bucketNext[e] = bucketHead[phi];
+          bucketHead[phi] = e;
+     }
+
+     for (phi = 1; phi <= maxPhi; phi++)
+          for (e = bucketHead[phi]; e != NIL; e = bucketNext[e])
+               _TricompAppendArc(tc, e);
+
+     free(bucketHead);
+     free(bucketNext);
+
+     return OK;
+}
+
+/********************************************************************
+ _PathFinder()
+
+ Traverses the DFS tree in the order of the acceptable adjacency
+ structure to mark the first edge of each path, to give each vertex
+ v its new number NEWNUM(v) = numCount - ND(v) + 1, and to build the
+ highpoint lists of the fronds.  The lowpoints are then converted to
+ the new numbering, and nodeAt gives the vertex with each new number.
+
+ The traversal uses vertexStack and the pendingArc of each vertex in
+ place of recursion.
+
+ Returns OK on success, NOTOK on failure.
+ ********************************************************************/
+
+int  _PathFinder(tricompContextP tc)
+{
+stackP theStack = tc->vertexStack;
+int  numCount = tc->N, newPath = TRUE, v, w, e;
+
+     sp_ClearStack(theStack);
+
+     tc->number[1] = numCount - tc->nd[1] + 1;
+     tc->pendingArc[1] = tc->firstArc[1];
+     sp_Push(theStack, 1);
+
+     while (sp_NonEmpty(theStack))
+     {
+          v = sp_Top(theStack);
+          e = tc->pendingArc[v];
+
+          // When the edges of v are exhausted, return to its parent
+          if (e == NIL)
+          {
+              sp_Pop(theStack, v);
+              if (sp_NonEmpty(theStack))
+                  numCount--;
+              continue;
+          }
+
+          tc->pendingArc[v] = tc->nextArc[e];
+          w = tc->tgt[e];
+
+          if (newPath)
+          {
+              newPath = FALSE;
+              tc->startsPath[e] = TRUE;
+          }
+
+          if (tc->type[e] == TRIC_TREE)
+          {
+              tc->number[w] = numCount - tc->nd[w] + 1;
+              tc->pendingArc[w] = tc->firstArc[w];
+              sp_Push(theStack, w);
+          }
+          else
+          {
+              _TricompAppendHigh(tc, w, e, tc->number[v]);
+              newPath = TRUE;
+          }
+     }
+
+     for (v = 1; v <= tc->N; v++)
+     {
+          tc->lowpt1[v] = tc->number[tc->lowpt1[v]];
+          tc->lowpt2[v] = tc->number[tc->lowpt2[v]];
+          tc->nodeAt[tc->number[v]] = v;
+     }
+
+     return OK;
+}
+
+/********************************************************************
+ _PathSearch()
+
+ The path search of Hopcroft and Tarjan with the corrections of
+ Gutwenger and Mutzel.  The vertices are visited in the order of the
+ acceptable adjacency structure, and the type-2 separation pairs are
+ tracked on the triple stack (tsH, tsA, tsB) while the edges of the
+ current segment are collected on edgeStack.  Each split removes the
+ edges of a split component from the graph and replaces them by a
+ virtual edge.  The edges that remain at the end form the last split
+ component.
+
+ Vertex numbers compared in the search are the new numbers from
+ _PathFinder().  As in _PathFinder(), the search is iterative: the
+ state of the search at each vertex v is kept in currentArc[v], the
+ edge currently leaving v; pathArc[v], the edge of the adjacency list
+ that was taken; pendingArc[v], the next edge to take; and outDegree[v],
+ the number of tree edges leaving v that are not yet finished.
+
+ Returns OK on success, NOTOK on failure.
+ ********************************************************************/
+
+int  _PathSearch(tricompContextP tc)
+{
+stackP theStack = tc->vertexStack;
+int  v, w, e, eVirt, u, vnum, wnum, y, b;
+
+     sp_ClearStack(theStack);
+     sp_ClearStack(tc->edgeStack);
+
+     // The bottom of the triple stack is an end-of-segment marker
+     tc->tsTop = 0;
+     tc->tsH[0] = tc->tsB[0] = 0;
+     tc->tsA[0] = TRIC_EOS;
+
+     for (v = 1; v <= tc->N; v++)
+     {
+          tc->pendingArc[v] = tc->firstArc[v];
+          tc->currentArc[v] = tc->pathArc[v] = NIL;
+          tc->outDegree[v] = 0;
+          for (e = tc->firstArc[v]; e != NIL; e = tc->nextArc[e])
+               if (tc->type[e] == TRIC_TREE)
+                   tc->outDegree[v]++;
+     }
+
+     sp_Push(theStack, 1);
+
+     while (sp_NonEmpty(theStack))
+     {
+          v = sp_Top(theStack);
+          vnum = tc->number[v];
+          e = tc->pendingArc[v];
+
+          // When the edges of v are exhausted, return to its parent and
+          // look for the splits at the parent caused by the subtree of v
+          if (e == NIL)
+          {
+              sp_Pop(theStack, v);
+              if (sp_NonEmpty(theStack))
+              {
+                  if (_CheckSplitsAfterChild(tc, sp_Top(theStack), v) != OK)
+                      return NOTOK;
+              }
+              continue;
+          }
+
+          tc->pendingArc[v] = tc->nextArc[e];
+          tc->currentArc[v] = tc->pathArc[v] = e;
+          w = tc->tgt[e];
+          wnum = tc->number[w];
+
+          if (tc->type[e] == TRIC_TREE)
+          {
+              // A new path starting with a tree edge closes the triples
+              // whose a exceeds lowpt1(w) into one triple
+              if (tc->startsPath[e])
+              {
+                  y = 0;
+                  if (tc->tsA[tc->tsTop] > tc->lowpt1[w])
+                  {
+                      do {
+                          if (tc->tsH[tc->tsTop] > y)
+                              y = tc->tsH[tc->tsTop];
+                          b = tc->tsB[tc->tsTop];
+                          tc->tsTop--;
+                      } while (tc->tsA[tc->tsTop] > tc->lowpt1[w]);
+
+                      if (_PushTriple(tc, y, tc->lowpt1[w], b) != OK)
+                          return NOTOK;
+                  }
+                  else if (_PushTriple(tc, wnum + tc->nd[w] - 1, tc->lowpt1[w], vnum) != OK)
+                      return NOTOK;
+
+                  if (_PushTriple(tc, 0, TRIC_EOS, 0) != OK)
+                      return NOTOK;
+              }
+
+              sp_Push(theStack, w);
+          }
+          else
+          {
+              // A new path consisting of a frond closes the triples whose
+              // a exceeds the number of its ancestor endpoint
+              if (tc->startsPath[e])
+              {
+                  y = 0;
+                  if (tc->tsA[tc->tsTop] > wnum)
+                  {
+                      do {
+                          if (tc->tsH[tc->tsTop] > y)
+                              y = tc->tsH[tc->tsTop];
+                          b = tc->tsB[tc->tsTop];
+                          tc->tsTop--;
+                      } while (tc->tsA[tc->tsTop] > wnum);
+
+                      if (_PushTriple(tc, y, wnum, b) != OK)
+                          return NOTOK;
+                  }
+                  else if (_PushTriple(tc, vnum, wnum, vnum) != OK)
+                      return NOTOK;
+              }
+
+              // A frond to the parent is parallel to the tree edge, so the
+              // two are split off as a bond.  Since parallel edges are split
+              // before the search, this only guards against a malformed
+              // adjacency structure.
+              if (w == tc->father[v])
+              {
+                  u = tc->treeArc[v];
+                  if (_NewTricompComp(tc, TRIC_BOND) != OK ||
+                      _AddToTricompComp(tc, e) != OK ||
+                      _AddToTricompComp(tc, u) != OK ||
+                      (eVirt = _NewTricompEdge(tc, w, v, TRIC_TREE)) == NIL ||
+                      _AddToTricompComp(tc, eVirt) != OK)
+                      return NOTOK;
+
+                  _TricompDeleteHigh(tc, e);
+                  _TricompDeleteArc(tc, e);
+                  tc->currentArc[v] = NIL;
+                  _TricompReplaceArc(tc, u, eVirt);
+                  if (tc->currentArc[w] == u)
+                      tc->currentArc[w] = eVirt;
+                  tc->treeArc[v] = eVirt;
+                  tc->degree[v]--;
+                  tc->degree[w]--;
+              }
+              else
+                  sp_Push(tc->edgeStack, e);
+          }
+     }
+
+     // The edges that remain form the last split component
+     if (sp_NonEmpty(tc->edgeStack))
+     {
+         if (_NewTricompComp(tc, TRIC_TRICONNECTED) != OK)
+             return NOTOK;
+
+         while (sp_NonEmpty(tc->edgeStack))
+         {
+             sp_Pop(tc->edgeStack, e);
+             if (_AddToTricompComp(tc, e) != OK)
+                 return NOTOK;
+         }
+     }
+
+     return OK;
+}
+
+/********************************************************************
+ _CheckSplitsAfterChild()
+
+ Called when the path search returns to v from its child w.  The tree
+ edge to w is pushed on the edge stack, then the type-2 separation
+ pairs with a = v are split off, then the type-1 separation pair
+ {lowpt1(w), v} is split off if the subtree of w is attached to the
+ rest of the graph only through it.  Finally, the triples that can no
+ longer yield a separation pair are removed from the triple stack.
+
+ Returns OK on success, NOTOK on failure.
+ ********************************************************************/
+
+int  _CheckSplitsAfterChild(tricompContextP tc, int v, int w)
+{
+int  vnum = tc->number[v], wnum = tc->number[w], e0 = tc->pathArc[v];
+int  a, b, h, x, xy, xs, xt, e1, e2, eab, eVirt, lw, topValid = FALSE;
+
+     sp_Push(tc->edgeStack, tc->treeArc[w]);
+     tc->currentArc[v] = tc->treeArc[w];
+
+     // Type-2 separation pairs
+     while (vnum != 1 && (tc->tsA[tc->tsTop] == vnum ||
+            (tc->degree[w] == 2 && _FirstChildNumber(tc, w) > wnum)))
+     {
+          a = tc->tsA[tc->tsTop];
+          b = tc->tsB[tc->tsTop];
+          eab = NIL;
+
+          // A triple whose b is a child of a does not give a separation pair
+          if (a == vnum && tc->father[tc->nodeAt[b]] == tc->nodeAt[a])
+          {
+              tc->tsTop--;
+              continue;
+          }
+
+          if (tc->degree[w] == 2 && _FirstChildNumber(tc, w) > wnum)
+          {
+              // w has degree 2, so the tree edges v->w->x form a polygon
+              // with a new virtual edge (v, x)
+              sp_Pop(tc->edgeStack, e1);
+              sp_Pop(tc->edgeStack, e2);
+              _TricompDeleteArc(tc, e2);
+
+              x = tc->tgt[e2];
+              if ((eVirt = _NewTricompEdge(tc, v, x, TRIC_UNSEEN)) == NIL)
+                  return NOTOK;
+              tc->degree[x]--;
+              tc->degree[v]--;
+
+              if (_NewTricompComp(tc, TRIC_POLYGON) != OK ||
+                  _AddToTricompComp(tc, e1) != OK ||
+                  _AddToTricompComp(tc, e2) != OK ||
+                  _AddToTricompComp(tc, eVirt) != OK)
+                  return NOTOK;
+
+              if (sp_NonEmpty(tc->edgeStack))
+              {
+                  e1 = sp_Top(tc->edgeStack);
+                  if (tc->src[e1] == x && tc->tgt[e1] == v)
+                  {
+                      sp_Pop(tc->edgeStack, eab);
+                      _TricompDeleteArc(tc, eab);
+                      _TricompDeleteHigh(tc, eab);
+                  }
+              }
+          }
+          else
+          {
+              // The edges on the stack with both endpoints numbered from
+              // a to h form a split component with the virtual edge (a, b)
+              h = tc->tsH[tc->tsTop];
+              tc->tsTop--;
+
+              if (_NewTricompComp(tc, TRIC_TRICONNECTED) != OK)
+                  return NOTOK;
+
+              while (sp_NonEmpty(tc->edgeStack))
+              {
+                   xy = sp_Top(tc->edgeStack);
+                   xs = tc->number[tc->src[xy]];
+                   xt = tc->number[tc->tgt[xy]];
+                   if (xs < a || xs > h || xt < a || xt > h)
+                       break;
+
+                   sp_Pop(tc->edgeStack, xy);
+                   if ((xs == a && xt == b) || (xt == a && xs == b))
+                   {
+                       eab = xy;
+                       _TricompDeleteArc(tc, xy);
+                       _TricompDeleteHigh(tc, xy);
+                   }
+                   else
+                   {
+                       if (xy != tc->currentArc[v])
+                       {
+                           _TricompDeleteArc(tc, xy);
+                           _TricompDeleteHigh(tc, xy);
+                       }
+                       if (_AddToTricompComp(tc, xy) != OK)
+                           return NOTOK;
+                       tc->degree[tc->src[xy]]--;
+                       tc->degree[tc->tgt[xy]]--;
+                   }
+              }
+
+              if ((eVirt = _NewTricompEdge(tc, tc->nodeAt[a], tc->nodeAt[b], TRIC_UNSEEN)) == NIL ||
+                  _AddToTricompComp(tc, eVirt) != OK)
+                  return NOTOK;
+              x = tc->nodeAt[b];
+          }
+
+          // An edge parallel to the new virtual edge is split off as a bond
+          if (eab != NIL)
+          {
+              if (_NewTricompComp(tc, TRIC_BOND) != OK ||
+                  _AddToTricompComp(tc, eab) != OK ||
+                  _AddToTricompComp(tc, eVirt) != OK ||
+                  (eVirt = _NewTricompEdge(tc, v, x, TRIC_UNSEEN)) == NIL ||
+                  _AddToTricompComp(tc, eVirt) != OK)
+                  return NOTOK;
+              tc->degree[x]--;
+              tc->degree[v]--;
+          }
+
+          // The virtual edge becomes the tree edge from v to x
+          sp_Push(tc->edgeStack, eVirt);
+          _TricompReplaceArc(tc, tc->currentArc[v], eVirt);
+          tc->currentArc[v] = eVirt;
+          tc->degree[x]++;
+          tc->degree[v]++;
+          tc->father[x] = v;
+          tc->treeArc[x] = eVirt;
+          tc->type[eVirt] = TRIC_TREE;
+
+          w = x;
+          wnum = tc->number[w];
+     }
+
+     // Type-1 separation pair
+     if (tc->lowpt2[w] >= vnum && tc->lowpt1[w] < vnum &&
+         (tc->father[v] != 1 || tc->outDegree[v] >= 2))
+     {
+         if (_NewTricompComp(tc, TRIC_TRICONNECTED) != OK)
+             return NOTOK;
+
+         xs = xt = 0;
+         while (sp_NonEmpty(tc->edgeStack))
+         {
+              xy = sp_Top(tc->edgeStack);
+              xs = tc->number[tc->src[xy]];
+              xt = tc->number[tc->tgt[xy]];
+              if (!(wnum <= xs && xs < wnum + tc->nd[w]) &&
+                  !(wnum <= xt && xt < wnum + tc->nd[w]))
+              {
+                  topValid = TRUE;
+                  break;
+              }
+
+              sp_Pop(tc->edgeStack, xy);
+              if (_AddToTricompComp(tc, xy) != OK)
+                  return NOTOK;
+              _TricompDeleteHigh(tc, xy);
+              tc->degree[tc->src[xy]]--;
+              tc->degree[tc->tgt[xy]]--;
+         }
+
+         lw = tc->nodeAt[tc->lowpt1[w]];
+         if ((eVirt = _NewTricompEdge(tc, v, lw, TRIC_UNSEEN)) == NIL ||
+             _AddToTricompComp(tc, eVirt) != OK)
+             return NOTOK;
+
+         // A frond from v to lowpt1(w) is parallel to the virtual edge
+         if (topValid && ((xs == vnum && xt == tc->lowpt1[w]) ||
+                          (xt == vnum && xs == tc->lowpt1[w])))
+         {
+             sp_Pop(tc->edgeStack, e1);
+             if (e1 != tc->currentArc[v])
+                 _TricompDeleteArc(tc, e1);
+
+             if (_NewTricompComp(tc, TRIC_BOND) != OK ||
+                 _AddToTricompComp(tc, e1) != OK ||
+                 _AddToTricompComp(tc, eVirt) != OK ||
+                 (eVirt = _NewTricompEdge(tc, v, lw, TRIC_UNSEEN)) == NIL ||
+                 _AddToTricompComp(tc, eVirt) != OK)
+                 return NOTOK;
+
+             _TricompReplaceHigh(tc, e1, eVirt);
+             tc->degree[v]--;
+             tc->degree[lw]--;
+         }
+
+         if (lw != tc->father[v])
+         {
+             // The virtual edge becomes a frond from v to lowpt1(w)
+             sp_Push(tc->edgeStack, eVirt);
+             _TricompReplaceArc(tc, tc->currentArc[v], eVirt);
+             tc->currentArc[v] = eVirt;
+             tc->type[eVirt] = TRIC_FROND;
+             if (tc->inHigh[eVirt] == NIL && _TricompGetHigh(tc, lw) < vnum)
+                 _TricompPrependHigh(tc, lw, eVirt, vnum);
+             tc->degree[v]++;
+             tc->degree[lw]++;
+         }
+         else
+         {
+             // The virtual edge is parallel to the tree edge from the
+             // parent of v, so the two form a bond whose new virtual
+             // edge becomes the tree edge to v
+             _TricompDeleteArc(tc, tc->currentArc[v]);
+             tc->currentArc[v] = NIL;
+
+             e2 = tc->treeArc[v];
+             if (_NewTricompComp(tc, TRIC_BOND) != OK ||
+                 _AddToTricompComp(tc, eVirt) != OK ||
+                 (eVirt = _NewTricompEdge(tc, lw, v, TRIC_TREE)) == NIL ||
+                 _AddToTricompComp(tc, eVirt) != OK ||
+                 _AddToTricompComp(tc, e2) != OK)
+                 return NOTOK;
+
+             _TricompReplaceArc(tc, e2, eVirt);
+             if (tc->currentArc[lw] == e2)
+                 tc->currentArc[lw] = eVirt;
+             tc->treeArc[v] = eVirt;
+         }
+     }
+
+     // The triples of a path that began with the edge to w are finished
+     if (tc->startsPath[e0])
+     {
+         while (tc->tsA[tc->tsTop] != TRIC_EOS)
+              tc->tsTop--;
+         tc->tsTop--;
+     }
+
+     while (tc->tsA[tc->tsTop] != TRIC_EOS && tc->tsA[tc->tsTop] != vnum &&
+            tc->tsB[tc->tsTop] != vnum && _TricompGetHigh(tc, v) > tc->tsH[tc->tsTop])
+          tc->tsTop--;
+
+     tc->outDegree[v]--;
+
+     return OK;
+}
+
+/********************************************************************
+ Helpers for the edge records, adjacency lists, highpoint lists,
+ triple stack and split components of the path search.
+ ********************************************************************/
+
+int  _NewTricompEdge(tricompContextP tc, int u, int v, int type)
+{
+int  e;
+
+     if (tc->numEdges >= tc->capacity)
+         return NIL;
+
+     e = ++tc->numEdges;
+     tc->src[e] = u;
+     tc->tgt[e] = v;
+     tc->type[e] = type;
+     tc->startsPath[e] = FALSE;
+     tc->nextArc[e] = tc->prevArc[e] = NIL;
+     tc->inHigh[e] = tc->nextHigh[e] = tc->prevHigh[e] = NIL;
+
+     return e;
+}
+
+int  _NewTricompComp(tricompContextP tc, int type)
+{
+     if (tc->numComps >= tc->capacity)
+         return NOTOK;
+
+     tc->compType[tc->numComps] = type;
+     tc->compStart[tc->numComps] = tc->compLen;
+     tc->numComps++;
+     tc->compStart[tc->numComps] = tc->compLen;
+
+     return OK;
+}
+
+int  _AddToTricompComp(tricompContextP tc, int e)
+{
+     if (tc->compLen >= tc->compCapacity)
+         return NOTOK;
+
+     tc->compEdges[tc->compLen++] = e;
+     tc->compStart[tc->numComps] = tc->compLen;
+
+     return OK;
+}
+
+int  _PushTriple(tricompContextP tc, int h, int a, int b)
+{
+     if (tc->tsTop >= tc->tsCapacity)
+         return NOTOK;
+
+     tc->tsTop++;
+     tc->tsH[tc->tsTop] = h;
+     tc->tsA[tc->tsTop] = a;
+     tc->tsB[tc->tsTop] = b;
+
+     return OK;
+}
+
+int  _FirstChildNumber(tricompContextP tc, int v)
+{
+int  e = tc->firstArc[v];
+
+     return e != NIL && tc->type[e] == TRIC_TREE ? tc->number[tc->tgt[e]] : 0;
+}
+
+void _TricompAppendArc(tricompContextP tc, int e)
+{
+int  v = tc->src[e];
+
+     tc->prevArc[e] = tc->lastArc[v];
+     tc->nextArc[e] = NIL;
+     if (tc->lastArc[v] != NIL)
+         tc->nextArc[tc->lastArc[v]] = e;
+     else
+         tc->firstArc[v] = e;
+     tc->lastArc[v] = e;
+}
+
+void _TricompDeleteArc(tricompContextP tc, int e)
+{
+int  v = tc->src[e];
+
+     if (tc->prevArc[e] != NIL)
+         tc->nextArc[tc->prevArc[e]] = tc->nextArc[e];
+     else if (tc->firstArc[v] == e)
+         tc->firstArc[v] = tc->nextArc[e];
+     else
+         return;
+
+     if (tc->nextArc[e] != NIL)
+         tc->prevArc[tc->nextArc[e]] = tc->prevArc[e];
+     else
+         tc->lastArc[v] = tc->prevArc[e];
+
+     tc->nextArc[e] = tc->prevArc[e] = NIL;
+}
+
+// Puts eNew in the place of e in the adjacency list of the source of e,
+// which must also be the source of eNew
+void _TricompReplaceArc(tricompContextP tc, int e, int eNew)
+{
+int  v = tc->src[e];
+
+     tc->prevArc[eNew] = tc->prevArc[e];
+     tc->nextArc[eNew] = tc->nextArc[e];
+
+     if (tc->prevArc[e] != NIL)
+         tc->nextArc[tc->prevArc[e]] = eNew;
+     else
+         tc->firstArc[v] = eNew;
+
+     if (tc->nextArc[e] != NIL)
+         tc->prevArc[tc->nextArc[e]] = eNew;
+     else
+         tc->lastArc[v] = eNew;
+
+     tc->nextArc[e] = tc->prevArc[e] = NIL;
+}
+
+void _TricompAppendHigh(tricompContextP tc, int v, int e, int value)
+{
+     tc->inHigh[e] = v;
+     tc->highValue[e] = value;
+     tc->prevHigh[e] = tc->lastHigh[v];
+     tc->nextHigh[e] = NIL;
+     if (tc->lastHigh[v] != NIL)
+         tc->nextHigh[tc->lastHigh[v]] = e;
+     else
+         tc->firstHigh[v] = e;
+     tc->lastHigh[v] = e;
+}
+
+void _TricompPrependHigh(tricompContextP tc, int v, int e, int value)
+{
+     tc->inHigh[e] = v;
+     tc->highValue[e] = value;
+     tc->nextHigh[e] = tc->firstHigh[v];
+     tc->prevHigh[e] = NIL;
+     if (tc->firstHigh[v] != NIL)
+         tc->prevHigh[tc->firstHigh[v]] = e;
+     else
+         tc->lastHigh[v] = e;
+     tc->firstHigh[v] = e;
+}
+
+void _TricompDeleteHigh(tricompContextP tc, int e)
+{
+int  v = tc->inHigh[e];
+
+     if (v == NIL)
+         return;
+
+     if (tc->prevHigh[e] != NIL)
+         tc->nextHigh[tc->prevHigh[e]] = tc->nextHigh[e];
+     else
+         tc->firstHigh[v] = tc->nextHigh[e];
+
+     if (tc->nextHigh[e] != NIL)
+         tc->prevHigh[tc->nextHigh[e]] = tc->prevHigh[e];
+     else
+         tc->lastHigh[v] = tc->prevHigh[e];
+
+     tc->inHigh[e] = tc->nextHigh[e] = tc->prevHigh[e] = NIL;
+}
+
+// Puts eNew in the place of e in the highpoint list that holds e
+void _TricompReplaceHigh(tricompContextP tc, int e, int eNew)
+{
+int  v = tc->inHigh[e];
+
+     if (v == NIL)
+         return;
+
+     tc->inHigh[eNew] = v;
+     tc->highValue[eNew] = tc->highValue[e];
+     tc->prevHigh[eNew] = tc->prevHigh[e];
+     tc->nextHigh[eNew] = tc->nextHigh[e];
+
+     if (tc->prevHigh[e] != NIL)
+         tc->nextHigh[tc->prevHigh[e]] = eNew;
+     else
+         tc->firstHigh[v] = eNew;
+
+     if (tc->nextHigh[e] != NIL)
+         tc->prevHigh[tc->nextHigh[e]] = eNew;
+     else
+         tc->lastHigh[v] = eNew;
+
+     tc->inHigh[e] = tc->nextHigh[e] = tc->prevHigh[e] = NIL;
+}
+
+int  _TricompGetHigh(tricompContextP tc, int v)
+{
+     return tc->firstHigh[v] != NIL ? tc->highValue[tc->firstHigh[v]] : 0;
+}
+
+/********************************************************************
+ _EmitBlockNodes()
+
+ Turns the split components found by the path search into the nodes
+ of the SPQR tree of the block, and appends them to theTree.
+
+ Each split component is classified by its structure as a bond (two
+ vertices), a polygon (a cycle) or a triconnected graph.  Then the
+ bonds that share a virtual edge are merged, as are the polygons that
+ share a virtual edge, which makes the decomposition unique.  Each
+ resulting group of components becomes one node, whose edges are those
+ of its components except the virtual edges shared within the group.
+ The remaining virtual edges join two nodes and are the edges of the
+ tree.  The edges of an S-node are put in cycle order.
+
+ Returns OK on success, NOTOK on failure.
+ ********************************************************************/
+
+int  _EmitBlockNodes(spqrTreeP theTree, tricompContextP tc, int block,
+                     int *blockArcs, int *vertexGlobal, int nodeCapacity, int edgeCapacity)
+{
+int  *comp1=NULL, *comp2=NULL, *virtualId=NULL, *classOf=NULL, *classStart=NULL, *work=NULL;
+int  *vertexMark=NULL, *incident1=NULL, *incident2=NULL, *classEdges=NULL;
+int  numComps = tc->numComps, numEdges = tc->numEdges, M = tc->M, N = tc->N;
+int  nodeBase = theTree->numNodes, edgeBase = theTree->nodeEdgeStart[theTree->numNodes];
+int  numClasses = 0, numKept = 0, c, d, i, e, k, top, arc, RetVal = OK;
+
+     if ((comp1 = (int *) malloc((numEdges + 1) * sizeof(int))) == NULL ||
+         (comp2 = (int *) malloc((numEdges + 1) * sizeof(int))) == NULL ||
+         (virtualId = (int *) malloc((numEdges + 1) * sizeof(int))) == NULL ||
+         (classOf = (int *) malloc((numComps + 1) * sizeof(int))) == NULL ||
+         (classStart = (int *) calloc(numComps + 2, sizeof(int))) == NULL ||
+         (work = (int *) malloc((tc->compLen + 1) * sizeof(int))) == NULL ||
+         (vertexMark = (int *) calloc(N + 1, sizeof(int))) == NULL ||
+         (incident1 = (int *) malloc((N + 1) * sizeof(int))) == NULL ||
+         (incident2 = (int *) malloc((N + 1) * sizeof(int))) == NULL ||
+         (classEdges = (int *) malloc((tc->compLen + 1) * sizeof(int))) == NULL)
+         RetVal = NOTOK;
+
+     if (RetVal == OK)
+     {
+         // incident1 serves as the degree counter of the classification
+         _ClassifyComponents(tc, vertexMark, incident1);
+
+         // Find the components containing each edge.  A real edge must be
+         // in one component and a virtual edge in two.
+         for (e = 1; e <= numEdges; e++)
+              comp1[e] = comp2[e] = virtualId[e] = -1;
+
+         for (c = 0; c < numComps && RetVal == OK; c++)
+              for (i = tc->compStart[c]; i < tc->compStart[c+1]; i++)
+              {
+                   e = tc->compEdges[i];
+                   if (comp1[e] < 0)
+                       comp1[e] = c;
+                   else if (comp2[e] < 0 && e > M)
+                       comp2[e] = c;
+                   else
+                       RetVal = NOTOK;
+              }
+
+         for (e = 1; e <= numEdges && RetVal == OK; e++)
+              if (e <= M ? comp1[e] < 0 : comp2[e] < 0)
+                  RetVal = NOTOK;
+     }
+
+     // Group the bonds joined by virtual edges, and likewise the polygons
+     if (RetVal == OK)
+     {
+         for (c = 0; c < numComps; c++)
+              classOf[c] = -1;
+
+         for (c = 0; c < numComps; c++)
+         {
+              if (classOf[c] >= 0)
+                  continue;
+
+              classOf[c] = numClasses;
+              work[top = 0] = c;
+              while (top >= 0)
+              {
+                   d = work[top--];
+                   if (tc->compType[d] == TRIC_TRICONNECTED)
+                       continue;
+
+                   for (i = tc->compStart[d]; i < tc->compStart[d+1]; i++)
+                   {
+                        e = tc->compEdges[i];
+                        if (e <= M)
+                            continue;
+
+                        k = comp1[e] == d ? comp2[e] : comp1[e];
+                        if (classOf[k] < 0 && tc->compType[k] == tc->compType[d])
+                        {
+                            classOf[k] = numClasses;
+                            work[++top] = k;
+                        }
+                   }
+              }
+
+              numClasses++;
+         }
+     }
+
+     // Gather the edges of each group, leaving out the virtual edges
+     // shared by two components of the group
+     if (RetVal == OK)
+     {
+         for (c = 0; c < numComps; c++)
+              for (i = tc->compStart[c]; i < tc->compStart[c+1]; i++)
+              {
+                   e = tc->compEdges[i];
+                   if (e > M && classOf[comp1[e]] == classOf[comp2[e]])
+                       continue;
+                   classStart[classOf[c]+1]++;
+              }
+
+         for (k = 0; k < numClasses; k++)
+              classStart[k+1] += classStart[k];
+         numKept = classStart[numClasses];
+
+         if (nodeBase + numClasses > nodeCapacity || edgeBase + numKept > edgeCapacity)
+             RetVal = NOTOK;
+     }
+
+     if (RetVal == OK)
+     {
+         for (c = 0; c < numComps; c++)
+         {
+              theTree->nodeType[nodeBase + classOf[c]] =
+                      tc->compType[c] == TRIC_BOND ? SPQR_PNODE :
+                      tc->compType[c] == TRIC_POLYGON ? SPQR_SNODE : SPQR_RNODE;
+
+              for (i = tc->compStart[c]; i < tc->compStart[c+1]; i++)
+              {
+                   e = tc->compEdges[i];
+                   if (e > M && classOf[comp1[e]] == classOf[comp2[e]])
+                       continue;
+                   classEdges[classStart[classOf[c]]++] = e;
+              }
+         }
+
+         for (k = numClasses; k > 0; k--)
+              classStart[k] = classStart[k-1];
+         classStart[0] = 0;
+
+         for (k = 0; k < numClasses; k++)
+              if (theTree->nodeType[nodeBase + k] == SPQR_SNODE)
+                  _OrderCycle(tc, classEdges + classStart[k], classStart[k+1] - classStart[k],
+                              numComps + 1 + k, vertexMark, incident1, incident2, work);
+     }
+
+     // Report the nodes, their edges and the virtual edges between them
+     if (RetVal == OK)
+     {
+         for (k = 0; k < numClasses; k++)
+         {
+              theTree->nodeBlock[nodeBase + k] = block;
+              theTree->nodeEdgeStart[nodeBase + k] = edgeBase + classStart[k];
+
+              for (i = classStart[k]; i < classStart[k+1]; i++)
+              {
+                   e = classEdges[i];
+                   if (e <= M)
+                   {
+                       arc = blockArcs[e-1];
+                       theTree->nodeEdges[edgeBase + i] = arc;
+                       theTree->edgeNode[arc] = nodeBase + k;
+                       theTree->edgeNode[gp_GetTwinArc(theGraph, arc)] = nodeBase + k;
+                   }
+                   else
+                   {
+                       if (virtualId[e] < 0)
+                       {
+                           d = virtualId[e] = theTree->numVirtualEdges++;
+                           theTree->virtualEdgeEnds[2*d] = vertexGlobal[tc->src[e]];
+                           theTree->virtualEdgeEnds[2*d+1] = vertexGlobal[tc->tgt[e]];
+                           theTree->virtualEdgeNodes[2*d] = nodeBase + classOf[comp1[e]];
+                           theTree->virtualEdgeNodes[2*d+1] = nodeBase + classOf[comp2[e]];
+                       }
+                       theTree->nodeEdges[edgeBase + i] = -1 - virtualId[e];
+                   }
+              }
+         }
+
+         theTree->numNodes += numClasses;
+         theTree->nodeEdgeStart[theTree->numNodes] = edgeBase + numKept;
+     }
+
+     if (comp1 != NULL) free(comp1);
+     if (comp2 != NULL) free(comp2);
+     if (virtualId != NULL) free(virtualId);
+     if (classOf != NULL) free(classOf);
+     if (classStart != NULL) free(classStart);
+     if (work != NULL) free(work);
+     if (vertexMark != NULL) free(vertexMark);
+     if (incident1 != NULL) free(incident1);
+     if (incident2 != NULL) free(incident2);
+     if (classEdges != NULL) free(classEdges);
+
+     return RetVal;
+}
+
+/********************************************************************
+ _ClassifyComponents()
+
+ Sets the type of each split component from its structure: a bond has
+ two vertices, a polygon has only vertices of degree two, and any other
+ component is triconnected.  The vertexMark array must be zero on entry
+ and receives the marks 1 to numComps, and vertexCount is scratch space.
+ ********************************************************************/
+
+void _ClassifyComponents(tricompContextP tc, int *vertexMark, int *vertexCount)
+{
+int  c, i, e, x, j, numVertices, isCycle;
+
+     for (c = 0; c < tc->numComps; c++)
+     {
+          numVertices = 0;
+          for (i = tc->compStart[c]; i < tc->compStart[c+1]; i++)
+          {
+               e = tc->compEdges[i];
+               for (j = 0; j < 2; j++)
+               {
+                    x = j == 0 ? tc->src[e] : tc->tgt[e];
+                    if (vertexMark[x] != c + 1)
+                    {
+                        vertexMark[x] = c + 1;
+                        vertexCount[x] = 0;
+                        numVertices++;
+                    }
+                    vertexCount[x]++;
+               }
+          }
+
+          isCycle = TRUE;
+          for (i = tc->compStart[c]; i < tc->compStart[c+1]; i++)
+          {
+               e = tc->compEdges[i];
+               if (vertexCount[tc->src[e]] != 2 || vertexCount[tc->tgt[e]] != 2)
+                   isCycle = FALSE;
+          }
+
+          tc->compType[c] = numVertices == 2 ? TRIC_BOND :
+                            (isCycle ? TRIC_POLYGON : TRIC_TRICONNECTED);
+     }
+}
+
+/********************************************************************
+ _OrderCycle()
+
+ Reorders the numEdges edges of a cycle so that consecutive edges share
+ a vertex.  The mark must differ from all marks already in vertexMark,
+ and incident1, incident2 and scratch are scratch space.
+ ********************************************************************/
+
+void _OrderCycle(tricompContextP tc, int *edges, int numEdges, int mark,
+                 int *vertexMark, int *incident1, int *incident2, int *scratch)
+{
+int  i, j, x, prev, next;
+
+     for (i = 0; i < numEdges; i++)
+          for (j = 0; j < 2; j++)
+          {
+               x = j == 0 ? tc->src[edges[i]] : tc->tgt[edges[i]];
+               if (vertexMark[x] != mark)
+               {
+                   vertexMark[x] = mark;
+                   incident1[x] = i;
+               }
+               else
+                   incident2[x] = i;
+          }
+
+     scratch[0] = edges[0];
+     x = tc->tgt[edges[0]];
+     prev = 0;
+     for (i = 1; i < numEdges; i++)
+     {
+          next = incident1[x] == prev ? incident2[x] : incident1[x];
+          scratch[i] = edges[next];
+          x = tc->src[edges[next]] == x ? tc->tgt[edges[next]] : tc->src[edges[next]];
+          prev = next;
+     }
+
+     for (i = 0; i < numEdges; i++)
+          edges[i] = scratch[i];
+}
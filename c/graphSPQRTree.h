@@ -0,0 +1,108 @@
+#ifndef GRAPH_SPQRTREE_H
+#define GRAPH_SPQRTREE_H
+
+/*
+Planarity-Related Graph Algorithms Project
+Copyright (c) 1997-2012, John M. Boyer
+All rights reserved. Includes a reference implementation of the following:
+
+* John M. Boyer. "Subgraph Homeomorphism via the Edge Addition Planarity Algorithm".
+  Journal of Graph Algorithms and Applications, Vol. 16, no. 2, pp. 381-410, 2012.
+  http://www.jgaa.info/16/268.html
+
+* John M. Boyer. "A New Method for Efficiently Generating Planar Graph
+  Visibility Representations". In P. Eades and P. Healy, editors,
+  Proceedings of the 13th International Conference on Graph Drawing 2005,
+  Lecture Notes Comput. Sci., Volume 3843, pp. 508-511, Springer-Verlag, 2006.
+
+* John M. Boyer and Wendy J. Myrvold. "On the Cutting Edge: Simplified O(n)
+  Planarity by Edge Addition". Journal of Graph Algorithms and Applications,
+  Vol. 8, No. 3, pp. 241-273, 2004.
+  http://www.jgaa.info/08/91.html
+
+* John M. Boyer. "Simplified O(n) Algorithms for Planar Graph Embedding,
+  Kuratowski Subgraph Isolation, and Related Problems". Ph.D. Dissertation,
+  University of Victoria, 2001.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+* Redistributions of source code must retain the above copyright notice, this
+  list of conditions and the following disclaimer.
+
+* Redistributions in binary form must reproduce the above copyright notice, this
+  list of conditions and the following disclaimer in the documentation and/or
+  other materials provided with the distribution.
+
+* Neither the name of the Planarity-Related Graph Algorithms Project nor the names
+  of its contributors may be used to endorse or promote products derived from this
+  software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include "graphStructures.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Node types of an SPQR tree.  The skeleton of an S-node is a cycle, the
+   skeleton of a P-node is a bond (two vertices joined by two or more
+   edges), and the skeleton of an R-node is a triconnected simple graph.
+   A block consisting of a single edge has no triconnected components,
+   so it is given a Q-node whose skeleton is that edge. */
+
+#define SPQR_SNODE  1
+#define SPQR_PNODE  2
+#define SPQR_RNODE  3
+#define SPQR_QNODE  4
+
+/* The SPQR trees of the blocks (biconnected components) of a graph, in
+   flat arrays indexed from zero.  There is one tree per block, so the
+   trees of blocks that share a cut vertex are not joined by tree edges.
+
+   numNodes, nodeType[i], nodeBlock[i]: the nodes, their types and the
+       number of the block containing each node.
+   nodeEdgeStart[i] .. nodeEdgeStart[i+1]-1: the positions in nodeEdges
+       of the skeleton edges of node i.  A skeleton edge is either a real
+       edge, stored as the lesser arc of its edge record pair, or virtual
+       edge k, stored as -1-k.  The edges of an S-node are in cycle order.
+   numVirtualEdges, virtualEdgeEnds[2k], virtualEdgeEnds[2k+1]: the two
+       graph vertices joined by virtual edge k.
+   virtualEdgeNodes[2k], virtualEdgeNodes[2k+1]: the two nodes whose
+       skeletons contain virtual edge k, i.e. the tree edge it represents.
+   edgeNode[e]: the node containing the edge of arc e, or -1 for a
+       self-loop or an edge record that is not in use.
+ */
+
+typedef struct
+{
+     int  numNodes, numVirtualEdges, numBlocks;
+     int  *nodeType, *nodeBlock, *nodeEdgeStart, *nodeEdges;
+     int  *virtualEdgeEnds, *virtualEdgeNodes;
+     int  *edgeNode;
+} spqrTreeRec;
+
+typedef spqrTreeRec * spqrTreeP;
+
+#define spqr_IsVirtualEdge(x)      ((x) < 0)
+#define spqr_GetVirtualEdge(x)     (-1-(x))
+
+int  gp_CreateSPQRTree(graphP theGraph, spqrTreeP *pSPQRTree);
+void gp_FreeSPQRTree(spqrTreeP *pSPQRTree);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
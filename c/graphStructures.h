@@ -57,6 +57,8 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 #include "graphFunctionTable.h"
 #include "graphExtensions.private.h"
+#include "graphTrace.h"
+#include "platformMemory.h"
 
 #ifdef __cplusplus
 extern "C" {
@@ -565,6 +567,12 @@ typedef isolatorContext * isolatorContextP;
 #define MINORTYPE_E6        1024
 #define MINORTYPE_E7        2048
 
+/* The maximum number of distinct extension modules (see gp_AddExtension()).
+   Module IDs run from 1 to this value, and each graph reserves one
+   context slot per module ID. */
+
+#define GRAPH_MAXEXTENSIONS 32
+
 /********************************************************************
  Graph structure definition
         V : Array of vertex records (allocated size N + NV)
@@ -588,10 +596,22 @@ typedef isolatorContext * isolatorContextP;
         extFace: Array of (N + NV) external face short circuit records
 
         extensions: a list of extension data structures
+        extensionContexts: the context of each attached extension, indexed by
+                   module ID so that overloads can find their context in
+                   constant time; unused entries are NULL
         functions: a table of function pointers that can be overloaded to provide
                    extension behaviors to the graph
+        trace: the event trace ring buffer, or NULL if tracing is not enabled
+        preprocessCache: the result of gp_PreprocessForEmbedding() on a copy of
+                   the graph, or NULL if there is none (see gp_CachePreprocessing())
+
+        VMemory, VIMemory, EMemory, extFaceMemory: describe the memory allocated
+                for V, VI, E and extFace, which lets a graph copy share these
+                arrays copy-on-write with the original graph
 */
 
+struct preprocessCache;
+
 typedef struct
 {
         vertexRecP V;
@@ -610,12 +630,35 @@ typedef struct
         extFaceLinkRecP extFace;
 
         graphExtensionP extensions;
+        void *extensionContexts[GRAPH_MAXEXTENSIONS+1];
         graphFunctionTable functions;
 
+        traceBufferP trace;
+        struct preprocessCache *preprocessCache;
+
+        platform_memory VMemory, VIMemory, EMemory, extFaceMemory;
+
 } baseGraphStructure;
 
 typedef baseGraphStructure * graphP;
 
+/* Preprocessing cache:
+        theGraph: a copy of the graph on which gp_PreprocessForEmbedding()
+                has been run
+        refCount: the number of graphs sharing the cache.  Graph copies made
+                by gp_CopyGraph() and gp_DupGraph() share the cache of the
+                original graph, so the count is not safe to change from
+                several threads at once.
+*/
+
+typedef struct preprocessCache
+{
+        graphP theGraph;
+        int refCount;
+} preprocessCacheRec;
+
+typedef preprocessCacheRec * preprocessCacheP;
+
 /* Flags for graph:
         FLAGS_DFSNUMBERED is set if DFSNumber() has succeeded for the graph
         FLAGS_SORTEDBYDFI records whether the graph is in original vertex
@@ -627,12 +670,18 @@ typedef baseGraphStructure * graphP;
                 gp_TestEmbedResultIntegrity() to decide what integrity tests to run.
         FLAGS_ZEROBASEDIO is typically set by gp_Read() to indicate that the
         		adjacency list representation began with index 0.
+        FLAGS_EMBEDPREPROCESSED is set by gp_PreprocessForEmbedding() to indicate
+                that the DFS, sort and lowpoint work of gp_Embed() is done.
+                It is cleared by gp_Embed() once the embedding begins.
+                A graph with a preprocessCache gets this flag by copying the
+                cached graph rather than by repeating the work.
 */
 
 #define FLAGS_DFSNUMBERED       1
 #define FLAGS_SORTEDBYDFI       2
 #define FLAGS_OBSTRUCTIONFOUND  4
 #define FLAGS_ZEROBASEDIO		8
+#define FLAGS_EMBEDPREPROCESSED 16
 
 /********************************************************************
  More link structure accessors/manipulators
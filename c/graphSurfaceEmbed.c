@@ -0,0 +1,1849 @@
+/*
+Planarity-Related Graph Algorithms Project
+Copyright (c) 1997-2012, John M. Boyer
+All rights reserved. Includes a reference implementation of the following:
+
+* John M. Boyer. "Subgraph Homeomorphism via the Edge Addition Planarity Algorithm".
+  Journal of Graph Algorithms and Applications, Vol. 16, no. 2, pp. 381-410, 2012.
+  http://www.jgaa.info/16/268.html
+
+* John M. Boyer. "A New Method for Efficiently Generating Planar Graph
+  Visibility Representations". In P. Eades and P. Healy, editors,
+  Proceedings of the 13th International Conference on Graph Drawing 2005,
+  Lecture Notes Comput. Sci., Volume 3843, pp. 508-511, Springer-Verlag, 2006.
+
+* John M. Boyer and Wendy J. Myrvold. "On the Cutting Edge: Simplified O(n)
+  Planarity by Edge Addition". Journal of Graph Algorithms and Applications,
+  Vol. 8, No. 3, pp. 241-273, 2004.
+  http://www.jgaa.info/08/91.html
+
+* John M. Boyer. "Simplified O(n) Algorithms for Planar Graph Embedding,
+  Kuratowski Subgraph Isolation, and Related Problems". Ph.D. Dissertation,
+  University of Victoria, 2001.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+* Redistributions of source code must retain the above copyright notice, this
+  list of conditions and the following disclaimer.
+
+* Redistributions in binary form must reproduce the above copyright notice, this
+  list of conditions and the following disclaimer in the documentation and/or
+  other materials provided with the distribution.
+
+* Neither the name of the Planarity-Related Graph Algorithms Project nor the names
+  of its contributors may be used to endorse or promote products derived from this
+  software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include "graphSurfaceEmbed.h"
+#include "graphSurfaceEmbed.private.h"
+
+#include "graph.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+/* Imported functions */
+
+extern void _InitEdges(graphP theGraph);
+
+/* Private definitions */
+
+// The memoization of failed search states stops growing once the keys
+// stored reach this many integers
+#define SURFACEEMBED_MEMO_LIMIT (1L << 24)
+
+typedef struct
+{
+    SurfaceEmbedContext *context;
+    int maxEulerGenus, orientable;
+
+    // The copy of the input graph, in which the edges of the Kuratowski
+    // subgraph isolated by the core planarity algorithm are marked, and
+    // the block (biconnected component) of each edge, both indexed by the
+    // arc index divided by two.  The search is confined to the block of
+    // the Kuratowski subgraph, the other blocks must be planar.
+    graphP G;
+    int *inH, *edgeBlock, theBlock;
+
+    // The planar embedding of the edges of G that are not in the block,
+    // and the arc of G corresponding to each of its arcs
+    graphP Gp;
+    int *gpArcMap;
+
+    // The reduced block R, whose vertices are the vertices of degree at
+    // least 3 in the block and whose edges are the paths of the block
+    // between them.  Edge i of R has arcs 2i and 2i+1, each with the vertex
+    // at which it starts and the first arc of G on its path.  The adjacency
+    // lists are stored consecutively, starting at adjStart for each vertex.
+    int numRVertices, numREdges;
+    int *degreeInBlock, *RVertexOf, *GVertexOf;
+    int *arcVertex, *chainArc, *RInH, *adjStart, *adjArcs;
+
+    // The order in which the edges of R are embedded, and the position of
+    // each edge in the order
+    int *order, *orderPos;
+
+    // The rotation system built by the search: the next and previous arcs
+    // around the vertex of each embedded arc, whether each embedded edge is
+    // twisted (passes through a crosscap), an arc of each embedded vertex
+    // and the number of arcs embedded at each vertex
+    int *rnext, *rprev, *twisted, *anyArc, *embeddedDegree;
+    int numV, numE;
+
+    // The face tracing: each state is an arc and an orientation, and the
+    // states are partitioned into orbits, two of which traverse each face in
+    // opposite directions.  The face of a corner between an arc and its next
+    // arc is the lesser of its two orbits, and the faces of the corners of
+    // the vertices to which a subgraph attaches are tallied with faceCall
+    // and faceHits.
+    int *orbit, *orbitStart, numOrbits, *cornerFace;
+    int *faceCall, *faceHits, callId;
+
+    // Work arrays for the forward check and the memoization keys
+    int *mark, *queue, *attach, *seq, *faceSeqStart, *faceSeqLen, markId;
+
+    // The hash set of the keys of the search states that failed
+    int **memo, memoSize, memoCount;
+    long memoInts;
+} surfaceSearchRec;
+
+typedef surfaceSearchRec * surfaceSearchRecP;
+
+/* Private functions exported to system */
+
+int  _CopySurfaceEmbedGraph(SurfaceEmbedContext *context);
+int  _SearchForSurfaceEmbedding(SurfaceEmbedContext *context);
+int  _CheckSurfaceEmbeddingIntegrity(graphP theGraph, int maxEulerGenus, int orientable);
+
+/* Private functions */
+
+int  _SurfaceEmbed_Init(surfaceSearchRecP s, SurfaceEmbedContext *context);
+void _SurfaceEmbed_Free(surfaceSearchRecP s);
+int  _SurfaceEmbed_MarkObstruction(surfaceSearchRecP s);
+int  _SurfaceEmbed_FindBlocks(surfaceSearchRecP s);
+int  _SurfaceEmbed_EmbedOtherBlocks(surfaceSearchRecP s);
+int  _SurfaceEmbed_ReduceBlock(surfaceSearchRecP s);
+int  _SurfaceEmbed_OrderEdges(surfaceSearchRecP s);
+int  _SurfaceEmbed_AddEar(surfaceSearchRecP s, int *placed, int *numOrdered, int HOnly);
+int  _SurfaceEmbed_Search(surfaceSearchRecP s, int k);
+int  _SurfaceEmbed_SearchClosingEdge(surfaceSearchRecP s, int k, int eg, int p, int q);
+int  _SurfaceEmbed_TraceFaces(surfaceSearchRecP s, int k);
+int  _SurfaceEmbed_NextState(surfaceSearchRecP s, int state);
+int  _SurfaceEmbed_BridgesFit(surfaceSearchRecP s, int k);
+int  _SurfaceEmbed_AttachmentsShareFace(surfaceSearchRecP s, int *attach, int numAttach);
+int *_SurfaceEmbed_MakeKey(surfaceSearchRecP s, int k, int eg);
+int  _SurfaceEmbed_FaceSequence(surfaceSearchRecP s, int orbitId, int *seq);
+void _SurfaceEmbed_MinRotation(int *seq, int len);
+int  _SurfaceEmbed_CompareSequences(int *seq1, int len1, int *seq2, int len2);
+unsigned _SurfaceEmbed_HashKey(int *key);
+int  _SurfaceEmbed_MemoFind(surfaceSearchRecP s, int *key);
+void _SurfaceEmbed_MemoAdd(surfaceSearchRecP s, int *key);
+int  _SurfaceEmbed_Assemble(surfaceSearchRecP s, int found);
+
+/********************************************************************
+ _CopySurfaceEmbedGraph()
+
+ Copies the preprocessed graph into context->origGraph, with the edges
+ numbered consecutively.  The back arcs have been moved from the
+ adjacency lists to the forward arc lists, but the neighbors of all
+ arcs are intact, so the edges are copied from the edge array.
+ ********************************************************************/
+
+int _CopySurfaceEmbedGraph(SurfaceEmbedContext *context)
+{
+graphP theGraph = context->theGraph;
+int e, EsizeOccupied;
+
+    gp_Free(&context->origGraph);
+
+    if ((context->origGraph = gp_New()) == NULL ||
+        gp_EnsureArcCapacity(context->origGraph, theGraph->arcCapacity) != OK ||
+        gp_InitGraph(context->origGraph, theGraph->N) != OK)
+    {
+        gp_Free(&context->origGraph);
+        return NOTOK;
+    }
+
+    EsizeOccupied = gp_EdgeInUseIndexBound(theGraph);
+    for (e = gp_GetFirstEdge(theGraph); e < EsizeOccupied; e+=2)
+    {
+        if (gp_EdgeInUse(theGraph, e))
+        {
+            if (gp_AddEdge(context->origGraph, gp_GetNeighbor(theGraph, e), 0,
+                           gp_GetNeighbor(theGraph, gp_GetTwinArc(theGraph, e)), 0) != OK)
+            {
+                gp_Free(&context->origGraph);
+                return NOTOK;
+            }
+        }
+    }
+
+    return OK;
+}
+
+/********************************************************************
+ _SearchForSurfaceEmbedding()
+
+ theGraph contains a Kuratowski subgraph H isolated by the core planarity
+ algorithm, and context->origGraph contains the input graph with the same
+ vertex numbering.  This function searches for an embedding of the input
+ graph on the projective plane or the torus, and stores it in theGraph.
+
+ The Euler genus of a graph is the sum of the Euler genera of its blocks,
+ and so is the orientable genus, so the blocks other than the block of H
+ must be planar, and they are embedded by the core planarity algorithm.
+
+ The block of H is reduced to the multigraph R of the paths between its
+ vertices of degree at least 3, whose edges are embedded one at a time
+ by a backtracking search over the rotation systems of R, with a twisted
+ flag per edge on the projective plane.  The edges of H are embedded
+ first, starting with a cycle, and each further edge either closes an ear
+ or extends it, so the partial embedding stays connected and the
+ branching starts where the obstruction forces it.  At each step, the
+ faces are traced to obtain the Euler genus of the partial embedding,
+ and the search backtracks if it exceeds that of the surface, or if
+ some bridge of the partial embedding has no face containing all its
+ attachments in a case where no face can be merged with another.  The
+ states that fail are memoized by the face boundaries as seen from the
+ vertices that still have edges to embed.
+
+ The search is exponential in the worst case, but the pruning makes it
+ practical for the small reduced blocks typical of near-planar graphs.
+
+ Returns OK with the embedding in theGraph, NONEMBEDDABLE with the input
+ graph restored in theGraph, or NOTOK on internal error.
+ ********************************************************************/
+
+int _SearchForSurfaceEmbedding(SurfaceEmbedContext *context)
+{
+surfaceSearchRec s;
+int RetVal;
+
+    RetVal = _SurfaceEmbed_Init(&s, context);
+
+    if (RetVal == OK)
+    {
+        if (_SurfaceEmbed_MarkObstruction(&s) != OK ||
+            _SurfaceEmbed_FindBlocks(&s) != OK ||
+            _SurfaceEmbed_ReduceBlock(&s) != OK ||
+            _SurfaceEmbed_OrderEdges(&s) != OK)
+            RetVal = NOTOK;
+    }
+
+    if (RetVal == OK)
+        RetVal = _SurfaceEmbed_EmbedOtherBlocks(&s);
+
+    if (RetVal == OK)
+        RetVal = _SurfaceEmbed_Search(&s, 0);
+
+    if (RetVal != NOTOK)
+    {
+        if (_SurfaceEmbed_Assemble(&s, RetVal == OK) != OK)
+            RetVal = NOTOK;
+    }
+
+    _SurfaceEmbed_Free(&s);
+    return RetVal;
+}
+
+/********************************************************************
+ _SurfaceEmbed_Init()
+ ********************************************************************/
+
+int  _SurfaceEmbed_Init(surfaceSearchRecP s, SurfaceEmbedContext *context)
+{
+graphP G = context->origGraph;
+int VIsize, Esize;
+
+    memset(s, 0, sizeof(surfaceSearchRec));
+
+    s->context = context;
+    s->G = G;
+    if (G == NULL)
+        return NOTOK;
+
+    s->orientable = context->theGraph->embedFlags == EMBEDFLAGS_TOROIDAL;
+    s->maxEulerGenus = s->orientable ? 2 : 1;
+
+    VIsize = gp_PrimaryVertexIndexBound(G);
+    Esize = gp_EdgeIndexBound(G);
+
+    if ((s->inH = (int *) calloc(Esize/2, sizeof(int))) == NULL ||
+        (s->edgeBlock = (int *) calloc(Esize/2, sizeof(int))) == NULL ||
+        (s->gpArcMap = (int *) calloc(Esize, sizeof(int))) == NULL ||
+        (s->degreeInBlock = (int *) calloc(VIsize, sizeof(int))) == NULL ||
+        (s->RVertexOf = (int *) malloc(VIsize * sizeof(int))) == NULL)
+        return NOTOK;
+
+    return OK;
+}
+
+/********************************************************************
+ _SurfaceEmbed_Free()
+ ********************************************************************/
+
+void _SurfaceEmbed_Free(surfaceSearchRecP s)
+{
+int i;
+
+    gp_Free(&s->Gp);
+
+    if (s->inH != NULL) free(s->inH);
+    if (s->edgeBlock != NULL) free(s->edgeBlock);
+    if (s->gpArcMap != NULL) free(s->gpArcMap);
+    if (s->degreeInBlock != NULL) free(s->degreeInBlock);
+    if (s->RVertexOf != NULL) free(s->RVertexOf);
+    if (s->GVertexOf != NULL) free(s->GVertexOf);
+    if (s->arcVertex != NULL) free(s->arcVertex);
+    if (s->chainArc != NULL) free(s->chainArc);
+    if (s->RInH != NULL) free(s->RInH);
+    if (s->adjStart != NULL) free(s->adjStart);
+    if (s->adjArcs != NULL) free(s->adjArcs);
+    if (s->order != NULL) free(s->order);
+    if (s->orderPos != NULL) free(s->orderPos);
+    if (s->rnext != NULL) free(s->rnext);
+    if (s->rprev != NULL) free(s->rprev);
+    if (s->twisted != NULL) free(s->twisted);
+    if (s->anyArc != NULL) free(s->anyArc);
+    if (s->embeddedDegree != NULL) free(s->embeddedDegree);
+    if (s->orbit != NULL) free(s->orbit);
+    if (s->orbitStart != NULL) free(s->orbitStart);
+    if (s->cornerFace != NULL) free(s->cornerFace);
+    if (s->faceCall != NULL) free(s->faceCall);
+    if (s->faceHits != NULL) free(s->faceHits);
+    if (s->mark != NULL) free(s->mark);
+    if (s->queue != NULL) free(s->queue);
+    if (s->attach != NULL) free(s->attach);
+    if (s->seq != NULL) free(s->seq);
+    if (s->faceSeqStart != NULL) free(s->faceSeqStart);
+    if (s->faceSeqLen != NULL) free(s->faceSeqLen);
+
+    if (s->memo != NULL)
+    {
+        for (i = 0; i < s->memoSize; i++)
+            if (s->memo[i] != NULL)
+                free(s->memo[i]);
+        free(s->memo);
+    }
+
+    memset(s, 0, sizeof(surfaceSearchRec));
+}
+
+/********************************************************************
+ _SurfaceEmbed_MarkObstruction()
+
+ Marks the edges of G that are in the Kuratowski subgraph left in
+ theGraph.  The edges are matched by their endpoints, so the edges of
+ the subgraph are bucketed by one endpoint, and the arcs of each such
+ endpoint in G are indexed by neighbor while its bucket is processed.
+ ********************************************************************/
+
+int  _SurfaceEmbed_MarkObstruction(surfaceSearchRecP s)
+{
+graphP theGraph = s->context->theGraph, G = s->G;
+int VIsize = gp_PrimaryVertexIndexBound(G);
+int *start = NULL, *partner = NULL, *pos = NULL;
+int e, u, w, i, numH = 0, EsizeOccupied, RetVal = OK;
+
+    if ((start = (int *) calloc(VIsize + 1, sizeof(int))) == NULL ||
+        (partner = (int *) malloc((theGraph->M + 1) * sizeof(int))) == NULL ||
+        (pos = (int *) malloc(VIsize * sizeof(int))) == NULL)
+        RetVal = NOTOK;
+
+    EsizeOccupied = gp_EdgeInUseIndexBound(theGraph);
+
+    // Count the edges of the subgraph at each endpoint u
+    for (e = gp_GetFirstEdge(theGraph); RetVal == OK && e < EsizeOccupied; e+=2)
+    {
+        if (gp_EdgeInUse(theGraph, e))
+        {
+            u = gp_GetNeighbor(theGraph, e);
+            if (gp_IsVirtualVertex(theGraph, u))
+                u = gp_GetPrimaryVertexFromRoot(theGraph, u);
+            start[u+1]++;
+            numH++;
+        }
+    }
+
+    if (RetVal == OK)
+    {
+        for (u = 0; u < VIsize; u++)
+            start[u+1] += start[u];
+
+        for (e = gp_GetFirstEdge(theGraph); e < EsizeOccupied; e+=2)
+        {
+            if (gp_EdgeInUse(theGraph, e))
+            {
+                u = gp_GetNeighbor(theGraph, e);
+                if (gp_IsVirtualVertex(theGraph, u))
+                    u = gp_GetPrimaryVertexFromRoot(theGraph, u);
+                w = gp_GetNeighbor(theGraph, gp_GetTwinArc(theGraph, e));
+                if (gp_IsVirtualVertex(theGraph, w))
+                    w = gp_GetPrimaryVertexFromRoot(theGraph, w);
+                partner[start[u]++] = w;
+            }
+        }
+
+        for (u = VIsize; u > 0; u--)
+            start[u] = start[u-1];
+        start[0] = 0;
+
+        for (u = 0; u < VIsize; u++)
+            pos[u] = NIL;
+    }
+
+    // Match the edges of the subgraph to the arcs of G
+    for (u = gp_GetFirstVertex(G); RetVal == OK && gp_VertexInRange(G, u); u++)
+    {
+        if (start[u] == start[u+1])
+            continue;
+
+        e = gp_GetFirstArc(G, u);
+        while (gp_IsArc(e))
+        {
+            pos[gp_GetNeighbor(G, e)] = e;
+            e = gp_GetNextArc(G, e);
+        }
+
+        for (i = start[u]; i < start[u+1]; i++)
+        {
+            if (gp_IsNotArc(pos[partner[i]]))
+            {
+                RetVal = NOTOK;
+                break;
+            }
+            s->inH[pos[partner[i]] >> 1] = TRUE;
+        }
+
+        e = gp_GetFirstArc(G, u);
+        while (gp_IsArc(e))
+        {
+            pos[gp_GetNeighbor(G, e)] = NIL;
+            e = gp_GetNextArc(G, e);
+        }
+    }
+
+    if (numH == 0)
+        RetVal = NOTOK;
+
+    if (start != NULL) free(start);
+    if (partner != NULL) free(partner);
+    if (pos != NULL) free(pos);
+
+    return RetVal;
+}
+
+/********************************************************************
+ _SurfaceEmbed_FindBlocks()
+
+ Labels the edges of G with their blocks by an iterative version of
+ the Hopcroft-Tarjan algorithm, which pushes the edges on a stack as
+ they are explored and pops a block once the DFS returns from a child
+ whose lowpoint is not less than its parent.  The block of the
+ Kuratowski subgraph is then the block of any of its edges.
+ ********************************************************************/
+
+int  _SurfaceEmbed_FindBlocks(surfaceSearchRecP s)
+{
+graphP G = s->G;
+int VIsize = gp_PrimaryVertexIndexBound(G);
+int *disc = NULL, *low = NULL, *nextArc = NULL, *parentArc = NULL, *vstack = NULL, *estack = NULL;
+int r, v, w, e, f, p, vtop, etop, time = 0, numBlocks = 0, RetVal = OK;
+
+    if ((disc = (int *) calloc(VIsize, sizeof(int))) == NULL ||
+        (low = (int *) calloc(VIsize, sizeof(int))) == NULL ||
+        (nextArc = (int *) calloc(VIsize, sizeof(int))) == NULL ||
+        (parentArc = (int *) calloc(VIsize, sizeof(int))) == NULL ||
+        (vstack = (int *) malloc(VIsize * sizeof(int))) == NULL ||
+        (estack = (int *) malloc((G->M + 1) * sizeof(int))) == NULL)
+        RetVal = NOTOK;
+
+    for (r = gp_GetFirstVertex(G); RetVal == OK && gp_VertexInRange(G, r); r++)
+    {
+        if (disc[r] != 0)
+            continue;
+
+        disc[r] = low[r] = ++time;
+        parentArc[r] = NIL;
+        nextArc[r] = gp_GetFirstArc(G, r);
+        vstack[vtop = 0] = r;
+        etop = 0;
+
+        while (vtop >= 0)
+        {
+            v = vstack[vtop];
+            e = nextArc[v];
+
+            if (gp_IsArc(e))
+            {
+                nextArc[v] = gp_GetNextArc(G, e);
+                if (e == gp_GetTwinArc(G, parentArc[v]) && gp_IsArc(parentArc[v]))
+                    continue;
+
+                w = gp_GetNeighbor(G, e);
+                if (disc[w] == 0)
+                {
+                    estack[etop++] = e;
+                    parentArc[w] = e;
+                    disc[w] = low[w] = ++time;
+                    nextArc[w] = gp_GetFirstArc(G, w);
+                    vstack[++vtop] = w;
+                }
+                else if (disc[w] < disc[v])
+                {
+                    estack[etop++] = e;
+                    if (low[v] > disc[w])
+                        low[v] = disc[w];
+                }
+            }
+            else
+            {
+                vtop--;
+                if (gp_IsArc(parentArc[v]))
+                {
+                    p = gp_GetNeighbor(G, gp_GetTwinArc(G, parentArc[v]));
+                    if (low[p] > low[v])
+                        low[p] = low[v];
+
+                    if (low[v] >= disc[p])
+                    {
+                        numBlocks++;
+                        do {
+                            f = estack[--etop];
+                            s->edgeBlock[f >> 1] = numBlocks;
+                        } while (f != parentArc[v]);
+                    }
+                }
+            }
+        }
+    }
+
+    // Find the block of the subgraph, and check that it has all its edges
+    s->theBlock = 0;
+    for (e = gp_GetFirstEdge(G); RetVal == OK && e < gp_EdgeInUseIndexBound(G); e+=2)
+    {
+        if (s->inH[e >> 1])
+        {
+            if (s->theBlock == 0)
+                s->theBlock = s->edgeBlock[e >> 1];
+            else if (s->theBlock != s->edgeBlock[e >> 1])
+                RetVal = NOTOK;
+        }
+    }
+
+    if (disc != NULL) free(disc);
+    if (low != NULL) free(low);
+    if (nextArc != NULL) free(nextArc);
+    if (parentArc != NULL) free(parentArc);
+    if (vstack != NULL) free(vstack);
+    if (estack != NULL) free(estack);
+
+    return RetVal;
+}
+
+/********************************************************************
+ _SurfaceEmbed_EmbedOtherBlocks()
+
+ Creates Gp with the edges of G that are not in the block of the
+ Kuratowski subgraph, and embeds it with the core planarity algorithm.
+ The vertices of Gp are restored to the numbering of G afterward, and
+ the arcs of Gp keep their indices, so gpArcMap gives the arc of G for
+ each arc of Gp.
+
+ Returns OK if Gp is planar, NONEMBEDDABLE if not, NOTOK on error.
+ ********************************************************************/
+
+int  _SurfaceEmbed_EmbedOtherBlocks(surfaceSearchRecP s)
+{
+graphP G = s->G;
+int e, f, RetVal;
+
+    if ((s->Gp = gp_New()) == NULL ||
+        gp_EnsureArcCapacity(s->Gp, G->arcCapacity) != OK ||
+        gp_InitGraph(s->Gp, G->N) != OK)
+        return NOTOK;
+
+    for (e = gp_GetFirstEdge(G); e < gp_EdgeInUseIndexBound(G); e+=2)
+    {
+        if (s->edgeBlock[e >> 1] == s->theBlock)
+            continue;
+
+        f = gp_EdgeInUseIndexBound(s->Gp);
+        if (gp_AddEdge(s->Gp, gp_GetNeighbor(G, e), 0, gp_GetNeighbor(G, e+1), 0) != OK)
+            return NOTOK;
+
+        s->gpArcMap[f] = e;
+        s->gpArcMap[f+1] = e+1;
+    }
+
+    RetVal = gp_EmbedPlanar(s->Gp);
+    if (RetVal != OK)
+        return RetVal;
+
+    if (gp_SortVertices(s->Gp) != OK)
+        return NOTOK;
+
+    for (f = gp_GetFirstEdge(s->Gp); f < gp_EdgeInUseIndexBound(s->Gp); f++)
+    {
+        if (gp_GetNeighbor(s->Gp, f) != gp_GetNeighbor(G, s->gpArcMap[f]))
+            return NOTOK;
+    }
+
+    return OK;
+}
+
+/********************************************************************
+ _SurfaceEmbed_ReduceBlock()
+
+ Creates the reduced block R.  Since the block is biconnected and
+ nonplanar, each of its vertices has degree at least 2 in the block, and
+ each path of the block through vertices of degree 2 ends at two distinct
+ vertices of degree at least 3.  Since the Kuratowski subgraph has no
+ vertices of degree less than 2, each such path is either in the subgraph
+ or has no edges in it.
+ ********************************************************************/
+
+int  _SurfaceEmbed_ReduceBlock(surfaceSearchRecP s)
+{
+graphP G = s->G;
+int VIsize = gp_PrimaryVertexIndexBound(G);
+int v, w, e, f, i, a, numArcs, *fill;
+
+    for (v = 0; v < VIsize; v++)
+        s->RVertexOf[v] = -1;
+
+    for (e = gp_GetFirstEdge(G); e < gp_EdgeInUseIndexBound(G); e+=2)
+    {
+        if (s->edgeBlock[e >> 1] == s->theBlock)
+        {
+            s->degreeInBlock[gp_GetNeighbor(G, e)]++;
+            s->degreeInBlock[gp_GetNeighbor(G, e+1)]++;
+        }
+    }
+
+    // Number the vertices of R and count the edges of R
+    s->numRVertices = numArcs = 0;
+    for (v = gp_GetFirstVertex(G); gp_VertexInRange(G, v); v++)
+    {
+        if (s->degreeInBlock[v] >= 3)
+        {
+            s->RVertexOf[v] = s->numRVertices++;
+            numArcs += s->degreeInBlock[v];
+        }
+    }
+    s->numREdges = numArcs / 2;
+
+    if (s->numRVertices == 0)
+        return NOTOK;
+
+    if ((s->GVertexOf = (int *) malloc(s->numRVertices * sizeof(int))) == NULL ||
+        (s->arcVertex = (int *) malloc(numArcs * sizeof(int))) == NULL ||
+        (s->chainArc = (int *) malloc(numArcs * sizeof(int))) == NULL ||
+        (s->RInH = (int *) calloc(s->numREdges, sizeof(int))) == NULL ||
+        (s->adjStart = (int *) calloc(s->numRVertices + 1, sizeof(int))) == NULL ||
+        (s->adjArcs = (int *) malloc(numArcs * sizeof(int))) == NULL)
+        return NOTOK;
+
+    // Walk the path from each arc of the block at each vertex of R to the
+    // vertex of R at its other end.  The edge of G labeled with the block
+    // label negated is the first edge of a path that has been walked.
+    s->numREdges = 0;
+    for (v = gp_GetFirstVertex(G); gp_VertexInRange(G, v); v++)
+    {
+        if (s->RVertexOf[v] < 0)
+            continue;
+
+        s->GVertexOf[s->RVertexOf[v]] = v;
+
+        e = gp_GetFirstArc(G, v);
+        while (gp_IsArc(e))
+        {
+            if (s->edgeBlock[e >> 1] == s->theBlock)
+            {
+                i = s->numREdges++;
+                s->chainArc[2*i] = e;
+                s->RInH[i] = s->inH[e >> 1];
+
+                f = e;
+                s->edgeBlock[f >> 1] = -s->theBlock;
+                w = gp_GetNeighbor(G, f);
+                while (s->RVertexOf[w] < 0)
+                {
+                    f = gp_GetTwinArc(G, f);
+                    a = gp_GetFirstArc(G, w);
+                    while (a == f || s->edgeBlock[a >> 1] != s->theBlock)
+                        a = gp_GetNextArc(G, a);
+                    f = a;
+                    s->edgeBlock[f >> 1] = -s->theBlock;
+                    w = gp_GetNeighbor(G, f);
+                }
+
+                s->chainArc[2*i+1] = gp_GetTwinArc(G, f);
+                s->arcVertex[2*i] = s->RVertexOf[v];
+                s->arcVertex[2*i+1] = s->RVertexOf[w];
+            }
+            e = gp_GetNextArc(G, e);
+        }
+    }
+
+    for (e = gp_GetFirstEdge(G); e < gp_EdgeInUseIndexBound(G); e+=2)
+    {
+        if (s->edgeBlock[e >> 1] == -s->theBlock)
+            s->edgeBlock[e >> 1] = s->theBlock;
+    }
+
+    // Store the adjacency lists of R
+    for (a = 0; a < 2*s->numREdges; a++)
+        s->adjStart[s->arcVertex[a]+1]++;
+    for (v = 0; v < s->numRVertices; v++)
+        s->adjStart[v+1] += s->adjStart[v];
+
+    if ((fill = (int *) malloc(s->numRVertices * sizeof(int))) == NULL)
+        return NOTOK;
+    memcpy(fill, s->adjStart, s->numRVertices * sizeof(int));
+    for (a = 0; a < 2*s->numREdges; a++)
+        s->adjArcs[fill[s->arcVertex[a]]++] = a;
+    free(fill);
+
+    // Allocate the search state, in which no vertex is embedded yet
+    if ((s->rnext = (int *) malloc(numArcs * sizeof(int))) == NULL ||
+        (s->rprev = (int *) malloc(numArcs * sizeof(int))) == NULL ||
+        (s->twisted = (int *) calloc(s->numREdges, sizeof(int))) == NULL ||
+        (s->anyArc = (int *) malloc(s->numRVertices * sizeof(int))) == NULL ||
+        (s->embeddedDegree = (int *) calloc(s->numRVertices, sizeof(int))) == NULL ||
+        (s->orbit = (int *) malloc(2 * numArcs * sizeof(int))) == NULL ||
+        (s->orbitStart = (int *) malloc(2 * numArcs * sizeof(int))) == NULL ||
+        (s->cornerFace = (int *) malloc(numArcs * sizeof(int))) == NULL ||
+        (s->faceCall = (int *) calloc(2 * numArcs, sizeof(int))) == NULL ||
+        (s->faceHits = (int *) calloc(2 * numArcs, sizeof(int))) == NULL ||
+        (s->attach = (int *) malloc((s->numRVertices + 2) * sizeof(int))) == NULL ||
+        (s->seq = (int *) malloc(4 * numArcs * sizeof(int))) == NULL ||
+        (s->faceSeqStart = (int *) malloc(2 * numArcs * sizeof(int))) == NULL ||
+        (s->faceSeqLen = (int *) malloc(2 * numArcs * sizeof(int))) == NULL)
+        return NOTOK;
+
+    for (v = 0; v < s->numRVertices; v++)
+        s->anyArc[v] = -1;
+
+    return OK;
+}
+
+/********************************************************************
+ _SurfaceEmbed_OrderEdges()
+
+ Orders the edges of R for the search.  The first edges form a cycle of
+ the Kuratowski subgraph, made of one of its edges and a shortest path
+ between the endpoints.  Then the rest of the subgraph is added, and
+ then the rest of R, one ear at a time, where an ear is either an edge
+ joining two placed vertices or a shortest path between placed vertices
+ through unplaced vertices.  Since the subgraph and the block are both
+ biconnected, an ear exists until all their edges are placed.
+ ********************************************************************/
+
+int  _SurfaceEmbed_OrderEdges(surfaceSearchRecP s)
+{
+int m = s->numREdges, n = s->numRVertices;
+int *placed, *prevArc, numOrdered = 0, i, j, a, u, v, w, x, head, tail, RetVal = OK;
+
+    if ((s->order = (int *) malloc(m * sizeof(int))) == NULL ||
+        (s->orderPos = (int *) malloc(m * sizeof(int))) == NULL ||
+        (s->mark = (int *) calloc(n, sizeof(int))) == NULL ||
+        (s->queue = (int *) malloc(3 * n * sizeof(int))) == NULL)
+        return NOTOK;
+
+    if ((placed = (int *) calloc(n, sizeof(int))) == NULL)
+        return NOTOK;
+    if ((prevArc = (int *) malloc(n * sizeof(int))) == NULL)
+    {
+        free(placed);
+        return NOTOK;
+    }
+
+    for (i = 0; i < m; i++)
+        s->orderPos[i] = -1;
+
+    // Find an edge of the subgraph, then a shortest path of the subgraph
+    // from its second endpoint v back to its first endpoint u
+    for (i = 0; i < m && !s->RInH[i]; i++)
+        ;
+
+    u = s->arcVertex[2*i];
+    v = s->arcVertex[2*i+1];
+
+    s->markId++;
+    s->mark[v] = s->markId;
+    s->queue[0] = v;
+    head = 0; tail = 1;
+    while (head < tail && s->mark[u] != s->markId)
+    {
+        x = s->queue[head++];
+        for (j = s->adjStart[x]; j < s->adjStart[x+1]; j++)
+        {
+            a = s->adjArcs[j];
+            w = s->arcVertex[a ^ 1];
+            if (s->RInH[a >> 1] && (a >> 1) != i && s->mark[w] != s->markId)
+            {
+                s->mark[w] = s->markId;
+                prevArc[w] = a;
+                s->queue[tail++] = w;
+            }
+        }
+    }
+
+    if (s->mark[u] != s->markId)
+        RetVal = NOTOK;
+    else
+    {
+        s->orderPos[i] = numOrdered;
+        s->order[numOrdered++] = i;
+        placed[u] = placed[v] = TRUE;
+
+        // The path is recovered backward from u, then reversed to start at v
+        j = numOrdered;
+        for (w = u; w != v; w = s->arcVertex[prevArc[w]])
+        {
+            a = prevArc[w];
+            s->order[numOrdered++] = a >> 1;
+            placed[w] = TRUE;
+        }
+        for (x = numOrdered-1; j < x; j++, x--)
+        {
+            a = s->order[j];
+            s->order[j] = s->order[x];
+            s->order[x] = a;
+        }
+        for (j = 1; j < numOrdered; j++)
+            s->orderPos[s->order[j]] = j;
+
+        while (_SurfaceEmbed_AddEar(s, placed, &numOrdered, TRUE))
+            ;
+        while (_SurfaceEmbed_AddEar(s, placed, &numOrdered, FALSE))
+            ;
+
+        if (numOrdered != m)
+            RetVal = NOTOK;
+    }
+
+    free(placed);
+    free(prevArc);
+    return RetVal;
+}
+
+/********************************************************************
+ _SurfaceEmbed_AddEar()
+
+ Appends the next ear to the edge order, preferring an edge that joins
+ two placed vertices, and otherwise taking a short path between placed
+ vertices found by a breadth first search from all of them at once.  If HOnly is
+ TRUE, then only the edges of the Kuratowski subgraph are considered.
+
+ Returns TRUE if an ear was added, FALSE if there is none.
+ ********************************************************************/
+
+int  _SurfaceEmbed_AddEar(surfaceSearchRecP s, int *placed, int *numOrdered, int HOnly)
+{
+int m = s->numREdges, n = s->numRVertices;
+int *queue = s->queue, *prevVertex = s->queue + n, *prevEdge = s->queue + 2*n;
+int i, j, a, v, w, x, head, tail, first, second, last;
+
+    // An unplaced edge between placed vertices is an ear by itself
+    for (i = 0; i < m; i++)
+    {
+        if (s->orderPos[i] < 0 && (!HOnly || s->RInH[i]) &&
+            placed[s->arcVertex[2*i]] && placed[s->arcVertex[2*i+1]])
+        {
+            s->orderPos[i] = *numOrdered;
+            s->order[(*numOrdered)++] = i;
+            return TRUE;
+        }
+    }
+
+    // Search from all placed vertices at once for a path to a placed vertex
+    s->markId++;
+    head = tail = 0;
+    for (v = 0; v < n; v++)
+    {
+        if (!placed[v])
+            continue;
+
+        for (j = s->adjStart[v]; j < s->adjStart[v+1]; j++)
+        {
+            a = s->adjArcs[j];
+            w = s->arcVertex[a ^ 1];
+            if (s->orderPos[a >> 1] < 0 && (!HOnly || s->RInH[a >> 1]) &&
+                !placed[w] && s->mark[w] != s->markId)
+            {
+                s->mark[w] = s->markId;
+                prevVertex[w] = v;
+                prevEdge[w] = a >> 1;
+                queue[tail++] = w;
+            }
+        }
+    }
+
+    // The search stops at the first edge from a vertex x that it reaches to
+    // a placed vertex, or to a vertex w reached from another direction
+    first = second = last = -1;
+    while (head < tail && last < 0)
+    {
+        x = queue[head++];
+        for (j = s->adjStart[x]; j < s->adjStart[x+1]; j++)
+        {
+            a = s->adjArcs[j];
+            i = a >> 1;
+            w = s->arcVertex[a ^ 1];
+            if (s->orderPos[i] >= 0 || (HOnly && !s->RInH[i]) || i == prevEdge[x])
+                continue;
+
+            if (placed[w] || s->mark[w] == s->markId)
+            {
+                first = x;
+                second = w;
+                last = i;
+                break;
+            }
+
+            s->mark[w] = s->markId;
+            prevVertex[w] = x;
+            prevEdge[w] = i;
+            queue[tail++] = w;
+        }
+    }
+
+    if (last < 0)
+        return FALSE;
+
+    // The path edges are appended from the placed vertex at which the
+    // search reached x, then the edge from x to w, then the path from w
+    // back to a placed vertex or to the path to x, so each edge but the
+    // last adds a new vertex
+    i = *numOrdered;
+    for (x = first; !placed[x]; x = prevVertex[x])
+        s->order[(*numOrdered)++] = prevEdge[x];
+    for (j = *numOrdered - 1; i < j; i++, j--)
+    {
+        a = s->order[i];
+        s->order[i] = s->order[j];
+        s->order[j] = a;
+    }
+    for (x = first; !placed[x]; x = prevVertex[x])
+        placed[x] = TRUE;
+
+    s->order[(*numOrdered)++] = last;
+    for (w = second; !placed[w]; w = prevVertex[w])
+        s->order[(*numOrdered)++] = prevEdge[w];
+    for (w = second; !placed[w]; w = prevVertex[w])
+        placed[w] = TRUE;
+
+    for (i = *numOrdered - 1; i >= 0 && s->orderPos[s->order[i]] < 0; i--)
+        s->orderPos[s->order[i]] = i;
+
+    return TRUE;
+}
+
+/********************************************************************
+ _SurfaceEmbed_Search()
+
+ Embeds edges k and up of the edge order into the partial embedding of
+ edges 0 to k-1, trying every way of doing so until one succeeds.
+
+ An edge with one endpoint not yet embedded is inserted into each corner
+ of the other endpoint in turn; the new endpoint has no other corner, and
+ a twist of the edge would only flip the orientation of the new vertex.
+ An edge joining two embedded vertices is handled by
+ _SurfaceEmbed_SearchClosingEdge().
+
+ Returns OK if the embedding is completed, NONEMBEDDABLE if not, or
+ NOTOK on internal error.
+ ********************************************************************/
+
+int  _SurfaceEmbed_Search(surfaceSearchRecP s, int k)
+{
+int  i, j, u, v, p, q, c, d, temp, eg = 0, RetVal = NONEMBEDDABLE;
+int *key = NULL, *corners;
+
+    if (k > 0)
+    {
+        eg = 2 - s->numV + s->numE - _SurfaceEmbed_TraceFaces(s, k);
+        if (eg > s->maxEulerGenus)
+            return NONEMBEDDABLE;
+    }
+
+    if (k == s->numREdges)
+        return OK;
+
+    i = s->order[k];
+    p = 2*i;
+    q = 2*i+1;
+    u = s->arcVertex[p];
+    v = s->arcVertex[q];
+
+    // The first edge and its two endpoints make the initial embedding
+    if (k == 0)
+    {
+        s->anyArc[u] = s->rnext[p] = s->rprev[p] = p;
+        s->anyArc[v] = s->rnext[q] = s->rprev[q] = q;
+        s->embeddedDegree[u] = s->embeddedDegree[v] = 1;
+        s->numV = 2;
+        s->numE = 1;
+
+        RetVal = _SurfaceEmbed_Search(s, 1);
+        if (RetVal != OK)
+        {
+            s->anyArc[u] = s->anyArc[v] = -1;
+            s->embeddedDegree[u] = s->embeddedDegree[v] = 0;
+            s->numV = s->numE = 0;
+        }
+        return RetVal;
+    }
+
+    // If no face can be merged with another, then each bridge of the
+    // partial embedding must have all its attachments on a single face
+    if ((!s->orientable || eg == s->maxEulerGenus) && !_SurfaceEmbed_BridgesFit(s, k))
+        return NONEMBEDDABLE;
+
+    // The state is memoized unless the edge has only one way to be added,
+    // in which case the state that follows is memoized instead
+    if (!((s->anyArc[u] < 0 && s->embeddedDegree[v] == 1) ||
+          (s->anyArc[v] < 0 && s->embeddedDegree[u] == 1)))
+    {
+        if ((key = _SurfaceEmbed_MakeKey(s, k, eg)) == NULL)
+            return NOTOK;
+
+        if (_SurfaceEmbed_MemoFind(s, key))
+        {
+            free(key);
+            return NONEMBEDDABLE;
+        }
+    }
+
+    if (s->anyArc[u] >= 0 && s->anyArc[v] >= 0)
+        RetVal = _SurfaceEmbed_SearchClosingEdge(s, k, eg, p, q);
+
+    else
+    {
+        // Let u be the embedded endpoint, with p its arc of the edge
+        if (s->anyArc[u] < 0)
+        {
+            temp = u; u = v; v = temp;
+            temp = p; p = q; q = temp;
+        }
+
+        d = s->embeddedDegree[u];
+        if ((corners = (int *) malloc(d * sizeof(int))) == NULL)
+            RetVal = NOTOK;
+        else
+        {
+            c = s->anyArc[u];
+            for (j = 0; j < d; j++, c = s->rnext[c])
+                corners[j] = c;
+
+            s->anyArc[v] = s->rnext[q] = s->rprev[q] = q;
+            s->embeddedDegree[v] = 1;
+            s->embeddedDegree[u]++;
+            s->numV++;
+            s->numE++;
+
+            for (j = 0; j < d && RetVal == NONEMBEDDABLE; j++)
+            {
+                c = corners[j];
+                s->rnext[p] = s->rnext[c];
+                s->rprev[p] = c;
+                s->rprev[s->rnext[c]] = p;
+                s->rnext[c] = p;
+
+                RetVal = _SurfaceEmbed_Search(s, k+1);
+
+                if (RetVal != OK)
+                {
+                    s->rnext[c] = s->rnext[p];
+                    s->rprev[s->rnext[p]] = c;
+                }
+            }
+
+            if (RetVal != OK)
+            {
+                s->anyArc[v] = -1;
+                s->embeddedDegree[v] = 0;
+                s->embeddedDegree[u]--;
+                s->numV--;
+                s->numE--;
+            }
+
+            free(corners);
+        }
+    }
+
+    if (key != NULL)
+    {
+        if (RetVal == NONEMBEDDABLE)
+            _SurfaceEmbed_MemoAdd(s, key);
+        else
+            free(key);
+    }
+
+    return RetVal;
+}
+
+/********************************************************************
+ _SurfaceEmbed_SearchClosingEdge()
+
+ Embeds edge k, with arc p at u and arc q at v, where u and v are both
+ embedded, into each pair of corners of u and v in turn.  The pairs of
+ corners on the same face are tried first, untwisted and, on the
+ projective plane, twisted, one of which splits the face while the other
+ adds a crosscap.  On the torus, if the partial embedding is planar,
+ the pairs of corners on different faces are then tried, which adds a
+ handle.  The pairs on different faces are not tried on the projective
+ plane, since joining two faces raises the Euler genus by 2.
+ ********************************************************************/
+
+int  _SurfaceEmbed_SearchClosingEdge(surfaceSearchRecP s, int k, int eg, int p, int q)
+{
+int u = s->arcVertex[p], v = s->arcVertex[q];
+int du = s->embeddedDegree[u], dv = s->embeddedDegree[v];
+int *arcs, *Au, *Av, *Fu, *Fv, ju, jv, c, pass, sign, RetVal = NONEMBEDDABLE;
+
+    if ((arcs = (int *) malloc(2 * (du + dv) * sizeof(int))) == NULL)
+        return NOTOK;
+
+    Au = arcs;
+    Av = Au + du;
+    Fu = Av + dv;
+    Fv = Fu + du;
+
+    for (ju = 0, c = s->anyArc[u]; ju < du; ju++, c = s->rnext[c])
+    {
+        Au[ju] = c;
+        Fu[ju] = s->cornerFace[c];
+    }
+    for (jv = 0, c = s->anyArc[v]; jv < dv; jv++, c = s->rnext[c])
+    {
+        Av[jv] = c;
+        Fv[jv] = s->cornerFace[c];
+    }
+
+    s->embeddedDegree[u]++;
+    s->embeddedDegree[v]++;
+    s->numE++;
+
+    for (pass = 0; pass < 2 && RetVal == NONEMBEDDABLE; pass++)
+    {
+        if (pass == 1 && !(s->orientable && eg == 0))
+            break;
+
+        for (ju = 0; ju < du && RetVal == NONEMBEDDABLE; ju++)
+        {
+            for (jv = 0; jv < dv && RetVal == NONEMBEDDABLE; jv++)
+            {
+                if ((Fu[ju] == Fv[jv]) != (pass == 0))
+                    continue;
+
+                for (sign = 0; sign <= (s->orientable || pass == 1 ? 0 : 1) && RetVal == NONEMBEDDABLE; sign++)
+                {
+                    c = Au[ju];
+                    s->rnext[p] = s->rnext[c];
+                    s->rprev[p] = c;
+                    s->rprev[s->rnext[c]] = p;
+                    s->rnext[c] = p;
+
+                    c = Av[jv];
+                    s->rnext[q] = s->rnext[c];
+                    s->rprev[q] = c;
+                    s->rprev[s->rnext[c]] = q;
+                    s->rnext[c] = q;
+
+                    s->twisted[p >> 1] = sign;
+
+                    RetVal = _SurfaceEmbed_Search(s, k+1);
+
+                    if (RetVal != OK)
+                    {
+                        s->rnext[s->rprev[q]] = s->rnext[q];
+                        s->rprev[s->rnext[q]] = s->rprev[q];
+                        s->rnext[s->rprev[p]] = s->rnext[p];
+                        s->rprev[s->rnext[p]] = s->rprev[p];
+                        s->twisted[p >> 1] = 0;
+                    }
+                }
+            }
+        }
+    }
+
+    if (RetVal != OK)
+    {
+        s->embeddedDegree[u]--;
+        s->embeddedDegree[v]--;
+        s->numE--;
+    }
+
+    free(arcs);
+    return RetVal;
+}
+
+/********************************************************************
+ _SurfaceEmbed_NextState()
+
+ A state of a face traversal is an arc and an orientation, encoded as
+ twice the arc plus the orientation.  The traversal goes along the arc
+ to its twin, flips the orientation if the edge is twisted, then leaves
+ by the next arc around the vertex in orientation 0 or the previous arc
+ in orientation 1.  So the state (b, 0) has passed the corner between
+ the previous arc of b and b, and the state (b, 1) the corner between
+ b and its next arc.
+ ********************************************************************/
+
+int  _SurfaceEmbed_NextState(surfaceSearchRecP s, int state)
+{
+int t = (state >> 1) ^ 1, o = (state & 1) ^ s->twisted[t >> 1];
+
+    return 2 * (o ? s->rprev[t] : s->rnext[t]) + o;
+}
+
+/********************************************************************
+ _SurfaceEmbed_TraceFaces()
+
+ Partitions the states of the first k edges of the order into orbits,
+ and labels the corner between each arc and its next arc with the lesser
+ of the two orbits that pass it, which traverse the same face in
+ opposite directions.  Each face has two orbits.
+
+ Returns the number of faces.
+ ********************************************************************/
+
+int  _SurfaceEmbed_TraceFaces(surfaceSearchRecP s, int k)
+{
+int j, st, x, a, f1, f2;
+
+    for (j = 0; j < k; j++)
+        for (st = 4*s->order[j]; st < 4*s->order[j] + 4; st++)
+            s->orbit[st] = -1;
+
+    s->numOrbits = 0;
+    for (j = 0; j < k; j++)
+    {
+        for (st = 4*s->order[j]; st < 4*s->order[j] + 4; st++)
+        {
+            if (s->orbit[st] >= 0)
+                continue;
+
+            s->orbitStart[s->numOrbits] = x = st;
+            do {
+                s->orbit[x] = s->numOrbits;
+                x = _SurfaceEmbed_NextState(s, x);
+            } while (x != st);
+            s->numOrbits++;
+        }
+    }
+
+    for (j = 0; j < k; j++)
+    {
+        for (a = 2*s->order[j]; a < 2*s->order[j] + 2; a++)
+        {
+            f1 = s->orbit[2*s->rnext[a]];
+            f2 = s->orbit[2*a+1];
+            s->cornerFace[a] = f1 < f2 ? f1 : f2;
+        }
+    }
+
+    return s->numOrbits / 2;
+}
+
+/********************************************************************
+ _SurfaceEmbed_BridgesFit()
+
+ A bridge of the partial embedding is either an edge not yet embedded
+ that joins two embedded vertices, or a connected component of the
+ vertices not yet embedded together with its edges to the embedded
+ vertices, which are its attachments.  The bridge must be embedded in a
+ single face unless it joins faces, so this function checks whether each
+ bridge has a face on which all its attachments have corners.
+
+ Returns TRUE if so, FALSE otherwise.
+ ********************************************************************/
+
+int  _SurfaceEmbed_BridgesFit(surfaceSearchRecP s, int k)
+{
+int n = s->numRVertices, baseId;
+int v, w, x, a, j, head, tail, numAttach;
+
+    if (s->markId > 0x7FFFFFFF - n)
+    {
+        memset(s->mark, 0, n * sizeof(int));
+        s->markId = 0;
+    }
+    baseId = s->markId;
+
+    for (v = 0; v < n; v++)
+    {
+        if (s->anyArc[v] >= 0 || s->mark[v] > baseId)
+            continue;
+
+        // Mark the component of v and its attachments with a new markId
+        s->markId++;
+        s->mark[v] = s->markId;
+        s->queue[0] = v;
+        head = 0; tail = 1;
+        numAttach = 0;
+        while (head < tail)
+        {
+            x = s->queue[head++];
+            for (j = s->adjStart[x]; j < s->adjStart[x+1]; j++)
+            {
+                a = s->adjArcs[j];
+                w = s->arcVertex[a ^ 1];
+                if (s->mark[w] == s->markId)
+                    continue;
+
+                s->mark[w] = s->markId;
+                if (s->anyArc[w] >= 0)
+                    s->attach[numAttach++] = w;
+                else
+                    s->queue[tail++] = w;
+            }
+        }
+
+        if (!_SurfaceEmbed_AttachmentsShareFace(s, s->attach, numAttach))
+            return FALSE;
+    }
+
+    for (j = k; j < s->numREdges; j++)
+    {
+        s->attach[0] = s->arcVertex[2*s->order[j]];
+        s->attach[1] = s->arcVertex[2*s->order[j]+1];
+        if (s->anyArc[s->attach[0]] >= 0 && s->anyArc[s->attach[1]] >= 0 &&
+            !_SurfaceEmbed_AttachmentsShareFace(s, s->attach, 2))
+            return FALSE;
+    }
+
+    return TRUE;
+}
+
+/********************************************************************
+ _SurfaceEmbed_AttachmentsShareFace()
+
+ Counts, for each face, the leading attachments that have a corner on
+ it, and returns TRUE if some face has corners of all of them.
+ ********************************************************************/
+
+int  _SurfaceEmbed_AttachmentsShareFace(surfaceSearchRecP s, int *attach, int numAttach)
+{
+int i, a, f;
+
+    if (numAttach < 2)
+        return TRUE;
+
+    if (++s->callId == 0x7FFFFFFF)
+    {
+        memset(s->faceCall, 0, 4 * s->numREdges * sizeof(int));
+        s->callId = 1;
+    }
+
+    for (i = 0; i < numAttach; i++)
+    {
+        a = s->anyArc[attach[i]];
+        do {
+            f = s->cornerFace[a];
+            if (i == 0)
+            {
+                s->faceCall[f] = s->callId;
+                s->faceHits[f] = 1;
+            }
+            else if (s->faceCall[f] == s->callId && s->faceHits[f] == i)
+                s->faceHits[f] = i+1;
+
+            a = s->rnext[a];
+        } while (a != s->anyArc[attach[i]]);
+    }
+
+    a = s->anyArc[attach[numAttach-1]];
+    do {
+        f = s->cornerFace[a];
+        if (s->faceCall[f] == s->callId && s->faceHits[f] == numAttach)
+            return TRUE;
+        a = s->rnext[a];
+    } while (a != s->anyArc[attach[numAttach-1]]);
+
+    return FALSE;
+}
+
+/********************************************************************
+ _SurfaceEmbed_MakeKey()
+
+ The future of the search from a partial embedding depends only on the
+ number of edges embedded, the Euler genus, and the boundaries of the
+ faces as seen from the active vertices, i.e. the embedded vertices that
+ have edges not yet embedded.  A face is described by the sequence of
+ active vertices and orientations of the states of one of its orbits,
+ rotated to its least form.  On the torus, the orbits of orientation 0
+ are used, and on the projective plane, the lesser of the two orbits.
+ Faces without active vertices are omitted, and the rest are sorted.
+
+ The key is an array whose first entry is its length.
+
+ Returns the key, or NULL if it could not be allocated.
+ ********************************************************************/
+
+int *_SurfaceEmbed_MakeKey(surfaceSearchRecP s, int k, int eg)
+{
+int id, mid, st, a, len = 0, L1, L2, numFaces = 0, i, j, t1, t2, *key, *out;
+
+    for (id = 0; id < s->numOrbits; id++)
+    {
+        st = s->orbitStart[id];
+        a = st >> 1;
+        mid = s->orbit[(st & 1) ? 2*s->rnext[a] : 2*s->rprev[a]+1];
+        if (mid < id)
+            continue;
+
+        if (s->orientable)
+        {
+            L1 = _SurfaceEmbed_FaceSequence(s, (st & 1) ? mid : id, s->seq + len);
+            _SurfaceEmbed_MinRotation(s->seq + len, L1);
+        }
+        else
+        {
+            L1 = _SurfaceEmbed_FaceSequence(s, id, s->seq + len);
+            _SurfaceEmbed_MinRotation(s->seq + len, L1);
+            L2 = _SurfaceEmbed_FaceSequence(s, mid, s->seq + len + L1);
+            _SurfaceEmbed_MinRotation(s->seq + len + L1, L2);
+            if (_SurfaceEmbed_CompareSequences(s->seq + len + L1, L2, s->seq + len, L1) < 0)
+            {
+                memmove(s->seq + len, s->seq + len + L1, L2 * sizeof(int));
+                L1 = L2;
+            }
+        }
+
+        if (L1 > 0)
+        {
+            s->faceSeqStart[numFaces] = len;
+            s->faceSeqLen[numFaces] = L1;
+            numFaces++;
+            len += L1;
+        }
+    }
+
+    // Insertion sort the faces
+    for (i = 1; i < numFaces; i++)
+    {
+        t1 = s->faceSeqStart[i];
+        t2 = s->faceSeqLen[i];
+        for (j = i; j > 0 && _SurfaceEmbed_CompareSequences(s->seq + t1, t2,
+                            s->seq + s->faceSeqStart[j-1], s->faceSeqLen[j-1]) < 0; j--)
+        {
+            s->faceSeqStart[j] = s->faceSeqStart[j-1];
+            s->faceSeqLen[j] = s->faceSeqLen[j-1];
+        }
+        s->faceSeqStart[j] = t1;
+        s->faceSeqLen[j] = t2;
+    }
+
+    if ((key = (int *) malloc((4 + numFaces + len) * sizeof(int))) == NULL)
+        return NULL;
+
+    key[0] = 4 + numFaces + len;
+    key[1] = k;
+    key[2] = eg;
+    key[3] = numFaces;
+    out = key + 4;
+    for (i = 0; i < numFaces; i++)
+    {
+        *out++ = s->faceSeqLen[i];
+        memcpy(out, s->seq + s->faceSeqStart[i], s->faceSeqLen[i] * sizeof(int));
+        out += s->faceSeqLen[i];
+    }
+
+    return key;
+}
+
+/********************************************************************
+ _SurfaceEmbed_FaceSequence()
+
+ Stores in seq the active vertex and orientation of each state of the
+ orbit, and returns the length of the sequence.
+ ********************************************************************/
+
+int  _SurfaceEmbed_FaceSequence(surfaceSearchRecP s, int orbitId, int *seq)
+{
+int st = s->orbitStart[orbitId], x = st, v, len = 0;
+
+    do {
+        v = s->arcVertex[x >> 1];
+        if (s->embeddedDegree[v] < s->adjStart[v+1] - s->adjStart[v])
+            seq[len++] = 2*v + (x & 1);
+        x = _SurfaceEmbed_NextState(s, x);
+    } while (x != st);
+
+    return len;
+}
+
+/********************************************************************
+ _SurfaceEmbed_MinRotation()
+
+ Rotates the sequence to its lexicographically least rotation.
+ ********************************************************************/
+
+void _SurfaceEmbed_MinRotation(int *seq, int len)
+{
+int best = 0, r, i, a, b, temp;
+
+    for (r = 1; r < len; r++)
+    {
+        for (i = 0; i < len; i++)
+        {
+            a = seq[(r + i) % len];
+            b = seq[(best + i) % len];
+            if (a != b)
+            {
+                if (a < b)
+                    best = r;
+                break;
+            }
+        }
+    }
+
+    // Rotate by reversing the two parts, then the whole
+    for (i = 0, r = best-1; i < r; i++, r--)
+    {
+        temp = seq[i]; seq[i] = seq[r]; seq[r] = temp;
+    }
+    for (i = best, r = len-1; i < r; i++, r--)
+    {
+        temp = seq[i]; seq[i] = seq[r]; seq[r] = temp;
+    }
+    for (i = 0, r = len-1; i < r; i++, r--)
+    {
+        temp = seq[i]; seq[i] = seq[r]; seq[r] = temp;
+    }
+}
+
+/********************************************************************
+ _SurfaceEmbed_CompareSequences()
+
+ Compares two sequences by length, then lexicographically.
+ ********************************************************************/
+
+int  _SurfaceEmbed_CompareSequences(int *seq1, int len1, int *seq2, int len2)
+{
+int i;
+
+    if (len1 != len2)
+        return len1 < len2 ? -1 : 1;
+
+    for (i = 0; i < len1; i++)
+        if (seq1[i] != seq2[i])
+            return seq1[i] < seq2[i] ? -1 : 1;
+
+    return 0;
+}
+
+/********************************************************************
+ _SurfaceEmbed_HashKey()
+ ********************************************************************/
+
+unsigned _SurfaceEmbed_HashKey(int *key)
+{
+unsigned h = 2166136261u;
+int i;
+
+    for (i = 0; i < key[0]; i++)
+        h = (h ^ (unsigned) key[i]) * 16777619u;
+
+    return h;
+}
+
+/********************************************************************
+ _SurfaceEmbed_MemoFind()
+
+ Returns TRUE if the key is in the hash set of failed states.
+ ********************************************************************/
+
+int  _SurfaceEmbed_MemoFind(surfaceSearchRecP s, int *key)
+{
+unsigned h;
+
+    if (s->memo == NULL)
+        return FALSE;
+
+    h = _SurfaceEmbed_HashKey(key) & (s->memoSize - 1);
+    while (s->memo[h] != NULL)
+    {
+        if (s->memo[h][0] == key[0] && memcmp(s->memo[h], key, key[0] * sizeof(int)) == 0)
+            return TRUE;
+        h = (h + 1) & (s->memoSize - 1);
+    }
+
+    return FALSE;
+}
+
+/********************************************************************
+ _SurfaceEmbed_MemoAdd()
+
+ Adds the key to the hash set of failed states, which takes ownership
+ of it.  The hash set doubles in size when it becomes half full, and it
+ stops growing once SURFACEEMBED_MEMO_LIMIT is reached or memory runs
+ out, since the memoization only serves to prune the search.
+ ********************************************************************/
+
+void _SurfaceEmbed_MemoAdd(surfaceSearchRecP s, int *key)
+{
+int **newMemo, newSize, i;
+unsigned h;
+
+    if (s->memoInts + key[0] > SURFACEEMBED_MEMO_LIMIT)
+    {
+        free(key);
+        return;
+    }
+
+    if (2 * (s->memoCount + 1) > s->memoSize)
+    {
+        newSize = s->memoSize > 0 ? 2 * s->memoSize : 1024;
+        if ((newMemo = (int **) calloc(newSize, sizeof(int *))) == NULL)
+        {
+            free(key);
+            return;
+        }
+
+        for (i = 0; i < s->memoSize; i++)
+        {
+            if (s->memo[i] != NULL)
+            {
+                h = _SurfaceEmbed_HashKey(s->memo[i]) & (newSize - 1);
+                while (newMemo[h] != NULL)
+                    h = (h + 1) & (newSize - 1);
+                newMemo[h] = s->memo[i];
+            }
+        }
+
+        if (s->memo != NULL)
+            free(s->memo);
+        s->memo = newMemo;
+        s->memoSize = newSize;
+    }
+
+    h = _SurfaceEmbed_HashKey(key) & (s->memoSize - 1);
+    while (s->memo[h] != NULL)
+        h = (h + 1) & (s->memoSize - 1);
+    s->memo[h] = key;
+    s->memoCount++;
+    s->memoInts += key[0];
+}
+
+/********************************************************************
+ _SurfaceEmbed_Assemble()
+
+ Restores the edges of the input graph in theGraph, in the order and
+ with the arc indices of G.  If the search found an embedding of R, then
+ the adjacency list of each vertex is set to its rotation: for a vertex
+ of R, the first arcs of the paths of its arcs of R in rotation order,
+ for an inner vertex of a path, its two arcs in the block, followed in
+ each case by the arcs of the vertex in the planar embedding of Gp.
+ The inverted flag is set on the first edge of the path of each twisted
+ edge of R.
+ ********************************************************************/
+
+int  _SurfaceEmbed_Assemble(surfaceSearchRecP s, int found)
+{
+graphP theGraph = s->context->theGraph, G = s->G, Gp = s->Gp;
+int v, e, n, i, a, r, numArcs = 0, *list;
+
+    for (v = gp_GetFirstVertex(theGraph); gp_VertexInRange(theGraph, v); v++)
+    {
+        gp_SetFirstArc(theGraph, v, NIL);
+        gp_SetLastArc(theGraph, v, NIL);
+    }
+    for (v = gp_GetFirstVirtualVertex(theGraph); gp_VirtualVertexInRange(theGraph, v); v++)
+    {
+        gp_SetFirstArc(theGraph, v, NIL);
+        gp_SetLastArc(theGraph, v, NIL);
+    }
+
+    _InitEdges(theGraph);
+    theGraph->M = 0;
+    sp_ClearStack(theGraph->edgeHoles);
+
+    for (e = gp_GetFirstEdge(G); e < gp_EdgeInUseIndexBound(G); e+=2)
+    {
+        if (gp_AddEdge(theGraph, gp_GetNeighbor(G, e), 0, gp_GetNeighbor(G, e+1), 0) != OK)
+            return NOTOK;
+    }
+
+    if (!found)
+        return OK;
+
+    if ((list = (int *) malloc(gp_EdgeIndexBound(G) * sizeof(int))) == NULL)
+        return NOTOK;
+
+    for (v = gp_GetFirstVertex(theGraph); gp_VertexInRange(theGraph, v); v++)
+    {
+        n = 0;
+
+        if (s->RVertexOf[v] >= 0)
+        {
+            r = s->RVertexOf[v];
+            a = s->anyArc[r];
+            do {
+                list[n++] = s->chainArc[a];
+                a = s->rnext[a];
+            } while (a != s->anyArc[r]);
+        }
+        else if (s->degreeInBlock[v] > 0)
+        {
+            e = gp_GetFirstArc(G, v);
+            while (gp_IsArc(e))
+            {
+                if (s->edgeBlock[e >> 1] == s->theBlock)
+                    list[n++] = e;
+                e = gp_GetNextArc(G, e);
+            }
+        }
+
+        e = gp_GetFirstArc(Gp, v);
+        while (gp_IsArc(e))
+        {
+            list[n++] = s->gpArcMap[e];
+            e = gp_GetNextArc(Gp, e);
+        }
+
+        if (n == 0)
+            continue;
+
+        gp_SetFirstArc(theGraph, v, list[0]);
+        gp_SetLastArc(theGraph, v, list[n-1]);
+        for (i = 0; i < n; i++)
+        {
+            gp_SetPrevArc(theGraph, list[i], i > 0 ? list[i-1] : NIL);
+            gp_SetNextArc(theGraph, list[i], i < n-1 ? list[i+1] : NIL);
+        }
+        numArcs += n;
+    }
+
+    free(list);
+
+    if (numArcs != 2 * theGraph->M)
+        return NOTOK;
+
+    for (i = 0; i < s->numREdges; i++)
+    {
+        if (s->twisted[i])
+        {
+            gp_SetEdgeFlagInverted(theGraph, s->chainArc[2*i]);
+            gp_SetEdgeFlagInverted(theGraph, gp_GetTwinArc(theGraph, s->chainArc[2*i]));
+        }
+    }
+
+    return OK;
+}
+
+/********************************************************************
+ _CheckSurfaceEmbeddingIntegrity()
+
+ Traverses the faces of the embedding in theGraph, in which an edge
+ with the inverted flag passes through a crosscap, so the traversal
+ flips its orientation when it crosses such an edge, and then takes the
+ previous arc around each vertex rather than the next.  Each face is
+ traversed once in each orientation, or only in orientation 0 if the
+ embedding is required to be orientable, in which case no edge can be
+ inverted.  The Euler genus is then obtained from Euler's formula,
+ applied to each connected component that has edges.
+
+ Returns OK if the Euler genus is at most maxEulerGenus, NOTOK otherwise.
+ ********************************************************************/
+
+int _CheckSurfaceEmbeddingIntegrity(graphP theGraph, int maxEulerGenus, int orientable)
+{
+int v, e, t, o, d, st, x, EsizeOccupied, numArcs = 0, numOrbits = 0, F, c = 0, NV = 0, eg;
+char *visited;
+
+    // Check the adjacency lists and the inverted flags
+    for (v = gp_GetFirstVertex(theGraph); gp_VertexInRange(theGraph, v); v++)
+    {
+        e = gp_GetFirstArc(theGraph, v);
+        while (gp_IsArc(e))
+        {
+            t = gp_GetTwinArc(theGraph, e);
+            if (gp_GetNeighbor(theGraph, t) != v ||
+                (gp_GetEdgeFlagInverted(theGraph, e) != 0) != (gp_GetEdgeFlagInverted(theGraph, t) != 0) ||
+                (orientable && gp_GetEdgeFlagInverted(theGraph, e)))
+                return NOTOK;
+
+            if (++numArcs > 2 * theGraph->M)
+                return NOTOK;
+            e = gp_GetNextArc(theGraph, e);
+        }
+    }
+
+    if (numArcs != 2 * theGraph->M)
+        return NOTOK;
+
+    EsizeOccupied = gp_EdgeInUseIndexBound(theGraph);
+    if ((visited = (char *) calloc(2 * EsizeOccupied, sizeof(char))) == NULL)
+        return NOTOK;
+
+    // Traverse the faces
+    for (e = gp_GetFirstEdge(theGraph); e < EsizeOccupied; e++)
+    {
+        if (!gp_EdgeInUse(theGraph, e))
+            continue;
+
+        for (o = 0; o < (orientable ? 1 : 2); o++)
+        {
+            if (visited[st = 2*e + o])
+                continue;
+
+            x = st;
+            do {
+                if (visited[x])
+                {
+                    free(visited);
+                    return NOTOK;
+                }
+                visited[x] = 1;
+
+                t = gp_GetTwinArc(theGraph, x >> 1);
+                d = (x & 1) ^ (gp_GetEdgeFlagInverted(theGraph, t) ? 1 : 0);
+                x = 2 * (d ? gp_GetPrevArcCircular(theGraph, t) : gp_GetNextArcCircular(theGraph, t)) + d;
+            } while (x != st);
+
+            numOrbits++;
+        }
+    }
+
+    free(visited);
+
+    if (!orientable && numOrbits % 2 != 0)
+        return NOTOK;
+
+    F = orientable ? numOrbits : numOrbits / 2;
+
+    for (v = gp_GetFirstVertex(theGraph); gp_VertexInRange(theGraph, v); v++)
+    {
+        if (gp_GetVertexDegree(theGraph, v) > 0)
+        {
+            NV++;
+            if (gp_IsDFSTreeRoot(theGraph, v))
+                c++;
+        }
+    }
+
+    eg = 2*c - NV + theGraph->M - F;
+
+    if (eg < 0 || eg > maxEulerGenus || (orientable && eg % 2 != 0))
+        return NOTOK;
+
+    return OK;
+}
@@ -0,0 +1,354 @@
+/*
+Planarity-Related Graph Algorithms Project
+Copyright (c) 1997-2012, John M. Boyer
+All rights reserved. Includes a reference implementation of the following:
+
+* John M. Boyer. "Subgraph Homeomorphism via the Edge Addition Planarity Algorithm".
+  Journal of Graph Algorithms and Applications, Vol. 16, no. 2, pp. 381-410, 2012.
+  http://www.jgaa.info/16/268.html
+
+* John M. Boyer. "A New Method for Efficiently Generating Planar Graph
+  Visibility Representations". In P. Eades and P. Healy, editors,
+  Proceedings of the 13th International Conference on Graph Drawing 2005,
+  Lecture Notes Comput. Sci., Volume 3843, pp. 508-511, Springer-Verlag, 2006.
+
+* John M. Boyer and Wendy J. Myrvold. "On the Cutting Edge: Simplified O(n)
+  Planarity by Edge Addition". Journal of Graph Algorithms and Applications,
+  Vol. 8, No. 3, pp. 241-273, 2004.
+  http://www.jgaa.info/08/91.html
+
+* John M. Boyer. "Simplified O(n) Algorithms for Planar Graph Embedding,
+  Kuratowski Subgraph Isolation, and Related Problems". Ph.D. Dissertation,
+  University of Victoria, 2001.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+* Redistributions of source code must retain the above copyright notice, this
+  list of conditions and the following disclaimer.
+
+* Redistributions in binary form must reproduce the above copyright notice, this
+  list of conditions and the following disclaimer in the documentation and/or
+  other materials provided with the distribution.
+
+* Neither the name of the Planarity-Related Graph Algorithms Project nor the names
+  of its contributors may be used to endorse or promote products derived from this
+  software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include <stdlib.h>
+
+#include "graphSurfaceEmbed.private.h"
+#include "graphSurfaceEmbed.h"
+
+extern int  _IsolateKuratowskiSubgraph(graphP theGraph, int v, int R);
+extern int  _TestSubgraph(graphP theSubgraph, graphP theGraph);
+
+extern int  _CopySurfaceEmbedGraph(SurfaceEmbedContext *context);
+extern int  _SearchForSurfaceEmbedding(SurfaceEmbedContext *context);
+extern int  _CheckSurfaceEmbeddingIntegrity(graphP theGraph, int maxEulerGenus, int orientable);
+
+/* Forward declarations of overloading functions */
+
+int  _SurfaceEmbed_EmbeddingInitialize(graphP theGraph);
+int  _SurfaceEmbed_HandleBlockedBicomp(graphP theGraph, int v, int RootVertex, int R);
+int  _SurfaceEmbed_EmbedPostprocess(graphP theGraph, int v, int edgeEmbeddingResult);
+int  _SurfaceEmbed_CheckEmbeddingIntegrity(graphP theGraph, graphP origGraph);
+int  _SurfaceEmbed_CheckObstructionIntegrity(graphP theGraph, graphP origGraph);
+
+/* Forward declarations of functions used by the extension system */
+
+void *_SurfaceEmbed_DupContext(void *pContext, void *theGraph);
+void _SurfaceEmbed_FreeContext(void *);
+
+/****************************************************************************
+ * SURFACEEMBED_ID - the variable used to hold the integer identifier for this
+ * extension, enabling this feature's extension context to be distinguished
+ * from other features' extension contexts that may be attached to a graph.
+ ****************************************************************************/
+
+int SURFACEEMBED_ID = 0;
+
+/****************************************************************************
+ gp_AttachSurfaceEmbed()
+
+ This function adjusts the graph data structure to attach the feature that
+ embeds graphs on the projective plane and on the torus.
+
+ To activate this feature during gp_Embed(), use EMBEDFLAGS_PROJECTIVEPLANAR
+ or EMBEDFLAGS_TOROIDAL.  The result is OK if the graph is embedded on the
+ surface, in which case the adjacency lists give the rotation of each vertex.
+ On the projective plane, the edges that pass through the crosscap have the
+ inverted flag set.  The result is NONEMBEDDABLE if the graph does not embed
+ on the surface, in which case theGraph is restored to the input graph.
+ ****************************************************************************/
+
+int  gp_AttachSurfaceEmbed(graphP theGraph)
+{
+     SurfaceEmbedContext *context = NULL;
+
+     // If the surface embedding feature has already been attached to the graph
+     // then there is no need to attach it again
+     gp_FindExtension(theGraph, SURFACEEMBED_ID, (void *)&context);
+     if (context != NULL)
+     {
+         return OK;
+     }
+
+     // Allocate a new extension context
+     context = (SurfaceEmbedContext *) malloc(sizeof(SurfaceEmbedContext));
+     if (context == NULL)
+     {
+         return NOTOK;
+     }
+
+     context->theGraph = theGraph;
+     context->origGraph = NULL;
+
+     // Put the overload functions into the context function table.
+     // gp_AddExtension will overload the graph's functions with these, and
+     // return the base function pointers in the context function table
+     memset(&context->functions, 0, sizeof(graphFunctionTable));
+
+     context->functions.fpEmbeddingInitialize = _SurfaceEmbed_EmbeddingInitialize;
+     context->functions.fpHandleBlockedBicomp = _SurfaceEmbed_HandleBlockedBicomp;
+     context->functions.fpEmbedPostprocess = _SurfaceEmbed_EmbedPostprocess;
+     context->functions.fpCheckEmbeddingIntegrity = _SurfaceEmbed_CheckEmbeddingIntegrity;
+     context->functions.fpCheckObstructionIntegrity = _SurfaceEmbed_CheckObstructionIntegrity;
+
+     // Store the surface embedding context, including the data structure and
+     // the function pointers, as an extension of the graph
+     if (gp_AddExtension(theGraph, &SURFACEEMBED_ID, (void *) context,
+                         _SurfaceEmbed_DupContext, _SurfaceEmbed_FreeContext,
+                         &context->functions) != OK)
+     {
+         _SurfaceEmbed_FreeContext(context);
+         return NOTOK;
+     }
+
+     return OK;
+}
+
+/********************************************************************
+ gp_DetachSurfaceEmbed()
+ ********************************************************************/
+
+int gp_DetachSurfaceEmbed(graphP theGraph)
+{
+    return gp_RemoveExtension(theGraph, SURFACEEMBED_ID);
+}
+
+/********************************************************************
+ _SurfaceEmbed_DupContext()
+ The copy of the input graph is only used during gp_Embed(),
+ so it is not duplicated.
+ ********************************************************************/
+
+void *_SurfaceEmbed_DupContext(void *pContext, void *theGraph)
+{
+     SurfaceEmbedContext *context = (SurfaceEmbedContext *) pContext;
+     SurfaceEmbedContext *newContext = (SurfaceEmbedContext *) malloc(sizeof(SurfaceEmbedContext));
+
+     if (newContext != NULL)
+     {
+         *newContext = *context;
+
+         newContext->theGraph = (graphP) theGraph;
+         newContext->origGraph = NULL;
+     }
+
+     return newContext;
+}
+
+/********************************************************************
+ _SurfaceEmbed_FreeContext()
+ ********************************************************************/
+
+void _SurfaceEmbed_FreeContext(void *pContext)
+{
+     SurfaceEmbedContext *context = (SurfaceEmbedContext *) pContext;
+
+     gp_Free(&context->origGraph);
+     free(pContext);
+}
+
+/********************************************************************
+ _SurfaceEmbed_EmbeddingInitialize()
+
+ For the surface embeddings, the graph is preprocessed and then copied
+ before the base initialization separates the DFS tree edges into
+ singleton bicomps.  The copy therefore has the DFI vertex numbering
+ that theGraph still has once the core planarity algorithm finishes.
+ ********************************************************************/
+
+int  _SurfaceEmbed_EmbeddingInitialize(graphP theGraph)
+{
+    SurfaceEmbedContext *context = NULL;
+    context = (SurfaceEmbedContext *) gp_GetExtensionContext(theGraph, SURFACEEMBED_ID);
+
+    if (context == NULL)
+        return NOTOK;
+
+    if (theGraph->embedFlags == EMBEDFLAGS_PROJECTIVEPLANAR ||
+        theGraph->embedFlags == EMBEDFLAGS_TOROIDAL)
+    {
+        if (gp_PreprocessForEmbedding(theGraph) != OK ||
+            _CopySurfaceEmbedGraph(context) != OK)
+            return NOTOK;
+    }
+
+    return context->functions.fpEmbeddingInitialize(theGraph);
+}
+
+/********************************************************************
+ _SurfaceEmbed_HandleBlockedBicomp()
+
+ For the surface embeddings, the core planarity algorithm isolates a
+ Kuratowski subgraph as it would for EMBEDFLAGS_PLANAR.  The search
+ for the surface embedding starts with the edges of this subgraph.
+ ********************************************************************/
+
+int  _SurfaceEmbed_HandleBlockedBicomp(graphP theGraph, int v, int RootVertex, int R)
+{
+    if (theGraph->embedFlags == EMBEDFLAGS_PROJECTIVEPLANAR ||
+        theGraph->embedFlags == EMBEDFLAGS_TOROIDAL)
+    {
+        if (R != RootVertex)
+            sp_Push2(theGraph->theStack, R, 0);
+
+        if (_IsolateKuratowskiSubgraph(theGraph, v, RootVertex) != OK)
+            return NOTOK;
+
+        return NONEMBEDDABLE;
+    }
+
+    else
+    {
+        SurfaceEmbedContext *context = NULL;
+        context = (SurfaceEmbedContext *) gp_GetExtensionContext(theGraph, SURFACEEMBED_ID);
+
+        if (context != NULL)
+        {
+            return context->functions.fpHandleBlockedBicomp(theGraph, v, RootVertex, R);
+        }
+    }
+
+    return NOTOK;
+}
+
+/********************************************************************
+ _SurfaceEmbed_EmbedPostprocess()
+
+ A planar embedding is also an embedding on the surface, so it is
+ postprocessed by the superclass.  Otherwise, theGraph contains a
+ Kuratowski subgraph, and the search for the surface embedding is
+ performed on the copy of the input graph.
+ ********************************************************************/
+
+int  _SurfaceEmbed_EmbedPostprocess(graphP theGraph, int v, int edgeEmbeddingResult)
+{
+    SurfaceEmbedContext *context = NULL;
+    int RetVal;
+
+    context = (SurfaceEmbedContext *) gp_GetExtensionContext(theGraph, SURFACEEMBED_ID);
+
+    if (context == NULL)
+        return NOTOK;
+
+    RetVal = context->functions.fpEmbedPostprocess(theGraph, v, edgeEmbeddingResult);
+
+    if ((theGraph->embedFlags == EMBEDFLAGS_PROJECTIVEPLANAR ||
+         theGraph->embedFlags == EMBEDFLAGS_TOROIDAL) && context->origGraph != NULL)
+    {
+        if (RetVal == NONEMBEDDABLE)
+            RetVal = _SearchForSurfaceEmbedding(context);
+
+        gp_Free(&context->origGraph);
+    }
+
+    return RetVal;
+}
+
+/********************************************************************
+ _SurfaceEmbed_CheckEmbeddingIntegrity()
+
+ For the surface embeddings, the face walk accounts for the edges
+ that pass through the crosscap of the projective plane, and the
+ Euler genus it obtains must be at most 1 for the projective plane,
+ or at most 2 without any inverted edges for the torus.
+ ********************************************************************/
+
+int  _SurfaceEmbed_CheckEmbeddingIntegrity(graphP theGraph, graphP origGraph)
+{
+     if (theGraph->embedFlags == EMBEDFLAGS_PROJECTIVEPLANAR ||
+         theGraph->embedFlags == EMBEDFLAGS_TOROIDAL)
+     {
+         if (_TestSubgraph(theGraph, origGraph) != TRUE ||
+             _TestSubgraph(origGraph, theGraph) != TRUE)
+             return NOTOK;
+
+         if (theGraph->embedFlags == EMBEDFLAGS_PROJECTIVEPLANAR)
+             return _CheckSurfaceEmbeddingIntegrity(theGraph, 1, FALSE);
+
+         return _CheckSurfaceEmbeddingIntegrity(theGraph, 2, TRUE);
+     }
+
+     // When not embedding on a surface, we let the superclass do the work
+     else
+     {
+        SurfaceEmbedContext *context = NULL;
+        context = (SurfaceEmbedContext *) gp_GetExtensionContext(theGraph, SURFACEEMBED_ID);
+
+        if (context != NULL)
+        {
+            return context->functions.fpCheckEmbeddingIntegrity(theGraph, origGraph);
+        }
+     }
+
+     return NOTOK;
+}
+
+/********************************************************************
+ _SurfaceEmbed_CheckObstructionIntegrity()
+
+ For the surface embeddings, there is no small obstruction to isolate,
+ so theGraph must be the same graph as the input graph.
+ ********************************************************************/
+
+int  _SurfaceEmbed_CheckObstructionIntegrity(graphP theGraph, graphP origGraph)
+{
+     if (theGraph->embedFlags == EMBEDFLAGS_PROJECTIVEPLANAR ||
+         theGraph->embedFlags == EMBEDFLAGS_TOROIDAL)
+     {
+         if (_TestSubgraph(theGraph, origGraph) != TRUE ||
+             _TestSubgraph(origGraph, theGraph) != TRUE)
+             return NOTOK;
+
+         return OK;
+     }
+
+     // When not embedding on a surface, we let the superclass do the work
+     else
+     {
+        SurfaceEmbedContext *context = NULL;
+        context = (SurfaceEmbedContext *) gp_GetExtensionContext(theGraph, SURFACEEMBED_ID);
+
+        if (context != NULL)
+        {
+            return context->functions.fpCheckObstructionIntegrity(theGraph, origGraph);
+        }
+     }
+
+     return NOTOK;
+}
@@ -120,6 +120,13 @@ int gp_TestEmbedResultIntegrity(graphP theGraph, graphP origGraph, int embedResu
 {
 int RetVal = embedResult;
 
+#ifdef PROFILE
+platform_time start, end;
+platform_counters startCounters, endCounters;
+platform_GetTime(start);
+platform_GetCounters(&startCounters);
+#endif
+
     if (theGraph == NULL || origGraph == NULL)
         return NOTOK;
 
@@ -135,6 +142,13 @@ int RetVal = embedResult;
     if (RetVal == OK)
     	RetVal = embedResult;
 
+#ifdef PROFILE
+platform_GetCounters(&endCounters);
+platform_GetTime(end);
+printf("Integrity test in %.3lf seconds.\n", platform_GetDuration(start,end));
+platform_PrintCounters("Integrity test", &startCounters, &endCounters, origGraph->M);
+#endif
+
     return RetVal;
 }
 
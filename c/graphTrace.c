@@ -0,0 +1,410 @@
+/*
+Planarity-Related Graph Algorithms Project
+Copyright (c) 1997-2012, John M. Boyer
+All rights reserved. Includes a reference implementation of the following:
+
+* John M. Boyer. "Subgraph Homeomorphism via the Edge Addition Planarity Algorithm".
+  Journal of Graph Algorithms and Applications, Vol. 16, no. 2, pp. 381-410, 2012.
+  http://www.jgaa.info/16/268.html
+
+* John M. Boyer. "A New Method for Efficiently Generating Planar Graph
+  Visibility Representations". In P. Eades and P. Healy, editors,
+  Proceedings of the 13th International Conference on Graph Drawing 2005,
+  Lecture Notes Comput. Sci., Volume 3843, pp. 508-511, Springer-Verlag, 2006.
+
+* John M. Boyer and Wendy J. Myrvold. "On the Cutting Edge: Simplified O(n)
+  Planarity by Edge Addition". Journal of Graph Algorithms and Applications,
+  Vol. 8, No. 3, pp. 241-273, 2004.
+  http://www.jgaa.info/08/91.html
+
+* John M. Boyer. "Simplified O(n) Algorithms for Planar Graph Embedding,
+  Kuratowski Subgraph Isolation, and Related Problems". Ph.D. Dissertation,
+  University of Victoria, 2001.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+* Redistributions of source code must retain the above copyright notice, this
+  list of conditions and the following disclaimer.
+
+* Redistributions in binary form must reproduce the above copyright notice, this
+  list of conditions and the following disclaimer in the documentation and/or
+  other materials provided with the distribution.
+
+* Neither the name of the Planarity-Related Graph Algorithms Project nor the names
+  of its contributors may be used to endorse or promote products derived from this
+  software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include <stdlib.h>
+
+#include "graph.h"
+
+/* Private definitions */
+
+/* The trace file begins with a header, followed by numRecords trace
+   records in the order in which the events occurred.  The firstEvent
+   member is the sequence number of the first record, which is nonzero
+   if the ring buffer overwrote older events.  The trace file is written
+   in the native byte order and integer sizes of the platform. */
+
+#define TRACE_MAGIC     0x43525450
+#define TRACE_VERSION   1
+
+typedef struct
+{
+    int magic, version, numArgs, numRecords;
+    unsigned long firstEvent;
+} traceFileHeader;
+
+/* The decoder's description of each trace event: its name, its Chrome
+   trace event phase (B for the beginning of a span, E for the end of
+   a span, i for an instantaneous event), and the names of its arguments.
+   The table is indexed by event identifier. */
+
+typedef struct
+{
+    char *name;
+    char phase;
+    char *argNames[TRACE_MAXARGS];
+} traceEventInfo;
+
+static traceEventInfo traceEvents[TRACE_NUMEVENTS] =
+{
+    { "Unknown", 'i', { NULL } },
+    { "CreateDFSTree", 'B', { NULL } },
+    { "CreateDFSTree", 'E', { NULL } },
+    { "DFSVisit", 'i', { "v", "DFI", "parent", NULL } },
+    { "SortVertices", 'B', { NULL } },
+    { "SortVertices", 'E', { NULL } },
+    { "LowpointAndLeastAncestor", 'B', { NULL } },
+    { "LowpointAndLeastAncestor", 'E', { NULL } },
+    { "LeastAncestor", 'B', { NULL } },
+    { "LeastAncestor", 'E', { NULL } },
+    { "EmbeddingInitialize", 'B', { NULL } },
+    { "EmbeddingInitialize", 'E', { NULL } },
+    { "WalkDown", 'B', { "v", "RootVertex", NULL } },
+    { "WalkDown", 'E', { "result", NULL } },
+    { "EmbedBackEdgeToDescendant", 'i', { "v", "R", "R_out", "W", "W_in" } },
+    { "InvertVertex", 'i', { "W", NULL } },
+    { "MergeVertex", 'i', { "W", "W_in", "R", "R_out", NULL } },
+    { "HandleBlockedBicomp", 'i', { "v", "RootVertex", "R", NULL } },
+    { "EmbedComponents", 'B', { "embedFlags", "numThreads", NULL } },
+    { "EmbedComponents", 'E', { "result", NULL } },
+    { "EmbedReduced", 'B', { "embedFlags", NULL } },
+    { "EmbedReduced", 'E', { "result", NULL } },
+    { "ComputeEdgePositions", 'B', { NULL } },
+    { "ComputeEdgePositions", 'E', { NULL } },
+    { "VertexPosition", 'i', { "v", "DFI", "position", NULL } },
+    { "AppendGeneratorEdge", 'i', { "u", "v", NULL } },
+    { "InsertEdge", 'i', { "u", "v", "afterU", "afterV", NULL } },
+    { "GeneratorEdge", 'i', { "u", "v", NULL } },
+    { "EdgeListEntry", 'i', { "u", "v", NULL } },
+    { "CollectDrawingData", 'B', { "RootVertex", "W", "W_in", NULL } },
+    { "CollectDrawingData", 'E', { NULL } },
+    { "Tie", 'i', { "parent", "direction", "descendant", "descendantDirection", "child" } },
+    { "BreakTie", 'B', { "BicompRoot", "W", "W_in", "WPred", NULL } },
+    { "BreakTie", 'E', { NULL } },
+    { "TieAncestor", 'i', { "child", "ancestorChild", "ancestor", NULL } },
+    { "Between", 'i', { "child", "ancestorChild", "ancestor", NULL } },
+    { "Beyond", 'i', { "child", "ancestorChild", "ancestor", NULL } },
+    { "EmbedBlocks", 'B', { "embedFlags", "numThreads", NULL } },
+    { "EmbedBlocks", 'E', { "result", NULL } },
+    { "CreateSPQRTree", 'B', { NULL } },
+    { "CreateSPQRTree", 'E', { "result", "numNodes", NULL } }
+};
+
+/* Private functions */
+
+void _TraceDecodeText(FILE *outfile, traceRecP rec, unsigned long eventNum, int *pDepth);
+void _TraceDecodeJSON(FILE *outfile, traceRecP rec, unsigned long eventNum, int isFirst);
+
+/********************************************************************
+ gp_TraceEnable()
+
+ Attaches a trace ring buffer that can hold the given number of events
+ to the graph, so that the trace points in the graph algorithms record
+ events for theGraph.  If capacity is not positive, then the default
+ capacity TRACE_DEFAULT_CAPACITY is used.  Any events recorded by a
+ previously enabled trace are discarded.
+
+ Returns OK on success, NOTOK on allocation failure
+ ********************************************************************/
+
+int  gp_TraceEnable(graphP theGraph, int capacity)
+{
+traceBufferP theTrace;
+
+     if (theGraph == NULL)
+         return NOTOK;
+
+     gp_TraceDisable(theGraph);
+
+     if (capacity <= 0)
+         capacity = TRACE_DEFAULT_CAPACITY;
+
+     theTrace = (traceBufferP) malloc(sizeof(traceBuffer));
+     if (theTrace == NULL)
+         return NOTOK;
+
+     theTrace->records = (traceRecP) malloc(capacity * sizeof(traceRec));
+     if (theTrace->records == NULL)
+     {
+         free(theTrace);
+         return NOTOK;
+     }
+
+     theTrace->capacity = capacity;
+     theTrace->next = 0;
+     theTrace->numEvents = 0;
+
+     theGraph->trace = theTrace;
+     return OK;
+}
+
+/********************************************************************
+ gp_TraceDisable()
+
+ Frees the trace ring buffer, if any, so that the trace points in the
+ graph algorithms return to doing nothing for theGraph.
+ ********************************************************************/
+
+void gp_TraceDisable(graphP theGraph)
+{
+     if (theGraph == NULL || theGraph->trace == NULL)
+         return;
+
+     free(theGraph->trace->records);
+     free(theGraph->trace);
+     theGraph->trace = NULL;
+}
+
+/********************************************************************
+ _Trace()
+
+ Records one event in the trace ring buffer, overwriting the oldest
+ event if the buffer is full.  This is called by the gp_Trace macros
+ only when tracing is enabled, and it does no formatting or I/O.
+ ********************************************************************/
+
+void _Trace(traceBufferP theTrace, int eventId, int one, int two, int three, int four, int five)
+{
+traceRecP rec = theTrace->records + theTrace->next;
+
+     rec->eventId = eventId;
+     rec->args[0] = one;
+     rec->args[1] = two;
+     rec->args[2] = three;
+     rec->args[3] = four;
+     rec->args[4] = five;
+
+     if (++theTrace->next == theTrace->capacity)
+         theTrace->next = 0;
+
+     theTrace->numEvents++;
+}
+
+/********************************************************************
+ gp_TraceWrite()
+
+ Writes the events in the trace ring buffer of theGraph to a binary
+ trace file, oldest event first.  The recorded events are kept, so
+ the trace can be written again after more events have been recorded.
+
+ Returns OK on success, NOTOK if tracing is not enabled for the graph
+         or if the file could not be written
+ ********************************************************************/
+
+int  gp_TraceWrite(graphP theGraph, char *FileName)
+{
+traceBufferP theTrace;
+traceFileHeader header;
+FILE *outfile;
+int  start, Result = OK;
+
+     if (theGraph == NULL || (theTrace = theGraph->trace) == NULL)
+         return NOTOK;
+
+     if ((outfile = fopen(FileName, "wb")) == NULL)
+         return NOTOK;
+
+     header.magic = TRACE_MAGIC;
+     header.version = TRACE_VERSION;
+     header.numArgs = TRACE_MAXARGS;
+
+     // If the ring buffer has wrapped, then the oldest event is at the next
+     // position to be written, and the events before it are the newest
+     if (theTrace->numEvents > (unsigned long) theTrace->capacity)
+     {
+         header.numRecords = theTrace->capacity;
+         start = theTrace->next;
+     }
+     else
+     {
+         header.numRecords = (int) theTrace->numEvents;
+         start = 0;
+     }
+     header.firstEvent = theTrace->numEvents - header.numRecords;
+
+     if (fwrite(&header, sizeof(traceFileHeader), 1, outfile) != 1)
+         Result = NOTOK;
+
+     if (Result == OK && start > 0)
+     {
+         if (fwrite(theTrace->records + start, sizeof(traceRec),
+                    theTrace->capacity - start, outfile) != (size_t) (theTrace->capacity - start))
+             Result = NOTOK;
+     }
+
+     if (Result == OK && theTrace->next > 0)
+     {
+         if (fwrite(theTrace->records, sizeof(traceRec),
+                    theTrace->next, outfile) != (size_t) theTrace->next)
+             Result = NOTOK;
+     }
+
+     if (fclose(outfile) != 0)
+         Result = NOTOK;
+
+     return Result;
+}
+
+/********************************************************************
+ gp_TraceDecode()
+
+ Reads a binary trace file written by gp_TraceWrite() and writes its
+ events to the output file in the given format, either TRACEFORMAT_TEXT
+ or TRACEFORMAT_JSON.
+
+ The text format has one line per event, indented by the nesting of
+ the spans formed by BEGIN and END events.  The JSON format is the
+ Chrome trace event format.  Since trace records are not timestamped,
+ the event sequence number is used as the timestamp of each event.
+
+ Returns OK on success, NOTOK if the trace file could not be read or
+         is not a trace file, or if the output file could not be written
+ ********************************************************************/
+
+int  gp_TraceDecode(char *traceFileName, char *outputFileName, int format)
+{
+FILE *infile, *outfile;
+traceFileHeader header;
+traceRec rec;
+unsigned long eventNum;
+int  i, depth = 0, Result = OK;
+
+     if (format != TRACEFORMAT_TEXT && format != TRACEFORMAT_JSON)
+         return NOTOK;
+
+     if ((infile = fopen(traceFileName, "rb")) == NULL)
+         return NOTOK;
+
+     if (fread(&header, sizeof(traceFileHeader), 1, infile) != 1 ||
+         header.magic != TRACE_MAGIC || header.version != TRACE_VERSION ||
+         header.numArgs != TRACE_MAXARGS || header.numRecords < 0)
+     {
+         fclose(infile);
+         return NOTOK;
+     }
+
+     if ((outfile = fopen(outputFileName, WRITETEXT)) == NULL)
+     {
+         fclose(infile);
+         return NOTOK;
+     }
+
+     if (format == TRACEFORMAT_JSON)
+         fprintf(outfile, "{\"traceEvents\":[\n");
+     else if (header.firstEvent > 0)
+         fprintf(outfile, "(%lu earlier events were overwritten)\n", header.firstEvent);
+
+     eventNum = header.firstEvent;
+     for (i = 0; i < header.numRecords; i++, eventNum++)
+     {
+         if (fread(&rec, sizeof(traceRec), 1, infile) != 1)
+         {
+             Result = NOTOK;
+             break;
+         }
+
+         if (rec.eventId <= 0 || rec.eventId >= TRACE_NUMEVENTS)
+             rec.eventId = 0;
+
+         if (format == TRACEFORMAT_JSON)
+             _TraceDecodeJSON(outfile, &rec, eventNum, i == 0);
+         else
+             _TraceDecodeText(outfile, &rec, eventNum, &depth);
+     }
+
+     if (format == TRACEFORMAT_JSON)
+         fprintf(outfile, "\n]}\n");
+
+     fclose(infile);
+     if (fclose(outfile) != 0)
+         Result = NOTOK;
+
+     return Result;
+}
+
+/********************************************************************
+ _TraceDecodeText()
+ Writes one line of text for the given trace event, indented by the
+ current nesting depth of BEGIN/END spans.
+ ********************************************************************/
+
+void _TraceDecodeText(FILE *outfile, traceRecP rec, unsigned long eventNum, int *pDepth)
+{
+traceEventInfo *info = &traceEvents[rec->eventId];
+int  i;
+
+     if (info->phase == 'E' && *pDepth > 0)
+         (*pDepth)--;
+
+     fprintf(outfile, "%lu:", eventNum);
+     for (i = 0; i < *pDepth; i++)
+         fprintf(outfile, "  ");
+
+     fprintf(outfile, " %s%s", info->name,
+             info->phase == 'B' ? " start" : (info->phase == 'E' ? " end" : ""));
+
+     for (i = 0; i < TRACE_MAXARGS && info->argNames[i] != NULL; i++)
+         fprintf(outfile, "%s%s=%d", i == 0 ? " " : ", ", info->argNames[i], rec->args[i]);
+
+     fprintf(outfile, "\n");
+
+     if (info->phase == 'B')
+         (*pDepth)++;
+}
+
+/********************************************************************
+ _TraceDecodeJSON()
+ Writes the given trace event as a Chrome trace event JSON object.
+ ********************************************************************/
+
+void _TraceDecodeJSON(FILE *outfile, traceRecP rec, unsigned long eventNum, int isFirst)
+{
+traceEventInfo *info = &traceEvents[rec->eventId];
+int  i;
+
+     fprintf(outfile, "%s{\"name\":\"%s\",\"ph\":\"%c\",\"ts\":%lu,\"pid\":1,\"tid\":1",
+             isFirst ? "" : ",\n", info->name, info->phase, eventNum);
+
+     if (info->phase == 'i')
+         fprintf(outfile, ",\"s\":\"t\"");
+
+     fprintf(outfile, ",\"args\":{");
+     for (i = 0; i < TRACE_MAXARGS && info->argNames[i] != NULL; i++)
+         fprintf(outfile, "%s\"%s\":%d", i == 0 ? "" : ",", info->argNames[i], rec->args[i]);
+     fprintf(outfile, "}}");
+}
@@ -0,0 +1,169 @@
+#ifndef GRAPH_TRACE_H
+#define GRAPH_TRACE_H
+
+/*
+Planarity-Related Graph Algorithms Project
+Copyright (c) 1997-2012, John M. Boyer
+All rights reserved. Includes a reference implementation of the following:
+
+* John M. Boyer. "Subgraph Homeomorphism via the Edge Addition Planarity Algorithm".
+  Journal of Graph Algorithms and Applications, Vol. 16, no. 2, pp. 381-410, 2012.
+  http://www.jgaa.info/16/268.html
+
+* John M. Boyer. "A New Method for Efficiently Generating Planar Graph
+  Visibility Representations". In P. Eades and P. Healy, editors,
+  Proceedings of the 13th International Conference on Graph Drawing 2005,
+  Lecture Notes Comput. Sci., Volume 3843, pp. 508-511, Springer-Verlag, 2006.
+
+* John M. Boyer and Wendy J. Myrvold. "On the Cutting Edge: Simplified O(n)
+  Planarity by Edge Addition". Journal of Graph Algorithms and Applications,
+  Vol. 8, No. 3, pp. 241-273, 2004.
+  http://www.jgaa.info/08/91.html
+
+* John M. Boyer. "Simplified O(n) Algorithms for Planar Graph Embedding,
+  Kuratowski Subgraph Isolation, and Related Problems". Ph.D. Dissertation,
+  University of Victoria, 2001.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+* Redistributions of source code must retain the above copyright notice, this
+  list of conditions and the following disclaimer.
+
+* Redistributions in binary form must reproduce the above copyright notice, this
+  list of conditions and the following disclaimer in the documentation and/or
+  other materials provided with the distribution.
+
+* Neither the name of the Planarity-Related Graph Algorithms Project nor the names
+  of its contributors may be used to endorse or promote products derived from this
+  software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/********************************************************************
+ Event tracing
+
+ A graph can record a trace of the events that occur while algorithms
+ run on it.  Tracing is off by default, in which case each trace point
+ costs only a test of the graph's trace pointer.  Calling
+ gp_TraceEnable() attaches a ring buffer of fixed-size binary records
+ to the graph.  Each trace point then stores an event identifier and
+ up to TRACE_MAXARGS integer arguments, with no formatting and no I/O.
+ If more events occur than the ring buffer can hold, the oldest events
+ are overwritten, so the buffer always holds the most recent history.
+
+ gp_TraceWrite() writes the buffered events to a binary trace file, and
+ gp_TraceDecode() converts a trace file offline into either readable
+ text or the Chrome trace event JSON format (viewable in a browser
+ trace viewer, with the BEGIN/END events shown as nested spans).
+ ********************************************************************/
+
+#define TRACE_MAXARGS   5
+
+typedef struct
+{
+    int eventId;
+    int args[TRACE_MAXARGS];
+} traceRec;
+
+typedef traceRec * traceRecP;
+
+typedef struct
+{
+    traceRecP records;
+    int capacity, next;
+    unsigned long numEvents;
+} traceBuffer;
+
+typedef traceBuffer * traceBufferP;
+
+#define TRACE_DEFAULT_CAPACITY  65536
+
+/* Trace event identifiers.  The event names and argument names used by
+   the decoder are in the traceEventInfo table in graphTrace.c, which
+   must be kept in the same order. */
+
+#define TRACE_CREATEDFSTREE_BEGIN           1
+#define TRACE_CREATEDFSTREE_END             2
+#define TRACE_DFS_VISIT                     3
+#define TRACE_SORTVERTICES_BEGIN            4
+#define TRACE_SORTVERTICES_END              5
+#define TRACE_LOWPOINT_BEGIN                6
+#define TRACE_LOWPOINT_END                  7
+#define TRACE_LEASTANCESTOR_BEGIN           8
+#define TRACE_LEASTANCESTOR_END             9
+#define TRACE_EMBEDDINGINITIALIZE_BEGIN     10
+#define TRACE_EMBEDDINGINITIALIZE_END       11
+#define TRACE_WALKDOWN_BEGIN                12
+#define TRACE_WALKDOWN_END                  13
+#define TRACE_EMBEDBACKEDGE                 14
+#define TRACE_INVERTVERTEX                  15
+#define TRACE_MERGEVERTEX                   16
+#define TRACE_BLOCKEDBICOMP                 17
+#define TRACE_EMBEDCOMPONENTS_BEGIN         18
+#define TRACE_EMBEDCOMPONENTS_END           19
+#define TRACE_EMBEDREDUCED_BEGIN            20
+#define TRACE_EMBEDREDUCED_END              21
+#define TRACE_COMPUTEEDGEPOSITIONS_BEGIN    22
+#define TRACE_COMPUTEEDGEPOSITIONS_END      23
+#define TRACE_DRAW_VERTEXPOSITION           24
+#define TRACE_DRAW_APPENDEDGE               25
+#define TRACE_DRAW_INSERTEDGE               26
+#define TRACE_DRAW_GENERATOREDGE            27
+#define TRACE_DRAW_EDGELISTENTRY            28
+#define TRACE_COLLECTDRAWINGDATA_BEGIN      29
+#define TRACE_COLLECTDRAWINGDATA_END        30
+#define TRACE_DRAW_TIE                      31
+#define TRACE_BREAKTIE_BEGIN                32
+#define TRACE_BREAKTIE_END                  33
+#define TRACE_DRAW_ANCESTOR                 34
+#define TRACE_DRAW_BETWEEN                  35
+#define TRACE_DRAW_BEYOND                   36
+#define TRACE_EMBEDBLOCKS_BEGIN             37
+#define TRACE_EMBEDBLOCKS_END               38
+#define TRACE_CREATESPQRTREE_BEGIN          39
+#define TRACE_CREATESPQRTREE_END            40
+
+#define TRACE_NUMEVENTS                     41
+
+/* Trace points.  Each macro is an expression that records an event
+   only if tracing has been enabled for the graph. */
+
+#define gp_Trace5(theGraph, eventId, one, two, three, four, five) \
+        ((theGraph)->trace == NULL ? (void) 0 : \
+         _Trace((theGraph)->trace, eventId, one, two, three, four, five))
+
+#define gp_Trace0(theGraph, eventId) gp_Trace5(theGraph, eventId, 0, 0, 0, 0, 0)
+#define gp_Trace1(theGraph, eventId, one) gp_Trace5(theGraph, eventId, one, 0, 0, 0, 0)
+#define gp_Trace2(theGraph, eventId, one, two) gp_Trace5(theGraph, eventId, one, two, 0, 0, 0)
+#define gp_Trace3(theGraph, eventId, one, two, three) gp_Trace5(theGraph, eventId, one, two, three, 0, 0)
+#define gp_Trace4(theGraph, eventId, one, two, three, four) gp_Trace5(theGraph, eventId, one, two, three, four, 0)
+
+void _Trace(traceBufferP theTrace, int eventId, int one, int two, int three, int four, int five);
+
+/* Output formats for gp_TraceDecode() */
+
+#define TRACEFORMAT_TEXT    1
+#define TRACEFORMAT_JSON    2
+
+int gp_TraceDecode(char *traceFileName, char *outputFileName, int format);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
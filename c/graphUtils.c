@@ -70,6 +70,10 @@ extern int  _CheckObstructionIntegrity(graphP theGraph, graphP origGraph);
 extern int  _ReadPostprocess(graphP theGraph, void *extraData, long extraDataSize);
 extern int  _WritePostprocess(graphP theGraph, void **pExtraData, long *pExtraDataSize);
 
+/* Imported functions */
+
+extern void _DeletePreprocessedBackEdge(graphP theGraph, int e);
+
 /* Internal util functions for FUNCTION POINTERS */
 
 int  _HideVertex(graphP theGraph, int vertex);
@@ -111,6 +115,11 @@ void _InitVertices(graphP theGraph);
 void _InitEdges(graphP theGraph);
 
 void _ClearGraph(graphP theGraph);
+int  _CopyBaseGraph(graphP dstGraph, graphP srcGraph);
+void _ReleasePreprocessCache(graphP theGraph);
+void _DeleteEdgeFromPreprocessCache(graphP theGraph, int e);
+int  _ShareArray(platform_memory *dstMem, platform_memory *srcMem);
+void _AdviseGraphMemory(graphP theGraph, int advice);
 
 int  _GetRandomNumber(int NMin, int NMax);
 
@@ -149,6 +158,15 @@ graphP theGraph = (graphP) malloc(sizeof(baseGraphStructure));
          theGraph->edgeHoles = NULL;
 
          theGraph->extensions = NULL;
+         memset(theGraph->extensionContexts, 0, sizeof(theGraph->extensionContexts));
+
+         theGraph->trace = NULL;
+         theGraph->preprocessCache = NULL;
+
+         platform_InitMemory(&theGraph->VMemory);
+         platform_InitMemory(&theGraph->VIMemory);
+         platform_InitMemory(&theGraph->EMemory);
+         platform_InitMemory(&theGraph->extFaceMemory);
 
          _InitFunctionTable(theGraph);
 
@@ -260,13 +278,13 @@ int  _InitGraph(graphP theGraph, int N)
      stackSize = stackSize < 6*N ? 6*N : stackSize;
 
      // Allocate memory as described above
-     if ((theGraph->V = (vertexRecP) calloc(Vsize, sizeof(vertexRec))) == NULL ||
-    	 (theGraph->VI = (vertexInfoP) calloc(VIsize, sizeof(vertexInfo))) == NULL ||
-    	 (theGraph->E = (edgeRecP) calloc(Esize, sizeof(edgeRec))) == NULL ||
+     if ((theGraph->V = (vertexRecP) platform_AllocMemory(&theGraph->VMemory, Vsize*sizeof(vertexRec))) == NULL ||
+    	 (theGraph->VI = (vertexInfoP) platform_AllocMemory(&theGraph->VIMemory, VIsize*sizeof(vertexInfo))) == NULL ||
+    	 (theGraph->E = (edgeRecP) platform_AllocMemory(&theGraph->EMemory, Esize*sizeof(edgeRec))) == NULL ||
          (theGraph->BicompRootLists = LCNew(VIsize)) == NULL ||
          (theGraph->sortedDFSChildLists = LCNew(VIsize)) == NULL ||
          (theGraph->theStack = sp_New(stackSize)) == NULL ||
-         (theGraph->extFace = (extFaceLinkRecP) calloc(Vsize, sizeof(extFaceLinkRec))) == NULL ||
+         (theGraph->extFace = (extFaceLinkRecP) platform_AllocMemory(&theGraph->extFaceMemory, Vsize*sizeof(extFaceLinkRec))) == NULL ||
          (theGraph->edgeHoles = sp_New(Esize / 2)) == NULL ||
          0)
      {
@@ -274,9 +292,13 @@ int  _InitGraph(graphP theGraph, int N)
          return NOTOK;
      }
 
-     // Initialize memory
+     // Initialize memory.  The arrays are allocated zero-filled, so if NIL
+     // is 0, then the vertices and edges are already initialized, and not
+     // writing them again leaves untouched any pages that are never used
+#if NIL != 0
      _InitVertices(theGraph);
      _InitEdges(theGraph);
+#endif
      _InitIsolatorContext(theGraph);
 
      return OK;
@@ -364,6 +386,8 @@ void gp_ReinitializeGraph(graphP theGraph)
 
 void _ReinitializeGraph(graphP theGraph)
 {
+     _ReleasePreprocessCache(theGraph);
+
      theGraph->M = 0;
      theGraph->internalFlags = theGraph->embedFlags = 0;
 
@@ -375,6 +399,8 @@ void _ReinitializeGraph(graphP theGraph)
      LCReset(theGraph->sortedDFSChildLists);
      sp_ClearStack(theGraph->theStack);
      sp_ClearStack(theGraph->edgeHoles);
+
+     _AdviseGraphMemory(theGraph, PLATFORM_ADVISE_NORMAL);
 }
 
 /********************************************************************
@@ -508,9 +534,9 @@ int e, Esize = gp_EdgeIndexBound(theGraph),
     theGraph->edgeHoles = newStack;
 
 	// Reallocate the edgeRec array to the new size,
-    theGraph->E = (edgeRecP) realloc(theGraph->E, newEsize*sizeof(edgeRec));
-    if (theGraph->E == NULL)
+    if (platform_ResizeMemory(&theGraph->EMemory, newEsize*sizeof(edgeRec)) == NULL)
     	return NOTOK;
+    theGraph->E = (edgeRecP) theGraph->EMemory.ptr;
 
     // Initialize the new edge records
     for (e = Esize; e < newEsize; e++)
@@ -873,21 +899,12 @@ int  stackBottom = sp_GetCurrentSize(theGraph->theStack);
 
 void _ClearGraph(graphP theGraph)
 {
-     if (theGraph->V != NULL)
-     {
-          free(theGraph->V);
-          theGraph->V = NULL;
-     }
-     if (theGraph->VI != NULL)
-     {
-          free(theGraph->VI);
-          theGraph->V = NULL;
-     }
-     if (theGraph->E != NULL)
-     {
-          free(theGraph->E);
-          theGraph->E = NULL;
-     }
+     platform_FreeMemory(&theGraph->VMemory);
+     theGraph->V = NULL;
+     platform_FreeMemory(&theGraph->VIMemory);
+     theGraph->VI = NULL;
+     platform_FreeMemory(&theGraph->EMemory);
+     theGraph->E = NULL;
 
      theGraph->N = 0;
      theGraph->NV = 0;
@@ -903,15 +920,16 @@ void _ClearGraph(graphP theGraph)
 
      sp_Free(&theGraph->theStack);
 
-     if (theGraph->extFace != NULL)
-     {
-         free(theGraph->extFace);
-         theGraph->extFace = NULL;
-     }
+     platform_FreeMemory(&theGraph->extFaceMemory);
+     theGraph->extFace = NULL;
 
      sp_Free(&theGraph->edgeHoles);
 
+     _ReleasePreprocessCache(theGraph);
+
      gp_FreeExtensions(theGraph);
+
+     gp_TraceDisable(theGraph);
 }
 
 /********************************************************************
@@ -956,6 +974,8 @@ int  gp_CopyAdjacencyLists(graphP dstGraph, graphP srcGraph)
     if (gp_EnsureArcCapacity(dstGraph, srcGraph->arcCapacity) != OK)
     	return NOTOK;
 
+    _ReleasePreprocessCache(dstGraph);
+
 	// Copy the links that hook each owning vertex to its adjacency list
     for (v = gp_GetFirstVertex(srcGraph); gp_VertexInRange(srcGraph, v); v++)
 	{
@@ -989,6 +1009,79 @@ int  gp_CopyAdjacencyLists(graphP dstGraph, graphP srcGraph)
  ********************************************************************/
 
 int  gp_CopyGraph(graphP dstGraph, graphP srcGraph)
+{
+     // Copy the vertices, edges and other members of the base graph
+     if (_CopyBaseGraph(dstGraph, srcGraph) != OK)
+    	 return NOTOK;
+
+     // Copy the set of extensions, which includes copying the
+     // extension data as well as the function overload tables
+     if (gp_CopyExtensions(dstGraph, srcGraph) != OK)
+    	 return NOTOK;
+
+     // Copy the graph's function table, which has the pointers to
+     // the most recent extension overloads of each function (or
+     // the original function pointer if a particular function has
+     // not been overloaded).
+     // This must be done after copying the extension because the
+     // first step of copying the extensions is to delete the
+     // dstGraph extensions, which clears its function table.
+     // Therefore, no good to assign the srcGraph functions *before*
+     // copying the extensions because the assignment would be wiped out
+     // This, in turn, means that the DupContext function of an extension
+     // *cannot* depend on any extension function overloads; the extension
+     // must directly invoke extension functions only.
+     dstGraph->functions = srcGraph->functions;
+
+     return OK;
+}
+
+/********************************************************************
+ _ShareArray()
+ If the source array is large enough to be mapped from a memory file
+ and has the same size as the destination array, then the destination
+ array is replaced by a copy-on-write snapshot of the source array.
+
+ Returns TRUE if the destination array now shares the content of the
+ source array, or FALSE if the caller must copy the content.
+ ********************************************************************/
+
+int  _ShareArray(platform_memory *dstMem, platform_memory *srcMem)
+{
+     if (srcMem->fd < 0 || dstMem->size != srcMem->size)
+         return FALSE;
+
+     return platform_SnapshotMemory(dstMem, srcMem) != NULL ? TRUE : FALSE;
+}
+
+/********************************************************************
+ _AdviseGraphMemory()
+ Tells the operating system how the vertex, edge and external face
+ arrays of theGraph are about to be accessed, using one of the
+ PLATFORM_ADVISE_* values.  This matters mainly for arrays kept in
+ files (see platform_SetMemoryFileDir()), e.g. the embedder accesses
+ the arrays randomly, so reading ahead in the files is wasted I/O.
+ ********************************************************************/
+
+void _AdviseGraphMemory(graphP theGraph, int advice)
+{
+     platform_AdviseMemory(&theGraph->VMemory, advice);
+     platform_AdviseMemory(&theGraph->VIMemory, advice);
+     platform_AdviseMemory(&theGraph->EMemory, advice);
+     platform_AdviseMemory(&theGraph->extFaceMemory, advice);
+}
+
+/********************************************************************
+ _CopyBaseGraph()
+ Copies the content of the srcGraph into the dstGraph, except for the
+ extensions and the function table.  The dstGraph must have been
+ previously initialized with the same number of vertices as srcGraph.
+ The dstGraph shares the preprocessing cache of the srcGraph, if any.
+
+ Returns OK for success, NOTOK for failure.
+ ********************************************************************/
+
+int  _CopyBaseGraph(graphP dstGraph, graphP srcGraph)
 {
 int  v, e, Esize;
 
@@ -1012,30 +1105,45 @@ int  v, e, Esize;
     	 return NOTOK;
      }
 
-     // Copy the primary vertices.  Augmentations to vertices created
+     // Copy the primary and virtual vertices.  Augmentations to vertices created
      // by extensions are copied below by gp_CopyExtensions()
-     for (v = gp_GetFirstVertex(srcGraph); gp_VertexInRange(srcGraph, v); v++)
+     if (_ShareArray(&dstGraph->VMemory, &srcGraph->VMemory))
+    	 dstGraph->V = (vertexRecP) dstGraph->VMemory.ptr;
+     else
      {
-    	 gp_CopyVertexRec(dstGraph, v, srcGraph, v);
-    	 gp_CopyVertexInfo(dstGraph, v, srcGraph, v);
-    	 gp_SetExtFaceVertex(dstGraph, v, 0, gp_GetExtFaceVertex(srcGraph, v, 0));
-    	 gp_SetExtFaceVertex(dstGraph, v, 1, gp_GetExtFaceVertex(srcGraph, v, 1));
+    	 for (v = gp_GetFirstVertex(srcGraph); gp_VirtualVertexInRange(srcGraph, v); v++)
+    		 gp_CopyVertexRec(dstGraph, v, srcGraph, v);
      }
 
-     // Copy the virtual vertices.  Augmentations to virtual vertices created
-     // by extensions are copied below by gp_CopyExtensions()
-     for (v = gp_GetFirstVirtualVertex(srcGraph); gp_VirtualVertexInRange(srcGraph, v); v++)
+     if (_ShareArray(&dstGraph->VIMemory, &srcGraph->VIMemory))
+    	 dstGraph->VI = (vertexInfoP) dstGraph->VIMemory.ptr;
+     else
      {
-    	 gp_CopyVertexRec(dstGraph, v, srcGraph, v);
-    	 gp_SetExtFaceVertex(dstGraph, v, 0, gp_GetExtFaceVertex(srcGraph, v, 0));
-    	 gp_SetExtFaceVertex(dstGraph, v, 1, gp_GetExtFaceVertex(srcGraph, v, 1));
+    	 for (v = gp_GetFirstVertex(srcGraph); gp_VertexInRange(srcGraph, v); v++)
+    		 gp_CopyVertexInfo(dstGraph, v, srcGraph, v);
+     }
+
+     if (_ShareArray(&dstGraph->extFaceMemory, &srcGraph->extFaceMemory))
+    	 dstGraph->extFace = (extFaceLinkRecP) dstGraph->extFaceMemory.ptr;
+     else
+     {
+    	 for (v = gp_GetFirstVertex(srcGraph); gp_VirtualVertexInRange(srcGraph, v); v++)
+    	 {
+    		 gp_SetExtFaceVertex(dstGraph, v, 0, gp_GetExtFaceVertex(srcGraph, v, 0));
+    		 gp_SetExtFaceVertex(dstGraph, v, 1, gp_GetExtFaceVertex(srcGraph, v, 1));
+    	 }
      }
 
      // Copy the basic EdgeRec structures.  Augmentations to the edgeRec structure
      // created by extensions are copied below by gp_CopyExtensions()
-     Esize = gp_EdgeIndexBound(srcGraph);
-     for (e = gp_GetFirstEdge(theGraph); e < Esize; e++)
-    	 gp_CopyEdgeRec(dstGraph, e, srcGraph, e);
+     if (_ShareArray(&dstGraph->EMemory, &srcGraph->EMemory))
+    	 dstGraph->E = (edgeRecP) dstGraph->EMemory.ptr;
+     else
+     {
+    	 Esize = gp_EdgeIndexBound(srcGraph);
+    	 for (e = gp_GetFirstEdge(theGraph); e < Esize; e++)
+    		 gp_CopyEdgeRec(dstGraph, e, srcGraph, e);
+     }
 
      // Give the dstGraph the same size and intrinsic properties
      dstGraph->N = srcGraph->N;
@@ -1051,26 +1159,93 @@ int  v, e, Esize;
      sp_Copy(dstGraph->theStack, srcGraph->theStack);
      sp_Copy(dstGraph->edgeHoles, srcGraph->edgeHoles);
 
-     // Copy the set of extensions, which includes copying the
-     // extension data as well as the function overload tables
-     if (gp_CopyExtensions(dstGraph, srcGraph) != OK)
+     if (dstGraph->preprocessCache != srcGraph->preprocessCache)
+     {
+         _ReleasePreprocessCache(dstGraph);
+         if ((dstGraph->preprocessCache = srcGraph->preprocessCache) != NULL)
+             dstGraph->preprocessCache->refCount++;
+     }
+
+     return OK;
+}
+
+/********************************************************************
+ _ReleasePreprocessCache()
+ Drops the reference of theGraph to its preprocessing cache, if any,
+ and frees the cache if no other graph shares it.  This is called by
+ every function that changes the vertices or edges of a graph, since
+ the cache no longer describes the graph after such a change.
+ ********************************************************************/
+
+void _ReleasePreprocessCache(graphP theGraph)
+{
+preprocessCacheP cache = theGraph->preprocessCache;
+
+     if (cache == NULL)
+         return;
+
+     theGraph->preprocessCache = NULL;
+     if (--cache->refCount == 0)
+     {
+         gp_Free(&cache->theGraph);
+         free(cache);
+     }
+}
+
+/********************************************************************
+ _DeleteEdgeFromPreprocessCache()
+ Called by gp_DeleteEdge() before the edge e is deleted from theGraph.
+ The cached graph has the same edge records as theGraph, so if e is a
+ back edge in the cached DFS tree, then the edge is deleted from the
+ cached graph as well and the cache remains valid.  Otherwise, or if
+ other graphs share the cache, the cache is released.
+ ********************************************************************/
+
+void _DeleteEdgeFromPreprocessCache(graphP theGraph, int e)
+{
+graphP cacheGraph = theGraph->preprocessCache->theGraph;
+int  edgeType = gp_GetEdgeType(cacheGraph, e);
+
+     if (theGraph->preprocessCache->refCount > 1 ||
+         (edgeType != EDGE_TYPE_BACK && edgeType != EDGE_TYPE_FORWARD))
+         _ReleasePreprocessCache(theGraph);
+
+     else
+         _DeletePreprocessedBackEdge(cacheGraph, edgeType == EDGE_TYPE_BACK ? e : gp_GetTwinArc(cacheGraph, e));
+}
+
+/********************************************************************
+ gp_CopyPreprocessedGraph()
+ Restores into the dstGraph a snapshot of the srcGraph that was taken
+ by preprocessing srcGraph with gp_PreprocessForEmbedding(), so that
+ the embedding algorithm attached to dstGraph can be run without
+ repeating the DFS, the sort and the lowpoint computation.  A single
+ preprocessed srcGraph can be shared by several graphs on which
+ different algorithms are to be run.
+
+ The dstGraph is reinitialized, which puts the data of its extensions
+ into their initial state, and then the vertices, edges and DFS data of
+ srcGraph are copied into dstGraph.  The extensions of dstGraph are
+ kept, whereas extensions of srcGraph are not copied.  This relies on
+ extensions not changing their initial data during the DFS and sort,
+ except by relabelling it.
+
+ Returns OK for success, NOTOK if the graphs are not the same order
+ or if srcGraph has not been preprocessed.
+ ********************************************************************/
+
+int  gp_CopyPreprocessedGraph(graphP dstGraph, graphP srcGraph)
+{
+     if (dstGraph == NULL || srcGraph == NULL)
     	 return NOTOK;
 
-     // Copy the graph's function table, which has the pointers to
-     // the most recent extension overloads of each function (or
-     // the original function pointer if a particular function has
-     // not been overloaded).
-     // This must be done after copying the extension because the
-     // first step of copying the extensions is to delete the
-     // dstGraph extensions, which clears its function table.
-     // Therefore, no good to assign the srcGraph functions *before*
-     // copying the extensions because the assignment would be wiped out
-     // This, in turn, means that the DupContext function of an extension
-     // *cannot* depend on any extension function overloads; the extension
-     // must directly invoke extension functions only.
-     dstGraph->functions = srcGraph->functions;
+     if (!(srcGraph->internalFlags & FLAGS_EMBEDPREPROCESSED) ||
+    	 !(srcGraph->internalFlags & FLAGS_SORTEDBYDFI))
+    	 return NOTOK;
 
-     return OK;
+     gp_ReinitializeGraph(dstGraph);
+
+     return _CopyBaseGraph(dstGraph, srcGraph);
 }
 
 /********************************************************************
@@ -1083,7 +1258,10 @@ graphP result;
 
      if ((result = gp_New()) == NULL) return NULL;
 
-     if (gp_InitGraph(result, theGraph->N) != OK ||
+     // Give the result the same arc capacity so that gp_CopyGraph() can
+     // share the edge array of theGraph rather than copying it
+     if (gp_EnsureArcCapacity(result, theGraph->arcCapacity) != OK ||
+         gp_InitGraph(result, theGraph->N) != OK ||
          gp_CopyGraph(result, theGraph) != OK)
      {
          gp_Free(&result);
@@ -1670,6 +1848,8 @@ int  upos, vpos;
      if (theGraph->M >= theGraph->arcCapacity/2)
          return NONEMBEDDABLE;
 
+     _ReleasePreprocessCache(theGraph);
+
      if (sp_NonEmpty(theGraph->edgeHoles))
      {
          sp_Pop(theGraph->edgeHoles, vpos);
@@ -1719,6 +1899,8 @@ int vertMax = gp_GetLastVirtualVertex(theGraph),
      if (theGraph->M >= theGraph->arcCapacity/2)
          return NONEMBEDDABLE;
 
+     _ReleasePreprocessCache(theGraph);
+
      if (sp_NonEmpty(theGraph->edgeHoles))
      {
          sp_Pop(theGraph->edgeHoles, vpos);
@@ -1739,6 +1921,89 @@ int vertMax = gp_GetLastVirtualVertex(theGraph),
      return OK;
 }
 
+/********************************************************************
+ gp_BuildFromEdgeArray()
+
+ Initializes theGraph with N vertices and adds the M edges (u[i], v[i])
+ in bulk, which is faster than M calls to gp_AddEdge().  theGraph must
+ either be new, from gp_New(), or already have N vertices and no edges.
+ The arc capacity is raised to 2*M if needed, once, before any edge is
+ added.
+
+ The edges are laid out in E in order of u[i] by a counting sort, so
+ the arcs of each vertex u to the v[i] of its edges are contiguous.
+ An arc and its twin must be adjacent in E, so the arcs of a vertex
+ from the edges in which it is v[i] are spread over the other vertices'
+ blocks.  Each adjacency list is then linked in a single pass over E,
+ in the order of the arcs in E, so traversing an adjacency list, as
+ the DFS does, reads the edge array forward.  Edges (u[i], v[i]) with
+ the same u[i] keep their relative order.
+
+ Returns OK on success, NOTOK if theGraph cannot be initialized or
+ any endpoint is not a vertex of theGraph.
+ ********************************************************************/
+
+int  gp_BuildFromEdgeArray(graphP theGraph, int N, const int *u, const int *v, int M)
+{
+int  *start, i, j, e, arc, EsizeOccupied;
+
+     if (theGraph == NULL || N <= 0 || M < 0 || (M > 0 && (u == NULL || v == NULL)))
+         return NOTOK;
+
+     if (theGraph->N == 0)
+     {
+         if ((M > DEFAULT_EDGE_LIMIT * N && gp_EnsureArcCapacity(theGraph, 2*M) != OK) ||
+             gp_InitGraph(theGraph, N) != OK)
+             return NOTOK;
+     }
+     else if (theGraph->N != N || theGraph->M != 0 || sp_NonEmpty(theGraph->edgeHoles) ||
+              (2*M > theGraph->arcCapacity && gp_EnsureArcCapacity(theGraph, 2*M) != OK))
+         return NOTOK;
+
+     for (i = 0; i < M; i++)
+     {
+         if (u[i] < gp_GetFirstVertex(theGraph) || u[i] > gp_GetLastVertex(theGraph) ||
+             v[i] < gp_GetFirstVertex(theGraph) || v[i] > gp_GetLastVertex(theGraph))
+             return NOTOK;
+     }
+
+     _ReleasePreprocessCache(theGraph);
+
+     // Count the edges of each u, then turn the counts into the starting
+     // edge position of each u, offset by one so that the vertex numbers
+     // of either origin can index the array
+     if ((start = (int *) calloc(N+2, sizeof(int))) == NULL)
+         return NOTOK;
+
+     for (i = 0; i < M; i++)
+         start[u[i] - gp_GetFirstVertex(theGraph) + 1]++;
+
+     for (j = 1; j <= N; j++)
+         start[j] += start[j-1];
+
+     // Place each edge at the next position for its u.  As in gp_AddEdge(),
+     // the even arc is in the adjacency list of v and its twin is in u's.
+     for (i = 0; i < M; i++)
+     {
+         e = gp_GetFirstEdge(theGraph) + 2 * start[u[i] - gp_GetFirstVertex(theGraph)]++;
+         gp_SetNeighbor(theGraph, e, u[i]);
+         gp_SetNeighbor(theGraph, gp_GetTwinArc(theGraph, e), v[i]);
+     }
+
+     free(start);
+
+     // Append each arc to the adjacency list of its vertex, in order of E
+     theGraph->M = M;
+     EsizeOccupied = gp_EdgeInUseIndexBound(theGraph);
+     for (arc = gp_GetFirstEdge(theGraph); arc < EsizeOccupied; arc++)
+     {
+         j = gp_GetNeighbor(theGraph, gp_GetTwinArc(theGraph, arc));
+         gp_AttachLastArc(theGraph, j, arc);
+     }
+
+     return OK;
+}
+
 /****************************************************************************
  gp_DeleteEdge()
 
@@ -1756,6 +2021,12 @@ int  gp_DeleteEdge(graphP theGraph, int e, int nextLink)
 	 // informs a calling loop of the next edge to be processed.
 	 int  nextArc = gp_GetAdjacentArc(theGraph, e, nextLink);
 
+	 // Deleting a DFS tree edge changes the DFS tree, so the preprocessing
+	 // cache is dropped.  Deleting any other edge leaves the DFS tree as it
+	 // was, so the cache is updated instead, unless other graphs share it.
+	 if (theGraph->preprocessCache != NULL)
+		 _DeleteEdgeFromPreprocessCache(theGraph, e);
+
 	 // Delete the edge records e and eTwin from their adjacency lists.
      gp_DetachArc(theGraph, e);
      gp_DetachArc(theGraph, gp_GetTwinArc(theGraph, e));
@@ -1827,6 +2098,7 @@ int nextArc = gp_GetNextArc(theGraph, arc),
 
 void gp_HideEdge(graphP theGraph, int e)
 {
+	_ReleasePreprocessCache(theGraph);
 	theGraph->functions.fpHideEdge(theGraph, e);
 }
 
@@ -1855,6 +2127,7 @@ void _HideEdge(graphP theGraph, int e)
 
 void gp_RestoreEdge(graphP theGraph, int e)
 {
+	_ReleasePreprocessCache(theGraph);
 	theGraph->functions.fpRestoreEdge(theGraph, e);
 }
 
@@ -1954,6 +2227,7 @@ int  gp_HideVertex(graphP theGraph, int vertex)
 	if (gp_IsNotVertex(vertex))
 		return NOTOK;
 
+	_ReleasePreprocessCache(theGraph);
 	return theGraph->functions.fpHideVertex(theGraph, vertex);
 }
 
@@ -1988,6 +2262,9 @@ int  _HideVertex(graphP theGraph, int vertex)
  Contracts the edge e=(u,v).  This hides the edge (both e and its
  twin arc), and it also identifies vertex v with u.
  See gp_IdentifyVertices() for further details.
+ The stack segment pushed is the same as for gp_IdentifyVertices(),
+ with e counted among the hidden edges, so gp_RestoreVertex() undoes
+ the contraction, including restoring e.
 
  Returns OK for success, NOTOK for internal failure.
  ********************************************************************/
@@ -1997,12 +2274,13 @@ int gp_ContractEdge(graphP theGraph, int e)
 	if (gp_IsNotArc(e))
 		return NOTOK;
 
+	_ReleasePreprocessCache(theGraph);
 	return theGraph->functions.fpContractEdge(theGraph, e);
 }
 
 int _ContractEdge(graphP theGraph, int e)
 {
-	int eBefore, u, v;
+	int eBefore, u, v, hiddenEdgesStackBottomIndex;
 
 	if (gp_IsNotArc(e))
 		return NOTOK;
@@ -2014,7 +2292,20 @@ int _ContractEdge(graphP theGraph, int e)
 	sp_Push(theGraph->theStack, e);
 	gp_HideEdge(theGraph, e);
 
-	return gp_IdentifyVertices(theGraph, u, v, eBefore);
+	if (gp_IdentifyVertices(theGraph, u, v, eBefore) != OK)
+		return NOTOK;
+
+	// The identification pushes K hidden edges, then an integer indicating
+	// where the top of stack was before the edges were hidden, then six more
+	// integers to indicate edges that were moved from v to u.  The hidden
+	// edge e was pushed just below the K hidden edges, so the "hidden edges
+	// stackBottom" must be decremented so that gp_RestoreVertex() also
+	// restores e, i.e. the number of hidden edges becomes K+1.
+	hiddenEdgesStackBottomIndex = sp_GetCurrentSize(theGraph->theStack)-7;
+	sp_Set(theGraph->theStack, hiddenEdgesStackBottomIndex,
+		   sp_Get(theGraph->theStack, hiddenEdgesStackBottomIndex) - 1);
+
+	return OK;
 }
 
 /********************************************************************
@@ -2054,6 +2345,7 @@ int _ContractEdge(graphP theGraph, int e)
 
 int gp_IdentifyVertices(graphP theGraph, int u, int v, int eBefore)
 {
+	_ReleasePreprocessCache(theGraph);
 	return theGraph->functions.fpIdentifyVertices(theGraph, u, v, eBefore);
 }
 
@@ -2063,29 +2355,10 @@ int _IdentifyVertices(graphP theGraph, int u, int v, int eBefore)
 	int hiddenEdgeStackBottom, eBeforePred;
 
 	// If the vertices are adjacent, then the identification is
-	// essentially an edge contraction with a bit of fixup.
+	// essentially an edge contraction, which hides the edge e=(u,v)
+	// then recursively calls this method.
 	if (gp_IsArc(e))
-	{
-		int result = gp_ContractEdge(theGraph, e);
-
-		// The edge contraction operation pushes one hidden edge then
-	    // recursively calls this method. This method then pushes K
-	    // hidden edges then an integer indicating where the top of
-	    // stack was before the edges were hidden. That integer
-	    // indicator must be decremented, thereby incrementing the
-		// number of hidden edges to K+1.
-		// After pushing the K hidden edges and the stackBottom of
-		// the hidden edges, the recursive call to this method pushes
-		// six more integers to indicate edges that were moved from
-		// v to u, so the "hidden edges stackBottom" is in the next
-		// position down.
-		int hiddenEdgesStackBottomIndex = sp_GetCurrentSize(theGraph->theStack)-7;
-		int hiddenEdgesStackBottomValue = sp_Get(theGraph->theStack, hiddenEdgesStackBottomIndex);
-
-		sp_Set(theGraph->theStack, hiddenEdgesStackBottomIndex,	hiddenEdgesStackBottomValue - 1);
-
-		return result;
-	}
+		return gp_ContractEdge(theGraph, e);
 
 	// Now, u and v are not adjacent. Before we do any edge hiding or
 	// moving, we record the current stack size, as this is the
@@ -2234,6 +2507,7 @@ int _IdentifyVertices(graphP theGraph, int u, int v, int eBefore)
 
 int gp_RestoreVertex(graphP theGraph)
 {
+	_ReleasePreprocessCache(theGraph);
 	return theGraph->functions.fpRestoreVertex(theGraph);
 }
 
@@ -2286,7 +2560,7 @@ int u, v, e_u_succ, e_u_pred, e_v_first, e_v_last, HESB, e;
 		if (gp_IsArc(e_v_first))
 			gp_SetPrevArc(theGraph, e_v_first, NIL);
 		if (gp_IsArc(e_v_last))
-			gp_SetPrevArc(theGraph, e_v_last, NIL);
+			gp_SetNextArc(theGraph, e_v_last, NIL);
 
 		// For each edge record restored to v's adjacency list, reassign the 'v' member
 		//    of each twin arc to indicate v rather than u.
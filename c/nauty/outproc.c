@@ -60,9 +60,28 @@ extern char quietMode;
 
 #include "outproc.h"
 #include "testFramework.h"
+#include "../graphK33Search.h"
+#include "../graphK5Search.h"
 #include "../graphColorVertices.h"
+#include "../graphSPQRTree.h"
 
 int runTest(FILE *, char);
+int runEmbedVariant(char command, testResultP testResult, graphP theGraph, graphP origGraph);
+int runOuterplanarVariant(char command, testResultP testResult, graphP theGraph, graphP origGraph);
+int runFindObstructions(testResultP testResult, graphP theGraph, graphP origGraph);
+int runBuildFromEdgeArray(testResultP testResult, graphP theGraph, graphP origGraph);
+int runCompactAndReorder(testResultP testResult, graphP theGraph, graphP origGraph);
+int runCachePreprocessing(testResultP testResult, graphP theGraph, graphP origGraph);
+int runSPQRTree(testResultP testResult, graphP theGraph, graphP origGraph);
+int runColorVerticesParallel(testResultP testResult, graphP theGraph, graphP origGraph);
+int runColorVerticesStrategies(testResultP testResult, graphP theGraph, graphP origGraph);
+int getDegeneracy(graphP theGraph);
+int checkSPQRTree(graphP theGraph, spqrTreeP theTree, char **pMsg);
+int checkSPQRNode(graphP theGraph, spqrTreeP theTree, int node, int *virtualCount, int *edgeCount, char **pMsg);
+int isConnectedWithout(int numVertices, int *vertices, int numEdges, int *u, int *v, int x, int y);
+
+extern int _TestSubgraph(graphP theSubgraph, graphP theGraph);
+extern int _CheckObstructionIntegrity(graphP theGraph, graphP origGraph);
 
 testResultFrameworkP testFramework = NULL;
 int errorFound = 0;
@@ -181,20 +200,15 @@ void outprocTest(FILE *f, graph *g, int n)
 
 	// gp_Write(testFramework->algResults[0].origGraph, "origGraph.txt", WRITE_ADJLIST);
 
+	// When all algorithms are tested, they share the DFS preprocessing of the graph
 	if (g_command == 'a')
 	{
-		int i, len;
-
-		for (i=1, len=strlen(commands); i < len; i++)
+		if (gp_CopyGraph(testFramework->preprocessedGraph, testFramework->algResults[0].origGraph) != OK ||
+			gp_PreprocessForEmbedding(testFramework->preprocessedGraph) != OK)
 		{
-			gp_ReinitializeGraph(testFramework->algResults[i].origGraph);
-			if (gp_CopyAdjacencyLists(testFramework->algResults[i].origGraph,
-					                  testFramework->algResults[0].origGraph) != OK)
-			{
-				fprintf(g_msgfile, "\nFailed to copy adjacency lists\n");
-				errorFound++;
-				return;
-			}
+			fprintf(g_msgfile, "\nFailed to preprocess the generated graph\n");
+			errorFound++;
+			return;
 		}
 	}
 
@@ -250,6 +264,11 @@ int runTest(FILE *outfile, char command)
 	testResultP testResult = tf_GetTestResult(testFramework, command);
 	graphP theGraph = testResult->theGraph;
 	graphP origGraph = testResult->origGraph;
+	graphP preprocessedGraph = testFramework->preprocessedGraph;
+
+	// When all algorithms are tested, they share the first origGraph
+	if (preprocessedGraph != NULL)
+		origGraph = testFramework->algResults[0].origGraph;
 
 	// Increment the main graph counter
 	if (++testResult->result.numGraphs == 0)
@@ -260,8 +279,20 @@ int runTest(FILE *outfile, char command)
 		return NOTOK;
 	}
 
-	// Now copy from the origGraph into theGraph on which the work will be done
-	if ((Result = gp_CopyGraph(theGraph, origGraph)) != OK)
+	// Now copy from the origGraph into theGraph on which the work will be done.
+	// If a preprocessed graph is shared by the algorithms, then the embedding
+	// algorithms copy it instead, and the other algorithms need only the edges
+	if (preprocessedGraph == NULL)
+		Result = gp_CopyGraph(theGraph, origGraph);
+	else if (strchr(commands, command) && command != 'c')
+		Result = gp_CopyPreprocessedGraph(theGraph, preprocessedGraph);
+	else
+	{
+		gp_ReinitializeGraph(theGraph);
+		Result = gp_CopyAdjacencyLists(theGraph, origGraph);
+	}
+
+	if (Result != OK)
 	{
 		fprintf(g_msgfile, "\nFailed to copy graph #%lu\n", testResult->result.numGraphs);
 		errorFound++;
@@ -287,7 +318,15 @@ int runTest(FILE *outfile, char command)
 			}
 		}
 	}
-	else if (strchr(commands, command))
+	else if (strchr(embedVariantCommands, command))
+		Result = runEmbedVariant(command, testResult, theGraph, origGraph);
+	else if (command == 'g')
+		Result = runSPQRTree(testResult, theGraph, origGraph);
+	else if (command == 'v')
+		Result = runColorVerticesParallel(testResult, theGraph, origGraph);
+	else if (command == 'w')
+		Result = runColorVerticesStrategies(testResult, theGraph, origGraph);
+	else if (strchr(commands, command) || strchr(unittestCommands, command))
 	{
 		int embedFlags = EMBEDFLAGS_PLANAR;
 
@@ -295,10 +334,14 @@ int runTest(FILE *outfile, char command)
 		{
 			case 'p' : embedFlags = EMBEDFLAGS_PLANAR; break;
 			case 'd' : embedFlags = EMBEDFLAGS_DRAWPLANAR; break;
+			case 'l' : embedFlags = EMBEDFLAGS_DRAWSTRAIGHTLINE; break;
 			case 'o' : embedFlags = EMBEDFLAGS_OUTERPLANAR; break;
 			case '2' : embedFlags = EMBEDFLAGS_SEARCHFORK23; break;
 			case '3' : embedFlags = EMBEDFLAGS_SEARCHFORK33; break;
 			case '4' : embedFlags = EMBEDFLAGS_SEARCHFORK4; break;
+			case '5' : embedFlags = EMBEDFLAGS_SEARCHFORK5; break;
+			case 'j' : embedFlags = EMBEDFLAGS_PROJECTIVEPLANAR; break;
+			case 't' : embedFlags = EMBEDFLAGS_TOROIDAL; break;
 		}
 
 		Result = gp_Embed(theGraph, embedFlags);
@@ -328,6 +371,10 @@ int runTest(FILE *outfile, char command)
 		;
 	else
 	{
+		// The counts must be definitive, so an undecided K5 search is a failure
+		if (command == '5' && Result == K5SEARCH_LIMITREACHED)
+			fprintf(g_msgfile, "\nK5 search branch limit reached on graph #%lu.\n", testResult->result.numGraphs);
+
 		errorFound++;
 		fprintf(g_msgfile, "\nFailed to runTest() on graph #%lu.\n", testResult->result.numGraphs);
 		// If the command-line shunts the output to a file, then we ensure that the file also
@@ -340,21 +387,842 @@ int runTest(FILE *outfile, char command)
 }
 
 /***********************************************************************
+ runEmbedVariant()
+
+ Runs one of the alternative entry points into the planarity embedder
+ on theGraph, which holds a copy of origGraph, and runs gp_Embed() on
+ another copy in the refGraph of the testResult.  The result must pass
+ the integrity check, and it must equal the result of gp_Embed().
+
+ For gp_EmbedK33(), both graphs have the K3,3 search attached, and
+ gp_Embed() searches for K3,3.  As the embedder of gp_EmbedK33() only
+ has its hooks bound at compile time, it must also isolate the same
+ K3,3 homeomorph as gp_Embed().
+ ***********************************************************************/
+
+int runEmbedVariant(char command, testResultP testResult, graphP theGraph, graphP origGraph)
+{
+	graphP refGraph = testResult->refGraph;
+	int embedFlags = command == 'y' ? EMBEDFLAGS_SEARCHFORK33 : EMBEDFLAGS_PLANAR;
+	int Result, refResult;
+
+	if (gp_CopyGraph(refGraph, origGraph) != OK)
+		return NOTOK;
+
+	refResult = gp_Embed(refGraph, embedFlags);
+
+	switch (command)
+	{
+		case 'm' : Result = gp_EmbedComponents(theGraph, EMBEDFLAGS_PLANAR, 2); break;
+		case 'e' : Result = gp_EmbedReduced(theGraph, EMBEDFLAGS_PLANAR); break;
+		case 'f' : Result = runFindObstructions(testResult, theGraph, origGraph); break;
+		case 'u' : Result = runBuildFromEdgeArray(testResult, theGraph, origGraph); break;
+		case 'n' : Result = runCompactAndReorder(testResult, theGraph, origGraph); break;
+		case 'k' : Result = runCachePreprocessing(testResult, theGraph, origGraph); break;
+		case 'b' : Result = gp_EmbedBlocks(theGraph, EMBEDFLAGS_PLANAR, 2); break;
+		case 'y' : Result = gp_EmbedK33(theGraph); break;
+		default  : Result = NOTOK; break;
+	}
+
+	// gp_FindObstructions() leaves theGraph unchanged, and its obstructions
+	// have already been checked, and the vertices of a reordered graph are
+	// numbered differently from origGraph, so it has already been checked
+	if ((Result == OK || Result == NONEMBEDDABLE) && command != 'f' && command != 'n')
+	{
+		gp_SortVertices(theGraph);
+
+		if (gp_TestEmbedResultIntegrity(theGraph, origGraph, Result) != Result)
+		{
+			fprintf(g_msgfile, "\nIntegrity check failed on graph #%lu.\n", testResult->result.numGraphs);
+			Result = NOTOK;
+		}
+	}
+
+	if ((Result == OK || Result == NONEMBEDDABLE) && Result != refResult)
+	{
+		fprintf(g_msgfile, "\nResult differs from gp_Embed() on graph #%lu.\n", testResult->result.numGraphs);
+		Result = NOTOK;
+	}
+
+	if (Result == NONEMBEDDABLE && command == 'y')
+	{
+		gp_SortVertices(refGraph);
+
+		if (_TestSubgraph(theGraph, refGraph) != TRUE || _TestSubgraph(refGraph, theGraph) != TRUE)
+		{
+			fprintf(g_msgfile, "\nK3,3 differs from gp_Embed() on graph #%lu.\n", testResult->result.numGraphs);
+			Result = NOTOK;
+		}
+	}
+
+	// The result counted is the planarity result, but the entry points
+	// that also accept outerplanarity are tested with it as well
+	if ((Result == OK || Result == NONEMBEDDABLE) && (command == 'm' || command == 'b'))
+	{
+		if (runOuterplanarVariant(command, testResult, theGraph, origGraph) != OK)
+			Result = NOTOK;
+	}
+
+	return Result;
+}
+
+/***********************************************************************
+ runOuterplanarVariant()
+
+ Repeats the test of runEmbedVariant() with EMBEDFLAGS_OUTERPLANAR,
+ using theGraph and the refGraph of the testResult for new copies of
+ origGraph.  Returns OK if the result passes the integrity check and
+ equals the result of gp_Embed(), or NOTOK otherwise.
  ***********************************************************************/
 
-int getCommandIndex(char command)
+int runOuterplanarVariant(char command, testResultP testResult, graphP theGraph, graphP origGraph)
 {
+	graphP refGraph = testResult->refGraph;
+	int Result, refResult;
+
+	if (gp_CopyGraph(refGraph, origGraph) != OK || gp_CopyGraph(theGraph, origGraph) != OK)
+		return NOTOK;
+
+	refResult = gp_Embed(refGraph, EMBEDFLAGS_OUTERPLANAR);
+
 	switch (command)
 	{
-		case 'p' : return 0;
-		case 'd' : return 1;
-		case 'o' : return 2;
-		case '2' : return 3;
-		case '3' : return 4;
-		case '4' : return 5;
-		case 'c' : return 6;
+		case 'm' : Result = gp_EmbedComponents(theGraph, EMBEDFLAGS_OUTERPLANAR, 2); break;
+		case 'b' : Result = gp_EmbedBlocks(theGraph, EMBEDFLAGS_OUTERPLANAR, 2); break;
+		default  : Result = NOTOK; break;
+	}
+
+	if (Result == OK || Result == NONEMBEDDABLE)
+	{
+		gp_SortVertices(theGraph);
+
+		if (gp_TestEmbedResultIntegrity(theGraph, origGraph, Result) != Result)
+		{
+			fprintf(g_msgfile, "\nOuterplanar integrity check failed on graph #%lu.\n", testResult->result.numGraphs);
+			return NOTOK;
+		}
+	}
+
+	if (Result != refResult)
+	{
+		fprintf(g_msgfile, "\nOuterplanar result differs from gp_Embed() on graph #%lu.\n", testResult->result.numGraphs);
+		return NOTOK;
+	}
+
+	return OK;
+}
+
+/***********************************************************************
+ runFindObstructions()
+
+ Finds up to three Kuratowski subgraphs of theGraph, alternating between
+ distinct and edge-disjoint obstructions from one graph to the next.
+ Each obstruction must be a Kuratowski subgraph of origGraph, and must
+ differ from, or be edge-disjoint from, each one found before it, and
+ theGraph must be unchanged.
+
+ Returns NONEMBEDDABLE if an obstruction was found, OK if not, or NOTOK
+ if gp_FindObstructions() failed or a check did not pass.
+ ***********************************************************************/
+
+#define NUMOBSTRUCTIONSTOFIND 3
+
+int runFindObstructions(testResultP testResult, graphP theGraph, graphP origGraph)
+{
+	graphP obstructions[NUMOBSTRUCTIONSTOFIND];
+	int findFlags = testResult->result.numGraphs % 2 ? FINDOBSTRUCTIONS_EDGEDISJOINT
+	                                                 : FINDOBSTRUCTIONS_DISTINCT;
+	int numFound, i, j, e, Result;
+
+	if (gp_FindObstructions(theGraph, EMBEDFLAGS_PLANAR, findFlags, NUMOBSTRUCTIONSTOFIND,
+	                        obstructions, &numFound) != OK)
+		return NOTOK;
+
+	Result = numFound > 0 ? NONEMBEDDABLE : OK;
+
+	if (theGraph->M != origGraph->M || _TestSubgraph(origGraph, theGraph) != TRUE)
+	{
+		fprintf(g_msgfile, "\nGraph changed by gp_FindObstructions() on graph #%lu.\n", testResult->result.numGraphs);
+		Result = NOTOK;
+	}
+
+	for (i = 0; i < numFound && Result != NOTOK; i++)
+	{
+		obstructions[i]->embedFlags = EMBEDFLAGS_PLANAR;
+		if (_CheckObstructionIntegrity(obstructions[i], origGraph) != OK)
+		{
+			fprintf(g_msgfile, "\nObstruction %d failed integrity check on graph #%lu.\n", i+1, testResult->result.numGraphs);
+			Result = NOTOK;
+		}
+
+		for (j = 0; j < i && Result != NOTOK; j++)
+		{
+			if (findFlags == FINDOBSTRUCTIONS_DISTINCT)
+			{
+				if (obstructions[i]->M == obstructions[j]->M &&
+					_TestSubgraph(obstructions[i], obstructions[j]) == TRUE)
+					Result = NOTOK;
+			}
+			else
+			{
+				for (e = gp_GetFirstEdge(obstructions[i]); e < gp_EdgeInUseIndexBound(obstructions[i]); e += 2)
+				{
+					if (gp_EdgeInUse(obstructions[i], e) &&
+						gp_IsNeighbor(obstructions[j], gp_GetNeighbor(obstructions[i], e),
+						                               gp_GetNeighbor(obstructions[i], gp_GetTwinArc(obstructions[i], e))))
+						Result = NOTOK;
+				}
+			}
+
+			if (Result == NOTOK)
+				fprintf(g_msgfile, "\nObstructions %d and %d not %s on graph #%lu.\n", j+1, i+1,
+						findFlags == FINDOBSTRUCTIONS_DISTINCT ? "distinct" : "edge-disjoint",
+						testResult->result.numGraphs);
+		}
+	}
+
+	for (i = 0; i < numFound; i++)
+		gp_Free(&obstructions[i]);
+
+	return Result;
+}
+
+/***********************************************************************
+ runBuildFromEdgeArray()
+
+ Rebuilds theGraph from the edge arrays of origGraph, checks that it has
+ the same edges, and embeds it.  Every other graph lists the edges in
+ reverse order with their endpoints swapped, so that both the counting
+ sort by first endpoint and the placement of the twin arcs are tested.
+
+ Returns the result of gp_Embed(), or NOTOK if the rebuild failed.
+ ***********************************************************************/
+
+int runBuildFromEdgeArray(testResultP testResult, graphP theGraph, graphP origGraph)
+{
+	int u[MAXN*(MAXN-1)/2], v[MAXN*(MAXN-1)/2];
+	int reverse = testResult->result.numGraphs % 2;
+	int M = 0, e, EsizeOccupied = gp_EdgeInUseIndexBound(origGraph);
+
+	for (e = gp_GetFirstEdge(origGraph); e < EsizeOccupied && M < origGraph->M; e += 2)
+	{
+		if (gp_EdgeInUse(origGraph, e))
+		{
+			int i = reverse ? origGraph->M - 1 - M : M;
+			u[i] = gp_GetNeighbor(origGraph, reverse ? e : gp_GetTwinArc(origGraph, e));
+			v[i] = gp_GetNeighbor(origGraph, reverse ? gp_GetTwinArc(origGraph, e) : e);
+			M++;
+		}
+	}
+
+	gp_ReinitializeGraph(theGraph);
+
+	if (M != origGraph->M || gp_BuildFromEdgeArray(theGraph, origGraph->N, u, v, M) != OK)
+		return NOTOK;
+
+	if (theGraph->M != origGraph->M ||
+		_TestSubgraph(theGraph, origGraph) != TRUE || _TestSubgraph(origGraph, theGraph) != TRUE)
+	{
+		fprintf(g_msgfile, "\nEdges differ after gp_BuildFromEdgeArray() on graph #%lu.\n", testResult->result.numGraphs);
+		return NOTOK;
+	}
+
+	return gp_Embed(theGraph, EMBEDFLAGS_PLANAR);
+}
+
+/***********************************************************************
+ runCompactAndReorder()
+
+ Renumbers the vertices of theGraph with gp_CompactAndReorder(), cycling
+ through the BFS, DFS and RCM orders from one graph to the next.  The
+ original vertex numbers it returns must be a permutation that maps the
+ edges of theGraph onto those of origGraph.  Then theGraph is embedded,
+ and the result is checked against a copy of the reordered graph, which
+ is kept in the refGraph of the testResult once runEmbedVariant() has
+ taken the gp_Embed() result from it.
+
+ Returns the result of gp_Embed(), or NOTOK if the reorder or a check
+ failed.
+ ***********************************************************************/
+
+int runCompactAndReorder(testResultP testResult, graphP theGraph, graphP origGraph)
+{
+	int originalIds[MAXN+1], isMapped[MAXN+1];
+	int orderType = (int) (testResult->result.numGraphs % 3) + REORDER_BFS;
+	int v, e, Result;
+
+	if (gp_CompactAndReorder(theGraph, orderType, originalIds) != OK)
+		return NOTOK;
+
+	Result = theGraph->N == origGraph->N && theGraph->M == origGraph->M ? OK : NOTOK;
+
+	memset(isMapped, 0, sizeof(isMapped));
+	for (v = gp_GetFirstVertex(theGraph); gp_VertexInRange(theGraph, v) && Result == OK; v++)
+	{
+		if (!gp_VertexInRange(origGraph, originalIds[v]) || isMapped[originalIds[v]])
+			Result = NOTOK;
+		else
+			isMapped[originalIds[v]] = TRUE;
+	}
+
+	for (e = gp_GetFirstEdge(theGraph); e < gp_EdgeInUseIndexBound(theGraph) && Result == OK; e += 2)
+	{
+		if (!gp_EdgeInUse(theGraph, e) ||
+			!gp_IsNeighbor(origGraph, originalIds[gp_GetNeighbor(theGraph, e)],
+			                          originalIds[gp_GetNeighbor(theGraph, gp_GetTwinArc(theGraph, e))]))
+			Result = NOTOK;
+	}
+
+	if (Result != OK)
+	{
+		fprintf(g_msgfile, "\nEdges differ after gp_CompactAndReorder() on graph #%lu.\n", testResult->result.numGraphs);
+		return NOTOK;
+	}
+
+	if (gp_CopyGraph(testResult->refGraph, theGraph) != OK)
+		return NOTOK;
+
+	Result = gp_Embed(theGraph, EMBEDFLAGS_PLANAR);
+
+	if (Result == OK || Result == NONEMBEDDABLE)
+	{
+		gp_SortVertices(theGraph);
+
+		if (gp_TestEmbedResultIntegrity(theGraph, testResult->refGraph, Result) != Result)
+		{
+			fprintf(g_msgfile, "\nIntegrity check failed on graph #%lu.\n", testResult->result.numGraphs);
+			Result = NOTOK;
+		}
+	}
+
+	return Result;
+}
+
+/***********************************************************************
+ runCachePreprocessing()
+
+ Caches the preprocessing of theGraph with gp_CachePreprocessing(), then
+ copies theGraph into the refGraph of the testResult, which runEmbedVariant()
+ is done with, so that the copy shares the cache.  The copy is embedded
+ first, and its result must pass the integrity check.  Then theGraph is
+ embedded from the same cache, which the first embedding must have left
+ intact, and it must get the same result.
+
+ Returns the result of embedding theGraph, or NOTOK if the cache could
+ not be made or a check failed.
+ ***********************************************************************/
+
+int runCachePreprocessing(testResultP testResult, graphP theGraph, graphP origGraph)
+{
+	graphP copyGraph = testResult->refGraph;
+	int Result, copyResult;
+
+	if (gp_CachePreprocessing(theGraph) != OK || gp_CopyGraph(copyGraph, theGraph) != OK)
+		return NOTOK;
+
+	if (theGraph->preprocessCache == NULL || copyGraph->preprocessCache != theGraph->preprocessCache)
+	{
+		fprintf(g_msgfile, "\nCache not shared by graph copy on graph #%lu.\n", testResult->result.numGraphs);
+		return NOTOK;
+	}
+
+	copyResult = gp_Embed(copyGraph, EMBEDFLAGS_PLANAR);
+
+	if (copyResult == OK || copyResult == NONEMBEDDABLE)
+	{
+		gp_SortVertices(copyGraph);
+
+		if (gp_TestEmbedResultIntegrity(copyGraph, origGraph, copyResult) != copyResult)
+		{
+			fprintf(g_msgfile, "\nIntegrity check failed on copy of graph #%lu.\n", testResult->result.numGraphs);
+			return NOTOK;
+		}
+	}
+	else return NOTOK;
+
+	Result = gp_Embed(theGraph, EMBEDFLAGS_PLANAR);
+
+	if ((Result == OK || Result == NONEMBEDDABLE) && Result != copyResult)
+	{
+		fprintf(g_msgfile, "\nResult differs between graph and its copy on graph #%lu.\n", testResult->result.numGraphs);
+		Result = NOTOK;
+	}
+
+	return Result;
+}
+
+/***********************************************************************
+ runColorVerticesParallel()
+
+ Colors theGraph with gp_ColorVerticesParallel() using two threads, so
+ the removal rounds and the coloring of each round are split between
+ them, and checks the coloring with gp_ColorVerticesIntegrityCheck().
+ Every planar graph must be colored with at most five colors, so the
+ planarity of a copy of origGraph in the refGraph of the testResult is
+ found with gp_Embed() to check the bound.
+
+ Returns OK if at most five colors are used, NONEMBEDDABLE if more are
+ used by a nonplanar graph, or NOTOK if a check did not pass.
+ ***********************************************************************/
+
+int runColorVerticesParallel(testResultP testResult, graphP theGraph, graphP origGraph)
+{
+	graphP refGraph = testResult->refGraph;
+	int Result, planarResult;
+
+	if (gp_CopyGraph(refGraph, origGraph) != OK)
+		return NOTOK;
+
+	if ((planarResult = gp_Embed(refGraph, EMBEDFLAGS_PLANAR)) != OK && planarResult != NONEMBEDDABLE)
+		return NOTOK;
+
+	if (gp_ColorVerticesParallel(theGraph, 2) != OK)
+		return NOTOK;
+
+	if (gp_ColorVerticesIntegrityCheck(theGraph, origGraph) != OK)
+	{
+		fprintf(g_msgfile, "\nIntegrity check failed on graph #%lu.\n", testResult->result.numGraphs);
+		return NOTOK;
+	}
+
+	Result = gp_GetNumColorsUsed(theGraph) >= 6 ? NONEMBEDDABLE : OK;
+
+	if (Result == NONEMBEDDABLE && planarResult == OK)
+	{
+		fprintf(g_msgfile, "\nPlanar graph #%lu used more than five colors.\n", testResult->result.numGraphs);
+		return NOTOK;
+	}
+
+	return Result;
+}
+
+/***********************************************************************
+ runColorVerticesStrategies()
+
+ Colors a copy of origGraph in theGraph with each strategy of
+ gp_ColorVerticesStrategy(), with and without the local search and with
+ no time limit, and checks each coloring with
+ gp_ColorVerticesIntegrityCheck().  The number of colors must also meet
+ the bound of the strategy:
+   - the reduction uses at most five colors on a planar graph,
+   - smallest-last uses at most one more than the degeneracy, and
+   - DSATUR uses at most one more than the maximum degree,
+ and the local search must not use more colors than the strategy alone.
+
+ Returns OK if some strategy uses at most five colors, NONEMBEDDABLE if
+ all use more, or NOTOK if a check did not pass.
+ ***********************************************************************/
+
+#define NUMCOLORSTRATEGIES 3
+
+int runColorVerticesStrategies(testResultP testResult, graphP theGraph, graphP origGraph)
+{
+	int strategies[NUMCOLORSTRATEGIES] = {
+			COLORVERTICES_STRATEGY_REDUCTION,
+			COLORVERTICES_STRATEGY_SMALLESTLAST,
+			COLORVERTICES_STRATEGY_DSATUR
+	};
+	graphP refGraph = testResult->refGraph;
+	int planarResult, degeneracy, maxDegree, bound, numColors, baseColors, leastColors;
+	int i, j, v;
+
+	if (gp_CopyGraph(refGraph, origGraph) != OK)
+		return NOTOK;
+
+	if ((planarResult = gp_Embed(refGraph, EMBEDFLAGS_PLANAR)) != OK && planarResult != NONEMBEDDABLE)
+		return NOTOK;
+
+	degeneracy = getDegeneracy(origGraph);
+
+	maxDegree = 0;
+	for (v = gp_GetFirstVertex(origGraph); gp_VertexInRange(origGraph, v); v++)
+		if (maxDegree < gp_GetVertexDegree(origGraph, v))
+			maxDegree = gp_GetVertexDegree(origGraph, v);
+
+	leastColors = origGraph->N + 1;
+	for (i = 0; i < NUMCOLORSTRATEGIES; i++)
+	{
+		switch (strategies[i])
+		{
+			case COLORVERTICES_STRATEGY_REDUCTION    : bound = planarResult == OK ? 5 : origGraph->N; break;
+			case COLORVERTICES_STRATEGY_SMALLESTLAST : bound = degeneracy + 1; break;
+			default                                  : bound = maxDegree + 1; break;
+		}
+
+		baseColors = 0;
+		for (j = 0; j < 2; j++)
+		{
+			int strategy = strategies[i] | (j == 0 ? 0 : COLORVERTICES_LOCALSEARCH);
+
+			if (gp_CopyGraph(theGraph, origGraph) != OK ||
+				gp_ColorVerticesStrategy(theGraph, strategy, 0) != OK)
+				return NOTOK;
+
+			if (gp_ColorVerticesIntegrityCheck(theGraph, origGraph) != OK)
+			{
+				fprintf(g_msgfile, "\nIntegrity check of strategy %d failed on graph #%lu.\n", strategy, testResult->result.numGraphs);
+				return NOTOK;
+			}
+
+			numColors = gp_GetNumColorsUsed(theGraph);
+			if (numColors > (j == 0 ? bound : baseColors))
+			{
+				fprintf(g_msgfile, "\nStrategy %d used %d colors on graph #%lu.\n", strategy, numColors, testResult->result.numGraphs);
+				return NOTOK;
+			}
+
+			if (j == 0)
+				baseColors = numColors;
+			if (leastColors > numColors)
+				leastColors = numColors;
+		}
+	}
+
+	return leastColors >= 6 ? NONEMBEDDABLE : OK;
+}
+
+/***********************************************************************
+ getDegeneracy()
+
+ Returns the least d such that every subgraph of theGraph has a vertex
+ of degree at most d, by repeatedly removing a vertex of minimum degree.
+ theGraph must have at most MAXN vertices.
+ ***********************************************************************/
+
+int getDegeneracy(graphP theGraph)
+{
+	int degree[MAXN+1], isRemoved[MAXN+1];
+	int degeneracy = 0, i, v, minv, e;
+
+	for (v = gp_GetFirstVertex(theGraph); gp_VertexInRange(theGraph, v); v++)
+	{
+		degree[v] = gp_GetVertexDegree(theGraph, v);
+		isRemoved[v] = FALSE;
+	}
+
+	for (i = 0; i < theGraph->N; i++)
+	{
+		minv = NIL;
+		for (v = gp_GetFirstVertex(theGraph); gp_VertexInRange(theGraph, v); v++)
+			if (!isRemoved[v] && (minv == NIL || degree[v] < degree[minv]))
+				minv = v;
+
+		if (degeneracy < degree[minv])
+			degeneracy = degree[minv];
+
+		isRemoved[minv] = TRUE;
+		e = gp_GetFirstArc(theGraph, minv);
+		while (gp_IsArc(e))
+		{
+			degree[gp_GetNeighbor(theGraph, e)]--;
+			e = gp_GetNextArc(theGraph, e);
+		}
+	}
+
+	return degeneracy;
+}
+
+/***********************************************************************
+ runSPQRTree()
+
+ Creates the SPQR trees of the blocks of theGraph and validates them
+ with checkSPQRTree().  theGraph must be unchanged by gp_CreateSPQRTree().
+
+ Returns NONEMBEDDABLE if any node is an R-node, i.e. if theGraph has a
+ triconnected component with more than three vertices, OK if not, or
+ NOTOK if the tree could not be created or a check did not pass.  A graph
+ has no R-node exactly when it is series-parallel, i.e. has no K_4 minor,
+ so the count of graphs with an R-node must equal the count of -4.
+ ***********************************************************************/
+
+int runSPQRTree(testResultP testResult, graphP theGraph, graphP origGraph)
+{
+	spqrTreeP theTree = NULL;
+	char *msg = NULL;
+	int i, Result;
+
+	if (gp_CreateSPQRTree(theGraph, &theTree) != OK)
+		return NOTOK;
+
+	Result = checkSPQRTree(theGraph, theTree, &msg);
+
+	if (Result == OK && (theGraph->M != origGraph->M || _TestSubgraph(origGraph, theGraph) != TRUE))
+	{
+		msg = "graph changed";
+		Result = NOTOK;
+	}
+
+	for (i = 0; i < theTree->numNodes && Result == OK; i++)
+		if (theTree->nodeType[i] == SPQR_RNODE)
+			Result = NONEMBEDDABLE;
+
+	if (Result == NOTOK)
+		fprintf(g_msgfile, "\nSPQR tree check failed on graph #%lu: %s.\n", testResult->result.numGraphs, msg);
+
+	gp_FreeSPQRTree(&theTree);
+	return Result;
+}
+
+/***********************************************************************
+ checkSPQRTree()
+
+ Checks the skeleton of each node with checkSPQRNode(), then checks that
+ each real edge of theGraph other than a self-loop is in exactly one
+ skeleton, and that each virtual edge is in the skeletons of exactly the
+ two nodes it joins, which are distinct nodes of the same block and not
+ both S-nodes or both P-nodes.  Finally, the nodes joined by the virtual
+ edges must form no cycle, and there must be exactly one fewer virtual
+ edge than nodes in each block, so the nodes of each block form a tree.
+
+ Returns OK if the tree is valid, or NOTOK with the failed check in *pMsg.
+ ***********************************************************************/
+
+int checkSPQRTree(graphP theGraph, spqrTreeP theTree, char **pMsg)
+{
+	int *virtualCount, *edgeCount, *set, *blockNodes;
+	int i, k, a, b, e, Result = OK;
+
+	virtualCount = (int *) calloc(theTree->numVirtualEdges + 1, sizeof(int));
+	edgeCount = (int *) calloc(gp_EdgeInUseIndexBound(theGraph), sizeof(int));
+	set = (int *) malloc((theTree->numNodes + 1) * sizeof(int));
+	blockNodes = (int *) calloc(theTree->numBlocks + 1, sizeof(int));
+	if (virtualCount == NULL || edgeCount == NULL || set == NULL || blockNodes == NULL)
+	{
+		*pMsg = "out of memory";
+		Result = NOTOK;
 	}
-	return -1;
+
+	for (i = 0; i < theTree->numNodes && Result == OK; i++)
+		Result = checkSPQRNode(theGraph, theTree, i, virtualCount, edgeCount, pMsg);
+
+	for (e = gp_GetFirstEdge(theGraph); e < gp_EdgeInUseIndexBound(theGraph) && Result == OK; e += 2)
+	{
+		if (!gp_EdgeInUse(theGraph, e))
+			continue;
+
+		if (gp_GetNeighbor(theGraph, e) == gp_GetNeighbor(theGraph, gp_GetTwinArc(theGraph, e))
+				? edgeCount[e] != 0 || theTree->edgeNode[e] != -1
+				: edgeCount[e] != 1)
+		{
+			*pMsg = "edge not in exactly one skeleton";
+			Result = NOTOK;
+		}
+	}
+
+	// Join the nodes of each virtual edge, which must be in different sets
+	for (i = 0; i < theTree->numNodes && Result == OK; i++)
+	{
+		set[i] = i;
+		blockNodes[theTree->nodeBlock[i]]++;
+	}
+
+	for (k = 0; k < theTree->numVirtualEdges && Result == OK; k++)
+	{
+		a = theTree->virtualEdgeNodes[2*k];
+		b = theTree->virtualEdgeNodes[2*k+1];
+
+		if (virtualCount[k] != 2 || a == b || theTree->nodeBlock[a] != theTree->nodeBlock[b])
+		{
+			*pMsg = "virtual edge not in two nodes of one block";
+			Result = NOTOK;
+		}
+		else if (theTree->nodeType[a] == theTree->nodeType[b] &&
+				 (theTree->nodeType[a] == SPQR_SNODE || theTree->nodeType[a] == SPQR_PNODE))
+		{
+			*pMsg = "adjacent S-nodes or P-nodes";
+			Result = NOTOK;
+		}
+		else
+		{
+			while (set[a] != a) a = set[a];
+			while (set[b] != b) b = set[b];
+			if (a == b)
+			{
+				*pMsg = "cycle of nodes";
+				Result = NOTOK;
+			}
+			set[a] = b;
+			blockNodes[theTree->nodeBlock[theTree->virtualEdgeNodes[2*k]]]--;
+		}
+	}
+
+	for (i = 0; i < theTree->numBlocks && Result == OK; i++)
+	{
+		if (blockNodes[i] != 1)
+		{
+			*pMsg = "nodes of a block not a tree";
+			Result = NOTOK;
+		}
+	}
+
+	if (virtualCount != NULL) free(virtualCount);
+	if (edgeCount != NULL) free(edgeCount);
+	if (set != NULL) free(set);
+	if (blockNodes != NULL) free(blockNodes);
+
+	return Result;
+}
+
+/***********************************************************************
+ checkSPQRNode()
+
+ Checks the skeleton of one node, counting its real edges in edgeCount
+ and its virtual edges in virtualCount.  Each real edge must be given
+ by its lesser arc and must belong to the node, and each virtual edge
+ must have the node as one of its two nodes.  A Q-node has one real
+ edge, and a P-node has two vertices and at least two edges.  An S-node
+ is a cycle: at least three edges, listed in cycle order, with as many
+ vertices as edges, each of degree two.  An R-node is a simple graph on
+ at least four vertices that stays connected when any two of them are
+ removed, i.e. it is triconnected.
+
+ Returns OK if the node is valid, or NOTOK with the failed check in *pMsg.
+ ***********************************************************************/
+
+#define MAXSKELETONEDGES (MAXN*(MAXN-1))
+
+int checkSPQRNode(graphP theGraph, spqrTreeP theTree, int node, int *virtualCount, int *edgeCount, char **pMsg)
+{
+	int u[MAXSKELETONEDGES], v[MAXSKELETONEDGES], vertices[MAXN+1], degree[MAXN+1];
+	int numEdges = theTree->nodeEdgeStart[node+1] - theTree->nodeEdgeStart[node];
+	int numVertices = 0, i, j, k, x;
+
+	if (numEdges < 1 || numEdges > MAXSKELETONEDGES || theTree->nodeBlock[node] < 0 ||
+		theTree->nodeBlock[node] >= theTree->numBlocks)
+	{
+		*pMsg = "bad node";
+		return NOTOK;
+	}
+
+	memset(degree, 0, sizeof(degree));
+	for (i = 0; i < numEdges; i++)
+	{
+		x = theTree->nodeEdges[theTree->nodeEdgeStart[node] + i];
+		if (spqr_IsVirtualEdge(x))
+		{
+			k = spqr_GetVirtualEdge(x);
+			if (k >= theTree->numVirtualEdges ||
+				(theTree->virtualEdgeNodes[2*k] != node && theTree->virtualEdgeNodes[2*k+1] != node))
+			{
+				*pMsg = "virtual edge of another node";
+				return NOTOK;
+			}
+			virtualCount[k]++;
+			u[i] = theTree->virtualEdgeEnds[2*k];
+			v[i] = theTree->virtualEdgeEnds[2*k+1];
+		}
+		else
+		{
+			if (x >= gp_EdgeInUseIndexBound(theGraph) || x != (x & ~1) || !gp_EdgeInUse(theGraph, x) ||
+				theTree->edgeNode[x] != node || theTree->edgeNode[gp_GetTwinArc(theGraph, x)] != node)
+			{
+				*pMsg = "real edge of another node";
+				return NOTOK;
+			}
+			edgeCount[x]++;
+			u[i] = gp_GetNeighbor(theGraph, gp_GetTwinArc(theGraph, x));
+			v[i] = gp_GetNeighbor(theGraph, x);
+		}
+
+		if (u[i] == v[i] || !gp_VertexInRange(theGraph, u[i]) || !gp_VertexInRange(theGraph, v[i]))
+		{
+			*pMsg = "bad skeleton edge";
+			return NOTOK;
+		}
+
+		if (degree[u[i]]++ == 0)
+			vertices[numVertices++] = u[i];
+		if (degree[v[i]]++ == 0)
+			vertices[numVertices++] = v[i];
+	}
+
+	switch (theTree->nodeType[node])
+	{
+		case SPQR_QNODE :
+			if (numEdges != 1 || spqr_IsVirtualEdge(theTree->nodeEdges[theTree->nodeEdgeStart[node]]))
+				*pMsg = "Q-node not one real edge";
+			break;
+
+		case SPQR_PNODE :
+			if (numVertices != 2 || numEdges < 2)
+				*pMsg = "P-node not a bond";
+			break;
+
+		case SPQR_SNODE :
+			if (numEdges < 3 || numVertices != numEdges)
+				*pMsg = "S-node not a cycle";
+			for (i = 0; i < numVertices; i++)
+				if (degree[vertices[i]] != 2)
+					*pMsg = "S-node not a cycle";
+			for (i = 0; i < numEdges; i++)
+			{
+				j = (i+1) % numEdges;
+				if (u[i] != u[j] && u[i] != v[j] && v[i] != u[j] && v[i] != v[j])
+					*pMsg = "S-node edges not in cycle order";
+			}
+			if (!isConnectedWithout(numVertices, vertices, numEdges, u, v, NIL, NIL))
+				*pMsg = "S-node not a cycle";
+			break;
+
+		case SPQR_RNODE :
+			if (numVertices < 4)
+				*pMsg = "R-node too small";
+			for (i = 0; i < numEdges; i++)
+				for (j = i+1; j < numEdges; j++)
+					if ((u[i] == u[j] && v[i] == v[j]) || (u[i] == v[j] && v[i] == u[j]))
+						*pMsg = "R-node not simple";
+			for (i = 0; i < numVertices; i++)
+				for (j = i+1; j < numVertices; j++)
+					if (!isConnectedWithout(numVertices, vertices, numEdges, u, v, vertices[i], vertices[j]))
+						*pMsg = "R-node not triconnected";
+			break;
+
+		default :
+			*pMsg = "bad node type";
+			break;
+	}
+
+	return *pMsg == NULL ? OK : NOTOK;
+}
+
+/***********************************************************************
+ isConnectedWithout()
+
+ Returns TRUE if the graph formed by the given vertices and edges is
+ still connected once vertices x and y are removed, or FALSE if not.
+ Pass NIL for x and y to test the whole graph.
+ ***********************************************************************/
+
+int isConnectedWithout(int numVertices, int *vertices, int numEdges, int *u, int *v, int x, int y)
+{
+	int set[MAXN+1], i, a, b, root = NIL;
+
+	for (i = 0; i < numVertices; i++)
+		set[vertices[i]] = vertices[i];
+
+	for (i = 0; i < numEdges; i++)
+	{
+		if (u[i] == x || u[i] == y || v[i] == x || v[i] == y)
+			continue;
+
+		for (a = u[i]; set[a] != a; a = set[a]) ;
+		for (b = v[i]; set[b] != b; b = set[b]) ;
+		set[a] = b;
+	}
+
+	for (i = 0; i < numVertices; i++)
+	{
+		if (vertices[i] == x || vertices[i] == y)
+			continue;
+
+		for (a = vertices[i]; set[a] != a; a = set[a]) ;
+		if (root == NIL)
+			root = a;
+		else if (a != root)
+			return FALSE;
+	}
+
+	return TRUE;
 }
 
 /***********************************************************************
@@ -366,11 +1234,26 @@ void getMessages(char command, char **pMsgAlg, char **pMsgOK, char **pMsgNoEmbed
 	{
 		case 'p' : *pMsgAlg="Planarity"; *pMsgOK="Planar"; *pMsgNoEmbed="Not Planar"; break;
 		case 'd' : *pMsgAlg="Planar Drawing"; *pMsgOK="Planar"; *pMsgNoEmbed="Not Planar"; break;
+		case 'l' : *pMsgAlg="Straight-Line Drawing"; *pMsgOK="Planar"; *pMsgNoEmbed="Not Planar"; break;
 		case 'o' : *pMsgAlg="Outerplanarity"; *pMsgOK="Embedded"; *pMsgNoEmbed="Obstructed"; break;
 		case '2' : *pMsgAlg="K2,3 Search"; *pMsgOK="no K2,3"; *pMsgNoEmbed="with K2,3"; break;
 		case '3' : *pMsgAlg="K3,3 Search"; *pMsgOK="no K3,3"; *pMsgNoEmbed="with K3,3"; break;
 		case '4' : *pMsgAlg="K4 Search"; *pMsgOK="no K4"; *pMsgNoEmbed="with K4"; break;
+		case '5' : *pMsgAlg="K5 Search"; *pMsgOK="no K5"; *pMsgNoEmbed="with K5"; break;
+		case 'j' : *pMsgAlg="Projective Planarity"; *pMsgOK="Embedded"; *pMsgNoEmbed="Not Embedded"; break;
+		case 't' : *pMsgAlg="Toroidality"; *pMsgOK="Embedded"; *pMsgNoEmbed="Not Embedded"; break;
 		case 'c' : *pMsgAlg="Vertex Coloring"; *pMsgOK="<=5 colors"; *pMsgNoEmbed=">5 colors"; break;
+		case 'm' : *pMsgAlg="Embed Components"; *pMsgOK="Planar"; *pMsgNoEmbed="Not Planar"; break;
+		case 'e' : *pMsgAlg="Embed Reduced"; *pMsgOK="Planar"; *pMsgNoEmbed="Not Planar"; break;
+		case 'f' : *pMsgAlg="Find Obstructions"; *pMsgOK="Planar"; *pMsgNoEmbed="Not Planar"; break;
+		case 'u' : *pMsgAlg="Build From Edge Array"; *pMsgOK="Planar"; *pMsgNoEmbed="Not Planar"; break;
+		case 'n' : *pMsgAlg="Compact And Reorder"; *pMsgOK="Planar"; *pMsgNoEmbed="Not Planar"; break;
+		case 'k' : *pMsgAlg="Cache Preprocessing"; *pMsgOK="Planar"; *pMsgNoEmbed="Not Planar"; break;
+		case 'b' : *pMsgAlg="Embed Blocks"; *pMsgOK="Planar"; *pMsgNoEmbed="Not Planar"; break;
+		case 'y' : *pMsgAlg="Embed K3,3 Search"; *pMsgOK="no K3,3"; *pMsgNoEmbed="with K3,3"; break;
+		case 'g' : *pMsgAlg="SPQR Tree"; *pMsgOK="no R-node"; *pMsgNoEmbed="with R-node"; break;
+		case 'v' : *pMsgAlg="Parallel Vertex Coloring"; *pMsgOK="<=5 colors"; *pMsgNoEmbed=">5 colors"; break;
+		case 'w' : *pMsgAlg="Vertex Coloring Strategies"; *pMsgOK="<=5 colors"; *pMsgNoEmbed=">5 colors"; break;
 		default  : *pMsgAlg = *pMsgOK = *pMsgNoEmbed = NULL; break;
 	}
 }
@@ -450,31 +1333,16 @@ void Test_PrintStats(FILE *outfile)
 	// The unit test mode has special case handling to test whether the stat are correct
 	if (unittestMode)
 	{
-		unsigned long results[NUMCOMMANDSTOTEST] = { 194815, 194815, 269377, 268948, 191091, 265312, 2178 };
 		int i;
 		testResultP testResult;
 
-		if (g_command == 'a')
-		{
-		    for (i=0; i < NUMCOMMANDSTOTEST; i++)
-		    {
-		    	testResult = testFramework->algResults + i;
-		    	if (results[i] != testResult->result.numGraphs - testResult->result.numOKs)
-		    		errorFound = 1;
-		    }
-		}
-		else
+		for (i=0; i < testFramework->algResultsSize; i++)
 		{
-			i = getCommandIndex(g_command);
-
-			if (i < 0 || i >= NUMCOMMANDSTOTEST)
+			testResult = testFramework->algResults + i;
+			if (g_maxn != tf_GetUnitTestOrder(testResult->command) ||
+				tf_GetUnitTestExpectedResult(testResult->command) !=
+						testResult->result.numGraphs - testResult->result.numOKs)
 				errorFound = 1;
-			else
-			{
-				testResult = testFramework->algResults + 0;
-		    	if (results[i] != testResult->result.numGraphs - testResult->result.numOKs)
-		    		errorFound = 1;
-			}
 		}
 	}
 
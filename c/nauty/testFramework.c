@@ -46,14 +46,46 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 #include "testFramework.h"
 
-char *commands = "pdo234c";
+char *commands = "pdlo234c";
+char *unittestCommands = "5mefunkbygvwjt";
+char *embedVariantCommands = "mefunkby";
 
 #include "../graphK23Search.h"
 #include "../graphK33Search.h"
 #include "../graphK4Search.h"
+#include "../graphK5Search.h"
+#include "../graphSurfaceEmbed.h"
 #include "../graphDrawPlanar.h"
+#include "../graphDrawStraightLine.h"
 #include "../graphColorVertices.h"
 
+/* The number of vertices of the graphs on which the quick regression test
+   runs each command, and the number of those graphs on which the command
+   is expected not to produce OK. All of the planar embedding variants are
+   expected to find the same number of nonplanar graphs. */
+
+typedef struct
+{
+	char command;
+	int n;
+	unsigned long numNotOKs;
+} unittestRec;
+
+unittestRec unittests[] = {
+		{ 'p', 9, 194815 }, { 'd', 9, 194815 }, { 'l', 9, 194815 }, { 'o', 9, 269377 },
+		{ '2', 9, 268948 }, { '3', 9, 191091 }, { '4', 9, 265312 },
+		{ 'c', 9, 2178 },
+		{ '5', 9, 164382 },
+		{ 'm', 9, 194815 }, { 'e', 9, 194815 }, { 'f', 9, 194815 },
+		{ 'u', 9, 194815 },
+		{ 'n', 9, 194815 }, { 'k', 9, 194815 }, { 'b', 9, 194815 },
+		{ 'y', 9, 191091 },
+		{ 'g', 9, 265312 },
+		{ 'v', 9, 2175 }, { 'w', 9, 2155 },
+		{ 'j', 8, 527 }, { 't', 8, 15 },
+		{ '\0', 0, 0 }
+};
+
 /* Forward Declarations of Private functions */
 graphP createGraph(char command, int n, int maxe);
 int attachAlgorithmExtension(char command, graphP aGraph);
@@ -75,6 +107,7 @@ testResultFrameworkP tf_AllocateTestFramework(char command, int n, int maxe)
 
 		framework->algResultsSize = command == 'a' ? NUMCOMMANDSTOTEST : 1;
 		framework->algResults = (testResultP) malloc(framework->algResultsSize * sizeof(testResultStruct));
+		framework->preprocessedGraph = NULL;
 		for (i=0; i < framework->algResultsSize; i++)
 			if (initTestResult(framework->algResults+i,
 					command=='a'?commands[i]:command, n, maxe) != OK)
@@ -83,6 +116,9 @@ testResultFrameworkP tf_AllocateTestFramework(char command, int n, int maxe)
 				tf_FreeTestFramework(&framework);
 				return NULL;
 			}
+
+		if (command == 'a' && (framework->preprocessedGraph = createGraph('p', n, maxe)) == NULL)
+			tf_FreeTestFramework(&framework);
 	}
 
 	return framework;
@@ -109,6 +145,8 @@ void tf_FreeTestFramework(testResultFrameworkP *pTestFramework)
 			framework->algResultsSize = 0;
 		}
 
+		gp_Free(&framework->preprocessedGraph);
+
 		free(*pTestFramework);
 		*pTestFramework = framework = NULL;
 	}
@@ -133,6 +171,36 @@ testResultP tf_GetTestResult(testResultFrameworkP framework, char command)
 	return testResult;
 }
 
+/***********************************************************************
+ tf_GetUnitTestOrder()
+ ***********************************************************************/
+
+int tf_GetUnitTestOrder(char command)
+{
+	int i;
+
+	for (i=0; unittests[i].command != '\0'; i++)
+		if (unittests[i].command == command)
+			return unittests[i].n;
+
+	return 0;
+}
+
+/***********************************************************************
+ tf_GetUnitTestExpectedResult()
+ ***********************************************************************/
+
+unsigned long tf_GetUnitTestExpectedResult(char command)
+{
+	int i;
+
+	for (i=0; unittests[i].command != '\0'; i++)
+		if (unittests[i].command == command)
+			return unittests[i].numNotOKs;
+
+	return 0;
+}
+
 /***********************************************************************
  initTestResult()
  ***********************************************************************/
@@ -147,6 +215,7 @@ int initTestResult(testResultP testResult, char command, int n, int maxe)
 		testResult->edgeResultsSize = maxe;
 		testResult->theGraph = NULL;
 		testResult->origGraph = NULL;
+		testResult->refGraph = NULL;
 
 		testResult->edgeResults = (baseTestResultStruct *) malloc((maxe+1) * sizeof(baseTestResultStruct));
 		if (testResult->edgeResults == NULL)
@@ -162,7 +231,9 @@ int initTestResult(testResultP testResult, char command, int n, int maxe)
 		}
 
 		if ((testResult->theGraph = createGraph(command, n, maxe)) == NULL ||
-			(testResult->origGraph = createGraph(command, n, maxe)) == NULL)
+			(testResult->origGraph = createGraph(command, n, maxe)) == NULL ||
+			((strchr(embedVariantCommands, command) != NULL || command == 'v' || command == 'w') &&
+			 (testResult->refGraph = createGraph(command == 'y' ? '3' : 'p', n, maxe)) == NULL))
 		{
 			releaseTestResult(testResult);
 			return NOTOK;
@@ -187,6 +258,7 @@ void releaseTestResult(testResultP testResult)
 	}
 	gp_Free(&(testResult->theGraph));
 	gp_Free(&(testResult->origGraph));
+	gp_Free(&(testResult->refGraph));
 }
 
 /***********************************************************************
@@ -228,11 +300,26 @@ int attachAlgorithmExtension(char command, graphP aGraph)
     {
 		case 'p' : break;
 		case 'd' : gp_AttachDrawPlanar(aGraph);	break;
+		case 'l' : gp_AttachDrawStraightLine(aGraph); break;
 		case 'o' : break;
 		case '2' : gp_AttachK23Search(aGraph); break;
 		case '3' : gp_AttachK33Search(aGraph); break;
 		case '4' : gp_AttachK4Search(aGraph); break;
+		case '5' : gp_AttachK5Search(aGraph); break;
+		case 'j' : gp_AttachSurfaceEmbed(aGraph); break;
+		case 't' : gp_AttachSurfaceEmbed(aGraph); break;
 		case 'c' : gp_AttachColorVertices(aGraph); break;
+		case 'm' : break;
+		case 'e' : break;
+		case 'f' : break;
+		case 'u' : break;
+		case 'n' : break;
+		case 'k' : break;
+		case 'b' : break;
+		case 'y' : gp_AttachK33Search(aGraph); break;
+		case 'g' : break;
+		case 'v' : break;
+		case 'w' : break;
 		default  : return NOTOK;
     }
 
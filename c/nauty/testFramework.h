@@ -51,9 +51,21 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 extern "C" {
 #endif
 
-#define NUMCOMMANDSTOTEST	7
+#define NUMCOMMANDSTOTEST	8
 extern char *commands;
 
+// unittestCommands: the commands that the quick regression test runs
+//            after testing the commands above, each on all graphs of
+//            the order given by tf_GetUnitTestOrder().  These are the
+//            alternative entry points into the embedder, which are
+//            tested against the result of gp_Embed(), and algorithms
+//            that are too costly to run with all of the commands above.
+extern char *unittestCommands;
+
+// embedVariantCommands: the unittestCommands that are alternative entry
+//            points into the embedder
+extern char *embedVariantCommands;
+
 // numGraphs: the number of graphs that met the test criteria
 //            (e.g. were generated and had a specific number of edges)
 // numOKs: the number of graphs on which the test produced OK
@@ -78,26 +90,34 @@ typedef struct
 //            an algorithm's result produced in theGraph
 //            The origGraph from algResult[0] in th test framework
 //            receives the edges from the adjacency matrix graph
-//            generated by Nauty.  Then, gp_CopyAdjacencyLists() is
-//            used to copy the edges of this graph into the origGraph
-//            of each other algorithm testResult (if any).
+//            generated by Nauty.  When all algorithms are tested,
+//            this origGraph is used by every algorithm testResult.
+// refGraph: for the embedVariantCommands, a graph with no extensions
+//           in which gp_Embed() computes the reference result, and NULL
+//           for the other commands.
 typedef struct
 {
 	char command;
 	baseTestResultStruct result;
 	baseTestResultStruct *edgeResults;
 	int edgeResultsSize;
-	graphP theGraph, origGraph;
+	graphP theGraph, origGraph, refGraph;
 } testResultStruct;
 
 typedef testResultStruct * testResultP;
 
 // algResults: An array of testResults for each algorithm being tested
 // algResultsSize: the number of algorithms being tested
+// preprocessedGraph: When all algorithms are tested, each generated graph
+//            is copied into this graph and preprocessed once by
+//            gp_PreprocessForEmbedding(). Each embedding algorithm then
+//            obtains the graph with gp_CopyPreprocessedGraph() so that
+//            the DFS is not repeated by each algorithm.  NULL otherwise.
 typedef struct
 {
 	testResultStruct *algResults;
 	int algResultsSize;
+	graphP preprocessedGraph;
 } testResultFrameworkStruct;
 
 typedef testResultFrameworkStruct * testResultFrameworkP;
@@ -113,6 +133,14 @@ testResultFrameworkP tf_AllocateTestFramework(char command, int n, int maxe);
 // Free the test framework.
 void tf_FreeTestFramework(testResultFrameworkP *pTestFramework);
 
+// Returns the number of vertices of the graphs on which the quick
+// regression test runs the given command, or 0 if it is not tested.
+int tf_GetUnitTestOrder(char command);
+
+// Returns the number of graphs of the unit test order on which the
+// given command is expected not to produce OK.
+unsigned long tf_GetUnitTestExpectedResult(char command);
+
 #ifdef __cplusplus
 }
 #endif
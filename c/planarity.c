@@ -76,9 +76,6 @@ int main(int argc, char *argv[])
 	else
 		retVal = legacyCommandLine(argc, argv);
 
-	// Close the log file if logging
-	gp_Log(NULL);
-
 	return retVal;
 }
 
@@ -92,12 +89,16 @@ int helpMessage(char *param)
     	"C = command (algorithm implementation to run)\n"
     	"    -p = Planar embedding and Kuratowski subgraph isolation\n"
         "    -d = Planar graph drawing by visibility representation\n"
+        "    -l = Planar graph drawing with straight-line edges on a grid\n"
         "    -o = Outerplanar embedding and obstruction isolation\n"
         "    -2 = Search for subgraph homeomorphic to K_{2,3}\n"
         "    -3 = Search for subgraph homeomorphic to K_{3,3}\n"
         "    -4 = Search for subgraph homeomorphic to K_4\n"
+        "    -5 = Search for subgraph homeomorphic to K_5\n"
 		"    -c = Color the vertices of the graph\n"
 		"    -a = All of the above\n"
+        "    -j = Projective planar embedding\n"
+        "    -t = Toroidal embedding\n"
     	"\n";
 
 	ProjectTitle();
@@ -112,6 +113,13 @@ int helpMessage(char *param)
 	        "'planarity (-i|-info): copyright and license information\n"
     	    "'planarity -test [-q] [C]': runs tests (optional quiet mode, single test)\n"
 	    	"'planarity -gen [-q] C [...] n [...]': run command C on n-vertex graphs\n"
+	    	"'planarity -trace [-q] C I O T': run command C on graph I, as with -s, and\n"
+	    	"       write a binary trace T of the events that occurred in the algorithm\n"
+	    	"'planarity -decode [-q] [-json] T O': convert trace T to text (or to Chrome\n"
+	    	"       trace event JSON with -json), writing it to O\n"
+	    	"'planarity -ooc [-q] D B C I O [O2]': run command C on graph I, as with -s,\n"
+	    	"       keeping arrays beyond a memory budget of B megabytes in temporary\n"
+	    	"       files in directory D, for graphs too large for memory\n"
 	    	"\n"
 	    );
 
@@ -192,6 +200,23 @@ int helpMessage(char *param)
 
 	    Message(commandStr);
 
+	    Message(
+	    	"These commands are only for -gen and -test, and check the result\n"
+	    	"against that of -p as well as its integrity:\n"
+	    	"    -m = Planarity by gp_EmbedComponents() with two threads\n"
+	    	"    -e = Planarity by gp_EmbedReduced()\n"
+	    	"    -f = Planarity by gp_FindObstructions(), checking each obstruction\n"
+	    	"    -u = Planarity of the graph rebuilt by gp_BuildFromEdgeArray()\n"
+	    	"    -n = Planarity after gp_CompactAndReorder() by BFS, DFS and RCM\n"
+	    	"    -k = Planarity of graph copies sharing gp_CachePreprocessing()\n"
+	    	"    -b = Planarity by gp_EmbedBlocks() with two threads\n"
+	    	"    -y = K_{3,3} search by gp_EmbedK33(), checked against that of -3\n"
+	    	"    -g = SPQR tree by gp_CreateSPQRTree(), checking each node\n"
+	    	"    -v = Vertex coloring by gp_ColorVerticesParallel() with two threads\n"
+	    	"    -w = Vertex coloring by each strategy of gp_ColorVerticesStrategy()\n"
+	    	"\n"
+	    );
+
 	    Message("{ncl}= [-c -t -b] [-d<max>] n [mine [maxe [mod res]]]\n\n");
 
 	    Message(
@@ -228,6 +253,12 @@ int helpMessage(char *param)
 
 	    Message(commandStr);
 
+	    Message(
+	    	"For -s, -trace and -ooc, C=-d<T> draws the graph using T threads\n"
+	    	"    (by default, one per online processor)\n"
+	    	"\n"
+	    );
+
 	    Message(
 	    	"K = # of graphs to randomly generate\n"
 	    	"N = # of vertices in each randomly generated graph\n"
@@ -237,7 +268,10 @@ int helpMessage(char *param)
 	    	"    If C=-3, then O receives a subgraph containing a K_{3,3}\n"
 	        "O2= Secondary output file\n"
 	    	"    For -s, if C=-p or -o, then O2 receives the embedding obstruction\n"
-	       	"    For -s, if C=-d, then O2 receives a drawing of the planar graph\n"
+	       	"    For -s, if C=-d, then O2 receives a drawing of the planar graph, or\n"
+	       	"        its coordinate list if O2 ends with .coords.txt (or .coords.bin),\n"
+	       	"        or an SVG or JSON drawing if O2 ends with .svg or .json\n"
+	       	"    For -s, if C=-l, then O2 receives the grid coordinates of the vertices\n"
 	    	"    For -m and -n, O2 contains the original randomly generated graph\n"
 	    	"\n"
 	    );
@@ -245,9 +279,12 @@ int helpMessage(char *param)
 	    Message(
 	        "planarity process results: 0=OK, -1=NOTOK, 1=NONEMBEDDABLE\n"
 	    	"    1 result only produced by specific graph mode (-s)\n"
-	        "      with command -2,-3,-4: found K_{2,3}, K_{3,3} or K_4\n"
-	    	"      with command -p,-d: found planarity obstruction\n"
+	        "      with command -2,-3,-4,-5: found K_{2,3}, K_{3,3}, K_4 or K_5\n"
+	    	"      with command -p,-d,-l: found planarity obstruction\n"
 	    	"      with command -o: found outerplanarity obstruction\n"
+	    	"      with command -j,-t: graph does not embed on the surface\n"
+	    	"    2 result only produced with command -5 when the K_5 search\n"
+	    	"      reaches its branch limit, so the result is not definitive\n"
 	    );
 	}
 
@@ -269,10 +306,14 @@ char Choice;
         Message("\n"
                 "P. Planar embedding and Kuratowski subgraph isolation\n"
                 "D. Planar graph drawing by visibility representation\n"
+                "L. Planar graph drawing with straight-line edges on a grid\n"
                 "O. Outerplanar embedding and obstruction isolation\n"
                 "2. Search for subgraph homeomorphic to K_{2,3}\n"
                 "3. Search for subgraph homeomorphic to K_{3,3}\n"
                 "4. Search for subgraph homeomorphic to K_4\n"
+                "5. Search for subgraph homeomorphic to K_5\n"
+                "J. Projective planar embedding\n"
+                "T. Toroidal embedding\n"
         		"C. Color the vertices of the graph\n"
         		"H. Help message for command line version\n"
                 "R. Reconfigure options\n"
@@ -294,7 +335,7 @@ char Choice;
         else if (Choice != 'x')
         {
         	char *secondOutfile = NULL;
-        	if (Choice == 'p'  || Choice == 'o' || Choice == 'd')
+        	if (Choice == 'p'  || Choice == 'o' || Choice == 'd' || Choice == 'l')
         		secondOutfile ="";
 
             switch (tolower(Mode))
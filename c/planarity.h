@@ -64,7 +64,10 @@ extern "C" {
 #include "graphK23Search.h"
 #include "graphK33Search.h"
 #include "graphK4Search.h"
+#include "graphK5Search.h"
 #include "graphDrawPlanar.h"
+#include "graphDrawStraightLine.h"
+#include "graphSurfaceEmbed.h"
 #include "graphColorVertices.h"
 
 void ProjectTitle();
@@ -89,6 +92,10 @@ char Mode,
      AdjListsForEmbeddingsOut,
      quietMode;
 
+char *traceFileName;
+char *memoryFileDir;
+int   numThreads;
+
 void Reconfigure();
 
 /* Low-level Utilities */
@@ -103,6 +110,7 @@ void Prompt(char *message);
 void SaveAsciiGraph(graphP theGraph, char *filename);
 
 int  FilesEqual(char *file1Name, char *file2Name);
+int  FileNameEndsWith(char *fileName, char *ending);
 
 int GetEmbedFlags(char command);
 char *GetAlgorithmName(char command);
@@ -111,6 +119,7 @@ void AttachAlgorithm(graphP theGraph, char command);
 char *ConstructInputFilename(char *infileName);
 char *ConstructPrimaryOutputFilename(char *infileName, char *outfileName, char command);
 void WriteAlgorithmResults(graphP theGraph, int Result, char command, platform_time start, platform_time end, char *infileName);
+int  WriteDrawPlanarFile(graphP theGraph, char *theFileName);
 
 #ifdef __cplusplus
 }
@@ -57,6 +57,10 @@ int callRandomGraphs(int argc, char *argv[]);
 int callSpecificGraph(int argc, char *argv[]);
 int callRandomMaxPlanarGraph(int argc, char *argv[]);
 int callRandomNonplanarGraph(int argc, char *argv[]);
+int callTraceGraph(int argc, char *argv[]);
+int callOutOfCoreGraph(int argc, char *argv[]);
+int callDecodeTrace(int argc, char *argv[]);
+char GetCommandChoice(char *commandArg);
 
 /****************************************************************************
  Command Line Processor
@@ -97,6 +101,15 @@ int commandLine(int argc, char *argv[])
 	else if (strcmp(argv[1], "-rn") == 0)
 		Result = callRandomNonplanarGraph(argc, argv);
 
+	else if (strcmp(argv[1], "-trace") == 0)
+		Result = callTraceGraph(argc, argv);
+
+	else if (strcmp(argv[1], "-ooc") == 0)
+		Result = callOutOfCoreGraph(argc, argv);
+
+	else if (strcmp(argv[1], "-decode") == 0)
+		Result = callDecodeTrace(argc, argv);
+
 	else
 	{
 		ErrorMessage("Unsupported command line.  Here is the help for this program.\n");
@@ -104,6 +117,9 @@ int commandLine(int argc, char *argv[])
 		Result = NOTOK;
 	}
 
+	if (Result == K5SEARCH_LIMITREACHED)
+		return 2;
+
 	return Result == OK ? 0 : (Result == NONEMBEDDABLE ? 1 : -1);
 }
 
@@ -130,7 +146,7 @@ int Result;
 		}
 	}
 
-	Result = gp_Embed(theGraph, EMBEDFLAGS_PLANAR);
+	Result = gp_EmbedPlanar(theGraph);
 
 	if (Result == OK)
 	{
@@ -260,6 +276,11 @@ int callNauty(int argc, char *argv[])
 int runNautyTests(int argc, char *argv[]);
 int runSpecificGraphTests();
 int runSpecificGraphTest(char *command, char *infileName);
+int runDrawPlanarTest(char *infileName, char *suffix);
+int runTraceDecodeTest(char *command, char *infileName);
+int runOutOfCoreTest(char *command, char *infileName);
+int compareToExemplar(char *exemplarName, char *outfileName, char *resultName);
+char *appendToFilename(char *fileName, char *suffix);
 
 int runQuickRegressionTests(int argc, char *argv[])
 {
@@ -297,6 +318,15 @@ int runSpecificGraphTests()
 	if (runSpecificGraphTest("-d", "drawExample.txt") < 0)
 		retVal = -1;
 
+	if (runSpecificGraphTest("-d4", "drawExample.txt") < 0)
+		retVal = -1;
+
+	if (runSpecificGraphTest("-l", "maxPlanar5.txt") < 0)
+		retVal = -1;
+
+	if (runSpecificGraphTest("-l", "drawExample.txt") < 0)
+		retVal = -1;
+
 	if (runSpecificGraphTest("-p", "Petersen.txt") < 0)
 		retVal = -1;
 
@@ -312,6 +342,15 @@ int runSpecificGraphTests()
 	if (runSpecificGraphTest("-4", "Petersen.txt") < 0)
 		retVal = -1;
 
+	if (runSpecificGraphTest("-5", "gridPlusEdge.txt") < 0)
+		retVal = -1;
+
+	if (runSpecificGraphTest("-j", "Petersen.txt") < 0)
+		retVal = -1;
+
+	if (runSpecificGraphTest("-t", "Petersen.txt") < 0)
+		retVal = -1;
+
 	if (runSpecificGraphTest("-c", "maxPlanar5.txt") < 0)
 		retVal = -1;
 
@@ -320,6 +359,21 @@ int runSpecificGraphTests()
 
 	if (runSpecificGraphTest("-c", "drawExample.txt") < 0)
 		retVal = -1;
+
+	if (runDrawPlanarTest("drawExample.txt", ".coords.txt") < 0)
+		retVal = -1;
+
+	if (runDrawPlanarTest("drawExample.txt", ".svg") < 0)
+		retVal = -1;
+
+	if (runDrawPlanarTest("drawExample.txt", ".json") < 0)
+		retVal = -1;
+
+	if (runTraceDecodeTest("-p", "maxPlanar5.txt") < 0)
+		retVal = -1;
+
+	if (runOutOfCoreTest("-d", "drawExample.txt") < 0)
+		retVal = -1;
 #endif
 
 	if (runSpecificGraphTest("-p", "maxPlanar5.0-based.txt") < 0)
@@ -331,6 +385,15 @@ int runSpecificGraphTests()
 	if (runSpecificGraphTest("-d", "drawExample.0-based.txt") < 0)
 		retVal = -1;
 
+	if (runSpecificGraphTest("-d4", "drawExample.0-based.txt") < 0)
+		retVal = -1;
+
+	if (runSpecificGraphTest("-l", "maxPlanar5.0-based.txt") < 0)
+		retVal = -1;
+
+	if (runSpecificGraphTest("-l", "drawExample.0-based.txt") < 0)
+		retVal = -1;
+
 	if (runSpecificGraphTest("-p", "Petersen.0-based.txt") < 0)
 		retVal = -1;
 
@@ -346,6 +409,15 @@ int runSpecificGraphTests()
 	if (runSpecificGraphTest("-4", "Petersen.0-based.txt") < 0)
 		retVal = -1;
 
+	if (runSpecificGraphTest("-5", "gridPlusEdge.0-based.txt") < 0)
+		retVal = -1;
+
+	if (runSpecificGraphTest("-j", "Petersen.0-based.txt") < 0)
+		retVal = -1;
+
+	if (runSpecificGraphTest("-t", "Petersen.0-based.txt") < 0)
+		retVal = -1;
+
 	if (runSpecificGraphTest("-c", "maxPlanar5.0-based.txt") < 0)
 		retVal = -1;
 
@@ -355,6 +427,18 @@ int runSpecificGraphTests()
 	if (runSpecificGraphTest("-c", "drawExample.0-based.txt") < 0)
 		retVal = -1;
 
+	if (runDrawPlanarTest("drawExample.0-based.txt", ".coords.txt") < 0)
+		retVal = -1;
+
+	if (runDrawPlanarTest("drawExample.0-based.txt", ".svg") < 0)
+		retVal = -1;
+
+	if (runDrawPlanarTest("drawExample.0-based.txt", ".json") < 0)
+		retVal = -1;
+
+	if (runOutOfCoreTest("-d", "drawExample.0-based.txt") < 0)
+		retVal = -1;
+
 	if (retVal == 0)
 		printf("Tests of all specific graphs succeeded\n");
 
@@ -412,17 +496,20 @@ int runSpecificGraphTest(char *command, char *infileName)
 		}
 	}
 
-	// For graph drawing, secondary file is outfileName + ".render.txt"
+	// For graph drawing, secondary file is outfileName + ".render.txt", and
+	// for straight-line drawing, it is outfileName + ".coords.txt"
 
-	if (command[1] == 'd' && Result == 0)
+	if ((command[1] == 'd' || command[1] == 'l') && Result == 0)
 	{
+		char *suffix = command[1] == 'd' ? ".render.txt" : ".coords.txt";
+
 		outfile2Name = ConstructPrimaryOutputFilename(NULL, outfileName, command[1]);
 		free(outfileName);
-		outfileName = strdup(strcat(outfile2Name, ".render.txt"));
+		outfileName = strdup(strcat(outfile2Name, suffix));
 
 		free(testfileName);
 		testfileName = ConstructPrimaryOutputFilename(infileName, NULL, command[1]);
-		testfileName = strdup(strcat(testfileName, ".render.txt"));
+		testfileName = strdup(strcat(testfileName, suffix));
 
 		if (Result == 0)
 		{
@@ -446,40 +533,273 @@ int runSpecificGraphTest(char *command, char *infileName)
 	return Result;
 }
 
+/****************************************************************************
+ runDrawPlanarTest()
+
+ Runs -d on the input file with a secondary output file whose name ends
+ with the suffix, which selects the format in which the drawing is
+ written.  The primary output must equal the exemplar of
+ runSpecificGraphTest(), and the secondary output must equal the
+ exemplar named by the primary exemplar plus the suffix.
+ ****************************************************************************/
+
+int runDrawPlanarTest(char *infileName, char *suffix)
+{
+	char *commandLine[] = {
+			"planarity", "-s", "-d", "infile", "outfile", "outfile2"
+	};
+	char *testfileName = strdup(ConstructPrimaryOutputFilename(infileName, NULL, 'd'));
+	char *outfileName = appendToFilename(testfileName, ".test.txt");
+	char *outfile2Name = appendToFilename(outfileName, suffix);
+	char *testfile2Name = appendToFilename(testfileName, suffix);
+	int Result = 0;
+
+	if (testfileName == NULL || outfileName == NULL || outfile2Name == NULL || testfile2Name == NULL)
+		Result = -1;
+
+	// 'planarity -s [-q] C I O [O2]': Specific graph
+	if (Result == 0)
+	{
+		commandLine[3] = infileName;
+		commandLine[4] = outfileName;
+		commandLine[5] = outfile2Name;
+
+		Result = callSpecificGraph(6, commandLine);
+		if (Result == OK || Result == NONEMBEDDABLE)
+			Result = compareToExemplar(testfileName, outfileName, "result");
+		else
+		{
+			ErrorMessage("Test failed (graph processor returned failure result).\n");
+			Result = -1;
+		}
+	}
+
+	if (Result == 0)
+		Result = compareToExemplar(testfile2Name, outfile2Name, "secondary result");
+
+	Message("\n");
+
+	if (testfileName != NULL) free(testfileName);
+	if (outfileName != NULL) free(outfileName);
+	if (outfile2Name != NULL) free(outfile2Name);
+	if (testfile2Name != NULL) free(testfile2Name);
+	return Result;
+}
+
+/****************************************************************************
+ runTraceDecodeTest()
+
+ Runs the command on the input file with -trace, then decodes the event
+ trace to text with -decode.  The primary output must equal the exemplar
+ of runSpecificGraphTest(), and the decoded trace must equal the exemplar
+ named by the primary exemplar plus ".trace.txt".
+ ****************************************************************************/
+
+int runTraceDecodeTest(char *command, char *infileName)
+{
+	char *traceCommandLine[] = {
+			"planarity", "-trace", "C", "infile", "outfile", "tracefile"
+	};
+	char *decodeCommandLine[] = {
+			"planarity", "-decode", "tracefile", "decodefile"
+	};
+	char *testfileName = strdup(ConstructPrimaryOutputFilename(infileName, NULL, command[1]));
+	char *outfileName = appendToFilename(testfileName, ".test.txt");
+	char *tracefileName = appendToFilename(outfileName, ".trace");
+	char *decodefileName = appendToFilename(outfileName, ".trace.txt");
+	char *decodeTestfileName = appendToFilename(testfileName, ".trace.txt");
+	int Result = 0;
+
+	if (testfileName == NULL || outfileName == NULL || tracefileName == NULL ||
+		decodefileName == NULL || decodeTestfileName == NULL)
+		Result = -1;
+
+	// 'planarity -trace [-q] C I O T': Specific graph, with event trace written to T
+	if (Result == 0)
+	{
+		traceCommandLine[2] = command;
+		traceCommandLine[3] = infileName;
+		traceCommandLine[4] = outfileName;
+		traceCommandLine[5] = tracefileName;
+
+		Result = callTraceGraph(6, traceCommandLine);
+		if (Result == OK || Result == NONEMBEDDABLE)
+			Result = compareToExemplar(testfileName, outfileName, "result");
+		else
+		{
+			ErrorMessage("Test failed (graph processor returned failure result).\n");
+			Result = -1;
+		}
+	}
+
+	// 'planarity -decode [-q] [-json] T O': Convert event trace T to text or JSON
+	if (Result == 0)
+	{
+		decodeCommandLine[2] = tracefileName;
+		decodeCommandLine[3] = decodefileName;
+
+		if (callDecodeTrace(4, decodeCommandLine) == OK)
+			Result = compareToExemplar(decodeTestfileName, decodefileName, "decoded trace");
+		else
+		{
+			ErrorMessage("Test failed (trace decoder returned failure result).\n");
+			Result = -1;
+		}
+	}
+
+	Message("\n");
+
+	if (tracefileName != NULL)
+		unlink(tracefileName);
+
+	if (testfileName != NULL) free(testfileName);
+	if (outfileName != NULL) free(outfileName);
+	if (tracefileName != NULL) free(tracefileName);
+	if (decodefileName != NULL) free(decodefileName);
+	if (decodeTestfileName != NULL) free(decodeTestfileName);
+	return Result;
+}
+
+/****************************************************************************
+ runOutOfCoreTest()
+
+ Runs the command on the input file with -ooc and a memory budget of zero,
+ with the temporary files in the current directory.  The primary and, for
+ the drawing commands, secondary outputs must equal the exemplars of
+ runSpecificGraphTest().
+ ****************************************************************************/
+
+int runOutOfCoreTest(char *command, char *infileName)
+{
+	char *commandLine[] = {
+			"planarity", "-ooc", ".", "0", "C", "infile", "outfile", "outfile2"
+	};
+	char *testfileName = strdup(ConstructPrimaryOutputFilename(infileName, NULL, command[1]));
+	char *outfileName = appendToFilename(testfileName, ".test.txt");
+	char *outfile2Name = NULL, *testfile2Name = NULL;
+	int Result = 0;
+
+	if (command[1] == 'd' || command[1] == 'l')
+	{
+		char *suffix = command[1] == 'd' ? ".render.txt" : ".coords.txt";
+
+		outfile2Name = appendToFilename(outfileName, suffix);
+		testfile2Name = appendToFilename(testfileName, suffix);
+		if (outfile2Name == NULL || testfile2Name == NULL)
+			Result = -1;
+	}
+
+	if (testfileName == NULL || outfileName == NULL)
+		Result = -1;
+
+	// 'planarity -ooc [-q] D B C I O [O2]': Specific graph, with arrays beyond
+	// a memory budget of B megabytes kept in temporary files in directory D
+	if (Result == 0)
+	{
+		commandLine[4] = command;
+		commandLine[5] = infileName;
+		commandLine[6] = outfileName;
+		commandLine[7] = outfile2Name;
+
+		Result = callOutOfCoreGraph(outfile2Name != NULL ? 8 : 7, commandLine);
+		if (Result == OK || Result == NONEMBEDDABLE)
+			Result = compareToExemplar(testfileName, outfileName, "result");
+		else
+		{
+			ErrorMessage("Test failed (graph processor returned failure result).\n");
+			Result = -1;
+		}
+	}
+
+	if (Result == 0 && outfile2Name != NULL)
+		Result = compareToExemplar(testfile2Name, outfile2Name, "secondary result");
+
+	Message("\n");
+
+	if (testfileName != NULL) free(testfileName);
+	if (outfileName != NULL) free(outfileName);
+	if (outfile2Name != NULL) free(outfile2Name);
+	if (testfile2Name != NULL) free(testfile2Name);
+	return Result;
+}
+
+/****************************************************************************
+ compareToExemplar()
+
+ Returns 0 and removes the output file if it equals the exemplar, or
+ reports the difference and returns -1 otherwise.
+ ****************************************************************************/
+
+int compareToExemplar(char *exemplarName, char *outfileName, char *resultName)
+{
+	if (FilesEqual(exemplarName, outfileName) == TRUE)
+	{
+		sprintf(Line, "Test succeeded (%s equal to exemplar).\n", resultName);
+		Message(Line);
+		unlink(outfileName);
+		return 0;
+	}
+
+	sprintf(Line, "Test failed (%s not equal to exemplar).\n", resultName);
+	ErrorMessage(Line);
+	return -1;
+}
+
+/****************************************************************************
+ appendToFilename()
+
+ Returns a newly allocated copy of the file name with the suffix appended,
+ or NULL if the file name is NULL or memory is exhausted.
+ ****************************************************************************/
+
+char *appendToFilename(char *fileName, char *suffix)
+{
+	char *newName;
+
+	if (fileName == NULL ||
+		(newName = (char *) malloc(strlen(fileName) + strlen(suffix) + 1)) == NULL)
+		return NULL;
+
+	strcpy(newName, fileName);
+	strcat(newName, suffix);
+	return newName;
+}
+
 #include "nauty/testFramework.h"
 extern int unittestMode;
 extern int errorFound;
 //extern testResultFrameworkP testFramework;
 
+int runNautyTest(char command);
+
 int runNautyTests(int argc, char *argv[])
 {
 	platform_time start, end;
 	int success = TRUE;
-	char *commandLine[4] = {
-			"planarity", "-gen", "-a", "9"
-	};
+	char command = 'a';
+	int i, len;
 
 	platform_GetTime(start);
 
-	// If a single command test, then get the command, otherwise restore 'a' for all
+	// If a single command test, then get the command, otherwise use 'a' for all
 	if (argc == 4 || (argc == 3 && quietMode != 'y'))
-		commandLine[2] = argv[2 + (quietMode == 'y' ? 1 : 0)];
-	else
-		commandLine[2] = "-a";
+		command = argv[2 + (quietMode == 'y' ? 1 : 0)][1];
 
-	// Go to unit test mode, tell the user what is happening
+	// Go to unit test mode
 	unittestMode = 1;
-	printf("Testing all %s vertex graphs\n", commandLine[3]);
 
-	// Run the test and obtain the result
-	if (callNauty(4, commandLine) != 0)
-		success = FALSE;
-	else
+	// Test all the commands, then each of the unit test commands in its own pass
+	if (command == 'a')
 	{
-		if (errorFound)
+		if (runNautyTest('a') != OK)
 			success = FALSE;
-		errorFound = 0;
+
+		for (i=0, len=strlen(unittestCommands); i < len; i++)
+			if (runNautyTest(unittestCommands[i]) != OK)
+				success = FALSE;
 	}
+	else if (runNautyTest(command) != OK)
+		success = FALSE;
 
 	// Get out of unit test mode
 	unittestMode = 0;
@@ -492,6 +812,38 @@ int runNautyTests(int argc, char *argv[])
 	return success ? 0 : -1;
 }
 
+int runNautyTest(char command)
+{
+	char commandStr[3] = { '-', command, '\0' }, orderStr[16];
+	char *commandLine[4] = {
+			"planarity", "-gen", commandStr, orderStr
+	};
+	int n = tf_GetUnitTestOrder(command == 'a' ? commands[0] : command);
+	int Result = OK;
+
+	if (n == 0)
+	{
+		ErrorMessage("Unsupported command for the unit test.\n");
+		return NOTOK;
+	}
+
+	// Tell the user what is happening
+	sprintf(orderStr, "%d", n);
+	printf("Testing all %s vertex graphs with %s\n", orderStr, commandStr);
+
+	// Run the test and obtain the result
+	if (callNauty(4, commandLine) != 0)
+		Result = NOTOK;
+	else
+	{
+		if (errorFound)
+			Result = NOTOK;
+		errorFound = 0;
+	}
+
+	return Result;
+}
+
 /****************************************************************************
  callRandomGraphs()
  ****************************************************************************/
@@ -519,6 +871,24 @@ int callRandomGraphs(int argc, char *argv[])
     return RandomGraphs(Choice, NumGraphs, SizeOfGraphs);
 }
 
+/****************************************************************************
+ GetCommandChoice()
+
+ Returns the command character of a command argument such as -p, and
+ for the drawing command given as -d<T>, sets numThreads to T so that
+ the visibility representation is computed by T threads.  If T is not
+ given, then numThreads is 0, so the number of online processors is used.
+ ****************************************************************************/
+
+char GetCommandChoice(char *commandArg)
+{
+	numThreads = 0;
+	if (commandArg[1] == 'd' && isdigit(commandArg[2]))
+		numThreads = atoi(commandArg+2);
+
+	return commandArg[1];
+}
+
 /****************************************************************************
  callSpecificGraph()
  ****************************************************************************/
@@ -534,12 +904,12 @@ int callSpecificGraph(int argc, char *argv[])
 
 	if (argv[2][0] == '-' && (Choice = argv[2][1]) == 'q')
 	{
-		Choice = argv[3][1];
 		if (argc < 6)
 			return -1;
 		offset = 1;
 	}
 
+	Choice = GetCommandChoice(argv[2+offset]);
 	infileName = argv[3+offset];
 	outfileName = argv[4+offset];
 	if (argc == 6+offset)
@@ -603,3 +973,106 @@ int callRandomNonplanarGraph(int argc, char *argv[])
 
 	return RandomGraph('p', 1, numVertices, outfileName, outfile2Name);
 }
+
+/****************************************************************************
+ callTraceGraph()
+ ****************************************************************************/
+
+// 'planarity -trace [-q] C I O T': Specific graph, with event trace written to T
+int callTraceGraph(int argc, char *argv[])
+{
+	char Choice=0, *infileName=NULL, *outfileName=NULL;
+	int offset = 0, Result;
+
+	if (argc < 6)
+		return -1;
+
+	if (argv[2][0] == '-' && (Choice = argv[2][1]) == 'q')
+	{
+		if (argc < 7)
+			return -1;
+		offset = 1;
+	}
+
+	Choice = GetCommandChoice(argv[2+offset]);
+	infileName = argv[3+offset];
+	outfileName = argv[4+offset];
+	traceFileName = argv[5+offset];
+
+	Result = SpecificGraph(Choice, infileName, outfileName, NULL);
+
+	traceFileName = NULL;
+	return Result;
+}
+
+/****************************************************************************
+ callOutOfCoreGraph()
+ ****************************************************************************/
+
+// 'planarity -ooc [-q] D B C I O [O2]': Specific graph, with arrays beyond
+// a memory budget of B megabytes kept in temporary files in directory D
+int callOutOfCoreGraph(int argc, char *argv[])
+{
+	char Choice=0, *infileName=NULL, *outfileName=NULL, *outfile2Name=NULL;
+	int offset = 0, Result;
+
+	if (argc < 7)
+		return -1;
+
+	if (argv[2][0] == '-' && argv[2][1] == 'q')
+	{
+		if (argc < 8)
+			return -1;
+		offset = 1;
+	}
+
+	Choice = GetCommandChoice(argv[4+offset]);
+	infileName = argv[5+offset];
+	outfileName = argv[6+offset];
+	if (argc == 8+offset)
+	    outfile2Name = argv[7+offset];
+
+	if (!platform_SetMemoryFileDir(argv[2+offset]))
+	{
+		ErrorMessage("Failed to create temporary files in the given directory\n");
+		return NOTOK;
+	}
+	platform_SetMemoryBudget((size_t) atol(argv[3+offset]) * 1024 * 1024);
+	memoryFileDir = argv[2+offset];
+
+	Result = SpecificGraph(Choice, infileName, outfileName, outfile2Name);
+
+	memoryFileDir = NULL;
+	platform_SetMemoryFileDir(NULL);
+	return Result;
+}
+
+/****************************************************************************
+ callDecodeTrace()
+ ****************************************************************************/
+
+// 'planarity -decode [-q] [-json] T O': Convert event trace T to text or JSON
+int callDecodeTrace(int argc, char *argv[])
+{
+	int offset = 0, format = TRACEFORMAT_TEXT;
+
+	if (argc >= 3 && strcmp(argv[2], "-q") == 0)
+		offset++;
+
+	if (argc >= 3+offset && strcmp(argv[2+offset], "-json") == 0)
+	{
+		format = TRACEFORMAT_JSON;
+		offset++;
+	}
+
+	if (argc < 4+offset)
+		return -1;
+
+	if (gp_TraceDecode(argv[2+offset], argv[3+offset], format) != OK)
+	{
+		ErrorMessage("Failed to decode trace file\n");
+		return NOTOK;
+	}
+
+	return OK;
+}
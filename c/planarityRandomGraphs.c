@@ -68,7 +68,7 @@ int  RandomGraphs(char command, int NumGraphs, int SizeOfGraphs)
 {
 char theFileName[256];
 int  K, countUpdateFreq;
-int Result=OK, MainStatistic=0;
+int Result=OK, MainStatistic=0, NumUndecided=0;
 int  ObstructionMinorFreqs[NUM_MINORS];
 graphP theGraph=NULL, origGraph=NULL;
 platform_time start, end;
@@ -122,7 +122,7 @@ int ReuseGraphs = TRUE;
 
               gp_CopyGraph(origGraph, theGraph);
 
-              if (strchr("pdo234", command))
+              if (strchr("pdlo2345jt", command))
               {
                   Result = gp_Embed(theGraph, embedFlags);
 
@@ -176,6 +176,12 @@ int ReuseGraphs = TRUE;
                            }
                        }
                   }
+                  // A K5 search that reached its branch limit is undecided, not in error
+                  else if (embedFlags == EMBEDFLAGS_SEARCHFORK5 && Result == K5SEARCH_LIMITREACHED)
+                  {
+                       NumUndecided++;
+                       Result = OK;
+                  }
               }
               else if (command == 'c')
               {
@@ -282,6 +288,16 @@ int ReuseGraphs = TRUE;
          sprintf(Line, "Of the generated graphs, %d did not contain a K_4 homeomorph as a subgraph.\n", MainStatistic);
          Message(Line);
      }
+     else if (embedFlags == EMBEDFLAGS_SEARCHFORK5)
+     {
+         sprintf(Line, "Of the generated graphs, %d did not contain a K_5 homeomorph as a subgraph.\n", MainStatistic);
+         Message(Line);
+         if (NumUndecided > 0)
+         {
+             sprintf(Line, "Of the generated graphs, %d were not resolved within the K_5 search branch limit.\n", NumUndecided);
+             Message(Line);
+         }
+     }
 
      // Report statistics for vertex coloring
      else if (command == 'c')
@@ -347,9 +363,13 @@ graphP MakeGraph(int Size, char command)
 	switch (command)
 	{
 		case 'd' : gp_AttachDrawPlanar(theGraph); break;
+		case 'l' : gp_AttachDrawStraightLine(theGraph); break;
 		case '2' : gp_AttachK23Search(theGraph); break;
 		case '3' : gp_AttachK33Search(theGraph); break;
 		case '4' : gp_AttachK4Search(theGraph); break;
+		case '5' : gp_AttachK5Search(theGraph); break;
+		case 'j' : gp_AttachSurfaceEmbed(theGraph); break;
+		case 't' : gp_AttachSurfaceEmbed(theGraph); break;
 		case 'c' : gp_AttachColorVertices(theGraph); break;
 	}
 
@@ -417,7 +437,7 @@ char saveEdgeListFormat;
      Message("Now processing\n");
      FlushConsole(stdout);
 
-     if (strchr("pdo234", command))
+     if (strchr("pdlo2345jt", command))
      {
          platform_GetTime(start);
          Result = gp_Embed(theGraph, embedFlags);
@@ -68,20 +68,29 @@ int Result;
 
 	switch (command)
 	{
-		case 'd' : gp_AttachDrawPlanar(theGraph); break;
+		case 'd' : gp_AttachDrawPlanar(theGraph);
+		           gp_DrawPlanar_SetNumThreads(theGraph, numThreads); break;
+		case 'l' : gp_AttachDrawStraightLine(theGraph); break;
 		case '2' : gp_AttachK23Search(theGraph); break;
 		case '3' : gp_AttachK33Search(theGraph); break;
 		case '4' : gp_AttachK4Search(theGraph); break;
+		case '5' : gp_AttachK5Search(theGraph); break;
+		case 'j' : gp_AttachSurfaceEmbed(theGraph); break;
+		case 't' : gp_AttachSurfaceEmbed(theGraph); break;
 		case 'c' : gp_AttachColorVertices(theGraph); break;
 	}
 
+	// If a trace file was requested, then record the events of the algorithm
+	if (traceFileName != NULL && gp_TraceEnable(theGraph, 0) != OK)
+		ErrorMessage("Failed to enable tracing\n");
+
     // Read the graph into memory
 	Result = gp_Read(theGraph, infileName);
 	if (Result == NONEMBEDDABLE)
 	{
 		Message("The graph contains too many edges.\n");
 		// Some of the algorithms will still run correctly with some edges removed.
-		if (strchr("pdo234", command))
+		if (strchr("pdlo234", command))
 		{
 			Message("Some edges were removed, but the algorithm will still run correctly.\n");
 			Result = OK;
@@ -96,10 +105,17 @@ int Result;
 	else
 	{
 		// Copy the graph for integrity checking
+#ifdef PROFILE
+        platform_GetTime(start);
+#endif
         origGraph = gp_DupGraph(theGraph);
+#ifdef PROFILE
+        platform_GetTime(end);
+        printf("Copy graph in %.3lf seconds.\n", platform_GetDuration(start,end));
+#endif
 
         // Run the algorithm
-        if (strchr("pdo234", command))
+        if (strchr("pdlo2345jt", command))
         {
     		int embedFlags = GetEmbedFlags(command);
 	        platform_GetTime(start);
@@ -109,7 +125,14 @@ int Result;
 //			gp_Write(theGraph, "debug.before.txt", WRITE_DEBUGINFO);
 //	        gp_SortVertices(theGraph);
 
-			Result = gp_Embed(theGraph, embedFlags);
+			// For a graph too large for memory, the vertices of degree two or
+			// less are removed first, so only the smaller kernel that remains
+			// is given to the embedder (for planarity only; other embedFlags
+			// are passed on to gp_Embed())
+			if (memoryFileDir != NULL)
+				Result = gp_EmbedReduced(theGraph, embedFlags);
+			else
+				Result = gp_Embed(theGraph, embedFlags);
 	        platform_GetTime(end);
 	        Result = gp_TestEmbedResultIntegrity(theGraph, origGraph, Result);
         }
@@ -129,12 +152,23 @@ int Result;
         // Write what the algorithm determined and how long it took
         WriteAlgorithmResults(theGraph, Result, command, start, end, infileName);
 
+        // Write the trace of the algorithm's events, if one was requested
+        if (traceFileName != NULL && gp_TraceWrite(theGraph, traceFileName) != OK)
+        	ErrorMessage("Failed to write trace file\n");
+
         // Free the graph obtained for integrity checking.
         gp_Free(&origGraph);
 	}
 
-	// Report an error, if there was one, free the graph, and return
-	if (Result != OK && Result != NONEMBEDDABLE)
+	// Report an error, if there was one, free the graph, and return.
+	// A K5 search that reached its branch limit is undecided rather than
+	// in error, so it is reported as such and no output file is written
+	if (command == '5' && Result == K5SEARCH_LIMITREACHED)
+	{
+		ErrorMessage("THE RESULT IS NOT DEFINITIVE\n");
+	}
+
+	else if (Result != OK && Result != NONEMBEDDABLE)
 	{
 		ErrorMessage("AN ERROR HAS BEEN DETECTED\n");
 		Result = NOTOK;
@@ -145,15 +179,15 @@ int Result;
 	else
 	{
         // Restore the vertex ordering of the original graph (undo DFS numbering)
-        if (strchr("pdo234", command))
+        if (strchr("pdlo2345jt", command))
             gp_SortVertices(theGraph);
 
         // Determine the name of the primary output file
         outfileName = ConstructPrimaryOutputFilename(infileName, outfileName, command);
 
         // For some algorithms, the primary output file is not always written
-        if ((strchr("pdo", command) && Result == NONEMBEDDABLE) ||
-        	(strchr("234", command) && Result == OK))
+        if ((strchr("pdlojt", command) && Result == NONEMBEDDABLE) ||
+        	(strchr("2345", command) && Result == OK))
         {
         	// Do not write the file
         }
@@ -168,7 +202,8 @@ int Result;
 
 		// When called from the menu system, we want to write the planar or outerplanar
 		// obstruction, if one exists. For planar graph drawing, we want the character
-        // art rendition.  An empty but non-NULL string is passed to indicate the necessity
+        // art rendition, and for straight-line drawing, the coordinates of the vertices.
+        // An empty but non-NULL string is passed to indicate the necessity
         // of selecting a default name for the second output file.
 		if (outfile2Name != NULL)
 		{
@@ -184,7 +219,14 @@ int Result;
 				// By default, add ".render.txt" to the primary output filename
 				if (strlen(outfile2Name) == 0)
    				    strcat((outfile2Name = outfileName), ".render.txt");
-				gp_DrawPlanar_RenderToFile(theGraph, outfile2Name);
+				WriteDrawPlanarFile(theGraph, outfile2Name);
+			}
+			else if (command == 'l' && Result == OK)
+			{
+				// By default, add ".coords.txt" to the primary output filename
+				if (strlen(outfile2Name) == 0)
+   				    strcat((outfile2Name = outfileName), ".coords.txt");
+				gp_DrawStraightLine_WriteCoordinates(theGraph, outfile2Name);
 			}
 		}
 	}
@@ -197,6 +239,34 @@ int Result;
 	return Result;
 }
 
+/****************************************************************************
+ WriteDrawPlanarFile()
+
+ Writes the visibility representation computed by the DrawPlanar
+ algorithm in the format given by the ending of the file name:
+ ".coords.txt" for the text coordinate list, ".coords.bin" for the
+ binary coordinate list, ".svg" for an SVG image, ".json" for JSON,
+ or otherwise the character art rendition.  All but the rendition
+ take O(N+M) space, so they are the only choices for a large graph.
+ ****************************************************************************/
+
+int WriteDrawPlanarFile(graphP theGraph, char *theFileName)
+{
+	if (FileNameEndsWith(theFileName, ".coords.txt"))
+		return gp_DrawPlanar_WriteCoordinates(theGraph, theFileName, DRAWPLANAR_WRITE_TEXT);
+
+	if (FileNameEndsWith(theFileName, ".coords.bin"))
+		return gp_DrawPlanar_WriteCoordinates(theGraph, theFileName, DRAWPLANAR_WRITE_BINARY);
+
+	if (FileNameEndsWith(theFileName, ".svg"))
+		return gp_DrawPlanar_WriteSVG(theGraph, theFileName);
+
+	if (FileNameEndsWith(theFileName, ".json"))
+		return gp_DrawPlanar_WriteJSON(theGraph, theFileName);
+
+	return gp_DrawPlanar_RenderToFile(theGraph, theFileName);
+}
+
 /****************************************************************************
  WriteAlgorithmResults()
  ****************************************************************************/
@@ -212,10 +282,15 @@ void WriteAlgorithmResults(graphP theGraph, int Result, char command, platform_t
 	{
 		case 'p' : sprintf(Line, "is%s planar.\n", Result==OK ? "" : " not"); break;
 		case 'd' : sprintf(Line, "is%s planar.\n", Result==OK ? "" : " not"); break;
+		case 'l' : sprintf(Line, "is%s planar.\n", Result==OK ? "" : " not"); break;
 		case 'o' : sprintf(Line, "is%s outerplanar.\n", Result==OK ? "" : " not"); break;
 		case '2' : sprintf(Line, "has %s subgraph homeomorphic to K_{2,3}.\n", Result==OK ? "no" : "a"); break;
 		case '3' : sprintf(Line, "has %s subgraph homeomorphic to K_{3,3}.\n", Result==OK ? "no" : "a"); break;
 		case '4' : sprintf(Line, "has %s subgraph homeomorphic to K_4.\n", Result==OK ? "no" : "a"); break;
+		case '5' : sprintf(Line, Result==K5SEARCH_LIMITREACHED ? "was not resolved within the K_5 search branch limit.\n"
+		                                       : "has %s subgraph homeomorphic to K_5.\n", Result==OK ? "no" : "a"); break;
+		case 'j' : sprintf(Line, "is%s projective planar.\n", Result==OK ? "" : " not"); break;
+		case 't' : sprintf(Line, "is%s toroidal.\n", Result==OK ? "" : " not"); break;
 		case 'c' : sprintf(Line, "has been %d-colored.\n", gp_GetNumColorsUsed(theGraph)); break;
 		default  : sprintf(Line, "nas not been processed due to unrecognized command.\n"); break;
 	}
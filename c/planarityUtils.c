@@ -60,6 +60,10 @@ char Mode='r',
      AdjListsForEmbeddingsOut='n',
      quietMode='n';
 
+char *traceFileName=NULL;
+char *memoryFileDir=NULL;
+int   numThreads=0;
+
 void Reconfigure()
 {
      fflush(stdin);
@@ -218,6 +222,17 @@ int  FilesEqual(char *file1Name, char *file2Name)
 	return Result;
 }
 
+/****************************************************************************
+ ****************************************************************************/
+
+int  FileNameEndsWith(char *fileName, char *ending)
+{
+	size_t nameLength = strlen(fileName), endingLength = strlen(ending);
+
+	return nameLength >= endingLength &&
+	       strcmp(fileName + nameLength - endingLength, ending) == 0 ? TRUE : FALSE;
+}
+
 /****************************************************************************
  ****************************************************************************/
 
@@ -230,9 +245,13 @@ int GetEmbedFlags(char command)
 		case 'o' : embedFlags = EMBEDFLAGS_OUTERPLANAR; break;
 		case 'p' : embedFlags = EMBEDFLAGS_PLANAR; break;
 		case 'd' : embedFlags = EMBEDFLAGS_DRAWPLANAR; break;
+		case 'l' : embedFlags = EMBEDFLAGS_DRAWSTRAIGHTLINE; break;
 		case '2' : embedFlags = EMBEDFLAGS_SEARCHFORK23; break;
 		case '3' : embedFlags = EMBEDFLAGS_SEARCHFORK33; break;
 		case '4' : embedFlags = EMBEDFLAGS_SEARCHFORK4; break;
+		case '5' : embedFlags = EMBEDFLAGS_SEARCHFORK5; break;
+		case 'j' : embedFlags = EMBEDFLAGS_PROJECTIVEPLANAR; break;
+		case 't' : embedFlags = EMBEDFLAGS_TOROIDAL; break;
 	}
 
 	return embedFlags;
@@ -249,10 +268,14 @@ char *GetAlgorithmName(char command)
 	{
 		case 'p' : algorithmName = "PlanarEmbed"; break;
 		case 'd' : algorithmName = DRAWPLANAR_NAME;	break;
+		case 'l' : algorithmName = DRAWSTRAIGHTLINE_NAME; break;
 		case 'o' : algorithmName = "OuterplanarEmbed"; break;
 		case '2' : algorithmName = K23SEARCH_NAME; break;
 		case '3' : algorithmName = K33SEARCH_NAME; break;
 		case '4' : algorithmName = K4SEARCH_NAME; break;
+		case '5' : algorithmName = K5SEARCH_NAME; break;
+		case 'j' : algorithmName = "ProjectivePlanarEmbed"; break;
+		case 't' : algorithmName = "ToroidalEmbed"; break;
 		case 'c' : algorithmName = COLORVERTICES_NAME; break;
 	}
 
@@ -267,9 +290,13 @@ void AttachAlgorithm(graphP theGraph, char command)
 	switch (command)
 	{
 		case 'd' : gp_AttachDrawPlanar(theGraph); break;
+		case 'l' : gp_AttachDrawStraightLine(theGraph); break;
 		case '2' : gp_AttachK23Search(theGraph); break;
 		case '3' : gp_AttachK33Search(theGraph); break;
 		case '4' : gp_AttachK4Search(theGraph); break;
+		case '5' : gp_AttachK5Search(theGraph); break;
+		case 'j' : gp_AttachSurfaceEmbed(theGraph); break;
+		case 't' : gp_AttachSurfaceEmbed(theGraph); break;
 		case 'c' : gp_AttachColorVertices(theGraph); break;
 	}
 }
@@ -278,6 +305,7 @@ void AttachAlgorithm(graphP theGraph, char command)
  A string used to construct input and output filenames.
 
  The SUFFIXMAXLENGTH is 32 to accommodate ".out.txt" + ".render.txt" + ".test.txt"
+ (or ".coords.txt" in place of ".render.txt")
  ****************************************************************************/
 
 #define FILENAMEMAXLENGTH 128
@@ -0,0 +1,237 @@
+/*
+Planarity-Related Graph Algorithms Project
+Copyright (c) 1997-2012, John M. Boyer
+All rights reserved. Includes a reference implementation of the following:
+
+* John M. Boyer. "Subgraph Homeomorphism via the Edge Addition Planarity Algorithm".
+  Journal of Graph Algorithms and Applications, Vol. 16, no. 2, pp. 381-410, 2012.
+  http://www.jgaa.info/16/268.html
+
+* John M. Boyer. "A New Method for Efficiently Generating Planar Graph
+  Visibility Representations". In P. Eades and P. Healy, editors,
+  Proceedings of the 13th International Conference on Graph Drawing 2005,
+  Lecture Notes Comput. Sci., Volume 3843, pp. 508-511, Springer-Verlag, 2006.
+
+* John M. Boyer and Wendy J. Myrvold. "On the Cutting Edge: Simplified O(n)
+  Planarity by Edge Addition". Journal of Graph Algorithms and Applications,
+  Vol. 8, No. 3, pp. 241-273, 2004.
+  http://www.jgaa.info/08/91.html
+
+* John M. Boyer. "Simplified O(n) Algorithms for Planar Graph Embedding,
+  Kuratowski Subgraph Isolation, and Related Problems". Ph.D. Dissertation,
+  University of Victoria, 2001.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+* Redistributions of source code must retain the above copyright notice, this
+  list of conditions and the following disclaimer.
+
+* Redistributions in binary form must reproduce the above copyright notice, this
+  list of conditions and the following disclaimer in the documentation and/or
+  other materials provided with the distribution.
+
+* Neither the name of the Planarity-Related Graph Algorithms Project nor the names
+  of its contributors may be used to endorse or promote products derived from this
+  software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include "appconst.h"
+
+#ifdef PROFILE_COUNTERS
+
+#include <stdio.h>
+#include <string.h>
+
+#include "platformCounters.h"
+
+#ifdef __linux__
+#include <unistd.h>
+#include <sys/syscall.h>
+#include <linux/perf_event.h>
+#endif
+
+/* The counters count the events of the thread that opened them, so each
+   thread opens and reads its own. */
+
+#if defined(_MSC_VER)
+#define PLATFORM_THREADLOCAL __declspec(thread)
+#else
+#define PLATFORM_THREADLOCAL __thread
+#endif
+
+static PLATFORM_THREADLOCAL int counterFDs[PLATFORM_NUMCOUNTERS];
+static PLATFORM_THREADLOCAL int countersOpened = 0, ioAvailable = 0;
+
+/* Private functions */
+
+int  _OpenCounter(unsigned int type, unsigned long long config);
+void _OpenCounters(void);
+int  _ReadIOBytes(platform_counters *counters);
+
+#ifdef __linux__
+
+/********************************************************************
+ _OpenCounter()
+ Opens a perf_event counter for the user mode events of the calling
+ thread.  Returns the file descriptor, or -1 if the counter is not
+ available.
+ ********************************************************************/
+
+int  _OpenCounter(unsigned int type, unsigned long long config)
+{
+struct perf_event_attr attr;
+
+     memset(&attr, 0, sizeof(attr));
+     attr.type = type;
+     attr.size = sizeof(attr);
+     attr.config = config;
+     attr.exclude_kernel = 1;
+     attr.exclude_hv = 1;
+
+     return (int) syscall(__NR_perf_event_open, &attr, 0, -1, -1, 0);
+}
+
+/********************************************************************
+ _OpenCounters()
+ ********************************************************************/
+
+void _OpenCounters(void)
+{
+     counterFDs[PLATFORM_CYCLES] = _OpenCounter(PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES);
+     counterFDs[PLATFORM_INSTRUCTIONS] = _OpenCounter(PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS);
+     counterFDs[PLATFORM_L1DMISSES] = _OpenCounter(PERF_TYPE_HW_CACHE,
+    		 PERF_COUNT_HW_CACHE_L1D |
+    		 (PERF_COUNT_HW_CACHE_OP_READ << 8) |
+    		 (PERF_COUNT_HW_CACHE_RESULT_MISS << 16));
+     counterFDs[PLATFORM_LLCMISSES] = _OpenCounter(PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES);
+     counterFDs[PLATFORM_BRANCHMISSES] = _OpenCounter(PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES);
+     counterFDs[PLATFORM_MAJORFAULTS] = _OpenCounter(PERF_TYPE_SOFTWARE, PERF_COUNT_SW_PAGE_FAULTS_MAJ);
+
+     countersOpened = 1;
+}
+
+/********************************************************************
+ _ReadIOBytes()
+ Reads the bytes read from and written to storage by the process.
+ Returns nonzero on success, or zero if /proc/self/io is unavailable.
+ ********************************************************************/
+
+int  _ReadIOBytes(platform_counters *counters)
+{
+FILE *infile;
+char line[64];
+int numFound = 0;
+
+     if ((infile = fopen("/proc/self/io", "r")) == NULL)
+    	 return 0;
+
+     while (fgets(line, sizeof(line), infile) != NULL)
+     {
+    	 if (sscanf(line, "read_bytes: %llu", &counters->value[PLATFORM_READBYTES]) == 1 ||
+    		 sscanf(line, "write_bytes: %llu", &counters->value[PLATFORM_WRITEBYTES]) == 1)
+    		 numFound++;
+     }
+
+     fclose(infile);
+     return numFound == 2;
+}
+
+#else
+
+void _OpenCounters(void)
+{
+int i;
+
+     for (i = 0; i < PLATFORM_NUMCOUNTERS; i++)
+    	 counterFDs[i] = -1;
+
+     countersOpened = 1;
+}
+
+int  _ReadIOBytes(platform_counters *counters)
+{
+     return 0;
+}
+
+#endif
+
+/********************************************************************
+ platform_GetCounters()
+ Reads the current value of each counter.  An unavailable counter
+ reads as zero.
+ ********************************************************************/
+
+void platform_GetCounters(platform_counters *counters)
+{
+int i;
+
+     memset(counters, 0, sizeof(platform_counters));
+
+     if (!countersOpened)
+    	 _OpenCounters();
+
+#ifdef __linux__
+     for (i = 0; i < PLATFORM_NUMCOUNTERS; i++)
+     {
+    	 if (counterFDs[i] >= 0 &&
+    		 read(counterFDs[i], &counters->value[i], sizeof(counters->value[i])) != sizeof(counters->value[i]))
+    		 counters->value[i] = 0;
+     }
+#endif
+
+     ioAvailable = _ReadIOBytes(counters);
+}
+
+/********************************************************************
+ platform_PrintCounters()
+ Prints, for the named phase, the number of events per edge counted
+ by each available counter between the start and end readings, and
+ then the I/O of the phase.
+ ********************************************************************/
+
+void platform_PrintCounters(char *phaseName, platform_counters *start, platform_counters *end, int numEdges)
+{
+static char *counterNames[PLATFORM_NUMCOUNTERS] = {
+		"cycles", "instructions", "L1D misses", "LLC misses", "branch misses", "major faults"
+};
+int i, numAvailable = 0;
+
+     printf("%s per edge:", phaseName);
+
+     for (i = 0; i < PLATFORM_NUMCOUNTERS; i++)
+     {
+    	 if (counterFDs[i] < 0 || i == PLATFORM_MAJORFAULTS)
+    		 continue;
+    	 printf("%s %.2lf %s", numAvailable++ > 0 ? "," : "",
+    			 (double) (end->value[i] - start->value[i]) / (numEdges > 0 ? numEdges : 1),
+    			 counterNames[i]);
+     }
+
+     printf("%s\n", numAvailable > 0 ? "" : " counters unavailable");
+
+     printf("%s I/O:", phaseName);
+     if (counterFDs[PLATFORM_MAJORFAULTS] >= 0)
+    	 printf(" %llu major faults%s", end->value[PLATFORM_MAJORFAULTS] - start->value[PLATFORM_MAJORFAULTS],
+    			 ioAvailable ? "," : "");
+     if (ioAvailable)
+    	 printf(" %.1lf MB read, %.1lf MB written",
+    			 (double) (end->value[PLATFORM_READBYTES] - start->value[PLATFORM_READBYTES]) / (1024*1024),
+    			 (double) (end->value[PLATFORM_WRITEBYTES] - start->value[PLATFORM_WRITEBYTES]) / (1024*1024));
+     if (counterFDs[PLATFORM_MAJORFAULTS] < 0 && !ioAvailable)
+    	 printf(" unavailable");
+     printf("\n");
+}
+
+#endif
@@ -0,0 +1,115 @@
+#ifndef PLATFORM_COUNTERS
+#define PLATFORM_COUNTERS
+
+/*
+Planarity-Related Graph Algorithms Project
+Copyright (c) 1997-2012, John M. Boyer
+All rights reserved. Includes a reference implementation of the following:
+
+* John M. Boyer. "Subgraph Homeomorphism via the Edge Addition Planarity Algorithm".
+  Journal of Graph Algorithms and Applications, Vol. 16, no. 2, pp. 381-410, 2012.
+  http://www.jgaa.info/16/268.html
+
+* John M. Boyer. "A New Method for Efficiently Generating Planar Graph
+  Visibility Representations". In P. Eades and P. Healy, editors,
+  Proceedings of the 13th International Conference on Graph Drawing 2005,
+  Lecture Notes Comput. Sci., Volume 3843, pp. 508-511, Springer-Verlag, 2006.
+
+* John M. Boyer and Wendy J. Myrvold. "On the Cutting Edge: Simplified O(n)
+  Planarity by Edge Addition". Journal of Graph Algorithms and Applications,
+  Vol. 8, No. 3, pp. 241-273, 2004.
+  http://www.jgaa.info/08/91.html
+
+* John M. Boyer. "Simplified O(n) Algorithms for Planar Graph Embedding,
+  Kuratowski Subgraph Isolation, and Related Problems". Ph.D. Dissertation,
+  University of Victoria, 2001.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+* Redistributions of source code must retain the above copyright notice, this
+  list of conditions and the following disclaimer.
+
+* Redistributions in binary form must reproduce the above copyright notice, this
+  list of conditions and the following disclaimer in the documentation and/or
+  other materials provided with the distribution.
+
+* Neither the name of the Planarity-Related Graph Algorithms Project nor the names
+  of its contributors may be used to endorse or promote products derived from this
+  software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/********************************************************************
+ Hardware performance counters for profiling
+
+ When PROFILE_COUNTERS is defined (see appconst.h), a PROFILE build
+ reads the processor's performance counters around each phase that it
+ times, and it reports the counts per edge so that changes to the data
+ layout can be judged by their cache and branch behaviour.
+
+ The counters are read with the Linux perf_event interface, counting
+ user mode events of the calling thread.  Each thread has its own set
+ of counters, opened on its first use by that thread, so that threads
+ that embed in parallel (see gp_EmbedComponents()) each read their own
+ counts.  The counters of a thread stay open until the process exits.
+ A counter that the processor or the system's perf_event_paranoid
+ setting does not allow is reported as unavailable.  On other platforms,
+ and when PROFILE_COUNTERS is not defined, the counter operations do
+ nothing.
+
+ The I/O of each phase is also reported, as totals rather than per
+ edge: the major page faults of the calling thread, which are the
+ faults that read a page of an array from its file (see
+ platform_SetMemoryFileDir()), and the bytes the process read from and
+ wrote to storage, according to /proc/self/io.
+ ********************************************************************/
+
+#define PLATFORM_CYCLES         0
+#define PLATFORM_INSTRUCTIONS   1
+#define PLATFORM_L1DMISSES      2
+#define PLATFORM_LLCMISSES      3
+#define PLATFORM_BRANCHMISSES   4
+#define PLATFORM_MAJORFAULTS    5
+#define PLATFORM_NUMCOUNTERS    6
+
+#define PLATFORM_READBYTES      6
+#define PLATFORM_WRITEBYTES     7
+#define PLATFORM_NUMVALUES      8
+
+typedef struct
+{
+    unsigned long long value[PLATFORM_NUMVALUES];
+} platform_counters;
+
+#ifdef PROFILE_COUNTERS
+
+void platform_GetCounters(platform_counters *counters);
+void platform_PrintCounters(char *phaseName, platform_counters *start, platform_counters *end, int numEdges);
+
+#else
+
+#define platform_GetCounters(counters) ((void) (counters))
+#define platform_PrintCounters(phaseName, start, end, numEdges) ((void) (start), (void) (end))
+
+#endif
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,541 @@
+/*
+Planarity-Related Graph Algorithms Project
+Copyright (c) 1997-2012, John M. Boyer
+All rights reserved. Includes a reference implementation of the following:
+
+* John M. Boyer. "Subgraph Homeomorphism via the Edge Addition Planarity Algorithm".
+  Journal of Graph Algorithms and Applications, Vol. 16, no. 2, pp. 381-410, 2012.
+  http://www.jgaa.info/16/268.html
+
+* John M. Boyer. "A New Method for Efficiently Generating Planar Graph
+  Visibility Representations". In P. Eades and P. Healy, editors,
+  Proceedings of the 13th International Conference on Graph Drawing 2005,
+  Lecture Notes Comput. Sci., Volume 3843, pp. 508-511, Springer-Verlag, 2006.
+
+* John M. Boyer and Wendy J. Myrvold. "On the Cutting Edge: Simplified O(n)
+  Planarity by Edge Addition". Journal of Graph Algorithms and Applications,
+  Vol. 8, No. 3, pp. 241-273, 2004.
+  http://www.jgaa.info/08/91.html
+
+* John M. Boyer. "Simplified O(n) Algorithms for Planar Graph Embedding,
+  Kuratowski Subgraph Isolation, and Related Problems". Ph.D. Dissertation,
+  University of Victoria, 2001.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+* Redistributions of source code must retain the above copyright notice, this
+  list of conditions and the following disclaimer.
+
+* Redistributions in binary form must reproduce the above copyright notice, this
+  list of conditions and the following disclaimer in the documentation and/or
+  other materials provided with the distribution.
+
+* Neither the name of the Planarity-Related Graph Algorithms Project nor the names
+  of its contributors may be used to endorse or promote products derived from this
+  software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#ifdef __linux__
+#define _GNU_SOURCE
+#endif
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "platformMemory.h"
+
+#ifdef __linux__
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+
+#ifdef MFD_CLOEXEC
+#define PLATFORM_MAPMEMORY
+#endif
+#endif
+
+/* The number of bytes of arrays kept in memory.  Arrays are allocated
+   and freed concurrently by graphs embedded in different threads. */
+
+static size_t memoryInUse = 0;
+
+#ifdef __GNUC__
+#define _AddMemoryInUse(n) __sync_fetch_and_add(&memoryInUse, (size_t) (n))
+#define _SubMemoryInUse(n) __sync_fetch_and_sub(&memoryInUse, (size_t) (n))
+#else
+#define _AddMemoryInUse(n) (memoryInUse += (size_t) (n))
+#define _SubMemoryInUse(n) (memoryInUse -= (size_t) (n))
+#endif
+
+#ifdef PLATFORM_MAPMEMORY
+
+static char *memoryFileDir = NULL;
+static size_t memoryBudget = 0;
+
+/* Private functions */
+
+size_t _MapSize(size_t size);
+void *_MapFile(int fd, size_t mapSize, int flags);
+int  _CreateFile(size_t mapSize, int isFile);
+int  _CreateTempFile(void);
+int  _KeepInFile(size_t size);
+
+/********************************************************************
+ _MapSize()
+ Returns the size rounded up to a whole number of pages.
+ ********************************************************************/
+
+size_t _MapSize(size_t size)
+{
+size_t pageSize = (size_t) sysconf(_SC_PAGESIZE);
+
+     return (size + pageSize - 1) / pageSize * pageSize;
+}
+
+/********************************************************************
+ _MapFile()
+ Maps the memory file with the given mmap() flags, returning NULL on
+ failure rather than MAP_FAILED.
+ ********************************************************************/
+
+void *_MapFile(int fd, size_t mapSize, int flags)
+{
+void *ptr = mmap(NULL, mapSize, PROT_READ | PROT_WRITE, flags, fd, 0);
+
+     return ptr == MAP_FAILED ? NULL : ptr;
+}
+
+/********************************************************************
+ _CreateFile()
+ Creates a file of the given size, whose content is initially zero.
+ The file is a temporary file in the memoryFileDir if isFile is set,
+ or an anonymous memory file otherwise.  Returns the file descriptor,
+ or -1 on failure.
+ ********************************************************************/
+
+int  _CreateFile(size_t mapSize, int isFile)
+{
+int fd = isFile ? _CreateTempFile() : memfd_create("planarity", MFD_CLOEXEC);
+
+     if (fd >= 0 && ftruncate(fd, (off_t) mapSize) != 0)
+     {
+         close(fd);
+         fd = -1;
+     }
+
+     return fd;
+}
+
+/********************************************************************
+ _CreateTempFile()
+ Creates an empty file in the memoryFileDir that has no name, so that
+ it is deleted once closed.  Returns the file descriptor, or -1 on
+ failure.
+ ********************************************************************/
+
+int  _CreateTempFile(void)
+{
+char *fileName;
+int fd = -1;
+
+#ifdef O_TMPFILE
+     if ((fd = open(memoryFileDir, O_TMPFILE | O_RDWR | O_CLOEXEC, 0600)) >= 0)
+         return fd;
+#endif
+
+     // The file system may not support unnamed files, so a named file
+     // is created and then unlinked
+     if ((fileName = (char *) malloc(strlen(memoryFileDir) + 20)) == NULL)
+         return -1;
+
+     sprintf(fileName, "%s/planarityXXXXXX", memoryFileDir);
+     if ((fd = mkstemp(fileName)) >= 0)
+         unlink(fileName);
+
+     free(fileName);
+     return fd;
+}
+
+/********************************************************************
+ _KeepInFile()
+ Returns nonzero if an array of the given size should be kept in a
+ file rather than in memory.
+ ********************************************************************/
+
+int  _KeepInFile(size_t size)
+{
+     return memoryFileDir != NULL && size >= PLATFORM_MAPTHRESHOLD &&
+            memoryInUse + size > memoryBudget;
+}
+
+#endif
+
+/********************************************************************
+ platform_InitMemory()
+ Initializes a memory record to describe no array.
+ ********************************************************************/
+
+void platform_InitMemory(platform_memory *mem)
+{
+     mem->ptr = NULL;
+     mem->size = 0;
+     mem->fd = -1;
+     mem->isSnapshot = 0;
+     mem->isFile = 0;
+}
+
+/********************************************************************
+ platform_AllocMemory()
+ Frees the array described by mem, if any, and then allocates a new
+ zero-filled array of the given size.
+
+ Returns a pointer to the new array, or NULL on failure.
+ ********************************************************************/
+
+void *platform_AllocMemory(platform_memory *mem, size_t size)
+{
+     platform_FreeMemory(mem);
+
+#ifdef PLATFORM_MAPMEMORY
+     if (size >= PLATFORM_MAPTHRESHOLD)
+     {
+         size_t mapSize = _MapSize(size);
+         int isFile = _KeepInFile(size);
+         int fd = _CreateFile(mapSize, isFile);
+
+         // If a temporary file cannot be created, then the array is kept
+         // in memory after all
+         if (fd < 0 && isFile)
+             fd = _CreateFile(mapSize, isFile = 0);
+
+         if (fd >= 0)
+         {
+             if ((mem->ptr = _MapFile(fd, mapSize, MAP_SHARED)) != NULL)
+             {
+                 mem->size = size;
+                 mem->fd = fd;
+                 mem->isFile = isFile;
+                 if (!isFile)
+                     _AddMemoryInUse(size);
+                 return mem->ptr;
+             }
+             close(fd);
+         }
+     }
+#endif
+
+     if ((mem->ptr = calloc(1, size > 0 ? size : 1)) != NULL)
+     {
+         mem->size = size;
+         _AddMemoryInUse(size);
+     }
+
+     return mem->ptr;
+}
+
+/********************************************************************
+ platform_ResizeMemory()
+ Changes the size of the array described by mem, keeping its content
+ up to the lesser of the old and new sizes.  Any added memory is
+ zero-filled.
+
+ A mapped array that is not shared with a snapshot grows by extending
+ its memory file, so the content is not copied even if the array moves
+ to a new address.  Otherwise, the content is copied once into a new
+ array, which is mapped if it is large enough.  An array in memory is
+ also copied if its growth would exceed the memory budget, so that the
+ new array can be kept in a file.
+
+ Returns a pointer to the resized array, or NULL on failure, in which
+ case the array described by mem is unchanged.
+ ********************************************************************/
+
+void *platform_ResizeMemory(platform_memory *mem, size_t newSize)
+{
+void *ptr;
+
+     if (mem->ptr == NULL)
+         return platform_AllocMemory(mem, newSize);
+
+#ifdef PLATFORM_MAPMEMORY
+     if (mem->fd >= 0 && !mem->isSnapshot &&
+         (mem->isFile || memoryFileDir == NULL || newSize <= mem->size ||
+          memoryInUse + (newSize - mem->size) <= memoryBudget))
+     {
+         size_t oldMapSize = _MapSize(mem->size), newMapSize = _MapSize(newSize);
+
+         if (ftruncate(mem->fd, (off_t) newMapSize) != 0)
+             return NULL;
+
+         if ((ptr = mremap(mem->ptr, oldMapSize, newMapSize, MREMAP_MAYMOVE)) == MAP_FAILED)
+             return NULL;
+
+         if (!mem->isFile)
+         {
+             _SubMemoryInUse(mem->size);
+             _AddMemoryInUse(newSize);
+         }
+
+         mem->ptr = ptr;
+         mem->size = newSize;
+         return ptr;
+     }
+
+     if (mem->fd >= 0 || newSize >= PLATFORM_MAPTHRESHOLD)
+     {
+         platform_memory newMem;
+
+         platform_InitMemory(&newMem);
+         if (platform_AllocMemory(&newMem, newSize) == NULL)
+             return NULL;
+
+         memcpy(newMem.ptr, mem->ptr, mem->size < newSize ? mem->size : newSize);
+         platform_FreeMemory(mem);
+         *mem = newMem;
+         return mem->ptr;
+     }
+#endif
+
+     if ((ptr = realloc(mem->ptr, newSize > 0 ? newSize : 1)) == NULL)
+         return NULL;
+
+     if (newSize > mem->size)
+         memset((char *) ptr + mem->size, 0, newSize - mem->size);
+
+     _SubMemoryInUse(mem->size);
+     _AddMemoryInUse(newSize);
+
+     mem->ptr = ptr;
+     mem->size = newSize;
+     return ptr;
+}
+
+/********************************************************************
+ platform_SnapshotMemory()
+ Replaces the array described by dstMem with an array having the same
+ size and content as the array described by srcMem.
+
+ If the source array is mapped from a memory file, then both arrays are
+ mapped privately from the same memory file, so no content is copied
+ until one of the arrays is modified, and then only the modified pages
+ are copied.  If the source array is itself a snapshot, then it may
+ have modified pages that are not in its memory file, so its content
+ is first copied into a new memory file that the two arrays then share.
+ An array kept in a temporary file is copied in full.
+
+ Returns a pointer to the new destination array, or NULL on failure, in
+ which case the array described by dstMem is unchanged.
+ ********************************************************************/
+
+void *platform_SnapshotMemory(platform_memory *dstMem, platform_memory *srcMem)
+{
+platform_memory newMem;
+
+     if (srcMem->ptr == NULL)
+         return NULL;
+
+     platform_InitMemory(&newMem);
+
+#ifdef PLATFORM_MAPMEMORY
+     if (srcMem->fd >= 0 && !srcMem->isFile)
+     {
+         size_t mapSize = _MapSize(srcMem->size);
+
+         // Make the memory file of the source array hold its current content
+         if (srcMem->isSnapshot)
+         {
+             int fd = _CreateFile(mapSize, 0);
+             void *ptr;
+
+             if (fd < 0)
+                 return NULL;
+
+             if ((ptr = _MapFile(fd, mapSize, MAP_SHARED)) == NULL)
+             {
+                 close(fd);
+                 return NULL;
+             }
+
+             memcpy(ptr, srcMem->ptr, srcMem->size);
+             munmap(ptr, mapSize);
+
+             if (mmap(srcMem->ptr, mapSize, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_FIXED, fd, 0) == MAP_FAILED)
+             {
+                 close(fd);
+                 return NULL;
+             }
+
+             close(srcMem->fd);
+             srcMem->fd = fd;
+         }
+
+         // Otherwise, the source array is mapped shared, so it is remapped
+         // privately at the same address so that its future modifications
+         // do not change the memory file
+         else
+         {
+             if (mmap(srcMem->ptr, mapSize, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_FIXED, srcMem->fd, 0) == MAP_FAILED)
+                 return NULL;
+
+             srcMem->isSnapshot = 1;
+         }
+
+         // Map the memory file privately for the destination array
+         if ((newMem.fd = dup(srcMem->fd)) < 0)
+             return NULL;
+
+         if ((newMem.ptr = _MapFile(newMem.fd, mapSize, MAP_PRIVATE)) == NULL)
+         {
+             close(newMem.fd);
+             return NULL;
+         }
+
+         newMem.size = srcMem->size;
+         newMem.isSnapshot = 1;
+         _AddMemoryInUse(newMem.size);
+     }
+     else if (srcMem->isFile)
+     {
+         if (platform_AllocMemory(&newMem, srcMem->size) == NULL)
+             return NULL;
+
+         memcpy(newMem.ptr, srcMem->ptr, srcMem->size);
+     }
+     else
+#endif
+     {
+         if ((newMem.ptr = malloc(srcMem->size > 0 ? srcMem->size : 1)) == NULL)
+             return NULL;
+
+         memcpy(newMem.ptr, srcMem->ptr, srcMem->size);
+         newMem.size = srcMem->size;
+         _AddMemoryInUse(newMem.size);
+     }
+
+     platform_FreeMemory(dstMem);
+     *dstMem = newMem;
+     return dstMem->ptr;
+}
+
+/********************************************************************
+ platform_FreeMemory()
+ Frees the array described by mem, if any, and reinitializes mem.
+ ********************************************************************/
+
+void platform_FreeMemory(platform_memory *mem)
+{
+     if (mem->ptr != NULL)
+     {
+         if (!mem->isFile)
+             _SubMemoryInUse(mem->size);
+
+#ifdef PLATFORM_MAPMEMORY
+         if (mem->fd >= 0)
+         {
+             munmap(mem->ptr, _MapSize(mem->size));
+             close(mem->fd);
+         }
+         else
+#endif
+         free(mem->ptr);
+     }
+
+     platform_InitMemory(mem);
+}
+
+/********************************************************************
+ platform_SetMemoryFileDir()
+ Sets the directory in which arrays that do not fit in the memory
+ budget are kept in temporary files, or keeps all arrays in memory if
+ dirName is NULL.  Arrays that are already allocated are unaffected.
+
+ Returns nonzero on success, or zero if temporary files cannot be
+ created in the directory, or on platforms without mapped arrays, in
+ which case all arrays are kept in memory.
+ ********************************************************************/
+
+int  platform_SetMemoryFileDir(const char *dirName)
+{
+#ifdef PLATFORM_MAPMEMORY
+int fd;
+
+     if (memoryFileDir != NULL)
+     {
+         free(memoryFileDir);
+         memoryFileDir = NULL;
+     }
+
+     if (dirName == NULL)
+         return 1;
+
+     if ((memoryFileDir = (char *) malloc(strlen(dirName) + 1)) == NULL)
+         return 0;
+     strcpy(memoryFileDir, dirName);
+
+     // Make sure that temporary files can be created
+     if ((fd = _CreateTempFile()) < 0)
+     {
+         free(memoryFileDir);
+         memoryFileDir = NULL;
+         return 0;
+     }
+
+     close(fd);
+     return 1;
+#else
+     return dirName == NULL;
+#endif
+}
+
+/********************************************************************
+ platform_SetMemoryBudget()
+ Sets the number of bytes of arrays that may be kept in memory once
+ a directory has been set by platform_SetMemoryFileDir().
+ ********************************************************************/
+
+void platform_SetMemoryBudget(size_t budget)
+{
+#ifdef PLATFORM_MAPMEMORY
+     memoryBudget = budget;
+#endif
+}
+
+/********************************************************************
+ platform_GetMemoryInUse()
+ Returns the number of bytes of arrays kept in memory, counting each
+ snapshot in full even though it may share pages with its source.
+ ********************************************************************/
+
+size_t platform_GetMemoryInUse(void)
+{
+     return memoryInUse;
+}
+
+/********************************************************************
+ platform_AdviseMemory()
+ Gives the operating system a hint, one of the PLATFORM_ADVISE_*
+ values, of how the array described by mem is about to be accessed.
+ ********************************************************************/
+
+void platform_AdviseMemory(platform_memory *mem, int advice)
+{
+#ifdef PLATFORM_MAPMEMORY
+static int advices[] = { MADV_NORMAL, MADV_SEQUENTIAL, MADV_RANDOM, MADV_WILLNEED };
+
+     if (mem->ptr != NULL && mem->fd >= 0 && advice >= 0 && advice <= PLATFORM_ADVISE_WILLNEED)
+         madvise(mem->ptr, _MapSize(mem->size), advices[advice]);
+#endif
+}
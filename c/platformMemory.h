@@ -0,0 +1,128 @@
+#ifndef PLATFORM_MEMORY
+#define PLATFORM_MEMORY
+
+/*
+Planarity-Related Graph Algorithms Project
+Copyright (c) 1997-2012, John M. Boyer
+All rights reserved. Includes a reference implementation of the following:
+
+* John M. Boyer. "Subgraph Homeomorphism via the Edge Addition Planarity Algorithm".
+  Journal of Graph Algorithms and Applications, Vol. 16, no. 2, pp. 381-410, 2012.
+  http://www.jgaa.info/16/268.html
+
+* John M. Boyer. "A New Method for Efficiently Generating Planar Graph
+  Visibility Representations". In P. Eades and P. Healy, editors,
+  Proceedings of the 13th International Conference on Graph Drawing 2005,
+  Lecture Notes Comput. Sci., Volume 3843, pp. 508-511, Springer-Verlag, 2006.
+
+* John M. Boyer and Wendy J. Myrvold. "On the Cutting Edge: Simplified O(n)
+  Planarity by Edge Addition". Journal of Graph Algorithms and Applications,
+  Vol. 8, No. 3, pp. 241-273, 2004.
+  http://www.jgaa.info/08/91.html
+
+* John M. Boyer. "Simplified O(n) Algorithms for Planar Graph Embedding,
+  Kuratowski Subgraph Isolation, and Related Problems". Ph.D. Dissertation,
+  University of Victoria, 2001.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+* Redistributions of source code must retain the above copyright notice, this
+  list of conditions and the following disclaimer.
+
+* Redistributions in binary form must reproduce the above copyright notice, this
+  list of conditions and the following disclaimer in the documentation and/or
+  other materials provided with the distribution.
+
+* Neither the name of the Planarity-Related Graph Algorithms Project nor the names
+  of its contributors may be used to endorse or promote products derived from this
+  software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/********************************************************************
+ Copy-on-write memory for large arrays
+
+ A platform_memory record describes a zero-initialized array allocated
+ by platform_AllocMemory().  On Linux, an array of at least
+ PLATFORM_MAPTHRESHOLD bytes is kept in an anonymous memory file that
+ is mapped into the address space, which allows platform_SnapshotMemory()
+ to give a second array the same content without copying it.  Both
+ arrays are then mapped privately, so the operating system copies only
+ those pages that are later modified through one of them.
+
+ Smaller arrays, and all arrays on other platforms, are allocated with
+ calloc(), and a snapshot is a full copy.  Either way, the arrays are
+ used as ordinary memory, and they must be resized with
+ platform_ResizeMemory() and freed with platform_FreeMemory().
+ ********************************************************************/
+
+#define PLATFORM_MAPTHRESHOLD   (1024*1024)
+
+typedef struct
+{
+    void *ptr;
+    size_t size;
+    int fd, isSnapshot, isFile;
+} platform_memory;
+
+void  platform_InitMemory(platform_memory *mem);
+void *platform_AllocMemory(platform_memory *mem, size_t size);
+void *platform_ResizeMemory(platform_memory *mem, size_t newSize);
+void *platform_SnapshotMemory(platform_memory *dstMem, platform_memory *srcMem);
+void  platform_FreeMemory(platform_memory *mem);
+
+/********************************************************************
+ Out-of-core arrays
+
+ Once platform_SetMemoryFileDir() names a directory, arrays of at least
+ PLATFORM_MAPTHRESHOLD bytes that do not fit in the memory budget are
+ kept in temporary files in that directory.  The files are deleted when
+ the arrays are freed.  The pages of such an array are written back to
+ its file rather than to swap space, so the operating system can evict
+ them whenever memory is short, and a graph larger than memory can be
+ processed.  A snapshot of an array kept in a file is a full copy, as
+ copy-on-write pages would be moved out of the file when modified.
+
+ The memory budget, set by platform_SetMemoryBudget(), is the number of
+ bytes of arrays that may be kept in memory; it is zero by default, so
+ every large array is kept in a file.  platform_GetMemoryInUse() gives
+ the number of bytes of arrays currently kept in memory.
+
+ platform_AdviseMemory() tells the operating system how a mapped array
+ is about to be accessed, e.g. so that it reads ahead in the file for
+ sequential access but not for random access.  It does nothing for an
+ array that is not mapped.
+ ********************************************************************/
+
+#define PLATFORM_ADVISE_NORMAL      0
+#define PLATFORM_ADVISE_SEQUENTIAL  1
+#define PLATFORM_ADVISE_RANDOM      2
+#define PLATFORM_ADVISE_WILLNEED    3
+
+int   platform_SetMemoryFileDir(const char *dirName);
+void  platform_SetMemoryBudget(size_t budget);
+size_t platform_GetMemoryInUse(void);
+void  platform_AdviseMemory(platform_memory *mem, int advice);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif